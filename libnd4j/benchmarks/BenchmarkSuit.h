@@ -0,0 +1,62 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_BENCHMARKSUIT_H
+#define LIBND4J_BENCHMARKSUIT_H
+
+#include <string>
+#include <vector>
+#include <system/common.h>
+#include <helpers/BenchmarkHelper.h>
+#include <array/NDArrayFactory.h>
+
+namespace sd {
+    class BenchmarkSuit {
+    protected:
+        // machine-readable copy of everything the suit measured
+        BenchmarkReport _report;
+
+        // data types the suit runs its typed benchmarks for, empty means suit default
+        std::vector<sd::DataType> _dataTypes;
+
+    public:
+        BenchmarkSuit() = default;
+        virtual ~BenchmarkSuit() = default;
+
+        void setDataTypes(const std::vector<sd::DataType> &dataTypes) { _dataTypes = dataTypes; }
+
+        BenchmarkReport &report() { return _report; }
+
+        // flops estimators for DeclarableBenchmark
+
+        // conv2d/conv3d with default weights format, [kH, kW, iC, oC] or [kD, kH, kW, iC, oC]
+        static double convolutionFlops(graph::Context &ctx);
+
+        // (batched) matmul without transposes, [..., M, K] x [..., K, N]
+        static double matmulFlops(graph::Context &ctx);
+
+        virtual std::string runSuit() = 0;
+    };
+}
+
+
+#endif //DEV_TESTS_BENCHMARKSUIT_H
@@ -23,7 +23,7 @@
 #ifndef LIBND4J_FULLBENCHMARKSUIT_H
 #define LIBND4J_FULLBENCHMARKSUIT_H
 
-#include <performance/benchmarking/BenchmarkSuit.h>
+#include "BenchmarkSuit.h"
 
 namespace sd {
     class FullBenchmarkSuit : public BenchmarkSuit {
@@ -23,7 +23,7 @@
 #ifndef LIBND4J_LIGHTBENCHMARKSUIT_H
 #define LIBND4J_LIGHTBENCHMARKSUIT_H
 
-#include <performance/benchmarking/BenchmarkSuit.h>
+#include "BenchmarkSuit.h"
 
 namespace sd {
     class LightBenchmarkSuit : public BenchmarkSuit {
@@ -0,0 +1,162 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include "FullBenchmarkSuit.h"
+#include "LightBenchmarkSuit.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+//
+// Native benchmark runner:
+//    benchmarks [light|full] [--format text|json|csv] [--output file] [--dtypes float32,half,...]
+//
+// text format is the human-readable table the suits produce, json and csv contain one record per measurement.
+// progress messages go to stderr whenever json or csv is written to stdout, so the output stays parseable
+//
+
+static int usage(const char *binary) {
+    std::cerr << "Usage: " << binary << " [light|full] [--format text|json|csv] [--output file] [--dtypes float32,half,...]"
+              << std::endl;
+    return 1;
+}
+
+// points stdout at stderr for its lifetime, this catches sd_printf as well as std::cout
+class StdoutToStderr {
+private:
+    int _saved;
+
+public:
+    StdoutToStderr() {
+        fflush(stdout);
+        _saved = dup(fileno(stdout));
+        if (_saved >= 0)
+            dup2(fileno(stderr), fileno(stdout));
+    }
+
+    ~StdoutToStderr() {
+        fflush(stdout);
+        if (_saved >= 0) {
+            dup2(_saved, fileno(stdout));
+            close(_saved);
+        }
+    }
+};
+
+static std::vector<sd::DataType> parseDataTypes(const std::string &list) {
+    std::vector<sd::DataType> result;
+
+    size_t start = 0;
+    while (start <= list.size()) {
+        auto end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+
+        auto name = list.substr(start, end - start);
+        if (name == "float32" || name == "float")
+            result.push_back(sd::DataType::FLOAT32);
+        else if (name == "double" || name == "float64")
+            result.push_back(sd::DataType::DOUBLE);
+        else if (name == "half" || name == "float16")
+            result.push_back(sd::DataType::HALF);
+        else if (name == "bfloat16")
+            result.push_back(sd::DataType::BFLOAT16);
+        else if (!name.empty())
+            throw std::invalid_argument("Unsupported data type: " + name);
+
+        start = end + 1;
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv) {
+    std::string suitName("light");
+    std::string format("text");
+    std::string outputFile;
+    std::string dataTypes;
+
+    for (int e = 1; e < argc; e++) {
+        std::string arg(argv[e]);
+        if (arg == "--format" && e + 1 < argc)
+            format = argv[++e];
+        else if (arg == "--output" && e + 1 < argc)
+            outputFile = argv[++e];
+        else if (arg == "--dtypes" && e + 1 < argc)
+            dataTypes = argv[++e];
+        else if (arg == "light" || arg == "full")
+            suitName = arg;
+        else
+            return usage(argv[0]);
+    }
+
+    if (format != "text" && format != "json" && format != "csv")
+        return usage(argv[0]);
+
+    try {
+        std::unique_ptr<sd::BenchmarkSuit> suit;
+        if (suitName == "full")
+            suit.reset(new sd::FullBenchmarkSuit());
+        else
+            suit.reset(new sd::LightBenchmarkSuit());
+
+        if (!dataTypes.empty())
+            suit->setDataTypes(parseDataTypes(dataTypes));
+
+        std::string table;
+        {
+            std::unique_ptr<StdoutToStderr> redirect;
+            if (format != "text" && outputFile.empty())
+                redirect.reset(new StdoutToStderr());
+
+            table = suit->runSuit();
+        }
+
+        std::string result;
+        if (format == "json")
+            result = suit->report().asJson();
+        else if (format == "csv")
+            result = suit->report().asCsv();
+        else
+            result = table;
+
+        if (outputFile.empty()) {
+            std::cout << result << std::endl;
+        } else {
+            std::ofstream stream(outputFile);
+            if (!stream) {
+                std::cerr << "Unable to open output file: " << outputFile << std::endl;
+                return 1;
+            }
+            stream << result;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
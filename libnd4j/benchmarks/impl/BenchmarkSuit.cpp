@@ -19,25 +19,21 @@
 //
 // @author raver119@gmail.com
 //
-
-#ifndef LIBND4J_BENCHMARKSUIT_H
-#define LIBND4J_BENCHMARKSUIT_H
-
-#include <string>
-#include <system/pointercast.h>
-#include <system/dll.h>
-#include <helpers/BenchmarkHelper.h>
-#include <array/NDArrayFactory.h>
+#include "BenchmarkSuit.h"
 
 namespace sd {
-    class SD_LIB_EXPORT BenchmarkSuit {
-    public:
-        BenchmarkSuit() = default;
-        ~BenchmarkSuit() = default;
+    double BenchmarkSuit::convolutionFlops(graph::Context &ctx) {
+        auto weights = ctx.fastpath_in()[1];
+        auto output = ctx.fastpath_out()[0];
 
-        virtual std::string runSuit() = 0;
-    };
-}
+        // every output element is a dot product over kernel window and input channels
+        return 2.0 * output->lengthOf() * (weights->lengthOf() / weights->sizeAt(-1));
+    }
 
+    double BenchmarkSuit::matmulFlops(graph::Context &ctx) {
+        auto x = ctx.fastpath_in()[0];
+        auto z = ctx.fastpath_out()[0];
 
-#endif //DEV_TESTS_BENCHMARKSUIT_H
+        return 2.0 * z->lengthOf() * x->sizeAt(-1);
+    }
+}
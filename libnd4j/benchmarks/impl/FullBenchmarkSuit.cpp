@@ -21,7 +21,7 @@
 //
 
 #include <ops/declarable/CustomOperations.h>
-#include <performance/benchmarking/FullBenchmarkSuit.h>
+#include "FullBenchmarkSuit.h"
 #include <ops/declarable/LegacyRandomOp.h>
 #include <algorithm>
 
@@ -82,9 +82,9 @@
 
 namespace sd {
 
-    static std::string layerNormBenchmark() {
+    static std::string layerNormBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         BoolParameters nhwc("nhwc");    //0 = nchw
 
@@ -136,9 +136,9 @@ namespace sd {
     }
 
 
-    static std::string maxPool3DBenchmark(){
+    static std::string maxPool3DBenchmark(BenchmarkReport &report){
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         BoolParameters ncdhw("ncdhw");  //1 = ndhwc
         ParametersBatch batch({&ncdhw});
@@ -202,15 +202,15 @@ namespace sd {
     }
 
 
-    static std::string conv3dBenchmark(){
+    static std::string conv3dBenchmark(BenchmarkReport &report){
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         BoolParameters ncdhw("ncdhw");  //1 = ndhwc
         ParametersBatch batch({&ncdhw});
 
         sd::ops::conv3dnew conv3Dnew;
-        DeclarableBenchmark benchmark(conv3Dnew, "conv3d");
+        DeclarableBenchmark benchmark(conv3Dnew, "conv3d", BenchmarkSuit::convolutionFlops);
 
 #ifdef _RELEASE
         int mb = 16;
@@ -272,9 +272,9 @@ namespace sd {
     }
 
 
-    static std::string lstmBenchmark() {
+    static std::string lstmBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         BoolParameters format("format");    //0=TNS=[seqLen,mb,size]; 1=NST=[mb,size,seqLen]
 #ifdef _RELEASE
@@ -357,9 +357,9 @@ namespace sd {
         return output;
     }
 
-    static std::string batchnormBenchmark() {
+    static std::string batchnormBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Convolution2D op
         BoolParameters nhwc("nhwc");
@@ -423,9 +423,9 @@ namespace sd {
         return output;
     }
 
-    static std::string pool2dBenchmark() {
+    static std::string pool2dBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Convolution2D op
         BoolParameters nhwc("nhwc");
@@ -483,9 +483,9 @@ namespace sd {
         return output;
     }
 
-    static std::string conv2dBenchmark() {
+    static std::string conv2dBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Convolution2D op
         BoolParameters nhwc("nhwc");
@@ -500,7 +500,7 @@ namespace sd {
 #endif
         ParametersBatch batch({&nhwc, &k, &c, &hw});
         sd::ops::conv2d conv2d;
-        DeclarableBenchmark benchmark(conv2d, "conv2d");
+        DeclarableBenchmark benchmark(conv2d, "conv2d", BenchmarkSuit::convolutionFlops);
 
         auto generator = PARAMETRIC_D() {
             auto ctx = new Context(1);
@@ -543,9 +543,9 @@ namespace sd {
         return output;
     }
 
-    static std::string rngBenchmark() {
+    static std::string rngBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         //Uniform, gaussian and bernoulli RNG generation
 
         IntPowerParameters length("length", 2, 4, scalarBenchmarkPowLimit, 3);      //2^8 to 2^30 in steps of 3
@@ -602,9 +602,9 @@ namespace sd {
         return output;
     }
 
-    static std::string gemmIrregularBenchmark() {
+    static std::string gemmIrregularBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Basically the same as above, but with irregular shapes (not multiples of 8, etc)
 
@@ -727,7 +727,7 @@ namespace sd {
                 n3 += ", tB=";
                 n3 += std::to_string(tB);
 
-                MatrixBenchmark mb3(1.0, 0.0, tA, tB, n);
+                MatrixBenchmark mb3(1.0, 0.0, tA, tB, n3);
 
                 output += helper.runOperationSuit(&mb3, generator3, dim, n3.c_str());
             }
@@ -736,9 +736,9 @@ namespace sd {
         return output;
     }
 
-    static std::string batchGemmBenchmark() {
+    static std::string batchGemmBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Rank 3 - [32,1024,1024]x[32,1024,1024]
         //Rank 4 - [4,8,1024,1024]x[4,8,1024,1024]
@@ -767,15 +767,15 @@ namespace sd {
         };
 
         sd::ops::matmul mmul;
-        DeclarableBenchmark benchmark(mmul, "mmul (batch)");
+        DeclarableBenchmark benchmark(mmul, "mmul (batch)", BenchmarkSuit::matmulFlops);
         output += helper.runOperationSuit(&benchmark, generator, b, "MMul (batch)");
 
         return output;
     }
 
-    static std::string gemmRegularBenchmark() {
+    static std::string gemmRegularBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         for (int o = 0; o <= 1; o++) {
             char resultOrder = (o == 0 ? 'f' : 'c');
@@ -816,9 +816,9 @@ namespace sd {
         return output;
     }
 
-    static std::string scatterOpBenchmark() {
+    static std::string scatterOpBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 10, gatherOpPowLimit, 4);      //2^10 to 2^26 in steps of 4
         ParametersBatch batch({&length});
@@ -926,9 +926,9 @@ namespace sd {
         return output;
     }
 
-    static std::string gatherOpBenchmark() {
+    static std::string gatherOpBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 10, gatherOpPowLimit, 4);      //2^10 to 2^22 in steps of 4
         ParametersBatch batch({&length});
@@ -1027,9 +1027,9 @@ namespace sd {
         return output;
     }
 
-    static std::string mismatchedOrdersAssignBenchmark() {
+    static std::string mismatchedOrdersAssignBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters rows("rows", 2, 2, mismatchedAssignPowLimit, 4);      //2^2 to 2^26 in steps of 2 - 2^1=2, ..., 2^26=67108864
         BoolParameters cf("cf");
@@ -1075,9 +1075,9 @@ namespace sd {
         return output;
     }
 
-    static std::string broadcastOpsMatrixBenchmark() {
+    static std::string broadcastOpsMatrixBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Broadcast ops: matrices for rank 3, 4, 5
         for( int rank=3; rank <= broadcastMatrixRankLimit; rank++ ){
@@ -1177,9 +1177,9 @@ namespace sd {
     }
 
 
-    static std::string broadcast2dBenchmark() {
+    static std::string broadcast2dBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         PredefinedParameters rows("rows", {65536});
         IntPowerParameters cols("cols", 2, 2, limit10, 4);      //2^2, 2^6, 2^10
@@ -1215,9 +1215,9 @@ namespace sd {
         return output;
     }
 
-    static std::string broadcastBenchmark() {
+    static std::string broadcastBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         //Broadcast ops: vectors for rank 2, 3, 4, 5
         for( int axis=0; axis<=1; axis++ ){
@@ -1282,9 +1282,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastStridedReductionNonEws() {
+    static std::string fastStridedReductionNonEws(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters stride("stride", 2, 0, 10, 2);          //2^0=1, ..., 2^10=1024
 
@@ -1340,9 +1340,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastStridedReductionIrregular() {
+    static std::string fastStridedReductionIrregular(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 12, stridedReductionPowLimit, 4);      //2^12 to 2^20 in steps of 4
         PredefinedParameters stride("stride", {26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
@@ -1377,9 +1377,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastStridedReductionsRegular() {
+    static std::string fastStridedReductionsRegular(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 12, stridedReductionPowLimit, 4);      //2^12 to 2^20 in steps of 4
         IntPowerParameters stride("stride", 2, 0, 10);          //2^0=1, ..., 2^10=1024
@@ -1440,9 +1440,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastReduceAlongDimBenchmark() {
+    static std::string fastReduceAlongDimBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         int length[] = {1024*1024, 64*1024*1024};
         int powLimit[] = {10, 20, 26};
@@ -1518,9 +1518,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastReduceToScalarBenchmark() {
+    static std::string fastReduceToScalarBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 10, reduceScalarPowLimit, 4);      //2^10 to 2^26 in steps of 4
 
@@ -1555,9 +1555,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastNonEwsTransformBenchmark() {
+    static std::string fastNonEwsTransformBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         IntPowerParameters rowcol("rowcol", 2, 2, nonEwsPowLimit, 4);      //2^2 to 2^14 in steps of 4 -> non-inplace case: 2x 2^10 x 2^10 = 128mb
         BoolParameters inplace("inplace");
 
@@ -1589,9 +1589,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastPairwiseBenchmark() {
+    static std::string fastPairwiseBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         IntPowerParameters length("length", 2, 10, pairwisePowLimit, 4);      //2^10 to 2^26 in steps of 4 -> max is 512mb
         BoolParameters inplace("inplace");
 
@@ -1618,9 +1618,9 @@ namespace sd {
         return output;
     }
 
-    static std::string heavyTransformsBenchmark() {
+    static std::string heavyTransformsBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         IntPowerParameters length("length", 2, 10, heavyPowLimit, 4);      //2^10 to 2^22, steps of 4
         BoolParameters inplace("inplace");
 
@@ -1682,11 +1682,11 @@ namespace sd {
         return output;
     }
 
-    static std::string intermediateTransformsBenchmark() {
+    static std::string intermediateTransformsBenchmark(BenchmarkReport &report) {
         std::string output;
 
         //Non-inplace: 2x 2^26 elements FP32 -> 512MB
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         IntPowerParameters length("length", 2, 10, intermediateTransformPowLimit, 4);      //2^20 to 2^22 in steps of 4
         BoolParameters inplace("inplace");
 
@@ -1734,9 +1734,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastTransformsBenchmark() {
+    static std::string fastTransformsBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
         IntPowerParameters length("length", 2, 10, transformBenchmarkPowLimit, 4);      //2^10 to 2^30 in steps of 4 - 2^10, 2^14, ..., 2^26
         BoolParameters inplace("inplace");
 
@@ -1766,9 +1766,9 @@ namespace sd {
         return output;
     }
 
-    static std::string fastScalarBenchmark() {
+    static std::string fastScalarBenchmark(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(wIterations, rIterations);
+        BenchmarkHelper helper(wIterations, rIterations, &report);
 
         IntPowerParameters length("length", 2, 10, scalarBenchmarkPowLimit, 4);      //2^10 to 2^30 in steps of 4 - 2^10, 2^14, ..., 2^26
         BoolParameters inplace("inplace");
@@ -1828,93 +1828,93 @@ namespace sd {
 
         // set 1
         sd_printf("Running FullBenchmarkSuite.fastScalarBenchmark\n", "");
-        result += fastScalarBenchmark();
+        result += fastScalarBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastTransformsBenchmark\n", "");
-        result += fastTransformsBenchmark();
+        result += fastTransformsBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.intermediateTransformsBenchmark\n", "");
-        result += intermediateTransformsBenchmark();
+        result += intermediateTransformsBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastPairwiseBenchmark\n", "");
-        result += fastPairwiseBenchmark();
+        result += fastPairwiseBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.heavyTransformsBenchmark\n", "");
-        result += heavyTransformsBenchmark();
+        result += heavyTransformsBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastNonEwsTransformBenchmark\n", "");
-        result += fastNonEwsTransformBenchmark();
+        result += fastNonEwsTransformBenchmark(_report);
         start = done(start);
 
         // set 2
         sd_printf("Running FullBenchmarkSuite.fastReduceToScalarBenchmark\n", "");
-        result += fastReduceToScalarBenchmark();
+        result += fastReduceToScalarBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastReduceAlongDimBenchmark\n", "");
-        result += fastReduceAlongDimBenchmark();
+        result += fastReduceAlongDimBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastStridedReductionsRegular\n", "");
-        result += fastStridedReductionsRegular();
+        result += fastStridedReductionsRegular(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastStridedReductionIrregular\n", "");
-        result += fastStridedReductionIrregular();
+        result += fastStridedReductionIrregular(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.fastStridedReductionNonEws\n", "");
-        result += fastStridedReductionNonEws();
+        result += fastStridedReductionNonEws(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.broadcastBenchmark\n", "");
-        result += broadcastBenchmark();
+        result += broadcastBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.broadcast2dBenchmark\n", "");
-        result += broadcast2dBenchmark();
+        result += broadcast2dBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.broadcastOpsMatrixBenchmark\n", "");
-        result += broadcastOpsMatrixBenchmark();
+        result += broadcastOpsMatrixBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.mismatchedOrdersAssignBenchmark\n", "");
-        result += mismatchedOrdersAssignBenchmark();
+        result += mismatchedOrdersAssignBenchmark(_report);
         start = done(start);
 
 
         // set 3
         sd_printf("Running FullBenchmarkSuite.gatherOpBenchmark\n", "");
-        result += gatherOpBenchmark();
+        result += gatherOpBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.scatterOpBenchmark\n", "");
-        result += scatterOpBenchmark();
+        result += scatterOpBenchmark(_report);
         start = done(start);
 
         // set 4
         sd_printf("Running FullBenchmarkSuite.gemmRegularBenchmark\n", "");
-        result += gemmRegularBenchmark();
+        result += gemmRegularBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.gemmIrregularBenchmark\n", "");
-        result += gemmIrregularBenchmark();
+        result += gemmIrregularBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.rngBenchmark\n", "");
-        result += rngBenchmark();
+        result += rngBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.conv2dBenchmark\n", "");
-        result += conv2dBenchmark();
+        result += conv2dBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.pool2dBenchmark\n", "");
-        result += pool2dBenchmark();
+        result += pool2dBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.batchnormBenchmark\n", "");
-        result += batchnormBenchmark();
+        result += batchnormBenchmark(_report);
         start = done(start);
 
         sd_printf("Running FullBenchmarkSuite.lstmBenchmark\n", "");
-        result += lstmBenchmark();
+        result += lstmBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.conv3dBenchmark\n", "");
-        result += conv3dBenchmark();
+        result += conv3dBenchmark(_report);
         start = done(start);
         sd_printf("Running FullBenchmarkSuite.maxPool3DBenchmark\n", "");
-        result += maxPool3DBenchmark();
+        result += maxPool3DBenchmark(_report);
         start = done(start);
 //        sd_printf("Running FullBenchmarkSuite.layerNormBenchmark\n", "");
-//        result += layerNormBenchmark();
+//        result += layerNormBenchmark(_report);
 //        start = done(start);
 
         return result;
@@ -21,7 +21,7 @@
 //
 
 #include <ops/declarable/CustomOperations.h>
-#include "performance/benchmarking/LightBenchmarkSuit.h"
+#include "LightBenchmarkSuit.h"
 
 #ifdef RELEASE_BUILD
 #define WARMUP 5
@@ -37,11 +37,11 @@
 namespace sd {
 
     template <typename T>
-    static std::string transformBenchmark() {
+    static std::string transformBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "transformBenchmark " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
 
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
         IntPowerParameters length("length", 2, 8, 20, 4);      //2^8, 2^12, 2^16, 2^20 - 4MB
         BoolParameters inplace("inplace");
 
@@ -72,11 +72,11 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string scalarBenchmark() {
+    static std::string scalarBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "scalarBenchmark " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
 
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         IntPowerParameters length("length", 2, 8, 20, 4);      //2^8, 2^12, 2^16, 2^20
         BoolParameters inplace("inplace");
@@ -113,11 +113,11 @@ namespace sd {
 
 
     template <typename T>
-    static std::string pairwiseBenchmark() {
+    static std::string pairwiseBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "pairwiseBenchmark " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
 
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
         IntPowerParameters length("length", 2, 8, 20, 4);      //2^4 to 2^20 in steps of 4 - 2^4, 2^8, 2^16, 2^20
         BoolParameters inplace("inplace");
 
@@ -144,9 +144,9 @@ namespace sd {
         return output;
     }
 
-    static std::string mismatchedOrderAssign() {
+    static std::string mismatchedOrderAssign(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         IntPowerParameters rows("rows", 2, 8, 20, 4);      //2^8, 2^12, 2^16, 2^20
         BoolParameters cf("cf");
@@ -196,10 +196,10 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string gemmBenchmark() {
+    static std::string gemmBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "gemm " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         for (int o = 0; o <= 1; o++) {
             char resultOrder = (o == 0 ? 'f' : 'c');
@@ -237,11 +237,11 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string reduceFullBenchmark() {
+    static std::string reduceFullBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "reduceFullBenchmark " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
 
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         IntPowerParameters length("length", 2, 8, 20, 4);      //2^8, 2^12, 2^16, 2^20
 
@@ -280,11 +280,11 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string reduceDimBenchmark(){
+    static std::string reduceDimBenchmark(BenchmarkReport &report){
         std::string output;
         output += "reduceDimBenchmark " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
 
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         int length[] = {1024*1024};
         int pow[] = {10};
@@ -363,10 +363,10 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string conv2d(){
+    static std::string conv2d(BenchmarkReport &report){
         std::string output;
         output += "conv2d " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         //Convolution2D op
         BoolParameters nhwc("nhwc");
@@ -374,7 +374,7 @@ namespace sd {
 
         ParametersBatch batch({&nhwc, &k});
         sd::ops::conv2d conv2d;
-        DeclarableBenchmark benchmark(conv2d, "conv2d");
+        DeclarableBenchmark benchmark(conv2d, "conv2d", BenchmarkSuit::convolutionFlops);
 
         int hw = 64;
 
@@ -419,10 +419,10 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string pool2d() {
+    static std::string pool2d(BenchmarkReport &report) {
         std::string output;
         output += "pool2d " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         //Convolution2D op
         BoolParameters nhwc("nhwc");
@@ -475,10 +475,10 @@ namespace sd {
     }
 
     template <typename T>
-    static std::string lstmBenchmark() {
+    static std::string lstmBenchmark(BenchmarkReport &report) {
         std::string output;
         output += "lstm " + DataTypeUtils::asString(DataTypeUtils::fromT<T>());
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         BoolParameters format("format");    //0=TNS=[seqLen,mb,size]; 1=NST=[mb,size,seqLen]
         PredefinedParameters mb("mb", {1, 8});
@@ -555,9 +555,9 @@ namespace sd {
         return output;
     }
 
-    static std::string broadcast2d() {
+    static std::string broadcast2d(BenchmarkReport &report) {
         std::string output;
-        BenchmarkHelper helper(WARMUP, NUM_ITER);
+        BenchmarkHelper helper(WARMUP, NUM_ITER, &report);
 
         int rows = 65536;
         IntPowerParameters cols("cols", 2, 2, 12, 4);      //2^2 to 2^12 in steps of 2 - 2^1=2, ..., 2^10=1024
@@ -599,43 +599,45 @@ namespace sd {
 #else
         std::vector<sd::DataType> dtypes({sd::DataType::FLOAT32});
 #endif
+        if (!_dataTypes.empty())
+            dtypes = _dataTypes;
 
         std::string result;
 
         for (auto t:dtypes) {
-            nd4j_printf("Running LightBenchmarkSuite.transformBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += transformBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.transformBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += transformBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.scalarBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += scalarBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.scalarBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += scalarBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.pairwiseBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += pairwiseBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.pairwiseBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += pairwiseBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.reduceFullBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += reduceFullBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.reduceFullBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += reduceFullBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.reduceDimBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += reduceDimBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.reduceDimBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += reduceDimBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.gemmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += gemmBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.gemmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += gemmBenchmark, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.conv2d [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += conv2d, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.conv2d [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += conv2d, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.pool2d [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += pool2d, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.pool2d [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += pool2d, (_report), SD_FLOAT_TYPES);
 
-            nd4j_printf("Running LightBenchmarkSuite.lstmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
-            BUILD_SINGLE_SELECTOR(t, result += lstmBenchmark, (), LIBND4J_TYPES);
+            sd_printf("Running LightBenchmarkSuite.lstmBenchmark [%s]\n", DataTypeUtils::asString(t).c_str());
+            BUILD_SINGLE_SELECTOR(t, result += lstmBenchmark, (_report), SD_FLOAT_TYPES);
 
         }
 
-        nd4j_printf("Running LightBenchmarkSuite.broadcast2d\n", "");
-        result += broadcast2d();
-        nd4j_printf("Running LightBenchmarkSuite.mismatchedOrderAssign\n", "");
-        result += mismatchedOrderAssign();
+        sd_printf("Running LightBenchmarkSuite.broadcast2d\n", "");
+        result += broadcast2d(_report);
+        sd_printf("Running LightBenchmarkSuite.mismatchedOrderAssign\n", "");
+        result += mismatchedOrderAssign(_report);
 
         return result;
     }
@@ -43,6 +43,9 @@ class SD_LIB_EXPORT DataBuffer {
   memory::Workspace *_workspace = nullptr;
   bool _isOwnerPrimary;
   bool _isOwnerSpecial;
+
+  // primary buffer was taken from calling thread's scratch arena, see memory/ScratchArena.h
+  bool _isArenaPrimary = false;
   std::atomic<int> _deviceId;
 
 #ifndef __JAVACPP_HACK__
@@ -102,6 +105,11 @@ class SD_LIB_EXPORT DataBuffer {
   void allocatePrimary();
   void allocateSpecial();
 
+  /**
+   * Moves primary buffer taken from scratch arena to heap, so the array can outlive its op without pinning the arena
+   */
+  void detachFromArena();
+
   void writePrimary() const;
   void writeSpecial() const;
   void readPrimary() const;
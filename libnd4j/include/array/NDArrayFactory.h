@@ -126,6 +126,14 @@ class SD_LIB_EXPORT NDArrayFactory {
    */
   static NDArray fromNpyFile(const char *fileName);
 
+  /**
+   * This method creates NDArray backed by memory mapped .npy file, so data is paged in on demand and never copied.
+   * Writes to the array stay private to the process and never reach the file.
+   * @param fileName
+   * @return
+   */
+  static NDArray mapNpyFile(const char *fileName);
+
   /**
    * This factory create array from utf8 string
    * @return NDArray default dataType UTF8
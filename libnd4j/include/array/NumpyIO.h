@@ -0,0 +1,120 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Memory mapped .npy/.npz access and streaming .npy writer
+//
+#ifndef LIBND4J_NUMPYIO_H
+#define LIBND4J_NUMPYIO_H
+#include <array/NDArray.h>
+#include <helpers/MmapFile.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sd {
+
+/**
+ * This method returns array backed directly by the given part of the mapped file. No data is copied, unless it's
+ * misaligned or stored in foreign byte order. Mapping is kept alive for as long as the array buffer exists.
+ *
+ * @param file - mapped file
+ * @param offset - offset of the .npy header within the file
+ * @param length - length of the .npy content, header included
+ */
+SD_LIB_EXPORT NDArray npyArrayFromMapping(const std::shared_ptr<MmapFile> &file, sd::LongType offset,
+                                          sd::LongType length);
+
+/**
+ * This class provides lazy access to arrays stored in .npz archive. Zip directory is parsed once on open, and nothing
+ * is read until particular array is requested. Stored entries come back as zero-copy views of the mapped file,
+ * deflated ones get decompressed into a new array.
+ */
+class SD_LIB_EXPORT NpzArchive {
+ protected:
+  struct Entry {
+    sd::LongType localHeaderOffset = 0;
+    sd::LongType compressedSize = 0;
+    sd::LongType uncompressedSize = 0;
+    int method = 0;
+  };
+
+  std::shared_ptr<MmapFile> _file;
+  std::map<std::string, Entry> _entries;
+  std::vector<std::string> _names;
+
+ public:
+  explicit NpzArchive(const char *fileName);
+  ~NpzArchive() = default;
+
+  /**
+   * This method returns names of arrays in the order they are stored in archive, without .npy suffix
+   */
+  const std::vector<std::string> &names() const { return _names; }
+
+  bool contains(const std::string &name) const { return _entries.count(name) > 0; }
+
+  int size() const { return static_cast<int>(_names.size()); }
+
+  NDArray array(const std::string &name) const;
+};
+
+/**
+ * This class writes .npy file chunk by chunk, so arrays never have to be materialized in memory as a whole.
+ * If the first dimension of the shape is negative, it's not known in advance and gets computed on close()
+ * from the amount of data written.
+ */
+class SD_LIB_EXPORT NpyWriter {
+ protected:
+  FILE *_file = nullptr;
+  sd::DataType _dataType;
+  std::vector<sd::LongType> _shape;
+  size_t _headerLength = 0;
+  sd::LongType _written = 0;
+
+ public:
+  NpyWriter(const char *fileName, sd::DataType dataType, const std::vector<sd::LongType> &shape);
+  ~NpyWriter();
+
+  NpyWriter(const NpyWriter &other) = delete;
+  NpyWriter &operator=(const NpyWriter &other) = delete;
+
+  /**
+   * This method appends elements of the given array in 'c' order, casting them to the file data type if needed
+   */
+  void write(const NDArray &chunk);
+
+  /**
+   * This method appends raw bytes, which must already be in the file data type
+   */
+  void write(const void *data, sd::LongType bytes);
+
+  /**
+   * This method finalizes the header and closes the file. Called automatically on destruction.
+   */
+  void close();
+
+  sd::LongType bytesWritten() const { return _written; }
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_NUMPYIO_H
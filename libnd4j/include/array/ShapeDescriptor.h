@@ -121,6 +121,14 @@ class SD_LIB_EXPORT ShapeDescriptor {
 
   sd::LongType *toShapeInfo() const;
 
+  // comparisons against descriptors that would be built from given arguments, without building them
+  bool equalsShapeInfo(const sd::LongType *shapeInfo) const;
+  bool equalsShape(const DataType type, const char order, const sd::LongType *shape, const int rank) const;
+
+  // std::hash values of descriptors that would be built from given arguments
+  static size_t hashShapeInfo(const sd::LongType *shapeInfo);
+  static size_t hashShape(const DataType type, const char order, const sd::LongType *shape, const int rank);
+
   static ShapeDescriptor * emptyDescriptor(const DataType type);
   static ShapeDescriptor  * scalarDescriptor(const DataType type);
   static ShapeDescriptor * vectorDescriptor(const sd::LongType length, const DataType type);
@@ -22,6 +22,7 @@
 //
 #include <array/DataBuffer.h>
 #include <array/DataTypeUtils.h>
+#include <memory/ScratchArena.h>
 #if defined(HAVE_VEDA)
 #include <ops/declarable/platform/vednn/veda_helper.h>
 #endif
@@ -37,12 +38,16 @@ void DataBuffer::expand(const uint64_t size) {
     std::memcpy(newBuffer, _primaryBuffer, _lenInBytes);
 
     if (_isOwnerPrimary) {
-      RELEASE(reinterpret_cast<int8_t*>(_primaryBuffer), _workspace);
+      if (_isArenaPrimary)
+        sd::memory::ScratchArena::release(_primaryBuffer);
+      else
+        RELEASE(reinterpret_cast<int8_t*>(_primaryBuffer), _workspace);
     }
 
     _primaryBuffer = newBuffer;
     _lenInBytes = size;
     _isOwnerPrimary = true;
+    _isArenaPrimary = false;
   }
 }
 
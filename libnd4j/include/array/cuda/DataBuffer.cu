@@ -25,6 +25,7 @@
 #include <exceptions/cuda_exception.h>
 #include <execution/AffinityManager.h>
 #include <memory/MemoryCounter.h>
+#include <memory/ScratchArena.h>
 #include <system/op_boilerplate.h>
 
 #include "../DataBuffer.h"
@@ -45,11 +46,15 @@ void DataBuffer::expand(const uint64_t size) {
 
       if (_isOwnerPrimary) {
         auto ipb = reinterpret_cast<int8_t*>(_primaryBuffer);
-        RELEASE(ipb, _workspace);
+        if (_isArenaPrimary)
+          sd::memory::ScratchArena::release(ipb);
+        else
+          RELEASE(ipb, _workspace);
       }
 
       _primaryBuffer = newBuffer;
       _isOwnerPrimary = true;
+      _isArenaPrimary = false;
     }
 
     cudaMemcpy(newSpecialBuffer, _specialBuffer, _lenInBytes, cudaMemcpyDeviceToDevice);
@@ -24,8 +24,12 @@
 #include <array/DataTypeUtils.h>
 #include <exceptions/allocation_exception.h>
 #include <execution/AffinityManager.h>
+#include <helpers/ExecutionTracer.h>
 #include <helpers/logger.h>
 #include <memory/MemoryCounter.h>
+#include <memory/ScratchArena.h>
+
+#include <cstring>
 
 namespace sd {
 ///// IMPLEMENTATION OF COMMON METHODS /////
@@ -152,12 +156,14 @@ DataBuffer::DataBuffer(DataBuffer&& other) {
   _workspace = other._workspace;
   _isOwnerPrimary = other._isOwnerPrimary;
   _isOwnerSpecial = other._isOwnerSpecial;
+  _isArenaPrimary = other._isArenaPrimary;
   _deviceId.store(other._deviceId);
 
   copyCounters(other);
 
   other._primaryBuffer = other._specialBuffer = nullptr;
   other.setAllocFlags(false, false);
+  other._isArenaPrimary = false;
   other._lenInBytes = 0;
 }
 
@@ -192,11 +198,13 @@ DataBuffer& DataBuffer::operator=(DataBuffer&& other) noexcept {
   _workspace = other._workspace;
   _isOwnerPrimary = other._isOwnerPrimary;
   _isOwnerSpecial = other._isOwnerSpecial;
+  _isArenaPrimary = other._isArenaPrimary;
 
   copyCounters(other);
 
   other._primaryBuffer = other._specialBuffer = nullptr;
   other.setAllocFlags(false, false);
+  other._isArenaPrimary = false;
   other._lenInBytes = 0;
 
   return *this;
@@ -226,6 +234,18 @@ size_t DataBuffer::getNumElements()   {
 ////////////////////////////////////////////////////////////////////////
 void DataBuffer::allocatePrimary() {
   if (_primaryBuffer == nullptr && getLenInBytes() > 0) {
+    if (ExecutionTracer::isEnabled()) ExecutionTracer::countAllocation(getLenInBytes());
+
+    // op temporaries without user workspace go to per-thread scratch arena, if there's room
+    if (_workspace == nullptr && sd::memory::ScratchArena::isActive()) {
+      _primaryBuffer = sd::memory::ScratchArena::allocate(getLenInBytes());
+      if (_primaryBuffer != nullptr) {
+        _isOwnerPrimary = true;
+        _isArenaPrimary = true;
+        return;
+      }
+    }
+
     auto deviceId = sd::AffinityManager::currentDeviceId();
     // check if this allocation won't bring us above limit
     if (_workspace == nullptr) {
@@ -257,6 +277,25 @@ void DataBuffer::allocatePrimary() {
   }
 }
 
+////////////////////////////////////////////////////////////////////////
+void DataBuffer::detachFromArena() {
+  if (!_isArenaPrimary || _primaryBuffer == nullptr) return;
+
+  int8_t* heap = nullptr;
+  ALLOCATE(heap, _workspace, getLenInBytes(), int8_t);
+  std::memcpy(heap, _primaryBuffer, getLenInBytes());
+
+  // arena blocks never belong to workspace, so heap copy is counted just like in allocatePrimary()
+  if (Environment::getInstance().isCPU())
+    sd::memory::MemoryCounter::getInstance().countIn(_deviceId, getLenInBytes());
+
+  sd::memory::MemoryCounter::getInstance().countIn(sd::memory::MemoryType::HOST, getLenInBytes());
+
+  sd::memory::ScratchArena::release(_primaryBuffer);
+  _primaryBuffer = heap;
+  _isArenaPrimary = false;
+}
+
 ////////////////////////////////////////////////////////////////////////
 void DataBuffer::setAllocFlags(const bool isOwnerPrimary, const bool isOwnerSpecial) {
   _isOwnerPrimary = isOwnerPrimary;
@@ -267,10 +306,18 @@ void DataBuffer::setAllocFlags(const bool isOwnerPrimary, const bool isOwnerSpec
 void DataBuffer::deletePrimary() {
   if (_isOwnerPrimary && _primaryBuffer != nullptr && getLenInBytes() != 0) {
     auto p = reinterpret_cast<int8_t*>(_primaryBuffer);
-    RELEASE(p, _workspace);
     _primaryBuffer = nullptr;
     _isOwnerPrimary = false;
 
+    // arena blocks are counted by MemoryCounter as part of their arena
+    if (_isArenaPrimary) {
+      _isArenaPrimary = false;
+      sd::memory::ScratchArena::release(p);
+      return;
+    }
+
+    RELEASE(p, _workspace);
+
     // count out towards DataBuffer device, only if we're not in workspace
     if (_workspace == nullptr) {
       if (Environment::getInstance().isCPU())
@@ -23,6 +23,7 @@
 // @author Oleg Semeniv <oleg.semeniv@gmail.com>
 //
 #include <array/NDArrayFactory.h>
+#include <array/NumpyIO.h>
 #include <exceptions/cuda_exception.h>
 #include <graph/GraphExecutioner.h>
 #include <helpers/ConstantHelper.h>
@@ -837,24 +838,15 @@ NDArray NDArrayFactory::string(const std::vector<sd::LongType>& shape, const std
 }
 
 NDArray NDArrayFactory::fromNpyFile(const char* fileName) {
+  // single copy out of the page cache, array doesn't keep the file mapped
+  return mapNpyFile(fileName).dup();
+}
+
+NDArray NDArrayFactory::mapNpyFile(const char* fileName) {
   auto size = sd::graph::getFileSize(fileName);
   if (size < 0) THROW_EXCEPTION("File doesn't exit");
 
-  auto pNPY = reinterpret_cast<char*>(::numpyFromFile(std::string(fileName)));
-
-  auto nBuffer = reinterpret_cast<void*>(::dataPointForNumpy(pNPY));
-  auto shape = reinterpret_cast<sd::LongType*>(::shapeBufferForNumpy(pNPY));
-
-  auto length = shape::length(shape);
-  int8_t* buffer = nullptr;
-  sd::memory::Workspace* workspace = nullptr;
-  auto byteLen = length * DataTypeUtils::sizeOfElement(ArrayOptions::dataType(shape));
-
-  ALLOCATE(buffer, workspace, byteLen, int8_t);
-  memcpy(buffer, nBuffer, byteLen);
-
-  free(pNPY);
-
-  return NDArray(buffer, shape, LaunchContext::defaultContext(), true);
+  auto file = std::make_shared<MmapFile>(fileName);
+  return npyArrayFromMapping(file, 0, file->length());
 }
 }  // namespace sd
@@ -0,0 +1,540 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Memory mapped .npy/.npz access and streaming .npy writer
+//
+#include <array/NumpyIO.h>
+#include <cnpy/cnpy.h>
+#include <helpers/ConstantShapeHelper.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace sd {
+
+// DataBuffer over a part of mapped file, keeps the mapping alive
+class MappedDataBuffer : public DataBuffer {
+ private:
+  std::shared_ptr<MmapFile> _file;
+
+ public:
+  MappedDataBuffer(const std::shared_ptr<MmapFile> &file, void *primary, size_t lenInBytes, DataType dataType)
+      : DataBuffer(primary, lenInBytes, dataType, false), _file(file) {}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// little endian readers for zip structures
+static SD_INLINE uint64_t readLE(const char *p, int bytes) {
+  uint64_t result = 0;
+  for (int e = bytes - 1; e >= 0; e--) result = (result << 8) | static_cast<unsigned char>(p[e]);
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// RFC 1951 decoder for deflated .npz entries, zlib isn't a dependency of the library
+class Inflater {
+ private:
+  struct Huffman {
+    short count[16];
+    short symbol[288];
+  };
+
+  const unsigned char *_in;
+  size_t _inLength;
+  size_t _inPos = 0;
+  uint64_t _bitBuffer = 0;
+  int _bitCount = 0;
+
+  unsigned char *_out;
+  size_t _outLength;
+  size_t _outPos = 0;
+
+  SD_INLINE int bits(int need) {
+    while (_bitCount < need) {
+      if (_inPos >= _inLength) THROW_EXCEPTION("NpzArchive: deflate stream is truncated");
+
+      _bitBuffer |= static_cast<uint64_t>(_in[_inPos++]) << _bitCount;
+      _bitCount += 8;
+    }
+
+    auto result = static_cast<int>(_bitBuffer & ((1ULL << need) - 1));
+    _bitBuffer >>= need;
+    _bitCount -= need;
+    return result;
+  }
+
+  static void build(Huffman &h, const short *lengths, int n) {
+    short offsets[16];
+    memset(h.count, 0, sizeof(h.count));
+    for (int e = 0; e < n; e++) h.count[lengths[e]]++;
+
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h.count[len];
+
+    for (int e = 0; e < n; e++)
+      if (lengths[e] != 0) h.symbol[offsets[lengths[e]]++] = static_cast<short>(e);
+  }
+
+  int decode(const Huffman &h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+      code |= bits(1);
+      const int count = h.count[len];
+      if (code - count < first) return h.symbol[index + (code - first)];
+
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+    }
+
+    THROW_EXCEPTION("NpzArchive: invalid Huffman code in deflate stream");
+  }
+
+  void stored() {
+    _bitBuffer = 0;
+    _bitCount = 0;
+
+    if (_inPos + 4 > _inLength) THROW_EXCEPTION("NpzArchive: deflate stream is truncated");
+    const size_t len = _in[_inPos] | (_in[_inPos + 1] << 8);
+    _inPos += 4;
+
+    if (_inPos + len > _inLength || _outPos + len > _outLength)
+      THROW_EXCEPTION("NpzArchive: stored block doesn't fit");
+
+    memcpy(_out + _outPos, _in + _inPos, len);
+    _inPos += len;
+    _outPos += len;
+  }
+
+  void codes(const Huffman &lengthCode, const Huffman &distCode) {
+    static const short lengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                       31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const short lengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int distBase[] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                   193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const short distExtra[] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                      6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    while (true) {
+      int symbol = decode(lengthCode);
+      if (symbol < 256) {
+        if (_outPos >= _outLength) THROW_EXCEPTION("NpzArchive: entry is bigger than declared");
+
+        _out[_outPos++] = static_cast<unsigned char>(symbol);
+      } else if (symbol == 256) {
+        return;
+      } else {
+        symbol -= 257;
+        if (symbol >= 29) THROW_EXCEPTION("NpzArchive: invalid length code in deflate stream");
+
+        const size_t len = lengthBase[symbol] + bits(lengthExtra[symbol]);
+
+        symbol = decode(distCode);
+        if (symbol >= 30) THROW_EXCEPTION("NpzArchive: invalid distance code in deflate stream");
+
+        const size_t dist = distBase[symbol] + bits(distExtra[symbol]);
+        if (dist > _outPos || _outPos + len > _outLength) THROW_EXCEPTION("NpzArchive: invalid back reference");
+
+        // regions may overlap, so byte by byte
+        for (size_t e = 0; e < len; e++, _outPos++) _out[_outPos] = _out[_outPos - dist];
+      }
+    }
+  }
+
+  // fixed Huffman codes of RFC 1951 3.2.6
+  struct FixedCodes {
+    Huffman lengthCode, distCode;
+
+    FixedCodes() {
+      short lengths[288];
+      int e = 0;
+      for (; e < 144; e++) lengths[e] = 8;
+      for (; e < 256; e++) lengths[e] = 9;
+      for (; e < 280; e++) lengths[e] = 7;
+      for (; e < 288; e++) lengths[e] = 8;
+      build(lengthCode, lengths, 288);
+
+      for (e = 0; e < 30; e++) lengths[e] = 5;
+      build(distCode, lengths, 30);
+    }
+  };
+
+  void fixed() {
+    // built once, initialization of a function-local static is thread safe, so archives may be read concurrently
+    static const FixedCodes tables;
+    codes(tables.lengthCode, tables.distCode);
+  }
+
+  void dynamic() {
+    static const short order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    short lengths[320];
+    Huffman lengthCode, distCode;
+
+    const int nlen = bits(5) + 257;
+    const int ndist = bits(5) + 1;
+    const int ncode = bits(4) + 4;
+    if (nlen > 286 || ndist > 30) THROW_EXCEPTION("NpzArchive: bad dynamic block header");
+
+    int e = 0;
+    for (; e < ncode; e++) lengths[order[e]] = static_cast<short>(bits(3));
+    for (; e < 19; e++) lengths[order[e]] = 0;
+    build(lengthCode, lengths, 19);
+
+    for (e = 0; e < nlen + ndist;) {
+      int symbol = decode(lengthCode);
+      if (symbol < 16) {
+        lengths[e++] = static_cast<short>(symbol);
+        continue;
+      }
+
+      short value = 0;
+      int repeat;
+      if (symbol == 16) {
+        if (e == 0) THROW_EXCEPTION("NpzArchive: repeat with no previous length");
+
+        value = lengths[e - 1];
+        repeat = 3 + bits(2);
+      } else if (symbol == 17) {
+        repeat = 3 + bits(3);
+      } else {
+        repeat = 11 + bits(7);
+      }
+
+      if (e + repeat > nlen + ndist) THROW_EXCEPTION("NpzArchive: too many code lengths");
+      while (repeat--) lengths[e++] = value;
+    }
+
+    if (lengths[256] == 0) THROW_EXCEPTION("NpzArchive: no end-of-block code");
+
+    build(lengthCode, lengths, nlen);
+    build(distCode, lengths + nlen, ndist);
+
+    codes(lengthCode, distCode);
+  }
+
+ public:
+  Inflater(const void *in, size_t inLength, void *out, size_t outLength)
+      : _in(reinterpret_cast<const unsigned char *>(in)),
+        _inLength(inLength),
+        _out(reinterpret_cast<unsigned char *>(out)),
+        _outLength(outLength) {}
+
+  size_t inflate() {
+    int last;
+    do {
+      last = bits(1);
+      switch (bits(2)) {
+        case 0:
+          stored();
+          break;
+        case 1:
+          fixed();
+          break;
+        case 2:
+          dynamic();
+          break;
+        default:
+          THROW_EXCEPTION("NpzArchive: invalid deflate block type");
+      }
+    } while (!last);
+
+    return _outPos;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////
+static NDArray arrayFromHeader(const cnpy::NpyHeader &header, const char *data, sd::LongType available,
+                               const std::shared_ptr<MmapFile> &file) {
+  const auto order = header.fortranOrder ? 'f' : 'c';
+
+  sd::LongType length = 1;
+  for (auto v : header.shape) length *= v;
+
+  if (length == 0) return NDArray(order, header.shape, header.dataType);
+
+  const auto bytes = length * static_cast<sd::LongType>(header.wordSize);
+  if (bytes > available) THROW_EXCEPTION("npyArrayFromMapping: file is shorter than array described by header");
+
+  auto shapeInfo = ConstantShapeHelper::getInstance().createShapeInfo(header.dataType, order, header.shape);
+
+  const bool aligned = reinterpret_cast<uintptr_t>(data) % header.wordSize == 0;
+  if (file != nullptr && aligned && !header.bigEndian) {
+    auto buffer = std::make_shared<MappedDataBuffer>(file, const_cast<char *>(data), bytes, header.dataType);
+    return NDArray(buffer, const_cast<sd::LongType *>(shapeInfo), LaunchContext::defaultContext(), 0);
+  }
+
+  NDArray result(order, header.shape, header.dataType);
+  auto z = reinterpret_cast<char *>(result.buffer());
+  if (!header.bigEndian || header.wordSize == 1) {
+    memcpy(z, data, bytes);
+  } else {
+    for (sd::LongType e = 0; e < length; e++)
+      for (unsigned int b = 0; b < header.wordSize; b++)
+        z[e * header.wordSize + b] = data[e * header.wordSize + header.wordSize - 1 - b];
+  }
+
+  result.tickWriteHost();
+  return result;
+}
+
+NDArray npyArrayFromMapping(const std::shared_ptr<MmapFile> &file, sd::LongType offset, sd::LongType length) {
+  if (offset < 0 || offset + length > file->length()) THROW_EXCEPTION("npyArrayFromMapping: range is out of file");
+
+  const auto data = file->data() + offset;
+  auto header = cnpy::readNpyHeader(data, static_cast<size_t>(length));
+
+  return arrayFromHeader(header, data + header.dataOffset, length - header.dataOffset, file);
+}
+
+//////////////////////////////////////////////////////////////////////////
+NpzArchive::NpzArchive(const char *fileName) : _file(std::make_shared<MmapFile>(fileName)) {
+  const auto data = _file->data();
+  const auto length = _file->length();
+
+  // end of central directory record: 22 bytes, followed by up to 64K of comment
+  sd::LongType eocd = -1;
+  for (sd::LongType e = length - 22; e >= 0 && e >= length - 22 - 65535; e--)
+    if (readLE(data + e, 4) == 0x06054b50) {
+      eocd = e;
+      break;
+    }
+
+  if (eocd < 0) THROW_EXCEPTION(("NpzArchive: not a zip archive: " + std::string(fileName)).c_str());
+
+  uint64_t numEntries = readLE(data + eocd + 10, 2);
+  uint64_t directoryOffset = readLE(data + eocd + 16, 4);
+
+  // archives over 4GB or with 64K+ entries keep real values in zip64 records
+  if (eocd >= 20 && readLE(data + eocd - 20, 4) == 0x07064b50) {
+    auto zip64 = static_cast<sd::LongType>(readLE(data + eocd - 20 + 8, 8));
+    if (zip64 < 0 || zip64 + 56 > length || readLE(data + zip64, 4) != 0x06064b50)
+      THROW_EXCEPTION("NpzArchive: broken zip64 end of central directory");
+
+    numEntries = readLE(data + zip64 + 32, 8);
+    directoryOffset = readLE(data + zip64 + 48, 8);
+  }
+
+  auto p = static_cast<sd::LongType>(directoryOffset);
+  for (uint64_t n = 0; n < numEntries; n++) {
+    if (p + 46 > length || readLE(data + p, 4) != 0x02014b50)
+      THROW_EXCEPTION("NpzArchive: broken central directory");
+
+    Entry entry;
+    entry.method = static_cast<int>(readLE(data + p + 10, 2));
+    uint64_t compressed = readLE(data + p + 20, 4);
+    uint64_t uncompressed = readLE(data + p + 24, 4);
+    uint64_t localOffset = readLE(data + p + 42, 4);
+
+    const auto nameLength = static_cast<sd::LongType>(readLE(data + p + 28, 2));
+    const auto extraLength = static_cast<sd::LongType>(readLE(data + p + 30, 2));
+    const auto commentLength = static_cast<sd::LongType>(readLE(data + p + 32, 2));
+    if (p + 46 + nameLength + extraLength > length) THROW_EXCEPTION("NpzArchive: broken central directory");
+
+    std::string name(data + p + 46, nameLength);
+
+    // zip64 extra field holds 64-bit values for every 32-bit field saturated to 0xFFFFFFFF, in this order
+    for (auto x = p + 46 + nameLength; x + 4 <= p + 46 + nameLength + extraLength;) {
+      const auto id = readLE(data + x, 2);
+      const auto size = static_cast<sd::LongType>(readLE(data + x + 2, 2));
+      const auto end = x + 4 + size;
+      if (end > p + 46 + nameLength + extraLength) THROW_EXCEPTION("NpzArchive: broken extra field");
+
+      if (id == 0x0001) {
+        auto f = x + 4;
+        auto next = [&]() -> uint64_t {
+          if (f + 8 > end) THROW_EXCEPTION("NpzArchive: zip64 extra field is too short");
+
+          f += 8;
+          return readLE(data + f - 8, 8);
+        };
+
+        if (uncompressed == 0xFFFFFFFFULL) uncompressed = next();
+        if (compressed == 0xFFFFFFFFULL) compressed = next();
+        if (localOffset == 0xFFFFFFFFULL) localOffset = next();
+      }
+
+      x = end;
+    }
+
+    p += 46 + nameLength + extraLength + commentLength;
+
+    if (entry.method != 0 && entry.method != 8)
+      THROW_EXCEPTION(("NpzArchive: unsupported compression method for entry " + name).c_str());
+
+    entry.compressedSize = static_cast<sd::LongType>(compressed);
+    entry.uncompressedSize = static_cast<sd::LongType>(uncompressed);
+    entry.localHeaderOffset = static_cast<sd::LongType>(localOffset);
+
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) name.resize(name.size() - 4);
+
+    _entries[name] = entry;
+    _names.emplace_back(name);
+  }
+}
+
+NDArray NpzArchive::array(const std::string &name) const {
+  auto it = _entries.find(name);
+  if (it == _entries.end()) THROW_EXCEPTION(("NpzArchive: no such array: " + name).c_str());
+
+  const auto &entry = it->second;
+  const auto data = _file->data();
+
+  // local header may carry its own extra field, so data offset is only known from it
+  const auto local = entry.localHeaderOffset;
+  if (local + 30 > _file->length() || readLE(data + local, 4) != 0x04034b50)
+    THROW_EXCEPTION("NpzArchive: broken local file header");
+
+  const auto offset = local + 30 + static_cast<sd::LongType>(readLE(data + local + 26, 2)) +
+                      static_cast<sd::LongType>(readLE(data + local + 28, 2));
+  if (offset + entry.compressedSize > _file->length()) THROW_EXCEPTION("NpzArchive: entry is out of file");
+
+  if (entry.method == 0) return npyArrayFromMapping(_file, offset, entry.compressedSize);
+
+  // deflated entry: whole .npy content is inflated into the buffer of resulting array, since header length isn't
+  // known upfront, and array is placed past the header within that buffer
+  const auto size = static_cast<size_t>(entry.uncompressedSize);
+  auto buffer = std::make_shared<DataBuffer>(size, sd::DataType::INT8);
+  auto content = reinterpret_cast<char *>(buffer->primary());
+
+  Inflater inflater(data + offset, static_cast<size_t>(entry.compressedSize), content, size);
+  if (inflater.inflate() != size) THROW_EXCEPTION("NpzArchive: entry is shorter than declared");
+
+  auto header = cnpy::readNpyHeader(content, size);
+  const auto available = static_cast<sd::LongType>(size - header.dataOffset);
+
+  // headers are padded to 16 or 64 bytes, so this only fails for hand-made files
+  if (header.dataOffset % header.wordSize != 0)
+    return arrayFromHeader(header, content + header.dataOffset, available, nullptr);
+
+  const auto order = header.fortranOrder ? 'f' : 'c';
+  sd::LongType length = 1;
+  for (auto v : header.shape) length *= v;
+
+  if (length == 0) return NDArray(order, header.shape, header.dataType);
+
+  const auto bytes = length * static_cast<sd::LongType>(header.wordSize);
+  if (bytes > available) THROW_EXCEPTION("NpzArchive: entry is shorter than array described by header");
+
+  auto z = content + header.dataOffset;
+  if (header.bigEndian && header.wordSize > 1)
+    for (sd::LongType e = 0; e < length; e++) std::reverse(z + e * header.wordSize, z + (e + 1) * header.wordSize);
+
+  buffer->setDataType(header.dataType);
+  auto shapeInfo = ConstantShapeHelper::getInstance().createShapeInfo(header.dataType, order, header.shape);
+  NDArray result(buffer, const_cast<sd::LongType *>(shapeInfo), LaunchContext::defaultContext(),
+                 static_cast<sd::LongType>(header.dataOffset / header.wordSize));
+  result.tickWriteHost();
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+NpyWriter::NpyWriter(const char *fileName, sd::DataType dataType, const std::vector<sd::LongType> &shape)
+    : _dataType(dataType), _shape(shape) {
+  _file = fopen(fileName, "wb");
+  if (_file == nullptr) THROW_EXCEPTION(("NpyWriter: unable to open file " + std::string(fileName)).c_str());
+
+  // unknown number of rows: header is written with room for the widest possible value, and rewritten in place later
+  auto reserved = _shape;
+  if (!reserved.empty() && reserved[0] < 0) reserved[0] = std::numeric_limits<sd::LongType>::max();
+
+  for (size_t e = 1; e < _shape.size(); e++)
+    if (_shape[e] < 0) THROW_EXCEPTION("NpyWriter: only the first dimension can be unknown");
+
+  auto header = cnpy::createNpyHeader(_dataType, reserved);
+  _headerLength = header.size();
+
+  if (fwrite(header.data(), 1, header.size(), _file) != header.size()) THROW_EXCEPTION("NpyWriter: write failed");
+}
+
+NpyWriter::~NpyWriter() {
+  if (_file == nullptr) return;
+
+  try {
+    close();
+  } catch (std::exception &e) {
+    sd_printf("NpyWriter: %s\n", e.what());
+  }
+}
+
+void NpyWriter::write(const void *data, sd::LongType bytes) {
+  if (_file == nullptr) THROW_EXCEPTION("NpyWriter: file is closed already");
+
+  if (bytes > 0 && fwrite(data, 1, static_cast<size_t>(bytes), _file) != static_cast<size_t>(bytes))
+    THROW_EXCEPTION("NpyWriter: write failed");
+
+  _written += bytes;
+}
+
+void NpyWriter::write(const NDArray &chunk) {
+  if (chunk.isEmpty()) return;
+
+  const bool direct = chunk.dataType() == _dataType && chunk.ordering() == 'c' && chunk.ews() == 1;
+  if (direct) {
+    chunk.syncToHost();
+    write(chunk.buffer(), chunk.lengthOf() * chunk.sizeOfT());
+    return;
+  }
+
+  auto contiguous = chunk.dataType() == _dataType ? chunk.dup('c') : chunk.cast(_dataType).dup('c');
+  contiguous.syncToHost();
+  write(contiguous.buffer(), contiguous.lengthOf() * contiguous.sizeOfT());
+}
+
+void NpyWriter::close() {
+  if (_file == nullptr) return;
+
+  auto file = _file;
+  _file = nullptr;
+
+  sd::LongType rowLength = 1;
+  for (size_t e = 1; e < _shape.size(); e++) rowLength *= _shape[e];
+
+  const auto rowBytes = rowLength * DataTypeUtils::sizeOfElement(_dataType);
+  auto shape = _shape;
+  if (!shape.empty() && shape[0] < 0) {
+    if (rowBytes > 0 && _written % rowBytes != 0) {
+      fclose(file);
+      THROW_EXCEPTION("NpyWriter: amount of data written isn't a whole number of rows");
+    }
+
+    shape[0] = rowBytes > 0 ? _written / rowBytes : 0;
+
+    auto header = cnpy::createNpyHeader(_dataType, shape, _headerLength);
+    if (header.size() != _headerLength || fseek(file, 0, SEEK_SET) != 0 ||
+        fwrite(header.data(), 1, header.size(), file) != header.size()) {
+      fclose(file);
+      THROW_EXCEPTION("NpyWriter: unable to update header");
+    }
+  } else {
+    sd::LongType expected = rowBytes;
+    if (!shape.empty()) expected *= shape[0];
+
+    if (expected != _written) {
+      fclose(file);
+      THROW_EXCEPTION("NpyWriter: amount of data written doesn't match the shape");
+    }
+  }
+
+  if (fclose(file) != 0) THROW_EXCEPTION("NpyWriter: unable to close file");
+}
+
+}  // namespace sd
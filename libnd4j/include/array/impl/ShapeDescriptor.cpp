@@ -395,20 +395,82 @@ ShapeDescriptor  * ShapeDescriptor::paddedBufferDescriptor(const DataType type,
   return descriptor;
 }
 
+// values are shape, followed by strides if they're hashed at all
+static size_t hashDescriptor(const char order, const DataType dataType, const sd::LongType *values, const int length) {
+  auto res = std::hash<char>()(order);
+  res ^= std::hash<int>()((int)dataType) + 0x9e3779b9 + (res << 6) + (res >> 2);
+  for (int j = 0; j < length; j++) {
+    res ^= std::hash<sd::LongType>()(values[j]) + 0x9e3779b9 + (res << 6) + (res >> 2);
+  }
+
+  return res;
+}
+
+size_t ShapeDescriptor::hashShapeInfo(const sd::LongType *shapeInfo) {
+  const int rank = shape::rank(shapeInfo);
+  const auto stop = shape::elementWiseStride(shapeInfo) == 1 ? rank : 2 * rank;
+  return hashDescriptor(shape::order(shapeInfo), ArrayOptions::dataType(shapeInfo), shape::shapeOf(shapeInfo), stop);
+}
+
+size_t ShapeDescriptor::hashShape(const DataType type, const char order, const sd::LongType *shape, const int rank) {
+  return hashDescriptor(order, type, shape, rank);
+}
+
+bool ShapeDescriptor::equalsShapeInfo(const sd::LongType *shapeInfo) const {
+  const int rank = shape::rank(shapeInfo);
+  if (_rank != rank || _order != shape::order(shapeInfo) || _ews != shape::elementWiseStride(shapeInfo) ||
+      _dataType != ArrayOptions::dataType(shapeInfo))
+    return false;
+
+  auto extras = ArrayOptions::propertyWithoutDataType(shapeInfo);
+  auto shapePtr = shape::shapeOf(shapeInfo);
+  for (int e = 0; e < rank; e++)
+    if (shapePtr[e] == 0) extras |= ARRAY_EMPTY;
+
+  if (_extraProperties != extras) return false;
+
+  // shape and strides are contiguous in shapeInfo as well
+  for (int e = 0; e < 2 * rank; e++)
+    if (_shape_strides[e] != shapePtr[e]) return false;
+
+  return true;
+}
+
+bool ShapeDescriptor::equalsShape(const DataType type, const char order, const sd::LongType *shape,
+                                  const int rank) const {
+  if (_rank != rank || _order != order || _dataType != type || _ews != 1 || rank > SD_MAX_RANK) return false;
+
+  bool empty = false;
+  for (int e = 0; e < rank; e++) {
+    if (_shape_strides[e] != shape[e]) return false;
+    if (shape[e] == 0) empty = true;
+  }
+
+  if (_extraProperties != (empty ? ARRAY_EMPTY : 0)) return false;
+  if (rank == 0) return true;
+
+  // same strides fillStrides() would produce
+  sd::LongType strides[SD_MAX_RANK];
+  if (empty)
+    for (int e = 0; e < rank; e++) strides[e] = 0;
+  else if (order == 'c')
+    shape::calcStrides(shape, rank, strides);
+  else
+    shape::calcStridesFortran(shape, rank, strides);
+
+  for (int e = 0; e < rank; e++)
+    if (_shape_strides[rank + e] != strides[e]) return false;
+
+  return true;
+}
+
 }  // namespace sd
 
 namespace std {
 size_t hash<sd::ShapeDescriptor>::operator()(const sd::ShapeDescriptor &k) const {
-  auto res = std::hash<char>()(k.order());
-  res ^= std::hash<int>()((int)k.dataType()) + 0x9e3779b9 + (res << 6) + (res >> 2);
-  auto shape_strides = const_cast<sd::ShapeDescriptor &>(k).shape_strides();
-  auto ptr = shape_strides.data();
+  auto &shape_strides = const_cast<sd::ShapeDescriptor &>(k).shape_strides();
   //dont include strides if its' ews==1
   int stop = k.ews()==1? shape_strides.size()/2 : shape_strides.size() ;
-  for (int j=0; j < stop; j++) {
-    res ^= std::hash<sd::LongType>()(ptr[j]) + 0x9e3779b9 + (res << 6) + (res >> 2);
-  }
-
-  return res;
+  return sd::hashDescriptor(k.order(), k.dataType(), shape_strides.data(), stop);
 }
 }  // namespace std
@@ -62,6 +62,20 @@ struct NpyArray {
   void destruct() { delete[] data; }
 };
 
+/**
+ * Parsed numpy header, as found at the beginning of .npy file or .npz entry
+ */
+struct NpyHeader {
+  sd::DataType dataType = sd::DataType::INHERIT;
+  std::vector<sd::LongType> shape;
+  bool fortranOrder = false;
+  bool bigEndian = false;
+  unsigned int wordSize = 0;
+
+  // offset of the first data byte from the beginning of the header
+  size_t dataOffset = 0;
+};
+
 struct SD_LIB_EXPORT npz_t : public std::map<std::string, NpyArray> {
   void destruct() {
     npz_t::iterator it = this->begin();
@@ -214,6 +228,26 @@ SD_LIB_EXPORT NpyArray loadNpyFromHeader(char *data);
 SD_LIB_EXPORT npz_t npzLoad(std::string fname);
 
 SD_LIB_EXPORT sd::DataType dataTypeFromHeader(char *data);
+
+/**
+ * Parse the numpy header (format versions 1, 2 and 3) from memory,
+ * never reading past the given length
+ * @param data pointer to the magic string
+ * @param length number of bytes available
+ * @return the parsed header
+ */
+SD_LIB_EXPORT NpyHeader readNpyHeader(const char *data, size_t length);
+
+/**
+ * Create the numpy header for the given data type and shape,
+ * padded with spaces to exactly minLength bytes if it's shorter
+ * @param dataType the data type of the array
+ * @param shape the shape of the array
+ * @param minLength the minimal header length, 0 for default padding
+ * @return the header bytes
+ */
+SD_LIB_EXPORT std::vector<char> createNpyHeader(sd::DataType dataType, const std::vector<sd::LongType> &shape,
+                                                size_t minLength = 0);
 /**
  * Parse the numpy header from
  * the given file
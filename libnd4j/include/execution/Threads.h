@@ -138,6 +138,19 @@ class SD_LIB_EXPORT Threads {
   static int parallel_tad(FUNC_1D function, long long int start, long long int stop, long long int increment = 1,
                           long long int numThreads = sd::Environment::getInstance().maxMasterThreads());
 
+  /**
+   * This function executes 1 dimensional loop with dynamic load balancing, meant for iterations of uneven cost,
+   * i.e. TADs of different effective length. Threads grab shrinking chunks of at least grain iterations until the
+   * range is exhausted.
+   * PLEASE NOTE: unlike parallel_for, function can be called several times with the same thread_id, each time with
+   * another part of the range. Calls with the same thread_id never overlap in time.
+   *
+   * @return number of thread ids used
+   */
+  static int parallel_dynamic(FUNC_1D function, long long int start, long long int stop, long long int increment = 1,
+                              long long int numThreads = sd::Environment::getInstance().maxMasterThreads(),
+                              long long int grain = 1);
+
   /**
    * This method will execute function splitting 2 nested loops space with multiple threads
    *
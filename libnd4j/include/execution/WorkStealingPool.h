@@ -0,0 +1,184 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Work-stealing scheduler behind samediff::Threads.
+//
+// Every worker owns a Chase-Lev deque: the owner pushes and pops at the bottom without locks, idle threads steal
+// from the top. Tasks submitted from outside of the pool go through a small injection queue. A thread waiting for
+// its tasks keeps executing the ones nobody has taken yet instead of blocking, so nested parallel calls made from
+// tasks simply add more work to the pool rather than running serially. Idle workers spin for a while, then park.
+//
+#ifndef SAMEDIFF_WORKSTEALINGPOOL_H
+#define SAMEDIFF_WORKSTEALINGPOOL_H
+#include <system/common.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(SD_IOS_BUILD) || defined(SD_APPLE_BUILD) || defined(SD_ANDROID_BUILD) || defined(__NEC__)
+// no reliable thread_local on these targets, Threads stays on ThreadPool
+#define SD_WORK_STEALING_DISABLED
+#endif
+
+namespace samediff {
+class TaskGroup;
+
+struct Task {
+  void (*function)(void *payload, int64_t index) = nullptr;
+  void *payload = nullptr;
+  int64_t index = 0;
+  TaskGroup *group = nullptr;
+};
+
+/**
+ * This class tracks completion of a set of tasks submitted together
+ */
+class SD_LIB_EXPORT TaskGroup {
+ private:
+  std::atomic<int64_t> _pending;
+  std::mutex _lock;
+  std::condition_variable _condition;
+  std::exception_ptr _error;
+
+ public:
+  TaskGroup() : _pending(0) {}
+  ~TaskGroup();
+
+  void add(int64_t numTasks) { _pending.fetch_add(numTasks, std::memory_order_relaxed); }
+
+  void done();
+
+  // first exception thrown by a task is kept, and rethrown by WorkStealingPool::wait()
+  void fail(std::exception_ptr error);
+  void rethrow();
+
+  bool finished() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+  // blocks until the group is finished, or for a short while at most
+  void park();
+};
+
+/**
+ * Fixed capacity Chase-Lev deque. push() and pop() may be called by the owner thread only, steal() by anyone.
+ */
+class SD_LIB_EXPORT TaskDeque {
+ private:
+  static const int64_t kCapacity = 4096;
+
+  alignas(64) std::atomic<int64_t> _top;
+  alignas(64) std::atomic<int64_t> _bottom;
+  std::atomic<Task *> _tasks[kCapacity];
+
+ public:
+  TaskDeque();
+  ~TaskDeque() = default;
+
+  // returns false if deque is full, task should be executed right away then
+  bool push(Task *task);
+  Task *pop();
+  Task *steal();
+};
+
+class SD_LIB_EXPORT WorkStealingPool {
+ private:
+  std::vector<std::thread> _threads;
+  std::vector<TaskDeque *> _deques;
+
+  std::mutex _injectionLock;
+  std::deque<Task *> _injection;
+  std::atomic<int64_t> _injected;
+
+  std::mutex _parkLock;
+  std::condition_variable _parkCondition;
+  std::atomic<int> _sleepers;
+  std::atomic<uint64_t> _epoch;
+
+  void workerLoop(int workerId);
+  void wakeUp(int numTasks);
+  Task *findTask(int workerId, uint64_t &seed);
+  Task *findGroupTask(int workerId, TaskGroup &group);
+  static void execute(Task *task);
+
+ protected:
+  WorkStealingPool();
+  ~WorkStealingPool();
+
+ public:
+  static WorkStealingPool &getInstance();
+
+  int numWorkers() const { return static_cast<int>(_threads.size()); }
+
+  /**
+   * This method returns index of the pool worker running the calling thread, or -1 for other threads
+   */
+  static int currentWorker();
+
+  /**
+   * This method makes tasks available for execution. They must stay alive until their group is finished.
+   */
+  void submit(Task *tasks, int numTasks);
+
+  /**
+   * This method returns once all tasks of the group are finished, executing pending tasks of that group in the
+   * meantime
+   */
+  void wait(TaskGroup &group);
+
+  /**
+   * This method executes body(e) for e in [0, numTasks), calling thread takes part in execution
+   */
+  template <typename F>
+  void parallel(int numTasks, F &body) {
+    if (numTasks <= 0) return;
+
+    TaskGroup group;
+    std::vector<Task> tasks(numTasks - 1);
+    for (int e = 0; e < numTasks - 1; e++) {
+      tasks[e].function = &invoke<F>;
+      tasks[e].payload = &body;
+      tasks[e].index = e + 1;
+      tasks[e].group = &group;
+    }
+
+    group.add(numTasks - 1);
+    submit(tasks.data(), numTasks - 1);
+
+    try {
+      body(0);
+    } catch (...) {
+      group.fail(std::current_exception());
+    }
+
+    wait(group);
+  }
+
+ private:
+  template <typename F>
+  static void invoke(void *payload, int64_t index) {
+    (*reinterpret_cast<F *>(payload))(index);
+  }
+};
+}  // namespace samediff
+
+#endif  // SAMEDIFF_WORKSTEALINGPOOL_H
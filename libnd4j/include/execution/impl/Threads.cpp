@@ -21,6 +21,8 @@
  //
 #include <execution/Threads.h>
 #include <execution/ThreadPool.h>
+#include <execution/WorkStealingPool.h>
+#include <atomic>
 #include <vector>
 #include <thread>
 #include <helpers/logger.h>
@@ -36,6 +38,16 @@
 
 namespace samediff {
 
+	// checked per call, so scheduler can be switched at runtime. OpenMP builds use it as well: nested
+	// omp regions are declined by tryAcquire and run serially, while pool tasks compose
+	static SD_INLINE bool useWorkStealing() {
+#ifdef SD_WORK_STEALING_DISABLED
+		return false;
+#else
+		return sd::Environment::getInstance().isUseWorkStealing();
+#endif
+	}
+
 	int ThreadsHelper::numberOfThreads(int maxThreads, uint64_t numberOfElements) {
 		// let's see how many threads we actually need first
 		auto optimalThreads = sd::math::sd_max<uint64_t>(1, numberOfElements / 1024);
@@ -390,6 +402,18 @@ namespace samediff {
 			return 1;
 		}
 
+		if (useWorkStealing()) {
+			auto span = delta / numThreads;
+			auto body = [&](int64_t e) {
+				auto start_ = span * e + start;
+				auto stop_ = e == numThreads - 1 ? stop : start_ + span;
+				function(e, start_, stop_, increment);
+			};
+
+			WorkStealingPool::getInstance().parallel(numThreads, body);
+			return numThreads;
+		}
+
 #ifdef _OPENMP
                 if (tryAcquire(numThreads)) {
 
@@ -414,7 +438,6 @@ namespace samediff {
 		}
 #else
 
-		sd::Environment::getInstance().maxThreads();
 		auto ticket = ThreadPool::getInstance().tryAcquire(numThreads);
 		if (ticket != nullptr) {
 
@@ -450,6 +473,44 @@ namespace samediff {
 #endif
 	}
 
+	int Threads::parallel_dynamic(FUNC_1D function, sd::LongType start, sd::LongType stop, sd::LongType increment,
+                                      sd::LongType numThreads, sd::LongType grain) {
+		if (start > stop)
+			THROW_EXCEPTION("Threads::parallel_dynamic got start > stop");
+
+		auto iterations = (stop - start + increment - 1) / increment;
+		if (iterations == 0)
+			return 1;
+
+		if (grain < 1)
+			grain = 1;
+
+		numThreads = sd::math::sd_min<sd::LongType>(numThreads, (iterations + grain - 1) / grain);
+		if (numThreads <= 1) {
+			function(0, start, stop, increment);
+			return 1;
+		}
+
+		// guided self-scheduling: chunks shrink as the range runs out, so stragglers get small pieces at the end
+		std::atomic<sd::LongType> cursor(0);
+		auto slot = [&](sd::LongType thread_id, sd::LongType, sd::LongType, sd::LongType) -> void {
+			while (true) {
+				auto remaining = iterations - cursor.load(std::memory_order_relaxed);
+				auto chunk = sd::math::sd_max<sd::LongType>(grain, remaining / (2 * numThreads));
+
+				auto first = cursor.fetch_add(chunk, std::memory_order_relaxed);
+				if (first >= iterations)
+					break;
+
+				auto last = first + chunk;
+				function(thread_id, start + first * increment, last >= iterations ? stop : start + last * increment, increment);
+			}
+		};
+
+		// every slot is a single iteration of parallel_tad, so it gets its own thread id
+		return parallel_tad(slot, 0, numThreads, 1, numThreads);
+	}
+
 	int Threads::parallel_for(FUNC_1D function, sd::LongType start, sd::LongType stop, sd::LongType increment,
                                   sd::LongType numThreads) {
 		if (start > stop)
@@ -513,6 +574,16 @@ namespace samediff {
 			return numThreads;
 		}
 		else {
+			if (useWorkStealing()) {
+				auto body = [&](int64_t e) {
+					auto span = Span2::build(splitLoop, e, numThreads, startX, stopX, incX, startY, stopY, incY);
+					function(e, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY());
+				};
+
+				WorkStealingPool::getInstance().parallel(numThreads, body);
+				return numThreads;
+			}
+
 #ifdef _OPENMP
 
 			if (tryAcquire(numThreads)) {
@@ -586,6 +657,17 @@ namespace samediff {
 			return 1;
 		}
 
+		if (useWorkStealing()) {
+			auto splitLoop = ThreadsHelper::pickLoop3d(numThreads, itersX, itersY, itersZ);
+			auto body = [&](int64_t e) {
+				auto span = Span3::build(splitLoop, e, numThreads, startX, stopX, incX, startY, stopY, incY, startZ, stopZ, incZ);
+				function(e, span.startX(), span.stopX(), span.incX(), span.startY(), span.stopY(), span.incY(), span.startZ(), span.stopZ(), span.incZ());
+			};
+
+			WorkStealingPool::getInstance().parallel(numThreads, body);
+			return numThreads;
+		}
+
 #ifdef _OPENMP
 
 		if (tryAcquire(numThreads)) {
@@ -644,6 +726,15 @@ namespace samediff {
 			return 1;
 		}
 
+		if (useWorkStealing()) {
+			auto body = [&](int64_t e) {
+				function(e, numThreads);
+			};
+
+			WorkStealingPool::getInstance().parallel(numThreads, body);
+			return numThreads;
+		}
+
 #ifdef _OPENMP
 
 		if (tryAcquire(numThreads)) {
@@ -708,40 +799,50 @@ namespace samediff {
 		int64_t intermediatery[256];
 		auto span = delta / numThreads;
 
-#ifdef _OPENMP
-		if (tryAcquire(numThreads)) {
-#pragma omp parallel for
-			for (int e = 0; e < numThreads; e++) {
+		if (useWorkStealing()) {
+			auto body = [&](int64_t e) {
 				auto start_ = span * e + start;
-				auto stop_ = span * (e + 1) + start;
+				auto stop_ = e == numThreads - 1 ? stop : span * (e + 1) + start;
+				intermediatery[e] = function(e, start_, stop_, increment);
+			};
 
-				intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
-			}
-			freeThreads(numThreads);
+			WorkStealingPool::getInstance().parallel(numThreads, body);
 		}
 		else {
-			// if there were no threads available - we'll execute function right within current thread
-			return	function(0, start, stop, increment);
-		}
-#else
-		auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
-		if (ticket == nullptr)
-			return function(0, start, stop, increment);
+#ifdef _OPENMP
+			if (tryAcquire(numThreads)) {
+#pragma omp parallel for
+				for (int e = 0; e < numThreads; e++) {
+					auto start_ = span * e + start;
+					auto stop_ = span * (e + 1) + start;
 
-		// execute threads in parallel
-		for (uint32_t e = 0; e < numThreads; e++) {
-			auto start_ = span * e + start;
-			auto stop_ = span * (e + 1) + start;
+					intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
+				}
+				freeThreads(numThreads);
+			}
+			else {
+				// if there were no threads available - we'll execute function right within current thread
+				return	function(0, start, stop, increment);
+			}
+#else
+			auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
+			if (ticket == nullptr)
+				return function(0, start, stop, increment);
 
-			if (e == numThreads - 1)
-				intermediatery[e] = function(e, start_, stop, increment);
-			else
-				ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
-		}
+			// execute threads in parallel
+			for (uint32_t e = 0; e < numThreads; e++) {
+				auto start_ = span * e + start;
+				auto stop_ = span * (e + 1) + start;
 
-		ticket->waitAndRelease();
+				if (e == numThreads - 1)
+					intermediatery[e] = function(e, start_, stop, increment);
+				else
+					ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
+			}
 
+			ticket->waitAndRelease();
 #endif
+		}
 
 		// aggregate results in single thread
 		for (uint64_t e = 1; e < numThreads; e++)
@@ -770,43 +871,50 @@ namespace samediff {
 		double intermediatery[256];
 		auto span = delta / numThreads;
 
-#ifdef _OPENMP
-
-		if (tryAcquire(numThreads)) {
-#pragma omp parallel for
-			for (int e = 0; e < numThreads; e++) {
+		if (useWorkStealing()) {
+			auto body = [&](int64_t e) {
 				auto start_ = span * e + start;
-				auto stop_ = span * (e + 1) + start;
+				auto stop_ = e == numThreads - 1 ? stop : span * (e + 1) + start;
+				intermediatery[e] = function(e, start_, stop_, increment);
+			};
 
-				intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
-			}
-			freeThreads(numThreads);
+			WorkStealingPool::getInstance().parallel(numThreads, body);
 		}
 		else {
-			// if there were no thre ads available - we'll execute function right within current thread
-			return	function(0, start, stop, increment);
-		}
+#ifdef _OPENMP
+			if (tryAcquire(numThreads)) {
+#pragma omp parallel for
+				for (int e = 0; e < numThreads; e++) {
+					auto start_ = span * e + start;
+					auto stop_ = span * (e + 1) + start;
 
+					intermediatery[e] = function(e, start_, e == numThreads - 1 ? stop : stop_, increment);
+				}
+				freeThreads(numThreads);
+			}
+			else {
+				// if there were no thre ads available - we'll execute function right within current thread
+				return	function(0, start, stop, increment);
+			}
 #else
+			auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
+			if (ticket == nullptr)
+				return function(0, start, stop, increment);
 
-		auto ticket = ThreadPool::getInstance().tryAcquire(numThreads - 1);
-		if (ticket == nullptr)
-			return function(0, start, stop, increment);
-
-		// execute threads in parallel
-		for (uint32_t e = 0; e < numThreads; e++) {
-			auto start_ = span * e + start;
-			auto stop_ = span * (e + 1) + start;
-
-			if (e == numThreads - 1)
-				intermediatery[e] = function(e, start_, stop, increment);
-			else
-				ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
-		}
+			// execute threads in parallel
+			for (uint32_t e = 0; e < numThreads; e++) {
+				auto start_ = span * e + start;
+				auto stop_ = span * (e + 1) + start;
 
-		ticket->waitAndRelease();
+				if (e == numThreads - 1)
+					intermediatery[e] = function(e, start_, stop, increment);
+				else
+					ticket->enqueue(e, numThreads, &intermediatery[e], function, start_, stop_, increment);
+			}
 
+			ticket->waitAndRelease();
 #endif
+		}
 
 		// aggregate results in single thread
 		for (uint64_t e = 1; e < numThreads; e++)
@@ -910,6 +1018,15 @@ namespace samediff {
 		thread_spans[numThreads - 1].start = begin;
 		thread_spans[numThreads - 1].end = stop;
 
+		if (useWorkStealing()) {
+			auto body = [&](int64_t j) {
+				function(j, thread_spans[j].start, thread_spans[j].end, increment);
+			};
+
+			WorkStealingPool::getInstance().parallel(numThreads, body);
+			return numThreads;
+		}
+
 #ifdef _OPENMP
 		if (tryAcquire(numThreads)) {
 #pragma omp parallel for
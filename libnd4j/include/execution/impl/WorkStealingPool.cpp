@@ -0,0 +1,321 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Work-stealing scheduler behind samediff::Threads, see WorkStealingPool.h
+//
+#include <execution/WorkStealingPool.h>
+#include <math/templatemath.h>
+#include <system/Environment.h>
+
+#include <chrono>
+
+namespace samediff {
+
+// number of empty scans before idle thread starts yielding, and before it parks
+static const int kSpinScans = 64;
+static const int kParkScans = 256;
+
+#ifndef SD_WORK_STEALING_DISABLED
+static thread_local int currentWorkerId = -1;
+#else
+static int currentWorkerId = -1;
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+TaskGroup::~TaskGroup() {
+  // the last done() finishes the group while holding the lock, so once the lock is acquired here nobody touches
+  // this group anymore, even though the waiter saw it finished earlier
+  std::lock_guard<std::mutex> lock(_lock);
+}
+
+void TaskGroup::done() {
+  // all but the last completion go lock free
+  auto pending = _pending.load(std::memory_order_relaxed);
+  while (pending > 1)
+    if (_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+      return;
+
+  std::lock_guard<std::mutex> lock(_lock);
+  _pending.fetch_sub(1, std::memory_order_acq_rel);
+  _condition.notify_all();
+}
+
+void TaskGroup::park() {
+  std::unique_lock<std::mutex> lock(_lock);
+
+  // timeout covers steals lost to contention, those tasks may still sit in some deque
+  _condition.wait_for(lock, std::chrono::milliseconds(1), [&] { return finished(); });
+}
+
+void TaskGroup::fail(std::exception_ptr error) {
+  std::lock_guard<std::mutex> lock(_lock);
+  if (!_error) _error = error;
+}
+
+void TaskGroup::rethrow() {
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::swap(error, _error);
+  }
+
+  if (error) std::rethrow_exception(error);
+}
+
+//////////////////////////////////////////////////////////////////////////
+TaskDeque::TaskDeque() : _top(0), _bottom(0) {
+  for (int64_t e = 0; e < kCapacity; e++) _tasks[e].store(nullptr, std::memory_order_relaxed);
+}
+
+bool TaskDeque::push(Task *task) {
+  const auto b = _bottom.load(std::memory_order_relaxed);
+  const auto t = _top.load(std::memory_order_acquire);
+  if (b - t >= kCapacity) return false;
+
+  _tasks[b & (kCapacity - 1)].store(task, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  _bottom.store(b + 1, std::memory_order_relaxed);
+  return true;
+}
+
+Task *TaskDeque::pop() {
+  const auto b = _bottom.load(std::memory_order_relaxed) - 1;
+  _bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto t = _top.load(std::memory_order_relaxed);
+
+  if (t > b) {
+    // empty
+    _bottom.store(b + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto task = _tasks[b & (kCapacity - 1)].load(std::memory_order_relaxed);
+  if (t == b) {
+    // last task, racing with thieves for it
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      task = nullptr;
+
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  return task;
+}
+
+Task *TaskDeque::steal() {
+  auto t = _top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto b = _bottom.load(std::memory_order_acquire);
+  if (t >= b) return nullptr;
+
+  auto task = _tasks[t & (kCapacity - 1)].load(std::memory_order_relaxed);
+  if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+
+  return task;
+}
+
+//////////////////////////////////////////////////////////////////////////
+WorkStealingPool::WorkStealingPool() : _injected(0), _sleepers(0), _epoch(0) {
+#ifndef SD_WORK_STEALING_DISABLED
+  // calling thread always takes part in execution, so one worker less is needed
+  const int numWorkers = sd::math::sd_max<int>(0, sd::Environment::getInstance().maxThreads() - 1);
+
+  _deques.resize(numWorkers);
+  for (int e = 0; e < numWorkers; e++) _deques[e] = new TaskDeque();
+
+  _threads.resize(numWorkers);
+  for (int e = 0; e < numWorkers; e++) _threads[e] = std::thread(&WorkStealingPool::workerLoop, this, e);
+#endif
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  // workers never exit, and the pool is never destroyed, see getInstance()
+  for (auto &t : _threads) t.detach();
+}
+
+WorkStealingPool &WorkStealingPool::getInstance() {
+  // intentionally leaked: workers may still be parked on its members while static destructors run
+  static auto instance = new WorkStealingPool();
+  return *instance;
+}
+
+int WorkStealingPool::currentWorker() { return currentWorkerId; }
+
+void WorkStealingPool::execute(Task *task) {
+  try {
+    task->function(task->payload, task->index);
+  } catch (...) {
+    task->group->fail(std::current_exception());
+  }
+
+  task->group->done();
+}
+
+Task *WorkStealingPool::findTask(int workerId, uint64_t &seed) {
+  // own tasks first, newest ones are the hottest in cache
+  if (workerId >= 0) {
+    auto task = _deques[workerId]->pop();
+    if (task != nullptr) return task;
+  }
+
+  if (_injected.load(std::memory_order_acquire) > 0) {
+    std::lock_guard<std::mutex> lock(_injectionLock);
+    if (!_injection.empty()) {
+      auto task = _injection.front();
+      _injection.pop_front();
+      _injected.fetch_sub(1, std::memory_order_release);
+      return task;
+    }
+  }
+
+  // random victim first, then everyone else
+  const auto numDeques = _deques.size();
+  if (numDeques == 0) return nullptr;
+
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  const auto first = seed % numDeques;
+  for (size_t e = 0; e < numDeques; e++) {
+    const auto victim = (first + e) % numDeques;
+    if (static_cast<int>(victim) == workerId) continue;
+
+    auto task = _deques[victim]->steal();
+    if (task != nullptr) return task;
+  }
+
+  return nullptr;
+}
+
+void WorkStealingPool::wakeUp(int numTasks) {
+  _epoch.fetch_add(1, std::memory_order_seq_cst);
+  if (_sleepers.load(std::memory_order_seq_cst) == 0) return;
+
+  std::lock_guard<std::mutex> lock(_parkLock);
+  if (numTasks == 1)
+    _parkCondition.notify_one();
+  else
+    _parkCondition.notify_all();
+}
+
+void WorkStealingPool::workerLoop(int workerId) {
+  currentWorkerId = workerId;
+  uint64_t seed = 0x9E3779B97F4A7C15ULL * (workerId + 1);
+
+  int idle = 0;
+  while (true) {
+    auto task = findTask(workerId, seed);
+    if (task != nullptr) {
+      execute(task);
+      idle = 0;
+      continue;
+    }
+
+    if (++idle < kParkScans) {
+      if (idle > kSpinScans) std::this_thread::yield();
+      continue;
+    }
+
+    // epoch is read before the last scan, so submission made after the scan always wakes us up
+    const auto epoch = _epoch.load(std::memory_order_seq_cst);
+    _sleepers.fetch_add(1, std::memory_order_seq_cst);
+
+    task = findTask(workerId, seed);
+    if (task == nullptr) {
+      std::unique_lock<std::mutex> lock(_parkLock);
+      _parkCondition.wait(lock, [&] { return _epoch.load(std::memory_order_seq_cst) != epoch; });
+    }
+
+    _sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    idle = 0;
+
+    if (task != nullptr) execute(task);
+  }
+}
+
+void WorkStealingPool::submit(Task *tasks, int numTasks) {
+  if (numTasks <= 0) return;
+
+  const auto workerId = currentWorkerId;
+  if (workerId >= 0) {
+    // nested call: tasks go to our own deque, so we'll pick them up first, others steal what we can't handle
+    for (int e = 0; e < numTasks; e++)
+      if (!_deques[workerId]->push(&tasks[e])) execute(&tasks[e]);
+  } else {
+    std::lock_guard<std::mutex> lock(_injectionLock);
+    for (int e = 0; e < numTasks; e++) _injection.push_back(&tasks[e]);
+
+    _injected.fetch_add(numTasks, std::memory_order_release);
+  }
+
+  wakeUp(numTasks);
+}
+
+Task *WorkStealingPool::findGroupTask(int workerId, TaskGroup &group) {
+  if (workerId >= 0) {
+    // tasks a worker submits go to the bottom of its own deque, and nested calls made by those tasks are finished
+    // before they return, so remaining tasks of the group are always the newest ones there
+    auto deque = _deques[workerId];
+    auto task = deque->pop();
+    if (task == nullptr || task->group == &group) return task;
+
+    // older task of some outer group goes back where it was, pop just freed its slot
+    deque->push(task);
+    return nullptr;
+  }
+
+  // tasks of outside callers go through the injection queue
+  if (_injected.load(std::memory_order_acquire) == 0) return nullptr;
+
+  std::lock_guard<std::mutex> lock(_injectionLock);
+  for (auto it = _injection.begin(); it != _injection.end(); ++it) {
+    if ((*it)->group != &group) continue;
+
+    auto task = *it;
+    _injection.erase(it);
+    _injected.fetch_sub(1, std::memory_order_release);
+    return task;
+  }
+
+  return nullptr;
+}
+
+void WorkStealingPool::wait(TaskGroup &group) {
+  const auto workerId = currentWorkerId;
+
+  // only tasks of this group are executed while waiting: an unrelated task could need a lock the waiter holds,
+  // and helping with arbitrary work would grow the stack with every nested wait
+  int idle = 0;
+  while (!group.finished()) {
+    auto task = findGroupTask(workerId, group);
+    if (task != nullptr) {
+      execute(task);
+      idle = 0;
+      continue;
+    }
+
+    // remaining tasks are being executed by others
+    if (++idle < kSpinScans) continue;
+
+    group.park();
+  }
+
+  group.rethrow();
+}
+}  // namespace samediff
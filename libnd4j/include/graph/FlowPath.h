@@ -80,6 +80,12 @@ class SD_LIB_EXPORT FlowPath {
   sd::LongType getNumberOfCycles(sd::LongType frameId);
 
   GraphProfile* profile();
+
+  /**
+   * This method brings node and frame states back to defaults, so the same FlowPath can be used for the next run.
+   * Node states are reset in place, without reallocating them.
+   */
+  void reset();
 };
 }  // namespace graph
 }  // namespace sd
@@ -220,6 +220,15 @@ class SD_LIB_EXPORT Graph {
    */
   void tagInplaceNodes();
 
+  /**
+   * This method replaces chains of elementwise legacy nodes (transform/scalar/pairwise/broadcast), where every
+   * intermediate result has exactly one consumer, with a single FusedElementwiseOp node, so the chain is evaluated in
+   * one pass over memory. Graphs with control flow are left untouched.
+   *
+   * PLEASE NOTE: intermediate results of fused chains are never materialized
+   */
+  void fuseElementwiseChains();
+
   void replaceState(VariableSpace *state, ExecutorConfiguration *configuration);
 
   SD_INLINE std::vector<int> *nodes() { return _nodes; }
@@ -21,10 +21,13 @@
 //
 #include <exceptions/unknown_graph_exception.h>
 #include <graph/Graph.h>
+#include <graph/GraphSession.h>
 #include <helpers/SimpleReadWriteLock.h>
 #include <helpers/logger.h>
 
 #include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace sd {
@@ -35,9 +38,18 @@ class SD_LIB_EXPORT GraphHolder {
 
   SD_MAP_IMPL<sd::LongType, SimpleReadWriteLock> _locks;
 
+  // inference sessions, one per thread for each stored graph
+  SD_MAP_IMPL<sd::LongType, std::map<std::thread::id, GraphSession*>> _sessions;
+  std::mutex _sessionsLock;
+
   GraphHolder() = default;
   ~GraphHolder() = default;
 
+  void dropSessions(sd::LongType graphId);
+
+  // removes graph and its sessions, caller is expected to hold write lock
+  Graph* detachGraph(sd::LongType graphId);
+
  public:
   static GraphHolder& getInstance();
 
@@ -62,6 +74,14 @@ class SD_LIB_EXPORT GraphHolder {
 
   void replaceGraph(sd::LongType graphId, Graph* graph);
 
+  /**
+   * This method returns inference session of the calling thread for given graph, creating it on first use.
+   * Session stays alive until the graph is forgotten, dropped or replaced, and must not be shared between threads.
+   */
+  GraphSession* session(sd::LongType graphId);
+
+  int numberOfSessions(sd::LongType graphId);
+
   /////////////////////////////
 
   SD_INLINE void lockWrite(sd::LongType graphId) {
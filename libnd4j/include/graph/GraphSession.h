@@ -0,0 +1,118 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+//
+// Inference session over a graph stored in GraphHolder.
+//
+// Session is created once per thread and keeps everything a request needs: its own copy of graph nodes, a
+// VariableSpace holding intermediate and output arrays, a FlowPath and a Workspace for op temporaries. Inputs are bound
+// zero-copy on every call; as long as input shapes stay the same, all arrays allocated by the previous call are reused.
+// After the first call intermediate arrays are moved into one arena, where buffers with disjoint lifetimes share memory.
+//
+#ifndef LIBND4J_GRAPHSESSION_H
+#define LIBND4J_GRAPHSESSION_H
+#include <graph/FlowPath.h>
+#include <graph/Graph.h>
+#include <graph/MemoryPlan.h>
+#include <graph/VariableProxy.h>
+#include <memory/Workspace.h>
+
+#include <memory>
+#include <vector>
+
+namespace sd {
+namespace graph {
+class SD_LIB_EXPORT GraphSession {
+ protected:
+  // per-session copy of nodes, variables of the stored graph are shared via proxy
+  Graph* _graph = nullptr;
+
+  // VariableSpace of the stored graph, constants and placeholders are read from it
+  VariableSpace* _origin = nullptr;
+
+  // per-session variables, recreated only when bound inputs change their shapes
+  VariableProxy* _variableSpace = nullptr;
+
+  FlowPath _flowPath;
+  sd::memory::Workspace _workspace;
+
+  // input arrays are owned by session, and get rebound to external buffers on every call
+  std::vector<int> _inputIds;
+  std::vector<NDArray*> _inputs;
+
+  std::vector<Variable*> _outputs;
+
+  // intermediate arrays are placed into single arena once shapes are known, see MemoryPlan
+  MemoryPlan _plan;
+  bool _planned = false;
+  std::shared_ptr<DataBuffer> _arena;
+  std::vector<NDArray*> _arenaArrays;
+
+  sd::LongType _executions = 0;
+  sd::LongType _rebuilds = 0;
+
+  void rebuild();
+  void releaseArena();
+  void planMemory();
+
+ public:
+  explicit GraphSession(Graph* graph);
+  ~GraphSession();
+
+  GraphSession(const GraphSession& other) = delete;
+  GraphSession& operator=(const GraphSession& other) = delete;
+
+  /**
+   * This method binds given buffers to graph inputs (no copies are made) and executes the graph.
+   * Output variables are owned by session, and stay valid until next execute() call.
+   * Per-session state is recreated only if input ids or shapes differ from the previous call, so shapes of
+   * intermediate arrays are expected to be defined by input shapes alone.
+   *
+   * @param inputBuffers - host buffers of inputs
+   * @param inputShapes - shapeInfo of inputs
+   * @param inputIndices - ids of variables inputs should be bound to
+   * @param numInputs - number of inputs
+   */
+  sd::Status execute(sd::Pointer* inputBuffers, sd::Pointer* inputShapes, int* inputIndices, int numInputs);
+
+  /**
+   * This method returns output variables produced by the last execute() call
+   */
+  const std::vector<Variable*>& outputs() const { return _outputs; }
+
+  sd::LongType executions() const { return _executions; }
+
+  /**
+   * This method returns number of times per-session state had to be recreated due to changed input ids or shapes
+   */
+  sd::LongType rebuilds() const { return _rebuilds; }
+
+  sd::memory::Workspace* workspace() { return &_workspace; }
+
+  /**
+   * This method returns memory plan applied to intermediate arrays, empty until the first successful execution
+   */
+  const MemoryPlan& memoryPlan() const { return _plan; }
+
+  sd::LongType arenaSize() const { return _arena != nullptr ? _plan.arenaSize() : 0; }
+};
+}  // namespace graph
+}  // namespace sd
+
+#endif  // LIBND4J_GRAPHSESSION_H
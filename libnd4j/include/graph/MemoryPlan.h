@@ -0,0 +1,106 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Static placement of graph activations into a single arena.
+//
+// Lifetimes are measured in layers of the toposorted graph: a buffer is alive from the layer that produces it up to
+// the last layer that reads it. Nodes of the same layer may run concurrently, so buffers touching the same layer
+// never share memory. Offsets are assigned greedily, biggest buffers first, each one going to the tightest gap
+// between buffers it overlaps with in time.
+//
+#ifndef LIBND4J_MEMORYPLAN_H
+#define LIBND4J_MEMORYPLAN_H
+#include <graph/Graph.h>
+#include <graph/VariableSpace.h>
+
+#include <utility>
+#include <vector>
+
+namespace sd {
+namespace graph {
+class SD_LIB_EXPORT MemoryPlan {
+ public:
+  struct Allocation {
+    std::pair<int, int> variable;
+
+    // constant shapeInfo of the array to be placed
+    const sd::LongType *shapeInfo = nullptr;
+
+    // layers range the buffer is alive at, both inclusive
+    int first = 0;
+    int last = 0;
+
+    sd::LongType bytes = 0;
+    sd::LongType offset = -1;
+  };
+
+  // every offset and size within arena is aligned to this value
+  static const sd::LongType kAlignment = 64;
+
+ protected:
+  std::vector<Allocation> _allocations;
+
+  // variables sharing the buffer of some allocation, i.e. outputs of in-place nodes: variable -> allocation index
+  std::vector<std::pair<std::pair<int, int>, int>> _aliases;
+
+  sd::LongType _arenaSize = 0;
+
+ public:
+  MemoryPlan() = default;
+  ~MemoryPlan() = default;
+
+  /**
+   * This method builds plan for intermediate arrays of the given graph, using arrays produced by previous execution
+   * within given VariableSpace as the source of shapes and data types. Graph outputs, arrays shared with anything
+   * besides in-place consumers, and graphs with control flow are not planned.
+   */
+  static MemoryPlan build(Graph *graph, VariableSpace *variableSpace);
+
+  /**
+   * This method adds buffer alive within [first, last] layers, and returns its index
+   */
+  int addAllocation(const std::pair<int, int> &variable, const sd::LongType *shapeInfo, sd::LongType bytes, int first,
+                    int last);
+
+  void addAlias(const std::pair<int, int> &variable, int allocation);
+
+  /**
+   * This method places all allocations within arena, so buffers with overlapping lifetimes never overlap in memory
+   */
+  void assignOffsets();
+
+  const std::vector<Allocation> &allocations() const { return _allocations; }
+  const std::vector<std::pair<std::pair<int, int>, int>> &aliases() const { return _aliases; }
+
+  bool empty() const { return _allocations.empty(); }
+
+  /**
+   * This method returns number of bytes required by the arena
+   */
+  sd::LongType arenaSize() const { return _arenaSize; }
+
+  /**
+   * This method returns number of bytes required if every buffer had its own memory
+   */
+  sd::LongType naiveSize() const;
+};
+}  // namespace graph
+}  // namespace sd
+
+#endif  // LIBND4J_MEMORYPLAN_H
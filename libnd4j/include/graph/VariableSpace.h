@@ -41,7 +41,7 @@ namespace sd {
 namespace graph {
 class SD_LIB_EXPORT VariableSpace {
  protected:
-  sd::memory::Workspace* _workspace;
+  sd::memory::Workspace* _workspace = nullptr;
 
   // stash is NOT cloned
   sd::graph::Stash _stash;
@@ -60,7 +60,8 @@ class SD_LIB_EXPORT VariableSpace {
 
   int _auto_counter = -1;
 
-  std::mutex _varmap;
+  // guards all maps above, recursive since put* methods call each other
+  std::recursive_mutex _varmap;
 
   SD_MAP_IMPL<int, sd::graph::Variable*> _temporary;
 
@@ -77,6 +78,7 @@ class SD_LIB_EXPORT VariableSpace {
   virtual int numberOfPlaceholders();
   virtual std::vector<Variable*>* getPlaceholders();
   virtual void setWorkspace(sd::memory::Workspace* workspace);
+  virtual sd::memory::Workspace* workspace();
 
   virtual LaunchContext* launchContext();
 
@@ -34,8 +34,11 @@ class SD_LIB_EXPORT VariablesSet {
   std::vector<sd::graph::Variable*> _holder;
   sd::Status _status;
 
+  // if false - variables are owned by someone else (i.e. inference session), and won't be deleted here
+  bool _removable;
+
  public:
-  VariablesSet(sd::Status status = sd::Status::OK);
+  VariablesSet(sd::Status status = sd::Status::OK, bool removable = true);
   ~VariablesSet();
 
   sd::Status status();
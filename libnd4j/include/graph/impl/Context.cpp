@@ -56,7 +56,10 @@ Context::Context(ContextPrototype *prototype, VariableSpace *variableSpace) {
     this->_useONEDNN = prototype->isUseONEDNN();
   }
 
-  if (variableSpace != nullptr && variableSpace->launchContext()->getWorkspace() != nullptr)
+  // workspace pinned to the VariableSpace itself (i.e. by inference session) takes precedence
+  if (variableSpace != nullptr && variableSpace->workspace() != nullptr)
+    this->_workspace = variableSpace->workspace();
+  else if (variableSpace != nullptr && variableSpace->launchContext()->getWorkspace() != nullptr)
     this->_workspace = variableSpace->launchContext()->getWorkspace();
 }
 sd::DataType Context::dataType(int index) { return _dataType; }
@@ -77,7 +80,10 @@ Context::Context(int nodeId, VariableSpace *variableSpace) {
   this->_executionTime.first = 0;
   this->_executionTime.second = 0;
 
-  if (variableSpace != nullptr && variableSpace->launchContext()->getWorkspace() != nullptr)
+  // workspace pinned to the VariableSpace itself (i.e. by inference session) takes precedence
+  if (variableSpace != nullptr && variableSpace->workspace() != nullptr)
+    this->_workspace = variableSpace->workspace();
+  else if (variableSpace != nullptr && variableSpace->launchContext()->getWorkspace() != nullptr)
     this->_workspace = variableSpace->launchContext()->getWorkspace();
 }
 
@@ -127,5 +127,12 @@ bool FlowPath::wasExecuted(int nodeId) { return _states[nodeId].wasExecuted(); }
 void FlowPath::markExecuted(int nodeId, bool wasExecuted) { _states[nodeId].markExecuted(wasExecuted); }
 
 GraphProfile* FlowPath::profile() { return &_profile; }
+
+void FlowPath::reset() {
+  for (auto &v : _states) v.second = NodeState(v.first);
+
+  _frames.clear();
+}
+
 }  // namespace graph
 }  // namespace sd
@@ -29,8 +29,10 @@
 #include <helpers/EnumUtils.h>
 #include <helpers/ShapeUtils.h>
 #include <legacy/NativeOps.h>
+#include <ops/declarable/FusedElementwiseOp.h>
 #include <ops/declarable/OpRegistrator.h>
 
+#include <algorithm>
 #include <vector>
 
 namespace sd {
@@ -704,6 +706,144 @@ void Graph::tagInplaceNodes() {
   }
 }
 
+void Graph::fuseElementwiseChains() {
+  // just calling, in case it wasn't built before
+  if (!_built.load()) this->buildGraph();
+
+  // control flow relies on node ids and layers as they were exported, so such graphs are left as is
+  for (auto &v : *_mapped)
+    if (v.second->opType() == OpType_LOGIC) return;
+
+  // consumers of each node output
+  SD_MAP_IMPL<int, std::vector<int>> consumers;
+  for (auto &v : *_mapped)
+    for (auto &t : *v.second->input())
+      if (_mapped->count(t.first) > 0) consumers[t.first].emplace_back(v.first);
+
+  auto isFusable = [&](Node *node) -> bool {
+    if (!sd::ops::FusedElementwiseOp::isFusable(node->opType()) || !node->hasCustomOp() || node->isScoped() ||
+        node->isDivergencePoint() || node->getContextPrototype() == nullptr)
+      return false;
+
+    auto numInputs = node->input()->size();
+    switch (node->opType()) {
+      case OpType_SCALAR:
+        // single input scalar ops take the scalar from T args or from the node itself, same as LegacyScalarOp
+        return numInputs == 1 || numInputs == 2;
+      case OpType_PAIRWISE:
+        return numInputs == 2;
+      case OpType_BROADCAST:
+        return numInputs == 2 && !node->getContextPrototype()->getAxis()->empty();
+      default:
+        return numInputs == 1;
+    }
+  };
+
+  // intermediate result can be folded into the chain only if nobody else will ever see it
+  auto isInternal = [&](Node *node) -> bool {
+    return consumers[node->id()].size() == 1 && !node->hasExternalOutputs() &&
+           std::find(_output.begin(), _output.end(), node->id()) == _output.end();
+  };
+
+  // layers are traversed in execution order, so chains are collected head first
+  std::vector<std::vector<Node *>> chains;
+  SD_MAP_IMPL<int, int> chainByTail;
+  for (int l = 0; l < (int)_onion->size(); l++) {
+    if (_onion->count(l) == 0) continue;
+
+    for (auto node : *_onion->at(l)) {
+      if (!isFusable(node)) continue;
+
+      auto in = node->input()->at(0);
+      auto it = chainByTail.find(in.first);
+      if (in.second == 0 && it != chainByTail.end() && isInternal(_mapped->at(in.first))) {
+        auto idx = it->second;
+        chainByTail.erase(it);
+        chains[idx].emplace_back(node);
+        chainByTail[node->id()] = idx;
+      } else {
+        chainByTail[node->id()] = (int)chains.size();
+        chains.emplace_back(std::vector<Node *>({node}));
+      }
+    }
+  }
+
+  for (auto &chain : chains) {
+    if (chain.size() < 2) continue;
+
+    auto head = chain.front();
+    auto tail = chain.back();
+
+    std::vector<std::pair<int, int>> inputs({head->input()->at(0)});
+    std::vector<sd::ops::FusedStage> stages;
+    for (auto node : chain) {
+      auto block = node->getContextPrototype();
+
+      sd::ops::FusedStage stage;
+      stage.opType = node->opType();
+      stage.opNum = block->opNum() < 0 ? (int)node->opNum() : block->opNum();
+      stage.tArgs = *block->getTArguments();
+      stage.dimensions = *block->getAxis();
+
+      if (node->input()->size() > 1) {
+        stage.operand = (int)inputs.size();
+        inputs.emplace_back(node->input()->at(1));
+      } else if (stage.opType == OpType_SCALAR) {
+        stage.scalar = stage.tArgs.empty() ? node->scalar() : stage.tArgs[0];
+      }
+
+      stages.emplace_back(stage);
+    }
+
+    auto fused = new Node(new sd::ops::FusedElementwiseOp(stages, (int)inputs.size()), tail->id());
+    fused->setDeductable(true);
+    fused->setLayer(tail->getLayer());
+    if (tail->getName() != nullptr) fused->setName(*tail->getName());
+
+    auto block = fused->getContextPrototype();
+    for (auto &p : inputs) {
+      if (p.second == 0)
+        fused->pickInput(p.first);
+      else
+        fused->pickInput(p.first, p.second);
+
+      block->pickInput(p);
+    }
+
+    for (auto &p : *tail->output()) {
+      if (p.second == 0)
+        fused->pickOutput(p.first);
+      else
+        fused->pickOutput(p.first, p.second);
+    }
+
+    if (tail->totalReferences() > 0)
+      for (auto c : consumers[tail->id()]) fused->addReference(c);
+
+    // fused node takes place of the tail, other nodes of the chain just disappear
+    for (auto node : chain) {
+      auto layer = _onion->at(node->getLayer());
+      auto pos = std::find(layer->begin(), layer->end(), node);
+      if (node == tail)
+        *pos = fused;
+      else
+        layer->erase(pos);
+
+      if (node == tail) {
+        (*_mapped)[node->id()] = fused;
+      } else {
+        _mapped->erase(node->id());
+        _nodes->erase(std::remove(_nodes->begin(), _nodes->end(), node->id()), _nodes->end());
+      }
+
+      _handles.erase(std::remove(_handles.begin(), _handles.end(), node), _handles.end());
+      delete node;
+    }
+
+    _handles.emplace_back(fused);
+  }
+}
+
 void Graph::prepareOutputs() {
   // if we're dumping everything out there - we'll add external variables as well
   if (_configuration->_outputMode == OutputMode_VARIABLE_SPACE) {
@@ -868,8 +1008,10 @@ Graph::Graph(const FlatGraph *flatGraph, VariableSpace *variableSpace) {
    *  1) this is FeedForward pass ONLY
    *  2) OPTIMIZED mode is set, so no intermediate results are going to be used
    */
-  if (_configuration->_direction == Direction_FORWARD_ONLY && _configuration->_outputMode == OutputMode_OPTIMIZED)
+  if (_configuration->_direction == Direction_FORWARD_ONLY && _configuration->_outputMode == OutputMode_OPTIMIZED) {
+    this->fuseElementwiseChains();
     this->tagInplaceNodes();
+  }
 }
 
 void Graph::toposortNodes() {
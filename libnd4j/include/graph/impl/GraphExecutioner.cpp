@@ -41,6 +41,7 @@
 #include <array/DataTypeUtils.h>
 #include <exceptions/graph_execution_exception.h>
 #include <exceptions/no_results_exception.h>
+#include <execution/Threads.h>
 #include <fcntl.h>
 #include <graph/ExecutionResult.h>
 #include <graph/FlatUtils.h>
@@ -53,6 +54,7 @@
 #include <chrono>
 #include <ctime>
 #include <deque>
+#include <exception>
 
 namespace sd {
 namespace graph {
@@ -193,6 +195,122 @@ sd::Status GraphExecutioner::executeFlatNode(Graph *graph, Node *node, VariableS
   return sd::Status::OK;
 }
 
+/**
+ * This method checks if given Node should be skipped, because one of its inputs is inactive,
+ * or because its input comes from a divergence point (i.e. Switch) that went the other way.
+ * Skipped nodes are marked inactive in the FlowPath.
+ */
+static bool shouldSkipNode(Graph *graph, Node *node, FlowPath *flowPath) {
+  if (node->opType() == OpType_LOGIC && node->opNum() == sd::logic::Merge) {
+    // Merge node has own checkout logic
+
+    auto inputId0 = node->input()->at(0);
+    auto inputId1 = node->input()->at(1);
+
+    // Merge node can be skipped only both inputs are inactive
+    return !flowPath->isNodeActive(inputId0.first) && !flowPath->isNodeActive(inputId1.first);
+  }
+
+  // let's check for input nodes, if they are disabled or contain divergents
+  for (int e = 0; e < node->input()->size(); e++) {
+    auto inputId = node->input()->at(e);
+
+    // not a node. skipping checks
+    if (graph->getMapped()->count(inputId.first) == 0) continue;
+
+    /**
+     * We can skip current node, in two cases:
+     * 1) If previous node was disabled
+     * 2) If previous node was divergent node (i.e. IF op) and code went other way
+     */
+    Node *prevNode = graph->getMapped()->at(inputId.first);
+    if (!flowPath->isNodeActive(inputId.first)) {
+      flowPath->markNodeActive(node->id(), false);
+
+      sd_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
+      return true;
+
+    } else if (prevNode->isDivergencePoint()) {  // literally checking for switch here
+      if (flowPath->branch(inputId.first) != inputId.second) {
+        flowPath->markNodeActive(node->id(), false);
+        sd_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Nodes of a single onion layer have no dependencies on each other, so they can be executed concurrently,
+ * as long as none of them touches the FlowPath state (logic ops, divergence points, embedded graphs)
+ * or writes into external variables.
+ */
+static bool canExecuteConcurrently(const std::vector<Node *> *layer) {
+  if (layer->size() < 2) return false;
+
+  for (auto node : *layer) {
+    if (node->opType() == OpType_LOGIC || node->hasGraphEmbedded() || node->isDivergencePoint() ||
+        node->hasExternalOutputs())
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * This method executes all nodes of one onion layer on the samediff thread pool.
+ * FlowPath bookkeeping stays on the calling thread, only executeFlatNode() calls run concurrently.
+ * Intra-op parallelism of every node draws threads from the same pool, so the machine isn't oversubscribed.
+ */
+static sd::Status executeLayerConcurrently(Graph *graph, const std::vector<Node *> *layer,
+                                           VariableSpace *variableSpace, FlowPath *flowPath) {
+  std::vector<Node *> ready;
+  for (auto node : *layer) {
+    if (shouldSkipNode(graph, node, flowPath)) continue;
+
+    flowPath->markNodeActive(node->id(), true);
+    ready.emplace_back(node);
+  }
+
+  const auto numNodes = static_cast<sd::LongType>(ready.size());
+  std::vector<sd::Status> statuses(numNodes, sd::Status::OK);
+  std::vector<sd::LongType> outerTimes(numNodes, 0);
+  std::vector<std::exception_ptr> errors(numNodes);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      try {
+        auto timeStart = std::chrono::system_clock::now();
+
+        statuses[e] = GraphExecutioner::executeFlatNode(graph, ready[e], variableSpace);
+
+        auto timeEnd = std::chrono::system_clock::now();
+        outerTimes[e] = std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count();
+      } catch (...) {
+        errors[e] = std::current_exception();
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(
+      func, 0, numNodes, 1,
+      sd::math::sd_min<sd::LongType>(numNodes, Environment::getInstance().maxMasterThreads()));
+
+  for (sd::LongType e = 0; e < numNodes; e++) {
+    if (errors[e]) std::rethrow_exception(errors[e]);
+
+    flowPath->setOuterTime(ready[e]->id(), outerTimes[e]);
+
+    if (statuses[e] != sd::Status::OK) return statuses[e];
+
+    flowPath->markExecuted(ready[e]->id(), true);
+  }
+
+  return sd::Status::OK;
+}
+
 /**
  * This method executes given Graph instance, and returns error code.
  *
@@ -212,12 +330,15 @@ sd::Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace)
   sd::LongType tb0 = Environment::getInstance().isProfiling() ? GraphProfile::currentTime() : 0L;
   graph->buildGraph();
 
+  auto workspace = __variableSpace->workspace() != nullptr ? __variableSpace->workspace()
+                                                            : __variableSpace->launchContext()->getWorkspace();
+
   auto footprintForward = sd::memory::MemoryRegistrator::getInstance().getGraphMemoryFootprint(graph->hashCode());
   if (footprintForward > 0) {
-    if (__variableSpace->launchContext()->getWorkspace() != nullptr) {
+    if (workspace != nullptr) {
       // this method will work only if current workspace size is smaller then proposed value
       sd_debug("Setting workspace to %lld bytes\n", footprintForward);
-      __variableSpace->launchContext()->getWorkspace()->expandTo(footprintForward);
+      workspace->expandTo(footprintForward);
     }
   }
 
@@ -242,6 +363,19 @@ sd::Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace)
   for (int l = 0; l < (int)graph->getOnion()->size(); l++) {
     int layerSize = graph->getOnion()->count(l) == 1 ? graph->getOnion()->at(l)->size() : 0;
 
+    // independent nodes of this layer go to the thread pool, if executor was configured for that
+    if (pe && frames.empty() && !leftFrame && !Environment::getInstance().isProfiling() &&
+        !Environment::getInstance().isDebugAndVerbose() && layerSize > 1 &&
+        canExecuteConcurrently(graph->getOnion()->at(l))) {
+      exec_counter += layerSize;
+      if (exec_counter > 10000) return Logger::logKernelFailureMsg("Early termination hit");
+
+      auto status = executeLayerConcurrently(graph, graph->getOnion()->at(l), __variableSpace, flowPath);
+      if (status != sd::Status::OK) return status;
+
+      continue;
+    }
+
     int n = 0;
     // this omp block will probably never be the case
     for (; n < layerSize; n++) {
@@ -279,49 +413,7 @@ sd::Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace)
         }
 
         // TODO: move inactivity check right here
-        bool shouldSkip = false;
-        if (node->opType() == OpType_LOGIC && node->opNum() == sd::logic::Merge) {
-          // Merge node has own checkout logic
-
-          auto inputId0 = node->input()->at(0);
-          auto inputId1 = node->input()->at(1);
-
-          // Merge node can be skipped only both inputs are inactive
-          if (!flowPath->isNodeActive(inputId0.first) && !flowPath->isNodeActive(inputId1.first)) shouldSkip = true;
-
-        } else {
-          // let's check for input nodes, if they are disabled or contain divergents
-          for (int e = 0; e < node->input()->size(); e++) {
-            auto inputId = node->input()->at(e);
-
-            // not a node. skipping checks
-            if (graph->getMapped()->count(inputId.first) == 0) continue;
-
-            /**
-             * We can skip current node, in two cases:
-             * 1) If previous node was disabled
-             * 2) If previous node was divergent node (i.e. IF op) and code went other way
-             */
-            Node *prevNode = graph->getMapped()->at(inputId.first);
-            if (!flowPath->isNodeActive(inputId.first)) {
-              shouldSkip = true;
-              flowPath->markNodeActive(node->id(), false);
-
-              sd_debug("Skipping Node_%i due to inactive input [%i]\n", node->id(), inputId.first);
-              break;
-
-            } else if (prevNode->isDivergencePoint()) {  // literally checking for switch here
-              if (flowPath->branch(inputId.first) != inputId.second) {
-                shouldSkip = true;
-                flowPath->markNodeActive(node->id(), false);
-                sd_debug("Skipping Node_%i due to divergent branch [%i]\n", node->id(), inputId.first);
-                break;
-              }
-            }
-          }
-        }
-
-        if (shouldSkip) continue;
+        if (shouldSkipNode(graph, node, flowPath)) continue;
       }
 
       // we're propagating frameId here (but only if wasn't set earlier)
@@ -464,8 +556,8 @@ sd::Status GraphExecutioner::execute(Graph *graph, VariableSpace *variableSpace)
   }
 
   // saving memory footprint for current run
-  if (__variableSpace->launchContext()->getWorkspace() != nullptr) {
-    auto m = __variableSpace->launchContext()->getWorkspace()->getAllocatedSize();
+  if (workspace != nullptr) {
+    auto m = workspace->getAllocatedSize();
     auto h = graph->hashCode();
     sd::memory::MemoryRegistrator::getInstance().setGraphMemoryFootprintIfGreater(h, m);
   }
@@ -62,26 +62,37 @@ Graph* GraphHolder::pullGraph(sd::LongType graphId) {
   return graph;
 }
 
+Graph* GraphHolder::detachGraph(sd::LongType graphId) {
+  dropSessions(graphId);
+
+  if (!this->hasGraph(graphId)) return nullptr;
+
+  auto graph = _graphF[graphId];
+  _graphF.erase(graphId);
+
+  return graph;
+}
+
 void GraphHolder::forgetGraph(sd::LongType graphId) {
-  if (this->hasGraph(graphId)) _graphF.erase(graphId);
+  this->lockWrite(graphId);
+
+  detachGraph(graphId);
+
+  this->unlockWrite(graphId);
 }
 
 void GraphHolder::dropGraph(sd::LongType graphId) {
-  if (this->hasGraph(graphId)) {
-    auto g = _graphF[graphId];
-    forgetGraph(graphId);
-    delete g;
-  }
+  this->lockWrite(graphId);
+
+  delete detachGraph(graphId);
+
+  this->unlockWrite(graphId);
 }
 
 void GraphHolder::dropGraphAny(sd::LongType graphId) {
   if (!hasGraphAny(graphId)) return;
 
-  this->lockWrite(graphId);
-
   this->dropGraph(graphId);
-
-  this->unlockWrite(graphId);
 }
 
 bool GraphHolder::hasGraphAny(sd::LongType graphId) { return this->hasGraph(graphId); }
@@ -96,11 +107,46 @@ void GraphHolder::replaceGraph(sd::LongType graphId, Graph* graph) {
 
   this->lockWrite(graphId);
 
+  // sessions are bound to the graph they were created for
+  dropSessions(graphId);
   _graphF[graphId] = graph;
 
   this->unlockWrite(graphId);
 }
 
+GraphSession* GraphHolder::session(sd::LongType graphId) {
+  if (!hasGraph(graphId)) throw unknown_graph_exception(graphId);
+
+  std::lock_guard<std::mutex> lock(_sessionsLock);
+
+  auto& sessions = _sessions[graphId];
+  auto tid = std::this_thread::get_id();
+
+  auto it = sessions.find(tid);
+  if (it != sessions.end()) return it->second;
+
+  auto session = new GraphSession(_graphF[graphId]);
+  sessions[tid] = session;
+
+  return session;
+}
+
+int GraphHolder::numberOfSessions(sd::LongType graphId) {
+  std::lock_guard<std::mutex> lock(_sessionsLock);
+
+  return _sessions.count(graphId) > 0 ? (int)_sessions[graphId].size() : 0;
+}
+
+void GraphHolder::dropSessions(sd::LongType graphId) {
+  std::lock_guard<std::mutex> lock(_sessionsLock);
+
+  if (_sessions.count(graphId) == 0) return;
+
+  for (auto& v : _sessions[graphId]) delete v.second;
+
+  _sessions.erase(graphId);
+}
+
 flatbuffers::Offset<FlatResult> GraphHolder::execute(sd::LongType graphId, flatbuffers::FlatBufferBuilder& builder,
                                                      const FlatInferenceRequest* request) {
   if (!hasGraph(graphId)) throw unknown_graph_exception(graphId);
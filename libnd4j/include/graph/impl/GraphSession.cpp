@@ -0,0 +1,175 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+
+//
+// Inference session over a graph stored in GraphHolder.
+//
+#include <graph/GraphExecutioner.h>
+#include <graph/GraphSession.h>
+#include <graph/exceptions/unresolved_output_exception.h>
+
+namespace sd {
+namespace graph {
+
+GraphSession::GraphSession(Graph *graph) {
+  _origin = graph->getVariableSpace();
+
+  // nodes are copied once per session, so sessions never touch each other's node state
+  _graph = graph->cloneWithProxy();
+}
+
+GraphSession::~GraphSession() {
+  delete _variableSpace;
+  releaseArena();
+  delete _graph;
+
+  for (auto v : _inputs) delete v;
+}
+
+void GraphSession::rebuild() {
+  // arrays allocated for previous shapes go away together with old proxy
+  delete _variableSpace;
+  releaseArena();
+  _outputs.clear();
+
+  _variableSpace = new VariableProxy(_origin);
+  _variableSpace->setFlowPath(&_flowPath);
+  _variableSpace->setWorkspace(&_workspace);
+
+  for (size_t e = 0; e < _inputs.size(); e++) {
+    auto id = _inputIds[e];
+    auto name = _origin->hasVariable(id) ? _origin->getVariable(id)->getName() : nullptr;
+
+    // inputs are shadowing variables of the stored graph, and remain owned by session
+    auto var = new Variable(_inputs[e], name != nullptr && !name->empty() ? name->c_str() : nullptr, id, 0);
+    var->markRemovable(false);
+    _variableSpace->putVariable(id, var);
+  }
+
+  // node outputs always go to session's own variables, so stored graph is never written to
+  for (auto &v : *_graph->getMapped()) {
+    for (int e = 0; e == 0 || _origin->hasVariable(v.first, e); e++) {
+      auto name = _origin->hasVariable(v.first, e) ? _origin->getVariable(v.first, e)->getName() : nullptr;
+      auto var = new Variable(nullptr, name != nullptr && !name->empty() ? name->c_str() : nullptr, v.first, e);
+      _variableSpace->putVariable(v.first, e, var);
+    }
+  }
+
+  _rebuilds++;
+}
+
+void GraphSession::releaseArena() {
+  for (auto v : _arenaArrays) delete v;
+
+  _arenaArrays.clear();
+  _arena.reset();
+  _plan = MemoryPlan();
+  _planned = false;
+}
+
+void GraphSession::planMemory() {
+  _planned = true;
+  _plan = MemoryPlan::build(_graph, _variableSpace);
+
+  if (_plan.empty() || _plan.arenaSize() >= _plan.naiveSize()) return;
+
+  _arena = std::make_shared<DataBuffer>(_plan.arenaSize(), sd::DataType::INT8, nullptr, true);
+
+  for (const auto &a : _plan.allocations()) {
+    auto offset = a.offset / DataTypeUtils::sizeOfElement(ArrayOptions::dataType(a.shapeInfo));
+    auto array = new NDArray(_arena, const_cast<sd::LongType *>(a.shapeInfo), _variableSpace->launchContext(), offset);
+    _arenaArrays.emplace_back(array);
+
+    // planned arrays were allocated by ops during the previous call, and nothing else refers to them
+    auto var = _variableSpace->getVariable(a.variable.first, a.variable.second);
+    delete var->getNDArray();
+    var->setNDArray(array);
+    var->markRemovable(false);
+  }
+
+  // outputs of in-place nodes were sharing arrays we've just released
+  for (const auto &a : _plan.aliases()) {
+    auto var = _variableSpace->getVariable(a.first.first, a.first.second);
+    var->setNDArray(_arenaArrays[a.second]);
+    var->markRemovable(false);
+  }
+}
+
+sd::Status GraphSession::execute(sd::Pointer *inputBuffers, sd::Pointer *inputShapes, int *inputIndices,
+                                 int numInputs) {
+  bool rebind = _variableSpace == nullptr || (size_t)numInputs != _inputs.size();
+  for (int e = 0; e < numInputs && !rebind; e++)
+    rebind = _inputIds[e] != inputIndices[e] ||
+             !shape::equalsStrict(_inputs[e]->shapeInfo(), reinterpret_cast<sd::LongType *>(inputShapes[e]));
+
+  if (rebind) {
+    for (size_t e = numInputs; e < _inputs.size(); e++) delete _inputs[e];
+
+    _inputs.resize(numInputs, nullptr);
+    _inputIds.assign(inputIndices, inputIndices + numInputs);
+
+    for (int e = 0; e < numInputs; e++)
+      if (_inputs[e] == nullptr) _inputs[e] = new NDArray();
+  }
+
+  // zero-copy binding: arrays are just pointed to caller's buffers
+  for (int e = 0; e < numInputs; e++)
+    *_inputs[e] = NDArray(inputBuffers[e], reinterpret_cast<sd::LongType *>(inputShapes[e]));
+
+  if (rebind) rebuild();
+
+  auto run = [&]() -> sd::Status {
+    _flowPath.reset();
+    _workspace.scopeIn();
+    try {
+      auto status = GraphExecutioner::execute(_graph, _variableSpace);
+      _workspace.scopeOut();
+      return status;
+    } catch (...) {
+      _workspace.scopeOut();
+      throw;
+    }
+  };
+
+  auto status = run();
+
+  _executions++;
+
+  _outputs.clear();
+  if (status != sd::Status::OK) return status;
+
+  if (!_planned) planMemory();
+
+  for (auto id : *_graph->output()) {
+    for (int e = 0;; e++) {
+      if (!_variableSpace->hasVariable(id, e)) {
+        if (e == 0) throw unresolved_output_exception::build("Can't find output variable", id, e);
+
+        break;
+      }
+
+      _outputs.emplace_back(_variableSpace->getVariable(id, e));
+    }
+  }
+
+  return status;
+}
+
+}  // namespace graph
+}  // namespace sd
@@ -0,0 +1,210 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Liveness based placement of graph activations
+//
+#include <graph/MemoryPlan.h>
+#include <helpers/ConstantShapeHelper.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace sd {
+namespace graph {
+
+static SD_INLINE sd::LongType alignedSize(sd::LongType bytes) {
+  return (bytes + MemoryPlan::kAlignment - 1) / MemoryPlan::kAlignment * MemoryPlan::kAlignment;
+}
+
+int MemoryPlan::addAllocation(const std::pair<int, int> &variable, const sd::LongType *shapeInfo, sd::LongType bytes,
+                              int first, int last) {
+  Allocation allocation;
+  allocation.variable = variable;
+  allocation.shapeInfo = shapeInfo;
+  allocation.bytes = alignedSize(bytes);
+  allocation.first = first;
+  allocation.last = last;
+
+  _allocations.emplace_back(allocation);
+  return (int)_allocations.size() - 1;
+}
+
+void MemoryPlan::addAlias(const std::pair<int, int> &variable, int allocation) {
+  _aliases.emplace_back(variable, allocation);
+}
+
+sd::LongType MemoryPlan::naiveSize() const {
+  sd::LongType result = 0;
+  for (const auto &a : _allocations) result += a.bytes;
+
+  return result;
+}
+
+void MemoryPlan::assignOffsets() {
+  std::vector<int> order(_allocations.size());
+  for (size_t e = 0; e < order.size(); e++) order[e] = (int)e;
+
+  // biggest buffers go first, so smaller ones are packed into the gaps left around them
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) -> bool {
+    if (_allocations[a].bytes != _allocations[b].bytes) return _allocations[a].bytes > _allocations[b].bytes;
+
+    return _allocations[a].first < _allocations[b].first;
+  });
+
+  _arenaSize = 0;
+  std::vector<int> placed;
+  std::vector<int> live;
+  for (auto i : order) {
+    auto &current = _allocations[i];
+
+    live.clear();
+    for (auto j : placed)
+      if (_allocations[j].first <= current.last && current.first <= _allocations[j].last) live.emplace_back(j);
+
+    std::sort(live.begin(), live.end(),
+              [&](int a, int b) -> bool { return _allocations[a].offset < _allocations[b].offset; });
+
+    // best fit among gaps between buffers alive at the same time, or the end of all of them
+    sd::LongType best = -1;
+    sd::LongType bestGap = DataTypeUtils::max<sd::LongType>();
+    sd::LongType prevEnd = 0;
+    for (auto j : live) {
+      const auto gap = _allocations[j].offset - prevEnd;
+      if (gap >= current.bytes && gap < bestGap) {
+        best = prevEnd;
+        bestGap = gap;
+      }
+
+      prevEnd = sd::math::sd_max<sd::LongType>(prevEnd, _allocations[j].offset + _allocations[j].bytes);
+    }
+
+    current.offset = best >= 0 ? best : prevEnd;
+    _arenaSize = sd::math::sd_max<sd::LongType>(_arenaSize, current.offset + current.bytes);
+
+    placed.emplace_back(i);
+  }
+}
+
+MemoryPlan MemoryPlan::build(Graph *graph, VariableSpace *variableSpace) {
+  MemoryPlan plan;
+
+  if (graph->buildGraph() != sd::Status::OK) return plan;
+
+  auto onion = graph->getOnion();
+  auto mapped = graph->getMapped();
+
+  // loops rewind execution to earlier layers, so layer order tells nothing about lifetimes there
+  for (auto &v : *mapped)
+    if (v.second->opType() == OpType_LOGIC || v.second->isScoped()) return plan;
+
+  struct Tensor {
+    NDArray *array;
+    int first;
+    int last;
+    bool pinned;
+  };
+
+  std::map<std::pair<int, int>, Tensor> tensors;
+  std::map<std::pair<int, int>, std::pair<int, int>> roots;
+
+  auto rootOf = [&](const std::pair<int, int> &p) -> std::pair<int, int> {
+    auto it = roots.find(p);
+    return it == roots.end() ? p : it->second;
+  };
+
+  for (int l = 0; l < (int)onion->size(); l++) {
+    int layerSize = onion->count(l) == 1 ? onion->at(l)->size() : 0;
+
+    for (int n = 0; n < layerSize; n++) {
+      auto node = onion->at(l)->at(n);
+
+      for (auto &in : *node->input()) {
+        auto t = tensors.find(rootOf(in));
+        if (t != tensors.end()) t->second.last = sd::math::sd_max<int>(t->second.last, l);
+      }
+
+      auto block = node->getContextPrototype();
+      const bool inplace = block != nullptr && block->isInplace();
+
+      for (int e = 0; variableSpace->hasVariable(node->id(), e); e++) {
+        auto var = variableSpace->getVariable(node->id(), e);
+        if (var->variableType() != VariableType::NDARRAY || !var->hasNDArray()) continue;
+
+        std::pair<int, int> p(node->id(), e);
+        if (inplace) {
+          // in-place output is the very same array as corresponding input, so it just extends lifetime of that buffer
+          if (e < (int)node->input()->size()) {
+            auto root = rootOf(node->input()->at(e));
+            auto t = tensors.find(root);
+            if (t != tensors.end() && t->second.array == var->getNDArray()) {
+              roots[p] = root;
+              t->second.last = sd::math::sd_max<int>(t->second.last, l);
+            }
+          }
+
+          continue;
+        }
+
+        auto array = var->getNDArray();
+        const bool eligible = !array->isEmpty() && !array->isS() && !array->isView() && array->lengthOf() > 0 &&
+                              array->ews() == 1 && array->buffer() != nullptr;
+
+        tensors[p] = {array, l, l, !eligible || node->hasExternalOutputs()};
+      }
+    }
+  }
+
+  // results must survive the run
+  for (auto id : *graph->output())
+    for (auto &t : tensors)
+      if (t.first.first == id) t.second.pinned = true;
+
+  for (auto &r : roots)
+    if (std::find(graph->output()->begin(), graph->output()->end(), r.first.first) != graph->output()->end() ||
+        mapped->at(r.first.first)->hasExternalOutputs())
+      tensors.at(r.second).pinned = true;
+
+  // arrays sharing memory with anything else (views, propagated variables) are left as is
+  std::map<const void *, std::set<NDArray *>> owners;
+  for (auto var : variableSpace->getVariables())
+    if (var->variableType() == VariableType::NDARRAY && var->hasNDArray() && var->getNDArray()->buffer() != nullptr)
+      owners[var->getNDArray()->buffer()].insert(var->getNDArray());
+
+  std::map<std::pair<int, int>, int> indices;
+  for (auto &t : tensors) {
+    if (t.second.pinned || owners[t.second.array->buffer()].size() > 1) continue;
+
+    auto array = t.second.array;
+    auto shapeInfo = ConstantShapeHelper::getInstance().bufferForShapeInfo(array->shapeInfo())->primary();
+    indices[t.first] = plan.addAllocation(t.first, shapeInfo, array->lengthOf() * array->sizeOfT(), t.second.first,
+                                          t.second.last);
+  }
+
+  for (auto &r : roots) {
+    auto it = indices.find(r.second);
+    if (it != indices.end()) plan.addAlias(r.first, it->second);
+  }
+
+  plan.assignOffsets();
+  return plan;
+}
+
+}  // namespace graph
+}  // namespace sd
@@ -710,7 +710,9 @@ void Node::setDeductable(bool reallyDeductable) { _isDeductable = reallyDeductab
 
 Node* Node::clone() {
   if (this->_customOp && this->_opType == sd::graph::OpType_CUSTOM) {
-    auto clone = new Node(this->_customOp, _id);
+    // deductable custom ops (i.e. fused chains) are owned by the node, so each clone gets its own copy
+    auto op = _isDeductable ? dynamic_cast<sd::ops::LegacyOp*>(_customOp)->clone() : this->_customOp;
+    auto clone = new Node(op, _id);
     clone->pullValues(this);
     return clone;
   } else {
@@ -31,9 +31,14 @@ void VariablesSet::push_back(Variable *variable) { _holder.push_back(variable);
 
 Variable *VariablesSet::at(int index) { return _holder.at(index); }
 
-VariablesSet::VariablesSet(sd::Status status) { _status = status; }
+VariablesSet::VariablesSet(sd::Status status, bool removable) {
+  _status = status;
+  _removable = removable;
+}
 
 VariablesSet::~VariablesSet() {
+  if (!_removable) return;
+
   for (auto v : _holder) delete v;
 }
 }  // namespace graph
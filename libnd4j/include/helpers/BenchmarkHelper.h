@@ -0,0 +1,100 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_BENCHMARKHELPER_H
+#define LIBND4J_BENCHMARKHELPER_H
+
+#include <array/ResultSet.h>
+#include <graph/Context.h>
+#include <helpers/OpBenchmark.h>
+#include <helpers/benchmark/BenchmarkReport.h>
+#include <helpers/benchmark/BroadcastBenchmark.h>
+#include <helpers/benchmark/DeclarableBenchmark.h>
+#include <helpers/benchmark/MatrixBenchmark.h>
+#include <helpers/benchmark/PairwiseBenchmark.h>
+#include <helpers/benchmark/ParametersBatch.h>
+#include <helpers/benchmark/ReductionBenchmark.h>
+#include <helpers/benchmark/ScalarBenchmark.h>
+#include <helpers/benchmark/TransformBenchmark.h>
+
+#include <functional>
+
+namespace sd {
+using graph::Context;
+
+/**
+ * Runs benchmarks over every combination of parameters produced by ParametersBatch.
+ * Each combination is warmed up, then timed call by call, so median and p99 latencies are available along with
+ * GFLOP/s and memory throughput. Results are returned as text table and, if report is given, recorded there too
+ */
+class SD_LIB_EXPORT BenchmarkHelper {
+ private:
+  unsigned int _wIterations;
+  unsigned int _rIterations;
+  BenchmarkReport *_report;
+
+ protected:
+  std::string benchmarkOperation(OpBenchmark &benchmark, const Parameters &parameters, const std::string &suite);
+
+  std::string printHeader(const char *message);
+
+  // runs one clone of given benchmark per array triple produced by generator, and releases those arrays afterwards
+  std::string runGenerated(OpBenchmark *op, const Parameters &parameters, ResultSet &x, ResultSet *y, ResultSet &z,
+                           const std::string &suite);
+
+ public:
+  BenchmarkHelper(unsigned int warmUpIterations = 10, unsigned int runIterations = 100,
+                  BenchmarkReport *report = nullptr);
+
+  void setReport(BenchmarkReport *report);
+
+  std::string runOperationSuit(std::initializer_list<OpBenchmark *> benchmarks, const char *message = nullptr);
+  std::string runOperationSuit(std::vector<OpBenchmark *> &benchmarks, const char *message = nullptr);
+  std::string runOperationSuit(OpBenchmark *op, const char *message = nullptr);
+
+  std::string runOperationSuit(ScalarBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(TransformBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(ReductionBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(ReductionBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(BroadcastBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(PairwiseBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(MatrixBenchmark *op,
+                               const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+  std::string runOperationSuit(DeclarableBenchmark *op, const std::function<Context *(Parameters &)> &func,
+                               ParametersBatch &parametersBatch, const char *message = nullptr);
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BENCHMARKHELPER_H
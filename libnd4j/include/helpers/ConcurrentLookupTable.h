@@ -0,0 +1,142 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Insert-only hash table used by the constant shape/TAD caches.
+//
+// Lookups never take a lock: every bucket is a singly linked list whose head is published with release semantics,
+// and entries are immutable once published. Inserts CAS a new entry onto the bucket head; if another thread managed to
+// publish an equal key first, the loser's entry (and value) is discarded and the winner's value is returned, so every
+// key maps to exactly one value for the lifetime of the table.
+//
+#ifndef LIBND4J_CONCURRENTLOOKUPTABLE_H
+#define LIBND4J_CONCURRENTLOOKUPTABLE_H
+
+#include <system/common.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace sd {
+
+template <typename K, typename V, typename H = std::hash<K>>
+class ConcurrentLookupTable {
+ private:
+  struct Entry {
+    const K key;
+    const size_t hash;
+    V *value;
+    Entry *next;
+
+    Entry(const K &k, const size_t h, V *v, Entry *n) : key(k), hash(h), value(v), next(n) {}
+  };
+
+  std::unique_ptr<std::atomic<Entry *>[]> _buckets;
+  const size_t _mask;
+  std::atomic<sd::LongType> _size;
+  H _hasher;
+
+  // walks the chain from head up to (not including) stop
+  static SD_INLINE V *lookup(const Entry *head, const Entry *stop, const K &key, const size_t hash) {
+    for (auto e = head; e != stop; e = e->next)
+      if (e->hash == hash && e->key == key) return e->value;
+
+    return nullptr;
+  }
+
+ public:
+  /**
+   * @param bucketsLog2 - log2 of the number of buckets, table never rehashes
+   */
+  explicit ConcurrentLookupTable(const int bucketsLog2 = 14)
+      : _buckets(new std::atomic<Entry *>[size_t(1) << bucketsLog2]), _mask((size_t(1) << bucketsLog2) - 1), _size(0) {
+    for (size_t e = 0; e <= _mask; e++) _buckets[e].store(nullptr, std::memory_order_relaxed);
+  }
+
+  // values are constants shared with the rest of the library, so only the table structure is released here
+  ~ConcurrentLookupTable() {
+    for (size_t e = 0; e <= _mask; e++) {
+      auto entry = _buckets[e].load(std::memory_order_relaxed);
+      while (entry != nullptr) {
+        auto next = entry->next;
+        delete entry;
+        entry = next;
+      }
+    }
+  }
+
+  ConcurrentLookupTable(const ConcurrentLookupTable &other) = delete;
+  ConcurrentLookupTable &operator=(const ConcurrentLookupTable &other) = delete;
+
+  /**
+   * This method returns value stored for given key, or nullptr if there's no such key yet
+   */
+  V *get(const K &key) const { return get(key, _hasher(key)); }
+
+  V *get(const K &key, const size_t hash) const {
+    return lookup(_buckets[hash & _mask].load(std::memory_order_acquire), nullptr, key, hash);
+  }
+
+  /**
+   * Lookup without building a key: hash must be the one H gives for the wanted key, equals(key) tells if stored key
+   * is the wanted one
+   */
+  template <typename Eq>
+  V *find(const size_t hash, Eq &&equals) const {
+    for (auto e = _buckets[hash & _mask].load(std::memory_order_acquire); e != nullptr; e = e->next)
+      if (e->hash == hash && equals(e->key)) return e->value;
+
+    return nullptr;
+  }
+
+  /**
+   * This method returns value stored for given key. If there's no such key, factory is invoked (without holding any
+   * lock) and its result gets published. If concurrent call published the same key first, produced value is deleted.
+   */
+  template <typename F>
+  V *getOrCreate(const K &key, F &&factory) {
+    const auto hash = _hasher(key);
+    auto &bucket = _buckets[hash & _mask];
+
+    auto head = bucket.load(std::memory_order_acquire);
+    if (auto existing = lookup(head, nullptr, key, hash)) return existing;
+
+    auto entry = new Entry(key, hash, factory(), head);
+    while (!bucket.compare_exchange_weak(entry->next, entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      // only entries published since our last look can hold the same key
+      if (auto existing = lookup(entry->next, head, key, hash)) {
+        delete entry->value;
+        delete entry;
+        return existing;
+      }
+      head = entry->next;
+    }
+
+    _size.fetch_add(1, std::memory_order_relaxed);
+    return entry->value;
+  }
+
+  bool contains(const K &key) const { return get(key) != nullptr; }
+
+  sd::LongType size() const { return _size.load(std::memory_order_relaxed); }
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_CONCURRENTLOOKUPTABLE_H
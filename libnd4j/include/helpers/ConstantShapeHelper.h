@@ -25,19 +25,19 @@
 
 #include <array/ConstantShapeBuffer.h>
 #include <array/ShapeDescriptor.h>
+#include <helpers/ConcurrentLookupTable.h>
 #include <memory/Workspace.h>
 #include <system/op_boilerplate.h>
 
-#include <map>
-#include <mutex>
+#include <memory>
 #include <vector>
 
 namespace sd {
 
 class SD_LIB_EXPORT ConstantShapeHelper {
  private:
-  std::mutex _mutex;
-  std::vector<SD_MAP_IMPL<ShapeDescriptor , ConstantShapeBuffer *>> _cache;
+  // one lock-free table per device, lookups of already cached shapes never block
+  std::vector<std::unique_ptr<ConcurrentLookupTable<ShapeDescriptor, ConstantShapeBuffer>>> _cache;
 #if defined(__NEC__)
   bool _cache_existing_pointers = true;
 #endif
@@ -94,7 +94,7 @@ class SD_LIB_EXPORT ConstantShapeHelper {
   SD_INLINE int cachedEntriesForDevice(int deviceId) {
     if (deviceId > _cache.size()) THROW_EXCEPTION("deviceId > number of actual devices");
 
-    return _cache[deviceId].size();
+    return _cache[deviceId]->size();
   }
 
   /**
@@ -104,7 +104,7 @@ class SD_LIB_EXPORT ConstantShapeHelper {
   SD_INLINE int totalCachedEntries() {
     int total = 0;
 
-    for (int e = 0; e < _cache.size(); e++) total += _cache[e].size();
+    for (int e = 0; e < _cache.size(); e++) total += _cache[e]->size();
 
     return total;
   }
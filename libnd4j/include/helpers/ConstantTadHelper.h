@@ -28,16 +28,18 @@
 #include <array/ShapeDescriptor.h>
 #include <array/TadDescriptor.h>
 #include <array/TadPack.h>
+#include <helpers/ConcurrentLookupTable.h>
 #include <system/op_boilerplate.h>
 
-#include <map>
-#include <mutex>
+#include <memory>
 #include <vector>
 namespace sd {
 class SD_LIB_EXPORT ConstantTadHelper {
  private:
-  std::mutex _mutex;
-  std::vector<SD_MAP_IMPL<TadDescriptor *, TadPack *>> _cache;
+  // one lock-free table per device, keyed by descriptor value
+  std::vector<std::unique_ptr<ConcurrentLookupTable<TadDescriptor, TadPack>>> _cache;
+
+  TadPack *buildTadPack(TadDescriptor &descriptor);
 
   ConstantTadHelper();
 
@@ -62,6 +64,7 @@ class SD_LIB_EXPORT ConstantTadHelper {
   TadPack *tadForDimensions(ShapeDescriptor &descriptor, std::vector<LongType> &dimensions,
                            const bool keepUnitiesInShape = false);
   TadPack *tadForDimensions(TadDescriptor *descriptor);
+  TadPack *tadForDimensions(TadDescriptor &descriptor);
 
   /**
    * This method returns number of cached TAD shapes/offsets on specific device
@@ -70,7 +73,7 @@ class SD_LIB_EXPORT ConstantTadHelper {
   SD_INLINE int cachedEntriesForDevice(int deviceId) {
     if (deviceId > _cache.size()) THROW_EXCEPTION("deviceId > number of actual devices");
 
-    return _cache[deviceId].size();
+    return _cache[deviceId]->size();
   }
 
   /**
@@ -80,7 +83,7 @@ class SD_LIB_EXPORT ConstantTadHelper {
   SD_INLINE int totalCachedEntries() {
     int total = 0;
 
-    for (int e = 0; e < _cache.size(); e++) total += _cache[e].size();
+    for (int e = 0; e < _cache.size(); e++) total += _cache[e]->size();
 
     return total;
   }
@@ -0,0 +1,140 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Always-on execution tracing: fixed-size events in per-thread rings, exported as Chrome trace JSON or Perfetto
+//
+#ifndef LIBND4J_EXECUTIONTRACER_H
+#define LIBND4J_EXECUTIONTRACER_H
+
+#include <helpers/ConcurrentLookupTable.h>
+#include <system/Environment.h>
+#include <system/common.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sd {
+
+/**
+ * Single traced execution. Records are fixed size, so recording one is a couple of stores into a ring
+ */
+struct TraceEvent {
+  uint64_t nameHash;   // op hash, or function address for compiler-instrumented functions
+  uint64_t shapeHash;  // hash of input shapes, 0 if not known
+  uint64_t start;      // ExecutionTracer::ticks()
+  uint64_t end;
+  int64_t bytes;       // DataBuffer bytes allocated by the executing thread, nested executions included
+  uint32_t threadId;   // tracer-assigned thread index
+  uint32_t kind;       // ExecutionTracer::Kind
+};
+
+class TraceRing;
+
+class SD_LIB_EXPORT ExecutionTracer {
+ public:
+  enum Kind : uint32_t { OP = 0, FUNCTION = 1 };
+  enum Format { CHROME_JSON = 0, PERFETTO = 1 };
+
+  // events kept per thread, older ones get overwritten
+  static const uint64_t kRingCapacity = 1 << 15;
+
+ private:
+  std::mutex _lock;
+  std::vector<TraceRing *> _rings;
+  ConcurrentLookupTable<uint64_t, std::string> _names;
+
+  // ticks are converted to nanoseconds with the rate measured against steady clock since tracer creation
+  uint64_t _epochTicks;
+  int64_t _epochNanos;
+  mutable std::atomic<double> _ticksPerNanosecond{0.};
+
+  ExecutionTracer();
+  ~ExecutionTracer() = default;
+
+  TraceRing *ring();
+  std::string nameOf(const TraceEvent &event) const;
+  double calibrate(bool force) const;
+
+ public:
+  ExecutionTracer(const ExecutionTracer &other) = delete;
+  ExecutionTracer &operator=(const ExecutionTracer &other) = delete;
+
+  static ExecutionTracer &getInstance();
+
+  /**
+   * This is the only check done on hot paths when tracing is off, see Environment::setTracing()
+   */
+  static SD_INLINE bool isEnabled() { return Environment::getInstance().isTracing(); }
+
+  /**
+   * TSC on x86, steady clock elsewhere
+   */
+  static uint64_t ticks();
+
+  static uint64_t hashShape(uint64_t seed, const sd::LongType *shapeInfo);
+
+  /**
+   * DataBuffer allocation hook: bytes are added to the calling thread's counter, which only grows
+   */
+  static void countAllocation(sd::LongType bytes);
+  static sd::LongType allocatedBytes();
+
+  /**
+   * This method tells if execution that took given number of ticks should be recorded: every N-th execution on the
+   * calling thread is sampled, and executions slower than Environment::traceSlowNanos() are always kept
+   */
+  bool shouldRecord(uint64_t durationTicks);
+
+  void registerName(uint64_t nameHash, const std::string &name);
+
+  void record(uint64_t nameHash, uint64_t shapeHash, uint64_t start, uint64_t end, int64_t bytes, Kind kind);
+
+  /**
+   * Hooks for -finstrument-functions builds, nested calls are matched with a small per-thread stack
+   */
+  void functionEnter(void *function);
+  void functionExit(void *function);
+
+  /**
+   * This method returns snapshot of all recorded events, ordered by thread and start time
+   */
+  std::vector<TraceEvent> events();
+
+  /**
+   * This method drops all recorded events
+   */
+  void purge();
+
+  std::string toChromeJson();
+  std::string toPerfetto();
+
+  /**
+   * This method writes recorded events to the given file
+   */
+  void exportTrace(const std::string &path, Format format);
+
+  uint64_t nanoseconds(uint64_t ticks) const;
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_EXECUTIONTRACER_H
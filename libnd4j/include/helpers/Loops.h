@@ -27,6 +27,7 @@
 #include <helpers/ConstantTadHelper.h>
 #include <helpers/LoopKind.h>
 #include <helpers/OmpLaunchHelper.h>
+#include <helpers/PairwiseReduction.h>
 #include <helpers/shape.h>
 #include <loops/indexreduce.h>
 #include <ops/ops.h>
@@ -164,14 +165,7 @@ static void reduceExec21(const X* x, const sd::LongType* xShapeInfo, Z* z, const
       auto x0 = x + i0 * xStrd0;
       auto z0 = z + i0 * zStrd0;
 
-      auto s = OpType::startingValue(x0);
-
-      if (xStrd1 == 1)
-        for (sd::LongType i1 = 0; i1 < xAxis1; ++i1)
-          s = OpType::update(s, OpType::op(x0[i1], extraParams), extraParams);
-      else
-        for (sd::LongType i1 = 0; i1 < xAxis1; ++i1)
-          s = OpType::update(s, OpType::op(x0[i1 * xStrd1], extraParams), extraParams);
+      const auto s = PairwiseReduction<X, E, OpType>::reduce(x0, xAxis1, xStrd1, extraParams);
 
       *z0 = OpType::postProcess(s, static_cast<sd::LongType>(xAxis1), extraParams);
     }
@@ -200,22 +194,17 @@ static void reduceExec31(const X* x, const sd::LongType* xShapeInfo, Z* z, const
       auto x0 = x + i0 * xStrd0;
       auto z0 = z + i0 * zStrd0;
 
-      auto s = OpType::startingValue(x0);
+      typename PairwiseReduction<X, E, OpType>::Stream s(extraParams);
 
+      // rows along the unit-stride axis are reduced pairwise, row results are merged in order
       if (xStrd1 == 1)
         for (sd::LongType i2 = 0; i2 < xAxis2; ++i2)
-          for (sd::LongType i1 = 0; i1 < xAxis1; ++i1)
-            s = OpType::update(s, OpType::op(x0[i1 + i2 * xStrd2], extraParams), extraParams);
-      else if (xStrd2 == 1)
-        for (sd::LongType i1 = 0; i1 < xAxis1; ++i1)
-          for (sd::LongType i2 = 0; i2 < xAxis2; ++i2)
-            s = OpType::update(s, OpType::op(x0[i1 * xStrd1 + i2], extraParams), extraParams);
+          s.push(PairwiseReduction<X, E, OpType>::reduce(x0 + i2 * xStrd2, xAxis1, 1, extraParams));
       else
         for (sd::LongType i1 = 0; i1 < xAxis1; ++i1)
-          for (sd::LongType i2 = 0; i2 < xAxis2; ++i2)
-            s = OpType::update(s, OpType::op(x0[i1 * xStrd1 + i2 * xStrd2], extraParams), extraParams);
+          s.push(PairwiseReduction<X, E, OpType>::reduce(x0 + i1 * xStrd1, xAxis2, xStrd2, extraParams));
 
-      *z0 = OpType::postProcess(s, tadLen, extraParams);
+      *z0 = OpType::postProcess(s.result(x0), tadLen, extraParams);
     }
   };
 
@@ -243,14 +232,7 @@ SD_LIB_HIDDEN void reduceExec32(const X* x, const sd::LongType* xShapeInfo, Z* z
         auto x1 = x + i0 * xStrd0 + i1 * xStrd1;
         auto z1 = z + i0 * zStrd0 + i1 * zStrd1;
 
-        auto s = OpType::startingValue(x1);
-
-        if (xStrd2 == 1)
-          for (sd::LongType i2 = 0; i2 < xAxis2; ++i2)
-            s = OpType::update(s, OpType::op(x1[i2], extraParams), extraParams);
-        else
-          for (sd::LongType i2 = 0; i2 < xAxis2; ++i2)
-            s = OpType::update(s, OpType::op(x1[i2 * xStrd2], extraParams), extraParams);
+        const auto s = PairwiseReduction<X, E, OpType>::reduce(x1, xAxis2, xStrd2, extraParams);
 
         *z1 = OpType::postProcess(s, static_cast<sd::LongType>(xAxis2), extraParams);
       }
@@ -287,7 +269,7 @@ SD_LIB_HIDDEN void reduceExec41(const X* x, const sd::LongType* xShapeInfo, Z* z
       auto x0 = x + i0 * xStrd0;
       auto z0 = z + i0 * zStrd0;
 
-      auto s = OpType::startingValue(x0);
+      typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x0);
 
       if (xStrd1 == 1)
         for (sd::LongType i3 = 0; i3 < xAxis3; ++i3)
@@ -345,7 +327,7 @@ SD_LIB_HIDDEN void reduceExec42(const X* x, const sd::LongType* xShapeInfo, Z* z
         auto x1 = x + i0 * xStrd0 + i1 * xStrd1;
         auto z1 = z + i0 * zStrd0 + i1 * zStrd1;
 
-        auto s = OpType::startingValue(x1);
+        typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x1);
 
         if (xStrd2 == 1)
           for (sd::LongType i3 = 0; i3 < xAxis3; ++i3)
@@ -395,7 +377,7 @@ SD_LIB_HIDDEN void reduceExec43(const X* x, const sd::LongType* xShapeInfo, Z* z
           auto x2 = x + i0 * xStrd0 + i1 * xStrd1 + i2 * xStrd2;
           auto z2 = z + i0 * zStrd0 + i1 * zStrd1 + i2 * zStrd2;
 
-          auto s = OpType::startingValue(x2);
+          typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x2);
 
           if (xStrd3 == 1)
             for (sd::LongType i3 = 0; i3 < xAxis3; ++i3)
@@ -443,7 +425,7 @@ SD_LIB_HIDDEN void reduceExec51(const X* x, const sd::LongType* xShapeInfo, Z* z
       auto x0 = x + i0 * xStrd0;
       auto z0 = z + i0 * zStrd0;
 
-      auto s = OpType::startingValue(x0);
+      typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x0);
 
       if (xStrd1 == 1)
         for (sd::LongType i4 = 0; i4 < xAxis4; ++i4)
@@ -520,7 +502,7 @@ SD_LIB_HIDDEN void reduceExec52(const X* x, const sd::LongType* xShapeInfo, Z* z
         auto x1 = x + i0 * xStrd0 + i1 * xStrd1;
         auto z1 = z + i0 * zStrd0 + i1 * zStrd1;
 
-        auto s = OpType::startingValue(x1);
+        typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x1);
 
         if (xStrd2 == 1)
           for (sd::LongType i4 = 0; i4 < xAxis4; ++i4)
@@ -585,7 +567,7 @@ SD_LIB_HIDDEN void reduceExec53(const X* x, const sd::LongType* xShapeInfo, Z* z
           auto x2 = x + i0 * xStrd0 + i1 * xStrd1 + i2 * xStrd2;
           auto z2 = z + i0 * zStrd0 + i1 * zStrd1 + i2 * zStrd2;
 
-          auto s = OpType::startingValue(x2);
+          typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x2);
 
           if (xStrd3 == 1)
             for (sd::LongType i4 = 0; i4 < xAxis4; ++i4)
@@ -642,7 +624,7 @@ SD_LIB_HIDDEN void reduceExec54(const X* x, const sd::LongType* xShapeInfo, Z* z
             auto x3 = x + i0 * xStrd0 + i1 * xStrd1 + i2 * xStrd2 + i3 * xStrd3;
             auto z3 = z + i0 * zStrd0 + i1 * zStrd1 + i2 * zStrd2 + i3 * zStrd3;
 
-            auto s = OpType::startingValue(x3);
+            typename ReduceAccumulator<OpType, X>::type s = OpType::startingValue(x3);
 
             if (xStrd4 == 1)
               for (sd::LongType i4 = 0; i4 < xAxis4; ++i4)
@@ -698,10 +680,9 @@ SD_LIB_HIDDEN void reduceDefault(sd::memory::Workspace* workspace, const X* x, c
   auto func = PRAGMA_THREADS_FOR {
     for (auto i = start; i < stop; ++i) {
       const auto tad = x + outerXTadOffsets[i];
-      auto s = OpType::startingValue(tad);
-
-      for (sd::LongType j = 0; j < tadLen; j++)
-        s = OpType::update(s, OpType::op(tad[innerXTadOffsets[j]], extraParams), extraParams);
+      const auto s = PairwiseReduction<X, E, OpType>::reduce(
+          tad, [tad, innerXTadOffsets](sd::LongType j) -> X { return tad[innerXTadOffsets[j]]; }, 0, tadLen,
+          extraParams);
 
       z[zOffsets[i]] = OpType::postProcess(s, tadLen, extraParams);
     }
@@ -0,0 +1,55 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Read-only view of a file mapped into memory
+//
+#ifndef LIBND4J_MMAPFILE_H
+#define LIBND4J_MMAPFILE_H
+#include <system/common.h>
+
+namespace sd {
+
+/**
+ * This class maps the whole file into memory. Mapping is private: pages are read from page cache on first access and
+ * stay shared with it until written to, and writes never reach the file itself.
+ */
+class SD_LIB_EXPORT MmapFile {
+ protected:
+  char *_data = nullptr;
+  sd::LongType _length = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+  void *_file = nullptr;
+  void *_mapping = nullptr;
+#endif
+
+ public:
+  explicit MmapFile(const char *fileName);
+  ~MmapFile();
+
+  MmapFile(const MmapFile &other) = delete;
+  MmapFile &operator=(const MmapFile &other) = delete;
+
+  char *data() const { return _data; }
+  sd::LongType length() const { return _length; }
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_MMAPFILE_H
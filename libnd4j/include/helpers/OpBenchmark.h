@@ -32,6 +32,10 @@
 #include <legacy/NativeOpExecutioner.h>
 
 namespace sd {
+/**
+ * Base class for single-op micro benchmarks. Subclasses bind operands via setX/setY/setZ and implement executeOnce();
+ * flops() and bytes() describe one execution, so BenchmarkHelper can report GFLOP/s and memory throughput
+ */
 class SD_LIB_EXPORT OpBenchmark {
  protected:
   int _opNum = 0;
@@ -39,16 +43,19 @@ class SD_LIB_EXPORT OpBenchmark {
   NDArray *_x = nullptr;
   NDArray *_y = nullptr;
   NDArray *_z = nullptr;
-  std::vector<sd::LongType> *_axis;
+  std::vector<sd::LongType> _axis;
+
+  static std::string orderOf(NDArray *array);
 
  public:
   OpBenchmark() = default;
+  virtual ~OpBenchmark() = default;
   OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z);
   OpBenchmark(std::string name, NDArray *x, NDArray *z);
-  OpBenchmark(std::string name, NDArray *x, NDArray *z, std::initializer_list<sd::LongType> *axis);
+  OpBenchmark(std::string name, NDArray *x, NDArray *z, std::initializer_list<sd::LongType> axis);
   OpBenchmark(std::string name, NDArray *x, NDArray *z, std::vector<sd::LongType> axis);
-  OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::initializer_list<sd::LongType> *axis);
-  OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::vector<sd::LongType> *axis);
+  OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::initializer_list<sd::LongType> axis);
+  OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::vector<sd::LongType> axis);
 
   void setOpNum(int opNum);
   void setTestName(std::string testName);
@@ -65,11 +72,17 @@ class SD_LIB_EXPORT OpBenchmark {
 
   virtual std::string extra();
   virtual std::string dataType();
-  virtual std::string axis() = 0;
-  virtual std::string orders() = 0;
-  virtual std::string strides() = 0;
+  virtual std::string axis();
+  virtual std::string orders();
+  virtual std::string strides();
   virtual std::string shape();
-  virtual std::string inplace() = 0;
+  virtual std::string inplace();
+
+  // floating point operations performed by single executeOnce() call
+  virtual double flops();
+
+  // bytes read and written by single executeOnce() call
+  virtual double bytes();
 
   virtual void executeOnce() = 0;
 
@@ -0,0 +1,183 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Pairwise (cascade) accumulation used by the CPU reduce loops.
+//
+// Spans up to kLeaf elements are folded into kLanes interleaved accumulators, which keeps independent dependency
+// chains for the vectorizer, and the lanes are then merged as a binary tree. Longer spans are halved recursively,
+// so the rounding error grows with log(n) instead of n. Accumulation happens in the op's InterType when it declares
+// one (float for HALF/BFLOAT16 sums and means), so 16-bit inputs are never upcast as a whole.
+//
+// Full-array reductions are split into fixed kChunk pieces regardless of the number of threads, and the partial
+// results are merged in index order, so the result does not depend on how the work was scheduled.
+//
+#ifndef LIBND4J_PAIRWISEREDUCTION_H
+#define LIBND4J_PAIRWISEREDUCTION_H
+
+#include <execution/Threads.h>
+#include <math/templatemath.h>
+#include <system/op_boilerplate.h>
+
+#include <memory>
+
+namespace sd {
+
+template <typename T>
+struct ReduceVoid {
+  using type = void;
+};
+
+/**
+ * Type the op accumulates in: InterType if the op declares one, otherwise whatever startingValue() returns
+ */
+template <typename OpType, typename X, typename = void>
+struct ReduceAccumulator {
+  using type = decltype(OpType::startingValue(static_cast<const X *>(nullptr)));
+};
+
+template <typename OpType, typename X>
+struct ReduceAccumulator<OpType, X, typename ReduceVoid<typename OpType::InterType>::type> {
+  using type = typename OpType::InterType;
+};
+
+template <typename X, typename E, typename OpType>
+class PairwiseReduction {
+ public:
+  using Acc = typename ReduceAccumulator<OpType, X>::type;
+
+  static constexpr int kLanes = 8;
+  static constexpr sd::LongType kLeaf = 256;
+  static constexpr sd::LongType kChunk = 16384;
+
+  /**
+   * Reduces elements [begin, end) of a span, get(i) returns the i-th element
+   * @param first - pointer handed to OpType::startingValue
+   */
+  template <typename Getter>
+  static Acc reduce(const X *first, const Getter &get, const sd::LongType begin, const sd::LongType end,
+                    E *extraParams) {
+    const auto length = end - begin;
+    if (length <= kLeaf) return leaf(first, get, begin, end, extraParams);
+
+    // split on a leaf boundary so the leaves stay full
+    const auto half = ((length / 2 + kLeaf - 1) / kLeaf) * kLeaf;
+    return OpType::update(reduce(first, get, begin, begin + half, extraParams),
+                          reduce(first, get, begin + half, end, extraParams), extraParams);
+  }
+
+  static Acc reduce(const X *x, const sd::LongType length, const sd::LongType stride, E *extraParams) {
+    if (stride == 1) return reduce(x, [x](sd::LongType i) -> X { return x[i]; }, 0, length, extraParams);
+
+    return reduce(x, [x, stride](sd::LongType i) -> X { return x[i * stride]; }, 0, length, extraParams);
+  }
+
+  /**
+   * Deterministic multi-threaded version of reduce(): chunking doesn't depend on the number of threads
+   */
+  template <typename Getter>
+  static Acc reduceParallel(const X *first, const Getter &get, const sd::LongType length, E *extraParams,
+                            const int maxThreads) {
+    if (length <= kChunk) return reduce(first, get, 0, length, extraParams);
+
+    const auto numChunks = (length + kChunk - 1) / kChunk;
+    std::unique_ptr<Acc[]> partials(new Acc[numChunks]);
+
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++)
+        partials[c] = reduce(first, get, c * kChunk, sd::math::sd_min<sd::LongType>(length, (c + 1) * kChunk),
+                             extraParams);
+    };
+
+    // single thread goes through the very same chunks, so results match bit for bit
+    if (maxThreads <= 1)
+      func(0, 0, numChunks, 1);
+    else
+      samediff::Threads::parallel_for(func, 0, numChunks, 1, maxThreads);
+
+    return combine(partials.get(), numChunks, extraParams);
+  }
+
+  /**
+   * Streaming form for nested loops: partial results of consecutive rows are pushed in order and merged as a binary
+   * counter, which gives the same tree shape as reduce() without materializing the partials
+   */
+  class Stream {
+   private:
+    Acc _levels[64];
+    uint64_t _count = 0;
+    E *_extraParams;
+
+   public:
+    explicit Stream(E *extraParams) : _extraParams(extraParams) {}
+
+    void push(Acc value) {
+      int level = 0;
+      for (; (_count >> level) & 1; level++) value = OpType::update(_levels[level], value, _extraParams);
+
+      _levels[level] = value;
+      _count++;
+    }
+
+    Acc result(const X *first) const {
+      Acc r = OpType::startingValue(first);
+      bool empty = true;
+      for (int level = 0; level < 64; level++) {
+        if (!((_count >> level) & 1)) continue;
+
+        r = empty ? _levels[level] : OpType::update(_levels[level], r, _extraParams);
+        empty = false;
+      }
+
+      return r;
+    }
+  };
+
+ private:
+  template <typename Getter>
+  static SD_INLINE Acc leaf(const X *first, const Getter &get, const sd::LongType begin, const sd::LongType end,
+                            E *extraParams) {
+    Acc lanes[kLanes];
+    for (int l = 0; l < kLanes; l++) lanes[l] = OpType::startingValue(first);
+
+    auto i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+      PRAGMA_OMP_SIMD
+      for (int l = 0; l < kLanes; l++) lanes[l] = OpType::update(lanes[l], OpType::op(get(i + l), extraParams), extraParams);
+    }
+
+    for (int l = 0; i < end; i++, l++) lanes[l] = OpType::update(lanes[l], OpType::op(get(i), extraParams), extraParams);
+
+    for (int width = kLanes / 2; width > 0; width /= 2)
+      for (int l = 0; l < width; l++) lanes[l] = OpType::update(lanes[l], lanes[l + width], extraParams);
+
+    return lanes[0];
+  }
+
+  static Acc combine(const Acc *partials, const sd::LongType n, E *extraParams) {
+    if (n == 1) return partials[0];
+
+    const auto half = n / 2;
+    return OpType::update(combine(partials, half, extraParams), combine(partials + half, n - half, extraParams),
+                          extraParams);
+  }
+};
+
+}  // namespace sd
+
+#endif  // LIBND4J_PAIRWISEREDUCTION_H
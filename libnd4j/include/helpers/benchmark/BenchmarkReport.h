@@ -0,0 +1,96 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Machine-readable benchmark results: one record per (benchmark, parameters) pair, exported as JSON or CSV
+//
+
+#ifndef LIBND4J_BENCHMARKREPORT_H
+#define LIBND4J_BENCHMARKREPORT_H
+
+#include <system/common.h>
+
+#include <string>
+#include <vector>
+
+namespace sd {
+struct SD_LIB_EXPORT BenchmarkResult {
+  std::string suite;
+  std::string testName;
+  std::string parameters;
+  std::string dataType;
+  std::string orders;
+  std::string shape;
+  std::string strides;
+  std::string axis;
+  std::string inplace;
+  std::string extra;
+
+  sd::LongType iterations = 0;
+
+  // timings of a single op invocation, in nanoseconds
+  double minNs = 0.0;
+  double medianNs = 0.0;
+  double p99Ns = 0.0;
+  double maxNs = 0.0;
+  double meanNs = 0.0;
+  double stdDevNs = 0.0;
+
+  // cost of a single op invocation, 0 when unknown
+  double flops = 0.0;
+  double bytes = 0.0;
+
+  // throughput derived from median timing
+  double gflops() const;
+  double bytesPerSecond() const;
+};
+
+class SD_LIB_EXPORT BenchmarkReport {
+ private:
+  std::vector<BenchmarkResult> _results;
+
+ public:
+  BenchmarkReport() = default;
+  ~BenchmarkReport() = default;
+
+  void add(const BenchmarkResult &result);
+
+  const std::vector<BenchmarkResult> &results() const;
+
+  size_t size() const;
+
+  void clear();
+
+  /**
+   * Array of objects, one per result
+   */
+  std::string asJson() const;
+
+  /**
+   * Header line followed by one line per result
+   */
+  std::string asCsv() const;
+
+  /**
+   * Nearest-rank percentile of given timings, timings get sorted in place
+   */
+  static double percentile(std::vector<double> &timings, double p);
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BENCHMARKREPORT_H
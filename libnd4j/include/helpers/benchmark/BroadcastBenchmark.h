@@ -0,0 +1,54 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_BROADCASTBENCHMARK_H
+#define LIBND4J_BROADCASTBENCHMARK_H
+
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+class SD_LIB_EXPORT BroadcastBenchmark : public OpBenchmark {
+ public:
+  BroadcastBenchmark() : OpBenchmark() {}
+
+  BroadcastBenchmark(broadcast::Ops op, std::string testName, std::initializer_list<sd::LongType> axis)
+      : OpBenchmark() {
+    _opNum = (int)op;
+    _testName = testName;
+    _axis = axis;
+  }
+
+  BroadcastBenchmark(broadcast::Ops op, std::string testName, NDArray *x, NDArray *y, NDArray *z,
+                     std::vector<sd::LongType> axis)
+      : OpBenchmark(testName, x, y, z, axis) {
+    _opNum = (int)op;
+  }
+
+  void executeOnce() override { _x->applyBroadcast((broadcast::Ops)_opNum, &_axis, *_y, *_z); }
+
+  OpBenchmark *clone() override {
+    return new BroadcastBenchmark((broadcast::Ops)_opNum, _testName, _x, _y, _z, _axis);
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BROADCASTBENCHMARK_H
@@ -0,0 +1,141 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_DECLARABLEBENCHMARK_H
+#define LIBND4J_DECLARABLEBENCHMARK_H
+
+#include <graph/Context.h>
+#include <helpers/OpBenchmark.h>
+#include <ops/declarable/DeclarableOp.h>
+
+#include <functional>
+
+namespace sd {
+/**
+ * Custom op benchmark: operands, iArgs and tArgs come with Context produced by PARAMETRIC_D generator.
+ * Optional flops estimator provides arithmetic cost of a single op call for the given Context
+ */
+class SD_LIB_EXPORT DeclarableBenchmark : public OpBenchmark {
+ protected:
+  ops::DeclarableOp *_op = nullptr;
+  graph::Context *_context = nullptr;
+  std::function<double(graph::Context &)> _flops;
+
+ public:
+  DeclarableBenchmark(ops::DeclarableOp &op, std::string name) : OpBenchmark() {
+    _op = &op;
+    _testName = name;
+  }
+
+  DeclarableBenchmark(ops::DeclarableOp &op, std::string name, std::function<double(graph::Context &)> flops)
+      : DeclarableBenchmark(op, name) {
+    _flops = flops;
+  }
+
+  void setContext(graph::Context *ctx) { _context = ctx; }
+
+  graph::Context *context() { return _context; }
+
+  void setFlopsEstimator(std::function<double(graph::Context &)> flops) { _flops = flops; }
+
+  void executeOnce() override {
+    auto status = _op->execute(_context);
+    if (status != sd::Status::OK) THROW_EXCEPTION("DeclarableBenchmark: op execution failed");
+  }
+
+  std::string dataType() override {
+    if (_context == nullptr || _context->fastpath_in().empty()) return "N/A";
+
+    return DataTypeUtils::asString(_context->fastpath_in()[0]->dataType());
+  }
+
+  std::string shape() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result;
+    for (auto array : _context->fastpath_in()) {
+      if (!result.empty()) result += "/";
+      result += array == nullptr ? std::string("N/A") : ShapeUtils::shapeAsString(array);
+    }
+    return result;
+  }
+
+  std::string orders() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result;
+    for (auto array : _context->fastpath_in()) {
+      if (!result.empty()) result += "/";
+      result += orderOf(array);
+    }
+    return result;
+  }
+
+  std::string strides() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result;
+    for (auto array : _context->fastpath_in()) {
+      if (!result.empty()) result += "/";
+      result += array == nullptr ? std::string("N/A") : ShapeUtils::strideAsString(array);
+    }
+    return result;
+  }
+
+  std::string axis() override { return "N/A"; }
+
+  std::string inplace() override { return _context != nullptr && _context->isInplace() ? "true" : "false"; }
+
+  std::string extra() override {
+    if (_context == nullptr) return "N/A";
+
+    std::string result("iArgs=[");
+    auto iArgs = _context->getIArguments();
+    for (size_t e = 0; e < iArgs->size(); e++) {
+      if (e > 0) result += ",";
+      result += std::to_string(iArgs->at(e));
+    }
+    return result + "]";
+  }
+
+  double flops() override { return _flops && _context != nullptr ? _flops(*_context) : 0.0; }
+
+  double bytes() override {
+    if (_context == nullptr) return 0.0;
+
+    double result = 0.0;
+    for (auto list : {&_context->fastpath_in(), &_context->fastpath_out()})
+      for (auto array : *list)
+        if (array != nullptr) result += static_cast<double>(array->lengthOf()) * array->sizeOfT();
+
+    return result;
+  }
+
+  OpBenchmark *clone() override {
+    auto result = new DeclarableBenchmark(*_op, _testName, _flops);
+    result->setContext(_context);
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_DECLARABLEBENCHMARK_H
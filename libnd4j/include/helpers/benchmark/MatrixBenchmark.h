@@ -0,0 +1,94 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_MATRIXBENCHMARK_H
+#define LIBND4J_MATRIXBENCHMARK_H
+
+#include <helpers/MmulHelper.h>
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+/**
+ * Z = alpha * op(X) * op(Y) + beta * Z, where op() optionally transposes its argument
+ */
+class SD_LIB_EXPORT MatrixBenchmark : public OpBenchmark {
+ private:
+  float _alpha = 1.0f;
+  float _beta = 0.0f;
+  bool _tA = false;
+  bool _tB = false;
+
+ public:
+  MatrixBenchmark() : OpBenchmark() {}
+
+  MatrixBenchmark(float alpha, float beta, bool tA, bool tB, std::string testName) : OpBenchmark() {
+    _testName = testName;
+    _alpha = alpha;
+    _beta = beta;
+    _tA = tA;
+    _tB = tB;
+  }
+
+  MatrixBenchmark(float alpha, float beta, bool tA, bool tB, std::string testName, NDArray *x, NDArray *y, NDArray *z)
+      : OpBenchmark(testName, x, y, z) {
+    _alpha = alpha;
+    _beta = beta;
+    _tA = tA;
+    _tB = tB;
+  }
+
+  void executeOnce() override {
+    // transposed operands are views, no copies involved
+    const NDArray *a = _x;
+    const NDArray *b = _y;
+    NDArray aT, bT;
+    if (_tA) {
+      aT = _x->transpose();
+      a = &aT;
+    }
+    if (_tB) {
+      bT = _y->transpose();
+      b = &bT;
+    }
+
+    MmulHelper::mmul(a, b, _z, _alpha, _beta, _z->ordering());
+  }
+
+  std::string axis() override { return "N/A"; }
+
+  std::string inplace() override { return "N/A"; }
+
+  std::string extra() override {
+    return std::string("transA=") + (_tA ? "true" : "false") + ", transB=" + (_tB ? "true" : "false");
+  }
+
+  // 2 * M * N * K
+  double flops() override {
+    const double k = static_cast<double>(_tA ? _x->sizeAt(0) : _x->sizeAt(1));
+    return 2.0 * static_cast<double>(_z->lengthOf()) * k;
+  }
+
+  OpBenchmark *clone() override { return new MatrixBenchmark(_alpha, _beta, _tA, _tB, _testName, _x, _y, _z); }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_MATRIXBENCHMARK_H
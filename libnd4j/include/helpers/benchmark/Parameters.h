@@ -0,0 +1,77 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Single point of benchmark parameters space: named integer values, in the order they were added
+//
+
+#ifndef LIBND4J_BENCHMARK_PARAMETERS_H
+#define LIBND4J_BENCHMARK_PARAMETERS_H
+
+#include <system/common.h>
+#include <system/op_boilerplate.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sd {
+class SD_LIB_EXPORT Parameters {
+ private:
+  std::vector<std::pair<std::string, int>> _intParams;
+
+ public:
+  Parameters() = default;
+
+  Parameters *addIntParam(const std::string &name, int value) {
+    for (auto &p : _intParams)
+      if (p.first == name) {
+        p.second = value;
+        return this;
+      }
+
+    _intParams.emplace_back(name, value);
+    return this;
+  }
+
+  Parameters *addBoolParam(const std::string &name, bool value) { return addIntParam(name, value ? 1 : 0); }
+
+  int getIntParam(const std::string &name) const {
+    for (const auto &p : _intParams)
+      if (p.first == name) return p.second;
+
+    THROW_EXCEPTION(("Benchmark parameter [" + name + "] wasn't defined").c_str());
+  }
+
+  bool getBoolParam(const std::string &name) const { return getIntParam(name) != 0; }
+
+  const std::vector<std::pair<std::string, int>> &intParams() const { return _intParams; }
+
+  // "name1=value1, name2=value2"
+  std::string asString() const {
+    std::string result;
+    for (const auto &p : _intParams) {
+      if (!result.empty()) result += ", ";
+      result += p.first + "=" + std::to_string(p.second);
+    }
+    return result;
+  }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BENCHMARK_PARAMETERS_H
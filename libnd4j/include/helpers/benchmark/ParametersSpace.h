@@ -0,0 +1,122 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Named sets of values a single benchmark parameter iterates over
+//
+
+#ifndef LIBND4J_BENCHMARK_PARAMETERSSPACE_H
+#define LIBND4J_BENCHMARK_PARAMETERSSPACE_H
+
+#include <system/common.h>
+#include <system/op_boilerplate.h>
+
+#include <string>
+#include <vector>
+
+namespace sd {
+class SD_LIB_EXPORT ParametersSpace {
+ protected:
+  std::string _name;
+
+ public:
+  explicit ParametersSpace(const std::string &name) : _name(name) {}
+  virtual ~ParametersSpace() = default;
+
+  const std::string &name() const { return _name; }
+
+  virtual std::vector<int> evaluate() const = 0;
+};
+
+/**
+ * start, start + step, ..., up to stop inclusive
+ */
+class SD_LIB_EXPORT IntParameters : public ParametersSpace {
+ private:
+  int _start;
+  int _stop;
+  int _step;
+
+ public:
+  IntParameters(const std::string &name, int start, int stop, int step = 1)
+      : ParametersSpace(name), _start(start), _stop(stop), _step(step) {
+    if (step < 1) THROW_EXCEPTION("IntParameters: step should be positive");
+  }
+
+  std::vector<int> evaluate() const override {
+    std::vector<int> result;
+    for (int e = _start; e <= _stop; e += _step) result.push_back(e);
+    return result;
+  }
+};
+
+/**
+ * base^start, base^(start + step), ..., up to base^stop inclusive
+ */
+class SD_LIB_EXPORT IntPowerParameters : public ParametersSpace {
+ private:
+  int _base;
+  int _start;
+  int _stop;
+  int _step;
+
+ public:
+  IntPowerParameters(const std::string &name, int base, int start, int stop, int step = 1)
+      : ParametersSpace(name), _base(base), _start(start), _stop(stop), _step(step) {
+    if (step < 1) THROW_EXCEPTION("IntPowerParameters: step should be positive");
+  }
+
+  std::vector<int> evaluate() const override {
+    std::vector<int> result;
+    for (int e = _start; e <= _stop; e += _step) {
+      long long value = 1;
+      for (int p = 0; p < e; p++) value *= _base;
+      result.push_back(static_cast<int>(value));
+    }
+    return result;
+  }
+};
+
+/**
+ * false and true, as 0 and 1
+ */
+class SD_LIB_EXPORT BoolParameters : public ParametersSpace {
+ public:
+  explicit BoolParameters(const std::string &name) : ParametersSpace(name) {}
+
+  std::vector<int> evaluate() const override { return {0, 1}; }
+};
+
+/**
+ * explicitly listed values
+ */
+class SD_LIB_EXPORT PredefinedParameters : public ParametersSpace {
+ private:
+  std::vector<int> _values;
+
+ public:
+  PredefinedParameters(const std::string &name, std::initializer_list<int> values)
+      : ParametersSpace(name), _values(values) {}
+  PredefinedParameters(const std::string &name, const std::vector<int> &values)
+      : ParametersSpace(name), _values(values) {}
+
+  std::vector<int> evaluate() const override { return _values; }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_BENCHMARK_PARAMETERSSPACE_H
@@ -0,0 +1,88 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+
+#ifndef LIBND4J_TRANSFORMBENCHMARK_H
+#define LIBND4J_TRANSFORMBENCHMARK_H
+
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+class SD_LIB_EXPORT TransformBenchmark : public OpBenchmark {
+ public:
+  // transform op family the op number belongs to
+  enum TransformType { Strict = 0, Same = 1, Float = 2, Any = 3, Bool = 4 };
+
+ protected:
+  int _opType = Strict;
+
+ public:
+  TransformBenchmark() : OpBenchmark() {}
+
+  TransformBenchmark(int opNum, int opType, std::string testName, NDArray *x, NDArray *z)
+      : OpBenchmark(testName, x, z) {
+    _opNum = opNum;
+    _opType = opType;
+  }
+
+  TransformBenchmark(transform::StrictOps op, std::string name)
+      : TransformBenchmark((int)op, Strict, name, nullptr, nullptr) {}
+  TransformBenchmark(transform::SameOps op, std::string name)
+      : TransformBenchmark((int)op, Same, name, nullptr, nullptr) {}
+  TransformBenchmark(transform::FloatOps op, std::string name)
+      : TransformBenchmark((int)op, Float, name, nullptr, nullptr) {}
+  TransformBenchmark(transform::AnyOps op, std::string name)
+      : TransformBenchmark((int)op, Any, name, nullptr, nullptr) {}
+  TransformBenchmark(transform::BoolOps op, std::string name)
+      : TransformBenchmark((int)op, Bool, name, nullptr, nullptr) {}
+
+  void executeOnce() override {
+    switch (_opType) {
+      case Strict:
+        _x->applyTransform((transform::StrictOps)_opNum, *_z);
+        break;
+      case Same:
+        _x->applyTransform((transform::SameOps)_opNum, *_z);
+        break;
+      case Float:
+        _x->applyTransform((transform::FloatOps)_opNum, *_z);
+        break;
+      case Any:
+        _x->applyTransform((transform::AnyOps)_opNum, *_z);
+        break;
+      case Bool:
+        _x->applyTransform((transform::BoolOps)_opNum, *_z);
+        break;
+      default:
+        THROW_EXCEPTION("TransformBenchmark: unknown transform type");
+    }
+  }
+
+  std::string extra() override {
+    static const char *names[] = {"strict", "same", "float", "any", "bool"};
+    return std::string("type=") + names[_opType];
+  }
+
+  OpBenchmark *clone() override { return new TransformBenchmark(_opNum, _opType, _testName, _x, _z); }
+};
+}  // namespace sd
+
+#endif  // LIBND4J_TRANSFORMBENCHMARK_H
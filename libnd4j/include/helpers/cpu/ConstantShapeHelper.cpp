@@ -29,11 +29,7 @@
 
 namespace sd {
 ConstantShapeHelper::ConstantShapeHelper() {
-  _cache.resize(1);
-  for (int e = 0; e < 1; e++) {
-    SD_MAP_IMPL<ShapeDescriptor , ConstantShapeBuffer *> cache;
-    _cache[e] = cache;
-  }
+  _cache.emplace_back(new ConcurrentLookupTable<ShapeDescriptor, ConstantShapeBuffer>());
 }
 
 ConstantShapeHelper& ConstantShapeHelper::getInstance() {
@@ -43,58 +39,54 @@ ConstantShapeHelper& ConstantShapeHelper::getInstance() {
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(sd::DataType dataType, char order,
                                                              const std::vector<sd::LongType>& shape) {
-  auto descriptor = new ShapeDescriptor(dataType, order, shape);
-  auto ret =  bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  return bufferForShapeInfo(dataType, order, static_cast<int>(shape.size()), shape.data());
 }
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::DataType dataType, const char order,
                                                              const int rank, const sd::LongType* shape) {
-  auto descriptor = new ShapeDescriptor(dataType, order, shape, rank);
-  auto ret =  bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  // hits are resolved against raw shape, descriptor is built only for a new entry
+  auto existing = _cache[0]->find(ShapeDescriptor::hashShape(dataType, order, shape, rank),
+                                  [&](const ShapeDescriptor& d) { return d.equalsShape(dataType, order, shape, rank); });
+  if (existing != nullptr) return existing;
+
+  ShapeDescriptor descriptor(dataType, order, shape, rank);
+  return bufferForShapeInfo(&descriptor);
 }
 
 ConstantShapeBuffer * ConstantShapeHelper::bufferForShapeInfo(ShapeDescriptor *descriptor) {
   int deviceId = 0;
-  std::lock_guard<std::mutex> lock(_mutex);
   if(_cache.empty()) {
     THROW_EXCEPTION("Cache is empty!");
   }
 
-  if (_cache[deviceId].count(*descriptor) == 0) {
+  return _cache[deviceId]->getOrCreate(*descriptor, [descriptor]() {
     auto hPtr =
         std::make_shared<PointerWrapper>(descriptor->toShapeInfo(), std::make_shared<PrimaryPointerDeallocator>());
-    ConstantShapeBuffer *constantShapeBuffer2 = new ConstantShapeBuffer(hPtr);
-    _cache[deviceId][*descriptor] = constantShapeBuffer2;
-    return constantShapeBuffer2;
-  } else {
-    return _cache[deviceId].at(*descriptor);
-  }
+    return new ConstantShapeBuffer(hPtr);
+  });
 }
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::LongType* shapeInfo) {
-  auto descriptor = new ShapeDescriptor(shapeInfo);
-  auto ret =  bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  // broken shapeInfo is reported by ShapeDescriptor
+  if (shapeInfo != nullptr && shape::rank(shapeInfo) >= 0 && shape::rank(shapeInfo) <= SD_MAX_RANK) {
+    auto existing = _cache[0]->find(ShapeDescriptor::hashShapeInfo(shapeInfo),
+                                    [shapeInfo](const ShapeDescriptor& d) { return d.equalsShapeInfo(shapeInfo); });
+    if (existing != nullptr) return existing;
+  }
+
+  ShapeDescriptor descriptor(shapeInfo);
+  return bufferForShapeInfo(&descriptor);
 }
 
 bool ConstantShapeHelper::checkBufferExistenceForShapeInfo(ShapeDescriptor *descriptor) {
   int deviceId = 0;
-  std::lock_guard<std::mutex> lock(_mutex);
 
-  return _cache[deviceId].count(*descriptor) != 0;
+  return _cache[deviceId]->contains(*descriptor);
 }
 
 const sd::LongType* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank,
                                                          const sd::LongType* shape) {
-  auto descriptor = new ShapeDescriptor(dataType, order, shape, rank);
-  auto ret =  bufferForShapeInfo(descriptor)->primary();
-  delete descriptor;
-  return ret;
+  return bufferForShapeInfo(dataType, order, rank, shape)->primary();
 }
 
 const sd::LongType* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const sd::LongType* shapeInfo) {
@@ -125,10 +117,7 @@ const sd::LongType* ConstantShapeHelper::vectorShapeInfo(const sd::LongType leng
 
 const sd::LongType* ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order,
                                                          const std::vector<sd::LongType>& shape) {
-  ShapeDescriptor * descriptor = new ShapeDescriptor(dataType, order, shape);
-  auto ret =  bufferForShapeInfo(descriptor)->primary();
-  delete descriptor;
-  return ret;
+  return bufferForShapeInfo(dataType, order, static_cast<int>(shape.size()), shape.data())->primary();
 }
 
 const sd::LongType* ConstantShapeHelper::createShapeInfo(ShapeDescriptor* descriptor) {
@@ -136,19 +125,15 @@ const sd::LongType* ConstantShapeHelper::createShapeInfo(ShapeDescriptor* descri
 }
 
 const sd::LongType* ConstantShapeHelper::createFromExisting(sd::LongType* shapeInfo, bool destroyOriginal) {
-  ShapeDescriptor *descriptor = new ShapeDescriptor(shapeInfo);
-  auto result = createShapeInfo(descriptor);
+  auto result = bufferForShapeInfo(shapeInfo)->primary();
   if (destroyOriginal) RELEASE(shapeInfo, nullptr)
-  delete descriptor;
   return result;
 }
 
 const sd::LongType* ConstantShapeHelper::createFromExisting(sd::LongType* shapeInfo, sd::memory::Workspace* workspace) {
-  ShapeDescriptor *descriptor = new ShapeDescriptor(shapeInfo);
-  auto result = createShapeInfo(descriptor);
+  auto result = bufferForShapeInfo(shapeInfo)->primary();
 
   RELEASE(shapeInfo, workspace);
-  delete descriptor;
   return result;
 }
 
@@ -191,13 +176,11 @@ ConstantShapeBuffer* ConstantShapeHelper::createShapeInfoWithUnitiesForBroadcast
     }
   }
 
-  ShapeDescriptor *descriptor = new ShapeDescriptor(newShapeInfo);
+  auto result = bufferForShapeInfo(newShapeInfo);
 
   RELEASE(newShapeInfo, workspace);
 
-  auto ret = bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  return result;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -215,13 +198,11 @@ ConstantShapeBuffer* ConstantShapeHelper::createShapeInfoWithNoUnitiesForReduce(
     shape::excludeUnitiesFromShapeInfo(maxShapeInfo, dimsWithUnities->data(), dimsWithUnities->size(), newShapeInfo);
   }
 
-  ShapeDescriptor *descriptor = new ShapeDescriptor(newShapeInfo);
+  auto result = bufferForShapeInfo(newShapeInfo);
 
   RELEASE(newShapeInfo, workspace);
 
-  auto ret =  bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  return result;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -229,13 +210,11 @@ ConstantShapeBuffer* ConstantShapeHelper::createSubArrShapeInfo(const sd::LongTy
                                                                 const sd::LongType dimsSize, sd::memory::Workspace* workspace) {
   sd::LongType* newShapeInfo = ShapeBuilders::createSubArrShapeInfo(inShapeInfo, dims, dimsSize, workspace);
 
-  ShapeDescriptor *descriptor = new ShapeDescriptor(newShapeInfo);
+  auto result = bufferForShapeInfo(newShapeInfo);
 
   RELEASE(newShapeInfo, workspace);
 
-  auto ret = bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  return result;
 }
 
 }  // namespace sd
@@ -31,8 +31,7 @@
 namespace sd {
 
 ConstantTadHelper::ConstantTadHelper() {
-  SD_MAP_IMPL<TadDescriptor *, TadPack *> pack;
-  _cache.emplace_back(pack);
+  _cache.emplace_back(new ConcurrentLookupTable<TadDescriptor, TadPack>());
 }
 
 ConstantTadHelper &ConstantTadHelper::getInstance() {
@@ -52,56 +51,58 @@ TadPack *ConstantTadHelper::tadForDimensions(const sd::LongType *originalShape,
 
 TadPack *ConstantTadHelper::tadForDimensions(const sd::LongType *originalShape, LongType *dimensions, LongType dimLength,
                                              const bool keepUnitiesInShape) {
-  TadDescriptor *tadDescriptor = new TadDescriptor(originalShape, dimensions, dimLength, keepUnitiesInShape);
+  TadDescriptor tadDescriptor(originalShape, dimensions, dimLength, keepUnitiesInShape);
   return tadForDimensions(tadDescriptor);
 }
 
 TadPack *ConstantTadHelper::tadForDimensions(ShapeDescriptor &descriptor, std::vector<LongType> &dimensions,
                                              const bool keepUnitiesInShape) {
-  TadDescriptor *tadDescriptor = new TadDescriptor(descriptor, dimensions, keepUnitiesInShape);
+  TadDescriptor tadDescriptor(descriptor, dimensions, keepUnitiesInShape);
   return tadForDimensions(tadDescriptor);
 }
 
 TadPack *ConstantTadHelper::tadForDimensions(TadDescriptor *descriptor) {
-  const int deviceId = 0;
   if(descriptor == nullptr)
     THROW_EXCEPTION("ConstantTadHelper::tadForDimensions: descriptor is nullptr!");
-  std::lock_guard<std::mutex> lock(_mutex);
-  if (_cache[deviceId].count(descriptor) == 0) {
-    // if there's no TadPack matching this descriptor - create one
-    const auto shapeInfo = descriptor->originalShape().toShapeInfo();
-    const sd::LongType rank = shape::rank(shapeInfo);
-    const std::vector<sd::LongType> *dimsToExclude = ShapeUtils::evalDimsToExclude(rank, descriptor->axis().size(),descriptor->axis().data());
 
-    const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(shapeInfo, *dimsToExclude);
-    const sd::LongType subArrRank =
-        (rank == dimsToExclude->size() || descriptor->areUnitiesinShape()) ? rank : rank - dimsToExclude->size();
+  return tadForDimensions(*descriptor);
+}
 
-    auto sPtr = std::make_shared<PointerWrapper>(
-        new sd::LongType[shape::shapeInfoLength(subArrRank)],
-        std::make_shared<PrimaryPointerDeallocator>());  // shape of sub-arrays (same for all for them)
-    auto oPtr =
-        std::make_shared<PointerWrapper>(new sd::LongType[numOfSubArrs], std::make_shared<PrimaryPointerDeallocator>());
+TadPack *ConstantTadHelper::tadForDimensions(TadDescriptor &descriptor) {
+  const int deviceId = 0;
 
-    if (numOfSubArrs > 0)
-      shape::calcSubArrsShapeInfoAndOffsets(shapeInfo, numOfSubArrs, dimsToExclude->size(), dimsToExclude->data(),
-                                            sPtr->pointerAsT<sd::LongType>(), oPtr->pointerAsT<sd::LongType>(),
-                                            descriptor->areUnitiesinShape());
+  // if there's no TadPack matching this descriptor - create one
+  return _cache[deviceId]->getOrCreate(descriptor, [&]() { return buildTadPack(descriptor); });
+}
 
-    ConstantShapeBuffer shapeBuffer(sPtr);
-    ConstantOffsetsBuffer offsetsBuffer(oPtr);
-    TadPack *t = new TadPack(shapeBuffer, offsetsBuffer, numOfSubArrs);
+TadPack *ConstantTadHelper::buildTadPack(TadDescriptor &descriptor) {
+  const auto shapeInfo = descriptor.originalShape().toShapeInfo();
+  const sd::LongType rank = shape::rank(shapeInfo);
+  const std::vector<sd::LongType> *dimsToExclude =
+      ShapeUtils::evalDimsToExclude(rank, descriptor.axis().size(), descriptor.axis().data());
 
-    _cache[deviceId][descriptor] = t;
-    delete dimsToExclude;
+  const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(shapeInfo, *dimsToExclude);
+  const sd::LongType subArrRank =
+      (rank == dimsToExclude->size() || descriptor.areUnitiesinShape()) ? rank : rank - dimsToExclude->size();
 
-  }
+  auto sPtr = std::make_shared<PointerWrapper>(
+      new sd::LongType[shape::shapeInfoLength(subArrRank)],
+      std::make_shared<PrimaryPointerDeallocator>());  // shape of sub-arrays (same for all for them)
+  auto oPtr =
+      std::make_shared<PointerWrapper>(new sd::LongType[numOfSubArrs], std::make_shared<PrimaryPointerDeallocator>());
 
+  if (numOfSubArrs > 0)
+    shape::calcSubArrsShapeInfoAndOffsets(shapeInfo, numOfSubArrs, dimsToExclude->size(), dimsToExclude->data(),
+                                          sPtr->pointerAsT<sd::LongType>(), oPtr->pointerAsT<sd::LongType>(),
+                                          descriptor.areUnitiesinShape());
 
-  return _cache[deviceId][descriptor];
+  ConstantShapeBuffer shapeBuffer(sPtr);
+  ConstantOffsetsBuffer offsetsBuffer(oPtr);
 
-// if there's no TadPack matching this descriptor - create one
+  delete dimsToExclude;
+  delete[] shapeInfo;
 
+  return new TadPack(shapeBuffer, offsetsBuffer, numOfSubArrs);
 }
 }  // namespace sd
 
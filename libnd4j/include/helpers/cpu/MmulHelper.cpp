@@ -27,6 +27,8 @@
 #include <execution/Threads.h>
 #include <helpers/BlasHelper.h>
 #include <helpers/ShapeUtils.h>
+#include <ops/impl/gemm_int8.hpp>
+#include <ops/impl/gemm_packed.hpp>
 
 namespace sd {
 
@@ -36,63 +38,36 @@ template <typename T1, typename T2, typename T3>
 static void usualGemm(const NDArray* vA, const NDArray* vB, NDArray* vC, const int aMaxis, const int aKaxis,
                       const int bKaxis, const int bNaxis, const int cMaxis, const int cNaxis, const double alpha,
                       const double beta) {
-  const T1* A = vA->bufferAsT<T1>();
-  const T2* B = vB->bufferAsT<T2>();
-  T3* C = vC->bufferAsT<T3>();
-
-  const T3 alphaZ = alpha;
-  const T3 betaZ = beta;
-
-  const bool betaPersent = beta;
-
-  const sd::LongType* aShapeInfo = vA->shapeInfo();
-  const sd::LongType* bShapeInfo = vB->shapeInfo();
-  const sd::LongType* cShapeInfo = vC->shapeInfo();
-
-  const int aRank = vA->rankOf();
-  const int bRank = vB->rankOf();
-  const int cRank = vC->rankOf();
-
-  const sd::LongType cLen = vC->lengthOf();
-
-  const int K = vA->sizeAt(aKaxis);
-
-  auto func = PRAGMA_THREADS_FOR {
-    std::vector<sd::LongType> aCoords(2), bCoords(2), cCoords(2);
-
-    for (auto i = start; i < stop; ++i) {
-      // evaluate C coordinates
-      shape::index2coordsCPU(start, i, cShapeInfo, cCoords.data());
-
-      // evaluate A coordinates
-      aCoords[aMaxis] = cCoords[cMaxis];
-      aCoords[aKaxis] = 0;
-
-      // evaluate B coordinates
-      bCoords[bKaxis] = 0;
-      bCoords[bNaxis] = cCoords[cNaxis];
-
-      auto aOffset = shape::getOffset(aShapeInfo, aCoords.data());
-      auto bOffset = shape::getOffset(bShapeInfo, bCoords.data());
-
-      T3 val = A[aOffset] * B[bOffset];  // first iteration
-
-      for (int j = 1; j < K; ++j) {  // rest iterations
-        aOffset += shape::stride(aShapeInfo)[aKaxis];
-        bOffset += shape::stride(bShapeInfo)[bKaxis];
-        val = val + A[aOffset] * B[bOffset];
-      }
-
-      auto cOffset = shape::getOffset(cShapeInfo, cCoords.data());
-
-      if (betaPersent)
-        C[cOffset] = alphaZ * val + betaZ * C[cOffset];
-      else
-        C[cOffset] = alphaZ * val;
-    }
-  };
+  // strides are passed as is, so views and 'f'-ordered arrays don't need to be duplicated
+  sd::blas::PackedGEMM<T1, T2, T3>::op(vC->sizeAt(cMaxis), vC->sizeAt(cNaxis), vA->sizeAt(aKaxis), alpha,
+                                       vA->bufferAsT<T1>(), vA->strideAt(aMaxis), vA->strideAt(aKaxis),
+                                       vB->bufferAsT<T2>(), vB->strideAt(bKaxis), vB->strideAt(bNaxis), beta,
+                                       vC->bufferAsT<T3>(), vC->strideAt(cMaxis), vC->strideAt(cNaxis));
+}
 
-  samediff::Threads::parallel_tad(func, 0, cLen);
+//////////////////////////////////////////////////////////////////////////////
+// int8 x int8 -> int8 or int32, runs on the byte dot-product kernels with int32 accumulation
+template <typename T3>
+static void int8MmulMxM(const NDArray* vA, const NDArray* vB, NDArray* vC, const double alpha, const double beta) {
+  // same integer alpha/beta semantics as PackedGEMM for integer types
+  const int32_t alphaAcc = static_cast<int32_t>(alpha);
+  const int32_t betaAcc = static_cast<int32_t>(beta);
+  const bool betaPresent = beta != 0.0;
+  T3* C = vC->bufferAsT<T3>();
+  const sd::LongType cRowStride = vC->strideAt(0);
+  const sd::LongType cColStride = vC->strideAt(1);
+
+  sd::blas::int8Gemm<int8_t>(vC->sizeAt(0), vC->sizeAt(1), vA->sizeAt(1), vA->bufferAsT<int8_t>(), vA->strideAt(0),
+                             vA->strideAt(1), 0, vB->bufferAsT<int8_t>(), vB->strideAt(0), vB->strideAt(1), nullptr,
+                             [&](const sd::LongType r, const sd::LongType c, const sd::LongType count,
+                                 const int32_t* acc) {
+                               T3* cRow = C + r * cRowStride + c * cColStride;
+                               for (sd::LongType j = 0; j < count; j++) {
+                                 int32_t v = alphaAcc * acc[j];
+                                 if (betaPresent) v += betaAcc * static_cast<int32_t>(cRow[j * cColStride]);
+                                 cRow[j * cColStride] = static_cast<T3>(v);
+                               }
+                             });
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -174,7 +149,10 @@ NDArray* MmulHelper::mmulMxM(const NDArray* A, const NDArray* B, NDArray* C, con
   if (A->dataType() != B->dataType())
     throw datatype_exception::build("mmulMxM expects all data types to be the same", A->dataType(), B->dataType());
 
-  if (C != nullptr && A->dataType() != C->dataType()) {
+  // int8 products may be kept in full int32 precision
+  const bool int8Product = A->dataType() == DataType::INT8 && C != nullptr && C->dataType() == DataType::INT32;
+
+  if (C != nullptr && A->dataType() != C->dataType() && !int8Product) {
     std::string errorMessage;
     errorMessage = "mmulMxM expects all data types to be the same";
     errorMessage += "A: " + DataTypeUtils::asString(A->dataType());
@@ -212,7 +190,12 @@ NDArray* MmulHelper::mmulMxM(const NDArray* A, const NDArray* B, NDArray* C, con
   const bool typeDouble = hasGemm && ABC && aType == DataType::DOUBLE;
   const bool typeFloat = hasGemm && ABC && aType == DataType::FLOAT32;
 
-  if (!typeFloat && !typeDouble) {
+  if (aType == DataType::INT8 && bType == DataType::INT8) {
+    if (cType == DataType::INT32)
+      int8MmulMxM<int32_t>(A, B, C, alpha, beta);
+    else
+      int8MmulMxM<int8_t>(A, B, C, alpha, beta);
+  } else if (!typeFloat && !typeDouble) {
     BUILD_SINGLE_SELECTOR_THRICE(aType, usualGemm, (A, B, C, 0, 1, 0, 1, 0, 1, alpha, beta), SD_NUMERIC_TYPES);
   } else {
     std::vector<NDArray*> toDelete;
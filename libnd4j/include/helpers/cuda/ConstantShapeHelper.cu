@@ -35,11 +35,8 @@ namespace sd {
 ConstantShapeHelper::ConstantShapeHelper() {
   auto numDevices = AffinityManager::numberOfDevices();
 
-  _cache.resize(numDevices);
-  for (int e = 0; e < numDevices; e++) {
-    SD_MAP_IMPL<ShapeDescriptor, ConstantShapeBuffer *> cache;
-    _cache[e] = cache;
-  }
+  for (int e = 0; e < numDevices; e++)
+    _cache.emplace_back(new ConcurrentLookupTable<ShapeDescriptor, ConstantShapeBuffer>());
 }
 
 ConstantShapeHelper& ConstantShapeHelper::getInstance() {
@@ -49,14 +46,17 @@ ConstantShapeHelper& ConstantShapeHelper::getInstance() {
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(sd::DataType dataType, char order,
                                                              const std::vector<sd::LongType>& shape) {
-  ShapeDescriptor *descriptor = new ShapeDescriptor(dataType, order, shape);
-  auto ret = bufferForShapeInfo(descriptor);
-  delete descriptor;
-  return ret;
+  return bufferForShapeInfo(dataType, order, static_cast<int>(shape.size()), shape.data());
 }
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::DataType dataType, const char order,
                                                              const int rank, const sd::LongType* shape) {
+  // hits are resolved against raw shape, descriptor is built only for a new entry
+  auto existing = _cache[AffinityManager::currentDeviceId()]->find(
+      ShapeDescriptor::hashShape(dataType, order, shape, rank),
+      [&](const ShapeDescriptor& d) { return d.equalsShape(dataType, order, shape, rank); });
+  if (existing != nullptr) return existing;
+
   ShapeDescriptor *descriptor = new ShapeDescriptor(dataType, order, shape, rank);
   auto ret = bufferForShapeInfo(descriptor);
   delete descriptor;
@@ -66,24 +66,25 @@ ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::DataType
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(ShapeDescriptor *descriptor) {
   int deviceId = AffinityManager::currentDeviceId();
 
-  std::lock_guard<std::mutex> lock(_mutex);
-
-  if (_cache[deviceId].count(*descriptor) == 0) {
+  return _cache[deviceId]->getOrCreate(*descriptor, [descriptor]() {
     auto hPtr =
         std::make_shared<PointerWrapper>(descriptor->toShapeInfo(), std::make_shared<PrimaryPointerDeallocator>());
     auto dPtr = std::make_shared<PointerWrapper>(
         ConstantHelper::getInstance().replicatePointer(hPtr->pointer(),
                                                        shape::shapeInfoByteLength(hPtr->pointerAsT<sd::LongType>())),
         std::make_shared<CudaPointerDeallocator>());
-    ConstantShapeBuffer *buffer = new ConstantShapeBuffer(hPtr, dPtr);
-    _cache[deviceId][*descriptor] = buffer;
-    return _cache[deviceId][*descriptor];
-  } else {
-    return _cache[deviceId].at(*descriptor);
-  }
+    return new ConstantShapeBuffer(hPtr, dPtr);
+  });
 }
 
 ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::LongType* shapeInfo) {
+  if (shapeInfo != nullptr && shape::rank(shapeInfo) >= 0 && shape::rank(shapeInfo) <= SD_MAX_RANK) {
+    auto existing = _cache[AffinityManager::currentDeviceId()]->find(
+        ShapeDescriptor::hashShapeInfo(shapeInfo),
+        [shapeInfo](const ShapeDescriptor& d) { return d.equalsShapeInfo(shapeInfo); });
+    if (existing != nullptr) return existing;
+  }
+
   ShapeDescriptor *descriptor = new ShapeDescriptor(shapeInfo);
   auto ret = bufferForShapeInfo(descriptor);
   delete descriptor;
@@ -92,9 +93,8 @@ ConstantShapeBuffer* ConstantShapeHelper::bufferForShapeInfo(const sd::LongType*
 
 bool ConstantShapeHelper::checkBufferExistenceForShapeInfo(ShapeDescriptor *descriptor) {
   auto deviceId = AffinityManager::currentDeviceId();
-  std::lock_guard<std::mutex> lock(_mutex);
 
-  return _cache[deviceId].count(*descriptor) != 0;
+  return _cache[deviceId]->contains(*descriptor);
 }
 
 const sd::LongType * ConstantShapeHelper::createShapeInfo(const sd::DataType dataType, const char order, const int rank,
@@ -35,8 +35,7 @@ ConstantTadHelper::ConstantTadHelper() {
   auto numDevices = AffinityManager::numberOfDevices();
 
   for (int e = 0; e < numDevices; e++) {
-    SD_MAP_IMPL<TadDescriptor *, TadPack *> pack;
-    _cache.emplace_back(pack);
+    _cache.emplace_back(new ConcurrentLookupTable<TadDescriptor, TadPack>());
   }
 }
 
@@ -57,67 +56,65 @@ TadPack * ConstantTadHelper::tadForDimensions(const sd::LongType *originalShape,
 
 TadPack * ConstantTadHelper::tadForDimensions(const sd::LongType *originalShape, LongType *dimensions, LongType dimLength,
                                               const bool keepUnitiesInShape) {
-  TadDescriptor *tadDescriptor = new TadDescriptor(originalShape, dimensions, dimLength, keepUnitiesInShape);
+  TadDescriptor tadDescriptor(originalShape, dimensions, dimLength, keepUnitiesInShape);
   return tadForDimensions(tadDescriptor);
 }
 
 TadPack * ConstantTadHelper::tadForDimensions(ShapeDescriptor &descriptor, std::vector<LongType> &dimensions,
                                               const bool keepUnitiesInShape) {
-  TadDescriptor *tadDescriptor = new TadDescriptor(descriptor, dimensions, keepUnitiesInShape);
+  TadDescriptor tadDescriptor(descriptor, dimensions, keepUnitiesInShape);
   return tadForDimensions(tadDescriptor);
 }
 
 TadPack * ConstantTadHelper::tadForDimensions(TadDescriptor *descriptor) {
-  const int deviceId = AffinityManager::currentDeviceId();
+  if (descriptor == nullptr) THROW_EXCEPTION("ConstantTadHelper::tadForDimensions: descriptor is nullptr!");
 
-  std::lock_guard<std::mutex> lock(_mutex);
+  return tadForDimensions(*descriptor);
+}
 
-  if (_cache[deviceId].count(descriptor) == 0) {
-    const auto shapeInfo = descriptor->originalShape().toShapeInfo();
-    const sd::LongType rank = shape::rank(shapeInfo);
-    auto descAxis = descriptor->axis();
-    const std::vector<sd::LongType > *dimsToExclude = ShapeUtils::evalDimsToExclude(rank,descAxis.size(), descAxis.data());
-    const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(shapeInfo, *dimsToExclude);
-    const sd::LongType subArrRank =
-        (rank == dimsToExclude->size() || descriptor->areUnitiesinShape()) ? rank : rank - dimsToExclude->size();
+TadPack * ConstantTadHelper::tadForDimensions(TadDescriptor &descriptor) {
+  const int deviceId = AffinityManager::currentDeviceId();
 
-    auto sPtr = std::make_shared<PointerWrapper>(new sd::LongType[shape::shapeInfoLength(subArrRank)],
-                                                 std::make_shared<PrimaryPointerDeallocator>());
-    auto oPtr =
-        std::make_shared<PointerWrapper>(new sd::LongType[numOfSubArrs], std::make_shared<PrimaryPointerDeallocator>());
+  return _cache[deviceId]->getOrCreate(descriptor, [&]() { return buildTadPack(descriptor); });
+}
 
-    if (numOfSubArrs > 0)
-      shape::calcSubArrsShapeInfoAndOffsets(shapeInfo, numOfSubArrs, dimsToExclude->size(), dimsToExclude->data(),
-                                            sPtr->pointerAsT<sd::LongType>(), oPtr->pointerAsT<sd::LongType>(),
-                                            descriptor->areUnitiesinShape());
+TadPack * ConstantTadHelper::buildTadPack(TadDescriptor &descriptor) {
+  const auto shapeInfo = descriptor.originalShape().toShapeInfo();
+  const sd::LongType rank = shape::rank(shapeInfo);
+  auto &descAxis = descriptor.axis();
+  const std::vector<sd::LongType > *dimsToExclude = ShapeUtils::evalDimsToExclude(rank,descAxis.size(), descAxis.data());
+  const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(shapeInfo, *dimsToExclude);
+  const sd::LongType subArrRank =
+      (rank == dimsToExclude->size() || descriptor.areUnitiesinShape()) ? rank : rank - dimsToExclude->size();
 
-    sd::Pointer soPtr;
-    auto res = cudaMalloc(reinterpret_cast<void **>(&soPtr), numOfSubArrs * sizeof(sd::LongType));
-    if (res != 0) throw cuda_exception::build("Memory allocation for tadOffsets failed", res);
+  auto sPtr = std::make_shared<PointerWrapper>(new sd::LongType[shape::shapeInfoLength(subArrRank)],
+                                               std::make_shared<PrimaryPointerDeallocator>());
+  auto oPtr =
+      std::make_shared<PointerWrapper>(new sd::LongType[numOfSubArrs], std::make_shared<PrimaryPointerDeallocator>());
 
-    res = cudaMemcpy(soPtr, oPtr->pointer(), numOfSubArrs * sizeof(sd::LongType), cudaMemcpyHostToDevice);
-    if (res != 0) throw cuda_exception::build("tadOffsets copy failed", res);
+  if (numOfSubArrs > 0)
+    shape::calcSubArrsShapeInfoAndOffsets(shapeInfo, numOfSubArrs, dimsToExclude->size(), dimsToExclude->data(),
+                                          sPtr->pointerAsT<sd::LongType>(), oPtr->pointerAsT<sd::LongType>(),
+                                          descriptor.areUnitiesinShape());
 
-    // TODO: add deallocator here?
-    auto ssPtr = std::make_shared<PointerWrapper>(
-        ConstantHelper::getInstance().replicatePointer(sPtr->pointer(), shape::shapeInfoByteLength(subArrRank)));
+  sd::Pointer soPtr;
+  auto res = cudaMalloc(reinterpret_cast<void **>(&soPtr), numOfSubArrs * sizeof(sd::LongType));
+  if (res != 0) throw cuda_exception::build("Memory allocation for tadOffsets failed", res);
 
-    ConstantShapeBuffer shapesBuffer(sPtr, ssPtr);
-    ConstantOffsetsBuffer offsetsBuffer(
-        oPtr, std::make_shared<PointerWrapper>(soPtr, std::make_shared<CudaPointerDeallocator>()));
+  res = cudaMemcpy(soPtr, oPtr->pointer(), numOfSubArrs * sizeof(sd::LongType), cudaMemcpyHostToDevice);
+  if (res != 0) throw cuda_exception::build("tadOffsets copy failed", res);
 
-    TadPack *t = new TadPack(shapesBuffer, offsetsBuffer, numOfSubArrs);
-    _cache[deviceId][descriptor] = t;
+  // TODO: add deallocator here?
+  auto ssPtr = std::make_shared<PointerWrapper>(
+      ConstantHelper::getInstance().replicatePointer(sPtr->pointer(), shape::shapeInfoByteLength(subArrRank)));
 
-    TadPack *r = _cache[deviceId][descriptor];
-    delete dimsToExclude;
-    delete[] shapeInfo;
+  ConstantShapeBuffer shapesBuffer(sPtr, ssPtr);
+  ConstantOffsetsBuffer offsetsBuffer(
+      oPtr, std::make_shared<PointerWrapper>(soPtr, std::make_shared<CudaPointerDeallocator>()));
 
-    return r;
-  } else {
-    TadPack *r = _cache[deviceId][descriptor];
+  delete dimsToExclude;
+  delete[] shapeInfo;
 
-    return r;
-  }
+  return new TadPack(shapesBuffer, offsetsBuffer, numOfSubArrs);
 }
 }  // namespace sd
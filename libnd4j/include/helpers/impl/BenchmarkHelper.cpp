@@ -0,0 +1,308 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <helpers/BenchmarkHelper.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <set>
+
+namespace sd {
+BenchmarkHelper::BenchmarkHelper(unsigned int warmUpIterations, unsigned int runIterations, BenchmarkReport *report)
+    : _wIterations(warmUpIterations), _rIterations(runIterations), _report(report) {
+  if (_rIterations < 1) THROW_EXCEPTION("BenchmarkHelper: number of timed iterations should be positive");
+}
+
+void BenchmarkHelper::setReport(BenchmarkReport *report) { _report = report; }
+
+std::string BenchmarkHelper::printHeader(const char *message) {
+  std::string result;
+  if (message != nullptr) result += std::string("\n") + message + "\n";
+
+  result +=
+      "TestName\tParameters\tdType\tOrders\tShape\tStrides\tAxis\tInplace\tMedian (us)\tp99 (us)\tGFLOP/s\tGB/s\n";
+  return result;
+}
+
+std::string BenchmarkHelper::benchmarkOperation(OpBenchmark &benchmark, const Parameters &parameters,
+                                                const std::string &suite) {
+  for (unsigned int i = 0; i < _wIterations; i++) benchmark.executeOnce();
+
+  std::vector<double> timings(_rIterations);
+  for (unsigned int i = 0; i < _rIterations; i++) {
+    auto timeStart = std::chrono::steady_clock::now();
+    benchmark.executeOnce();
+    auto timeEnd = std::chrono::steady_clock::now();
+
+    timings[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - timeStart).count());
+  }
+
+  double sum = 0.0;
+  for (auto t : timings) sum += t;
+  const double mean = sum / _rIterations;
+
+  double variance = 0.0;
+  for (auto t : timings) variance += (t - mean) * (t - mean);
+
+  BenchmarkResult result;
+  result.suite = suite;
+  result.testName = benchmark.testName();
+  result.parameters = parameters.asString();
+  result.dataType = benchmark.dataType();
+  result.orders = benchmark.orders();
+  result.shape = benchmark.shape();
+  result.strides = benchmark.strides();
+  result.axis = benchmark.axis();
+  result.inplace = benchmark.inplace();
+  result.extra = benchmark.extra();
+  result.iterations = _rIterations;
+  result.meanNs = mean;
+  result.stdDevNs = std::sqrt(variance / _rIterations);
+  result.medianNs = BenchmarkReport::percentile(timings, 50.0);
+  result.p99Ns = BenchmarkReport::percentile(timings, 99.0);
+  result.minNs = timings.front();
+  result.maxNs = timings.back();
+  result.flops = benchmark.flops();
+  result.bytes = benchmark.bytes();
+
+  if (_report != nullptr) _report->add(result);
+
+  char numbers[128];
+  snprintf(numbers, sizeof(numbers), "%.3f\t%.3f\t%.3f\t%.3f", result.medianNs / 1000.0, result.p99Ns / 1000.0,
+           result.gflops(), result.bytesPerSecond() / 1e9);
+
+  return result.testName + "\t" + result.parameters + "\t" + result.dataType + "\t" + result.orders + "\t" +
+         result.shape + "\t" + result.strides + "\t" + result.axis + "\t" + result.inplace + "\t" + numbers + "\n";
+}
+
+std::string BenchmarkHelper::runOperationSuit(std::initializer_list<OpBenchmark *> benchmarks, const char *message) {
+  std::vector<OpBenchmark *> ops(benchmarks);
+  return runOperationSuit(ops, message);
+}
+
+std::string BenchmarkHelper::runOperationSuit(std::vector<OpBenchmark *> &benchmarks, const char *message) {
+  std::string suite(message != nullptr ? message : "");
+  std::string result(printHeader(message));
+
+  Parameters empty;
+  for (auto v : benchmarks) result += benchmarkOperation(*v, empty, suite);
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(OpBenchmark *op, const char *message) {
+  return runOperationSuit({op}, message);
+}
+
+std::string BenchmarkHelper::runGenerated(OpBenchmark *op, const Parameters &parameters, ResultSet &x, ResultSet *y,
+                                          ResultSet &z, const std::string &suite) {
+  if (x.size() != z.size() || (y != nullptr && y->size() != x.size()))
+    THROW_EXCEPTION("BenchmarkHelper: generator should produce equal number of X, Y and Z arrays");
+
+  std::string result;
+  for (int e = 0; e < x.size(); e++) {
+    std::unique_ptr<OpBenchmark> clone(op->clone());
+    clone->setX(x.at(e));
+    if (y != nullptr) clone->setY(y->at(e));
+    clone->setZ(z.at(e));
+
+    result += benchmarkOperation(*clone, parameters, suite);
+  }
+
+  // generators may reuse single array as several operands (i.e. in-place runs), so each one is released only once
+  std::set<NDArray *> arrays;
+  for (int e = 0; e < x.size(); e++) {
+    arrays.insert(x.at(e));
+    if (y != nullptr) arrays.insert(y->at(e));
+    arrays.insert(z.at(e));
+  }
+
+  for (auto array : arrays) delete array;
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(ScalarBenchmark *op,
+                                              const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                                              ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, z;
+    x.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, z);
+
+    result += runGenerated(op, p, x, nullptr, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(TransformBenchmark *op,
+                                              const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                                              ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, z;
+    x.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, z);
+
+    result += runGenerated(op, p, x, nullptr, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(ReductionBenchmark *op,
+                                              const std::function<void(Parameters &, ResultSet &, ResultSet &)> &func,
+                                              ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, z;
+    x.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, z);
+
+    result += runGenerated(op, p, x, nullptr, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(
+    ReductionBenchmark *op, const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+    ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, y, z;
+    x.setNonRemovable();
+    y.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, y, z);
+
+    // reduction axis is taken from Y, so it has to be in place before cloning
+    if (x.size() != y.size() || x.size() != z.size())
+      THROW_EXCEPTION("BenchmarkHelper: generator should produce equal number of X, Y and Z arrays");
+
+    for (int e = 0; e < x.size(); e++) {
+      ReductionBenchmark clone((reduce::SameOps)op->opNum(), op->testName(), x.at(e), y.at(e), z.at(e));
+      result += benchmarkOperation(clone, p, suite);
+    }
+
+    std::set<NDArray *> arrays;
+    for (int e = 0; e < x.size(); e++) {
+      arrays.insert(x.at(e));
+      arrays.insert(y.at(e));
+      arrays.insert(z.at(e));
+    }
+
+    for (auto array : arrays) delete array;
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(
+    BroadcastBenchmark *op, const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+    ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, y, z;
+    x.setNonRemovable();
+    y.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, y, z);
+
+    result += runGenerated(op, p, x, &y, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(
+    PairwiseBenchmark *op, const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+    ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, y, z;
+    x.setNonRemovable();
+    y.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, y, z);
+
+    result += runGenerated(op, p, x, &y, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(
+    MatrixBenchmark *op, const std::function<void(Parameters &, ResultSet &, ResultSet &, ResultSet &)> &func,
+    ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    ResultSet x, y, z;
+    x.setNonRemovable();
+    y.setNonRemovable();
+    z.setNonRemovable();
+    func(p, x, y, z);
+
+    result += runGenerated(op, p, x, &y, z, suite);
+  }
+
+  return result;
+}
+
+std::string BenchmarkHelper::runOperationSuit(DeclarableBenchmark *op,
+                                              const std::function<Context *(Parameters &)> &func,
+                                              ParametersBatch &parametersBatch, const char *message) {
+  std::string suite(message != nullptr ? message : op->testName());
+  std::string result(printHeader(message));
+
+  for (auto &p : parametersBatch.parameters()) {
+    // context owns arrays marked as removable by generator
+    std::unique_ptr<Context> ctx(func(p));
+    std::unique_ptr<OpBenchmark> clone(op->clone());
+    static_cast<DeclarableBenchmark *>(clone.get())->setContext(ctx.get());
+
+    result += benchmarkOperation(*clone, p, suite);
+  }
+
+  return result;
+}
+}  // namespace sd
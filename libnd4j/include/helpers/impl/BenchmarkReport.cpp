@@ -0,0 +1,144 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Machine-readable benchmark results
+//
+#include <helpers/benchmark/BenchmarkReport.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace sd {
+double BenchmarkResult::gflops() const { return medianNs > 0.0 ? flops / medianNs : 0.0; }
+
+double BenchmarkResult::bytesPerSecond() const { return medianNs > 0.0 ? bytes * 1e9 / medianNs : 0.0; }
+
+void BenchmarkReport::add(const BenchmarkResult &result) { _results.push_back(result); }
+
+const std::vector<BenchmarkResult> &BenchmarkReport::results() const { return _results; }
+
+size_t BenchmarkReport::size() const { return _results.size(); }
+
+void BenchmarkReport::clear() { _results.clear(); }
+
+double BenchmarkReport::percentile(std::vector<double> &timings, double p) {
+  if (timings.empty()) return 0.0;
+
+  std::sort(timings.begin(), timings.end());
+  auto rank = static_cast<size_t>(std::ceil(p / 100.0 * timings.size()));
+  if (rank > 0) rank--;
+
+  return timings[std::min(rank, timings.size() - 1)];
+}
+
+static std::string jsonString(const std::string &value) {
+  std::string result("\"");
+  for (auto c : value) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          result += buffer;
+        } else {
+          result += c;
+        }
+    }
+  }
+  return result + "\"";
+}
+
+static std::string csvString(const std::string &value) {
+  if (value.find_first_of(",\"\n") == std::string::npos) return value;
+
+  std::string result("\"");
+  for (auto c : value) {
+    if (c == '"') result += '"';
+    result += c;
+  }
+  return result + "\"";
+}
+
+static std::string number(double value) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.6g", std::isfinite(value) ? value : 0.0);
+  return buffer;
+}
+
+std::string BenchmarkReport::asJson() const {
+  std::string result("[\n");
+  for (size_t e = 0; e < _results.size(); e++) {
+    const auto &r = _results[e];
+    result += "  {";
+    result += "\"suite\": " + jsonString(r.suite);
+    result += ", \"name\": " + jsonString(r.testName);
+    result += ", \"parameters\": " + jsonString(r.parameters);
+    result += ", \"dtype\": " + jsonString(r.dataType);
+    result += ", \"orders\": " + jsonString(r.orders);
+    result += ", \"shape\": " + jsonString(r.shape);
+    result += ", \"strides\": " + jsonString(r.strides);
+    result += ", \"axis\": " + jsonString(r.axis);
+    result += ", \"inplace\": " + jsonString(r.inplace);
+    result += ", \"extra\": " + jsonString(r.extra);
+    result += ", \"iterations\": " + std::to_string(r.iterations);
+    result += ", \"min_ns\": " + number(r.minNs);
+    result += ", \"median_ns\": " + number(r.medianNs);
+    result += ", \"p99_ns\": " + number(r.p99Ns);
+    result += ", \"max_ns\": " + number(r.maxNs);
+    result += ", \"mean_ns\": " + number(r.meanNs);
+    result += ", \"stddev_ns\": " + number(r.stdDevNs);
+    result += ", \"flops\": " + number(r.flops);
+    result += ", \"bytes\": " + number(r.bytes);
+    result += ", \"gflops\": " + number(r.gflops());
+    result += ", \"bytes_per_second\": " + number(r.bytesPerSecond());
+    result += e + 1 < _results.size() ? "},\n" : "}\n";
+  }
+  return result + "]\n";
+}
+
+std::string BenchmarkReport::asCsv() const {
+  std::string result(
+      "suite,name,parameters,dtype,orders,shape,strides,axis,inplace,extra,iterations,min_ns,median_ns,p99_ns,max_ns,"
+      "mean_ns,stddev_ns,flops,bytes,gflops,bytes_per_second\n");
+
+  for (const auto &r : _results) {
+    result += csvString(r.suite) + "," + csvString(r.testName) + "," + csvString(r.parameters) + "," +
+              csvString(r.dataType) + "," + csvString(r.orders) + "," + csvString(r.shape) + "," +
+              csvString(r.strides) + "," + csvString(r.axis) + "," + csvString(r.inplace) + "," +
+              csvString(r.extra) + "," + std::to_string(r.iterations) + "," + number(r.minNs) + "," +
+              number(r.medianNs) + "," + number(r.p99Ns) + "," + number(r.maxNs) + "," + number(r.meanNs) + "," +
+              number(r.stdDevNs) + "," + number(r.flops) + "," + number(r.bytes) + "," + number(r.gflops()) + "," +
+              number(r.bytesPerSecond()) + "\n";
+  }
+  return result;
+}
+}  // namespace sd
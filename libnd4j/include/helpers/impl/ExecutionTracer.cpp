@@ -0,0 +1,470 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Per-thread trace rings and trace exporters
+//
+#include <helpers/ExecutionTracer.h>
+#include <helpers/shape.h>
+#include <system/op_boilerplate.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define SD_TRACE_TSC
+#endif
+
+#if defined(SD_GCC_FUNCTRACE)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#endif
+
+namespace sd {
+
+// Events are written by the owning thread only. Readers copy slots without synchronization and then drop whatever
+// might have been overwritten meanwhile, so a snapshot never blocks the writer.
+class TraceRing {
+ public:
+  static const int kMaxDepth = 256;
+
+  std::unique_ptr<TraceEvent[]> events;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<bool> owned{true};
+  const uint32_t index;
+
+  // sampling counter and open function calls, touched by the owning thread only
+  uint64_t counter = 0;
+  int depth = 0;
+  uint64_t starts[kMaxDepth];
+
+  explicit TraceRing(const uint32_t idx) : events(new TraceEvent[ExecutionTracer::kRingCapacity]), index(idx) {}
+
+  void push(const TraceEvent &event) {
+    const auto h = head.load(std::memory_order_relaxed);
+    events[h & (ExecutionTracer::kRingCapacity - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  void snapshot(std::vector<TraceEvent> &target) {
+    const auto h = head.load(std::memory_order_acquire);
+    const auto first = std::max(tail.load(std::memory_order_relaxed),
+                                h > ExecutionTracer::kRingCapacity ? h - ExecutionTracer::kRingCapacity : 0);
+
+    std::vector<TraceEvent> copy;
+    copy.reserve(h - first);
+    for (auto e = first; e < h; e++) copy.emplace_back(events[e & (ExecutionTracer::kRingCapacity - 1)]);
+
+    // slots below this one could have been reused while we were copying, including the one an in-flight push() of
+    // event number `after` is writing right now. The fence keeps the slot reads above from moving past the reload
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto after = head.load(std::memory_order_relaxed);
+    const auto valid = after >= ExecutionTracer::kRingCapacity ? after - ExecutionTracer::kRingCapacity + 1 : 0;
+    for (auto e = std::max(first, valid); e < h; e++) target.emplace_back(copy[e - first]);
+  }
+};
+
+// ring is handed back to the tracer when its thread exits, next new thread picks it up with all its events
+struct TraceRingHolder {
+  TraceRing *ring = nullptr;
+
+  ~TraceRingHolder() {
+    if (ring != nullptr) ring->owned.store(false, std::memory_order_release);
+  }
+};
+
+#if defined(SD_IOS_BUILD) || defined(SD_APPLE_BUILD) || defined(SD_ANDROID_BUILD) || defined(__NEC__)
+// no reliable thread_local on these targets, nothing gets recorded
+#define SD_TRACE_DISABLED
+#else
+static thread_local TraceRingHolder traceRingHolder;
+static thread_local sd::LongType traceAllocatedBytes = 0;
+#endif
+
+static int64_t steadyNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t ExecutionTracer::ticks() {
+#if defined(SD_TRACE_TSC)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(steadyNanos());
+#endif
+}
+
+ExecutionTracer::ExecutionTracer() : _names(10) {
+  _epochTicks = ticks();
+  _epochNanos = steadyNanos();
+}
+
+// TSC rate is measured over the whole lifetime of the tracer, so nothing spins upfront. Measurements over short
+// intervals aren't kept unless forced, export forces one over the longest interval available
+double ExecutionTracer::calibrate(bool force) const {
+#if defined(SD_TRACE_TSC)
+  const auto elapsed = steadyNanos() - _epochNanos;
+  const auto elapsedTicks = ticks() - _epochTicks;
+  auto rate = elapsed > 0 ? static_cast<double>(elapsedTicks) / static_cast<double>(elapsed) : 1.;
+  if (rate <= 0.) rate = 1.;
+
+  if (force || elapsed >= 10000000) _ticksPerNanosecond.store(rate, std::memory_order_relaxed);
+
+  return rate;
+#else
+  _ticksPerNanosecond.store(1., std::memory_order_relaxed);
+  return 1.;
+#endif
+}
+
+ExecutionTracer &ExecutionTracer::getInstance() {
+  // never destroyed: rings can be touched by threads that outlive static destructors
+  static ExecutionTracer *instance = new ExecutionTracer();
+  return *instance;
+}
+
+uint64_t ExecutionTracer::nanoseconds(uint64_t ticks) const {
+  auto rate = _ticksPerNanosecond.load(std::memory_order_relaxed);
+  if (rate == 0.) rate = calibrate(false);
+
+  return static_cast<uint64_t>(static_cast<double>(ticks) / rate);
+}
+
+void ExecutionTracer::countAllocation(sd::LongType bytes) {
+#if !defined(SD_TRACE_DISABLED)
+  traceAllocatedBytes += bytes;
+#endif
+}
+
+sd::LongType ExecutionTracer::allocatedBytes() {
+#if defined(SD_TRACE_DISABLED)
+  return 0;
+#else
+  return traceAllocatedBytes;
+#endif
+}
+
+uint64_t ExecutionTracer::hashShape(uint64_t seed, const sd::LongType *shapeInfo) {
+  if (shapeInfo == nullptr) return seed;
+
+  // FNV-1a over rank, shape, strides and flags
+  const auto length = shape::shapeInfoLength(shapeInfo);
+  for (sd::LongType e = 0; e < length; e++) {
+    seed ^= static_cast<uint64_t>(shapeInfo[e]);
+    seed *= 1099511628211ULL;
+  }
+
+  return seed;
+}
+
+TraceRing *ExecutionTracer::ring() {
+#if defined(SD_TRACE_DISABLED)
+  return nullptr;
+#else
+  if (traceRingHolder.ring != nullptr) return traceRingHolder.ring;
+
+  std::lock_guard<std::mutex> lock(_lock);
+  for (auto r : _rings) {
+    bool expected = false;
+    if (!r->owned.load(std::memory_order_acquire) &&
+        r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      traceRingHolder.ring = r;
+      return r;
+    }
+  }
+
+  auto r = new TraceRing(static_cast<uint32_t>(_rings.size()));
+  _rings.emplace_back(r);
+  traceRingHolder.ring = r;
+  return r;
+#endif
+}
+
+bool ExecutionTracer::shouldRecord(uint64_t durationTicks) {
+  auto r = ring();
+  if (r == nullptr) return false;
+
+  const auto sampling = Environment::getInstance().traceSampling();
+  if (sampling <= 1 || ++r->counter % sampling == 0) return true;
+
+  const auto slowNanos = Environment::getInstance().traceSlowNanos();
+  return slowNanos > 0 && nanoseconds(durationTicks) >= static_cast<uint64_t>(slowNanos);
+}
+
+void ExecutionTracer::registerName(uint64_t nameHash, const std::string &name) {
+  _names.getOrCreate(nameHash, [&name]() { return new std::string(name); });
+}
+
+void ExecutionTracer::record(uint64_t nameHash, uint64_t shapeHash, uint64_t start, uint64_t end, int64_t bytes,
+                             Kind kind) {
+  auto r = ring();
+  if (r == nullptr) return;
+
+  r->push({nameHash, shapeHash, start, end, bytes, r->index, static_cast<uint32_t>(kind)});
+}
+
+void ExecutionTracer::functionEnter(void *function) {
+  auto r = ring();
+  if (r == nullptr) return;
+
+  if (r->depth < TraceRing::kMaxDepth) r->starts[r->depth] = ticks();
+  r->depth++;
+}
+
+void ExecutionTracer::functionExit(void *function) {
+  auto r = ring();
+  if (r == nullptr || r->depth == 0) return;
+
+  r->depth--;
+  if (r->depth >= TraceRing::kMaxDepth) return;
+
+  const auto start = r->starts[r->depth];
+  const auto end = ticks();
+  if (shouldRecord(end - start))
+    r->push({reinterpret_cast<uint64_t>(function), 0, start, end, 0, r->index, static_cast<uint32_t>(FUNCTION)});
+}
+
+std::vector<TraceEvent> ExecutionTracer::events() {
+  std::vector<TraceRing *> rings;
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+    rings = _rings;
+  }
+
+  std::vector<TraceEvent> result;
+  for (auto r : rings) {
+    const auto first = result.size();
+    r->snapshot(result);
+    std::sort(result.begin() + first, result.end(), [](const TraceEvent &a, const TraceEvent &b) {
+      return a.start < b.start || (a.start == b.start && a.end > b.end);
+    });
+  }
+
+  return result;
+}
+
+void ExecutionTracer::purge() {
+  std::lock_guard<std::mutex> lock(_lock);
+  for (auto r : _rings) r->tail.store(r->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+std::string ExecutionTracer::nameOf(const TraceEvent &event) const {
+  if (auto name = _names.get(event.nameHash)) return *name;
+
+  if (event.kind == FUNCTION) {
+#if defined(SD_GCC_FUNCTRACE)
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void *>(event.nameHash), &info) && info.dli_sname != nullptr) {
+      int status = 0;
+      char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, 0, &status);
+      std::string result(status == 0 && demangled != nullptr ? demangled : info.dli_sname);
+      free(demangled);
+      return result;
+    }
+#endif
+  }
+
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(event.nameHash));
+  return std::string(buffer);
+}
+
+static void appendJsonString(std::string &out, const std::string &value) {
+  out += '"';
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+      out += buffer;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+std::string ExecutionTracer::toChromeJson() {
+  const auto all = events();
+  calibrate(true);
+
+  std::string out("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  char buffer[256];
+  uint32_t lastThread = static_cast<uint32_t>(-1);
+  bool first = true;
+  for (const auto &e : all) {
+    if (!first) out += ",\n";
+    first = false;
+
+    if (e.threadId != lastThread) {
+      snprintf(buffer, sizeof(buffer),
+               "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}},\n",
+               e.threadId, e.threadId);
+      out += buffer;
+      lastThread = e.threadId;
+    }
+
+    // Chrome expects microseconds
+    const auto start = e.start > _epochTicks ? nanoseconds(e.start - _epochTicks) : 0;
+    const auto duration = nanoseconds(e.end - e.start);
+    out += "{\"name\":";
+    appendJsonString(out, nameOf(e));
+    snprintf(buffer, sizeof(buffer),
+             ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+             "\"args\":{\"shapes\":\"0x%llx\",\"bytes\":%lld}}",
+             e.kind == FUNCTION ? "function" : "op", e.threadId, start / 1000., duration / 1000.,
+             static_cast<unsigned long long>(e.shapeHash), static_cast<long long>(e.bytes));
+    out += buffer;
+  }
+  out += "]}\n";
+
+  return out;
+}
+
+// minimal protobuf writer for the few Perfetto messages we need
+static void appendVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+static void appendVarintField(std::string &out, const int field, const uint64_t value) {
+  appendVarint(out, static_cast<uint64_t>(field) << 3);
+  appendVarint(out, value);
+}
+
+static void appendBytesField(std::string &out, const int field, const std::string &value) {
+  appendVarint(out, (static_cast<uint64_t>(field) << 3) | 2);
+  appendVarint(out, value.size());
+  out += value;
+}
+
+std::string ExecutionTracer::toPerfetto() {
+  // perfetto.protos field numbers
+  const int kTracePacket = 1;
+  const int kPacketTimestamp = 8, kPacketSequenceId = 10, kPacketTrackEvent = 11, kPacketSequenceFlags = 13,
+            kPacketTrackDescriptor = 60;
+  const int kEventType = 9, kEventTrackUuid = 11, kEventName = 23, kEventDebugAnnotations = 4;
+  const int kTrackUuid = 1, kTrackName = 2, kTrackThread = 4;
+  const int kThreadPid = 1, kThreadTid = 2;
+  const int kAnnotationUint = 3, kAnnotationInt = 4, kAnnotationName = 10;
+  const int kSliceBegin = 1, kSliceEnd = 2;
+  const uint64_t kSequence = 1;
+
+  const auto all = events();
+  calibrate(true);
+  std::string out;
+  bool first = true;
+
+  auto emit = [&](std::string &packet) {
+    appendVarintField(packet, kPacketSequenceId, kSequence);
+    if (first) appendVarintField(packet, kPacketSequenceFlags, 1);  // SEQ_INCREMENTAL_STATE_CLEARED
+    first = false;
+    appendBytesField(out, kTracePacket, packet);
+  };
+
+  size_t begin = 0;
+  while (begin < all.size()) {
+    const auto thread = all[begin].threadId;
+    auto end = begin;
+    while (end < all.size() && all[end].threadId == thread) end++;
+
+    const uint64_t uuid = thread + 1;
+    std::string threadDescriptor, trackDescriptor, packet;
+    appendVarintField(threadDescriptor, kThreadPid, 1);
+    appendVarintField(threadDescriptor, kThreadTid, thread + 1);
+    appendVarintField(trackDescriptor, kTrackUuid, uuid);
+    appendBytesField(trackDescriptor, kTrackName, "thread " + std::to_string(thread));
+    appendBytesField(trackDescriptor, kTrackThread, threadDescriptor);
+    appendBytesField(packet, kPacketTrackDescriptor, trackDescriptor);
+    emit(packet);
+
+    // slices are sent as begin/end pairs, nested slices have to be properly ordered on their track
+    struct Edge {
+      uint64_t time;
+      int type;
+      uint64_t order;
+      size_t event;
+    };
+    std::vector<Edge> edges;
+    for (auto e = begin; e < end; e++) {
+      const auto start = all[e].start > _epochTicks ? nanoseconds(all[e].start - _epochTicks) : 0;
+      const auto stop = std::max<uint64_t>(start + 1, start + nanoseconds(all[e].end - all[e].start));
+      edges.push_back({start, kSliceBegin, ~stop, e});
+      edges.push_back({stop, kSliceEnd, ~start, e});
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+      if (a.time != b.time) return a.time < b.time;
+      if (a.type != b.type) return a.type == kSliceEnd;
+      return a.order < b.order;
+    });
+
+    for (const auto &edge : edges) {
+      std::string trackEvent;
+      appendVarintField(trackEvent, kEventType, edge.type);
+      appendVarintField(trackEvent, kEventTrackUuid, uuid);
+      if (edge.type == kSliceBegin) {
+        const auto &e = all[edge.event];
+        appendBytesField(trackEvent, kEventName, nameOf(e));
+
+        std::string shapes, bytes;
+        appendBytesField(shapes, kAnnotationName, "shapes");
+        appendVarintField(shapes, kAnnotationUint, e.shapeHash);
+        appendBytesField(trackEvent, kEventDebugAnnotations, shapes);
+        appendBytesField(bytes, kAnnotationName, "bytes");
+        appendVarintField(bytes, kAnnotationInt, static_cast<uint64_t>(e.bytes));
+        appendBytesField(trackEvent, kEventDebugAnnotations, bytes);
+      }
+
+      packet.clear();
+      appendVarintField(packet, kPacketTimestamp, edge.time);
+      appendBytesField(packet, kPacketTrackEvent, trackEvent);
+      emit(packet);
+    }
+
+    begin = end;
+  }
+
+  return out;
+}
+
+void ExecutionTracer::exportTrace(const std::string &path, Format format) {
+  const auto content = format == PERFETTO ? toPerfetto() : toChromeJson();
+
+  std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!stream.is_open()) THROW_EXCEPTION(("ExecutionTracer: can't open file for writing: " + path).c_str());
+
+  stream.write(content.data(), content.size());
+  if (!stream.good()) THROW_EXCEPTION(("ExecutionTracer: failed to write trace to " + path).c_str());
+}
+
+}  // namespace sd
@@ -0,0 +1,102 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Private file mapping for POSIX and Windows
+//
+#include <helpers/MmapFile.h>
+#include <system/op_boilerplate.h>
+
+#include <string>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sd {
+
+MmapFile::MmapFile(const char *fileName) {
+#if defined(_WIN32) || defined(_WIN64)
+  auto file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                          nullptr);
+  if (file == INVALID_HANDLE_VALUE) THROW_EXCEPTION(("MmapFile: unable to open file " + std::string(fileName)).c_str());
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    THROW_EXCEPTION("MmapFile: unable to get file size");
+  }
+
+  _file = file;
+  _length = static_cast<sd::LongType>(size.QuadPart);
+  if (_length == 0) return;
+
+  _mapping = CreateFileMapping(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (_mapping == nullptr) {
+    CloseHandle(file);
+    THROW_EXCEPTION("MmapFile: CreateFileMapping failed");
+  }
+
+  _data = reinterpret_cast<char *>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+  if (_data == nullptr) {
+    CloseHandle(_mapping);
+    CloseHandle(file);
+    THROW_EXCEPTION("MmapFile: MapViewOfFile failed");
+  }
+#else
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) THROW_EXCEPTION(("MmapFile: unable to open file " + std::string(fileName)).c_str());
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    THROW_EXCEPTION("MmapFile: unable to get file size");
+  }
+
+  _length = static_cast<sd::LongType>(st.st_size);
+  if (_length > 0) {
+    auto ptr = mmap(nullptr, static_cast<size_t>(_length), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      THROW_EXCEPTION("MmapFile: mmap failed");
+    }
+
+    _data = reinterpret_cast<char *>(ptr);
+  }
+
+  // mapping stays valid after descriptor is closed
+  close(fd);
+#endif
+}
+
+MmapFile::~MmapFile() {
+#if defined(_WIN32) || defined(_WIN64)
+  if (_data != nullptr) UnmapViewOfFile(_data);
+  if (_mapping != nullptr) CloseHandle(_mapping);
+  if (_file != nullptr) CloseHandle(_file);
+#else
+  if (_data != nullptr) munmap(_data, static_cast<size_t>(_length));
+#endif
+}
+
+}  // namespace sd
@@ -0,0 +1,120 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// @author raver119@gmail.com
+//
+#include <helpers/OpBenchmark.h>
+
+namespace sd {
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z)
+    : _testName(name), _x(x), _y(y), _z(z) {}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z) : _testName(name), _x(x), _z(z) {}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z, std::initializer_list<sd::LongType> axis)
+    : _testName(name), _x(x), _z(z), _axis(axis) {}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *z, std::vector<sd::LongType> axis)
+    : _testName(name), _x(x), _z(z), _axis(axis) {}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z,
+                         std::initializer_list<sd::LongType> axis)
+    : _testName(name), _x(x), _y(y), _z(z), _axis(axis) {}
+
+OpBenchmark::OpBenchmark(std::string name, NDArray *x, NDArray *y, NDArray *z, std::vector<sd::LongType> axis)
+    : _testName(name), _x(x), _y(y), _z(z), _axis(axis) {}
+
+void OpBenchmark::setOpNum(int opNum) { _opNum = opNum; }
+
+void OpBenchmark::setTestName(std::string name) { _testName = name; }
+
+void OpBenchmark::setX(NDArray *array) { _x = array; }
+
+void OpBenchmark::setY(NDArray *array) { _y = array; }
+
+void OpBenchmark::setZ(NDArray *array) { _z = array; }
+
+void OpBenchmark::setAxis(std::vector<sd::LongType> axis) { _axis = axis; }
+
+void OpBenchmark::setAxis(std::initializer_list<sd::LongType> axis) { _axis = axis; }
+
+NDArray &OpBenchmark::x() { return *_x; }
+
+int OpBenchmark::opNum() { return _opNum; }
+
+std::string OpBenchmark::testName() { return _testName; }
+
+std::vector<sd::LongType> OpBenchmark::getAxis() { return _axis; }
+
+std::string OpBenchmark::orderOf(NDArray *array) {
+  if (array == nullptr) return "";
+
+  return std::string(1, array->ordering());
+}
+
+std::string OpBenchmark::extra() { return "N/A"; }
+
+std::string OpBenchmark::dataType() {
+  return _x == nullptr ? std::string("N/A") : DataTypeUtils::asString(_x->dataType());
+}
+
+std::string OpBenchmark::axis() {
+  if (_axis.empty()) return "N/A";
+
+  std::string result("[");
+  for (size_t e = 0; e < _axis.size(); e++) {
+    if (e > 0) result += ", ";
+    result += std::to_string(_axis[e]);
+  }
+  return result + "]";
+}
+
+std::string OpBenchmark::orders() {
+  std::string result(orderOf(_x));
+  if (_y != nullptr) result += "/" + orderOf(_y);
+  if (_z != nullptr) result += "/" + orderOf(_z);
+  return result;
+}
+
+std::string OpBenchmark::strides() {
+  std::string result(ShapeUtils::strideAsString(_x));
+  if (_y != nullptr) result += "/" + ShapeUtils::strideAsString(_y);
+  if (_z != nullptr) result += "/" + ShapeUtils::strideAsString(_z);
+  return result;
+}
+
+std::string OpBenchmark::shape() { return _x == nullptr ? std::string("N/A") : ShapeUtils::shapeAsString(_x); }
+
+std::string OpBenchmark::inplace() {
+  if (_z == nullptr) return "N/A";
+
+  return (_x == _z || (_x != nullptr && _x->buffer() == _z->buffer())) ? "true" : "false";
+}
+
+double OpBenchmark::flops() { return _z == nullptr ? 0.0 : static_cast<double>(_z->lengthOf()); }
+
+double OpBenchmark::bytes() {
+  double result = 0.0;
+  for (auto array : {_x, _y, _z})
+    if (array != nullptr) result += static_cast<double>(array->lengthOf()) * array->sizeOfT();
+
+  // in-place runs still count x and z separately: the same buffer is read and then written
+  return result;
+}
+}  // namespace sd
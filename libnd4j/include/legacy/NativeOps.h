@@ -124,6 +124,24 @@ SD_LIB_EXPORT void purgeOpTrace();
 
 SD_LIB_EXPORT void toggleOpTrace(bool opTrace);
 
+/**
+ * Low-overhead execution tracing, see helpers/ExecutionTracer.h
+ * Events are kept in per-thread rings of fixed size, so tracing can stay on in production
+ */
+SD_LIB_EXPORT void toggleExecutionTrace(bool enabled);
+
+/**
+ * Records only every N-th op execution per thread, plus all executions slower than slowNanos (0 disables that)
+ */
+SD_LIB_EXPORT void setExecutionTraceSampling(int every, sd::LongType slowNanos);
+
+/**
+ * Writes recorded events to file: format 0 is Chrome trace JSON, 1 is Perfetto protobuf
+ */
+SD_LIB_EXPORT void exportExecutionTrace(const char *path, int format);
+
+SD_LIB_EXPORT void purgeExecutionTrace();
+
 SD_LIB_EXPORT void saveNpy(std::string fname, const OpaqueDataBuffer *data, const unsigned int *shape, const unsigned int ndims,
                            std::string mode = "w");
 
@@ -1527,6 +1545,11 @@ SD_LIB_EXPORT sd::Status registerGraph(sd::Pointer* extraPointers, sd::LongType
 typedef sd::graph::VariablesSet OpaqueVariablesSet;
 typedef sd::graph::Variable OpaqueVariable;
 
+/**
+ * Executes graph registered via registerGraph() with given inputs, using per-thread inference session.
+ * Input buffers are bound without copying. Returned variables are owned by the session and stay valid until next
+ * executeStoredGraph() call from the same thread; deleteVariablesSet() releases just the set itself.
+ */
 SD_LIB_EXPORT OpaqueVariablesSet* executeStoredGraph(sd::Pointer* extraPointers, sd::LongType graphId,
                                                      sd::Pointer* inputBuffers, sd::Pointer* inputShapes,
                                                      int* inputIndices, int numInputs);
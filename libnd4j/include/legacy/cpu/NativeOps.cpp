@@ -67,6 +67,7 @@ bool experimentalSupport = false;
 #include <graph/ResultWrapper.h>
 #include <helpers/ConstantTadHelper.h>
 #include <helpers/DebugHelper.h>
+#include <helpers/ExecutionTracer.h>
 #include <helpers/TAD.h>
 #include <ops/declarable/OpRegistrator.h>
 #include <ops/specials.h>
@@ -106,31 +107,20 @@ extern "C" {
 //we need to tell -finstrument-functions not to include the logger otherwise it will recursively
 // stack overflow and segfault.
 __attribute__((no_instrument_function)) SD_LIB_EXPORT  void writeLog(bool enter,void *this_fn,void *call_site) {
-  if(instrumentFile == nullptr) {
-    return;
-  }
-  Dl_info info;
-  if (dladdr(this_fn, &info)) {
-    int status;
-    const char *funcName;
-    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, 0, &status);
-    if (status == 0) {
-      funcName = demangled  != nullptr ? demangled : "null_demangled";
-    } else {
-      funcName = info.dli_sname ? info.dli_sname : "null_dli_sname";
-    }
+  // calls made from here, isEnabled() included, are instrumented as well, they must not be traced themselves,
+  // so the guard is raised before any of them
+  static thread_local bool inside = false;
+  if (inside) return;
+  inside = true;
 
-    printf(" %s %s (%s)\n",enter ? "enter" : "exit", funcName, info.dli_fname);
-    fprintf( instrumentFile," %s %s (%s)\n",enter ? "enter" : "exit", funcName, info.dli_fname);
-    if (demangled != nullptr) {
-      delete demangled;
-      demangled = nullptr;
-    }
-  } else {
-    printf("%s %s\n", enter ? "enter" : "exit","unknown");
-    fprintf(instrumentFile, "%s %s\n", enter ? "enter" : "exit","unknown");
-    fflush(instrumentFile);
+  // symbols are resolved only when the trace gets exported
+  if (instrumentFile != nullptr || sd::ExecutionTracer::isEnabled()) {
+    if (enter)
+      sd::ExecutionTracer::getInstance().functionEnter(this_fn);
+    else
+      sd::ExecutionTracer::getInstance().functionExit(this_fn);
   }
+  inside = false;
 }
 //we need to tell -finstrument-functions not to include the logger otherwise it will recursively
 // stack overflow and segfault.
@@ -170,8 +160,12 @@ void setInstrumentOut(char *instrumentOutPath) {
 //clears the file.
 
 void closeInstrumentOut() {
-  if(instrumentFile != nullptr)
+  if(instrumentFile != nullptr) {
+    auto trace = sd::ExecutionTracer::getInstance().toChromeJson();
+    fwrite(trace.data(), 1, trace.size(), instrumentFile);
     fclose(instrumentFile);
+    instrumentFile = nullptr;
+  }
 }
 
 #endif
@@ -333,6 +327,29 @@ void purgeOpTrace() {
   sd::ops::OpRegistrator::getInstance().purgeOpExecs();
 }
 
+void toggleExecutionTrace(bool enabled) {
+  sd::Environment::getInstance().setTracing(enabled);
+}
+
+void setExecutionTraceSampling(int every, sd::LongType slowNanos) {
+  sd::Environment::getInstance().setTraceSampling(every);
+  sd::Environment::getInstance().setTraceSlowNanos(slowNanos);
+}
+
+void exportExecutionTrace(const char *path, int format) {
+  try {
+    sd::ExecutionTracer::getInstance().exportTrace(path, format == 1 ? sd::ExecutionTracer::PERFETTO
+                                                                     : sd::ExecutionTracer::CHROME_JSON);
+  } catch (std::exception &e) {
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+  }
+}
+
+void purgeExecutionTrace() {
+  sd::ExecutionTracer::getInstance().purge();
+}
+
 void copyBuffer(OpaqueDataBuffer *target, long n,  OpaqueDataBuffer *from, long fromOffset, long targetOffset) {
   OpaqueDataBuffer *copyFrom = dbCreateView(from,n,fromOffset);
   OpaqueDataBuffer *targetView = dbCreateView(target,n,targetOffset);
@@ -2333,53 +2350,38 @@ sd::Status registerGraph(sd::Pointer *extraPointers, sd::LongType graphId, sd::P
 
 static VariablesSet *executeStoredGraphT(sd::Pointer *extraPointers, sd::LongType graphId, sd::Pointer *inputBuffers,
                                          sd::Pointer *inputShapes, int *inputIndices, int numInputs) {
-  auto graph = sd::graph::GraphHolder::getInstance().cloneGraph(graphId);
-  auto varSpace = graph->getVariableSpace();
-
-  std::vector<sd::NDArray *> handles;
+  auto &holder = sd::graph::GraphHolder::getInstance();
 
-  for (int e = 0; e < numInputs; e++) {
-    auto idx = inputIndices[e];
-
-    // we'll delete this array later, together with cloned VariableSpace
-    auto array = new sd::NDArray(inputBuffers[e], reinterpret_cast<sd::LongType *>(inputShapes[e]));
-    handles.emplace_back(array);
-
-    if (varSpace->hasVariable(idx)) {
-      auto var = varSpace->getVariable(idx);
-      if (var->hasNDArray()) delete var->getNDArray();
-
-      var->setNDArray(array);
-    } else
-      varSpace->putVariable(idx, array);
-  }
-
-  auto hZ = sd::graph::GraphExecutioner::execute(graph, varSpace);
-  auto varSet = new sd::graph::VariablesSet(hZ);
-
-  if (hZ == sd::Status::OK) {
-    // pull back results, and provide them
-    auto outputs = graph->fetchOutputs();
-    for (int e = 0; e < outputs->size(); e++) {
-      // we're only getting variable ID/Index from original grap. values will be taken from cloned workspace
-      std::pair<int, int> varId(outputs->at(e)->id(), outputs->at(e)->index());
-
-      auto var = varSpace->getVariable(varId);
-
-      varSet->push_back(var->clone());
-    }
-
-    delete outputs;
+  // session is created once per thread, so per-request cost is just binding inputs and executing ops
+  holder.lockRead(graphId);
+  sd::Status status;
+  sd::graph::GraphSession *session = nullptr;
+  try {
+    session = holder.session(graphId);
+    status = session->execute(inputBuffers, inputShapes, inputIndices, numInputs);
+  } catch (...) {
+    holder.unlockRead(graphId);
+    throw;
   }
+  holder.unlockRead(graphId);
 
-  delete graph;
+  // outputs stay owned by session, and remain valid until next request from the same thread
+  auto varSet = new sd::graph::VariablesSet(status, false);
+  if (status == sd::Status::OK)
+    for (auto v : session->outputs()) varSet->push_back(v);
 
   return varSet;
 }
 
 sd::graph::VariablesSet *executeStoredGraph(sd::Pointer *extraPointers, sd::LongType graphId, sd::Pointer *inputBuffers,
                                             sd::Pointer *inputShapes, int *inputIndices, int numInputs) {
-  return nullptr;
+  try {
+    return executeStoredGraphT(extraPointers, graphId, inputBuffers, inputShapes, inputIndices, numInputs);
+  } catch (std::exception &e) {
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+    return nullptr;
+  }
 }
 
 sd::LongType getVariablesSetSize(sd::graph::VariablesSet *set) { return set->size(); }
@@ -2885,7 +2887,9 @@ void deleteConstantDataBuffer(sd::ConstantDataBuffer *ptr) {
   //constant buffers otherwise should stick around
 }
 
-void deleteTadPack(sd::TadPack *ptr) { delete ptr; }
+void deleteTadPack(sd::TadPack *ptr) {
+  // TadPacks are owned by ConstantTadHelper cache
+}
 
 sd::ConstantDataBuffer *constantBufferLong(sd::DataType dtype, const sd::LongType *data, int length) { return nullptr; }
 
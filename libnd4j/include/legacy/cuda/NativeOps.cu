@@ -25,6 +25,7 @@
 #include <helpers/BlasHelper.h>
 #include <helpers/CudaLaunchHelper.h>
 #include <helpers/DebugHelper.h>
+#include <helpers/ExecutionTracer.h>
 #include <helpers/PointersManager.h>
 #include <helpers/threshold.h>
 #include <legacy/NativeOpExecutioner.h>
@@ -169,6 +170,29 @@ void purgeOpTrace() {
   sd::ops::OpRegistrator::getInstance().purgeOpExecs();
 }
 
+void toggleExecutionTrace(bool enabled) {
+  sd::Environment::getInstance().setTracing(enabled);
+}
+
+void setExecutionTraceSampling(int every, sd::LongType slowNanos) {
+  sd::Environment::getInstance().setTraceSampling(every);
+  sd::Environment::getInstance().setTraceSlowNanos(slowNanos);
+}
+
+void exportExecutionTrace(const char *path, int format) {
+  try {
+    sd::ExecutionTracer::getInstance().exportTrace(path, format == 1 ? sd::ExecutionTracer::PERFETTO
+                                                                     : sd::ExecutionTracer::CHROME_JSON);
+  } catch (std::exception &e) {
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorCode(1);
+    sd::LaunchContext::defaultContext()->errorReference()->setErrorMessage(e.what());
+  }
+}
+
+void purgeExecutionTrace() {
+  sd::ExecutionTracer::getInstance().purge();
+}
+
 
 void printOpTrace() {
   auto execTrace = *sd::ops::OpRegistrator::getInstance().execTrace();
@@ -2902,46 +2926,25 @@ Status registerGraph(sd::Pointer *extraPointers, sd::LongType graphId, sd::Point
 
 static VariablesSet *executeStoredGraphT(sd::Pointer *extraPointers, sd::LongType graphId, sd::Pointer *inputBuffers,
                                          sd::Pointer *inputShapes, int *inputIndices, int numInputs) {
-  auto graph = sd::graph::GraphHolder::getInstance().pullGraph(graphId);
-  auto varSpace = graph->getVariableSpace()->clone();
-
-  std::vector<sd::NDArray *> handles;
+  auto &holder = sd::graph::GraphHolder::getInstance();
 
-  for (int e = 0; e < numInputs; e++) {
-    auto idx = inputIndices[e];
-
-    // we'll delete this array later, together with cloned VariableSpace
-    auto array = new sd::NDArray(inputBuffers[e], reinterpret_cast<sd::LongType *>(inputShapes[e]));
-    handles.emplace_back(array);
-
-    if (varSpace->hasVariable(idx)) {
-      auto var = varSpace->getVariable(idx);
-      if (var->hasNDArray()) delete var->getNDArray();
-
-      var->setNDArray(array);
-    } else
-      varSpace->putVariable(idx, array);
-  }
-
-  auto dZ = sd::graph::GraphExecutioner::execute(graph, varSpace);
-  auto varSet = new sd::graph::VariablesSet(dZ);
-
-  if (dZ == Status::OK) {
-    // pull back results, and provide them
-    auto outputs = graph->fetchOutputs();
-    for (int e = 0; e < outputs->size(); e++) {
-      // we're only getting variable ID/Index from original grap. values will be taken from cloned workspace
-      std::pair<int, int> varId(outputs->at(e)->id(), outputs->at(e)->index());
-
-      auto var = varSpace->getVariable(varId);
-
-      varSet->push_back(var->clone());
-    }
-
-    delete outputs;
+  // session is created once per thread, so per-request cost is just binding inputs and executing ops
+  holder.lockRead(graphId);
+  sd::Status status;
+  sd::graph::GraphSession *session = nullptr;
+  try {
+    session = holder.session(graphId);
+    status = session->execute(inputBuffers, inputShapes, inputIndices, numInputs);
+  } catch (...) {
+    holder.unlockRead(graphId);
+    throw;
   }
+  holder.unlockRead(graphId);
 
-  delete varSpace;
+  // outputs stay owned by session, and remain valid until next request from the same thread
+  auto varSet = new sd::graph::VariablesSet(status, false);
+  if (status == sd::Status::OK)
+    for (auto v : session->outputs()) varSet->push_back(v);
 
   return varSet;
 }
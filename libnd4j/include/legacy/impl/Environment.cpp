@@ -116,6 +116,78 @@ sd::Environment::Environment() {
     _allowHelpers = false;
   }
 
+  /**
+   * If this env var is defined - conv2d won't use Winograd transform for 3x3 kernels
+   */
+  const char *forbid_winograd = std::getenv("SD_FORBID_WINOGRAD");
+  if (forbid_winograd != nullptr) {
+    _useWinograd = false;
+  }
+
+  /**
+   * If this env var is defined - op temporaries won't use per-thread scratch arenas
+   */
+  const char *forbid_scratch_arena = std::getenv("SD_FORBID_SCRATCH_ARENA");
+  if (forbid_scratch_arena != nullptr) {
+    _useScratchArena = false;
+  }
+
+  /**
+   * If this env var is defined - op executions are traced, see helpers/ExecutionTracer.h
+   */
+  const char *trace = std::getenv("SD_TRACE");
+  if (trace != nullptr) {
+    _tracing = true;
+  }
+
+  /**
+   * This var defines tracing sampling: only every N-th execution on each thread gets recorded
+   */
+  const char *trace_sampling = std::getenv("SD_TRACE_SAMPLING");
+  if (trace_sampling != nullptr) {
+    try {
+      std::string t(trace_sampling);
+      auto val = std::stoi(t);
+      _traceSampling.store(val);
+    } catch (std::invalid_argument &e) {
+      // just do nothing
+    } catch (std::out_of_range &e) {
+      // still do nothing
+    }
+  }
+
+  /**
+   * This var defines duration, in nanoseconds, above which executions are traced regardless of sampling
+   */
+  const char *trace_slow_nanos = std::getenv("SD_TRACE_SLOW_NANOS");
+  if (trace_slow_nanos != nullptr) {
+    try {
+      std::string t(trace_slow_nanos);
+      auto val = std::stol(t);
+      _traceSlowNanos.store(val);
+    } catch (std::invalid_argument &e) {
+      // just do nothing
+    } catch (std::out_of_range &e) {
+      // still do nothing
+    }
+  }
+
+  /**
+   * This var defines max size of per-thread scratch arena, in bytes
+   */
+  const char *scratch_arena_bytes = std::getenv("SD_SCRATCH_ARENA_BYTES");
+  if (scratch_arena_bytes != nullptr) {
+    try {
+      std::string t(scratch_arena_bytes);
+      auto val = std::stol(t);
+      _scratchArenaLimit.store(val);
+    } catch (std::invalid_argument &e) {
+      // just do nothing
+    } catch (std::out_of_range &e) {
+      // still do nothing
+    }
+  }
+
   /**
    * This var defines max amount of host memory library can allocate
    */
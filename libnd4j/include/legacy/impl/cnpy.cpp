@@ -689,6 +689,195 @@ std::vector<char> cnpy::createNpyHeader( const unsigned int *shape, const unsign
   return header;
 }
 
+/**
+ * Parse the numpy header from memory
+ * @param data pointer to the magic string
+ * @param length number of bytes available
+ * @return the parsed header
+ */
+cnpy::NpyHeader cnpy::readNpyHeader(const char *data, size_t length) {
+  const unsigned char magic[] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+  if (data == nullptr || length < 10 || memcmp(data, magic, 6) != 0)
+    THROW_EXCEPTION("cnpy::readNpyHeader() - provided buffer doesn't look like a NumPy file");
+
+  // version 1 stores header length as uint16, versions 2 and 3 as uint32
+  const auto major = static_cast<unsigned char>(data[6]);
+  size_t headerStart, headerLength;
+  if (major == 1) {
+    headerStart = 10;
+    headerLength = static_cast<unsigned char>(data[8]) | (static_cast<unsigned char>(data[9]) << 8);
+  } else if (major == 2 || major == 3) {
+    if (length < 12) THROW_EXCEPTION("cnpy::readNpyHeader() - truncated NumPy header");
+
+    headerStart = 12;
+    headerLength = 0;
+    for (int e = 3; e >= 0; e--) headerLength = (headerLength << 8) | static_cast<unsigned char>(data[8 + e]);
+  } else {
+    THROW_EXCEPTION("cnpy::readNpyHeader() - unsupported NumPy format version");
+  }
+
+  if (headerStart + headerLength > length) THROW_EXCEPTION("cnpy::readNpyHeader() - truncated NumPy header");
+
+  const std::string header(data + headerStart, headerLength);
+  NpyHeader result;
+  result.dataOffset = headerStart + headerLength;
+
+  // descr, i.e. '<f4'
+  auto loc = header.find("'descr'");
+  if (loc == std::string::npos) THROW_EXCEPTION("cnpy::readNpyHeader() - header has no descr");
+  loc = header.find('\'', loc + 7);
+  auto end = loc == std::string::npos ? loc : header.find('\'', loc + 1);
+  if (end == std::string::npos || end - loc < 4) THROW_EXCEPTION("cnpy::readNpyHeader() - malformed descr");
+
+  const auto descr = header.substr(loc + 1, end - loc - 1);
+  result.bigEndian = descr[0] == '>';
+  result.wordSize = atoi(descr.c_str() + 2);
+
+  switch (descr[1]) {
+    case 'b':
+      result.dataType = sd::DataType::BOOL;
+      break;
+    case 'i':
+      result.dataType = result.wordSize == 1   ? sd::DataType::INT8
+                        : result.wordSize == 2 ? sd::DataType::INT16
+                        : result.wordSize == 4 ? sd::DataType::INT32
+                        : result.wordSize == 8 ? sd::DataType::INT64
+                                               : sd::DataType::INHERIT;
+      break;
+    case 'u':
+      result.dataType = result.wordSize == 1   ? sd::DataType::UINT8
+                        : result.wordSize == 2 ? sd::DataType::UINT16
+                        : result.wordSize == 4 ? sd::DataType::UINT32
+                        : result.wordSize == 8 ? sd::DataType::UINT64
+                                               : sd::DataType::INHERIT;
+      break;
+    case 'f':
+      result.dataType = result.wordSize == 2   ? sd::DataType::HALF
+                        : result.wordSize == 4 ? sd::DataType::FLOAT32
+                        : result.wordSize == 8 ? sd::DataType::DOUBLE
+                                               : sd::DataType::INHERIT;
+      break;
+    default:
+      break;
+  }
+
+  if (result.dataType == sd::DataType::INHERIT)
+    THROW_EXCEPTION(("cnpy::readNpyHeader() - unsupported data type: " + descr).c_str());
+
+  // fortran_order
+  loc = header.find("'fortran_order'");
+  if (loc == std::string::npos) THROW_EXCEPTION("cnpy::readNpyHeader() - header has no fortran_order");
+  loc = header.find_first_not_of(": ", loc + 15);
+  result.fortranOrder = loc != std::string::npos && header.compare(loc, 4, "True") == 0;
+
+  // shape, i.e. (3, 4) or (5,) or ()
+  loc = header.find("'shape'");
+  loc = loc == std::string::npos ? loc : header.find('(', loc);
+  end = loc == std::string::npos ? loc : header.find(')', loc);
+  if (end == std::string::npos) THROW_EXCEPTION("cnpy::readNpyHeader() - malformed shape");
+
+  const char *cursor = header.c_str() + loc + 1;
+  const char *last = header.c_str() + end;
+  while (cursor < last) {
+    char *next = nullptr;
+    auto dim = strtoll(cursor, &next, 10);
+    if (next == cursor) {
+      cursor++;
+      continue;
+    }
+
+    result.shape.emplace_back(static_cast<sd::LongType>(dim));
+    cursor = next;
+  }
+
+  return result;
+}
+
+/**
+ * Create the numpy header for the given data type and shape
+ * @param dataType the data type of the array
+ * @param shape the shape of the array
+ * @param minLength the minimal header length
+ * @return the header bytes
+ */
+std::vector<char> cnpy::createNpyHeader(sd::DataType dataType, const std::vector<sd::LongType> &shape,
+                                        size_t minLength) {
+  std::string descr;
+  switch (dataType) {
+    case sd::DataType::BOOL:
+      descr = "|b1";
+      break;
+    case sd::DataType::INT8:
+      descr = "|i1";
+      break;
+    case sd::DataType::UINT8:
+      descr = "|u1";
+      break;
+    case sd::DataType::INT16:
+      descr = "i2";
+      break;
+    case sd::DataType::UINT16:
+      descr = "u2";
+      break;
+    case sd::DataType::INT32:
+      descr = "i4";
+      break;
+    case sd::DataType::UINT32:
+      descr = "u4";
+      break;
+    case sd::DataType::INT64:
+      descr = "i8";
+      break;
+    case sd::DataType::UINT64:
+      descr = "u8";
+      break;
+    case sd::DataType::HALF:
+      descr = "f2";
+      break;
+    case sd::DataType::FLOAT32:
+      descr = "f4";
+      break;
+    case sd::DataType::DOUBLE:
+      descr = "f8";
+      break;
+    default:
+      THROW_EXCEPTION("cnpy::createNpyHeader() - data type has no NumPy equivalent");
+  }
+
+  if (descr.size() == 2) descr = BigEndianTest() + descr;
+
+  std::vector<char> dict;
+  dict += "{'descr': '";
+  dict += descr;
+  dict += "', 'fortran_order': False, 'shape': (";
+  for (size_t e = 0; e < shape.size(); e++) {
+    if (e > 0) dict += ", ";
+    dict += tostring(shape[e]);
+  }
+
+  if (shape.size() == 1) dict += ",";
+  dict += "), }";
+
+  // preamble + dict is padded to multiple of 64 bytes (and at least minLength), dict ends with \n
+  size_t total = 10 + dict.size() + 1;
+  total = (total + 63) / 64 * 64;
+  if (total < minLength) total = minLength;
+  if (total - 10 > 65535) THROW_EXCEPTION("cnpy::createNpyHeader() - header is too long");
+
+  dict.insert(dict.end(), total - 10 - dict.size(), ' ');
+  dict.back() = '\n';
+
+  std::vector<char> header;
+  header += (char)0x93;
+  header += "NUMPY";
+  header += (char)0x01;  // major version of numpy format
+  header += (char)0x00;  // minor version of numpy format
+  header += (unsigned short)dict.size();
+  header.insert(header.end(), dict.begin(), dict.end());
+
+  return header;
+}
+
 BUILD_SINGLE_TEMPLATE(template SD_LIB_EXPORT std::vector<char> cnpy::createNpyHeader,
                       (const unsigned int *shape, const unsigned int ndims, unsigned int wordSize),
                       SD_COMMON_TYPES);
@@ -23,6 +23,7 @@
 #include <helpers/ConstantTadHelper.h>
 #include <helpers/Loops.h>
 #include <helpers/OmpLaunchHelper.h>
+#include <helpers/PairwiseReduction.h>
 #include <helpers/ShapeBuilders.h>
 #include <loops/legacy_ops.h>
 #include <loops/reduce_float.h>
@@ -41,7 +42,6 @@ void SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, const sd::Lon
   auto x = reinterpret_cast<const X *>(vx);
   auto z = reinterpret_cast<Z *>(vz);
   auto extraParams = reinterpret_cast<Z *>(vextraParams);
-  using Y = typename OpType::InterType;
 
   const sd::LongType length = shape::length(xShapeInfo);
   auto xEws = shape::elementWiseStride(xShapeInfo);
@@ -67,30 +67,16 @@ void SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, const sd::Lon
   if (xEws > 0) {
     z[0] = execScalar<OpType>(x, xEws, length, extraParams);
   } else {
-    auto startingValue = OpType::startingValue(x);
     sd::LongType xShapeInfoCast[SD_MAX_RANK];
     const bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
     int maxThreads = sd::math::sd_min<int>(64, sd::Environment::getInstance().maxThreads());
-    Y intermediate[64];
 
-    PRAGMA_OMP_SIMD
-    for (auto e = 0; e < maxThreads; e++) intermediate[e] = OpType::startingValue(x);
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(
-            intermediate[thread_id],
-            OpType::op(x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)], extraParams), extraParams);
-    };
-
-    maxThreads = samediff::Threads::parallel_for(func, 0, length, 1, maxThreads);
-
-    // merge results
-    for (int e = 1; e < maxThreads; e++)
-      intermediate[0] = OpType::update(intermediate[0], intermediate[e], extraParams);
+    const auto s = sd::PairwiseReduction<X, Z, OpType>::reduceParallel(
+        x, [&](sd::LongType i) -> X { return x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)]; }, length,
+        extraParams, maxThreads);
 
     // write out results
-    z[0] = OpType::postProcess(intermediate[0], length, extraParams);
+    z[0] = OpType::postProcess(s, length, extraParams);
   }
 }
 
@@ -106,16 +92,14 @@ Z SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, const sd::LongTy
   if (xEws > 0) {
     return execScalar<OpType>(x, xEws, length, extraParams);
   } else {
-    auto startingValue = OpType::startingValue(x);
     sd::LongType xShapeInfoCast[SD_MAX_RANK];
     bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
 
-    for (sd::LongType i = 0; i < length; i++)
-      startingValue = OpType::update(
-          startingValue, OpType::op(x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)], extraParams),
-          extraParams);
+    const auto s = sd::PairwiseReduction<X, Z, OpType>::reduce(
+        x, [&](sd::LongType i) -> X { return x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)]; }, 0,
+        length, extraParams);
 
-    return OpType::postProcess(startingValue, length, extraParams);
+    return OpType::postProcess(s, length, extraParams);
   }
 }
 
@@ -146,29 +130,18 @@ Z SD_HOST ReduceFloatFunction<X, Z>::execScalar(const void *vx, sd::LongType xEw
   auto x = reinterpret_cast<const X *>(vx);
   auto extraParams = reinterpret_cast<Z *>(vextraParams);
   int maxThreads = sd::math::sd_min<int>(64, sd::Environment::getInstance().maxThreads());
-  using Y = typename OpType::InterType;
-  Y intermediate[64];
-
-  PRAGMA_OMP_SIMD
-  for (auto e = 0; e < maxThreads; e++) intermediate[e] = OpType::startingValue(x);
-
-  auto func = PRAGMA_THREADS_FOR {
-    if (xEws == 1) {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
-    } else {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] =
-            OpType::update(intermediate[thread_id], OpType::op(x[i * xEws], extraParams), extraParams);
-    }
-  };
-
-  maxThreads = samediff::Threads::parallel_for(func, 0, length, 1, maxThreads);
-  // merge results
-  for (int e = 1; e < maxThreads; e++) intermediate[0] = OpType::update(intermediate[0], intermediate[e], extraParams);
-
-  // return result
-  return OpType::postProcess(intermediate[0], length, extraParams);
+  using Reduction = sd::PairwiseReduction<X, Z, OpType>;
+
+  // chunks are fixed in size and merged in order, so the result doesn't depend on the number of threads
+  if (xEws == 1)
+    return OpType::postProcess(
+        Reduction::reduceParallel(x, [x](sd::LongType i) -> X { return x[i]; }, length, extraParams, maxThreads),
+        length, extraParams);
+
+  return OpType::postProcess(
+      Reduction::reduceParallel(x, [x, xEws](sd::LongType i) -> X { return x[i * xEws]; }, length, extraParams,
+                                maxThreads),
+      length, extraParams);
 }
 
 ////////////////////////////////////////////////////////////////////////
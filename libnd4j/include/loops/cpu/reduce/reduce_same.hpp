@@ -23,6 +23,7 @@
 #include <helpers/ConstantTadHelper.h>
 #include <helpers/Loops.h>
 #include <helpers/OmpLaunchHelper.h>
+#include <helpers/PairwiseReduction.h>
 #include <loops/legacy_ops.h>
 #include <loops/reduce_same.h>
 #include <system/op_boilerplate.h>
@@ -62,30 +63,16 @@ void SD_HOST ReduceSameFunction<X>::execScalar(const void *vx, const sd::LongTyp
   if (xEws >= 1) {
     z[0] = execScalar<OpType>(x, xEws, length, extraParams);
   } else {
-    auto startingValue = OpType::startingValue(x);
     sd::LongType xShapeInfoCast[SD_MAX_RANK];
     const bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
     int maxThreads = sd::math::sd_min<int>(64, sd::Environment::getInstance().maxThreads());
-    X intermediate[64];
 
-    PRAGMA_OMP_SIMD
-    for (auto e = 0; e < maxThreads; e++) intermediate[e] = OpType::startingValue(x);
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(
-            intermediate[thread_id],
-            OpType::op(x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)], extraParams), extraParams);
-    };
-
-    maxThreads = samediff::Threads::parallel_for(func, 0, length, 1, maxThreads);
-
-    // merge results
-    for (int e = 1; e < maxThreads; e++)
-      intermediate[0] = OpType::update(intermediate[0], intermediate[e], extraParams);
+    const auto s = sd::PairwiseReduction<X, X, OpType>::reduceParallel(
+        x, [&](sd::LongType i) -> X { return x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)]; }, length,
+        extraParams, maxThreads);
 
     // write out results
-    z[0] = OpType::postProcess(intermediate[0], length, extraParams);
+    z[0] = OpType::postProcess(s, length, extraParams);
   }
 }
 
@@ -101,16 +88,14 @@ X SD_HOST ReduceSameFunction<X>::execScalar(const void *vx, const sd::LongType *
   if (xEws >= 1) {
     return execScalar<OpType>(x, xEws, length, extraParams);
   } else {
-    auto startingValue = OpType::startingValue(x);
     sd::LongType xShapeInfoCast[SD_MAX_RANK];
     bool canCastX = sd::DataTypeUtils::castShapeInfo(xShapeInfo, xShapeInfoCast);
 
-    for (sd::LongType i = 0; i < length; i++)
-      startingValue = OpType::update(
-          startingValue, OpType::op(x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)], extraParams),
-          extraParams);
+    const auto s = sd::PairwiseReduction<X, X, OpType>::reduce(
+        x, [&](sd::LongType i) -> X { return x[shape::indexOffset(i, xShapeInfo, xShapeInfoCast, canCastX)]; }, 0,
+        length, extraParams);
 
-    return OpType::postProcess(startingValue, length, extraParams);
+    return OpType::postProcess(s, length, extraParams);
   }
 }
 
@@ -140,29 +125,18 @@ X SD_HOST ReduceSameFunction<X>::execScalar(const void *vx, sd::LongType xEws, s
   auto x = reinterpret_cast<const X *>(vx);
   auto extraParams = reinterpret_cast<X *>(vextraParams);
   int maxThreads = sd::math::sd_min<int>(64, sd::Environment::getInstance().maxThreads());
-  X intermediate[64];
-
-  PRAGMA_OMP_SIMD
-  for (auto e = 0; e < maxThreads; e++) intermediate[e] = OpType::startingValue(x);
-
-  auto func = PRAGMA_THREADS_FOR {
-    if (xEws == 1) {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] = OpType::update(intermediate[thread_id], OpType::op(x[i], extraParams), extraParams);
-    } else {
-      for (auto i = start; i < stop; i++)
-        intermediate[thread_id] =
-            OpType::update(intermediate[thread_id], OpType::op(x[i * xEws], extraParams), extraParams);
-    }
-  };
-
-  maxThreads = samediff::Threads::parallel_for(func, 0, length, 1, maxThreads);
-
-  // merge results
-  for (int e = 1; e < maxThreads; e++) intermediate[0] = OpType::update(intermediate[0], intermediate[e], extraParams);
-
-  // return result
-  return OpType::postProcess(intermediate[0], length, extraParams);
+  using Reduction = sd::PairwiseReduction<X, X, OpType>;
+
+  // chunks are fixed in size and merged in order, so the result doesn't depend on the number of threads
+  if (xEws == 1)
+    return OpType::postProcess(
+        Reduction::reduceParallel(x, [x](sd::LongType i) -> X { return x[i]; }, length, extraParams, maxThreads),
+        length, extraParams);
+
+  return OpType::postProcess(
+      Reduction::reduceParallel(x, [x, xEws](sd::LongType i) -> X { return x[i * xEws]; }, length, extraParams,
+                                maxThreads),
+      length, extraParams);
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,160 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Per-thread bump allocator for op-internal temporaries.
+//
+// While a DeclarableOp is executing, host buffers of arrays created without a user Workspace are carved out of the
+// calling thread's arena instead of the heap. The arena is rewound once the outermost op on that thread finishes and
+// every block handed out has been released; its capacity follows the largest per-op demand seen so far (capped by
+// Environment::scratchArenaLimit()), so after the first few ops temporaries stop hitting malloc/free altogether.
+//
+// Arena buffers are counted by MemoryCounter, and arena doesn't grow past its device/group limits. Blocks served from
+// it aren't counted again.
+//
+// Blocks may outlive the op or be released from another thread: every block references its arena, which only gets
+// rewound or destroyed when no live blocks remain. So a single escaped block pins the whole arena buffer, and later
+// temporaries spill to heap while it's alive. Results an op stores via DeclarableOp::overwriteResult() are moved to
+// heap for that reason, see DataBuffer::detachFromArena(). Arrays an op keeps elsewhere (i.e. in NDArrayList or Stash)
+// must be allocated with a workspace or copied out by the op.
+//
+
+#ifndef LIBND4J_SCRATCHARENA_H
+#define LIBND4J_SCRATCHARENA_H
+
+#include <system/common.h>
+
+#include <atomic>
+
+namespace sd {
+namespace memory {
+
+struct ScratchArenaHolder;
+
+struct SD_LIB_EXPORT ScratchArenaStatistics {
+  // blocks served from arena, and their total size in bytes
+  sd::LongType allocations = 0;
+  sd::LongType allocatedBytes = 0;
+
+  // requests made within op scope that didn't fit into arena and went to heap
+  sd::LongType spills = 0;
+  sd::LongType spilledBytes = 0;
+
+  // number of times arena was rewound, and number of times its buffer was grown
+  sd::LongType resets = 0;
+  sd::LongType resizes = 0;
+
+  // current arena size, and largest amount of scratch memory requested by a single top-level op
+  sd::LongType capacity = 0;
+  sd::LongType highWaterMark = 0;
+};
+
+class SD_LIB_EXPORT ScratchArena {
+ private:
+  char *_buffer = nullptr;
+  sd::LongType _capacity = 0;
+  sd::LongType _offset = 0;
+
+  // bytes requested within current top-level scope, served or spilled
+  sd::LongType _demand = 0;
+
+  // live blocks, plus one reference held by the owner thread
+  std::atomic<sd::LongType> _references{1};
+
+  int _depth = 0;
+
+  // device arena memory is counted against in MemoryCounter
+  const int _deviceId;
+
+  ScratchArenaStatistics _statistics;
+
+  // part of _statistics already added to global counters
+  ScratchArenaStatistics _published;
+
+  char *_raw = nullptr;
+
+  friend struct ScratchArenaHolder;
+
+  ScratchArena();
+  ~ScratchArena();
+
+  void rewind();
+  void unref();
+  void publish();
+
+ public:
+  ScratchArena(const ScratchArena &other) = delete;
+  ScratchArena &operator=(const ScratchArena &other) = delete;
+
+  /**
+   * Arena of the calling thread, created on first use
+   */
+  static ScratchArena *current();
+
+  /**
+   * TRUE if calling thread is inside op scope, so temporaries should go to its arena
+   */
+  static bool isActive();
+
+  /**
+   * Returns zeroed block of given size from the calling thread's arena, or nullptr if it doesn't fit there
+   */
+  static void *allocate(sd::LongType numBytes);
+
+  /**
+   * Returns block to its arena, can be called from any thread
+   */
+  static void release(void *block);
+
+  /**
+   * Statistics of the calling thread's arena
+   */
+  static ScratchArenaStatistics statistics();
+
+  /**
+   * Statistics summed over all threads, capacity is total memory currently held by arenas
+   */
+  static ScratchArenaStatistics globalStatistics();
+
+  /**
+   * Releases memory held by the calling thread's arena, if it's idle
+   */
+  static void trim();
+
+  void scopeIn();
+  void scopeOut();
+
+  /**
+   * RAII guard opening op scope on the calling thread, no-op if arena is disabled via Environment
+   */
+  class SD_LIB_EXPORT Scope {
+   private:
+    ScratchArena *_arena = nullptr;
+
+   public:
+    Scope();
+    ~Scope();
+
+    Scope(const Scope &other) = delete;
+    Scope &operator=(const Scope &other) = delete;
+  };
+};
+}  // namespace memory
+}  // namespace sd
+
+#endif  // LIBND4J_SCRATCHARENA_H
@@ -0,0 +1,268 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Per-thread bump allocator for op-internal temporaries
+//
+#include <execution/AffinityManager.h>
+#include <math/templatemath.h>
+#include <memory/MemoryCounter.h>
+#include <memory/ScratchArena.h>
+#include <system/Environment.h>
+
+#include <cstring>
+#include <new>
+
+namespace sd {
+namespace memory {
+
+// every block is preceded by header holding its arena, blocks and buffer itself are cache line aligned
+static const sd::LongType SCRATCH_ALIGNMENT = 64;
+static const sd::LongType SCRATCH_HEADER = SCRATCH_ALIGNMENT;
+
+// arena grows in steps of this size
+static const sd::LongType SCRATCH_GRANULARITY = 1 << 20;
+
+static SD_INLINE sd::LongType scratchRoundUp(sd::LongType value, sd::LongType step) {
+  return (value + step - 1) / step * step;
+}
+
+// totals over all arenas, updated once per top-level op
+static std::atomic<sd::LongType> globalAllocations{0};
+static std::atomic<sd::LongType> globalAllocatedBytes{0};
+static std::atomic<sd::LongType> globalSpills{0};
+static std::atomic<sd::LongType> globalSpilledBytes{0};
+static std::atomic<sd::LongType> globalResets{0};
+static std::atomic<sd::LongType> globalResizes{0};
+static std::atomic<sd::LongType> globalCapacity{0};
+static std::atomic<sd::LongType> globalHighWaterMark{0};
+
+// arena buffers are counted by MemoryCounter as a whole, with the same limits heap allocations of DataBuffer obey
+static bool scratchCountIn(const int deviceId, const sd::LongType numBytes) {
+  auto &counter = MemoryCounter::getInstance();
+  const bool cpu = Environment::getInstance().isCPU();
+  if (cpu ? !counter.validateDevice(deviceId, numBytes) : !counter.validateGroup(MemoryType::HOST, numBytes))
+    return false;
+
+  if (cpu) counter.countIn(deviceId, numBytes);
+  counter.countIn(MemoryType::HOST, numBytes);
+  return true;
+}
+
+static void scratchCountOut(const int deviceId, const sd::LongType numBytes) {
+  if (numBytes <= 0) return;
+
+  auto &counter = MemoryCounter::getInstance();
+  if (Environment::getInstance().isCPU()) counter.countOut(deviceId, numBytes);
+  counter.countOut(MemoryType::HOST, numBytes);
+}
+
+struct ScratchArenaHolder {
+  ScratchArena *arena = nullptr;
+
+  // thread is gone: arena lives on until blocks it handed out are released
+  ~ScratchArenaHolder() {
+    if (arena != nullptr) {
+      arena->_depth = 0;
+      arena->publish();
+      arena->unref();
+    }
+  }
+};
+
+#if defined(SD_IOS_BUILD) || defined(SD_APPLE_BUILD) || defined(SD_ANDROID_BUILD) || defined(__NEC__)
+// no reliable thread_local on these targets, arena stays disabled
+#define SD_SCRATCH_ARENA_DISABLED
+#else
+static thread_local ScratchArenaHolder scratchArenaHolder;
+#endif
+
+ScratchArena::ScratchArena() : _deviceId(AffinityManager::currentDeviceId()) {}
+
+ScratchArena::~ScratchArena() {
+  globalCapacity.fetch_sub(_capacity, std::memory_order_relaxed);
+  scratchCountOut(_deviceId, _capacity);
+  delete[] _raw;
+}
+
+ScratchArena *ScratchArena::current() {
+#if defined(SD_SCRATCH_ARENA_DISABLED)
+  return nullptr;
+#else
+  if (scratchArenaHolder.arena == nullptr) scratchArenaHolder.arena = new ScratchArena();
+
+  return scratchArenaHolder.arena;
+#endif
+}
+
+bool ScratchArena::isActive() {
+#if defined(SD_SCRATCH_ARENA_DISABLED)
+  return false;
+#else
+  return scratchArenaHolder.arena != nullptr && scratchArenaHolder.arena->_depth > 0;
+#endif
+}
+
+void *ScratchArena::allocate(sd::LongType numBytes) {
+  if (!isActive() || numBytes <= 0) return nullptr;
+
+  auto arena = current();
+  const auto size = SCRATCH_HEADER + scratchRoundUp(numBytes, SCRATCH_ALIGNMENT);
+  arena->_demand += size;
+
+  if (arena->_offset + size > arena->_capacity) {
+    arena->_statistics.spills++;
+    arena->_statistics.spilledBytes += numBytes;
+    return nullptr;
+  }
+
+  auto block = arena->_buffer + arena->_offset;
+  arena->_offset += size;
+  arena->_references.fetch_add(1, std::memory_order_relaxed);
+
+  arena->_statistics.allocations++;
+  arena->_statistics.allocatedBytes += numBytes;
+
+  *reinterpret_cast<ScratchArena **>(block) = arena;
+  auto result = block + SCRATCH_HEADER;
+  std::memset(result, 0, numBytes);
+
+  return result;
+}
+
+void ScratchArena::release(void *block) {
+  if (block == nullptr) return;
+
+  auto arena = *reinterpret_cast<ScratchArena **>(reinterpret_cast<char *>(block) - SCRATCH_HEADER);
+  arena->unref();
+}
+
+void ScratchArena::unref() {
+  if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+}
+
+void ScratchArena::rewind() {
+  // blocks that outlived their op are still in use, arena stays as is until they're gone
+  if (_references.load(std::memory_order_acquire) != 1) return;
+
+  if (_offset > 0) {
+    _offset = 0;
+    _statistics.resets++;
+  }
+
+  // high-water-mark sizing: make room for the largest op seen so far
+  const auto limit = Environment::getInstance().scratchArenaLimit();
+  const auto wanted = sd::math::sd_min<sd::LongType>(scratchRoundUp(_statistics.highWaterMark, SCRATCH_GRANULARITY),
+                                                     scratchRoundUp(limit, SCRATCH_ALIGNMENT));
+  if (wanted > _capacity) {
+    // arena just stays as is if growth would exceed MemoryCounter limits, temporaries spill to heap then
+    if (!scratchCountIn(_deviceId, wanted - _capacity)) return;
+
+    auto raw = new (std::nothrow) char[wanted + SCRATCH_ALIGNMENT];
+    if (raw == nullptr) {
+      scratchCountOut(_deviceId, wanted - _capacity);
+      return;
+    }
+
+    delete[] _raw;
+    globalCapacity.fetch_add(wanted - _capacity, std::memory_order_relaxed);
+
+    _raw = raw;
+    _buffer = reinterpret_cast<char *>(scratchRoundUp(reinterpret_cast<uintptr_t>(raw), SCRATCH_ALIGNMENT));
+    _capacity = wanted;
+    _statistics.resizes++;
+  }
+}
+
+void ScratchArena::publish() {
+  globalAllocations.fetch_add(_statistics.allocations - _published.allocations, std::memory_order_relaxed);
+  globalAllocatedBytes.fetch_add(_statistics.allocatedBytes - _published.allocatedBytes, std::memory_order_relaxed);
+  globalSpills.fetch_add(_statistics.spills - _published.spills, std::memory_order_relaxed);
+  globalSpilledBytes.fetch_add(_statistics.spilledBytes - _published.spilledBytes, std::memory_order_relaxed);
+  globalResets.fetch_add(_statistics.resets - _published.resets, std::memory_order_relaxed);
+  globalResizes.fetch_add(_statistics.resizes - _published.resizes, std::memory_order_relaxed);
+
+  auto hwm = globalHighWaterMark.load(std::memory_order_relaxed);
+  while (hwm < _statistics.highWaterMark &&
+         !globalHighWaterMark.compare_exchange_weak(hwm, _statistics.highWaterMark, std::memory_order_relaxed))
+    ;
+
+  _published = _statistics;
+}
+
+void ScratchArena::scopeIn() {
+  // blocks which escaped previous ops might be released by now
+  if (_depth++ == 0 && _offset > 0) rewind();
+}
+
+void ScratchArena::scopeOut() {
+  if (--_depth > 0) return;
+
+  _statistics.highWaterMark = sd::math::sd_max<sd::LongType>(_statistics.highWaterMark, _demand);
+  _demand = 0;
+
+  rewind();
+  publish();
+}
+
+ScratchArenaStatistics ScratchArena::statistics() {
+  auto arena = current();
+  if (arena == nullptr) return ScratchArenaStatistics();
+
+  auto result = arena->_statistics;
+  result.capacity = arena->_capacity;
+  return result;
+}
+
+ScratchArenaStatistics ScratchArena::globalStatistics() {
+  ScratchArenaStatistics result;
+  result.allocations = globalAllocations.load();
+  result.allocatedBytes = globalAllocatedBytes.load();
+  result.spills = globalSpills.load();
+  result.spilledBytes = globalSpilledBytes.load();
+  result.resets = globalResets.load();
+  result.resizes = globalResizes.load();
+  result.capacity = globalCapacity.load();
+  result.highWaterMark = globalHighWaterMark.load();
+  return result;
+}
+
+void ScratchArena::trim() {
+  auto arena = current();
+  if (arena == nullptr || arena->_depth > 0 || arena->_references.load(std::memory_order_acquire) != 1) return;
+
+  globalCapacity.fetch_sub(arena->_capacity, std::memory_order_relaxed);
+  scratchCountOut(arena->_deviceId, arena->_capacity);
+  delete[] arena->_raw;
+  arena->_raw = arena->_buffer = nullptr;
+  arena->_capacity = arena->_offset = 0;
+  arena->_statistics.highWaterMark = 0;
+}
+
+ScratchArena::Scope::Scope() {
+  if (!Environment::getInstance().isUseScratchArena()) return;
+
+  _arena = current();
+  if (_arena != nullptr) _arena->scopeIn();
+}
+
+ScratchArena::Scope::~Scope() {
+  if (_arena != nullptr) _arena->scopeOut();
+}
+}  // namespace memory
+}  // namespace sd
@@ -47,6 +47,7 @@
 #include <ops/declarable/headers/nlp.h>
 #include <ops/declarable/headers/nn.h>
 #include <ops/declarable/headers/parity_ops.h>
+#include <ops/declarable/headers/quantization.h>
 #include <ops/declarable/headers/random.h>
 #include <ops/declarable/headers/recurrent.h>
 #include <ops/declarable/headers/shape.h>
@@ -222,6 +222,9 @@ class SD_LIB_EXPORT DeclarableOp {
   sd::Status validateArguments(Context& block);
   void overwriteResult(Context& block, int outputIdx, NDArray* array, bool remove);
   void traceExecIfNeeded(Context& block);
+
+  // records this execution into ExecutionTracer, if sampling allows it
+  void traceExecution(Context& block, uint64_t start, sd::LongType allocatedBefore);
 };
 }  // namespace ops
 }  // namespace sd
@@ -0,0 +1,78 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Single-pass execution of a chain of legacy elementwise ops, built by Graph::fuseElementwiseChains()
+//
+
+#ifndef LIBND4J_FUSEDELEMENTWISEOP_H
+#define LIBND4J_FUSEDELEMENTWISEOP_H
+#include <graph/scheme/node_generated.h>
+#include <ops/declarable/LegacyOp.h>
+
+namespace sd {
+namespace ops {
+
+/**
+ * One link of a fused chain. Every stage consumes the result of the previous one (or input 0 of the fused op for the
+ * first stage), pairwise/broadcast stages and scalar stages fed by an array take their second operand from the
+ * fused op inputs.
+ */
+struct SD_LIB_EXPORT FusedStage {
+  sd::graph::OpType opType;
+  int opNum;
+
+  // index of the second operand among the fused op inputs, -1 if stage has none
+  int operand = -1;
+
+  // scalar for SCALAR stages without operand
+  double scalar = 0.0;
+
+  std::vector<double> tArgs;
+  std::vector<sd::LongType> dimensions;
+};
+
+/**
+ *   This class executes a chain of transform/scalar/pairwise/broadcast ops as one node. For contiguous inputs of the
+ * same floating point type the chain is applied tile by tile on CPU, so every intermediate result stays in cache
+ * and each array is read from memory only once. Any other case falls back to stage-by-stage execution over the
+ * output array.
+ */
+class SD_LIB_EXPORT FusedElementwiseOp : public LegacyOp {
+ protected:
+  std::vector<FusedStage> _stages;
+
+  sd::Status validateAndExecute(Context& block) override;
+
+ public:
+  FusedElementwiseOp(const std::vector<FusedStage>& stages, int numInputs);
+
+  const std::vector<FusedStage>& stages() const { return _stages; }
+
+  /**
+   * This method returns TRUE if node of given type can become a stage of a fused chain
+   */
+  static bool isFusable(sd::graph::OpType opType);
+
+  ShapeList* calculateOutputShape(ShapeList* inputShape, sd::graph::Context& block) override;
+  LegacyOp* clone() override;
+};
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_FUSEDELEMENTWISEOP_H
@@ -177,6 +177,8 @@ CONFIGURABLE_OP_IMPL(skipgram, 12, 12, true, 0, 0) {
 
   auto isInference = block.numB() > 0 ? B_ARG(0) : false;
   auto isPreciseMode = block.numB() > 1 ? B_ARG(1) : false;
+  // batch mode only: consecutive targets with the same negative starter share one set of negative samples
+  auto isSharedNegatives = block.numB() > 2 ? B_ARG(2) : false;
 
   auto minLearningRate = block.numT() > 0 ? T_ARG(0) : 1e-4;
 
@@ -189,7 +191,8 @@ CONFIGURABLE_OP_IMPL(skipgram, 12, 12, true, 0, 0) {
                "SkipGram: expTable must have the same data type as syn0 table");
 
   sd::ops::helpers::skipgram(*syn0, *syn1, *syn1neg, *expTable, *negTable, *target, *ngStarter, nsRounds, *indices,
-                             *codes, *alpha, *randomValue, *inferenceVector, isPreciseMode, numWorkers,iterations,minLearningRate);
+                             *codes, *alpha, *randomValue, *inferenceVector, isPreciseMode, numWorkers,iterations,minLearningRate,
+                             isSharedNegatives);
 
   return sd::Status::OK;
 }
@@ -95,8 +95,8 @@ CUSTOM_OP_IMPL(dot_product_attention, 3, -1, false, 0, 2) {
     // before going through the softmax, we effectively push all masked positions to zero after softmax.
     //
     // we are using 1e9 to mean effectively infinity
-    auto applyMask = reshapedMask  * 1e9;
-    *weights -= applyMask;
+    auto applyMask = (reshapedMask - 1.) * 1e9;
+    *weights += applyMask;
   }
 
   int softmaxDim = -2;
@@ -193,8 +193,9 @@ CUSTOM_OP_IMPL(dot_product_attention_bp, 4, 3, false, 0, 1) {
       reshapedMask = mask->reshape(mask->ordering(), {mask->sizeAt(0), mask->sizeAt(1), 1});
     }
 
-    reshapedMask  *= 1e9;
-    preSoftmax -= reshapedMask;
+    // same (mask - 1) * 1e9 bias as the forward pass, reshapedMask itself stays 0/1 for masking dLds below
+    auto applyMask = (reshapedMask - 1.) * 1e9;
+    preSoftmax += applyMask;
   }
 
   int softmaxDim = -2;
@@ -211,7 +212,7 @@ CUSTOM_OP_IMPL(dot_product_attention_bp, 4, 3, false, 0, 1) {
   softmax_bp.execute({&preSoftmax, &dLdw,&weights}, {&dLds}, {}, {softmaxDim}, {});
 
   if (normalization) dLds /= factor;
-  if(mask != nullptr) {
+  if(mask != nullptr && !mask->isEmpty()) {
     dLds *= reshapedMask;
   }
   mmul_bp.execute({keys, queries, &dLds}, std::vector<NDArray *>{dLdk, dLdq}, {}, {1}, {});
@@ -0,0 +1,177 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Embedding bag: table rows gathered and reduced per bag without materialized lookup, see helpers/embedding_bag.h
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_embedding_bag)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/embedding_bag.h>
+
+namespace sd {
+namespace ops {
+
+static void validateEmbeddingBag(const char* opName, const NDArray* table, const NDArray* indices, const NDArray* bags,
+                                 const NDArray* weights, const bool segmentIds, const int mode) {
+  REQUIRE_TRUE(table->rankOf() == 2, 0, "%s: table must be a matrix [numRows, dim], but got %s", opName,
+               ShapeUtils::shapeAsString(table).c_str());
+  REQUIRE_TRUE(indices->rankOf() == 1, 0, "%s: indices must be a vector, but got %s", opName,
+               ShapeUtils::shapeAsString(indices).c_str());
+  REQUIRE_TRUE(bags->rankOf() == 1, 0, "%s: offsets/segment ids must be a vector, but got %s", opName,
+               ShapeUtils::shapeAsString(bags).c_str());
+  if (segmentIds)
+    REQUIRE_TRUE(bags->lengthOf() == indices->lengthOf(), 0,
+                 "%s: segment ids must have the same length as indices, but got %i and %i", opName, bags->lengthOf(),
+                 indices->lengthOf());
+  REQUIRE_TRUE(mode >= helpers::kEmbeddingBagSum && mode <= helpers::kEmbeddingBagMax, 0,
+               "%s: mode must be 0 (sum), 1 (mean) or 2 (max), but got %i", opName, mode);
+
+  if (weights != nullptr) {
+    REQUIRE_TRUE(mode == helpers::kEmbeddingBagSum, 0, "%s: per sample weights are supported in sum mode only",
+                 opName);
+    REQUIRE_TRUE(weights->isVector() && weights->lengthOf() == indices->lengthOf(), 0,
+                 "%s: per sample weights must be a vector of length %i, but got %s", opName, indices->lengthOf(),
+                 ShapeUtils::shapeAsString(weights).c_str());
+    REQUIRE_TRUE(weights->dataType() == table->dataType(), 0,
+                 "%s: per sample weights must have the same data type as table", opName);
+  }
+}
+
+CUSTOM_OP_IMPL(embedding_bag, 3, 1, false, 0, -2) {
+  auto table = INPUT_VARIABLE(0);
+  auto indices = INPUT_VARIABLE(1);
+  auto bags = INPUT_VARIABLE(2);
+  auto weights = block.width() > 3 ? INPUT_VARIABLE(3) : nullptr;
+
+  auto output = OUTPUT_VARIABLE(0);
+
+  const int mode = block.numI() > 0 ? INT_ARG(0) : helpers::kEmbeddingBagSum;
+  const bool segmentIds = block.numI() > 1 && INT_ARG(1) != 0;
+
+  validateEmbeddingBag("embedding_bag", table, indices, bags, weights, segmentIds, mode);
+  REQUIRE_TRUE(output->dataType() == table->dataType(), 0,
+               "embedding_bag: output must have the same data type as table");
+
+  if (!output->isEmpty()) helpers::embeddingBag(*table, *indices, *bags, weights, segmentIds, mode, *output);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(embedding_bag) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {ALL_FLOATS})
+      ->setAllowedInputTypes(1, {ALL_INTS})
+      ->setAllowedInputTypes(2, {ALL_INTS})
+      ->setAllowedInputTypes(3, {ALL_FLOATS})
+      ->setAllowedOutputTypes({ALL_FLOATS});
+}
+
+DECLARE_SHAPE_FN(embedding_bag) {
+  auto tableShape = inputShape->at(0);
+  auto bags = INPUT_VARIABLE(2);
+  const bool segmentIds = block.numI() > 1 && INT_ARG(1) != 0;
+
+  // number of bags is the number of offsets, for segment ids it is either given or the largest id + 1
+  sd::LongType numBags = bags->lengthOf();
+  if (segmentIds) {
+    if (block.numI() > 2 && INT_ARG(2) > 0)
+      numBags = INT_ARG(2);
+    else
+      numBags = bags->isEmpty() ? 0 : bags->reduceNumber(reduce::Max).e<sd::LongType>(0) + 1;
+  }
+
+  return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(
+      ArrayOptions::dataType(tableShape), 'c', {numBags, shape::sizeAt(tableShape, static_cast<sd::LongType>(1))}));
+}
+
+CUSTOM_OP_IMPL(embedding_bag_bp, 4, 2, false, 0, -2) {
+  auto table = INPUT_VARIABLE(0);
+  auto indices = INPUT_VARIABLE(1);
+  auto bags = INPUT_VARIABLE(2);
+  auto weights = block.width() > 4 ? INPUT_VARIABLE(3) : nullptr;
+  auto eps = INPUT_VARIABLE(block.width() - 1);
+
+  auto uniqueIndices = OUTPUT_VARIABLE(0);
+  auto gradRows = OUTPUT_VARIABLE(1);
+  auto gradWeights = weights != nullptr ? OUTPUT_VARIABLE(2) : nullptr;
+
+  const int mode = block.numI() > 0 ? INT_ARG(0) : helpers::kEmbeddingBagSum;
+  const bool segmentIds = block.numI() > 1 && INT_ARG(1) != 0;
+
+  validateEmbeddingBag("embedding_bag_bp", table, indices, bags, weights, segmentIds, mode);
+
+  REQUIRE_TRUE(eps->rankOf() == 2 && eps->sizeAt(1) == table->sizeAt(1), 0,
+               "embedding_bag_bp: eps must have shape [numBags, %i], but got %s", table->sizeAt(1),
+               ShapeUtils::shapeAsString(eps).c_str());
+  if (!segmentIds)
+    REQUIRE_TRUE(eps->sizeAt(0) == bags->lengthOf(), 0,
+                 "embedding_bag_bp: eps must have one row per offset, expected %i rows, but got %i", bags->lengthOf(),
+                 eps->sizeAt(0));
+  // the helper is dispatched on the table type, so eps and the gradients have to share it
+  REQUIRE_TRUE(eps->dataType() == table->dataType() && gradRows->dataType() == table->dataType() &&
+                   (gradWeights == nullptr || gradWeights->dataType() == table->dataType()),
+               0, "embedding_bag_bp: eps and gradients must have the same data type as table");
+
+  if (!uniqueIndices->isEmpty())
+    helpers::embeddingBagBp(*table, *indices, *bags, weights, *eps, segmentIds, mode, *uniqueIndices, *gradRows,
+                            gradWeights);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(embedding_bag_bp) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {ALL_FLOATS})
+      ->setAllowedInputTypes(1, {ALL_INTS})
+      ->setAllowedInputTypes(2, {ALL_INTS})
+      ->setAllowedInputTypes(3, {ALL_FLOATS})
+      ->setAllowedInputTypes(4, {ALL_FLOATS})
+      ->setAllowedOutputTypes(0, {sd::DataType::INT64})
+      ->setAllowedOutputTypes(1, {ALL_FLOATS})
+      ->setAllowedOutputTypes(2, {ALL_FLOATS});
+}
+
+DECLARE_SHAPE_FN(embedding_bag_bp) {
+  auto tableShape = inputShape->at(0);
+  auto indices = INPUT_VARIABLE(1);
+  const auto dtype = ArrayOptions::dataType(tableShape);
+
+  // sparse gradient: distinct indices and gradient rows of the table they address
+  const sd::LongType numUnique = helpers::embeddingBagNumUnique(*indices);
+  auto uniqueShape = numUnique == 0 ? ConstantShapeHelper::getInstance().emptyShapeInfo(sd::DataType::INT64)
+                                    : ConstantShapeHelper::getInstance().vectorShapeInfo(numUnique, sd::DataType::INT64);
+  auto rowsShape =
+      numUnique == 0
+          ? ConstantShapeHelper::getInstance().emptyShapeInfo(dtype)
+          : ConstantShapeHelper::getInstance().createShapeInfo(
+                dtype, 'c', {numUnique, shape::sizeAt(tableShape, static_cast<sd::LongType>(1))});
+
+  if (block.width() > 4)
+    return SHAPELIST(uniqueShape, rowsShape,
+                     ConstantShapeHelper::getInstance().vectorShapeInfo(indices->lengthOf(), dtype));
+
+  return SHAPELIST(uniqueShape, rowsShape);
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
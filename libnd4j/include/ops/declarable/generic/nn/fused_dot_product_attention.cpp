@@ -0,0 +1,168 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Scaled dot product attention without materialized scores, see helpers/fused_attention.h
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_fused_dot_product_attention)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/fused_attention.h>
+
+namespace sd {
+namespace ops {
+
+static void validateFusedAttention(const char* opName, const NDArray* queries, const NDArray* keys,
+                                   const NDArray* values, const NDArray* mask) {
+  REQUIRE_TRUE(queries->rankOf() == keys->rankOf() && keys->rankOf() == values->rankOf(), 0,
+               "%s: queries, keys and values must have same rank, but got queries = %s, keys = %s, values = %s", opName,
+               ShapeUtils::shapeAsString(queries).c_str(), ShapeUtils::shapeAsString(keys).c_str(),
+               ShapeUtils::shapeAsString(values).c_str());
+  REQUIRE_TRUE(queries->rankOf() == 3 || queries->rankOf() == 4, 0,
+               "%s: queries, keys and values must be rank 3 arrays for single headed attention or rank 4 arrays for "
+               "multi headed attention, but got rank = %i",
+               opName, queries->rankOf());
+
+  const int rank = queries->rankOf();
+  for (int e = 0; e < rank - 2; e++)
+    REQUIRE_TRUE(queries->sizeAt(e) == keys->sizeAt(e) && keys->sizeAt(e) == values->sizeAt(e), 0,
+                 "%s: queries, keys and values must have the same batch and head sizes, but got queries = %s, "
+                 "keys = %s, values = %s",
+                 opName, ShapeUtils::shapeAsString(queries).c_str(), ShapeUtils::shapeAsString(keys).c_str(),
+                 ShapeUtils::shapeAsString(values).c_str());
+
+  // the helper is instantiated for a single float type, mask is the only input allowed to differ
+  REQUIRE_TRUE(queries->dataType() == keys->dataType() && keys->dataType() == values->dataType(), 0,
+               "%s: queries, keys and values must have the same data type, but got queries = %s, keys = %s, "
+               "values = %s",
+               opName, DataTypeUtils::asString(queries->dataType()).c_str(),
+               DataTypeUtils::asString(keys->dataType()).c_str(), DataTypeUtils::asString(values->dataType()).c_str());
+
+  REQUIRE_TRUE(queries->sizeAt(-1) == keys->sizeAt(-1), 0,
+               "%s: queries and keys must have the same feature size, but got queries = %i, keys = %i", opName,
+               queries->sizeAt(-1), keys->sizeAt(-1));
+  REQUIRE_TRUE(keys->sizeAt(-2) == values->sizeAt(-2), 0,
+               "%s: keys and values must have the same timestep length, but got keys = %i, values = %i", opName,
+               keys->sizeAt(-2), values->sizeAt(-2));
+
+  if (mask != nullptr && !mask->isEmpty())
+    REQUIRE_TRUE(mask->rankOf() == 2 && mask->sizeAt(0) == keys->sizeAt(0) && mask->sizeAt(1) == keys->sizeAt(-2), 0,
+                 "%s: mask must have shape [%i, %i], but got %s", opName, keys->sizeAt(0), keys->sizeAt(-2),
+                 ShapeUtils::shapeAsString(mask).c_str());
+}
+
+CUSTOM_OP_IMPL(fused_dot_product_attention, 3, 1, false, -2, 0) {
+  auto queries = INPUT_VARIABLE(0);
+  auto keys = INPUT_VARIABLE(1);
+  auto values = INPUT_VARIABLE(2);
+  auto mask = block.width() > 3 ? INPUT_VARIABLE(3) : nullptr;
+
+  auto output = OUTPUT_VARIABLE(0);
+
+  const double scale = block.numT() > 0 ? T_ARG(0) : 1.0;
+  const bool causal = block.numB() > 0 ? B_ARG(0) : false;
+
+  validateFusedAttention("fused_dot_product_attention", queries, keys, values, mask);
+  REQUIRE_TRUE(output->dataType() == queries->dataType(), 0,
+               "fused_dot_product_attention: output must have the same data type as queries, but got %s and %s",
+               DataTypeUtils::asString(output->dataType()).c_str(), DataTypeUtils::asString(queries->dataType()).c_str());
+
+  if (!output->isEmpty()) helpers::fusedDotProductAttention(*queries, *keys, *values, mask, *output, scale, causal);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(fused_dot_product_attention) {
+  getOpDescriptor()->setAllowedInputTypes(0, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(1, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(2, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(3, sd::DataType::ANY);
+  getOpDescriptor()->setAllowedOutputTypes({ALL_FLOATS});
+  getOpDescriptor()->setSameMode(false);
+}
+
+DECLARE_SHAPE_FN(fused_dot_product_attention) {
+  auto queryShape = inputShape->at(0);
+  auto valuesShape = inputShape->at(2);
+
+  // [batchSize, (numHeads,) queryCount, featureValues]
+  std::vector<sd::LongType> outShape(shape::shapeOf(queryShape), shape::shapeOf(queryShape) + shape::rank(queryShape));
+  outShape.back() = shape::sizeAt(valuesShape, static_cast<sd::LongType>(-1));
+
+  return SHAPELIST(
+      ConstantShapeHelper::getInstance().createShapeInfo(ArrayOptions::dataType(queryShape), 'c', outShape));
+}
+
+CUSTOM_OP_IMPL(fused_dot_product_attention_bp, 4, 3, false, -2, 0) {
+  auto queries = INPUT_VARIABLE(0);
+  auto keys = INPUT_VARIABLE(1);
+  auto values = INPUT_VARIABLE(2);
+  auto eps = INPUT_VARIABLE(3);
+  auto mask = block.width() > 4 ? INPUT_VARIABLE(4) : nullptr;
+
+  auto dLdq = OUTPUT_VARIABLE(0);
+  auto dLdk = OUTPUT_VARIABLE(1);
+  auto dLdv = OUTPUT_VARIABLE(2);
+
+  const double scale = block.numT() > 0 ? T_ARG(0) : 1.0;
+  const bool causal = block.numB() > 0 ? B_ARG(0) : false;
+
+  validateFusedAttention("fused_dot_product_attention_bp", queries, keys, values, mask);
+
+  std::vector<sd::LongType> expectedEpsShape = queries->getShapeAsVector();
+  expectedEpsShape.back() = values->sizeAt(-1);
+  REQUIRE_TRUE(eps->isSameShape(expectedEpsShape), 0,
+               "fused_dot_product_attention_bp: wrong shape of eps array, expected is %s, but got %s instead",
+               ShapeUtils::shapeAsString(expectedEpsShape).c_str(), ShapeUtils::shapeAsString(eps).c_str());
+  REQUIRE_TRUE(eps->dataType() == queries->dataType() && dLdq->dataType() == queries->dataType() &&
+                   dLdk->dataType() == queries->dataType() && dLdv->dataType() == queries->dataType(),
+               0, "fused_dot_product_attention_bp: eps and gradients must have the same data type as queries (%s)",
+               DataTypeUtils::asString(queries->dataType()).c_str());
+
+  helpers::fusedDotProductAttentionBp(*queries, *keys, *values, mask, *eps, *dLdq, *dLdk, *dLdv, scale, causal);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(fused_dot_product_attention_bp) {
+  getOpDescriptor()->setAllowedInputTypes(0, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(1, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(2, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(3, {ALL_FLOATS});
+  getOpDescriptor()->setAllowedInputTypes(4, sd::DataType::ANY);
+  getOpDescriptor()->setAllowedOutputTypes({ALL_FLOATS});
+  getOpDescriptor()->setSameMode(false);
+}
+
+DECLARE_SHAPE_FN(fused_dot_product_attention_bp) {
+  sd::LongType *dLdq_shape;
+  COPY_SHAPE(inputShape->at(0), dLdq_shape);
+  sd::LongType *dLdk_shape;
+  COPY_SHAPE(inputShape->at(1), dLdk_shape);
+  sd::LongType *dLdv_shape;
+  COPY_SHAPE(inputShape->at(2), dLdv_shape);
+
+  return SHAPELIST(CONSTANT(dLdq_shape), CONSTANT(dLdk_shape), CONSTANT(dLdv_shape));
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
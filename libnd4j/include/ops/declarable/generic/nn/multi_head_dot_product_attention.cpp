@@ -27,6 +27,7 @@
 
 #include <helpers/AttentionHelper.h>
 #include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/fused_attention.h>
 
 namespace sd {
 namespace ops {
@@ -114,9 +115,20 @@ CUSTOM_OP_IMPL(multi_head_dot_product_attention, 7, -1, false, 0, 2) {
       'c',
       {projectedQueries.sizeAt(0), projectedValues.sizeAt(1), projectedValues.sizeAt(2), projectedQueries.sizeAt(3)},
       projectedValues.dataType(), block.launchContext());
-  sd::ops::dot_product_attention attention;
-  attention.execute({&projectedQueries, &projectedKeys, &projectedValues, mask},
-                    {&attnResults, weights ? OUTPUT_VARIABLE(1) : nullptr}, {}, {normalization, weights}, {});
+  if (weights) {
+    sd::ops::dot_product_attention attention;
+    attention.execute({&projectedQueries, &projectedKeys, &projectedValues, mask},
+                      {&attnResults, OUTPUT_VARIABLE(1)}, {}, {normalization, weights}, {});
+  } else {
+    // without weights output the [timeSteps, queryCount] scores per head are never materialized,
+    // the fused kernel works on [minibatch, numHeads, seqLength, projectedSize] views
+    auto q = projectedQueries.permute({0, 1, 3, 2});
+    auto k = projectedKeys.permute({0, 1, 3, 2});
+    auto v = projectedValues.permute({0, 1, 3, 2});
+    auto attn = attnResults.permute({0, 1, 3, 2});
+    const double scale = normalization ? 1.0 / sqrt((double)projectedQueries.sizeAt(2)) : 1.0;
+    helpers::fusedDotProductAttention(q, k, v, mask, attn, scale, false);
+  }
 
   // Project attention results
   attnResults.permutei({0, 3, 1, 2});
@@ -269,12 +281,20 @@ CUSTOM_OP_IMPL(multi_head_dot_product_attention_bp, 8, 7, false, 0, 1) {
   dLdPreWo.reshapei({miniBatchSize, queryCount, numHeads, projectedValues.sizeAt(2)});
   dLdPreWo.permutei({0, 2, 3, 1});
 
-  sd::ops::dot_product_attention_bp attentionBp;
   NDArray dLdProjectedQueries(projectedQueries.shapeInfo(), false, block.launchContext());
   NDArray dLdProjectedKeys(projectedKeys.shapeInfo(), false, block.launchContext());
   NDArray dLdProjectedValues(projectedValues.shapeInfo(), false, block.launchContext());
-  attentionBp.execute({&projectedQueries, &projectedKeys, &projectedValues, &dLdPreWo, mask},
-                      {&dLdProjectedQueries, &dLdProjectedKeys, &dLdProjectedValues}, {}, {normalization}, {});
+
+  // attention gradients recompute the scores block by block on [minibatch, numHeads, seqLength, projectedSize] views
+  auto q = projectedQueries.permute({0, 1, 3, 2});
+  auto k = projectedKeys.permute({0, 1, 3, 2});
+  auto v = projectedValues.permute({0, 1, 3, 2});
+  auto gradAttn = dLdPreWo.permute({0, 1, 3, 2});
+  auto gradQ = dLdProjectedQueries.permute({0, 1, 3, 2});
+  auto gradK = dLdProjectedKeys.permute({0, 1, 3, 2});
+  auto gradV = dLdProjectedValues.permute({0, 1, 3, 2});
+  const double scale = normalization ? 1.0 / sqrt((double)projectedQueries.sizeAt(2)) : 1.0;
+  helpers::fusedDotProductAttentionBp(q, k, v, mask, gradAttn, gradQ, gradK, gradV, scale, false);
 
   AttentionHelper::multiHeadProjectBp(queries, Wq, &dLdProjectedQueries, dLdq, dLdWq, block.launchContext());
   AttentionHelper::multiHeadProjectBp(keys, Wk, &dLdProjectedKeys, dLdk, dLdWk, block.launchContext());
@@ -0,0 +1,151 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// image.combined_non_max_suppression
+//
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/image_suppression.h>
+
+#if NOT_EXCLUDED(OP_combined_non_max_suppression)
+
+namespace sd {
+namespace ops {
+
+static void combinedNmsArgs(sd::graph::Context& block, int& maxOutputPerClass, int& maxTotalSize,
+                            double& overlapThreshold, double& scoreThreshold) {
+  if (block.width() > 2)
+    maxOutputPerClass = INPUT_VARIABLE(2)->e<int>(0);
+  else if (block.getIArguments()->size() > 0)
+    maxOutputPerClass = INT_ARG(0);
+  else
+    THROW_EXCEPTION("image.combined_non_max_suppression: Max output size per class argument cannot be retrieved.");
+
+  if (block.width() > 3)
+    maxTotalSize = INPUT_VARIABLE(3)->e<int>(0);
+  else if (block.getIArguments()->size() > 1)
+    maxTotalSize = INT_ARG(1);
+  else
+    THROW_EXCEPTION("image.combined_non_max_suppression: Max total size argument cannot be retrieved.");
+
+  overlapThreshold = 0.5;
+  if (block.width() > 4)
+    overlapThreshold = INPUT_VARIABLE(4)->e<double>(0);
+  else if (block.getTArguments()->size() > 0)
+    overlapThreshold = T_ARG(0);
+
+  scoreThreshold = -DataTypeUtils::infOrMax<float>();
+  if (block.width() > 5)
+    scoreThreshold = INPUT_VARIABLE(5)->e<double>(0);
+  else if (block.getTArguments()->size() > 1)
+    scoreThreshold = T_ARG(1);
+}
+
+CUSTOM_OP_IMPL(combined_non_max_suppression, 2, 4, false, 0, 0) {
+  auto boxes = INPUT_VARIABLE(0);
+  auto scores = INPUT_VARIABLE(1);
+  auto nmsedBoxes = OUTPUT_VARIABLE(0);
+  auto nmsedScores = OUTPUT_VARIABLE(1);
+  auto nmsedClasses = OUTPUT_VARIABLE(2);
+  auto validDetections = OUTPUT_VARIABLE(3);
+
+  int maxOutputPerClass, maxTotalSize;
+  double overlapThreshold, scoreThreshold;
+  combinedNmsArgs(block, maxOutputPerClass, maxTotalSize, overlapThreshold, scoreThreshold);
+
+  const bool clipBoxes = block.getBArguments()->size() > 1 ? B_ARG(1) : true;
+
+  REQUIRE_TRUE(scores->rankOf() == 3, 0,
+               "image.combined_non_max_suppression: The rank of scores array should be 3, but %i is given",
+               scores->rankOf());
+  REQUIRE_TRUE(boxes->rankOf() == 3 || boxes->rankOf() == 4, 0,
+               "image.combined_non_max_suppression: The rank of boxes array should be 3 or 4, but %i is given",
+               boxes->rankOf());
+  REQUIRE_TRUE(boxes->sizeAt(-1) == 4, 0,
+               "image.combined_non_max_suppression: The last dimension of boxes array should be 4, but %i is given",
+               boxes->sizeAt(-1));
+  REQUIRE_TRUE(boxes->sizeAt(0) == scores->sizeAt(0) && boxes->sizeAt(1) == scores->sizeAt(1), 0,
+               "image.combined_non_max_suppression: Boxes and scores should have the same batch size and number of "
+               "boxes, but %s and %s are given",
+               ShapeUtils::shapeAsString(boxes).c_str(), ShapeUtils::shapeAsString(scores).c_str());
+  REQUIRE_TRUE(boxes->rankOf() == 3 || boxes->sizeAt(2) == 1 || boxes->sizeAt(2) == scores->sizeAt(2), 0,
+               "image.combined_non_max_suppression: Third dimension of boxes should be 1 or number of classes %i, "
+               "but %i is given",
+               scores->sizeAt(2), boxes->sizeAt(2));
+  REQUIRE_TRUE(overlapThreshold >= 0. && overlapThreshold <= 1., 0,
+               "image.combined_non_max_suppression: The overlap threshold should be in [0, 1], but %lf is given.",
+               overlapThreshold);
+  REQUIRE_TRUE(boxes->dataType() == scores->dataType(), 0,
+               "image.combined_non_max_suppression: Boxes and scores inputs should have the same data type, but %s "
+               "and %s were given.",
+               DataTypeUtils::asString(boxes->dataType()).c_str(), DataTypeUtils::asString(scores->dataType()).c_str());
+
+  if (boxes->isEmpty() || scores->isEmpty() || nmsedScores->isEmpty()) return sd::Status::OK;
+
+  NDArray boxes4 = boxes->rankOf() == 4
+                       ? *boxes
+                       : boxes->reshape(boxes->ordering(), {boxes->sizeAt(0), boxes->sizeAt(1), 1, 4});
+
+  helpers::combinedNonMaxSuppression(block.launchContext(), &boxes4, scores, maxOutputPerClass, overlapThreshold,
+                                     scoreThreshold, clipBoxes, nmsedBoxes, nmsedScores, nmsedClasses,
+                                     validDetections);
+  return sd::Status::OK;
+}
+
+DECLARE_SHAPE_FN(combined_non_max_suppression) {
+  auto scores = inputShape->at(1);
+
+  int maxOutputPerClass, maxTotalSize;
+  double overlapThreshold, scoreThreshold;
+  combinedNmsArgs(block, maxOutputPerClass, maxTotalSize, overlapThreshold, scoreThreshold);
+
+  const bool padPerClass = block.getBArguments()->size() > 0 ? B_ARG(0) : false;
+
+  const sd::LongType bS = shape::sizeAt(scores, static_cast<sd::LongType>(0));
+  const sd::LongType numClasses = shape::sizeAt(scores, static_cast<sd::LongType>(2));
+
+  sd::LongType maxDetections = maxTotalSize;
+  if (padPerClass)
+    maxDetections = sd::math::sd_min<sd::LongType>(maxTotalSize, (sd::LongType)maxOutputPerClass * numClasses);
+
+  const auto type = ArrayOptions::dataType(inputShape->at(0));
+
+  return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(type, 'c', {bS, maxDetections, 4}),
+                   ConstantShapeHelper::getInstance().createShapeInfo(type, 'c', {bS, maxDetections}),
+                   ConstantShapeHelper::getInstance().createShapeInfo(type, 'c', {bS, maxDetections}),
+                   ConstantShapeHelper::getInstance().vectorShapeInfo(bS, DataType::INT32));
+}
+
+DECLARE_TYPES(combined_non_max_suppression) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {ALL_FLOATS})
+      ->setAllowedInputTypes(1, {ALL_FLOATS})
+      ->setAllowedInputTypes(2, {ALL_INTS})
+      ->setAllowedInputTypes(3, {ALL_INTS})
+      ->setAllowedInputTypes(4, {ALL_FLOATS})
+      ->setAllowedInputTypes(5, {ALL_FLOATS})
+      ->setAllowedOutputTypes(0, {ALL_FLOATS})
+      ->setAllowedOutputTypes(1, {ALL_FLOATS})
+      ->setAllowedOutputTypes(2, {ALL_FLOATS})
+      ->setAllowedOutputTypes(3, {sd::DataType::INT32});
+}
+
+}  // namespace ops
+}  // namespace sd
+#endif
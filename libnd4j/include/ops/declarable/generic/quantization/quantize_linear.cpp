@@ -0,0 +1,117 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Affine quantize/dequantize with per-tensor or per-channel scale and zero point
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantize_linear) || NOT_EXCLUDED(OP_dequantize_linear)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+namespace ops {
+
+// per-channel parameters hold one value per slice along axis
+static bool validQuantizationParams(const NDArray& input, const NDArray& scale, const NDArray& zeroPoint,
+                                    const int axis) {
+  if (scale.lengthOf() != zeroPoint.lengthOf()) return false;
+  if (scale.lengthOf() == 1) return true;
+  return axis >= 0 && axis < input.rankOf() && scale.lengthOf() == input.sizeAt(axis);
+}
+
+#if NOT_EXCLUDED(OP_quantize_linear)
+CUSTOM_OP_IMPL(quantize_linear, 3, 1, false, 0, 0) {
+  auto input = INPUT_VARIABLE(0);
+  auto scale = INPUT_VARIABLE(1);
+  auto zeroPoint = INPUT_VARIABLE(2);
+  auto output = OUTPUT_VARIABLE(0);
+
+  const int axis = block.numI() > 0 ? INT_ARG(0) : 1;
+  REQUIRE_TRUE(validQuantizationParams(*input, *scale, *zeroPoint, axis < 0 ? axis + input->rankOf() : axis), 0,
+               "QUANTIZE_LINEAR OP: scale and zero point must be scalars or vectors of input size along axis "
+               "%i, but got %s and %s instead !",
+               axis, ShapeUtils::shapeAsString(scale).c_str(), ShapeUtils::shapeAsString(zeroPoint).c_str());
+  if (input->isEmpty()) return sd::Status::OK;
+
+  helpers::quantizeLinear(*input, *scale, *zeroPoint, axis, *output);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(quantize_linear) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {ALL_FLOATS})
+      ->setAllowedInputTypes(1, {ALL_FLOATS})
+      ->setAllowedInputTypes(2, {ALL_INTS})
+      ->setAllowedOutputTypes({sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32});
+}
+
+DECLARE_SHAPE_FN(quantize_linear) {
+  auto dtype = block.numD() > 0 ? D_ARG(0) : sd::DataType::INT8;
+  REQUIRE_TRUE(dtype == sd::DataType::INT8 || dtype == sd::DataType::UINT8 || dtype == sd::DataType::INT32, 0,
+               "QUANTIZE_LINEAR OP: output data type must be INT8, UINT8 or INT32, but got %s instead !",
+               DataTypeUtils::asString(dtype).c_str());
+
+  return SHAPELIST(CONSTANT(ShapeBuilders::copyShapeInfoAndType(inputShape->at(0), dtype, true, block.workspace())));
+}
+#endif
+
+#if NOT_EXCLUDED(OP_dequantize_linear)
+CUSTOM_OP_IMPL(dequantize_linear, 3, 1, false, 0, 0) {
+  auto input = INPUT_VARIABLE(0);
+  auto scale = INPUT_VARIABLE(1);
+  auto zeroPoint = INPUT_VARIABLE(2);
+  auto output = OUTPUT_VARIABLE(0);
+
+  const int axis = block.numI() > 0 ? INT_ARG(0) : 1;
+  REQUIRE_TRUE(validQuantizationParams(*input, *scale, *zeroPoint, axis < 0 ? axis + input->rankOf() : axis), 0,
+               "DEQUANTIZE_LINEAR OP: scale and zero point must be scalars or vectors of input size along axis "
+               "%i, but got %s and %s instead !",
+               axis, ShapeUtils::shapeAsString(scale).c_str(), ShapeUtils::shapeAsString(zeroPoint).c_str());
+  if (input->isEmpty()) return sd::Status::OK;
+
+  helpers::dequantizeLinear(*input, *scale, *zeroPoint, axis, *output);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(dequantize_linear) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32})
+      ->setAllowedInputTypes(1, {ALL_FLOATS})
+      ->setAllowedInputTypes(2, {ALL_INTS})
+      ->setAllowedOutputTypes({ALL_FLOATS});
+}
+
+DECLARE_SHAPE_FN(dequantize_linear) {
+  auto dtype = block.numD() > 0 ? D_ARG(0) : ArrayOptions::dataType(inputShape->at(1));
+  REQUIRE_TRUE(DataTypeUtils::isR(dtype), 0,
+               "DEQUANTIZE_LINEAR OP: output data type must be floating point, but got %s instead !",
+               DataTypeUtils::asString(dtype).c_str());
+
+  return SHAPELIST(CONSTANT(ShapeBuilders::copyShapeInfoAndType(inputShape->at(0), dtype, true, block.workspace())));
+}
+#endif
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
@@ -0,0 +1,156 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// conv2d over int8/uint8 input and int8 weights, see helpers::quantizedConv2d
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantized_conv2d)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+namespace ops {
+
+CUSTOM_OP_IMPL(quantized_conv2d, 6, 1, false, -2, 9) {
+  auto input = INPUT_VARIABLE(0);    // [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+  auto weights = INPUT_VARIABLE(1);  // [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+  auto xScale = INPUT_VARIABLE(2);
+  auto xZeroPoint = INPUT_VARIABLE(3);
+  auto wScale = INPUT_VARIABLE(4);                              // scalar or [oC]
+  auto wZeroPoint = INPUT_VARIABLE(5);                          // scalar or [oC]
+  auto bias = block.width() > 6 ? INPUT_VARIABLE(6) : nullptr;  // [oC]
+
+  auto output = OUTPUT_VARIABLE(0);  // [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
+
+  LongType sH = INT_ARG(2);                                          // strides height
+  LongType sW = INT_ARG(3);                                          // strides width
+  LongType pH = INT_ARG(4);                                          // paddings height
+  LongType pW = INT_ARG(5);                                          // paddings width
+  LongType dH = INT_ARG(6);                                          // dilations height
+  LongType dW = INT_ARG(7);                                          // dilations width
+  int isSameMode = INT_ARG(8);                                       // 0-VALID, 1-SAME
+  int isNCHW = block.getIArguments()->size() > 9 ? !INT_ARG(9) : 1;  // INT_ARG(9): 0-NCHW,  1-NHWC
+  int wFormat = block.getIArguments()->size() > 10
+                    ? INT_ARG(10)
+                    : 0;  // 0 - [kH, kW, iC, oC], 1 - [oC, iC, kH, kW], 2 - [oC, kH, kW, iC]
+
+  LongType kH = INT_ARG(0) > 0 ? INT_ARG(0) : static_cast<LongType>(weights->sizeAt(0));  // filter(kernel) height
+  LongType kW = INT_ARG(1) > 0 ? INT_ARG(1) : static_cast<LongType>(weights->sizeAt(1));  // filter(kernel) width
+
+  LongType bS, iC, iH, iW, oC, oH,
+      oW;  // batch size, input channels, input height/width, output channels, output height/width;
+  LongType indIOioC, indIiH, indWoC, indWiC, indWkH, indOoH;  // corresponding indexes
+  ConvolutionUtils::getSizesAndIndexesConv2d(isNCHW, wFormat, *input, *output, bS, iC, iH, iW, oC, oH, oW, indIOioC,
+                                             indIiH, indWiC, indWoC, indWkH, indOoH);
+
+  std::vector<sd::LongType> expectedWeightsShape = ConvolutionUtils::expectWeightsShape(wFormat, kH, kW, iC, oC);
+  REQUIRE_TRUE(weights->isSameShape(expectedWeightsShape), 0,
+               "QUANTIZED_CONV2D OP: wrong shape of weights array, expected is %s, but got %s instead !",
+               ShapeUtils::shapeAsString(expectedWeightsShape).c_str(), ShapeUtils::shapeAsString(weights).c_str());
+  if (bias)
+    REQUIRE_TRUE(bias->rankOf() <= 2 && oC == bias->lengthOf(), 0,
+                 "QUANTIZED_CONV2D OP: wrong shape of array with biases, expected rank, length: <=2, %i, but got %i, "
+                 "%i instead !",
+                 oC, bias->rankOf(), bias->lengthOf());
+  REQUIRE_TRUE(xScale->lengthOf() == 1 && xZeroPoint->lengthOf() == 1, 0,
+               "QUANTIZED_CONV2D OP: input scale and zero point must be scalars !");
+  REQUIRE_TRUE((wScale->lengthOf() == 1 || wScale->lengthOf() == oC) && wScale->lengthOf() == wZeroPoint->lengthOf(),
+               0,
+               "QUANTIZED_CONV2D OP: weights scale and zero point must be scalars or vectors of length %i, but got %s "
+               "and %s instead !",
+               oC, ShapeUtils::shapeAsString(wScale).c_str(), ShapeUtils::shapeAsString(wZeroPoint).c_str());
+
+  const bool requantize = output->dataType() == sd::DataType::INT8 || output->dataType() == sd::DataType::UINT8;
+  REQUIRE_TRUE(!requantize || block.numT() > 0, 0,
+               "QUANTIZED_CONV2D OP: INT8/UINT8 output requires output scale argument !");
+  REQUIRE_TRUE(!bias || output->dataType() != sd::DataType::INT32, 0,
+               "QUANTIZED_CONV2D OP: bias can't be added to raw INT32 accumulators !");
+  const double outScale = requantize ? T_ARG(0) : 1.;
+  const int outZeroPoint = block.numT() > 1 ? static_cast<int>(T_ARG(1)) : 0;
+  REQUIRE_TRUE(outScale > 0., 0, "QUANTIZED_CONV2D OP: output scale must be positive, but got %f instead !", outScale);
+
+  helpers::quantizedConv2d(*input, *weights, *xScale, *xZeroPoint, *wScale, *wZeroPoint, bias, *output, kH, kW, sH,
+                           sW, pH, pW, dH, dW, isSameMode, isNCHW, wFormat, outScale, outZeroPoint);
+
+  return sd::Status::OK;
+}
+
+DECLARE_SHAPE_FN(quantized_conv2d) {
+  auto inputShapeInfo = inputShape->at(0);    // [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW)
+  auto weightsShapeInfo = inputShape->at(1);  // [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+
+  LongType sH = INT_ARG(2);                                          // strides height
+  LongType sW = INT_ARG(3);                                          // strides width
+  LongType pH = INT_ARG(4);                                          // paddings height
+  LongType pW = INT_ARG(5);                                          // paddings width
+  LongType dH = INT_ARG(6);                                          // dilations height
+  LongType dW = INT_ARG(7);                                          // dilations width
+  int isSameMode = INT_ARG(8);                                       // 0-VALID, 1-SAME
+  int isNCHW = block.getIArguments()->size() > 9 ? !INT_ARG(9) : 1;  // INT_ARG(9): 0-NCHW, 1-NHWC
+  int wFormat = block.getIArguments()->size() > 10
+                    ? INT_ARG(10)
+                    : 0;  // 0 - [kH, kW, iC, oC], 1 - [oC, iC, kH, kW], 2 - [oC, kH, kW, iC]
+
+  LongType kH = INT_ARG(0) > 0 ? INT_ARG(0) : shape::sizeAt(weightsShapeInfo, static_cast<sd::LongType>(0));
+  LongType kW = INT_ARG(1) > 0 ? INT_ARG(1) : shape::sizeAt(weightsShapeInfo, static_cast<sd::LongType>(1));
+
+  const int rank = 4;
+  REQUIRE_TRUE(inputShapeInfo[0] == rank, 0,
+               "QUANTIZED_CONV2D OP: rank of input array must be equal to %i, but got %i instead !", rank,
+               inputShapeInfo[0]);
+  REQUIRE_TRUE(weightsShapeInfo[0] == rank, 0,
+               "QUANTIZED_CONV2D OP: rank of weights array must be equal to %i, but got %i instead !", rank,
+               weightsShapeInfo[0]);
+
+  const LongType indIiH = isNCHW ? 2 : 1;
+  const LongType indWoC = 0 == wFormat ? 3 : 0;
+
+  const LongType bS = inputShapeInfo[1];             // batch size
+  const LongType iH = inputShapeInfo[indIiH + 1];    // input height
+  const LongType iW = inputShapeInfo[indIiH + 2];    // input width
+  const LongType oC = weightsShapeInfo[indWoC + 1];  // output channels
+
+  LongType oH, oW;  // output height, width
+  ConvolutionUtils::calcOutSizePool2D(oH, oW, kH, kW, sH, sW, pH, pW, dH, dW, iH, iW, isSameMode);
+
+  auto dtype = block.numD() > 0 ? D_ARG(0) : sd::DataType::FLOAT32;
+
+  return SHAPELIST(ConstantShapeHelper::getInstance().createShapeInfo(
+      dtype, 'c', isNCHW ? std::vector<sd::LongType>({bS, oC, oH, oW}) : std::vector<sd::LongType>({bS, oH, oW, oC})));
+}
+
+DECLARE_TYPES(quantized_conv2d) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+      ->setAllowedInputTypes(1, {sd::DataType::INT8})
+      ->setAllowedInputTypes(2, {ALL_FLOATS})
+      ->setAllowedInputTypes(3, {ALL_INTS})
+      ->setAllowedInputTypes(4, {ALL_FLOATS})
+      ->setAllowedInputTypes(5, {ALL_INTS})
+      ->setAllowedInputTypes(6, {ALL_FLOATS})
+      ->setAllowedOutputTypes({ALL_FLOATS, sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32});
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
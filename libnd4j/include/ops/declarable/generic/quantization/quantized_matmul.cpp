@@ -0,0 +1,137 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// int8 matmul and xw_plus_b with int32 accumulation and dequantizing/requantizing epilogue
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_quantized_matmul) || NOT_EXCLUDED(OP_quantized_xw_plus_b)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/quantization.h>
+
+namespace sd {
+namespace ops {
+
+static void quantizedMatmulOp(sd::graph::Context& block, const char* opName, NDArray* x, NDArray* w,
+                              const NDArray* bias, const NDArray* xScale, const NDArray* xZeroPoint,
+                              const NDArray* wScale, const NDArray* wZeroPoint, NDArray* z) {
+  const bool transX = block.numI() > 0 && INT_ARG(0) == 1;
+  const bool transW = block.numI() > 1 && INT_ARG(1) == 1;
+
+  REQUIRE_TRUE(x->rankOf() == 2 && w->rankOf() == 2, 0,
+               "%s OP: x and w must be matrices, but got ranks %i and %i instead !", opName, x->rankOf(),
+               w->rankOf());
+
+  auto xM = transX ? new NDArray(x->transpose()) : x;
+  auto wM = transW ? new NDArray(w->transpose()) : w;
+  const LongType N = wM->sizeAt(1);
+
+  REQUIRE_TRUE(xM->sizeAt(1) == wM->sizeAt(0), 0, "%s OP: inner dimensions of x %s and w %s don't match !", opName,
+               ShapeUtils::shapeAsString(xM).c_str(), ShapeUtils::shapeAsString(wM).c_str());
+  REQUIRE_TRUE(xScale->lengthOf() == 1 && xZeroPoint->lengthOf() == 1, 0,
+               "%s OP: x scale and zero point must be scalars !", opName);
+  REQUIRE_TRUE((wScale->lengthOf() == 1 || wScale->lengthOf() == N) && wScale->lengthOf() == wZeroPoint->lengthOf(),
+               0, "%s OP: w scale and zero point must be scalars or vectors of length %i, but got %s and %s instead !",
+               opName, N, ShapeUtils::shapeAsString(wScale).c_str(), ShapeUtils::shapeAsString(wZeroPoint).c_str());
+  if (bias)
+    REQUIRE_TRUE(bias->lengthOf() == N, 0, "%s OP: bias length must be %i, but got %i instead !", opName, N,
+                 bias->lengthOf());
+
+  const bool requantize = z->dataType() == sd::DataType::INT8 || z->dataType() == sd::DataType::UINT8;
+  REQUIRE_TRUE(!requantize || block.numT() > 0, 0, "%s OP: INT8/UINT8 output requires output scale argument !",
+               opName);
+  const double outScale = requantize ? T_ARG(0) : 1.;
+  const int outZeroPoint = block.numT() > 1 ? static_cast<int>(T_ARG(1)) : 0;
+  REQUIRE_TRUE(outScale > 0., 0, "%s OP: output scale must be positive, but got %f instead !", opName, outScale);
+
+  if (!x->isEmpty() && !w->isEmpty())
+    helpers::quantizedMatmul(*xM, *wM, *xScale, *xZeroPoint, *wScale, *wZeroPoint, bias, outScale, outZeroPoint, *z);
+
+  if (transX) delete xM;
+  if (transW) delete wM;
+}
+
+static const sd::LongType* quantizedMatmulShape(sd::graph::Context& block, const sd::LongType* xShapeInfo,
+                                                const sd::LongType* wShapeInfo) {
+  const bool transX = block.numI() > 0 && INT_ARG(0) == 1;
+  const bool transW = block.numI() > 1 && INT_ARG(1) == 1;
+  auto dtype = block.numD() > 0 ? D_ARG(0) : sd::DataType::FLOAT32;
+
+  return ConstantShapeHelper::getInstance().createShapeInfo(
+      dtype, 'c', {shape::sizeAt(xShapeInfo, transX ? 1 : 0), shape::sizeAt(wShapeInfo, transW ? 0 : 1)});
+}
+
+#if NOT_EXCLUDED(OP_quantized_matmul)
+CUSTOM_OP_IMPL(quantized_matmul, 6, 1, false, -2, -2) {
+  quantizedMatmulOp(block, "QUANTIZED_MATMUL", INPUT_VARIABLE(0), INPUT_VARIABLE(1), nullptr, INPUT_VARIABLE(2),
+                    INPUT_VARIABLE(3), INPUT_VARIABLE(4), INPUT_VARIABLE(5), OUTPUT_VARIABLE(0));
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(quantized_matmul) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+      ->setAllowedInputTypes(1, {sd::DataType::INT8})
+      ->setAllowedInputTypes(2, {ALL_FLOATS})
+      ->setAllowedInputTypes(3, {ALL_INTS})
+      ->setAllowedInputTypes(4, {ALL_FLOATS})
+      ->setAllowedInputTypes(5, {ALL_INTS})
+      ->setAllowedOutputTypes({ALL_FLOATS, sd::DataType::INT8, sd::DataType::UINT8, sd::DataType::INT32});
+}
+
+DECLARE_SHAPE_FN(quantized_matmul) {
+  return SHAPELIST(quantizedMatmulShape(block, inputShape->at(0), inputShape->at(1)));
+}
+#endif
+
+#if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+CUSTOM_OP_IMPL(quantized_xw_plus_b, 7, 1, false, -2, -2) {
+  auto z = OUTPUT_VARIABLE(0);
+  REQUIRE_TRUE(z->dataType() != sd::DataType::INT32, 0,
+               "QUANTIZED_XW_PLUS_B OP: bias can't be added to raw INT32 accumulators !");
+
+  quantizedMatmulOp(block, "QUANTIZED_XW_PLUS_B", INPUT_VARIABLE(0), INPUT_VARIABLE(1), INPUT_VARIABLE(2),
+                    INPUT_VARIABLE(3), INPUT_VARIABLE(4), INPUT_VARIABLE(5), INPUT_VARIABLE(6), z);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(quantized_xw_plus_b) {
+  getOpDescriptor()
+      ->setAllowedInputTypes(0, {sd::DataType::INT8, sd::DataType::UINT8})
+      ->setAllowedInputTypes(1, {sd::DataType::INT8})
+      ->setAllowedInputTypes(2, {ALL_FLOATS})
+      ->setAllowedInputTypes(3, {ALL_FLOATS})
+      ->setAllowedInputTypes(4, {ALL_INTS})
+      ->setAllowedInputTypes(5, {ALL_FLOATS})
+      ->setAllowedInputTypes(6, {ALL_INTS})
+      ->setAllowedOutputTypes({ALL_FLOATS, sd::DataType::INT8, sd::DataType::UINT8});
+}
+
+DECLARE_SHAPE_FN(quantized_xw_plus_b) {
+  return SHAPELIST(quantizedMatmulShape(block, inputShape->at(0), inputShape->at(1)));
+}
+#endif
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
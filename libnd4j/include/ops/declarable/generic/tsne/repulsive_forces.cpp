@@ -0,0 +1,65 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Barnes-Hut approximation of t-SNE repulsive forces
+//
+
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_barnes_repulsive_forces)
+
+#include <ops/declarable/CustomOperations.h>
+#include <ops/declarable/helpers/BarnesHutTsne.h>
+
+namespace sd {
+namespace ops {
+
+CUSTOM_OP_IMPL(barnes_repulsive_forces, 1, 2, false, -1, 0) {
+  auto data = INPUT_VARIABLE(0);
+  auto theta = block.getTArguments()->size() > 0 ? T_ARG(0) : 0.5;
+
+  auto forces = OUTPUT_VARIABLE(0);
+  auto sumQ = OUTPUT_VARIABLE(1);
+
+  REQUIRE_TRUE(data->rankOf() == 2, 0, "barnes_repulsive_forces: data must be a matrix, but its rank is %i instead !",
+               data->rankOf());
+  REQUIRE_TRUE(data->sizeAt(1) > 0 && data->sizeAt(1) <= 8, 0,
+               "barnes_repulsive_forces: embedding should have from 1 to 8 dimensions, but got %i instead !",
+               (int)data->sizeAt(1));
+  REQUIRE_TRUE(theta >= 0., 0, "barnes_repulsive_forces: theta can't be negative, but got %f instead !", theta);
+
+  helpers::barnes_repulsive_forces(*data, theta, *forces, *sumQ);
+
+  return sd::Status::OK;
+}
+
+DECLARE_TYPES(barnes_repulsive_forces) {
+  getOpDescriptor()->setAllowedInputTypes(0, {ALL_FLOATS})->setAllowedOutputTypes({ALL_FLOATS})->setSameMode(true);
+}
+
+DECLARE_SHAPE_FN(barnes_repulsive_forces) {
+  auto dataShapeInfo = inputShape->at(0);
+  auto sumQShapeInfo = ShapeBuilders::createScalarShapeInfo(ArrayOptions::dataType(dataShapeInfo), block.workspace());
+  return SHAPELIST(CONSTANT(ShapeBuilders::copyShapeInfo(dataShapeInfo, false, block.getWorkspace())),
+                   CONSTANT(sumQShapeInfo));
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
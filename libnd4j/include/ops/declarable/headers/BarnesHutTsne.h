@@ -64,6 +64,24 @@ DECLARE_CUSTOM_OP(barnes_edge_forces, 4, 1, false, 0, 1);
 DECLARE_CUSTOM_OP(barnes_symmetrized, 3, 3, false, 0, -1);
 #endif
 
+/**
+ * This operation used as helper with BarnesHutTsne class
+ * to compute repulsive (non-edge) forces using barnes hut approximation over space-partitioning tree
+ *
+ * Expected input:
+ * 0: 2D float-point matrix with embedding, one point per row, up to 8 columns
+ *
+ * T args:
+ * 0: theta, optional, 0.5 by default. 0 gives exact forces
+ *
+ * Output:
+ * 0: 2D matrix with the same shape and type as input, unnormalized repulsive forces
+ * 1: scalar with sum of q over all pairs of points, forces should be divided by it
+ */
+#if NOT_EXCLUDED(OP_barnes_repulsive_forces)
+DECLARE_CUSTOM_OP(barnes_repulsive_forces, 1, 2, false, -1, 0);
+#endif
+
 /**
  * This operation used as helper with BranesHutTsne class
  * to compute x = x + 2 * yGrads / abs(yGrads) != yIncs / abs(yIncs)
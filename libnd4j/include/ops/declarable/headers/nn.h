@@ -253,6 +253,34 @@ DECLARE_CUSTOM_OP(dot_product_attention_v2, -2, -1, false, -2, 2);
 DECLARE_CUSTOM_OP(dot_product_attention_v2_bp, -2, -3, false, -2, 1);
 #endif
 
+/**
+ * Scaled dot product attention computed block by block with an online softmax, so the [queryCount, timesteps]
+ * scores are never materialized and memory stays linear in sequence length:
+ * out = softmax(scale * q * k^T) * v
+ *
+ * Expected arguments:
+ * q: queries of shape [batchSize, queryCount, featureKeys] or [batchSize, numHeads, queryCount, featureKeys]
+ * k: keys of shape [batchSize, timesteps, featureKeys] or [batchSize, numHeads, timesteps, featureKeys]
+ * v: values of shape [batchSize, timesteps, featureValues] or [batchSize, numHeads, timesteps, featureValues]
+ * mask: OPTIONAL; padding mask of shape [batchSize, timesteps], keys with 0 are skipped
+ *
+ * float input arguments:
+ * 0: OPTIONAL; scale, 1.0 by default
+ *
+ * boolean input arguments:
+ * 0: OPTIONAL; causal, query i only attends to keys 0..i
+ *
+ * Output Arrays:
+ * 0: attention result of shape [batchSize, (numHeads,) queryCount, featureValues], queries with every key masked
+ * get zeros
+ *
+ * The backprop op takes q, k, v, eps and the optional mask, and recomputes the scores block by block.
+ */
+#if NOT_EXCLUDED(OP_fused_dot_product_attention)
+DECLARE_CUSTOM_OP(fused_dot_product_attention, 3, 1, false, -2, 0);
+DECLARE_CUSTOM_OP(fused_dot_product_attention_bp, 4, 3, false, -2, 0);
+#endif
+
 
 /**
  * This performs multi-headed dot product attention on the given timeseries input
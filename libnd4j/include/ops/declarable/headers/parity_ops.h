@@ -847,6 +847,34 @@ DECLARE_CUSTOM_OP(moments, 1, 2, false, 0, -2);
 DECLARE_CUSTOM_OP(embedding_lookup, 2, 1, false, 0, 1);
 #endif
 
+/**
+ * embedding_bag - gathers rows of embedding table and reduces them per bag in a single pass, without materializing
+ * the [numIndices, dim] lookup.
+ *
+ * Input arrays:
+ * 0: table of shape [numRows, dim]
+ * 1: indices - vector of table rows to look up
+ * 2: offsets - vector of [numBags] non-decreasing start positions of bags in indices, or with segment ids mode
+ *    vector of bag ids, one per index
+ * 3: OPTIONAL; per sample weights - vector of the same length as indices, sum mode only
+ *
+ * Int arguments:
+ * 0: OPTIONAL; mode: 0 - sum (default), 1 - mean, 2 - max
+ * 1: OPTIONAL; 1 - input 2 holds segment ids instead of offsets
+ * 2: OPTIONAL; number of bags for segment ids mode, largest id + 1 by default
+ *
+ * Output array:
+ * 0: [numBags, dim], empty bags get zeros
+ *
+ * The backprop op takes the same inputs followed by eps [numBags, dim] and returns sparse gradient of the table:
+ * distinct indices in ascending order (INT64) and gradient rows [numUnique, dim] for them, plus gradient of per
+ * sample weights if they were given.
+ */
+#if NOT_EXCLUDED(OP_embedding_bag)
+DECLARE_CUSTOM_OP(embedding_bag, 3, 1, false, 0, -2);
+DECLARE_CUSTOM_OP(embedding_bag_bp, 4, 2, false, 0, -2);
+#endif
+
 /**
  * dynamic_partition - partition a input tensor onto num_partitions
  * accordingly to index array given.
@@ -1806,6 +1834,38 @@ DECLARE_CUSTOM_OP(non_max_suppression_v3, 2, 1, false, 0, 0);
 DECLARE_CUSTOM_OP(non_max_suppression_overlaps, 2, 1, false, 0, 0);
 #endif
 
+/*
+ * image.combined_non_max_suppression op - greedy non max suppression for every class of every batch element, results
+ * of all classes are merged by score.
+ * input:
+ *     0 - boxes - 4D-tensor with shape (batch, num_boxes, q, 4) or 3D-tensor with shape (batch, num_boxes, 4) by float
+ * type, q is either 1 (boxes are shared by all classes) or num_classes
+ *     1 - scores - 3D-tensor with shape (batch, num_boxes, num_classes) by float type
+ *     2 - max_output_size_per_class - 0D-tensor by int type (optional)
+ *     3 - max_total_size - 0D-tensor by int type (optional)
+ *     4 - overlap_threshold - 0D-tensor by float type (optional)
+ *     5 - score_threshold - 0D-tensor by float type (optional)
+ * float args:
+ *     0 - overlap_threshold - (optional, by default 0.5)
+ *     1 - score_threshold - (optional, by default -inf)
+ * int args:
+ *     0 - max_output_size_per_class - used when input 2 is absent
+ *     1 - max_total_size - used when input 3 is absent
+ * bool args:
+ *     0 - pad_per_class - if true, number of detections is min(max_total_size, max_output_size_per_class * num_classes)
+ * (optional, by default false)
+ *     1 - clip_boxes - clip output boxes to [0, 1] (optional, by default true)
+ *
+ * output:
+ *     0 - nmsed_boxes - 3D-tensor with shape (batch, max_detections, 4)
+ *     1 - nmsed_scores - 2D-tensor with shape (batch, max_detections)
+ *     2 - nmsed_classes - 2D-tensor with shape (batch, max_detections)
+ *     3 - valid_detections - 1D-tensor with shape (batch) by int type
+ * */
+#if NOT_EXCLUDED(OP_combined_non_max_suppression)
+DECLARE_CUSTOM_OP(combined_non_max_suppression, 2, 4, false, 0, 0);
+#endif
+
 /*
  * cholesky op - decomposite positive square symetric matrix (or matricies when rank > 2).
  * input:
@@ -0,0 +1,153 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Affine int8 quantization and integer inference ops
+//
+
+#ifndef LIBND4J_HEADERS_QUANTIZATION_H
+#define LIBND4J_HEADERS_QUANTIZATION_H
+#include <ops/declarable/headers/common.h>
+
+namespace sd {
+namespace ops {
+
+/**
+ * quantize_linear: q = saturate(round(x / scale) + zeroPoint), rounding half to even
+ *
+ * Input arrays:
+ *    0 - floating point input
+ *    1 - scale: scalar (per-tensor) or vector with one value per slice along axis (per-channel)
+ *    2 - zero point, same length as scale
+ *
+ * Int arguments:
+ *    0 - optional channel axis for per-channel parameters, default 1
+ *
+ * Data type arguments:
+ *    0 - optional output type: INT8 (default), UINT8 or INT32
+ *
+ * Output:
+ *    0 - quantized array with the same shape as input
+ */
+#if NOT_EXCLUDED(OP_quantize_linear)
+DECLARE_CUSTOM_OP(quantize_linear, 3, 1, false, 0, 0);
+#endif
+
+/**
+ * dequantize_linear: x = (q - zeroPoint) * scale
+ *
+ * Input arrays:
+ *    0 - INT8, UINT8 or INT32 input
+ *    1 - scale: scalar (per-tensor) or vector with one value per slice along axis (per-channel)
+ *    2 - zero point, same length as scale
+ *
+ * Int arguments:
+ *    0 - optional channel axis for per-channel parameters, default 1
+ *
+ * Data type arguments:
+ *    0 - optional floating point output type, scale type by default
+ *
+ * Output:
+ *    0 - dequantized array with the same shape as input
+ */
+#if NOT_EXCLUDED(OP_dequantize_linear)
+DECLARE_CUSTOM_OP(dequantize_linear, 3, 1, false, 0, 0);
+#endif
+
+/**
+ * quantized_matmul: matrix product of quantized x and w with int32 accumulation
+ *
+ * Input arrays:
+ *    0 - x [M, K], INT8 or UINT8
+ *    1 - w [K, N], INT8
+ *    2 - x scale, scalar
+ *    3 - x zero point, scalar
+ *    4 - w scale: scalar or [N] for per-output-channel quantized weights
+ *    5 - w zero point: scalar or [N]
+ *
+ * Int arguments:
+ *    0 - optional, 1 to transpose x
+ *    1 - optional, 1 to transpose w
+ *
+ * Float arguments, used for INT8/UINT8 output only:
+ *    0 - output scale
+ *    1 - optional output zero point, default 0
+ *
+ * Data type arguments:
+ *    0 - optional output type:
+ *        floating point (FLOAT32 by default) - dequantized product
+ *        INT8/UINT8 - product requantized with output scale/zero point
+ *        INT32 - raw accumulators (x - x zero point)(w - w zero point)
+ *
+ * Output:
+ *    0 - [M, N]
+ */
+#if NOT_EXCLUDED(OP_quantized_matmul)
+DECLARE_CUSTOM_OP(quantized_matmul, 6, 1, false, -2, -2);
+#endif
+
+/**
+ * quantized_xw_plus_b: quantized_matmul with floating point bias added before requantization
+ *
+ * Input arrays:
+ *    0 - x [M, K], INT8 or UINT8
+ *    1 - w [K, N], INT8
+ *    2 - bias [N], floating point
+ *    3 - x scale, scalar
+ *    4 - x zero point, scalar
+ *    5 - w scale: scalar or [N]
+ *    6 - w zero point: scalar or [N]
+ *
+ * Int, float and data type arguments are the same as for quantized_matmul, INT32 output isn't allowed.
+ *
+ * Output:
+ *    0 - [M, N]
+ */
+#if NOT_EXCLUDED(OP_quantized_xw_plus_b)
+DECLARE_CUSTOM_OP(quantized_xw_plus_b, 7, 1, false, -2, -2);
+#endif
+
+/**
+ * quantized_conv2d: 2D convolution of quantized input with int8 weights
+ *
+ * Input arrays:
+ *    0 - input [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW), INT8 or UINT8
+ *    1 - weights [kH, kW, iC, oC], [oC, iC, kH, kW] or [oC, kH, kW, iC], INT8
+ *    2 - input scale, scalar
+ *    3 - input zero point, scalar
+ *    4 - weights scale: scalar or [oC]
+ *    5 - weights zero point: scalar or [oC]
+ *    6 - optional bias [oC], floating point
+ *
+ * Int arguments are the same as for conv2d:
+ *    0,1 - kernel height/width, 2,3 - strides, 4,5 - paddings, 6,7 - dilations, 8 - 0 VALID / 1 SAME,
+ *    9 - optional 0 NCHW (default) / 1 NHWC, 10 - optional weights format 0 / 1 / 2
+ *
+ * Float and data type arguments are the same as for quantized_matmul.
+ *
+ * Output:
+ *    0 - [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW)
+ */
+#if NOT_EXCLUDED(OP_quantized_conv2d)
+DECLARE_CUSTOM_OP(quantized_conv2d, 6, 1, false, -2, 9);
+#endif
+
+}  // namespace ops
+}  // namespace sd
+
+#endif
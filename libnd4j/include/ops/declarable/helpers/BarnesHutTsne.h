@@ -35,6 +35,7 @@ SD_LIB_HIDDEN void barnes_symmetrize(const NDArray* rowP, const NDArray* colP, c
                                      NDArray* rowCounts = nullptr);
 SD_LIB_HIDDEN void barnes_edge_forces(const NDArray* rowP, NDArray const* colP, NDArray const* valP, int N,
                                       NDArray* output, NDArray const& data);
+SD_LIB_HIDDEN void barnes_repulsive_forces(const NDArray& data, const double theta, NDArray& forces, NDArray& sumQ);
 SD_LIB_HIDDEN void barnes_gains(NDArray* input, NDArray* gradX, NDArray* epsilon, NDArray* output);
 SD_LIB_HIDDEN bool cell_contains(NDArray* corner, NDArray* width, NDArray* point, sd::LongType dimension);
 
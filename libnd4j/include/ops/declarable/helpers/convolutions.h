@@ -289,6 +289,19 @@ class SD_LIB_HIDDEN ConvolutionUtils {
                       const sd::LongType sH, const sd::LongType sW, LongType pH, LongType pW, const sd::LongType dH, const sd::LongType dW, const int paddingMode,
                       const int isNCHW, const int wFormat);
 
+  static void conv3d(sd::graph::Context& block, const NDArray* input, const NDArray* weights, const NDArray* bias,
+                     NDArray* output, const sd::LongType kD, const sd::LongType kH, const sd::LongType kW,
+                     const sd::LongType sD, const sd::LongType sH, const sd::LongType sW, const sd::LongType pD,
+                     const sd::LongType pH, const sd::LongType pW, const sd::LongType dD, const sd::LongType dH,
+                     const sd::LongType dW, const int isNCDHW, const int wFormat);
+
+  static void conv3dBP(sd::graph::Context& block, const NDArray* input, const NDArray* weights, const NDArray* bias,
+                       const NDArray* gradO, NDArray* gradI, NDArray* gradW, NDArray* gradB, const sd::LongType kD,
+                       const sd::LongType kH, const sd::LongType kW, const sd::LongType sD, const sd::LongType sH,
+                       const sd::LongType sW, const sd::LongType pD, const sd::LongType pH, const sd::LongType pW,
+                       const sd::LongType dD, const sd::LongType dH, const sd::LongType dW, const int isNCDHW,
+                       const int wFormat);
+
   static void vol2col(sd::graph::Context& block, const NDArray& vol, NDArray& col, const sd::LongType sD, const sd::LongType sH,
                       const sd::LongType sW, const sd::LongType pD, const sd::LongType pH, const sd::LongType pW, const sd::LongType dD, const sd::LongType dH, const sd::LongType dW);
 
@@ -22,87 +22,192 @@
 #include <execution/Threads.h>
 #include <ops/declarable/helpers/BarnesHutTsne.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
 namespace sd {
 namespace ops {
 namespace helpers {
 
-sd::LongType barnes_row_count(const NDArray* rowP, const NDArray* colP, sd::LongType N, NDArray& rowCounts) {
-  int* pRowCounts = reinterpret_cast<int*>(rowCounts.buffer());
-  int const* pRows = reinterpret_cast<int const*>(rowP->buffer());
-  int const* pCols = reinterpret_cast<int const*>(colP->buffer());
+// integer views over rowP/colP, casting only when they aren't dense int32 already
+static const NDArray* barnes_dense_ints(const NDArray* array) {
+  if (array->dataType() == DataType::INT32 && array->ews() == 1) return array;
+
+  return new NDArray(array->cast(DataType::INT32).dup('c'));
+}
+
+// pattern of the transposed matrix: for every column c, (edge index, source row) of all edges n -> c.
+// Entries of a column are ordered by edge index, and so by source row as well.
+static sd::LongType barnes_transpose(const int* pRows, const int* pCols, const sd::LongType N, std::vector<int>& tRows,
+                                     std::vector<std::pair<int, int>>& tEdges) {
+  std::unique_ptr<std::atomic<int>[]> cursor(new std::atomic<int>[N]);
+  for (sd::LongType n = 0; n < N; n++) cursor[n].store(0, std::memory_order_relaxed);
+
+  auto countFunc = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++)
+      if (pCols[i] >= 0 && pCols[i] < N) cursor[pCols[i]].fetch_add(1, std::memory_order_relaxed);
+  };
+  samediff::Threads::parallel_for(countFunc, pRows[0], pRows[N]);
+
+  tRows.resize(N + 1);
+  tRows[0] = 0;
   for (sd::LongType n = 0; n < N; n++) {
-    int begin = pRows[n];    //->e<int>(n);
-    int end = pRows[n + 1];  // rowP->e<int>(n + 1);
-    for (int i = begin; i < end; i++) {
-      bool present = false;
-      for (int m = pRows[pCols[i]]; m < pRows[pCols[i] + 1]; m++)
-        if (pCols[m] == n) {
-          present = true;
-          break;
-        }
+    tRows[n + 1] = tRows[n] + cursor[n].load(std::memory_order_relaxed);
+    cursor[n].store(tRows[n], std::memory_order_relaxed);
+  }
+
+  tEdges.resize(tRows[N]);
+  auto fillFunc = PRAGMA_THREADS_FOR {
+    for (auto n = start; n < stop; n++)
+      for (int i = pRows[n]; i < pRows[n + 1]; i++)
+        if (pCols[i] >= 0 && pCols[i] < N)
+          tEdges[cursor[pCols[i]].fetch_add(1, std::memory_order_relaxed)] = std::make_pair(i, static_cast<int>(n));
+  };
+  samediff::Threads::parallel_for(fillFunc, 0, N);
+
+  auto sortFunc = PRAGMA_THREADS_FOR {
+    for (auto n = start; n < stop; n++) std::sort(tEdges.begin() + tRows[n], tEdges.begin() + tRows[n + 1]);
+  };
+  samediff::Threads::parallel_for(sortFunc, 0, N);
 
-      ++pRowCounts[n];
+  return tRows[N];
+}
+
+// merges row r of P with row r of P^T, calling emit(key, column, firstEdge, secondEdge) for every column of the
+// symmetrized row. secondEdge is -1 unless both P(r, c) and P(c, r) exist. key is the index of the edge that the serial
+// algorithm would have met first, so sorting by it reproduces the serial column order.
+template <typename F>
+static void barnes_merge_row(const sd::LongType r, const int* pRows, const int* pCols, const std::vector<int>& tRows,
+                             const std::vector<std::pair<int, int>>& tEdges, std::vector<int>& own, F&& emit) {
+  own.resize(pRows[r + 1] - pRows[r]);
+  for (int i = pRows[r]; i < pRows[r + 1]; i++) own[i - pRows[r]] = i;
+  std::sort(own.begin(), own.end(), [pCols](const int a, const int b) {
+    return pCols[a] < pCols[b] || (pCols[a] == pCols[b] && a < b);
+  });
+
+  const auto ownLength = static_cast<int>(own.size());
+  const auto rev = tEdges.data() + tRows[r];
+  const auto revLength = tRows[r + 1] - tRows[r];
+  const int sentinel = std::numeric_limits<int>::max();
+
+  int i = 0, j = 0;
+  while (i < ownLength || j < revLength) {
+    const int ownCol = i < ownLength ? pCols[own[i]] : sentinel;
+    const int revCol = j < revLength ? rev[j].second : sentinel;
+
+    if (ownCol == revCol) {
+      emit(r <= ownCol ? own[i] : rev[j].first, ownCol, own[i], rev[j].first);
+      i++;
+      j++;
+    } else if (ownCol < revCol) {
+      emit(own[i], ownCol, own[i], -1);
+      i++;
+    } else {
+      emit(rev[j].first, revCol, rev[j].first, -1);
+      j++;
+    }
+  }
+}
+
+sd::LongType barnes_row_count(const NDArray* rowP, const NDArray* colP, sd::LongType N, NDArray& rowCounts) {
+  auto rows = barnes_dense_ints(rowP);
+  auto cols = barnes_dense_ints(colP);
+  auto pRows = rows->bufferAsT<int>();
+  auto pCols = cols->bufferAsT<int>();
+
+  std::vector<int> tRows;
+  std::vector<std::pair<int, int>> tEdges;
+  barnes_transpose(pRows, pCols, N, tRows, tEdges);
 
-      if (!present) ++pRowCounts[pCols[i]];
+  std::vector<sd::LongType> counts(N);
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<int> own;
+    for (auto n = start; n < stop; n++) {
+      sd::LongType count = 0;
+      barnes_merge_row(n, pRows, pCols, tRows, tEdges, own, [&count](int, int, int, int) { count++; });
+      counts[n] = count;
     }
+  };
+  samediff::Threads::parallel_for(func, 0, N);
+
+  sd::LongType numElements = 0;
+  const bool dense = rowCounts.dataType() == DataType::INT32 && rowCounts.ews() == 1;
+  for (sd::LongType n = 0; n < N; n++) {
+    if (dense)
+      rowCounts.bufferAsT<int>()[n] = static_cast<int>(counts[n]);
+    else
+      rowCounts.p<sd::LongType>(n, counts[n]);
+    numElements += counts[n];
   }
-  NDArray numElementsArr = rowCounts.sumNumber();
-  auto numElements = numElementsArr.e<sd::LongType>(0);
+
+  if (rows != rowP) delete rows;
+  if (cols != colP) delete cols;
+
   return numElements;
 }
 
 template <typename T>
 static void barnes_symmetrize_(const NDArray* rowP, const NDArray* colP, const NDArray* valP, sd::LongType N,
                                NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts) {
+  auto rows = barnes_dense_ints(rowP);
+  auto cols = barnes_dense_ints(colP);
+  auto pRows = rows->bufferAsT<int>();
+  auto pCols = cols->bufferAsT<int>();
 
-  int const* pRows = reinterpret_cast<int const*>(rowP->buffer());
-  int* symRowP = reinterpret_cast<int*>(outputRows->buffer());
+  std::vector<int> tRows;
+  std::vector<std::pair<int, int>> tEdges;
+  barnes_transpose(pRows, pCols, N, tRows, tEdges);
+
+  int* symRowP = outputRows->bufferAsT<int>();
   symRowP[0] = 0;
-  for (sd::LongType n = 0; n < N; n++) symRowP[n + 1] = symRowP[n] + rowCounts->e<int>(n);
+  if (rowCounts != nullptr) {
+    const NDArray* counts = barnes_dense_ints(rowCounts);
+    auto pCounts = counts->bufferAsT<int>();
+    for (sd::LongType n = 0; n < N; n++) symRowP[n + 1] = symRowP[n] + pCounts[n];
+    if (counts != rowCounts) delete counts;
+  } else {
+    NDArray counts('c', {N}, DataType::INT32, rowP->getContext());
+    barnes_row_count(rows, cols, N, counts);
+    auto pCounts = counts.bufferAsT<int>();
+    for (sd::LongType n = 0; n < N; n++) symRowP[n + 1] = symRowP[n] + pCounts[n];
+  }
 
-  int* symColP = reinterpret_cast<int*>(outputCols->buffer());
-  int const* pCols = reinterpret_cast<int const*>(colP->buffer());
-  T const* pVals = reinterpret_cast<T const*>(valP->buffer());
-  T* pOutput = reinterpret_cast<T*>(outputVals->buffer());
-  std::vector<int> offset(N);
+  int* symColP = outputCols->bufferAsT<int>();
+  auto pVals = valP->bufferAsT<T>();
+  auto pOutput = outputVals->bufferAsT<T>();
 
-  for (sd::LongType n = 0; n < N; n++) {
-    int begin = pRows[n];
-    int bound = pRows[n + 1];
-
-    for (int i = begin; i < bound; i++) {
-      bool present = false;
-      int colPI = pCols[i];
-      int start = pRows[colPI];
-      int end = pRows[colPI + 1];
-
-      for (int m = start; m < end; m++) {
-        if (pCols[m] == n) {
-          present = true;
-          if (n <= colPI) {
-            symColP[symRowP[n] + offset[n]] = colPI;
-            symColP[symRowP[colPI] + offset[colPI]] = n;
-            pOutput[symRowP[n] + offset[n]] = pVals[i] + pVals[m];
-            pOutput[symRowP[colPI] + offset[colPI]] = pVals[i] + pVals[m];
-          }
-        }
-      }
+  struct Entry {
+    int key;
+    int col;
+    T value;
+  };
 
-      if (!present) {
-        symColP[symRowP[n] + offset[n]] = colPI;
-        symColP[symRowP[pCols[i]] + offset[colPI]] = n;
-        pOutput[symRowP[n] + offset[n]] = pVals[i];
-        pOutput[symRowP[colPI] + offset[colPI]] = pVals[i];
-        //}
-      }
-      // Update offsets
-      if (!present || (present && n <= colPI)) {
-        ++offset[n];
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<int> own;
+    std::vector<Entry> entries;
+    for (auto n = start; n < stop; n++) {
+      entries.clear();
+      barnes_merge_row(n, pRows, pCols, tRows, tEdges, own,
+                       [&entries, pVals](const int key, const int col, const int first, const int second) {
+                         const T value = second < 0 ? pVals[first] : pVals[first] + pVals[second];
+                         entries.push_back({key, col, value});
+                       });
+
+      std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
 
-        if (colPI != n) ++offset[colPI];
+      const auto limit = std::min<sd::LongType>(entries.size(), symRowP[n + 1] - symRowP[n]);
+      for (sd::LongType e = 0; e < limit; e++) {
+        symColP[symRowP[n] + e] = entries[e].col;
+        pOutput[symRowP[n] + e] = entries[e].value;
       }
     }
-  }
+  };
+  samediff::Threads::parallel_for(func, 0, N);
+
+  if (rows != rowP) delete rows;
+  if (cols != colP) delete cols;
 }
 void barnes_symmetrize(const NDArray* rowP, const NDArray* colP, const NDArray* valP, sd::LongType N,
                        NDArray* outputRows, NDArray* outputCols, NDArray* outputVals, NDArray* rowCounts) {
@@ -120,34 +225,54 @@ BUILD_SINGLE_TEMPLATE(template void barnes_symmetrize_,
 template <typename T>
 static void barnes_edge_forces_(const NDArray* rowP, NDArray const* colP, NDArray const* valP, int N,
                                 NDArray const* data, NDArray* output) {
-  T const* dataP = reinterpret_cast<T const*>(data->buffer());
-  T const* vals = reinterpret_cast<T const*>(valP->buffer());
-  T* outputP = reinterpret_cast<T*>(output->buffer());
-  int colCount = data->columns();
+  auto rows = barnes_dense_ints(rowP);
+  auto cols = barnes_dense_ints(colP);
+  auto pRows = rows->bufferAsT<int>();
+  auto pCols = cols->bufferAsT<int>();
 
-  auto rowSize = sizeof(T) * colCount;
+  const NDArray* y = data->ordering() == 'c' && data->ews() == 1 ? data : new NDArray(data->dup('c'));
+  NDArray* z = output->ordering() == 'c' && output->ews() == 1 ? output : new NDArray(output->dup('c'));
+
+  T const* dataP = y->bufferAsT<T>();
+  T const* vals = valP->ews() == 1 ? valP->bufferAsT<T>() : nullptr;
+  std::unique_ptr<NDArray> valsCopy;
+  if (vals == nullptr) {
+    valsCopy.reset(new NDArray(valP->dup('c')));
+    vals = valsCopy->bufferAsT<T>();
+  }
+  T* outputP = z->bufferAsT<T>();
+  const int colCount = y->columns();
 
   auto func = PRAGMA_THREADS_FOR {
     for (auto n = start; n < stop; n++) {
-      int s = rowP->e<int>(n);
-      int end = rowP->e<int>(n + 1);
-      int shift = n * colCount;
-      for (int i = s; i < end; i++) {
-        T const* thisSlice = dataP + colP->e<int>(i) * colCount;
+      T const* thisRow = dataP + n * colCount;
+      T* force = outputP + n * colCount;
+      for (int i = pRows[n]; i < pRows[n + 1]; i++) {
+        T const* thisSlice = dataP + pCols[i] * colCount;
         T res = 1;
 
+        PRAGMA_OMP_SIMD_SUM(res)
         for (int k = 0; k < colCount; k++) {
-          auto tempVal = dataP[shift + k] - thisSlice[k];  // thisSlice[k];
+          auto tempVal = thisRow[k] - thisSlice[k];
           res += tempVal * tempVal;
         }
 
         res = vals[i] / res;
-        for (int k = 0; k < colCount; k++) outputP[shift + k] += ((dataP[shift + k] - thisSlice[k]) * res);
+        PRAGMA_OMP_SIMD
+        for (int k = 0; k < colCount; k++) force[k] += (thisRow[k] - thisSlice[k]) * res;
       }
     }
   };
 
   samediff::Threads::parallel_tad(func, 0, N);
+
+  if (z != output) {
+    output->assign(*z);
+    delete z;
+  }
+  if (y != data) delete y;
+  if (rows != rowP) delete rows;
+  if (cols != colP) delete cols;
 }
 
 void barnes_edge_forces(const NDArray* rowP, NDArray const* colP, NDArray const* valP, int N, NDArray* output,
@@ -162,13 +287,36 @@ BUILD_SINGLE_TEMPLATE(template void barnes_edge_forces_,
 
 template <typename T>
 static void barnes_gains_(NDArray* input, NDArray* gradX, NDArray* epsilon, NDArray* output) {
-  auto gainsInternal = LAMBDA_TTT(x, grad, eps) {
-    T res = sd::math::sd_sign<T, T>(grad) != sd::math::sd_sign<T, T>(eps) ? x + T(.2) : x * T(.8);
-    if (res < .01) res = .01;
-    return res;
+  const bool dense = input->ews() == 1 && gradX->ews() == 1 && epsilon->ews() == 1 && output->ews() == 1 &&
+                     input->ordering() == gradX->ordering() && input->ordering() == epsilon->ordering() &&
+                     input->ordering() == output->ordering() && input->isSameShape(gradX) &&
+                     input->isSameShape(epsilon) && input->isSameShape(output);
+
+  if (!dense) {
+    auto gainsInternal = LAMBDA_TTT(x, grad, eps) {
+      T res = sd::math::sd_sign<T, T>(grad) != sd::math::sd_sign<T, T>(eps) ? x + T(.2) : x * T(.8);
+      if (res < .01) res = .01;
+      return res;
+    };
+
+    input->applyTriplewiseLambda<T>(*gradX, *epsilon, gainsInternal, *output);
+    return;
+  }
+
+  auto x = input->bufferAsT<T>();
+  auto grad = gradX->bufferAsT<T>();
+  auto eps = epsilon->bufferAsT<T>();
+  auto z = output->bufferAsT<T>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    PRAGMA_OMP_SIMD
+    for (auto e = start; e < stop; e++) {
+      T res = sd::math::sd_sign<T, T>(grad[e]) != sd::math::sd_sign<T, T>(eps[e]) ? x[e] + T(.2) : x[e] * T(.8);
+      z[e] = res < T(.01) ? T(.01) : res;
+    }
   };
 
-  input->applyTriplewiseLambda<T>(*gradX, *epsilon, gainsInternal, *output);
+  samediff::Threads::parallel_for(func, 0, input->lengthOf());
 }
 
 void barnes_gains(NDArray* input, NDArray* gradX, NDArray* epsilon, NDArray* output) {
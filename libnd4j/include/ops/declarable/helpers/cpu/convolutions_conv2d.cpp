@@ -26,6 +26,9 @@
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+
+#include "convolutions_implicitGemm.hpp"
+#include "convolutions_winograd.hpp"
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 
 namespace sd {
@@ -62,46 +65,39 @@ static void conv2d_(sd::graph::Context& block, const NDArray* input, const NDArr
 
   sd_debug("ONEDNN is not used for conv2d!\n", 0);
 
-  std::vector<sd::LongType> permutForOutput;
-
-  if (isNCHW)
-    permutForOutput = {0, 3, 1, 2};  // [bS, oH, oW, oC] -> [bS, oC, oH, oW]
-  else
-    input = new NDArray(input->permute({0, 3, 1, 2}));  // [bS, iH, iW, iC] -> [bS, iC, iH, iW] if NHWC
-
-  std::vector<sd::LongType> wAxes;
+  // weights -> [kH, kW, iC, oC]
+  std::vector<sd::LongType> wPermut;
   if (0 == wFormat)
-    wAxes = {0, 1, 2};
+    wPermut = {0, 1, 2, 3};
   else if (1 == wFormat)
-    wAxes = {2, 3, 1};
+    wPermut = {2, 3, 1, 0};
   else
-    wAxes = {1, 2, 3};
-
-  NDArray col('c', {bS, oH, oW, kH, kW, iC}, input->dataType(), input->getContext());
-  NDArray colP = col.permute({0, 5, 3, 4, 1, 2});  // {bS, iC, kH, kW, oH, oW}
-  NDArray mmulResult('f', {bS * oH * oW, oC}, output->dataType(), output->getContext());
-
-  //----- calculation of output -----//
-  auto ctx = block.launchContext();
-  helpers::im2col(
-      *ctx, *input, colP, kH, kW, sH, sW, pH, pW, dH, dW,
-      NDArrayFactory::create(0.f, input->getContext()));  // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-  MmulHelper::tensorDot(&col, weights, &mmulResult, {3, 4, 5}, wAxes,
-                        {});  // [bS, oH, oW, kH, kW, iC] x [kH, kW, iC, oC] = [bS, oH, oW, oC]
-
-  //----- assign outTemp to output  -----//
-  if (isNCHW) {
-    mmulResult.reshapei({bS, oH, oW, oC});
-    mmulResult.permutei(permutForOutput);
+    wPermut = {1, 2, 3, 0};
+
+  NDArray wPacked = implicitGemmPack(*weights, wPermut, input->dataType());
+
+  // patches are packed tile by tile, so no [bS, oH, oW, kH, kW, iC] columns are materialized
+  // and the product is written into output directly whenever its layout allows that
+  const bool direct = output->dataType() == input->dataType() &&
+                      implicitGemmGeometry(*input, *output, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW)
+                          .linearOutput();
+  NDArray* z = direct ? output
+                      : new NDArray('c', output->getShapeAsVector(), input->dataType(), output->getContext());
+
+  // 3x3 stride-1 kernels go through Winograd transform whenever it applies
+  const auto g = implicitGemmGeometry(*input, *z, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+  if (!winogradConv2d<X>(g, *weights, wPacked, input->bufferAsT<X>(), z->bufferAsT<X>()))
+    implicitGemmConv<X>(g, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), z->bufferAsT<X>());
+
+  if (!direct) {
+    output->assign(*z);
+    delete z;
   }
-  output->assign(mmulResult);
 
   //----- add biases if required -----//
   if (bias)
     // output->applyBroadcast(broadcast::Add, {indIOioC}, bias);
     helpers::addBias(block, *output, *bias, *output, isNCHW);
-
-  if (!isNCHW) delete input;
 }
 
 void ConvolutionUtils::conv2d(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
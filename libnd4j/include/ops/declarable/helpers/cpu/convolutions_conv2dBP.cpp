@@ -25,6 +25,8 @@
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+
+#include "convolutions_implicitGemm.hpp"
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 
 namespace sd {
@@ -66,63 +68,57 @@ static void conv2dBP_(sd::graph::Context& block, const NDArray* input, const NDA
 
   sd_debug("MKL-DNN is not used for conv2d_bp!\n", 0);
 
-  std::vector<sd::LongType > gradOaxesForDot;
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
 
-  if (!isNCHW) {
-    gradOaxesForDot = {0, 1, 2};                        // bS, oH, oW
-    input = new NDArray(input->permute({0, 3, 1, 2}));  // [bS, iH, iW, iC] -> [bS, iC, iH, iW]
-    gradI = new NDArray(gradI->permute({0, 3, 1, 2}));  // [bS, iH, iW, iC] -> [bS, iC, iH, iW]
-  } else {
-    gradOaxesForDot = {0, 2, 3};  // bS, oH, oW
-  }
+  // weights -> [kH, kW, iC, oC]
+  std::vector<sd::LongType> wPermut;
+  if (0 == wFormat)
+    wPermut = {0, 1, 2, 3};
+  else if (1 == wFormat)
+    wPermut = {2, 3, 1, 0};
+  else
+    wPermut = {1, 2, 3, 0};
 
-  std::vector<sd::LongType> wPermut, colPermut;
+  NDArray wPacked = implicitGemmPack(*weights, wPermut, input->dataType());
 
-  if (0 == wFormat) {
-    wPermut = {2, 0, 1, 3};
-    colPermut = {2, 3, 1, 0, 4, 5};
-  } else if (1 == wFormat) {
-    wPermut = {1, 2, 3, 0};
-    colPermut = {1, 2, 3, 0, 4, 5};
-  } else {
-    wPermut = {3, 1, 2, 0};
-    colPermut = {2, 3, 1, 0, 4, 5};
-  }
+  // gradO tiles are read by pixel index, so it has to be c-ordered
+  auto gOGeometry = implicitGemmGeometry(*input, *gradO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+  const bool gradODirect = gradO->dataType() == input->dataType() && gOGeometry.linearOutput();
+  const NDArray* gO = gradODirect ? gradO : new NDArray(implicitGemmPack(*gradO, {0, 1, 2, 3}, input->dataType()));
+  if (!gradODirect)
+    gOGeometry = implicitGemmGeometry(*input, *gO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+
+  NDArray* gI = gradI->dataType() == input->dataType()
+                    ? gradI
+                    : new NDArray('c', gradI->getShapeAsVector(), input->dataType(), gradI->getContext());
+  gI->nullify();
+  const auto gIGeometry = implicitGemmGeometry(*gI, *gO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
 
-  NDArray columns(input->ordering(), {bS, iC, kH, kW, oH, oW}, input->dataType(), input->getContext());
+  // [kH, kW, iC, oC] in accumulator type, no [bS, iC, kH, kW, oH, oW] columns are materialized
+  NDArray gWPacked;
+  if (gradW) gWPacked = NDArray('c', {kH, kW, iC, oC}, DataTypeUtils::fromT<Acc>(), input->getContext());
+
+  implicitGemmConvBP<X>(gOGeometry, gIGeometry, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), gO->bufferAsT<X>(),
+                        gI->bufferAsT<X>(), gradW ? gWPacked.bufferAsT<Acc>() : nullptr);
 
   // ----- calculation of gradW ----- //
-  if (gradW) {
-    auto ctx = block.launchContext();
-    helpers::im2col(*ctx, *input, columns, kH, kW, sH, sW, pH, pW, dH, dW,
-                    NDArrayFactory::create(
-                        0.f, input->getContext()));  // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-    sd::MmulHelper::tensorDot(
-        &columns, gradO, gradW, {0, 4, 5}, gradOaxesForDot,
-        wPermut);  // [bS, iC, kH, kW, oH, oW] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [iC, kH, kW, oC]
-  }
+  if (gradW) gradW->permute(wPermut).assign(gWPacked);
 
   // ----- calculation of gradB ----- //
   if (gradB) {
+    std::vector<sd::LongType> gradOaxesForDot = {0, indOoH, indOoH + 1};  // bS, oH, oW
     NDArray* gradBR = gradB;
     if (gradB->rankOf() == 2) gradBR = new NDArray(gradB->reshape(gradB->ordering(), {gradB->lengthOf()}));
     gradO->reduceAlongDimension(reduce::Sum, *gradBR, &gradOaxesForDot);  // sum over bS, oH, oW
     if (gradBR != gradB) delete gradBR;
   }
 
-  //----- calculation of gradI -----//
-  // [kH, kW, iC, oC] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [kH, kW, iC, bS, oH, oW]
-  // [oC, iC, kH, kW] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [iC, kH, kW, bS, oH, oW]
-  // [oC, kH, kW, iC] x [bS, oH, oW, oC]/[bS, oC, oH, oW] = [kH, kW, iC, bS, oH, oW]
-  sd::MmulHelper::tensorDot(weights, gradO, &columns, {indWoC}, {indIOioC}, colPermut);
-
-  helpers::col2im(*block.launchContext(), columns, *gradI, sH, sW, pH, pW, iH, iW, dH,
-                  dW);  // [bS, iC, kH, kW, oH, oW] is de-convoluted to [bS, iC, iH, iW]
-
-  if (!isNCHW) {
-    delete input;
-    delete gradI;
+  if (gI != gradI) {
+    gradI->assign(*gI);
+    delete gI;
   }
+
+  if (gO != gradO) delete gO;
 }
 
 void ConvolutionUtils::conv2dBP(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
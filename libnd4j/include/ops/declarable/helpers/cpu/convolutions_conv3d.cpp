@@ -0,0 +1,146 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// conv3d/conv3d_bp without materialized [bS, iC, kD, kH, kW, oD, oH, oW] columns
+//
+#include <ops/declarable/helpers/addBias.h>
+#include <ops/declarable/helpers/convolutions.h>
+
+#include "convolutions_implicitGemm.hpp"
+
+namespace sd {
+namespace ops {
+
+// weights -> [kD, kH, kW, iC, oC]
+static std::vector<sd::LongType> conv3dWeightsPermut(const int wFormat) {
+  if (0 == wFormat) return {0, 1, 2, 3, 4};
+  if (1 == wFormat) return {2, 3, 4, 1, 0};
+  return {1, 2, 3, 4, 0};
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void conv3d_(sd::graph::Context& block, const NDArray* input, const NDArray* weights, const NDArray* bias,
+                    NDArray* output, const LongType kD, const LongType kH, const LongType kW, const LongType sD,
+                    const LongType sH, const LongType sW, const LongType pD, const LongType pH, const LongType pW,
+                    const LongType dD, const LongType dH, const LongType dW, const int isNCDHW, const int wFormat) {
+  // input   [bS, iD, iH, iW, iC] (NDHWC) or [bS, iC, iD, iH, iW] (NCDHW)
+  // weights [kD, kH, kW, iC, oC], [oC, iC, kD, kH, kW], [oC, kD, kH, kW, iC]
+  // bias    [oC]
+  // output  [bS, oD, oH, oW, oC] (NDHWC) or [bS, oC, oD, oH, oW] (NCDHW)
+
+  NDArray wPacked = implicitGemmPack(*weights, conv3dWeightsPermut(wFormat), input->dataType());
+
+  const bool direct = output->dataType() == input->dataType() &&
+                      implicitGemmGeometry(*input, *output, isNCDHW, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW)
+                          .linearOutput();
+  NDArray* z = direct ? output
+                      : new NDArray('c', output->getShapeAsVector(), input->dataType(), output->getContext());
+
+  const auto g = implicitGemmGeometry(*input, *z, isNCDHW, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW);
+  implicitGemmConv<X>(g, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), z->bufferAsT<X>());
+
+  if (!direct) {
+    output->assign(*z);
+    delete z;
+  }
+
+  if (bias) helpers::addBias(block, *output, *bias, *output, isNCDHW);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void conv3dBP_(sd::graph::Context& block, const NDArray* input, const NDArray* weights, const NDArray* bias,
+                      const NDArray* gradO, NDArray* gradI, NDArray* gradW, NDArray* gradB, const LongType kD,
+                      const LongType kH, const LongType kW, const LongType sD, const LongType sH, const LongType sW,
+                      const LongType pD, const LongType pH, const LongType pW, const LongType dD, const LongType dH,
+                      const LongType dW, const int isNCDHW, const int wFormat) {
+  // input   [bS, iD, iH, iW, iC] (NDHWC) or [bS, iC, iD, iH, iW] (NCDHW)
+  // weights [kD, kH, kW, iC, oC], [oC, iC, kD, kH, kW], [oC, kD, kH, kW, iC]
+  // gradO   [bS, oD, oH, oW, oC] (NDHWC) or [bS, oC, oD, oH, oW] (NCDHW), epsilon_next
+  // gradI   [bS, iD, iH, iW, iC] (NDHWC) or [bS, iC, iD, iH, iW] (NCDHW), epsilon
+  // gradW   same shape as weights
+  // gradB   [oC]
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
+
+  const auto wPermut = conv3dWeightsPermut(wFormat);
+  NDArray wPacked = implicitGemmPack(*weights, wPermut, input->dataType());
+
+  auto gOGeometry = implicitGemmGeometry(*input, *gradO, isNCDHW, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW);
+  const bool gradODirect = gradO->dataType() == input->dataType() && gOGeometry.linearOutput();
+  const NDArray* gO = gradODirect ? gradO : new NDArray(implicitGemmPack(*gradO, {0, 1, 2, 3, 4}, input->dataType()));
+  if (!gradODirect)
+    gOGeometry = implicitGemmGeometry(*input, *gO, isNCDHW, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW);
+
+  NDArray* gI = gradI->dataType() == input->dataType()
+                    ? gradI
+                    : new NDArray('c', gradI->getShapeAsVector(), input->dataType(), gradI->getContext());
+  gI->nullify();
+  const auto gIGeometry = implicitGemmGeometry(*gI, *gO, isNCDHW, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW);
+
+  NDArray gWPacked;
+  if (gradW) gWPacked = NDArray('c', wPacked.getShapeAsVector(), DataTypeUtils::fromT<Acc>(), input->getContext());
+
+  implicitGemmConvBP<X>(gOGeometry, gIGeometry, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), gO->bufferAsT<X>(),
+                        gI->bufferAsT<X>(), gradW ? gWPacked.bufferAsT<Acc>() : nullptr);
+
+  if (gradW) gradW->permute(wPermut).assign(gWPacked);
+
+  if (gradB) {
+    std::vector<sd::LongType> gradOaxesForDot =
+        isNCDHW ? std::vector<sd::LongType>({0, 2, 3, 4}) : std::vector<sd::LongType>({0, 1, 2, 3});  // bS, oD, oH, oW
+    NDArray* gradBR = gradB;
+    if (gradB->rankOf() == 2) gradBR = new NDArray(gradB->reshape(gradB->ordering(), {gradB->lengthOf()}, false));
+    gradO->reduceAlongDimension(reduce::Sum, *gradBR, &gradOaxesForDot);
+    if (gradBR != gradB) delete gradBR;
+  }
+
+  if (gI != gradI) {
+    gradI->assign(*gI);
+    delete gI;
+  }
+
+  if (gO != gradO) delete gO;
+}
+
+void ConvolutionUtils::conv3d(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
+                              const NDArray* bias, NDArray* output, const LongType kD, const LongType kH,
+                              const LongType kW, const LongType sD, const LongType sH, const LongType sW,
+                              const LongType pD, const LongType pH, const LongType pW, const LongType dD,
+                              const LongType dH, const LongType dW, const int isNCDHW, const int wFormat) {
+  BUILD_SINGLE_SELECTOR(
+      input->dataType(), conv3d_,
+      (block, input, weights, bias, output, kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW, isNCDHW, wFormat),
+      SD_FLOAT_TYPES);
+}
+
+void ConvolutionUtils::conv3dBP(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
+                                const NDArray* bias, const NDArray* gradO, NDArray* gradI, NDArray* gradW,
+                                NDArray* gradB, const LongType kD, const LongType kH, const LongType kW,
+                                const LongType sD, const LongType sH, const LongType sW, const LongType pD,
+                                const LongType pH, const LongType pW, const LongType dD, const LongType dH,
+                                const LongType dW, const int isNCDHW, const int wFormat) {
+  BUILD_SINGLE_SELECTOR(input->dataType(), conv3dBP_,
+                        (block, input, weights, bias, gradO, gradI, gradW, gradB, kD, kH, kW, sD, sH, sW, pD, pH, pW,
+                         dD, dH, dW, isNCDHW, wFormat),
+                        SD_FLOAT_TYPES);
+}
+
+}  // namespace ops
+}  // namespace sd
@@ -26,6 +26,8 @@
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+
+#include "convolutions_implicitGemm.hpp"
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 namespace sd {
 namespace ops {
@@ -59,46 +61,38 @@ static void depthwiseConv2d_(sd::graph::Context& block, const NDArray* input, co
                                              indIiH, indWiC, indWmC, indWkH, indOoH);
   mC = weights->sizeAt(indWmC);  // channels multiplier
 
-  std::vector<std::vector<sd::LongType>> modifColumns = {
-      {1, 0, 4, 5, 2, 3},
-      {iC, bS * oH * oW, kH * kW}};  // [bS,iC,kH,kW,oH,oW] -> [iC,bS,oH,oW,kH,kW] -> [iC,bS*oH*oW,kH*kW]
-  std::vector<std::vector<sd::LongType>> modifOutput, modifWeights;
-  std::vector<sd::LongType> outReShape;
-
-  if (!isNCHW) {
-    outReShape = {bS, oH, oW, iC, mC};  // [bS,oH,oW,iC*mC] -> [bS,oH,oW,iC,mC]
-    modifOutput = {{3, 0, 1, 2, 4},
-                   {iC, bS * oH * oW, mC}};             // [bS,oH,oW,iC,mC] -> [iC,bS,oH,oW,mC] -> [iC,bS*oH*oW,mC]
-    input = new NDArray(input->permute({0, 3, 1, 2}));  // [bS,iH,iW,iC]    -> [bS,iC,iH,iW]
-  } else {
-    outReShape = {bS, iC, mC, oH, oW};  // [bS,iC*mC,oH,oW] -> [bS,iC,mC,oH,oW]
-    modifOutput = {{1, 0, 3, 4, 2},
-                   {iC, bS * oH * oW, mC}};  // [bS,iC,mC,oH,oW] -> [iC,bS,oH,oW,mC] -> [iC,bS*oH*oW,mC]
-  }
-
+  // weights -> [iC, kH, kW, mC]
+  std::vector<sd::LongType> wPermut;
   if (0 == wFormat)
-    modifWeights = {{2, 0, 1, 3}, {iC, kH * kW, mC}};
+    wPermut = {2, 0, 1, 3};
   else if (1 == wFormat)
-    modifWeights = {{1, 2, 3, 0}, {iC, kH * kW, mC}};
+    wPermut = {1, 2, 3, 0};
   else
-    modifWeights = {{3, 1, 2, 0}, {iC, kH * kW, mC}};
+    wPermut = {3, 1, 2, 0};
 
   if (paddingMode == 1)  // SAME
     ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW);
 
-  NDArray columns(input->ordering(), {bS, iC, kH, kW, oH, oW}, input->dataType(), input->getContext());
-  NDArray outputReshaped = output->reshape(output->ordering(), outReShape, false);
+  NDArray wPacked = implicitGemmPack(*weights, wPermut, input->dataType());
 
-  helpers::im2col(
-      *output->getContext(), *input, columns, kH, kW, sH, sW, pH, pW, dH, dW,
-      NDArrayFactory::create(0.f, input->getContext()));  // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-  MmulHelper::tensorDot(&columns, weights, &outputReshaped, modifColumns, modifWeights,
-                        modifOutput);  // [iC, bS*oH*oW, kW*kH] x [iC, kH*kW, mC] = [iC, bS*oH*oW, mC]
+  // every output channel depends on a single input channel, so it's computed directly, without im2col columns,
+  // output pixels are addressed linearly, so other layouts go through a c-ordered temporary
+  const bool direct = output->dataType() == input->dataType() &&
+                      implicitGemmGeometry(*input, *output, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW)
+                          .linearOutput();
+  NDArray* z = direct ? output
+                      : new NDArray('c', output->getShapeAsVector(), input->dataType(), output->getContext());
+
+  const auto g = implicitGemmGeometry(*input, *z, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+  depthwiseConvDirect<X>(g, mC, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), z->bufferAsT<X>());
+
+  if (!direct) {
+    output->assign(*z);
+    delete z;
+  }
 
   if (bias)
     helpers::addBias(block, *output, *bias, *output, isNCHW);
-
-  if (!isNCHW) delete input;
 }
 
 void ConvolutionUtils::depthwiseConv2d(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
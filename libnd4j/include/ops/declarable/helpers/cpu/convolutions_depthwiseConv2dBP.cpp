@@ -24,6 +24,8 @@
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
 #include <ops/declarable/helpers/im2col.h>
+
+#include "convolutions_implicitGemm.hpp"
 #if NOT_EXCLUDED(OP_col2im) && NOT_EXCLUDED(OP_im2col)
 
 namespace sd {
@@ -61,45 +63,41 @@ static void depthwiseConv2dBP_(const NDArray* input, const NDArray* weights, con
                                              indIiH, indWiC, indWmC, indWkH, indOoH);
   mC = weights->sizeAt(indWmC);  // channels multiplier
 
-  std::vector<std::vector<sd::LongType>> modifColumns = {
-      {1, 2, 3, 0, 4, 5}, {iC, kH * kW, bS * oH * oW}};  // [bS,iC,kH,kW,oH,oW] -> [iC, kH*kW, bS*oH*oW]
-  std::vector<std::vector<sd::LongType>> modifGradO1, modifGradO2, modifWeights;
-  std::vector<sd::LongType> gradOreShape;
-
-  if (!isNCHW) {
-    gradOreShape = {bS, oH, oW, iC, mC};  // [bS,oH,oW,iC*mC] -> [bS,oH,oW,iC,mC]
-    modifGradO1 = {{3, 0, 1, 2, 4},
-                   {iC, bS * oH * oW, mC}};                // [bS,oH,oW,iC,mC] -> [iC,bS,oH,oW,mC] -> [iC,bS*oH*oW,mC]
-    modifGradO2 = {{3, 0, 1, 2}, {iC, mC, bS * oH * oW}};  // [bS,oH,oW,iC*mC] -> [iC*mC,bS,oH,oW] -> [iC,mC,bS*oH*oW]
-    input = new NDArray(input->permute({0, 3, 1, 2}));     // [bS,iH,iW,iC]    -> [bS,iC,iH,iW]
-    gradI = new NDArray(gradI->permute({0, 3, 1, 2}));     // [bS,iH,iW,iC]    -> [bS,iC,iH,iW]
-  } else {
-    gradOreShape = {bS, iC, mC, oH, oW};  // [bS,iC*mC,oH,oW] -> [bS,iC,mC,oH,oW]
-    modifGradO1 = {{1, 0, 3, 4, 2},
-                   {iC, bS * oH * oW, mC}};                // [bS,iC,mC,oH,oW] -> [iC,bS,oH,oW,mC] -> [iC,bS*oH*oW,mC]
-    modifGradO2 = {{1, 0, 2, 3}, {iC, mC, bS * oH * oW}};  // [bS,iC*mC,oH,oW] -> [iC*mC,bS,oH,oW] -> [iC,mC,bS*oH*oW]
-  }
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
 
+  // weights -> [iC, kH, kW, mC]
+  std::vector<sd::LongType> wPermut;
   if (0 == wFormat)
-    modifWeights = {{2, 0, 1, 3}, {iC, kH * kW, mC}};
+    wPermut = {2, 0, 1, 3};
   else if (1 == wFormat)
-    modifWeights = {{1, 2, 3, 0}, {iC, kH * kW, mC}};
+    wPermut = {1, 2, 3, 0};
   else
-    modifWeights = {{3, 1, 2, 0}, {iC, kH * kW, mC}};
+    wPermut = {3, 1, 2, 0};
 
   if (paddingMode == 1)  // SAME
     ConvolutionUtils::calcPadding2D(pH, pW, oH, oW, iH, iW, kH, kW, sH, sW, dH, dW);
 
-  NDArray columns(input->ordering(), {bS, iC, kH, kW, oH, oW}, input->dataType(), input->getContext());
-  NDArray gradOreshaped = gradO->reshape(gradO->ordering(), gradOreShape);
+  NDArray wPacked = implicitGemmPack(*weights, wPermut, input->dataType());
+  NDArray gWPacked('c', {iC, kH, kW, mC}, DataTypeUtils::fromT<Acc>(), input->getContext());
+
+  // gradO pixels are read by linear index, so it has to be c-ordered
+  const bool gradODirect =
+      gradO->dataType() == input->dataType() &&
+      implicitGemmGeometry(*input, *gradO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW).linearOutput();
+  const NDArray* gO = gradODirect ? gradO : new NDArray(implicitGemmPack(*gradO, {0, 1, 2, 3}, input->dataType()));
+  NDArray* gI = gradI->dataType() == input->dataType()
+                    ? gradI
+                    : new NDArray('c', gradI->getShapeAsVector(), input->dataType(), gradI->getContext());
+  gI->nullify();
 
-  // ----- calculation of gradW and gradB ----- //
+  // work is split over input channels, so neither columns nor per-thread copies of gradients are needed
+  const auto g = implicitGemmGeometry(*input, *gO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+  const auto gIGeometry = implicitGemmGeometry(*gI, *gO, isNCHW, 1, kH, kW, 1, sH, sW, 0, pH, pW, 1, dH, dW);
+  depthwiseConvDirectBP<X>(g, gIGeometry, mC, input->bufferAsT<X>(), wPacked.bufferAsT<X>(), gO->bufferAsT<X>(),
+                           gI->bufferAsT<X>(), gWPacked.bufferAsT<Acc>());
 
-  helpers::im2col(
-      *input->getContext(), *input, columns, kH, kW, sH, sW, pH, pW, dH, dW,
-      NDArrayFactory::create(0.f, input->getContext()));  // [bS, iC, iH, iW] is convoluted to [bS, iC, kH, kW, oH, oW]
-  sd::MmulHelper::tensorDot(&columns, &gradOreshaped, gradW, modifColumns, modifGradO1,
-                            modifWeights);  // [iC, kW*kH, bS*oH*oW] x [iC, bS*oH*oW, mC] = [iC, kH*kW, mC]
+  // ----- calculation of gradW ----- //
+  gradW->permute(wPermut).assign(gWPacked);
 
   // ----- calculation of gradB ----- //
   if (gradB) {
@@ -111,16 +109,12 @@ static void depthwiseConv2dBP_(const NDArray* input, const NDArray* weights, con
     if (gradBR != gradB) delete gradBR;
   }
 
-  //----- calculation of gradI -----//
-  sd::MmulHelper::tensorDot(weights, gradO, &columns, modifWeights, modifGradO2,
-                            modifColumns);  // [iC, kH*kW, mC] x [iC, mC, bS*oH*oW] = [iC, kW*kH, bS*oH*oW]
-  helpers::col2im(*input->getContext(), columns, *gradI, sH, sW, pH, pW, iH, iW, dH,
-                  dW);  // [bS, iC, kH, kW, oH, oW] is de-convoluted to [bS, iC, iH, iW]
-
-  if (!isNCHW) {
-    delete input;
-    delete gradI;
+  if (gI != gradI) {
+    gradI->assign(*gI);
+    delete gI;
   }
+
+  if (gO != gradO) delete gO;
 }
 
 void ConvolutionUtils::depthwiseConv2dBP(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
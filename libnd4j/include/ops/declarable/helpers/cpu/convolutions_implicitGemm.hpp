@@ -0,0 +1,382 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Convolutions without materialized im2col/vol2col columns.
+//
+// Output pixels of every sample are processed in tiles: input patches of one tile are packed into a small
+// [tile, kD*kH*kW*iC] buffer (sized to stay in L2) and multiplied by weights packed as [kD*kH*kW*iC, oC],
+// the product is written straight into output. Backprop reuses the same tiles: gradW is accumulated per thread from
+// packed patches, gradI is produced tile by tile and scattered back into the input gradient.
+// 2d convolutions are handled as 3d ones with unit depth.
+//
+#ifndef LIBND4J_CONVOLUTIONS_IMPLICITGEMM_HPP
+#define LIBND4J_CONVOLUTIONS_IMPLICITGEMM_HPP
+
+#include <array/NDArray.h>
+#include <execution/Threads.h>
+#include <ops/impl/gemm_packed.hpp>
+#include <system/Environment.h>
+
+#include <vector>
+
+namespace sd {
+namespace ops {
+
+struct ImplicitGemmConvGeometry {
+  sd::LongType bS, iC, iD, iH, iW, oC, oD, oH, oW;
+  sd::LongType kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW;
+  // strides of input (or gradI): batch, channel, depth, height, width
+  sd::LongType ibS, icS, idS, ihS, iwS;
+  // strides of output (or gradO)
+  sd::LongType obS, ocS, odS, ohS, owS;
+
+  sd::LongType patchLength() const { return kD * kH * kW * iC; }
+  sd::LongType pixels() const { return oD * oH * oW; }
+
+  // output pixels of a sample are addressed as p * owS, this holds for any c-ordered NC(D)HW and N(D)HWC array
+  bool linearOutput() const { return oW * owS == ohS && (oD == 1 || oH * ohS == odS); }
+};
+
+/**
+ * Builds geometry for rank 4 (2d) or rank 5 (3d) input/output arrays, strides are taken from the arrays as they are,
+ * so NHWC and NCHW layouts are handled without permuting copies.
+ */
+static ImplicitGemmConvGeometry implicitGemmGeometry(const NDArray& input, const NDArray& output, const bool isNC,
+                                                     const sd::LongType kD, const sd::LongType kH, const sd::LongType kW,
+                                                     const sd::LongType sD, const sd::LongType sH, const sd::LongType sW,
+                                                     const sd::LongType pD, const sd::LongType pH, const sd::LongType pW,
+                                                     const sd::LongType dD, const sd::LongType dH, const sd::LongType dW) {
+  ImplicitGemmConvGeometry g;
+  const int rank = input.rankOf();
+  const int cAxis = isNC ? 1 : rank - 1;
+  const int sAxis = isNC ? 2 : 1;  // first spatial axis
+  const bool is3d = rank == 5;
+
+  g.bS = input.sizeAt(0);
+  g.iC = input.sizeAt(cAxis);
+  g.oC = output.sizeAt(cAxis);
+  g.iD = is3d ? input.sizeAt(sAxis) : 1;
+  g.iH = input.sizeAt(sAxis + is3d);
+  g.iW = input.sizeAt(sAxis + is3d + 1);
+  g.oD = is3d ? output.sizeAt(sAxis) : 1;
+  g.oH = output.sizeAt(sAxis + is3d);
+  g.oW = output.sizeAt(sAxis + is3d + 1);
+
+  g.kD = kD; g.kH = kH; g.kW = kW;
+  g.sD = sD; g.sH = sH; g.sW = sW;
+  g.pD = pD; g.pH = pH; g.pW = pW;
+  g.dD = dD; g.dH = dH; g.dW = dW;
+
+  g.ibS = input.strideAt(0);
+  g.icS = input.strideAt(cAxis);
+  g.ihS = input.strideAt(sAxis + is3d);
+  g.iwS = input.strideAt(sAxis + is3d + 1);
+  g.idS = is3d ? input.strideAt(sAxis) : g.iH * g.ihS;
+
+  g.obS = output.strideAt(0);
+  g.ocS = output.strideAt(cAxis);
+  g.ohS = output.strideAt(sAxis + is3d);
+  g.owS = output.strideAt(sAxis + is3d + 1);
+  g.odS = is3d ? output.strideAt(sAxis) : g.oH * g.ohS;
+
+  return g;
+}
+
+// dense c-ordered copy of arr permuted by permut, converted to dtype: this is how weights are handed to the kernels
+static NDArray implicitGemmPack(const NDArray& arr, const std::vector<sd::LongType>& permut, const sd::DataType dtype) {
+  NDArray permuted = arr.permute(permut);
+  NDArray packed('c', permuted.getShapeAsVector(), dtype, arr.getContext());
+  packed.assign(permuted);
+  return packed;
+}
+
+// number of output pixels packed at once: patch tile stays in L2, but small problems still give every thread work
+static sd::LongType implicitGemmTile(const ImplicitGemmConvGeometry& g, const size_t elementSize) {
+  const sd::LongType pixels = g.pixels();
+  const sd::LongType numThreads = sd::Environment::getInstance().maxMasterThreads();
+
+  sd::LongType tile = sd::math::sd_max<sd::LongType>(32, (256 * 1024 / elementSize) / g.patchLength());
+  const sd::LongType balanced = (g.bS * pixels + numThreads - 1) / numThreads;
+  tile = sd::math::sd_min<sd::LongType>(tile, sd::math::sd_max<sd::LongType>(16, balanced));
+
+  return sd::math::sd_max<sd::LongType>(1, sd::math::sd_min<sd::LongType>(tile, pixels));
+}
+
+// calls func(tap, id, ih, iw) for every kernel tap of the output pixel, padded taps get id = -1
+template <typename F>
+static SD_INLINE void forEachTap(const ImplicitGemmConvGeometry& g, const sd::LongType pixel, F&& func) {
+  const sd::LongType ow = pixel % g.oW;
+  const sd::LongType oh = (pixel / g.oW) % g.oH;
+  const sd::LongType od = pixel / (g.oW * g.oH);
+
+  sd::LongType tap = 0;
+  for (sd::LongType kd = 0; kd < g.kD; kd++) {
+    const sd::LongType id = od * g.sD - g.pD + kd * g.dD;
+    const bool dIn = id >= 0 && id < g.iD;
+    for (sd::LongType kh = 0; kh < g.kH; kh++) {
+      const sd::LongType ih = oh * g.sH - g.pH + kh * g.dH;
+      const bool hIn = dIn && ih >= 0 && ih < g.iH;
+      for (sd::LongType kw = 0; kw < g.kW; kw++, tap++) {
+        const sd::LongType iw = ow * g.sW - g.pW + kw * g.dW;
+        if (hIn && iw >= 0 && iw < g.iW)
+          func(tap, id, ih, iw);
+        else
+          func(tap, static_cast<sd::LongType>(-1), ih, iw);
+      }
+    }
+  }
+}
+
+// patches of pixels [p0, p0 + count) of one sample, packed as [count, kD*kH*kW*iC] with channels innermost
+template <typename T>
+static void packConvPatches(const ImplicitGemmConvGeometry& g, const T* in, const sd::LongType p0,
+                            const sd::LongType count, T* patches) {
+  const sd::LongType K = g.patchLength();
+  const sd::LongType iC = g.iC;
+  const sd::LongType icS = g.icS;
+
+  for (sd::LongType p = 0; p < count; p++) {
+    T* row = patches + p * K;
+    forEachTap(g, p0 + p, [&](const sd::LongType tap, const sd::LongType id, const sd::LongType ih, const sd::LongType iw) {
+      T* dst = row + tap * iC;
+      if (id < 0) {
+        for (sd::LongType c = 0; c < iC; c++) dst[c] = static_cast<T>(0);
+      } else {
+        const T* src = in + id * g.idS + ih * g.ihS + iw * g.iwS;
+        if (icS == 1) {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType c = 0; c < iC; c++) dst[c] = src[c];
+        } else {
+          for (sd::LongType c = 0; c < iC; c++) dst[c] = src[c * icS];
+        }
+      }
+    });
+  }
+}
+
+// reverse of packConvPatches: columns of pixels [p0, p0 + count) are accumulated into one sample of gradI
+template <typename T>
+static void scatterConvPatches(const ImplicitGemmConvGeometry& g, const T* columns, const sd::LongType p0,
+                               const sd::LongType count, T* gradI) {
+  const sd::LongType K = g.patchLength();
+  const sd::LongType iC = g.iC;
+  const sd::LongType icS = g.icS;
+
+  for (sd::LongType p = 0; p < count; p++) {
+    const T* row = columns + p * K;
+    forEachTap(g, p0 + p, [&](const sd::LongType tap, const sd::LongType id, const sd::LongType ih, const sd::LongType iw) {
+      if (id < 0) return;
+      const T* src = row + tap * iC;
+      T* dst = gradI + id * g.idS + ih * g.ihS + iw * g.iwS;
+      for (sd::LongType c = 0; c < iC; c++) dst[c * icS] += src[c];
+    });
+  }
+}
+
+/**
+ * output = conv(input, weights)
+ * weights are expected packed as c-ordered [kD, kH, kW, iC, oC], output must satisfy linearOutput()
+ */
+template <typename T>
+static void implicitGemmConv(const ImplicitGemmConvGeometry& g, const T* input, const T* weights, T* output) {
+  const sd::LongType K = g.patchLength();
+  const sd::LongType pixels = g.pixels();
+  const sd::LongType tile = implicitGemmTile(g, sizeof(T));
+  const sd::LongType tilesPerSample = (pixels + tile - 1) / tile;
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<T> patches(tile * K);
+
+    for (auto t = start; t < stop; t++) {
+      const sd::LongType b = t / tilesPerSample;
+      const sd::LongType p0 = (t % tilesPerSample) * tile;
+      const sd::LongType count = sd::math::sd_min<sd::LongType>(tile, pixels - p0);
+
+      packConvPatches<T>(g, input + b * g.ibS, p0, count, patches.data());
+
+      // [count, K] x [K, oC] = [count, oC]
+      sd::blas::PackedGEMM<T, T, T>::op(count, g.oC, K, 1.0, patches.data(), K, 1, weights, g.oC, 1, 0.0,
+                                        output + b * g.obS + p0 * g.owS, g.owS, g.ocS);
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, g.bS * tilesPerSample);
+}
+
+/**
+ * Backprop of implicitGemmConv, either of gradI and gradW may be nullptr.
+ * Geometry describes input/gradO, gradIGeometry holds strides of gradI, which must be zeroed by caller.
+ * gradW is produced packed as c-ordered [kD, kH, kW, iC, oC] in accumulator type.
+ */
+template <typename T>
+static void implicitGemmConvBP(const ImplicitGemmConvGeometry& g, const ImplicitGemmConvGeometry& gradIGeometry,
+                               const T* input, const T* weights, const T* gradO, T* gradI,
+                               typename sd::blas::GemmAccumulator<T>::type* gradW) {
+  using Acc = typename sd::blas::GemmAccumulator<T>::type;
+
+  const sd::LongType K = g.patchLength();
+  const sd::LongType pixels = g.pixels();
+  const sd::LongType tile = implicitGemmTile(g, sizeof(T));
+
+  // samples are split between threads, so that scattering into gradI never overlaps,
+  // gemms of a single sample grab idle threads on their own
+  const sd::LongType numThreads =
+      sd::math::sd_min<sd::LongType>(sd::Environment::getInstance().maxMasterThreads(), g.bS);
+  std::vector<std::vector<Acc>> gradWParts(gradW != nullptr ? numThreads : 0);
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<T> patches(gradW != nullptr ? tile * K : 0);
+    std::vector<T> columns(gradI != nullptr ? tile * K : 0);
+    Acc* gradWPart = nullptr;
+    if (gradW != nullptr) {
+      gradWParts[thread_id].resize(K * g.oC, static_cast<Acc>(0));
+      gradWPart = gradWParts[thread_id].data();
+    }
+
+    for (auto b = start; b < stop; b++) {
+      for (sd::LongType p0 = 0; p0 < pixels; p0 += tile) {
+        const sd::LongType count = sd::math::sd_min<sd::LongType>(tile, pixels - p0);
+        const T* gradOTile = gradO + b * g.obS + p0 * g.owS;
+
+        if (gradW != nullptr) {
+          packConvPatches<T>(g, input + b * g.ibS, p0, count, patches.data());
+          // [K, count] x [count, oC] += [K, oC]
+          sd::blas::PackedGEMM<T, T, Acc>::op(K, g.oC, count, 1.0, patches.data(), 1, K, gradOTile, g.owS, g.ocS, 1.0,
+                                              gradWPart, g.oC, 1);
+        }
+
+        if (gradI != nullptr) {
+          // [count, oC] x [oC, K] = [count, K]
+          sd::blas::PackedGEMM<T, T, T>::op(count, K, g.oC, 1.0, gradOTile, g.owS, g.ocS, weights, 1, g.oC, 0.0,
+                                            columns.data(), K, 1);
+          scatterConvPatches<T>(gradIGeometry, columns.data(), p0, count, gradI + b * gradIGeometry.ibS);
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, g.bS, 1, numThreads);
+
+  if (gradW != nullptr) {
+    const sd::LongType length = K * g.oC;
+    for (sd::LongType e = 0; e < length; e++) gradW[e] = static_cast<Acc>(0);
+    for (const auto& part : gradWParts) {
+      if (part.empty()) continue;
+      PRAGMA_OMP_SIMD
+      for (sd::LongType e = 0; e < length; e++) gradW[e] += part[e];
+    }
+  }
+}
+
+/**
+ * Depthwise convolution computed directly, output channel ic * mC + m is produced by input channel ic only.
+ * weights are expected packed as c-ordered [iC, kD, kH, kW, mC]
+ */
+template <typename T>
+static void depthwiseConvDirect(const ImplicitGemmConvGeometry& g, const sd::LongType mC, const T* input,
+                                const T* weights, T* output) {
+  using Acc = typename sd::blas::GemmAccumulator<T>::type;
+  const sd::LongType taps = g.kD * g.kH * g.kW;
+  const sd::LongType pixels = g.pixels();
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Acc> acc(mC);
+
+    for (auto t = start; t < stop; t++) {
+      const sd::LongType b = t / g.iC;
+      const sd::LongType c = t % g.iC;
+      const T* in = input + b * g.ibS + c * g.icS;
+      const T* w = weights + c * taps * mC;
+      T* out = output + b * g.obS + c * mC * g.ocS;
+
+      for (sd::LongType p = 0; p < pixels; p++) {
+        for (sd::LongType m = 0; m < mC; m++) acc[m] = static_cast<Acc>(0);
+
+        forEachTap(g, p, [&](const sd::LongType tap, const sd::LongType id, const sd::LongType ih, const sd::LongType iw) {
+          if (id < 0) return;
+          const Acc x = static_cast<Acc>(in[id * g.idS + ih * g.ihS + iw * g.iwS]);
+          const T* wTap = w + tap * mC;
+          PRAGMA_OMP_SIMD
+          for (sd::LongType m = 0; m < mC; m++) acc[m] += x * static_cast<Acc>(wTap[m]);
+        });
+
+        T* o = out + p * g.owS;
+        for (sd::LongType m = 0; m < mC; m++) o[m * g.ocS] = static_cast<T>(acc[m]);
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, g.bS * g.iC);
+}
+
+/**
+ * Backprop of depthwiseConvDirect. Work is split over input channels, every channel owns its slices of gradI and
+ * gradW, so no synchronization is needed. gradI (strides in gradIGeometry) must be zeroed by caller,
+ * gradW is produced packed as c-ordered [iC, kD, kH, kW, mC] in accumulator type.
+ */
+template <typename T>
+static void depthwiseConvDirectBP(const ImplicitGemmConvGeometry& g, const ImplicitGemmConvGeometry& gradIGeometry,
+                                  const sd::LongType mC, const T* input, const T* weights, const T* gradO, T* gradI,
+                                  typename sd::blas::GemmAccumulator<T>::type* gradW) {
+  using Acc = typename sd::blas::GemmAccumulator<T>::type;
+  const sd::LongType taps = g.kD * g.kH * g.kW;
+  const sd::LongType pixels = g.pixels();
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Acc> grad(mC);
+
+    for (auto c = start; c < stop; c++) {
+      const T* w = weights + c * taps * mC;
+      Acc* gW = gradW + c * taps * mC;
+      for (sd::LongType e = 0; e < taps * mC; e++) gW[e] = static_cast<Acc>(0);
+
+      for (sd::LongType b = 0; b < g.bS; b++) {
+        const T* in = input + b * g.ibS + c * g.icS;
+        const T* gO = gradO + b * g.obS + c * mC * g.ocS;
+        T* gI = gradI + b * gradIGeometry.ibS + c * gradIGeometry.icS;
+
+        for (sd::LongType p = 0; p < pixels; p++) {
+          const T* gOp = gO + p * g.owS;
+          for (sd::LongType m = 0; m < mC; m++) grad[m] = static_cast<Acc>(gOp[m * g.ocS]);
+
+          forEachTap(g, p, [&](const sd::LongType tap, const sd::LongType id, const sd::LongType ih, const sd::LongType iw) {
+            if (id < 0) return;
+            const T* wTap = w + tap * mC;
+            Acc* gWTap = gW + tap * mC;
+            const Acc x = static_cast<Acc>(in[id * g.idS + ih * g.ihS + iw * g.iwS]);
+            Acc sum = static_cast<Acc>(0);
+            PRAGMA_OMP_SIMD_SUM(sum)
+            for (sd::LongType m = 0; m < mC; m++) sum += grad[m] * static_cast<Acc>(wTap[m]);
+            PRAGMA_OMP_SIMD
+            for (sd::LongType m = 0; m < mC; m++) gWTap[m] += x * grad[m];
+            const sd::LongType iOffset = id * gradIGeometry.idS + ih * gradIGeometry.ihS + iw * gradIGeometry.iwS;
+            gI[iOffset] = static_cast<T>(static_cast<Acc>(gI[iOffset]) + sum);
+          });
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, g.iC);
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_CONVOLUTIONS_IMPLICITGEMM_HPP
@@ -0,0 +1,507 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Winograd F(2x2, 3x3) and F(4x4, 3x3) for 3x3 stride-1 non-dilated 2d convolutions.
+//
+// Output is split into M x M tiles, every tile needs an (M+2) x (M+2) input patch. Patch d, kernel g and product are
+// moved into the transform domain as V = B^T d B, U = G g G^T, output tile is Y = A^T [U . V] A. The elementwise
+// product summed over input channels turns into (M+2)^2 independent [tiles, iC] x [iC, oC] gemms, so one output tile
+// costs (M+2)^2 multiplications per channel pair instead of 9 * M^2.
+// Transformed weights are cached, cache hits are validated against a fingerprint of the packed weights, so updated
+// weights are never served stale.
+//
+#ifndef LIBND4J_CONVOLUTIONS_WINOGRAD_HPP
+#define LIBND4J_CONVOLUTIONS_WINOGRAD_HPP
+
+#include <array/NDArray.h>
+#include <execution/Threads.h>
+#include <system/Environment.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "convolutions_implicitGemm.hpp"
+
+namespace sd {
+namespace ops {
+
+// transform matrices are applied to one axis at a time: element k of a vector lives at src + k * srcStride,
+// and every element is itself a run of n contiguous values (channels), which is the axis we vectorize over
+template <int M>
+struct WinogradF3;
+
+template <>
+struct WinogradF3<2> {
+  static constexpr int alpha = 4;
+
+  // B^T
+  template <typename T>
+  static SD_INLINE void input(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T d0 = s[c], d1 = s[ss + c], d2 = s[2 * ss + c], d3 = s[3 * ss + c];
+      d[c] = d0 - d2;
+      d[ds + c] = d1 + d2;
+      d[2 * ds + c] = d2 - d1;
+      d[3 * ds + c] = d1 - d3;
+    }
+  }
+
+  // G
+  template <typename T>
+  static SD_INLINE void kernel(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    const T half = static_cast<T>(0.5);
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T g0 = s[c], g1 = s[ss + c], g2 = s[2 * ss + c];
+      d[c] = g0;
+      d[ds + c] = (g0 + g1 + g2) * half;
+      d[2 * ds + c] = (g0 - g1 + g2) * half;
+      d[3 * ds + c] = g2;
+    }
+  }
+
+  // A^T
+  template <typename T>
+  static SD_INLINE void output(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T m1 = s[ss + c], m2 = s[2 * ss + c];
+      d[c] = s[c] + m1 + m2;
+      d[ds + c] = m1 - m2 - s[3 * ss + c];
+    }
+  }
+};
+
+template <>
+struct WinogradF3<4> {
+  static constexpr int alpha = 6;
+
+  // B^T
+  template <typename T>
+  static SD_INLINE void input(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    const T two = static_cast<T>(2), four = static_cast<T>(4), five = static_cast<T>(5);
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T d0 = s[c], d1 = s[ss + c], d2 = s[2 * ss + c], d3 = s[3 * ss + c], d4 = s[4 * ss + c],
+              d5 = s[5 * ss + c];
+      d[c] = four * d0 - five * d2 + d4;
+      d[ds + c] = d3 + d4 - four * (d1 + d2);
+      d[2 * ds + c] = four * (d1 - d2) + d4 - d3;
+      d[3 * ds + c] = two * (d3 - d1) + d4 - d2;
+      d[4 * ds + c] = two * (d1 - d3) + d4 - d2;
+      d[5 * ds + c] = four * d1 - five * d3 + d5;
+    }
+  }
+
+  // G
+  template <typename T>
+  static SD_INLINE void kernel(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    const T q = static_cast<T>(1. / 4.), s6 = static_cast<T>(1. / 6.), s12 = static_cast<T>(1. / 12.),
+            s24 = static_cast<T>(1. / 24.);
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T g0 = s[c], g1 = s[ss + c], g2 = s[2 * ss + c];
+      d[c] = q * g0;
+      d[ds + c] = -s6 * (g0 + g1 + g2);
+      d[2 * ds + c] = -s6 * (g0 - g1 + g2);
+      d[3 * ds + c] = s24 * g0 + s12 * g1 + s6 * g2;
+      d[4 * ds + c] = s24 * g0 - s12 * g1 + s6 * g2;
+      d[5 * ds + c] = g2;
+    }
+  }
+
+  // A^T
+  template <typename T>
+  static SD_INLINE void output(const T* s, const sd::LongType ss, T* d, const sd::LongType ds, const sd::LongType n) {
+    const T two = static_cast<T>(2), four = static_cast<T>(4), eight = static_cast<T>(8);
+    PRAGMA_OMP_SIMD
+    for (sd::LongType c = 0; c < n; c++) {
+      const T m1 = s[ss + c], m2 = s[2 * ss + c], m3 = s[3 * ss + c], m4 = s[4 * ss + c];
+      d[c] = s[c] + m1 + m2 + m3 + m4;
+      d[ds + c] = m1 - m2 + two * (m3 - m4);
+      d[2 * ds + c] = m1 + m2 + four * (m3 + m4);
+      d[3 * ds + c] = m1 - m2 + eight * (m3 - m4) + s[5 * ss + c];
+    }
+  }
+};
+
+// transform domain loses a few bits of precision, half/bfloat16 results would be noticeably off, so they never get here
+template <typename T>
+struct WinogradNumerics {
+  static constexpr bool allowed = false;
+};
+
+template <>
+struct WinogradNumerics<float> {
+  static constexpr bool allowed = true;
+};
+
+template <>
+struct WinogradNumerics<double> {
+  static constexpr bool allowed = true;
+};
+
+// below this amount of channels transforms cost more than the saved multiplications
+static constexpr sd::LongType WINOGRAD_MIN_CHANNELS = 4;
+
+/**
+ * Returns tile size M to be used for given convolution, or 0 if Winograd path doesn't apply
+ */
+template <typename T>
+static int winogradTileSize(const ImplicitGemmConvGeometry& g) {
+  if (!WinogradNumerics<T>::allowed || !sd::Environment::getInstance().isUseWinograd()) return 0;
+
+  if (g.iD != 1 || g.kD != 1 || g.kH != 3 || g.kW != 3 || g.sH != 1 || g.sW != 1 || g.dH != 1 || g.dW != 1) return 0;
+
+  if (g.iC < WINOGRAD_MIN_CHANNELS || g.oC < WINOGRAD_MIN_CHANNELS || g.oH < 2 || g.oW < 2) return 0;
+
+  // larger tiles save more multiplications, but waste more on partial tiles of small images
+  return g.oH >= 8 && g.oW >= 8 ? 4 : 2;
+}
+
+/**
+ * Cache of weights moved into the transform domain, shared by all conv2d calls.
+ * Entries are looked up by weights buffer, shape and data type, and served only if fingerprint of packed weights
+ * matches the cached one. Least recently used entries are evicted once transformed weights exceed BUDGET bytes.
+ */
+template <typename T>
+class WinogradWeightsCache {
+ private:
+  struct Entry {
+    const void* key;
+    sd::DataType dataType;
+    std::vector<sd::LongType> shape;
+    int tile;
+    uint64_t fingerprint;
+    std::shared_ptr<std::vector<T>> transformed;
+  };
+
+  static constexpr size_t BUDGET = 64 * 1024 * 1024;
+
+  std::mutex _mutex;
+  std::list<std::shared_ptr<Entry>> _entries;
+  size_t _bytes = 0;
+
+  WinogradWeightsCache() = default;
+
+  static size_t bytesOf(const Entry& e) { return e.transformed->size() * sizeof(T); }
+
+  static bool matches(const Entry& e, const NDArray& weights, const int tile) {
+    return e.key == weights.buffer() && e.tile == tile && e.dataType == weights.dataType() &&
+           e.shape.size() == static_cast<size_t>(weights.rankOf()) &&
+           std::equal(e.shape.begin(), e.shape.end(), shape::shapeOf(weights.shapeInfo()));
+  }
+
+  // multiplicative hash over 8-byte words, 4 independent lanes keep it memory bound
+  static uint64_t fingerprint(const T* data, const sd::LongType length) {
+    const auto bytes = reinterpret_cast<const unsigned char*>(data);
+    const size_t size = static_cast<size_t>(length) * sizeof(T);
+    constexpr uint64_t K = 0x9E3779B97F4A7C15ULL;
+    uint64_t h[4] = {size, 1, 2, 3};
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+      for (int l = 0; l < 4; l++) {
+        uint64_t w;
+        std::memcpy(&w, bytes + i + l * 8, 8);
+        h[l] = (h[l] ^ w) * K;
+      }
+
+    for (; i < size; i++) h[0] = (h[0] ^ bytes[i]) * K;
+
+    return ((h[0] * K ^ h[1]) * K ^ h[2]) * K ^ h[3];
+  }
+
+  // packed [3, 3, iC, oC] -> [alpha * alpha, iC, oC]
+  template <int M>
+  static void transform(const T* weights, const sd::LongType iC, const sd::LongType oC, T* transformed) {
+    constexpr int alpha = WinogradF3<M>::alpha;
+    const sd::LongType n = iC * oC;
+
+    auto func = PRAGMA_THREADS_FOR {
+      std::vector<T> tmp(alpha * 3 * oC);
+
+      for (auto ic = start; ic < stop; ic++) {
+        const T* g = weights + ic * oC;
+        T* u = transformed + ic * oC;
+        // columns: tmp[alpha][3] = G g
+        for (int s = 0; s < 3; s++) WinogradF3<M>::kernel(g + s * n, 3 * n, tmp.data() + s * oC, 3 * oC, oC);
+        // rows: u[alpha][alpha] = tmp G^T
+        for (int i = 0; i < alpha; i++)
+          WinogradF3<M>::kernel(tmp.data() + i * 3 * oC, oC, u + i * alpha * n, n, oC);
+      }
+    };
+
+    samediff::Threads::parallel_for(func, 0, iC);
+  }
+
+ public:
+  static WinogradWeightsCache<T>& getInstance() {
+    static WinogradWeightsCache<T> instance;
+    return instance;
+  }
+
+  /**
+   * @param weights - original weights array, its buffer, shape and data type identify the entry
+   * @param packed - weights packed as c-ordered [3, 3, iC, oC]
+   */
+  std::shared_ptr<std::vector<T>> transformed(const NDArray& weights, const NDArray& packed, const int tile) {
+    const sd::LongType iC = packed.sizeAt(2);
+    const sd::LongType oC = packed.sizeAt(3);
+    const T* source = packed.bufferAsT<T>();
+    const uint64_t hash = fingerprint(source, packed.lengthOf());
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        if (matches(**it, weights, tile) && (*it)->fingerprint == hash) {
+          _entries.splice(_entries.begin(), _entries, it);
+          return _entries.front()->transformed;
+        }
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->key = weights.buffer();
+    entry->dataType = weights.dataType();
+    entry->shape = weights.getShapeAsVector();
+    entry->tile = tile;
+    entry->fingerprint = hash;
+    const int alpha = tile + 2;
+    entry->transformed = std::make_shared<std::vector<T>>(alpha * alpha * iC * oC);
+
+    if (tile == 4)
+      transform<4>(source, iC, oC, entry->transformed->data());
+    else
+      transform<2>(source, iC, oC, entry->transformed->data());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _entries.begin(); it != _entries.end();)
+      if (matches(**it, weights, tile)) {
+        _bytes -= bytesOf(**it);
+        it = _entries.erase(it);
+      } else {
+        ++it;
+      }
+
+    _entries.push_front(entry);
+    _bytes += bytesOf(*entry);
+
+    // entry just added is kept even if it's over budget on its own
+    while (_bytes > BUDGET && _entries.size() > 1) {
+      _bytes -= bytesOf(*_entries.back());
+      _entries.pop_back();
+    }
+
+    return entry->transformed;
+  }
+
+  /**
+   * This method drops all cached entries, i.e. when weights buffers are released or reused by caller
+   */
+  void clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _bytes = 0;
+  }
+};
+
+// P[count, oC] = V[count, iC] x U[iC, oC], all row-major: blocks are small enough to live in L1/L2, so this runs
+// without packing, R tiles share every loaded row of U
+template <typename T>
+static void winogradGemm(const sd::LongType count, const sd::LongType iC, const sd::LongType oC, const T* V,
+                         const T* U, T* P) {
+  constexpr int R = 4;
+  constexpr sd::LongType NB = 64 / sizeof(T) * 2;
+
+  for (sd::LongType t0 = 0; t0 < count; t0 += R) {
+    const int rows = static_cast<int>(sd::math::sd_min<sd::LongType>(R, count - t0));
+    const T* v = V + t0 * iC;
+
+    for (sd::LongType j0 = 0; j0 < oC; j0 += NB) {
+      const sd::LongType n = sd::math::sd_min<sd::LongType>(NB, oC - j0);
+      T acc[R][NB];
+      for (int r = 0; r < R; r++) {
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < NB; j++) acc[r][j] = static_cast<T>(0);
+      }
+
+      if (rows == R && n == NB) {
+        for (sd::LongType c = 0; c < iC; c++) {
+          const T* u = U + c * oC + j0;
+          const T v0 = v[c], v1 = v[iC + c], v2 = v[2 * iC + c], v3 = v[3 * iC + c];
+          PRAGMA_OMP_SIMD
+          for (sd::LongType j = 0; j < NB; j++) {
+            acc[0][j] += v0 * u[j];
+            acc[1][j] += v1 * u[j];
+            acc[2][j] += v2 * u[j];
+            acc[3][j] += v3 * u[j];
+          }
+        }
+      } else {
+        for (sd::LongType c = 0; c < iC; c++) {
+          const T* u = U + c * oC + j0;
+          for (int r = 0; r < rows; r++) {
+            const T vr = v[r * iC + c];
+            PRAGMA_OMP_SIMD
+            for (sd::LongType j = 0; j < n; j++) acc[r][j] += vr * u[j];
+          }
+        }
+      }
+
+      for (int r = 0; r < rows; r++) {
+        T* p = P + (t0 + r) * oC + j0;
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < n; j++) p[j] = acc[r][j];
+      }
+    }
+  }
+}
+
+/**
+ * output = conv(input, weights) for 3x3 kernel with unit strides and dilations
+ * U holds weights transformed by WinogradWeightsCache, output may have any strides
+ */
+template <typename T, int M>
+static void winogradConv(const ImplicitGemmConvGeometry& g, const T* input, const T* U, T* output) {
+  constexpr int alpha = WinogradF3<M>::alpha;
+  constexpr int alpha2 = alpha * alpha;
+
+  const sd::LongType iC = g.iC, oC = g.oC;
+  const sd::LongType tH = (g.oH + M - 1) / M;
+  const sd::LongType tW = (g.oW + M - 1) / M;
+  const sd::LongType tiles = tH * tW;
+
+  // tiles transformed at once: V and product blocks stay in L2, but small problems still give every thread work
+  const sd::LongType numThreads = sd::Environment::getInstance().maxMasterThreads();
+  sd::LongType block = sd::math::sd_max<sd::LongType>(8, (512 * 1024 / sizeof(T)) / (alpha2 * (iC + oC)));
+  const sd::LongType balanced = (g.bS * tiles + numThreads - 1) / numThreads;
+  block = sd::math::sd_min<sd::LongType>(block, sd::math::sd_max<sd::LongType>(4, balanced));
+  block = sd::math::sd_max<sd::LongType>(1, sd::math::sd_min<sd::LongType>(block, tiles));
+  const sd::LongType blocksPerSample = (tiles + block - 1) / block;
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<T> V(alpha2 * block * iC);
+    std::vector<T> P(alpha2 * block * oC);
+    std::vector<T> d(alpha2 * iC);
+    std::vector<T> tmp(alpha2 * sd::math::sd_max<sd::LongType>(iC, oC));
+    std::vector<T> y(M * M * oC);
+
+    for (auto e = start; e < stop; e++) {
+      const sd::LongType b = e / blocksPerSample;
+      const sd::LongType t0 = (e % blocksPerSample) * block;
+      const sd::LongType count = sd::math::sd_min<sd::LongType>(block, tiles - t0);
+      const T* in = input + b * g.ibS;
+      T* out = output + b * g.obS;
+
+      // input tiles -> V[alpha * alpha][count][iC]
+      for (sd::LongType t = 0; t < count; t++) {
+        const sd::LongType ih0 = ((t0 + t) / tW) * M - g.pH;
+        const sd::LongType iw0 = ((t0 + t) % tW) * M - g.pW;
+
+        for (int r = 0; r < alpha; r++) {
+          const sd::LongType ih = ih0 + r;
+          for (int s = 0; s < alpha; s++) {
+            const sd::LongType iw = iw0 + s;
+            T* dst = d.data() + (r * alpha + s) * iC;
+            if (ih < 0 || ih >= g.iH || iw < 0 || iw >= g.iW) {
+              for (sd::LongType c = 0; c < iC; c++) dst[c] = static_cast<T>(0);
+            } else {
+              const T* src = in + ih * g.ihS + iw * g.iwS;
+              if (g.icS == 1) {
+                PRAGMA_OMP_SIMD
+                for (sd::LongType c = 0; c < iC; c++) dst[c] = src[c];
+              } else {
+                for (sd::LongType c = 0; c < iC; c++) dst[c] = src[c * g.icS];
+              }
+            }
+          }
+        }
+
+        for (int s = 0; s < alpha; s++)
+          WinogradF3<M>::input(d.data() + s * iC, alpha * iC, tmp.data() + s * iC, alpha * iC, iC);
+        for (int r = 0; r < alpha; r++)
+          WinogradF3<M>::input(tmp.data() + r * alpha * iC, iC, V.data() + (r * alpha * count + t) * iC, count * iC,
+                               iC);
+      }
+
+      // P[xi] = V[xi] x U[xi]: [count, iC] x [iC, oC] = [count, oC]
+      for (int xi = 0; xi < alpha2; xi++)
+        winogradGemm<T>(count, iC, oC, V.data() + xi * count * iC, U + xi * iC * oC, P.data() + xi * count * oC);
+
+      // P -> output tiles
+      for (sd::LongType t = 0; t < count; t++) {
+        const sd::LongType oh0 = ((t0 + t) / tW) * M;
+        const sd::LongType ow0 = ((t0 + t) % tW) * M;
+
+        for (int s = 0; s < alpha; s++)
+          WinogradF3<M>::output(P.data() + (s * count + t) * oC, alpha * count * oC, tmp.data() + s * oC,
+                                alpha * oC, oC);
+        for (int r = 0; r < M; r++)
+          WinogradF3<M>::output(tmp.data() + r * alpha * oC, oC, y.data() + r * M * oC, oC, oC);
+
+        const int rows = static_cast<int>(sd::math::sd_min<sd::LongType>(M, g.oH - oh0));
+        const int cols = static_cast<int>(sd::math::sd_min<sd::LongType>(M, g.oW - ow0));
+        for (int r = 0; r < rows; r++)
+          for (int s = 0; s < cols; s++) {
+            const T* src = y.data() + (r * M + s) * oC;
+            T* dst = out + (oh0 + r) * g.ohS + (ow0 + s) * g.owS;
+            if (g.ocS == 1) {
+              PRAGMA_OMP_SIMD
+              for (sd::LongType c = 0; c < oC; c++) dst[c] = src[c];
+            } else {
+              for (sd::LongType c = 0; c < oC; c++) dst[c * g.ocS] = src[c];
+            }
+          }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, g.bS * blocksPerSample);
+}
+
+/**
+ * Runs Winograd convolution if it applies to given geometry and data type, returns false otherwise.
+ * packed holds weights as c-ordered [3, 3, iC, oC], original weights identify the cache entry
+ */
+template <typename T>
+static bool winogradConv2d(const ImplicitGemmConvGeometry& g, const NDArray& weights, const NDArray& packed,
+                           const T* input, T* output) {
+  const int tile = winogradTileSize<T>(g);
+  if (tile == 0) return false;
+
+  auto U = WinogradWeightsCache<T>::getInstance().transformed(weights, packed, tile);
+
+  if (tile == 4)
+    winogradConv<T, 4>(g, input, U->data(), output);
+  else
+    winogradConv<T, 2>(g, input, U->data(), output);
+
+  return true;
+}
+
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_CONVOLUTIONS_WINOGRAD_HPP
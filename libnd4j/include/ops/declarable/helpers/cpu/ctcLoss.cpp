@@ -412,7 +412,8 @@ void ctc_loss_(const NDArray &logits, const NDArray &targetLabels, const NDArray
       }
     }
   };
-  samediff::Threads::parallel_for(func, 0, lenBatch, 1);
+  // cost of a batch entry depends on its sequence lengths
+  samediff::Threads::parallel_dynamic(func, 0, lenBatch, 1);
 }
 
 void ctcLoss(graph::Context &block, const NDArray &logits, const NDArray &targetLabels, const NDArray &logitsLengths,
@@ -0,0 +1,119 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// gru forward time loop: input projection of all time steps is computed by single gemm, so every time step runs only
+// recurrent gemm followed by one fused element-wise pass
+//
+#include <system/op_boilerplate.h>
+
+#if NOT_EXCLUDED(OP_gru)
+
+#include <execution/Threads.h>
+#include <helpers/MmulHelper.h>
+#include <ops/declarable/helpers/gru.h>
+#include <ops/ops.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void gruTimeLoopFused_(const NDArray* x, const NDArray* hI, const NDArray* Wx, const NDArray* Wh,
+                              const NDArray* b, NDArray* h) {
+  // x   input [sL, bS, nIn]
+  // hI  initial cell output (at time step = 0) [bS, nOut]
+  // Wx  input-to-hidden  weights, [nIn, 3*nOut]
+  // Wh  hidden-to-hidden weights, [nOut, 3*nOut]
+  // b   biases, [3*nOut]
+  // h   cell outputs at each time step [sL, bS, nOut]
+
+  const sd::LongType sL = x->sizeAt(0);
+  const sd::LongType bS = x->sizeAt(1);
+  const sd::LongType nIn = x->sizeAt(2);
+  const sd::LongType nOut = hI->sizeAt(1);
+  const sd::LongType nOut3 = 3 * nOut;
+
+  // x × Wx + b for all time steps, [sL*bS, 3*nOut]
+  NDArray x2d = x->reshape('c', {sL * bS, nIn});
+  NDArray proj('c', {sL * bS, nOut3}, x->dataType(), x->getContext());
+  MmulHelper::mmul(&x2d, Wx, &proj, 1.0, 0.0, 'c');
+  proj += *b;
+
+  NDArray wh = Wh->dup('c');
+  NDArray gates('c', {bS, nOut3}, x->dataType(), x->getContext());
+  NDArray hState('c', {bS, nOut}, x->dataType(), x->getContext());
+  hState.assign(*hI);
+
+  const T* pBuff = proj.bufferAsT<T>();
+  T* gBuff = gates.bufferAsT<T>();
+  T* hBuff = hState.bufferAsT<T>();
+  T* hOut = h->bufferAsT<T>();
+  const sd::LongType hStrideT = h->strideAt(0), hStrideB = h->strideAt(1), hStrideF = h->strideAt(2);
+
+  for (sd::LongType t = 0; t < sL; ++t) {
+    MmulHelper::mmul(&hState, &wh, &gates, 1.0, 0.0, 'c');  // [bS, nOut] × [nOut, 3*nOut] = [bS, 3*nOut]
+
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; ++e) {
+        const T* p = pBuff + (t * bS + e) * nOut3;
+        T* g = gBuff + e * nOut3;
+        T* hRow = hBuff + e * nOut;
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < nOut; ++j) {
+          const T r = sd::math::sd_sigmoid<T, T>(g[j] + p[j]);
+          const T u = sd::math::sd_sigmoid<T, T>(g[nOut + j] + p[nOut + j]);
+          const T c = sd::math::sd_tanh<T, T>(r * g[2 * nOut + j] + p[2 * nOut + j]);
+          hRow[j] = u * hRow[j] + (static_cast<T>(1.f) - u) * c;
+        }
+
+        T* hT = hOut + t * hStrideT + e * hStrideB;
+        for (sd::LongType j = 0; j < nOut; ++j) hT[j * hStrideF] = hRow[j];
+      }
+    };
+
+    samediff::Threads::parallel_for(func, 0, bS);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool gruTimeLoopFused(const NDArray* x, const NDArray* hI, const NDArray* Wx, const NDArray* Wh, const NDArray* b,
+                      NDArray* h, bool linearBeforeReset) {
+  const auto type = x->dataType();
+
+  // linear before reset is not implemented by gruCell either, so let it report that
+  if (linearBeforeReset || !DataTypeUtils::isR(type)) return false;
+
+  for (auto arr : {hI, Wx, Wh, b, const_cast<const NDArray*>(h)})
+    if (arr->dataType() != type) return false;
+
+  if (x->rankOf() != 3 || hI->rankOf() != 2 || Wx->rankOf() != 2 || Wh->rankOf() != 2 || b->rankOf() != 1 ||
+      h->rankOf() != 3)
+    return false;
+
+  BUILD_SINGLE_SELECTOR(type, gruTimeLoopFused_, (x, hI, Wx, Wh, b, h), SD_FLOAT_TYPES);
+  return true;
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif
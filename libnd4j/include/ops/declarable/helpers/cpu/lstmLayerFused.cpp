@@ -0,0 +1,271 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// lstmLayer forward time loop: input projection of all time steps is computed by single gemm, so every time step runs
+// only recurrent gemm followed by one fused element-wise pass over preallocated state buffers
+//
+#include <system/op_boilerplate.h>
+
+#if NOT_EXCLUDED(OP_lstmLayer)
+
+#include <execution/Threads.h>
+#include <helpers/MmulHelper.h>
+#include <ops/declarable/helpers/lstmLayer.h>
+#include <ops/ops.h>
+
+#include <algorithm>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+//////////////////////////////////////////////////////////////////////////
+// same activation ids as applyActivation in impl/lstmLayer.cpp, applied in place to contiguous span
+template <typename T>
+static void activateSpan(T* z, const sd::LongType len, const int opId, const T alpha, const T beta) {
+  T args[] = {alpha, beta};
+
+  switch (opId) {
+    case 0:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::Tanh<T>::op(z[i], nullptr);
+      break;
+    case 1:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::RELU<T, T, T>::op(z[i], static_cast<T>(0), nullptr);
+      break;
+    case 2:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::Sigmoid<T>::op(z[i], nullptr);
+      break;
+    case 3:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::Affine<T>::op(z[i], args);
+      break;
+    case 4:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::LeakyRELU<T, T, T>::op(z[i], alpha, nullptr);
+      break;
+    case 5:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = z[i] > alpha ? z[i] : static_cast<T>(0.f);
+      break;
+    case 6:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::ScaledTanh<T>::op(z[i], args);
+      break;
+    case 7:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::HardSigmoid<T>::op(z[i], nullptr);
+      break;
+    case 8:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::ELU<T, T, T>::op(z[i], alpha, nullptr);
+      break;
+    case 9:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::SoftSign<T>::op(z[i], nullptr);
+      break;
+    case 10:
+      PRAGMA_OMP_SIMD
+      for (sd::LongType i = 0; i < len; ++i) z[i] = simdOps::SoftPlus<T>::op(z[i], nullptr);
+      break;
+    default:
+      THROW_EXCEPTION("LSTM_LAYER operation: wrong id number of activation !");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void lstmLayerTimeLoopFused_(const NDArray* x, const NDArray* Wx, const NDArray* Wr, const NDArray* b,
+                                    const NDArray* seqLen, const NDArray* hI, const NDArray* cI, const NDArray* Wp,
+                                    const std::vector<float>& params, const bool forward, NDArray* h, NDArray* hL,
+                                    NDArray* cL) {
+  const int dataFormat = params[0];
+  const int directionMode = params[1];
+  const T cellClip = params[2];
+
+  const sd::LongType sL = dataFormat == 3 ? x->sizeAt(0) : x->sizeAt(dataFormat);
+  const sd::LongType bS = dataFormat == 1 || dataFormat == 2 ? x->sizeAt(0) : x->sizeAt(1);
+  const sd::LongType nIn = dataFormat == 2 ? x->sizeAt(1) : x->sizeAt(2);
+  const sd::LongType nOut = Wx->sizeAt(-1) / 4;
+  const sd::LongType nOut4 = 4 * nOut;
+
+  // input projection for all time steps [sL*bS, 4*nOut], rows are ordered in the same way as x sub-arrays:
+  // t*bS + b for [sL, bS, nIn] and b*sL + t for [bS, sL, nIn] and [bS, nIn, sL]
+  NDArray x2d = dataFormat == 2 ? x->permute({0, 2, 1}).reshape('c', {bS * sL, nIn})
+                                : x->reshape('c', {sL * bS, nIn});
+  NDArray proj('c', {sL * bS, nOut4}, x->dataType(), x->getContext());
+  MmulHelper::mmul(&x2d, Wx, &proj, 1.0, 0.0, 'c');
+  if (b != nullptr) proj += *b;
+
+  // everything touched inside time loop is allocated here, once
+  NDArray wr = Wr->dup('c');
+  NDArray z('c', {bS, nOut4}, x->dataType(), x->getContext());
+  NDArray hState('c', {bS, nOut}, x->dataType(), x->getContext());
+  NDArray cState('c', {bS, nOut}, x->dataType(), x->getContext());
+  NDArray wp;
+  if (Wp != nullptr) wp = Wp->dup('c');
+
+  if (hI != nullptr)
+    hState.assign(*hI);
+  else
+    hState.nullify();
+
+  if (cI != nullptr)
+    cState.assign(*cI);
+  else
+    cState.nullify();
+
+  std::vector<sd::LongType> limits(bS, sL);
+  sd::LongType steps = seqLen == nullptr ? sL : 0;
+  if (seqLen != nullptr)
+    for (sd::LongType e = 0; e < bS; ++e) {
+      limits[e] = seqLen->e<sd::LongType>(e);
+      steps = sd::math::sd_max<sd::LongType>(steps, limits[e]);
+    }
+
+  // time steps beyond sequence length have zero output
+  if (h != nullptr && seqLen != nullptr) h->nullify();
+
+  const sd::LongType tAxis = dataFormat == 1 ? 1 : (dataFormat == 2 ? 2 : 0);
+  const sd::LongType bAxis = dataFormat == 1 || dataFormat == 2 ? 0 : 1;
+  const sd::LongType fAxis = dataFormat == 2 ? 1 : 2;
+  T* hOut = h != nullptr ? h->bufferAsT<T>() : nullptr;
+  const sd::LongType hStrideT = h != nullptr ? h->strideAt(tAxis) : 0;
+  const sd::LongType hStrideB = h != nullptr ? h->strideAt(bAxis) : 0;
+  const sd::LongType hStrideF = h != nullptr ? h->strideAt(fAxis) : 0;
+
+  const T* pBuff = proj.bufferAsT<T>();
+  const T* wpBuff = Wp != nullptr ? wp.bufferAsT<T>() : nullptr;
+  T* zBuff = z.bufferAsT<T>();
+  T* hBuff = hState.bufferAsT<T>();
+  T* cBuff = cState.bufferAsT<T>();
+
+  const int gateAct = params[3], cellAct = params[6], outAct = params[9];
+  const T gateAlpha = params[4], gateBeta = params[5];
+  const T cellAlpha = params[7], cellBeta = params[8];
+  const T outAlpha = params[10], outBeta = params[11];
+
+  for (sd::LongType k = 0; k < steps; ++k) {
+    MmulHelper::mmul(&hState, &wr, &z, 1.0, 0.0, 'c');  // [bS, nOut] × [nOut, 4*nOut] = [bS, 4*nOut]
+
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; ++e) {
+        const sd::LongType limit = limits[e];
+        if (k >= limit) continue;  // state of finished sequence stays as is
+
+        sd::LongType t = k;
+        if (!forward) t = seqLen != nullptr && directionMode != 1 ? limit - 1 - k : sL - 1 - k;
+
+        const auto row = dataFormat == 0 || dataFormat == 3 ? t * bS + e : e * sL + t;
+        const T* p = pBuff + row * nOut4;
+        T* zi = zBuff + e * nOut4;
+        T* zf = zi + nOut;
+        T* zg = zf + nOut;
+        T* zo = zg + nOut;
+        T* hRow = hBuff + e * nOut;
+        T* cRow = cBuff + e * nOut;
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < nOut4; ++j) zi[j] += p[j];
+
+        if (wpBuff != nullptr) {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType j = 0; j < nOut; ++j) {
+            zi[j] += cRow[j] * wpBuff[j];
+            zf[j] += cRow[j] * wpBuff[nOut + j];
+          }
+        }
+
+        activateSpan<T>(zi, 2 * nOut, gateAct, gateAlpha, gateBeta);  // it and ft are adjacent
+        activateSpan<T>(zg, nOut, cellAct, cellAlpha, cellBeta);
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < nOut; ++j) {
+          T c = zf[j] * cRow[j] + zi[j] * zg[j];
+          if (cellClip != static_cast<T>(0)) c = simdOps::LstmClip<T, T, T>::op(c, cellClip, nullptr);
+          cRow[j] = c;
+          hRow[j] = c;
+        }
+
+        if (wpBuff != nullptr) {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType j = 0; j < nOut; ++j) zo[j] += cRow[j] * wpBuff[2 * nOut + j];
+        }
+
+        activateSpan<T>(zo, nOut, gateAct, gateAlpha, gateBeta);
+        activateSpan<T>(hRow, nOut, outAct, outAlpha, outBeta);
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < nOut; ++j) hRow[j] *= zo[j];
+
+        if (hOut != nullptr) {
+          T* hT = hOut + t * hStrideT + e * hStrideB;
+          for (sd::LongType j = 0; j < nOut; ++j) hT[j * hStrideF] = hRow[j];
+        }
+      }
+    };
+
+    samediff::Threads::parallel_for(func, 0, bS);
+  }
+
+  if (hL == nullptr && cL == nullptr) return;
+
+  // empty sequences produce zero last output and cell state
+  for (sd::LongType e = 0; e < bS; ++e)
+    if (limits[e] == 0) {
+      std::fill_n(hBuff + e * nOut, nOut, static_cast<T>(0));
+      std::fill_n(cBuff + e * nOut, nOut, static_cast<T>(0));
+    }
+
+  if (hL != nullptr) hL->assign(hState);
+  if (cL != nullptr) cL->assign(cState);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool lstmLayerTimeLoopFused(const NDArray* x, const NDArray* Wx, const NDArray* Wr, const NDArray* b,
+                            const NDArray* seqLen, const NDArray* hI, const NDArray* cI, const NDArray* Wp,
+                            const std::vector<float>& params, const bool forward, NDArray* h, NDArray* hL,
+                            NDArray* cL) {
+  const auto type = x->dataType();
+  if (!DataTypeUtils::isR(type) || x->rankOf() != 3 || Wx->rankOf() != 2 || Wr->rankOf() != 2) return false;
+
+  // unusual layouts and mixed data types are left for per-step code
+  for (auto arr : {Wx, Wr, b, hI, cI, Wp, const_cast<const NDArray*>(h), const_cast<const NDArray*>(hL),
+                   const_cast<const NDArray*>(cL)})
+    if (arr != nullptr && arr->dataType() != type) return false;
+
+  if ((b && b->rankOf() != 1) || (Wp && Wp->rankOf() != 1) || (hI && hI->rankOf() != 2) || (cI && cI->rankOf() != 2) ||
+      (h && h->rankOf() != 3) || (hL && hL->rankOf() != 2) || (cL && cL->rankOf() != 2))
+    return false;
+
+  for (int i : {3, 6, 9})
+    if (params[i] < 0 || params[i] > 10) return false;
+
+  BUILD_SINGLE_SELECTOR(type, lstmLayerTimeLoopFused_,
+                        (x, Wx, Wr, b, seqLen, hI, cI, Wp, params, forward, h, hL, cL), SD_FLOAT_TYPES);
+  return true;
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif
@@ -23,7 +23,10 @@
 #include <helpers/ShapeUtils.h>
 #include <ops/declarable/helpers/scatter.h>
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
+#include <type_traits>
 #if NOT_EXCLUDED(OP_scatter)
 namespace sd {
 namespace ops {
@@ -68,92 +71,367 @@ sd::LongType checkIndices(sd::LaunchContext* context, const NDArray& indices, co
 }
 
 ///////////////////////////////////////////////////////////////////
-void scatter(sd::LaunchContext* context, pairwise::Ops op, const NDArray& indices, const NDArray& updates,
-             NDArray& output, const bool lock) {
-  const int outRank = output.rankOf();
-  const int indRank = indices.rankOf();
-  const int updRank = updates.rankOf();
-  const sd::LongType indLen = indices.lengthOf();
+// Scatter engine: output is viewed as [numRows, rowLen], updates as [numUpdates, rowLen], rows[i] is destination row
+// of i-th update. With lock = false indices are trusted to be unique and updates are applied directly in parallel.
+// Otherwise one of conflict-free strategies is picked by output size and expected duplicate rate (updates per row):
+//  - private accumulators: each thread reduces its share of updates into own copy of output, copies are merged
+//    afterwards. Used for small outputs receiving many updates per row, commutative ops only
+//  - atomic CAS: updates are applied concurrently via compare-and-swap. Used for float/double add/sub with short rows
+//    and outputs much larger than number of updates, where collisions are rare
+//  - partitioning: updates are grouped by destination row (counting sort, or sorting of update ids for sparse
+//    outputs), then rows are processed in parallel, each applying its updates in original order. Results are
+//    identical to serial execution, so this is the path for non-commutative ops like update
+
+// below this amount of work scatter runs serially
+constexpr sd::LongType kScatterSerialLimit = 8192;
+// max output length (in elements) replicated per thread for private accumulation
+constexpr sd::LongType kScatterPrivateLimit = 65536;
+// max row length for CAS updates
+constexpr sd::LongType kScatterAtomicRowLen = 64;
+#if defined(__GNUC__)
+constexpr bool kScatterHasCas = true;
+#else
+constexpr bool kScatterHasCas = false;
+#endif
+
+template <typename X>
+struct ScatterAtomicType {
+  static constexpr bool value = std::is_same<X, float>::value || std::is_same<X, double>::value;
+};
+
+// apply(z, u) is the op itself. For accumulative ops updates of the same row may be pre-reduced with accumulate(),
+// starting from init(z), and applied to output at once
+template <typename X>
+struct ScatterAdd {
+  static constexpr bool kAccumulative = true;
+  static constexpr bool kAtomic = ScatterAtomicType<X>::value;
+  static SD_INLINE X apply(X z, X u) { return z + u; }
+  static SD_INLINE X accumulate(X acc, X u) { return acc + u; }
+  static SD_INLINE X init(X z) { return static_cast<X>(0); }
+};
+
+template <typename X>
+struct ScatterSubtract {
+  static constexpr bool kAccumulative = true;
+  static constexpr bool kAtomic = ScatterAtomicType<X>::value;
+  static SD_INLINE X apply(X z, X u) { return z - u; }
+  static SD_INLINE X accumulate(X acc, X u) { return acc + u; }
+  static SD_INLINE X init(X z) { return static_cast<X>(0); }
+};
+
+template <typename X>
+struct ScatterMax {
+  static constexpr bool kAccumulative = true;
+  static constexpr bool kAtomic = false;
+  static SD_INLINE X apply(X z, X u) { return sd::math::sd_max<X>(z, u); }
+  static SD_INLINE X accumulate(X acc, X u) { return sd::math::sd_max<X>(acc, u); }
+  static SD_INLINE X init(X z) { return z; }
+};
+
+template <typename X>
+struct ScatterMin {
+  static constexpr bool kAccumulative = true;
+  static constexpr bool kAtomic = false;
+  static SD_INLINE X apply(X z, X u) { return sd::math::sd_min<X>(z, u); }
+  static SD_INLINE X accumulate(X acc, X u) { return sd::math::sd_min<X>(acc, u); }
+  static SD_INLINE X init(X z) { return z; }
+};
+
+template <typename X>
+struct ScatterMultiply {
+  static constexpr bool kAccumulative = false;
+  static constexpr bool kAtomic = false;
+  static SD_INLINE X apply(X z, X u) { return z * u; }
+  static SD_INLINE X accumulate(X acc, X u) { return acc * u; }
+  static SD_INLINE X init(X z) { return static_cast<X>(1); }
+};
+
+template <typename X>
+struct ScatterDivide {
+  static constexpr bool kAccumulative = false;
+  static constexpr bool kAtomic = false;
+  static SD_INLINE X apply(X z, X u) { return z / u; }
+  static SD_INLINE X accumulate(X acc, X u) { return acc * u; }
+  static SD_INLINE X init(X z) { return static_cast<X>(1); }
+};
+
+template <typename X>
+struct ScatterCopy {
+  static constexpr bool kAccumulative = false;
+  static constexpr bool kAtomic = false;
+  static SD_INLINE X apply(X z, X u) { return u; }
+  static SD_INLINE X accumulate(X acc, X u) { return u; }
+  static SD_INLINE X init(X z) { return z; }
+};
 
-  if (outRank == 1) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        sd::LongType idx = indices.e<sd::LongType>(i);
-        NDArray out = output({idx, idx + 1});
+///////////////////////////////////////////////////////////////////
+template <typename X, typename Op>
+static void scatterAtomic_(X* z, const X* u, const std::vector<sd::LongType>& rows, const sd::LongType rowLen,
+                           std::true_type) {
+#if defined(__GNUC__)
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      X* zRow = z + rows[i] * rowLen;
+      const X* uRow = u + i * rowLen;
+
+      for (sd::LongType j = 0; j < rowLen; ++j) {
+        X expected, desired;
+        __atomic_load(zRow + j, &expected, __ATOMIC_RELAXED);
+        do {
+          desired = Op::apply(expected, uRow[j]);
+        } while (!__atomic_compare_exchange(zRow + j, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+      }
+    }
+  };
 
-        out.applyPairwiseTransform(op, updates.e(i));
+  samediff::Threads::parallel_for(func, 0, static_cast<sd::LongType>(rows.size()));
+#endif
+}
+
+template <typename X, typename Op>
+static void scatterAtomic_(X* z, const X* u, const std::vector<sd::LongType>& rows, const sd::LongType rowLen,
+                           std::false_type) {
+  THROW_EXCEPTION("scatter: atomic updates are not supported for this data type and op !");
+}
+
+///////////////////////////////////////////////////////////////////
+template <typename X, typename Op>
+static void scatterPrivate_(X* z, const X* u, const std::vector<sd::LongType>& rows, const sd::LongType outLen,
+                            const sd::LongType rowLen, const int numThreads) {
+  const sd::LongType numUpdates = rows.size();
+  std::vector<X> acc(numThreads * outLen);
+
+  // chunk t goes to accumulator t regardless of thread it runs on, so results don't depend on scheduling
+  auto accumulate = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++) {
+      X* a = acc.data() + t * outLen;
+      for (sd::LongType e = 0; e < outLen; ++e) a[e] = Op::init(z[e]);
+
+      for (sd::LongType i = numUpdates * t / numThreads; i < numUpdates * (t + 1) / numThreads; ++i) {
+        X* aRow = a + rows[i] * rowLen;
+        const X* uRow = u + i * rowLen;
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < rowLen; ++j) aRow[j] = Op::accumulate(aRow[j], uRow[j]);
       }
-    };
+    }
+  };
+
+  samediff::Threads::parallel_tad(accumulate, 0, numThreads, 1, numThreads);
+
+  auto merge = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      X a = acc[e];
+      for (int t = 1; t < numThreads; ++t) a = Op::accumulate(a, acc[t * outLen + e]);
+      z[e] = Op::apply(z[e], a);
+    }
+  };
 
-    samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
-  } else {  // outRank > 1
+  samediff::Threads::parallel_for(merge, 0, outLen);
+}
 
-    int sizeOfDims = indRank;
-    if (outRank == updRank && indices.isVector()) sizeOfDims = 1;
+///////////////////////////////////////////////////////////////////
+template <typename X, typename Op>
+static void scatterPartitioned_(X* z, const X* u, const std::vector<sd::LongType>& rows, const sd::LongType numRows,
+                                const sd::LongType rowLen) {
+  const sd::LongType numUpdates = rows.size();
+
+  // update ids grouped by destination row, group g is order[bounds[g] : bounds[g + 1]]
+  std::vector<sd::LongType> order(numUpdates);
+  std::vector<sd::LongType> bounds;
+
+  if (numRows <= 4 * numUpdates) {
+    // counting sort, stable
+    std::vector<sd::LongType> offsets(numRows + 1, 0);
+    for (sd::LongType i = 0; i < numUpdates; ++i) ++offsets[rows[i] + 1];
+
+    for (sd::LongType r = 0; r < numRows; ++r) {
+      if (offsets[r + 1] > 0) bounds.push_back(offsets[r]);
+      offsets[r + 1] += offsets[r];
+    }
 
-    std::vector<sd::LongType > dimsToExcludeUpd(sizeOfDims);
-    std::iota(dimsToExcludeUpd.begin(), dimsToExcludeUpd.end(), 0);
+    for (sd::LongType i = 0; i < numUpdates; ++i) order[offsets[rows[i]]++] = i;
+  } else {
+    // sparse output: sort update ids instead of scanning all rows
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const sd::LongType a, const sd::LongType b) {
+      return rows[a] < rows[b] || (rows[a] == rows[b] && a < b);
+    });
+
+    for (sd::LongType k = 0; k < numUpdates; ++k)
+      if (k == 0 || rows[order[k]] != rows[order[k - 1]]) bounds.push_back(k);
+  }
+  bounds.push_back(numUpdates);
 
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        NDArray outSubArr = output(indices.e<sd::LongType>(i), std::vector<sd::LongType >({0}));
-        NDArray updSubArr = updates(i, dimsToExcludeUpd);
-        outSubArr.applyPairwiseTransform(op, updSubArr);
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto g = start; g < stop; g++) {
+      for (sd::LongType k = bounds[g]; k < bounds[g + 1]; ++k) {
+        X* zRow = z + rows[order[k]] * rowLen;
+        const X* uRow = u + order[k] * rowLen;
+
+        PRAGMA_OMP_SIMD
+        for (sd::LongType j = 0; j < rowLen; ++j) zRow[j] = Op::apply(zRow[j], uRow[j]);
       }
-    };
+    }
+  };
 
-    samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
-  }
+  const sd::LongType numGroups = bounds.size() - 1;
+  samediff::Threads::parallel_dynamic(func, 0, numGroups, 1, sd::Environment::getInstance().maxMasterThreads(),
+                                      sd::math::sd_max<sd::LongType>(1, 256 / rowLen));
 }
 
 ///////////////////////////////////////////////////////////////////
-void scatterND(sd::LaunchContext* context, pairwise::Ops op, const NDArray& indices, const NDArray& updates,
-               NDArray& output, const bool lock) {
-  const sd::LongType indLen = indices.lengthOf();
-  const int outRank = output.rankOf();
-  const int indRank = indices.rankOf();
-  const sd::LongType indLastDim = indices.sizeAt(-1);
+template <typename X, typename Op>
+static void scatterRows_(X* z, const X* u, const std::vector<sd::LongType>& rows, const sd::LongType numRows,
+                         const sd::LongType rowLen, const bool lock) {
+  const sd::LongType numUpdates = rows.size();
+  const sd::LongType outLen = numRows * rowLen;
+  const int maxThreads = sd::Environment::getInstance().maxMasterThreads();
 
-  if (outRank == 1) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        sd::LongType idx = indices.e<sd::LongType>(i);
-        NDArray out = output({idx, idx + 1});
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      X* zRow = z + rows[i] * rowLen;
+      const X* uRow = u + i * rowLen;
 
-        out.applyPairwiseTransform(op, updates.e(i), nullptr);
-      }
-    };
+      PRAGMA_OMP_SIMD
+      for (sd::LongType j = 0; j < rowLen; ++j) zRow[j] = Op::apply(zRow[j], uRow[j]);
+    }
+  };
 
-    samediff::Threads::parallel_tad(func, 0, indLen, 1, lock ? 1 : sd::Environment::getInstance().maxThreads());
+  if (maxThreads <= 1 || numUpdates < 2 || numUpdates * rowLen < kScatterSerialLimit) {
+    func(0, 0, numUpdates, 1);
+  } else if (!lock) {
+    samediff::Threads::parallel_for(func, 0, numUpdates);
+  } else if (Op::kAccumulative && numUpdates >= 2 * numRows && outLen <= kScatterPrivateLimit) {
+    scatterPrivate_<X, Op>(z, u, rows, outLen, rowLen, sd::math::sd_min<sd::LongType>(maxThreads, numUpdates / numRows));
+  } else if (Op::kAtomic && kScatterHasCas && numRows >= 4 * numUpdates && rowLen <= kScatterAtomicRowLen) {
+    scatterAtomic_<X, Op>(z, u, rows, rowLen, std::integral_constant<bool, Op::kAtomic>());
   } else {
-    std::vector<sd::LongType> dims = {indRank - 1};
-    std::vector<sd::LongType > *dimsToExcludeInd = ShapeUtils::evalDimsToExclude(indRank, dims.size(),dims.data());
-    std::vector<sd::LongType > dimsToExcludeUpd(indRank - 1);
-    std::iota(dimsToExcludeUpd.begin(), dimsToExcludeUpd.end(), 0);
+    scatterPartitioned_<X, Op>(z, u, rows, numRows, rowLen);
+  }
+}
 
-    auto func = PRAGMA_THREADS_FOR {
-      std::vector<sd::LongType> idxRangeOut(2 * outRank, 0);
+///////////////////////////////////////////////////////////////////
+template <typename X>
+static void scatterTyped_(pairwise::Ops op, NDArray& output, const NDArray& updates,
+                          const std::vector<sd::LongType>& rows, const sd::LongType numRows, const bool lock) {
+  auto z = output.bufferAsT<X>();
+  auto u = updates.bufferAsT<X>();
+  const sd::LongType rowLen = output.lengthOf() / numRows;
+
+  switch (op) {
+    case pairwise::Add:
+      scatterRows_<X, ScatterAdd<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::Subtract:
+      scatterRows_<X, ScatterSubtract<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::Multiply:
+      scatterRows_<X, ScatterMultiply<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::Divide:
+      scatterRows_<X, ScatterDivide<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::MaxPairwise:
+      scatterRows_<X, ScatterMax<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::MinPairwise:
+      scatterRows_<X, ScatterMin<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    case pairwise::CopyPws:
+      scatterRows_<X, ScatterCopy<X>>(z, u, rows, numRows, rowLen, lock);
+      break;
+    default:
+      THROW_EXCEPTION("scatter: unsupported pairwise op !");
+  }
+}
 
-      for (auto i = start; i < stop; i++) {
-        NDArray indSubArr = indices(i, *dimsToExcludeInd);
-        for (sd::LongType j = 0; j < indLastDim; ++j) {
-          idxRangeOut[2 * j] = indSubArr.e<sd::LongType>(j);
-          idxRangeOut[2 * j + 1] = idxRangeOut[2 * j] + 1;
+///////////////////////////////////////////////////////////////////
+// each consecutive rowDims.size() indices address one row of output, returns number of out-of-range indices
+template <typename I>
+static sd::LongType scatterRowIds_(const NDArray& indices, const std::vector<sd::LongType>& rowDims,
+                                   std::vector<sd::LongType>& rows) {
+  const I* x = indices.bufferAsT<I>();
+  const sd::LongType numDims = rowDims.size();
+  std::atomic<sd::LongType> numOfBadIndx{0};
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++) {
+      sd::LongType row = 0;
+      for (sd::LongType d = 0; d < numDims; ++d) {
+        const sd::LongType idx = x[i * numDims + d];
+        if (idx < 0 || idx >= rowDims[d]) {
+          ++numOfBadIndx;
+          row = 0;
+          break;
         }
+        row = row * rowDims[d] + idx;
+      }
+      rows[i] = row;
+    }
+  };
 
-        NDArray outSubArr = output(idxRangeOut);
-        NDArray updSubArr = updates(i, dimsToExcludeUpd);
+  samediff::Threads::parallel_for(func, 0, static_cast<sd::LongType>(rows.size()));
 
-        outSubArr.applyPairwiseTransform(op, updSubArr);
-      }
-    };
+  return numOfBadIndx;
+}
+
+// returns arr itself if it is c-contiguous and of given type, otherwise a c-ordered copy to be deleted by caller
+static const NDArray* scatterContiguous(const NDArray& arr, const sd::DataType dtype) {
+  if (arr.dataType() == dtype && arr.ordering() == 'c' && arr.ews() == 1) return &arr;
+
+  auto result = new NDArray('c', arr.getShapeAsVector(), dtype, arr.getContext());
+  result->assign(arr);
+  return result;
+}
+
+static void scatterEngine(pairwise::Ops op, const NDArray& indices, const std::vector<sd::LongType>& rowDims,
+                          const NDArray& updates, NDArray& output, const bool lock) {
+  if (output.isEmpty() || indices.isEmpty()) return;
+
+  const sd::LongType numRows =
+      std::accumulate(rowDims.begin(), rowDims.end(), static_cast<sd::LongType>(1), std::multiplies<sd::LongType>());
+  const sd::LongType numUpdates = indices.lengthOf() / rowDims.size();
 
-    samediff::Threads::parallel_tad(func, 0, indLen / indLastDim, 1,
-                                    lock ? 1 : sd::Environment::getInstance().maxThreads());
+  if (numRows == 0 || updates.lengthOf() != numUpdates * (output.lengthOf() / numRows))
+    THROW_EXCEPTION("scatter: length of updates doesn't match shapes of indices and output !");
 
-    delete dimsToExcludeInd;
+  std::vector<sd::LongType> rows(numUpdates);
+  auto ind = scatterContiguous(indices, indices.dataType());
+  sd::LongType numOfBadIndx;
+  BUILD_SINGLE_SELECTOR(ind->dataType(), numOfBadIndx = scatterRowIds_, (*ind, rowDims, rows), SD_INTEGER_TYPES);
+  if (ind != &indices) delete ind;
 
+  if (numOfBadIndx > 0) THROW_EXCEPTION("scatter: indices array contains out of range elements !");
+
+  auto upd = scatterContiguous(updates, output.dataType());
+  auto out = output.ordering() == 'c' && output.ews() == 1 ? &output : new NDArray(output.dup('c'));
+
+  BUILD_SINGLE_SELECTOR(out->dataType(), scatterTyped_, (op, *out, *upd, rows, numRows, lock), SD_NUMERIC_TYPES);
+
+  if (out != &output) {
+    output.assign(*out);
+    delete out;
   }
+  if (upd != &updates) delete upd;
+}
+
+///////////////////////////////////////////////////////////////////
+void scatter(sd::LaunchContext* context, pairwise::Ops op, const NDArray& indices, const NDArray& updates,
+             NDArray& output, const bool lock) {
+  // i-th element of indices picks i-th sub-array of output along dimension 0
+  scatterEngine(op, indices, {output.sizeAt(0)}, updates, output, lock);
+}
+
+///////////////////////////////////////////////////////////////////
+void scatterND(sd::LaunchContext* context, pairwise::Ops op, const NDArray& indices, const NDArray& updates,
+               NDArray& output, const bool lock) {
+  // each vector along last dimension of indices picks sub-array of output by its leading coordinates
+  const sd::LongType indLastDim = indices.sizeAt(-1);
+  const auto outShape = output.getShapeAsVector();
+
+  scatterEngine(op, indices, std::vector<sd::LongType>(outShape.begin(), outShape.begin() + indLastDim), updates,
+                output, lock);
 }
 
 void scatterForLoss(sd::LaunchContext* context, const NDArray& indices, NDArray& updates, NDArray& output,
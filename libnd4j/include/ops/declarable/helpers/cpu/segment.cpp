@@ -24,272 +24,425 @@
 #include <execution/Threads.h>
 #include <helpers/ShapeUtils.h>
 #include <ops/declarable/helpers/segment.h>
-#include <helpers/ConstantTadHelper.h>
 
-#include <unordered_map>
+#include <memory>
 #if NOT_EXCLUDED(OP_segment)
 namespace sd {
 namespace ops {
 namespace helpers {
 
-// segment max
+// -------------------------------------------------------------------------------------------------------------- //
+// Segment engine
+//
+// Both sorted and unsorted segment ops are executed the same way: input is viewed as [numOfRows, rowLen] matrix,
+// rows are grouped by their segment id with a single counting sort pass, and every output row is then owned by
+// exactly one task. Tasks are spread over (segment, column block) pairs, so neither many small segments nor few
+// wide ones serialize, and inner loops run over contiguous columns.
+// -------------------------------------------------------------------------------------------------------------- //
+
+enum class SegmentReduction { Max, Min, Sum, Mean, Prod, SqrtN };
+
+// number of columns processed by a single task
+static const sd::LongType SEGMENT_COLUMN_BLOCK = 1024;
+// minimal number of rows worth splitting a single segment between threads
+static const sd::LongType SEGMENT_SPLIT_ROWS = 8192;
+
 template <typename T>
-static void segmentMaxFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // max
-        val = sd::math::sd_max<T>(val, input->t<T>(e));
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
-      }
-      output->r<T>(idx) = val;
-    }
+struct SegmentAccumulator {
+  using type = T;
+};
+
+template <>
+struct SegmentAccumulator<float16> {
+  using type = float;
+};
+
+template <>
+struct SegmentAccumulator<bfloat16> {
+  using type = float;
+};
+
+template <typename A>
+struct SegmentMaxOp {
+  static SD_INLINE A op(const A a, const A b) { return sd::math::sd_max<A>(a, b); }
+};
+
+template <typename A>
+struct SegmentMinOp {
+  static SD_INLINE A op(const A a, const A b) { return sd::math::sd_min<A>(a, b); }
+};
+
+template <typename A>
+struct SegmentSumOp {
+  static SD_INLINE A op(const A a, const A b) { return a + b; }
+};
+
+template <typename A>
+struct SegmentProdOp {
+  static SD_INLINE A op(const A a, const A b) { return a * b; }
+};
+
+// rows of every segment, laid out one segment after another: rows of segment c are order[offsets[c]..offsets[c+1])
+struct SegmentGroups {
+  std::vector<sd::LongType> classes;
+  std::vector<sd::LongType> offsets;
+  std::vector<sd::LongType> order;
+
+  sd::LongType count(const sd::LongType c) const { return offsets[c + 1] - offsets[c]; }
+};
+
+template <typename I>
+static void segmentClasses_(const NDArray* indices, sd::LongType* classes) {
+  const auto numOfRows = indices->lengthOf();
+  const auto ews = indices->ews();
+
+  if (ews > 0) {
+    const auto idx = indices->bufferAsT<I>();
+    for (sd::LongType i = 0; i < numOfRows; i++) classes[i] = static_cast<sd::LongType>(idx[i * ews]);
   } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    auto numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto maxT = listOfOutTensors.at(idx);
-
-    // int pos = 0;
-    maxT->assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<int>(i) == idx) {
-        for (sd::LongType e = 0; e < maxT->lengthOf(); e++) {
-          maxT->r<T>(e) = sd::math::sd_max(maxT->t<T>(e), listOfTensors.at(i)->t<T>(e));
-        }
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        maxT = listOfOutTensors.at(idx);
-        maxT->assign(listOfTensors.at(i));
-      }
-    }
+    for (sd::LongType i = 0; i < numOfRows; i++) classes[i] = indices->e<sd::LongType>(i);
   }
 }
 
-// segmen min
-template <typename T>
-static void segmentMinFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // min
-        val = sd::math::sd_min<T>(val, input->t<T>(e));
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
+static SegmentGroups segmentGroups(const NDArray* indices, const sd::LongType numOfClasses) {
+  const auto numOfRows = indices->lengthOf();
+
+  SegmentGroups groups;
+  groups.classes.resize(numOfRows);
+  groups.offsets.assign(numOfClasses + 1, 0);
+  groups.order.resize(numOfRows);
+
+  BUILD_SINGLE_SELECTOR(indices->dataType(), segmentClasses_, (indices, groups.classes.data()), SD_INTEGER_TYPES);
+
+  for (sd::LongType i = 0; i < numOfRows; i++) {
+    const auto c = groups.classes[i];
+    if (c < 0 || c >= numOfClasses)
+      THROW_EXCEPTION("segment ops: segment index is out of range [0, number of segments)");
+    groups.offsets[c + 1]++;
+  }
+
+  for (sd::LongType c = 0; c < numOfClasses; c++) groups.offsets[c + 1] += groups.offsets[c];
+
+  // stable placement keeps rows of every segment in their original order
+  std::vector<sd::LongType> cursor(groups.offsets.begin(), groups.offsets.end() - 1);
+  for (sd::LongType i = 0; i < numOfRows; i++) groups.order[cursor[groups.classes[i]]++] = i;
+
+  return groups;
+}
+
+// length of the trailing [1:] part of input, which is reduced element-wise
+static sd::LongType segmentRowLength(const NDArray* input) {
+  return input->rankOf() > 1 ? input->lengthOf() / input->sizeAt(0) : 1;
+}
+
+// returns array itself if it's dense c-ordered and has given type, or a dense copy otherwise
+static NDArray* segmentDense(NDArray* array, const sd::DataType dtype) {
+  if (array->dataType() == dtype && array->ews() == 1 && (array->ordering() == 'c' || array->rankOf() <= 1))
+    return array;
+
+  auto dense = new NDArray('c', array->getShapeAsVector(), dtype, array->getContext());
+  dense->assign(array);
+  return dense;
+}
+
+// writes reduced accumulator into output row, applying mean/sqrt_n normalization
+template <typename T, typename A>
+static SD_INLINE void segmentStore(const A* acc, const sd::LongType len, const sd::LongType count,
+                                   const SegmentReduction reduction, T* zRow) {
+  if (reduction == SegmentReduction::Mean || reduction == SegmentReduction::SqrtN) {
+    const double divisor = reduction == SegmentReduction::Mean ? static_cast<double>(count)
+                                                               : sd::math::sd_sqrt<double, double>(count);
+    for (sd::LongType k = 0; k < len; k++) zRow[k] = static_cast<T>(static_cast<double>(acc[k]) / divisor);
+  } else {
+    PRAGMA_OMP_SIMD
+    for (sd::LongType k = 0; k < len; k++) zRow[k] = static_cast<T>(acc[k]);
+  }
+}
+
+template <typename T, typename A, typename OP>
+static void segmentReduce_(const T* x, const SegmentGroups& groups, const sd::LongType rowLen, T* z, const T emptyValue,
+                           const SegmentReduction reduction) {
+  const auto numOfRows = static_cast<sd::LongType>(groups.classes.size());
+  const auto numOfClasses = static_cast<sd::LongType>(groups.offsets.size()) - 1;
+  const auto numOfBlocks = (rowLen + SEGMENT_COLUMN_BLOCK - 1) / SEGMENT_COLUMN_BLOCK;
+  const auto numThreads = sd::Environment::getInstance().maxMasterThreads();
+  const auto offsets = groups.offsets.data();
+  const auto order = groups.order.data();
+  const auto classes = groups.classes.data();
+
+  if (numOfClasses * numOfBlocks < numThreads && numOfRows >= SEGMENT_SPLIT_ROWS) {
+    // too few output rows to keep all threads busy: rows are split between threads instead, every thread reduces its
+    // share into private partials, which are merged afterwards
+    const auto outLen = numOfClasses * rowLen;
+    std::unique_ptr<A[]> partials(new A[numThreads * outLen]);
+    std::vector<int8_t> touched(numThreads * numOfClasses, 0);
+
+    auto func = PRAGMA_THREADS_FOR {
+      auto p = partials.get() + thread_id * outLen;
+      auto t = touched.data() + thread_id * numOfClasses;
+
+      for (auto r = start; r < stop; r++) {
+        const auto c = classes[r];
+        const auto xRow = x + r * rowLen;
+        auto pRow = p + c * rowLen;
+
+        if (t[c]) {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < rowLen; k++) pRow[k] = OP::op(pRow[k], static_cast<A>(xRow[k]));
+        } else {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < rowLen; k++) pRow[k] = static_cast<A>(xRow[k]);
+          t[c] = 1;
+        }
+      }
+    };
+
+    samediff::Threads::parallel_for(func, 0, numOfRows, 1, numThreads);
+
+    std::unique_ptr<A[]> acc(new A[rowLen]);
+    for (sd::LongType c = 0; c < numOfClasses; c++) {
+      auto zRow = z + c * rowLen;
+      bool first = true;
+
+      for (sd::LongType e = 0; e < numThreads; e++) {
+        if (!touched[e * numOfClasses + c]) continue;
+
+        const auto pRow = partials.get() + e * outLen + c * rowLen;
+        if (first) {
+          for (sd::LongType k = 0; k < rowLen; k++) acc[k] = pRow[k];
+          first = false;
+        } else {
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < rowLen; k++) acc[k] = OP::op(acc[k], pRow[k]);
+        }
       }
-      output->r<T>(idx) = val;
+
+      if (first)
+        for (sd::LongType k = 0; k < rowLen; k++) zRow[k] = emptyValue;
+      else
+        segmentStore<T, A>(acc.get(), rowLen, groups.count(c), reduction, zRow);
     }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto minT = listOfOutTensors.at(idx);
-
-    int pos = 0;
-    minT->assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        for (sd::LongType e = 0; e < minT->lengthOf(); e++) {
-          minT->p(e, sd::math::sd_min(minT->e<T>(e), listOfTensors.at(i)->e<T>(e)));
+
+    return;
+  }
+
+  auto func = PRAGMA_THREADS_FOR_2D {
+    std::unique_ptr<A[]> acc(new A[sd::math::sd_min<sd::LongType>(rowLen, SEGMENT_COLUMN_BLOCK)]);
+
+    for (auto c = start_x; c < stop_x; c += inc_x) {
+      for (auto b = start_y; b < stop_y; b += inc_y) {
+        const auto first = b * SEGMENT_COLUMN_BLOCK;
+        const auto len = sd::math::sd_min<sd::LongType>(rowLen - first, SEGMENT_COLUMN_BLOCK);
+        const auto begin = offsets[c];
+        const auto end = offsets[c + 1];
+        auto zRow = z + c * rowLen + first;
+
+        if (begin == end) {
+          for (sd::LongType k = 0; k < len; k++) zRow[k] = emptyValue;
+          continue;
         }
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        minT = listOfOutTensors.at(idx);
-        minT->assign(listOfTensors.at(i));
+
+        auto xRow = x + order[begin] * rowLen + first;
+        PRAGMA_OMP_SIMD
+        for (sd::LongType k = 0; k < len; k++) acc[k] = static_cast<A>(xRow[k]);
+
+        for (auto r = begin + 1; r < end; r++) {
+          xRow = x + order[r] * rowLen + first;
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < len; k++) acc[k] = OP::op(acc[k], static_cast<A>(xRow[k]));
+        }
+
+        segmentStore<T, A>(acc.get(), len, end - begin, reduction, zRow);
       }
     }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numOfClasses, 1, 0, numOfBlocks, 1);
+}
+
+template <typename T>
+static void segmentReduce(const T* x, const SegmentGroups& groups, const sd::LongType rowLen, T* z, const T emptyValue,
+                          const SegmentReduction reduction) {
+  using A = typename SegmentAccumulator<T>::type;
+
+  switch (reduction) {
+    case SegmentReduction::Max:
+      segmentReduce_<T, A, SegmentMaxOp<A>>(x, groups, rowLen, z, emptyValue, reduction);
+      break;
+    case SegmentReduction::Min:
+      segmentReduce_<T, A, SegmentMinOp<A>>(x, groups, rowLen, z, emptyValue, reduction);
+      break;
+    case SegmentReduction::Prod:
+      segmentReduce_<T, A, SegmentProdOp<A>>(x, groups, rowLen, z, emptyValue, reduction);
+      break;
+    default:
+      segmentReduce_<T, A, SegmentSumOp<A>>(x, groups, rowLen, z, emptyValue, reduction);
   }
 }
 
-// segmen mean
+// value written into segments without any row: sorted ops leave them zeroed except for prod, which gives one,
+// unsorted ones follow TF conventions
 template <typename T>
-static void segmentMeanFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  int idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = T(0.f);
-    int count = 0;
-
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // mean
-        val += input->e<T>(e);
-        count++;
-      } else {
-        output->p<T>(idx, val / count);
-        idx = indices->e<sd::LongType>(e);
-        val = input->e<T>(e);
-        count = 1;
-      }
-      output->p<T>(idx, val / count);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto meanT = listOfOutTensors.at(idx);
-    int count = 1;
-    auto meanV = meanT->dup();
-    meanV.assign(listOfTensors.at(0));
-
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            meanV.p<T>(e, meanV.e<T>(e) + listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, meanT->lengthOf());
-
-        count++;
-      } else {
-        // meanT->assign(meanV);
-        meanV.applyScalar(scalar::Divide, count, *meanT);
-        idx = indices->e<sd::LongType>(i);
-        meanT = listOfOutTensors.at(idx);
-        meanV.assign(listOfTensors.at(i));
-        count = 1;
-      }
-      meanV.applyScalar(scalar::Divide, count, *meanT);
-    }
+static T segmentEmptyValue(const SegmentReduction reduction, const bool unsorted) {
+  if (!unsorted) return static_cast<T>(reduction == SegmentReduction::Prod ? 1 : 0);
+
+  switch (reduction) {
+    case SegmentReduction::Max:
+      return -DataTypeUtils::max<T>();
+    case SegmentReduction::Min:
+      return DataTypeUtils::max<T>();
+    case SegmentReduction::Prod:
+      return static_cast<T>(1);
+    default:
+      return static_cast<T>(0);
   }
 }
 
 template <typename T>
-static void segmentSumFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  int idx = indices->e<int>(0);
-  if (input->isVector() || input->isScalar()) {
-    T val = T(0.f);
-    int count = 0;
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // sum
-        val += input->t<T>(e);
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->t<T>(e);
-      }
-      output->p(idx, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    std::vector<std::pair<NDArray*, sd::LongType>> outputs(numOfClasses);
-    auto sumT = listOfOutTensors.at(idx);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            sumT->p(e, sumT->e<T>(e) + listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-      } else {
-        idx = indices->e<sd::LongType>(i);
-        sumT = listOfOutTensors.at(idx);
-        sumT->assign(listOfTensors.at(i));
-      }
-    }
+static void segmentFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output,
+                            SegmentReduction reduction, bool unsorted) {
+  if (indices->lengthOf() == 0 || numOfClasses == 0) return;
+
+  const auto rowLen = output->lengthOf() / numOfClasses;
+  const auto groups = segmentGroups(indices, numOfClasses);
+
+  auto x = segmentDense(input, input->dataType());
+  auto z = segmentDense(output, input->dataType());
+
+  segmentReduce<T>(x->bufferAsT<T>(), groups, rowLen, z->bufferAsT<T>(), segmentEmptyValue<T>(reduction, unsorted),
+                   reduction);
+
+  if (z != output) {
+    output->assign(z);
+    delete z;
   }
+  if (x != input) delete x;
 }
 
+BUILD_SINGLE_TEMPLATE(template void segmentFunctor_,
+                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output,
+                       SegmentReduction reduction, bool unsorted),
+                      SD_COMMON_TYPES);
+
 template <typename T>
-static void segmentProdFunctor_(NDArray* input, NDArray* indices, NDArray* output) {
-  // int numClasses = output->sizeAt(0);
-  int idx = indices->e<sd::LongType>(0);
-  output->assign(1.f);
-  if (input->isVector() || input->isScalar()) {
-    T val = input->e<T>(0);
-    int count = 0;
-
-    for (sd::LongType e = 1; e < indices->lengthOf(); e++) {
-      if (idx == indices->e<sd::LongType>(e)) {
-        // sum
-        val *= input->e<T>(e);
-      } else {
-        idx = indices->e<sd::LongType>(e);
-        val = input->e<T>(e);
-      }
-      output->p(idx, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int numOfClasses = output->sizeAt(0);  // number of classes
-    auto sumT = listOfOutTensors.at(idx);
-    sumT->assign(listOfTensors.at(0));
-    for (sd::LongType i = 1; i < indices->lengthOf(); i++) {
-      if (indices->e<sd::LongType>(i) == idx) {
-        auto func = PRAGMA_THREADS_FOR {
-          for (auto e = start; e < stop; e++) {
-            sumT->p(e, sumT->e<T>(e) * listOfTensors.at(i)->e<T>(e));
-          }
-        };
-        samediff::Threads::parallel_for(func, 0, sumT->lengthOf());
-      } else {
-        idx = indices->e<int>(i);
-        sumT = listOfOutTensors.at(idx);
-        sumT->assign(listOfTensors.at(i));
-      }
+static sd::Status segmentFunctorBP_(NDArray* input, NDArray* indices, NDArray* gradOut, NDArray* output,
+                                    SegmentReduction reduction) {
+  if (indices->lengthOf() == 0) return sd::Status::OK;
+
+  const auto rowLen = segmentRowLength(input);
+  const auto numOfRows = indices->lengthOf();
+  const auto numOfClasses = gradOut->lengthOf() / rowLen;
+  const auto numOfBlocks = (rowLen + SEGMENT_COLUMN_BLOCK - 1) / SEGMENT_COLUMN_BLOCK;
+  const auto groups = segmentGroups(indices, numOfClasses);
+
+  auto x = segmentDense(input, output->dataType());
+  auto gO = segmentDense(gradOut, output->dataType());
+  auto z = segmentDense(output, output->dataType());
+
+  const auto xBuf = x->bufferAsT<T>();
+  const auto gBuf = gO->bufferAsT<T>();
+  auto zBuf = z->bufferAsT<T>();
+  const auto classes = groups.classes.data();
+
+  // max, min and prod gradients depend on forward result
+  std::unique_ptr<T[]> forward;
+  if (reduction == SegmentReduction::Max || reduction == SegmentReduction::Min ||
+      reduction == SegmentReduction::Prod) {
+    forward.reset(new T[numOfClasses * rowLen]);
+    segmentReduce<T>(xBuf, groups, rowLen, forward.get(), static_cast<T>(0), reduction);
+  }
+  const auto fBuf = forward.get();
+
+  // per-segment scale for mean and sqrt_n
+  std::vector<T> scale;
+  if (reduction == SegmentReduction::Mean || reduction == SegmentReduction::SqrtN) {
+    scale.resize(numOfClasses);
+    for (sd::LongType c = 0; c < numOfClasses; c++) {
+      const auto n = static_cast<double>(sd::math::sd_max<sd::LongType>(groups.count(c), 1));
+      scale[c] = static_cast<T>(reduction == SegmentReduction::Mean ? n : sd::math::sd_sqrt<double, double>(n));
     }
   }
+
+  auto func = PRAGMA_THREADS_FOR_2D {
+    for (auto i = start_x; i < stop_x; i += inc_x) {
+      const auto c = classes[i];
+      const auto first = start_y * SEGMENT_COLUMN_BLOCK;
+      const auto len = sd::math::sd_min<sd::LongType>(rowLen, stop_y * SEGMENT_COLUMN_BLOCK) - first;
+      const auto xRow = xBuf + i * rowLen + first;
+      const auto gRow = gBuf + c * rowLen + first;
+      auto zRow = zBuf + i * rowLen + first;
+
+      switch (reduction) {
+        case SegmentReduction::Max:
+        case SegmentReduction::Min: {
+          // gradient goes to every element equal to segment extremum
+          const auto fRow = fBuf + c * rowLen + first;
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < len; k++)
+            zRow[k] = sd::math::sd_abs<T>(fRow[k] - xRow[k]) <= static_cast<T>(1.e-5) ? gRow[k] : static_cast<T>(0);
+        } break;
+        case SegmentReduction::Prod: {
+          const auto fRow = fBuf + c * rowLen + first;
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < len; k++) zRow[k] = fRow[k] * gRow[k] / xRow[k];
+        } break;
+        case SegmentReduction::Mean:
+        case SegmentReduction::SqrtN: {
+          const T s = scale[c];
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < len; k++) zRow[k] = gRow[k] / s;
+        } break;
+        default:
+          PRAGMA_OMP_SIMD
+          for (sd::LongType k = 0; k < len; k++) zRow[k] = gRow[k];
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, numOfRows, 1, 0, numOfBlocks, 1);
+
+  if (z != output) {
+    output->assign(z);
+    delete z;
+  }
+  if (gO != gradOut) delete gO;
+  if (x != input) delete x;
+
+  return sd::Status::OK;
 }
 
+BUILD_SINGLE_TEMPLATE(template sd::Status segmentFunctorBP_,
+                      (NDArray * input, NDArray* indices, NDArray* gradOut, NDArray* output,
+                       SegmentReduction reduction),
+                      SD_NUMERIC_TYPES);
+
+// -------------------------------------------------------------------------------------------------------------- //
+// Sorted segment ops
+// -------------------------------------------------------------------------------------------------------------- //
 
 void segmentMaxFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), segmentMaxFunctor_, (input, indices, output), SD_COMMON_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, output->sizeAt(0), output, SegmentReduction::Max, false), SD_COMMON_TYPES);
 }
 
 void segmentMinFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), segmentMinFunctor_, (input, indices, output), SD_COMMON_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, output->sizeAt(0), output, SegmentReduction::Min, false), SD_COMMON_TYPES);
 }
 
 void segmentMeanFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), segmentMeanFunctor_, (input, indices, output), SD_COMMON_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, output->sizeAt(0), output, SegmentReduction::Mean, false), SD_COMMON_TYPES);
 }
 
 void segmentSumFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), segmentSumFunctor_, (input, indices, output), SD_COMMON_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, output->sizeAt(0), output, SegmentReduction::Sum, false), SD_COMMON_TYPES);
 }
 
 void segmentProdFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), segmentProdFunctor_, (input, indices, output), SD_COMMON_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, output->sizeAt(0), output, SegmentReduction::Prod, false), SD_COMMON_TYPES);
 }
 
 bool segmentIndicesValidate(sd::LaunchContext* context, NDArray* indices, NDArray& expected, NDArray& output) {
@@ -303,17 +456,6 @@ bool segmentIndicesValidate(sd::LaunchContext* context, NDArray* indices, NDArra
   return true;
 }
 
-// BUILD_SINGLE_TEMPLATE(template bool segmentIndicesValidate_, (NDArray*, NDArray&, NDArray&), SD_COMMON_TYPES);
-BUILD_SINGLE_TEMPLATE(template void segmentProdFunctor_, (NDArray * input, NDArray* indices, NDArray* output),
-                      SD_COMMON_TYPES);
-BUILD_SINGLE_TEMPLATE(template void segmentSumFunctor_, (NDArray * input, NDArray* indices, NDArray* output),
-                      SD_COMMON_TYPES);
-BUILD_SINGLE_TEMPLATE(template void segmentMeanFunctor_, (NDArray * input, NDArray* indices, NDArray* output),
-                      SD_COMMON_TYPES);
-BUILD_SINGLE_TEMPLATE(template void segmentMinFunctor_, (NDArray * input, NDArray* indices, NDArray* output),
-                      SD_COMMON_TYPES);
-BUILD_SINGLE_TEMPLATE(template void segmentMaxFunctor_, (NDArray * input, NDArray* indices, NDArray* output),
-                      SD_COMMON_TYPES);
 // -------------------------------------------------------------------------------------------------------------- //
 // Unsorted segment ops
 // -------------------------------------------------------------------------------------------------------------- //
@@ -331,261 +473,40 @@ bool unsortedSegmentIndicesValidate(sd::LaunchContext* context, NDArray* indices
   return true;
 }
 
-template <typename T>
-static void unsortedSegmentMaxFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(-maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T val = input->e<T>(fi->second.at(0));
-      for (sd::LongType idx = 1; idx < static_cast<sd::LongType>(fi->second.size()); ++idx) {
-        val = sd::math::sd_max(val, input->e<T>(fi->second.at(idx)));
-      }
-      output->p(fi->first, val);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(-maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (sd::LongType idx = 0; idx < listOfTensors.size(); ++idx) {
-        if (idx >= fi->second.size() || fi->second.size() < 2 || fi->second.at(idx) >= listOfTensors.size()) {
-          continue;
-        }
-
-        auto maxT = listOfTensors.at(fi->second.at(idx));
-        for (sd::LongType e = 0; e < outputT->lengthOf(); ++e) {
-          T val = sd::math::sd_max(maxT->e<T>(e), outputT->e<T>(e));
-
-          outputT->p(e, val);
-        }
-      }
-    }
-  }
-}
 void unsortedSegmentMaxFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentMaxFunctor_, (input, indices, numOfClasses, output),
-                        SD_NUMERIC_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::Max, true), SD_NUMERIC_TYPES);
 }
-BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMaxFunctor_,
-                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
-                      SD_NUMERIC_TYPES);
 
-template <typename T>
-static void unsortedSegmentMinFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T val = input->t<T>(fi->second.at(0));
-
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        val = sd::math::sd_min(val, input->t<T>(fi->second.at(idx)));
-      }
-      output->r<T>(fi->first) = val;
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    T maxVal = DataTypeUtils::max<T>();
-    output->assign(maxVal);
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto minT = listOfTensors.at(fi->second.at(idx));
-
-        for (sd::LongType e = 0; e < outputT->lengthOf(); ++e) {
-          outputT->r<T>(e) = sd::math::sd_min(minT->t<T>(e), outputT->t<T>(e));
-        }
-      }
-    }
-  }
-}
 void unsortedSegmentMinFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentMinFunctor_, (input, indices, numOfClasses, output),
-                        SD_NUMERIC_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::Min, true), SD_NUMERIC_TYPES);
 }
 
-BUILD_SINGLE_TEMPLATE(template void unsortedSegmentMinFunctor_,
-                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
-                      SD_NUMERIC_TYPES);
-
 void unsortedSegmentMeanFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                 NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      int loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (size_t idx = 1; idx < loop_size; ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
-
-      output->p(fi->first, sumValue / fi->second.size());
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    // FIXME: parallelism here?
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      sd::LongType loopSize = fi->second.size();
-
-      for (sd::LongType idx = 1; idx < loopSize; ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *outputT += *current;
-      }
-      (*outputT) /= double(fi->second.size());
-    }
-  }
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::Mean, true), SD_NUMERIC_TYPES);
 }
 
 void unsortedSegmentSumFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;  //(indices->lengthOf());
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      sd::LongType loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (sd::LongType idx = 1; idx < loop_size; ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
-      output->p(fi->first, sumValue);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      sd::LongType loop_size = fi->second.size();
-
-      // FIXME: parallelism here?
-      for (sd::LongType idx = 1; idx < loop_size; ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *(outputT) += *current;
-      }
-    }
-  }
-}
-
-template <typename T>
-void unsortedSegmentProdFunctor_(NDArray* input, NDArray* indices, sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;  //(indices->lengthOf());
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-  output->assign(1.f);
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      T prodValue = input->e<T>(fi->second.at(0));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        prodValue *= input->e<T>(fi->second.at(idx));
-      }
-      output->p(fi->first, prodValue);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-
-        *outputT *= *current;
-      }
-    }
-  }
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::Sum, true), SD_NUMERIC_TYPES);
 }
 
 void unsortedSegmentProdFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices, sd::LongType numOfClasses,
                                 NDArray* output) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), unsortedSegmentProdFunctor_, (input, indices, numOfClasses, output),
-                        SD_NUMERIC_TYPES);
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::Prod, true), SD_NUMERIC_TYPES);
 }
-BUILD_SINGLE_TEMPLATE(template void unsortedSegmentProdFunctor_,
-                      (NDArray * input, NDArray* indices, sd::LongType numOfClasses, NDArray* output),
-                      SD_NUMERIC_TYPES);
 
 void unsortedSegmentSqrtNFunctor(sd::LaunchContext* context, NDArray* input, NDArray* indices,
                                  sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, std::vector<sd::LongType>> idxs;
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) idxs[indices->e<sd::LongType>(e)].push_back(e);
-
-
-  if (input->isVector() || input->isScalar()) {  // 1D case
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      double sumValue = input->e<double>(fi->second.at(0));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        sumValue += input->e<double>(fi->second.at(idx));
-      }
-      output->p(fi->first, sumValue / sd::math::sd_sqrt<sd::LongType, double>(fi->second.size()));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    auto listOfTensors = input->allTensorsAlongDimension(*restDims);
-    auto listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (auto fi = idxs.begin(); fi != idxs.end(); ++fi) {
-      auto outputT = listOfOutTensors.at(fi->first);
-      outputT->assign(listOfTensors.at(fi->second.at(0)));
-      for (size_t idx = 1; idx < fi->second.size(); ++idx) {
-        auto current = listOfTensors.at(fi->second.at(idx));
-        *outputT += *current;
-      }
-      (*outputT) /= sd::math::sd_sqrt<size_t, double>(fi->second.size());
-    }
-  }
+  BUILD_SINGLE_SELECTOR(input->dataType(), segmentFunctor_,
+                        (input, indices, numOfClasses, output, SegmentReduction::SqrtN, true), SD_NUMERIC_TYPES);
 }
 
 // -------------------------------------------------------------------------------------------------------------- //
@@ -593,464 +514,77 @@ void unsortedSegmentSqrtNFunctor(sd::LaunchContext* context, NDArray* input, NDA
 // -------------------------------------------------------------------------------------------------------------- //
 // Sorted backpropagate ops
 //
-// segment max
-template <typename T>
-sd::Status segmentMaxFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
-                                NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  auto tempRes = gradOut->dup();
-  segmentMaxFunctor_<T>(input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    sd::LongType loop_size = input->lengthOf();
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs(tempRes.e<T>(classNum) - input->e<T>(e)) <= T(1.e-6))
-          output->p(e, gradOut->e<T>(classNum));
-      }
-    };
-    samediff::Threads::parallel_for(func, 0, loop_size);
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        auto classNum = indices->e<sd::LongType>(i);
-        auto current = listOfTensors.at(i);
-        auto currentOut = listOfOutTensors.at(i);
-        auto currentGradOut = listOfGradOuts.at(classNum);
-
-        for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-          if (sd::math::sd_abs(listOfBPTensors.at(classNum)->e<T>(e) - current->e<T>(e)) <= T(1.e-6))
-            currentOut->p(e, currentGradOut->e<T>(e));
-        }
-      }
-    };
-
-    samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-  }
-
-  return sd::Status::OK;
-}
-
 sd::Status segmentMaxFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                NDArray* output) {
-  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentMaxFunctorBP_, (context, input, indices, gradOut, output),
-                        SD_NUMERIC_TYPES);
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Max), SD_NUMERIC_TYPES);
 }
-BUILD_SINGLE_TEMPLATE(template sd::Status segmentMaxFunctorBP_,
-                      (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut,
-                          NDArray* output),
-                      SD_NUMERIC_TYPES);
 
-// segmen min
 sd::Status segmentMinFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                NDArray* output) {
-  NDArray tempRes = gradOut->dup();
-  segmentMinFunctor(context, input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-          output->p(e, gradOut->e<double>(classNum));
-      }
-    };
-    samediff::Threads::parallel_for(func, 0, input->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    output->assign(0.);
-    int pos = 0;
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto i = start; i < stop; i++) {
-        auto classNum = indices->e<sd::LongType>(i);
-        auto current = listOfTensors.at(i);
-        auto currentOut = listOfOutTensors.at(i);
-        auto currentGradOut = listOfGradOuts.at(classNum);
-
-        for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-          if (sd::math::sd_abs(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) < 1.e-5)
-            currentOut->p(e, currentGradOut->e<double>(e));
-        }
-      }
-    };
-
-    samediff::Threads::parallel_tad(func, 0, indices->lengthOf());
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Min), SD_NUMERIC_TYPES);
 }
 
-// segmen mean
 sd::Status segmentMeanFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                 NDArray* output) {
-  int numClasses = output->sizeAt(0);
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
-
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    int pos = 0;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-        currentOut->p(e, currentGradOut->e<double>(e) / classCount.at(classNum));
-      }
-    }
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Mean), SD_NUMERIC_TYPES);
 }
 
 sd::Status segmentSumFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                NDArray* output) {
-  //        int numClasses = output->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      currentOut->assign(currentGradOut);
-    }
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Sum), SD_NUMERIC_TYPES);
 }
 
 sd::Status segmentProdFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                 NDArray* output) {
-  auto tempRes = gradOut->dup();
-  segmentProdFunctor(context, input, indices, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum) / input->e<double>(e));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-      auto currentFFOut = listOfBPTensors.at(classNum);
-
-      currentOut->assign((*currentFFOut) * (*currentGradOut) / (*current));
-    }
-
-  }
-
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Prod), SD_NUMERIC_TYPES);
 }
 
 // -------------------------------------------------------------------------------------------------------------- //
 // Unsorted backpropagate segment ops
 // -------------------------------------------------------------------------------------------------------------- //
 
-template <typename T>
-static sd::Status unsortedSegmentMaxFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
-                                               NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
-  //        int numOfClasses = gradOut->sizeAt(0);
-  // if input is a vector: (as if in doc sample)
-  auto tempRes = gradOut->dup();
-  unsortedSegmentMaxFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < input->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      if (sd::math::sd_abs(tempRes.e<double>(classNum) - input->e<double>(e)) < 1.e-5)
-        output->p(e, gradOut->e<T>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      sd::LongType classNum = indices->e<sd::LongType>(i);
-      NDArray* current = listOfTensors.at(i);
-      NDArray* currentOut = listOfOutTensors.at(i);
-      NDArray* currentGradOut = listOfGradOuts.at(classNum);
-      for (int e = 0; e < current->lengthOf(); e++) {
-        if (sd::math::sd_abs(listOfBPTensors.at(classNum)->e<double>(e) - current->e<double>(e)) < 1.e-5)
-          currentOut->p(e, currentGradOut->e<T>(e));
-      }
-    }
-
-    delete restDims;
-  }
-
-  return sd::Status::OK;
-}
-
 sd::Status unsortedSegmentMaxFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                        sd::LongType numOfClasses, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentMaxFunctorBP_,
-                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
-}
-BUILD_SINGLE_TEMPLATE(template sd::Status unsortedSegmentMaxFunctorBP_,
-                      (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut,
-                          sd::LongType numOfClasses, NDArray* output),
-                      SD_NUMERIC_TYPES);
-
-template <typename T>
-static sd::Status unsortedSegmentMinFunctorBP_(sd::LaunchContext* context, NDArray* input, NDArray* indices,
-                                               NDArray* gradOut, sd::LongType numOfClasses, NDArray* output) {
-  auto tempRes = gradOut->dup();
-  unsortedSegmentMinFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        if (sd::math::sd_abs(tempRes.t<T>(classNum) - input->t<T>(e)) < 1.e-6)
-          output->r<T>(e) = gradOut->t<T>(classNum);
-      }
-    };
-
-    samediff::Threads::parallel_for(func, 0, input->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (sd::LongType e = 0; e < current->lengthOf(); e++) {
-        if (sd::math::sd_abs(listOfBPTensors.at(classNum)->t<T>(e) - current->t<T>(e)) < 1.e-6)
-          currentOut->r<T>(e) = currentGradOut->t<T>(e);
-      }
-    }
-
-  }
-
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Max), SD_NUMERIC_TYPES);
 }
 
 sd::Status unsortedSegmentMinFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                        sd::LongType numOfClasses, NDArray* output) {
-  BUILD_SINGLE_SELECTOR(output->dataType(), return unsortedSegmentMinFunctorBP_,
-                        (context, input, indices, gradOut, numOfClasses, output), SD_NUMERIC_TYPES);
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Min), SD_NUMERIC_TYPES);
 }
-BUILD_SINGLE_TEMPLATE(template sd::Status unsortedSegmentMinFunctorBP_,
-                      (sd::LaunchContext * context, NDArray* input, NDArray* indices, NDArray* gradOut,
-                          sd::LongType numOfClasses, NDArray* output),
-                      SD_NUMERIC_TYPES);
 
 sd::Status unsortedSegmentMeanFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                         sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numOfClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
-
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / classCount[classNum]);
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      sd::LongType classNum = indices->e<sd::LongType>(i);
-      NDArray* current = listOfTensors.at(i);
-      NDArray* currentOut = listOfOutTensors.at(i);
-      NDArray* currentGradOut = listOfGradOuts.at(classNum);
-      currentOut->assign(*currentGradOut / double(classCount[classNum]));
-    }
-
-    delete restDims;
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Mean), SD_NUMERIC_TYPES);
 }
 
 sd::Status unsortedSegmentSumFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                        sd::LongType numOfClasses, NDArray* output) {
-  // if input is a vector: (as if in doc sample)
-  sd::LongType idx = indices->e<sd::LongType>(0);
-  if (input->isVector() || input->isScalar()) {
-    for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-      sd::LongType classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum));
-    }
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      currentOut->assign(currentGradOut);
-    }
-
-    delete restDims;
-
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Sum), SD_NUMERIC_TYPES);
 }
 
 sd::Status unsortedSegmentProdFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                         sd::LongType numOfClasses, NDArray* output) {
-  auto tempRes = gradOut->dup();
-  unsortedSegmentProdFunctor(context, input, indices, numOfClasses, &tempRes);
-  if (input->isVector() || input->isScalar()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        auto classNum = indices->e<sd::LongType>(e);
-        output->p<double>(e, gradOut->e<double>(classNum) * tempRes.e<double>(classNum) / input->e<double>(e));
-      }
-    };
-
-    samediff::Threads::parallel_for(func, 0, indices->lengthOf());
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfBPTensors = tempRes.allTensorsAlongDimension(*restDims);
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-      auto currentFFOut = listOfBPTensors.at(classNum);
-
-      currentOut->assign((*currentFFOut) * (*currentGradOut) / (*current));
-    }
-
-  }
-
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::Prod), SD_NUMERIC_TYPES);
 }
 
-//    template <typename T>
 sd::Status unsortedSegmentSqrtNFunctorBP(sd::LaunchContext* context, NDArray* input, NDArray* indices, NDArray* gradOut,
                                          sd::LongType numOfClasses, NDArray* output) {
-  SD_MAP_IMPL<sd::LongType, sd::LongType> classCount;  //(numClasses);
-
-  for (sd::LongType count = 0; count < numOfClasses; ++count) {
-    classCount[count] = 0;
-  }
-
-  for (sd::LongType e = 0; e < indices->lengthOf(); ++e) {
-    classCount[indices->e<sd::LongType>(e)]++;
-  }
-
-  // if input is a vector: (as if in doc sample)
-  if (input->isVector() || input->isScalar()) {
-    // auto func = PRAGMA_THREADS_FOR {
-    for (sd::LongType e = 0; e < indices->lengthOf(); e++) {
-      auto classNum = indices->e<sd::LongType>(e);
-      output->p(e, gradOut->e<double>(classNum) / sd::math::sd_sqrt<double, double>(classCount[classNum]));
-    }
-
-  } else {
-    std::vector<sd::LongType> zeroVec = {0};
-    std::vector<sd::LongType> *restDims = ShapeUtils::evalDimsToExclude(input->rankOf(), 1,zeroVec.data());
-    ResultSet listOfGradOuts = gradOut->allTensorsAlongDimension(*restDims);
-    ResultSet listOfTensors = input->allTensorsAlongDimension(*restDims);
-    ResultSet listOfOutTensors = output->allTensorsAlongDimension(*restDims);
-    delete restDims;
-    for (sd::LongType i = 0; i < indices->lengthOf(); i++) {
-      auto classNum = indices->e<sd::LongType>(i);
-      auto current = listOfTensors.at(i);
-      auto currentOut = listOfOutTensors.at(i);
-      auto currentGradOut = listOfGradOuts.at(classNum);
-
-      for (int e = 0; e < current->lengthOf(); e++) {
-        currentOut->p<double>(e,
-                              currentGradOut->e<double>(e) / sd::math::sd_sqrt<double, double>(classCount[classNum]));
-      }
-    }
-
-  }
-  return sd::Status::OK;
+  BUILD_SINGLE_SELECTOR(output->dataType(), return segmentFunctorBP_,
+                        (input, indices, gradOut, output, SegmentReduction::SqrtN), SD_NUMERIC_TYPES);
 }
 
 }  // namespace helpers
 }  // namespace ops
 }  // namespace sd
-#endif
\ No newline at end of file
+#endif
@@ -30,6 +30,63 @@
 namespace sd {
 namespace ops {
 namespace helpers {
+
+// dot and axpy over embedding rows, everything in this file boils down to these two
+template <typename T>
+static SD_INLINE T w2vDot(const T *x, const T *y, const int length) {
+  T dot = static_cast<T>(0.f);
+  PRAGMA_OMP_SIMD_SUM(dot)
+  for (int e = 0; e < length; e++) dot += x[e] * y[e];
+
+  return dot;
+}
+
+// y += a * x
+template <typename T>
+static SD_INLINE void w2vAxpy(const T a, const T *x, T *y, const int length) {
+  PRAGMA_OMP_SIMD
+  for (int e = 0; e < length; e++) y[e] += a * x[e];
+}
+
+// next negative sample, the same LCG as original word2vec
+template <typename T, typename R>
+static SD_INLINE int w2vNegative(R &randomValue, const T *negTable, const int negLength, const int vocabSize) {
+  randomValue = randomValue * (unsigned long long)25214903917 + 11;
+  auto idx = sd::math::sd_abs<sd::LongType>((randomValue >> 16) % negLength);
+  int irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
+
+  if (irow < 0 || irow >= vocabSize) irow = randomValue % (vocabSize - 1) + 1;
+  return irow;
+}
+
+// typed, contiguous access to per-batch inputs, so per-target loops never go through NDArray::e<T>()
+template <typename X>
+class W2vView {
+ private:
+  NDArray _copy;
+  const X *_data = nullptr;
+  sd::LongType _width = 1;
+
+ public:
+  explicit W2vView(const NDArray &array) {
+    if (array.isEmpty()) return;
+
+    _width = array.rankOf() > 1 ? array.sizeAt(1) : 1;
+    if (array.dataType() == DataTypeUtils::fromT<X>() && array.ordering() == 'c' && array.ews() == 1) {
+      _data = array.bufferAsT<X>();
+    } else {
+      _copy = NDArray('c', array.getShapeAsVector(), DataTypeUtils::fromT<X>(), array.getContext());
+      _copy.assign(array);
+      _data = _copy.bufferAsT<X>();
+    }
+  }
+
+  bool isEmpty() const { return _data == nullptr; }
+
+  X operator[](const sd::LongType e) const { return _data[e]; }
+  X operator()(const sd::LongType row, const sd::LongType column) const { return _data[row * _width + column]; }
+};
+
 template <typename T>
 void hSoftmax_(T *vsyn0, T *vsyn1, T *vexpTable, T *vneu1e, const double alpha, const int vectorLength, const int code,
 
@@ -45,11 +102,7 @@ void hSoftmax_(T *vsyn0, T *vsyn1, T *vexpTable, T *vneu1e, const double alpha,
 
 
   // dot
-  PRAGMA_OMP_SIMD
-  for (int e = 0; e < vectorLength; e++) {
-    dot += syn0[e] * syn1[e];
-
-  }
+  dot = w2vDot<T>(syn0, syn1, vectorLength);
 
 
   // gradient
@@ -89,10 +142,7 @@ void nSampling_(void *vsyn0, void *vsyn1Neg, void *vexpTable, void *vneu1e, doub
   T dot = (T)0.0f;
   T g = (T)0.0f;
 
-  PRAGMA_OMP_SIMD
-  for (int e = 0; e < vectorLength; e++) {
-    dot += syn0[e] * syn1Neg[e];
-  }
+  dot = w2vDot<T>(syn0, syn1Neg, vectorLength);
 
   if (dot > HS_MAX_EXP)
     g = (code - 1) * alpha;
@@ -336,11 +386,19 @@ int binarySearch(const int *haystack, const int needle, const int totalElements)
 
 
 template <typename T>
-void doSkipGramLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, NDArray &vinfVector, const NDArray &targets,
-                     const NDArray &negStarters, const NDArray &indices, const NDArray &codes, const NDArray &lr,
-                     const NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength,
-                     const int expLength, const int negLength, T *const expTable, const T *negTable,
-                     const LongType hsRounds, int t);
+void doSkipGramLoop_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &targets, const W2vView<int> &negStarters,
+                     const W2vView<int> &indices, const W2vView<int> &codes, const W2vView<double> &lr,
+                     const W2vView<LongType> &nextRandom, const int nsRounds, const int vocabSize,
+                     const int vectorLength, const int expLength, const int negLength, T *const expTable,
+                     const T *negTable, const LongType hsRounds, const LongType t, T *neu1e);
+
+template <typename T>
+void doSkipGramWindow_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &targets, const W2vView<int> &negStarters,
+                       const W2vView<int> &indices, const W2vView<int> &codes, const W2vView<double> &lr,
+                       const W2vView<LongType> &nextRandom, const int nsRounds, const int vocabSize,
+                       const int vectorLength, const int expLength, const int negLength, T *const expTable,
+                       const T *negTable, const LongType hsRounds, const LongType first, const LongType last,
+                       std::vector<T> &neu1e, std::vector<T> &gradients, std::vector<int> &rows);
 
 template <typename T>
 void doSkipGramInferenceLoop_(NDArray &s1, NDArray &s1n, T *syn0row, const NDArray &targets,
@@ -433,39 +491,57 @@ template <typename T>
 void skipgramBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, NDArray &vexpTable,NDArray &vnegTable, NDArray &vinfVector,
                         NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr,
                         NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength,
-                        const int expLength, const int negLength, const bool preciseMode, const int numThreads,const int iterations,double minLearningRate) {
+                        const int expLength, const int negLength, const bool preciseMode, const int numThreads,const int iterations,double minLearningRate,
+                        const bool sharedNegatives) {
   const auto expTable = reinterpret_cast<T *>(vexpTable.buffer());
   const auto negTable = reinterpret_cast<T *>(vnegTable.buffer());
   const auto hsRounds = codes.isEmpty() ? 0 : codes.sizeAt(1);
   //training
   if(vinfVector.isEmpty()) {
-    const sd::LongType  targetsLen = targets.lengthOf();
-
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto t = start; t < stop; t+= increment) {
-        doSkipGramLoop_(s0, s1, s1n, vinfVector, targets, negStarters, indices, codes, lr, nextRandom, nsRounds,
-                        vocabSize, vectorLength, expLength, negLength, expTable, negTable, hsRounds, t);
-      }
-    };
-
-
-    int chunkSize = 1024;
-
-    if(targetsLen < chunkSize) {
-      samediff::Threads::parallel_tad(func,0,targetsLen,1);
+    const sd::LongType numTargets = targets.lengthOf();
+    if (lr.lengthOf() < numTargets || nextRandom.lengthOf() < numTargets)
+      THROW_EXCEPTION("SkipGram: learning rates and random values are required for every target");
+
+    if (nsRounds > 0 && negStarters.lengthOf() < numTargets)
+      THROW_EXCEPTION("SkipGram: negative sampling requires starter for every target");
+
+    const W2vView<int> bTargets(targets), bStarters(negStarters), bIndices(indices), bCodes(codes);
+    const W2vView<double> bLr(lr);
+    const W2vView<sd::LongType> bRandom(nextRandom);
+
+    auto syn0 = s0.bufferAsT<T>();
+    auto syn1 = s1.bufferAsT<T>();
+    auto syn1Neg = s1n.bufferAsT<T>();
+
+    // Hogwild: rows of shared tables are updated without any synchronization, collisions are rare and benign
+    if (sharedNegatives && nsRounds > 0) {
+      // consecutive pairs with the same positive word form a context window
+      std::vector<sd::LongType> windows(1, 0);
+      for (sd::LongType t = 1; t < numTargets; t++)
+        if (bStarters[t] != bStarters[t - 1]) windows.emplace_back(t);
+      windows.emplace_back(numTargets);
+
+      auto func = PRAGMA_THREADS_FOR {
+        std::vector<T> neu1e, gradients;
+        std::vector<int> rows;
+        for (auto w = start; w < stop; w++)
+          doSkipGramWindow_<T>(syn0, syn1, syn1Neg, bTargets, bStarters, bIndices, bCodes, bLr, bRandom, nsRounds,
+                               vocabSize, vectorLength, expLength, negLength, expTable, negTable, hsRounds, windows[w],
+                               windows[w + 1], neu1e, gradients, rows);
+      };
+
+      samediff::Threads::parallel_dynamic(func, 0, windows.size() - 1, 1);
     } else {
-      int chunks = targetsLen / chunkSize;
-      for(int i = 0; i < chunks; i++) {
-        int start = i * chunkSize;
-        int potentialEnd = start + chunkSize;
-        int end = sd::math::sd_min<int>(targetsLen,potentialEnd);
-        samediff::Threads::parallel_tad(func,start,end,1);
-      }
-
+      auto func = PRAGMA_THREADS_FOR {
+        std::vector<T> neu1e(vectorLength);
+        for (auto t = start; t < stop; t++)
+          doSkipGramLoop_<T>(syn0, syn1, syn1Neg, bTargets, bStarters, bIndices, bCodes, bLr, bRandom, nsRounds,
+                             vocabSize, vectorLength, expLength, negLength, expTable, negTable, hsRounds, t,
+                             neu1e.data());
+      };
+
+      samediff::Threads::parallel_for(func, 0, numTargets, 1);
     }
-
-
-
   } else { //inference
     auto numTargets = targets.lengthOf();
     auto vec = reinterpret_cast<T *>(vinfVector.buffer());
@@ -621,96 +697,145 @@ void doSkipGramInferenceLoop_(NDArray &s1, NDArray &s1n, T *syn0row, const NDArr
 
 
 template <typename T>
-void doSkipGramLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, NDArray &vinfVector, const NDArray &targets,
-                     const NDArray &negStarters, const NDArray &indices, const NDArray &codes, const NDArray &lr,
-                     const NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength,
-                     const int expLength, const int negLength, T *const expTable, const T *negTable,
-                     const LongType hsRounds, int t) {
+void doSkipGramLoop_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &targets, const W2vView<int> &negStarters,
+                     const W2vView<int> &indices, const W2vView<int> &codes, const W2vView<double> &lr,
+                     const W2vView<LongType> &nextRandom, const int nsRounds, const int vocabSize,
+                     const int vectorLength, const int expLength, const int negLength, T *const expTable,
+                     const T *negTable, const LongType hsRounds, const LongType t, T *neu1e) {
+  memset(neu1e, 0, vectorLength * sizeof(T));
 
-  if(t >= lr.lengthOf()) {
-    std::string errorMessage;
-    errorMessage += "Target index is greater than number of learning rates ";
-    errorMessage += std::to_string(t);
-    errorMessage += " >= ";
-    errorMessage += std::to_string(lr.lengthOf());
-    THROW_EXCEPTION(errorMessage.c_str());
+  const auto alpha = lr[t];
+  auto randomValue = nextRandom[t];
+  auto syn0row = syn0 + targets[t] * vectorLength;
 
+  for (LongType e = 0; e < hsRounds; e++) {
+    const int code = codes(t, e);
+    //codes are only 0 and 1, -1 are placeholders for invalid codes
+    //the codes matrix is padded with extra values at time of allocation
+    //this is due to the code rows effectively being a ragged matrix (rows have different shapes)
+    if (code < 0) continue;
+
+    hSoftmax_<T>(syn0row, syn1 + indices(t, e) * vectorLength, expTable, neu1e, alpha, vectorLength, code, expLength,
+                 false);
   }
 
-  if(t >= targets.lengthOf()) {
-    std::string errorMessage;
-    errorMessage += "Target index is greater than number of targets ";
-    errorMessage += std::to_string(t);
-    errorMessage += " >= ";
-    errorMessage += std::to_string(targets.lengthOf());
-    THROW_EXCEPTION(errorMessage.c_str())
+  if (nsRounds > 0) {
+    const int nsStarter = negStarters[t];
+    for (int r = 0; r < nsRounds + 1; r++) {
+      // target is known in advance
+      int irow = nsStarter;
+      if (r != 0) {
+        irow = w2vNegative(randomValue, negTable, negLength, vocabSize);
+        if (irow == nsStarter) continue;
+      }
+
+      nSampling_<T>(syn0row, syn1Neg + irow * vectorLength, expTable, neu1e, alpha, vectorLength, r == 0 ? 1 : 0,
+                    expLength, false);
+    }
   }
-  T *neu1e = new T[vectorLength];
-  memset(neu1e, 0, vectorLength * sizeof(T));
 
-  auto alpha = lr.e<double>(t);
+  w2vAxpy<T>(static_cast<T>(1.f), neu1e, syn0row, vectorLength);
+}
 
-  LongType randomValue = nextRandom.e<LongType>(t);
-  auto target = targets.e<int>(t);
-  auto syn0row = vinfVector.isEmpty() ?  reinterpret_cast<T *>(s0.bufferWithOffset(target * vectorLength)) : reinterpret_cast<T *>(vinfVector.buffer());
-  if(hsRounds > 0) {
+// All pairs of a context window are trained against a single set of negative samples, so per-pair dot/axpy chains
+// turn into small dense products with every syn1Neg row loaded once per window:
+// scores = X * Y^T, neu1e = G * Y, Y += G^T * X, where X holds syn0 rows of the window and Y the sampled rows.
+template <typename T>
+void doSkipGramWindow_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &targets, const W2vView<int> &negStarters,
+                       const W2vView<int> &indices, const W2vView<int> &codes, const W2vView<double> &lr,
+                       const W2vView<LongType> &nextRandom, const int nsRounds, const int vocabSize,
+                       const int vectorLength, const int expLength, const int negLength, T *const expTable,
+                       const T *negTable, const LongType hsRounds, const LongType first, const LongType last,
+                       std::vector<T> &neu1e, std::vector<T> &gradients, std::vector<int> &rows) {
+  const auto numPairs = last - first;
+  neu1e.assign(numPairs * vectorLength, static_cast<T>(0.f));
+
+  // hierarchic softmax stays per pair
+  for (LongType i = 0; i < numPairs; i++) {
+    const auto t = first + i;
     for (LongType e = 0; e < hsRounds; e++) {
-      int currRow = indices.e<int>(t,e);
-      int code = codes.e<int>(t,e);
-      //codes are only 0 and 1, -1 are placeholders for invalid codes
-      //the codes matrix is padded with extra values at time of allocation
-      //this is due to the code rows effectively being a ragged matrix (rows have different shapes)
-      if(code < 0)  {
-        continue;
-      }
-
-      T *syn1row = (T *) s1.bufferWithOffset(currRow * vectorLength);
-      hSoftmax_<T>(syn0row,syn1row,expTable,neu1e,lr.e<double>(t),vectorLength,code,expLength,!vinfVector.isEmpty());
+      const int code = codes(t, e);
+      if (code < 0) continue;
 
+      hSoftmax_<T>(syn0 + targets[t] * vectorLength, syn1 + indices(t, e) * vectorLength, expTable,
+                   neu1e.data() + i * vectorLength, lr[t], vectorLength, code, expLength, false);
     }
   }
 
-  if(nsRounds > 0) {
-    int irow = negStarters.e<int>(t);
-    int nsStarter = irow;
-    for (int r = 0; r < nsRounds + 1; r++) {
-      if (r == 0) {
-        // target is known in advance
-      } else {
-        randomValue = randomValue * (unsigned long long)25214903917 + 11;
-        auto idx = math::sd_abs<LongType>((randomValue >> 16) % negLength);
-        irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
+  // positive word goes first, negatives are drawn once for the whole window
+  const int positive = negStarters[first];
+  auto randomValue = nextRandom[first];
+  rows.assign(1, positive);
+  for (int r = 1; r < nsRounds + 1; r++) {
+    const int irow = w2vNegative(randomValue, negTable, negLength, vocabSize);
+    if (irow != positive) rows.emplace_back(irow);
+  }
 
-        if (irow < 0 || irow >= vocabSize) irow = randomValue % (vocabSize - 1) + 1;
+  const auto numRows = static_cast<LongType>(rows.size());
+  gradients.resize(numPairs * numRows);
 
-        if (irow == nsStarter) continue;
+  const double scale = (double)expLength / HS_MAX_EXP / 2.0;
+  for (LongType j = 0; j < numRows; j++) {
+    const T *y = syn1Neg + rows[j] * vectorLength;
+    const T label = j == 0 ? static_cast<T>(1.f) : static_cast<T>(0.f);
+
+    for (LongType i = 0; i < numPairs; i++) {
+      const T alpha = static_cast<T>(lr[first + i]);
+      const T dot = w2vDot<T>(syn0 + targets[first + i] * vectorLength, y, vectorLength);
+
+      T g = static_cast<T>(0.f);
+      if (dot > HS_MAX_EXP) {
+        g = (label - static_cast<T>(1.f)) * alpha;
+      } else if (dot < (T)-HS_MAX_EXP) {
+        g = label * alpha;
+      } else {
+        const int idx = static_cast<int>((dot + (T)HS_MAX_EXP) * scale);
+        if (idx >= 0 && idx < expLength) g = (label - expTable[idx]) * alpha;
       }
 
-      nSampling_<T>(syn0row, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e, alpha, vectorLength,
-                    r == 0 ? 1 : 0, expLength, !vinfVector.isEmpty());
+      gradients[i * numRows + j] = g;
     }
   }
-      PRAGMA_OMP_SIMD
-  for (int e = 0; e < vectorLength; e++) {
-    syn0row[e] += neu1e[e];
+
+  // neu1e += G * Y, using rows before they get updated
+  for (LongType j = 0; j < numRows; j++) {
+    const T *y = syn1Neg + rows[j] * vectorLength;
+    for (LongType i = 0; i < numPairs; i++) {
+      const auto g = gradients[i * numRows + j];
+      if (g != static_cast<T>(0.f)) w2vAxpy<T>(g, y, neu1e.data() + i * vectorLength, vectorLength);
+    }
   }
-  delete[] neu1e;
+
+  // Y += G^T * X
+  for (LongType j = 0; j < numRows; j++) {
+    T *y = syn1Neg + rows[j] * vectorLength;
+    for (LongType i = 0; i < numPairs; i++) {
+      const auto g = gradients[i * numRows + j];
+      if (g != static_cast<T>(0.f)) w2vAxpy<T>(g, syn0 + targets[first + i] * vectorLength, y, vectorLength);
+    }
+  }
+
+  // X += neu1e
+  for (LongType i = 0; i < numPairs; i++)
+    w2vAxpy<T>(static_cast<T>(1.f), neu1e.data() + i * vectorLength, syn0 + targets[first + i] * vectorLength,
+               vectorLength);
 }
 
 BUILD_SINGLE_TEMPLATE(template void skipgramBatchExec_,
                       (NDArray & s0, NDArray &s1, NDArray &s1n, NDArray &vexpTable, NDArray &vnegTable, NDArray &vinfVector,
                           NDArray &targets, NDArray &negStarters, NDArray &indices, NDArray &codes, NDArray &lr,
                           NDArray &nextRandom, const int nsRounds, const int vocabSize, const int vectorLength,
-                          const int expLength, const int negLength, const bool preciseMode, const int numThreads,const int iterations,double minLearningRate),
+                          const int expLength, const int negLength, const bool preciseMode, const int numThreads,const int iterations,double minLearningRate,
+                          const bool sharedNegatives),
                       SD_NATIVE_FLOAT_TYPES);
 
 template <typename T>
-void doCbowLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, const NDArray &negStarters, const NDArray &indices,
-                 const NDArray &codes, const NDArray &lr, const NDArray &nextRandom, const NDArray &nLabels,
-                 const int nsRounds, const int vocabSize, const int vectorLength, const int expLength,
-                 const int negLength, const bool trainWords, T *const expTable, const T *negTable, const T *infVector,
-                 const int contextWidth, const int *bContext, const int *bLocker, const int *bStarters,
-                 const LongType numIndices, int t);
+void doCbowLoop_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &negStarters, const W2vView<int> &indices,
+                 const W2vView<int> &codes, const W2vView<double> &lr, const W2vView<LongType> &nextRandom,
+                 const W2vView<int> &nLabels, const int nsRounds, const int vocabSize, const int vectorLength,
+                 const int expLength, const int negLength, const bool trainWords, T *const expTable, const T *negTable,
+                 const T *infVector, const int contextWidth, const int *bContext, const int *bLocker,
+                 const LongType numIndices, const LongType t, T *neu1, T *neu1e);
 template <typename T>
 void cbowBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, NDArray &vexpTable, NDArray &vnegTable, NDArray &vinfVector,
                     NDArray &context, NDArray &lockedWords, NDArray &targets, NDArray &negStarters, NDArray &indices,
@@ -731,67 +856,52 @@ void cbowBatchExec_(NDArray &s0, NDArray &s1, NDArray &s1n, NDArray &vexpTable,
 
   const auto bContext = context.bufferAsT<int>();
   const auto bLocker = lockedWords.bufferAsT<int>();
-  const auto bStarters = negStarters.bufferAsT<int>();
   const auto numIndices = indices.isEmpty() ? 0 : indices.sizeAt(1);
-  if(vinfVector.isEmpty()) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto t = start; t < stop; t+= increment) {
-        doCbowLoop_(s0, s1, s1n, negStarters, indices, codes, lr, nextRandom, nLabels, nsRounds, vocabSize,
-                    vectorLength, expLength, negLength, trainWords, expTable, negTable, infVector, contextWidth,
-                    bContext, bLocker, bStarters, numIndices, t);
-
-      }
-    };
-
-
-    int targetsLen = targets.lengthOf();
-    int chunkSize = 1024;
-    if(targetsLen < chunkSize) {
-      samediff::Threads::parallel_tad(func,0,targetsLen,1);
-    } else {
-      int chunks = targetsLen / chunkSize;
-      for(int i = 0; i < chunks; i++) {
-        int start = i * chunkSize;
-        int potentialEnd = start + chunkSize;
-        int end = sd::math::sd_min<int>(targetsLen,potentialEnd);
-        samediff::Threads::parallel_tad(func,start,end,1);
-      }
-    }
 
+  const W2vView<int> bStarters(negStarters), bIndices(indices), bCodes(codes), bLabels(nLabels);
+  const W2vView<double> bLr(lr);
+  const W2vView<sd::LongType> bRandom(nextRandom);
 
+  auto syn0 = s0.bufferAsT<T>();
+  auto syn1 = s1.bufferAsT<T>();
 
+  if(vinfVector.isEmpty()) {
+    // Hogwild: rows of shared tables are updated without any synchronization, collisions are rare and benign
+    auto func = PRAGMA_THREADS_FOR {
+      std::vector<T> neu1(vectorLength), neu1e(vectorLength);
+      for (auto t = start; t < stop; t++)
+        doCbowLoop_<T>(syn0, syn1, syn1Neg, bStarters, bIndices, bCodes, bLr, bRandom, bLabels, nsRounds, vocabSize,
+                       vectorLength, expLength, negLength, trainWords, expTable, negTable, infVector, contextWidth,
+                       bContext, bLocker, numIndices, t, neu1.data(), neu1e.data());
+    };
 
+    samediff::Threads::parallel_for(func, 0, targets.lengthOf(), 1);
   } else {
     // regular mode provides 0 guarantees for reproducibility
     auto numTargets = targets.lengthOf();
+    std::vector<T> neu1(vectorLength), neu1e(vectorLength);
     for(int iteration = 0; iteration < iterations; iteration++) {
       for (auto t = 0; t < numTargets; t++) {
-        doCbowLoop_(s0, s1, s1n, negStarters, indices, codes, lr, nextRandom, nLabels, nsRounds, vocabSize,
-                    vectorLength, expLength, negLength, trainWords, expTable, negTable, infVector, contextWidth,
-                    bContext, bLocker, bStarters, numIndices, t);
+        doCbowLoop_<T>(syn0, syn1, syn1Neg, bStarters, bIndices, bCodes, bLr, bRandom, bLabels, nsRounds, vocabSize,
+                       vectorLength, expLength, negLength, trainWords, expTable, negTable, infVector, contextWidth,
+                       bContext, bLocker, numIndices, t, neu1.data(), neu1e.data());
       }
     }
   }
-
-
 }
+
 template <typename T>
-void doCbowLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, const NDArray &negStarters, const NDArray &indices,
-                 const NDArray &codes, const NDArray &lr, const NDArray &nextRandom, const NDArray &nLabels,
-                 const int nsRounds, const int vocabSize, const int vectorLength, const int expLength,
-                 const int negLength, const bool trainWords, T *const expTable, const T *negTable, const T *infVector,
-                 const int contextWidth, const int *bContext, const int *bLocker, const int *bStarters,
-                 const LongType numIndices, int t) {
-  T *neu1 =  new T[vectorLength];
-  T *neu1e =  new T[vectorLength];
-
-  // optionally we nullify temp arrays after successful (and on first) cycle
+void doCbowLoop_(T *syn0, T *syn1, T *syn1Neg, const W2vView<int> &negStarters, const W2vView<int> &indices,
+                 const W2vView<int> &codes, const W2vView<double> &lr, const W2vView<LongType> &nextRandom,
+                 const W2vView<int> &nLabels, const int nsRounds, const int vocabSize, const int vectorLength,
+                 const int expLength, const int negLength, const bool trainWords, T *const expTable, const T *negTable,
+                 const T *infVector, const int contextWidth, const int *bContext, const int *bLocker,
+                 const LongType numIndices, const LongType t, T *neu1, T *neu1e) {
   memset(neu1, 0, sizeof(T) * vectorLength);
   memset(neu1e, 0, sizeof(T) * vectorLength);
 
-  auto alpha = lr.e<double>(t);
-
-  auto numLabels = nLabels.isEmpty() ? 0 : nLabels.e<int>(t);
+  const auto alpha = lr[t];
+  const auto numLabels = nLabels.isEmpty() ? 0 : nLabels[t];
 
   int actualContext = 0;
 
@@ -805,9 +915,7 @@ void doCbowLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, const NDArray &negStart
 
     if (cContext >= vocabSize) THROW_EXCEPTION("ContextID can't be >= vocab size");
 
-    T *syn0word = (T *) s0.bufferWithOffset(cContext * vectorLength);
-
-    for (int i = 0; i < vectorLength; i++) neu1[i] += syn0word[i];
+    w2vAxpy<T>(static_cast<T>(1.f), syn0 + cContext * vectorLength, neu1, vectorLength);
 
     actualContext++;
   }
@@ -821,42 +929,33 @@ void doCbowLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, const NDArray &negStart
   // hierarchic softmax step
   if (!indices.isEmpty()) {
     for (LongType i = 0; i < numIndices; i++) {
-      const int cIndex = indices.e<int>(t,i);
-      const int cCode = codes.e<int>(t,i);
+      const int cIndex = indices(t, i);
+      const int cCode = codes(t, i);
 
       // we're skipping padded values
       if (cIndex < 0) continue;
 
       if (cIndex >= vocabSize) THROW_EXCEPTION("Index can't be > vocab size");
 
-      hSoftmax_<T>(neu1, s1.bufferasTWithOffset<T>(cIndex * vectorLength), expTable, neu1e, alpha, vectorLength, cCode, expLength,
-                   false);
+      hSoftmax_<T>(neu1, syn1 + cIndex * vectorLength, expTable, neu1e, alpha, vectorLength, cCode, expLength, false);
     }
   }
 
   // negative sampling step
   if (!negStarters.isEmpty() && nsRounds > 0) {
-    int irow = bStarters[t];
-    const int nsStarter = irow;
-    unsigned long long randomValue = nextRandom.e<LongType>(t);
+    const int nsStarter = negStarters[t];
+    unsigned long long randomValue = nextRandom[t];
 
     for (int r = 0; r < nsRounds + 1; r++) {
       // we're skipping rng on 0 step
+      int irow = nsStarter;
       if (r != 0) {
-        randomValue = randomValue * (unsigned long long)25214903917 + 11;
-        auto idx = math::sd_abs<LongType>((randomValue >> 16) % negLength);
-        irow = idx >= negLength ? -1 : static_cast<int>(negTable[idx]);
-
-        if (irow < 0 || irow >= vocabSize) irow = randomValue % (vocabSize - 1) + 1;
+        irow = w2vNegative(randomValue, negTable, negLength, vocabSize);
         if (irow == nsStarter) continue;
-
-        nSampling_<T>(neu1, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e, alpha, vectorLength,
-                      r == 0 ? 1 : 0, expLength, infVector != nullptr);
-      } else {
-        nSampling_<T>(neu1, s1n.bufferWithOffset(irow * vectorLength), expTable, neu1e, alpha, vectorLength,
-                      r == 0 ? 1 : 0, expLength, infVector != nullptr);
       }
 
+      nSampling_<T>(neu1, syn1Neg + irow * vectorLength, expTable, neu1e, alpha, vectorLength, r == 0 ? 1 : 0,
+                    expLength, infVector != nullptr);
     }
   }
 
@@ -875,15 +974,7 @@ void doCbowLoop_(NDArray &s0, NDArray &s1, NDArray &s1n, const NDArray &negStart
     if (cContext >= vocabSize) THROW_EXCEPTION("ContextID can't be > vocab size");
 
     // one word from context
-    T *syn0word = (T *) s0.bufferWithOffset(cContext * vectorLength);
-    PRAGMA_OMP_SIMD
-    for (int i = 0; i < vectorLength; i++) syn0word[i] += neu1e[i];
-  }
-
-  // optionally release temp arrays
-  if (vectorLength > 600) {
-    delete[] neu1;
-    delete[] neu1e;
+    w2vAxpy<T>(static_cast<T>(1.f), neu1e, syn0 + cContext * vectorLength, vectorLength);
   }
 }
 BUILD_SINGLE_TEMPLATE(template void cbowBatchExec_,
@@ -932,7 +1023,8 @@ void cbowInference(NDArray &syn0, NDArray &syn1, NDArray &syn1Neg, NDArray &expT
 
 void skipgram(NDArray &syn0, NDArray &syn1, NDArray &syn1Neg, NDArray &expTable, NDArray &negTable, NDArray &target,
               NDArray &ngStarter, int nsRounds, NDArray &indices, NDArray &codes, NDArray &alpha, NDArray &randomValue,
-              NDArray &inferenceVector, const bool preciseMode, const int numWorkers,const int iterations,double minLearningRate) {
+              NDArray &inferenceVector, const bool preciseMode, const int numWorkers,const int iterations,double minLearningRate,
+              const bool sharedNegatives) {
   auto xType = syn0.dataType();
 
   // single round case
@@ -952,7 +1044,8 @@ void skipgram(NDArray &syn0, NDArray &syn1, NDArray &syn1Neg, NDArray &expTable,
     BUILD_SINGLE_SELECTOR(xType, skipgramBatchExec_,
                           (syn0, syn1, syn1Neg, expTable, negTable, inferenceVector, target, ngStarter,
                               indices, codes, alpha, randomValue, nsRounds, syn0.sizeAt(0), syn0.sizeAt(1),
-                              expTable.lengthOf(), negTable.lengthOf(), preciseMode, numWorkers,iterations,minLearningRate),
+                              expTable.lengthOf(), negTable.lengthOf(), preciseMode, numWorkers,iterations,minLearningRate,
+                              sharedNegatives),
                           SD_NATIVE_FLOAT_TYPES);
   } else
     THROW_EXCEPTION("SkipGram: target must have rank 0 or 1");
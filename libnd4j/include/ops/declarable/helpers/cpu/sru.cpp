@@ -74,6 +74,73 @@ void sruCell(sd::LaunchContext* context, const NDArray* x, const NDArray* c0, co
   // *h = r * (activation<T>(c) - *x) + *x;
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+static void sruTimeLoop_(const NDArray* x, const NDArray* c0, const NDArray* w, const NDArray* b, NDArray* h,
+                         NDArray* c) {
+  // x   input [bS x inSize x time]
+  // c0  initial cell state  (at time step = 0) [bS x inSize],
+  // w   weights, [3*inSize x inSize]
+  // b   biases,  [2*inSize]
+
+  // h   cell outputs [bS x inSize x time]
+  // c   cell states  [bS x inSize x time]
+
+  const sd::LongType bS = x->sizeAt(0);
+  const sd::LongType K = x->sizeAt(1);
+  const sd::LongType time = x->sizeAt(2);
+
+  // there is no recurrent matrix product in sru, so x × wT is done for all time steps at once
+  NDArray xRows = x->permute({0, 2, 1}).reshape('c', {bS * time, K});  // [bS*time x inSize]
+  NDArray wT = w->transpose();                                          // [inSize x 3*inSize]
+  NDArray z('c', {bS * time, 3 * K}, x->dataType(), x->getContext());
+  MmulHelper::mmul(&xRows, &wT, &z, 1.0, 0.0, 'c');  // [bS*time x 3*inSize]
+
+  NDArray bias = b->dup('c');
+
+  const T* zBuff = z.bufferAsT<T>();
+  const T* bBuff = bias.bufferAsT<T>();
+  const T* xBuff = x->bufferAsT<T>();
+  const T* c0Buff = c0->bufferAsT<T>();
+  T* hBuff = h->bufferAsT<T>();
+  T* cBuff = c->bufferAsT<T>();
+
+  const sd::LongType xS0 = x->strideAt(0), xS1 = x->strideAt(1), xS2 = x->strideAt(2);
+  const sd::LongType hS0 = h->strideAt(0), hS1 = h->strideAt(1), hS2 = h->strideAt(2);
+  const sd::LongType cS0 = c->strideAt(0), cS1 = c->strideAt(1), cS2 = c->strideAt(2);
+  const sd::LongType c0S0 = c0->strideAt(0), c0S1 = c0->strideAt(1);
+
+  // every (batch, feature) column runs through all time steps independently
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto col = start; col < stop; ++col) {
+      const sd::LongType e = col / K;
+      const sd::LongType j = col % K;
+
+      const T bF = bBuff[j];
+      const T bR = bBuff[K + j];
+      const T* xCol = xBuff + e * xS0 + j * xS1;
+      T* hCol = hBuff + e * hS0 + j * hS1;
+      T* cCol = cBuff + e * cS0 + j * cS1;
+
+      T cPrev = c0Buff[e * c0S0 + j * c0S1];
+
+      for (sd::LongType t = 0; t < time; ++t) {
+        const T* zRow = zBuff + (e * time + t) * 3 * K;
+        const T xt = xCol[t * xS2];
+
+        const T f = sd::math::sd_sigmoid<T, T>(zRow[K + j] + bF);
+        const T r = sd::math::sd_sigmoid<T, T>(zRow[2 * K + j] + bR);
+
+        cPrev = f * cPrev + (static_cast<T>(1.f) - f) * zRow[j];
+        cCol[t * cS2] = cPrev;
+        hCol[t * hS2] = r * sd::math::sd_tanh<T, T>(cPrev) + (static_cast<T>(1.f) - r) * xt;
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, bS * K);
+}
+
 //////////////////////////////////////////////////////////////////////////
 void sruTimeLoop(sd::LaunchContext* context, const NDArray* x, const NDArray* c0, const NDArray* w, const NDArray* b,
                  NDArray* h, NDArray* c) {
@@ -85,6 +152,13 @@ void sruTimeLoop(sd::LaunchContext* context, const NDArray* x, const NDArray* c0
   // h   cell outputs [bS x inSize x time]
   // c   cell states  [bS x inSize x time]
 
+  const auto type = x->dataType();
+  if (DataTypeUtils::isR(type) && c0->dataType() == type && w->dataType() == type && b->dataType() == type &&
+      h->dataType() == type && c->dataType() == type && c0->rankOf() == 2 && b->rankOf() == 1) {
+    BUILD_SINGLE_SELECTOR(type, sruTimeLoop_, (x, c0, w, b, h, c), SD_FLOAT_TYPES);
+    return;
+  }
+
   auto wT = w->transpose();  // [3*inSize x inSize] -> [inSize x 3*inSize]
 
   const int time = x->sizeAt(2);
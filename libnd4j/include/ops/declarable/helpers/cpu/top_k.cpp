@@ -21,6 +21,7 @@
 //
 #include <array/NDArrayFactory.h>
 #include <execution/Threads.h>
+#include <helpers/ConstantTadHelper.h>
 #include <ops/declarable/headers/parity_ops.h>
 #include <ops/declarable/helpers/top_k.h>
 #if NOT_EXCLUDED(OP_top_k)
@@ -28,90 +29,150 @@ namespace sd {
 namespace ops {
 namespace helpers {
 
+// rows this wide are split between threads when there are fewer rows than threads
+static constexpr sd::LongType TOPK_SPLIT_WIDTH = 65536;
+
+// candidates are ordered by value, ties are resolved in favor of lower index
+template <typename T>
+struct TopKEntry {
+  T value;
+  sd::LongType index;
+};
+
 template <typename T>
+static SD_INLINE bool topKBetter(const TopKEntry<T>& a, const TopKEntry<T>& b) {
+  return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+// best k entries of contiguous row[begin, end), appended to selected in no particular order
+template <typename T>
+static void topKSelect(const T* row, const sd::LongType begin, const sd::LongType end, const sd::LongType k,
+                       std::vector<TopKEntry<T>>& selected) {
+  const sd::LongType n = end - begin;
+  const auto first = selected.size();
+
+  if (n <= k) {
+    for (sd::LongType i = begin; i < end; i++) selected.push_back({row[i], i});
+    return;
+  }
+
+  if (k * 16 <= n) {
+    // heap of k best so far, front() is the worst of them. Every index seen later is greater than the kept ones,
+    // so a newcomer gets in only if its value is strictly greater than the worst kept value
+    for (sd::LongType i = begin; i < begin + k; i++) selected.push_back({row[i], i});
+    auto heapBegin = selected.begin() + first;
+    std::make_heap(heapBegin, selected.end(), topKBetter<T>);
+
+    for (sd::LongType i = begin + k; i < end; i++) {
+      const T value = row[i];
+      if (value > heapBegin->value) {
+        std::pop_heap(heapBegin, selected.end(), topKBetter<T>);
+        selected.back() = {value, i};
+        std::push_heap(heapBegin, selected.end(), topKBetter<T>);
+      }
+    }
+  } else {
+    for (sd::LongType i = begin; i < end; i++) selected.push_back({row[i], i});
+    std::nth_element(selected.begin() + first, selected.begin() + first + k - 1, selected.end(), topKBetter<T>);
+    selected.resize(first + k);
+  }
+}
+
+// keeps the best k of candidates and stores them into one row of values/indices
+template <typename T, typename I>
+static void topKStore(std::vector<TopKEntry<T>>& candidates, const sd::LongType k, const bool needSort, T* values,
+                      const sd::LongType vStride, I* indices, const sd::LongType iStride) {
+  if (static_cast<sd::LongType>(candidates.size()) > k) {
+    std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), topKBetter<T>);
+    candidates.resize(k);
+  }
+
+  if (needSort)
+    std::sort(candidates.begin(), candidates.end(), topKBetter<T>);
+  else
+    std::sort(candidates.begin(), candidates.end(),
+              [](const TopKEntry<T>& a, const TopKEntry<T>& b) { return a.index < b.index; });
+
+  for (sd::LongType j = 0; j < k; j++) {
+    if (values != nullptr) values[j * vStride] = candidates[j].value;
+    if (indices != nullptr) indices[j * iStride] = static_cast<I>(candidates[j].index);
+  }
+}
+
+template <typename T, typename I>
 static sd::Status topKFunctor_(const NDArray* input, NDArray* values, NDArray* indices, const sd::LongType k,
                                bool needSort) {
-  sd::LongType width = input->sizeAt(-1);
-  sd::LongType lastDim = input->rankOf() - 1;
-  std::vector<sd::LongType> dimsToExclude(input->rankOf() - 1);
-  for (size_t d = 0; d < dimsToExclude.size(); ++d) dimsToExclude[d] = d;
-
-  const sd::LongType numOfSubArrs = ShapeUtils::getNumOfSubArrs(input->shapeInfo(), dimsToExclude);
-
-  if (k == 1) {
-    for (sd::LongType e = 0; e < numOfSubArrs; ++e) {
-      auto trial = (*input)(e, dimsToExclude);
-      sd::LongType maxPos = 0;
-      T maxVal = trial.e<T>(0);
-      for (sd::LongType pos = 1; pos < trial.lengthOf(); pos++)
-        if (maxVal < trial.e<T>(pos)) {
-          maxPos = pos;
-          maxVal = trial.e<T>(pos);
+  const sd::LongType width = input->sizeAt(-1);
+  const int lastDim = input->rankOf() - 1;
+
+  auto inPack = ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), lastDim);
+  auto vPack = values ? ConstantTadHelper::getInstance().tadForDimensions(values->shapeInfo(), lastDim) : nullptr;
+  auto iPack = indices ? ConstantTadHelper::getInstance().tadForDimensions(indices->shapeInfo(), lastDim) : nullptr;
+
+  const sd::LongType numOfSubArrs = inPack->numberOfTads();
+  const sd::LongType inStride = input->strideAt(-1);
+  const sd::LongType vStride = values ? values->strideAt(-1) : 0;
+  const sd::LongType iStride = indices ? indices->strideAt(-1) : 0;
+
+  const T* x = input->bufferAsT<T>();
+  T* v = values ? values->bufferAsT<T>() : nullptr;
+  I* ind = indices ? indices->bufferAsT<I>() : nullptr;
+
+  // strided rows are gathered first, so selection always runs over contiguous memory
+  auto rowOf = [&](const sd::LongType r, std::vector<T>& copy) -> const T* {
+    const T* row = x + inPack->primaryOffsets()[r];
+    if (inStride == 1) return row;
+    copy.resize(width);
+    for (sd::LongType i = 0; i < width; i++) copy[i] = row[i * inStride];
+    return copy.data();
+  };
+
+  auto store = [&](const sd::LongType r, std::vector<TopKEntry<T>>& candidates) {
+    topKStore<T, I>(candidates, k, needSort, v ? v + vPack->primaryOffsets()[r] : nullptr, vStride,
+                    ind ? ind + iPack->primaryOffsets()[r] : nullptr, iStride);
+  };
+
+  const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+
+  if (numOfSubArrs < numThreads && width >= TOPK_SPLIT_WIDTH) {
+    // few wide rows: every thread selects best k of its span, the union of those holds best k of the row
+    const sd::LongType numChunks = sd::math::sd_min<sd::LongType>(numThreads, width / (16 * k) + 1);
+    const sd::LongType chunk = (width + numChunks - 1) / numChunks;
+    std::vector<std::vector<TopKEntry<T>>> selected(numChunks);
+    std::vector<T> copy;
+    std::vector<TopKEntry<T>> candidates;
+
+    for (sd::LongType r = 0; r < numOfSubArrs; r++) {
+      const T* row = rowOf(r, copy);
+
+      auto func = PRAGMA_THREADS_FOR {
+        for (auto c = start; c < stop; c++) {
+          selected[c].clear();
+          topKSelect<T>(row, c * chunk, sd::math::sd_min<sd::LongType>(width, (c + 1) * chunk), k, selected[c]);
         }
-      if (indices) indices->p(e, maxPos);  // topIndex;
-      if (values) values->p(e, maxVal);
+      };
+      samediff::Threads::parallel_tad(func, 0, numChunks, 1, numChunks);
+
+      candidates.clear();
+      for (const auto& s : selected) candidates.insert(candidates.end(), s.begin(), s.end());
+      store(r, candidates);
     }
   } else {
-    int nextPos = 0;
-
-    for (sd::LongType e = 0; e < numOfSubArrs; ++e) {
-      auto trial = (*input)(e, dimsToExclude);
-
-      // fill up the first k elements
-      NDArray topValues = NDArrayFactory::create<T>('c', {k}, input->getContext());
-      NDArray sortedVals = NDArrayFactory::create<T>('c', {k}, input->getContext());
-      NDArray topIndices = NDArrayFactory::create<sd::LongType>('c', {k}, input->getContext());
-      for (sd::LongType pos = 0; pos < k; ++pos) {
-        topIndices.r<sd::LongType>(pos) = pos;
-        topValues.r<T>(pos) = trial.t<T>(pos);
-      }
-      // std::vector<T> sortedVals(topValues);
-      sortedVals.assign(topValues);  // = NDArrayFactory::create<T>('c', {k});
-      // std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-      SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-      for (sd::LongType i = static_cast<sd::LongType>(k); i < width; ++i) {
-        T val = trial.e<T>(i);
-        T minTopVal = sortedVals.t<T>(0);
-        if (minTopVal < val) {  // value should be inserted to top k
-          // only if it is not contained in
-          T* begin = reinterpret_cast<T*>(sortedVals.buffer());
-          T* end = begin + k;
-          bool exists = std::binary_search(begin, end, val);
-          if (!exists) {
-            // exchangePos - a distance between begin and minimal existed to be suppressed by val
-            T* topBegin = reinterpret_cast<T*>(topValues.buffer());
-            T* topEnd = topBegin + k;
-            auto exchangePos = std::distance(topBegin, std::find(topBegin, topEnd, sortedVals.t<T>(0)));
-            topValues.r<T>(exchangePos) = val;  //*exchangeIt = val;
-            topIndices.r<sd::LongType>(exchangePos) = i;
-            sortedVals.r<T>(0) = val;  // suppress in sorted
-            // std::sort(sortedVals.begin(), sortedVals.end()); // sorted in ascending order
-            SpecialMethods<T>::sortGeneric(sortedVals.buffer(), sortedVals.shapeInfo(), false);
-          }
-        }
-      }
-      if (needSort) {
-        SpecialMethods<T>::sortGeneric(topValues.buffer(), topValues.shapeInfo(), true);
-
-        for (sd::LongType j = 0; j < width; j++)
-          for (sd::LongType pos = 0; pos < k; ++pos)
-            if (topValues.t<T>(pos) == trial.t<T>(j)) topIndices.r<sd::LongType>(pos) = j;
-      } else {  // else sort by indices
-        std::map<sd::LongType, T> sortValsMap;
-        for (sd::LongType e = 0; e < topValues.lengthOf(); ++e) {
-          sortValsMap[topIndices.t<sd::LongType>(e)] = topValues.t<T>(e);
-        }
+    auto func = PRAGMA_THREADS_FOR {
+      // scratch is reused between rows processed by this thread
+      std::vector<T> copy;
+      std::vector<TopKEntry<T>> candidates;
+      candidates.reserve(k * 16 <= width ? k : width);
 
-        sd::LongType e = 0;
-        for (auto it = sortValsMap.begin(); it != sortValsMap.end(); ++it, e++) {
-          topIndices.r<sd::LongType>(e) = it->first;
-          topValues.r<T>(e) = it->second;
-        }
+      for (auto r = start; r < stop; r++) {
+        candidates.clear();
+        topKSelect<T>(rowOf(r, copy), 0, width, k, candidates);
+        store(r, candidates);
       }
-      if (values) (*values)(e, dimsToExclude).assign(topValues);
-      if (indices) (*indices)(e, dimsToExclude).assign(topIndices);
-    }
+    };
+    samediff::Threads::parallel_tad(func, 0, numOfSubArrs);
   }
+
   return sd::Status::OK;
 }
 // ----------------------------------------------------------------------------------------------- //
@@ -119,36 +180,41 @@ static sd::Status topKFunctor_(const NDArray* input, NDArray* values, NDArray* i
 template <typename T>
 static sd::Status inTopKFunctor_(sd::LaunchContext* context, const NDArray* input, const NDArray* target,
                                  NDArray* result, const sd::LongType k) {
-  std::vector<sd::LongType> shapeI(input->rankOf());
-  for (int i = 0; i < input->rankOf() - 1; i++) shapeI[i] = input->sizeAt(i);
-  shapeI[input->rankOf() - 1] = k;
-  std::unique_ptr<NDArray> indices(NDArrayFactory::create_<sd::LongType>(input->ordering(), shapeI, context));
-  NDArray* values = nullptr;
-  sd::Status status = topKFunctor(context, input, values, indices.get(), k, true);
-  result->assign(0);
-  if (status == sd::Status::OK) {
-    auto func = PRAGMA_THREADS_FOR {
-      for (auto e = start; e < stop; e++) {
-        bool found = false;
-        for (sd::LongType j = 0; j < k; j++) {
-          if (target->e<sd::LongType>(e) == indices->e<sd::LongType>(e * k + j)) {
-            found = true;
-            break;
-          }
-        }
-        if (found) result->p<bool>(e, true);
+  // target is within top k if less than k predictions are strictly greater than its own one,
+  // so classes tied at the boundary of top k are all counted in
+  const sd::LongType width = input->sizeAt(-1);
+  auto inPack = ConstantTadHelper::getInstance().tadForDimensions(input->shapeInfo(), input->rankOf() - 1);
+  const sd::LongType inStride = input->strideAt(-1);
+  const T* x = input->bufferAsT<T>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      const T* row = x + inPack->primaryOffsets()[e];
+      const auto t = target->e<sd::LongType>(e);
+      bool found = false;
+
+      if (t >= 0 && t < width) {
+        const T prediction = row[t * inStride];
+        sd::LongType greater = 0;
+        for (sd::LongType i = 0; i < width && greater < k; i++)
+          if (row[i * inStride] > prediction) greater++;
+        found = greater < k;
       }
-    };
 
-    samediff::Threads::parallel_tad(func, 0, target->lengthOf());
-  }
-  return status;
+      result->p<bool>(e, found);
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, target->lengthOf());
+
+  return sd::Status::OK;
 }
 
 sd::Status topKFunctor(sd::LaunchContext* context, const NDArray* input, NDArray* values, NDArray* indices,
                        const sd::LongType k, bool needSort) {
-  BUILD_SINGLE_SELECTOR(input->dataType(), return topKFunctor_, (input, values, indices, k, needSort),
-                        SD_NUMERIC_TYPES);
+  const auto indexType = indices != nullptr ? indices->dataType() : sd::DataType::INT64;
+  BUILD_DOUBLE_SELECTOR(input->dataType(), indexType, return topKFunctor_, (input, values, indices, k, needSort),
+                        SD_NUMERIC_TYPES, SD_INDEXING_TYPES);
 }
 
 sd::Status inTopKFunctor(sd::LaunchContext* context, const NDArray* input, const NDArray* target, NDArray* result,
@@ -157,9 +223,9 @@ sd::Status inTopKFunctor(sd::LaunchContext* context, const NDArray* input, const
                         SD_NUMERIC_TYPES);
 }
 
-BUILD_SINGLE_TEMPLATE(template sd::Status topKFunctor_,
+BUILD_DOUBLE_TEMPLATE(template sd::Status topKFunctor_,
                       (const NDArray* input, NDArray* values, NDArray* indices, const sd::LongType k, bool needSort),
-                      SD_NUMERIC_TYPES);
+                      SD_NUMERIC_TYPES, SD_INDEXING_TYPES);
 BUILD_SINGLE_TEMPLATE(template sd::Status inTopKFunctor_,
                       (sd::LaunchContext * context, const NDArray* input, const NDArray* target, NDArray* result,
                        const sd::LongType k),
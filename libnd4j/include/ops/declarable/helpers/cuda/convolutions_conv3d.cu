@@ -0,0 +1,139 @@
+/*
+ *  ******************************************************************************
+ *  *
+ *  *
+ *  * This program and the accompanying materials are made available under the
+ *  * terms of the Apache License, Version 2.0 which is available at
+ *  * https://www.apache.org/licenses/LICENSE-2.0.
+ *  *
+ *  * See the NOTICE file distributed with this work for additional
+ *  * information regarding copyright ownership.
+ *  * Unless required by applicable law or agreed to in writing, software
+ *  * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  * License for the specific language governing permissions and limitations
+ *  * under the License.
+ *  *
+ *  * SPDX-License-Identifier: Apache-2.0
+ *  *****************************************************************************
+ */
+
+//
+// @author Yurii Shyrma (iuriish@yahoo.com)
+//
+#include <helpers/MmulHelper.h>
+#include <ops/declarable/helpers/addBias.h>
+#include <ops/declarable/helpers/convolutions.h>
+
+namespace sd {
+namespace ops {
+
+//////////////////////////////////////////////////////////////////////////
+void ConvolutionUtils::conv3d(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
+                              const NDArray* bias, NDArray* output, const LongType kD, const LongType kH,
+                              const LongType kW, const LongType sD, const LongType sH, const LongType sW,
+                              const LongType pD, const LongType pH, const LongType pW, const LongType dD,
+                              const LongType dH, const LongType dW, const int isNCDHW, const int wFormat) {
+  LongType bS, iC, iD, iH, iW, oC, oD, oH,
+      oW;  // batch size, input channels, input depth/height/width, output channels, output depth/height/width;
+  LongType indIOioC, indIOioD, indWoC, indWiC, indWkD;  // corresponding indexes
+  ConvolutionUtils::getSizesAndIndexesConv3d(isNCDHW, wFormat, *input, *output, bS, iC, iD, iH, iW, oC, oD, oH, oW,
+                                             indIOioC, indIOioD, indWiC, indWoC, indWkD);
+
+  std::vector<LongType> permutForOutput;
+
+  if (isNCDHW)
+    permutForOutput = {0, 2, 3, 4, 1};  // [bS, oC, oD, oH, oW] -> [bS, oD, oH, oW, oC]
+  else
+    input = new NDArray(input->permute({0, 4, 1, 2, 3}));
+
+  std::vector<LongType> wAxes;
+  if (0 == wFormat)
+    wAxes = {3, 0, 1, 2};
+  else if (1 == wFormat)
+    wAxes = {1, 2, 3, 4};
+  else
+    wAxes = {4, 1, 2, 3};
+
+  NDArray columns(input->ordering(), {bS, iC, kD, kH, kW, oD, oH, oW}, input->dataType(), block.launchContext());
+  ConvolutionUtils::vol2col(block, *input, columns, sD, sH, sW, pD, pH, pW, dD, dH,
+                            dW);  // [bS, iC, iD, iH, iW] is convoluted to [bS, iC, kD, kH, kW, oD, oH, oW]
+  // [bS, iC, kD, kH, kW, oD, oH, oW] x [kD, kH, kW, iC, oC] = [bS, oD, oH, oW, oC]
+  // [bS, iC, kD, kH, kW, oD, oH, oW] x [oC, iC, kD, kH, kW] = [bS, oD, oH, oW, oC]
+  // [bS, iC, kD, kH, kW, oD, oH, oW] x [oC, kD, kH, kW, iC] = [bS, oD, oH, oW, oC]
+  MmulHelper::tensorDot(&columns, weights, output, {1, 2, 3, 4}, wAxes, permutForOutput);
+
+  if (bias)
+    helpers::addBias(block, *output, *bias, *output, isNCDHW);
+
+  if (!isNCDHW) delete input;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ConvolutionUtils::conv3dBP(sd::graph::Context& block, const NDArray* input, const NDArray* weights,
+                                const NDArray* bias, const NDArray* gradO, NDArray* gradI, NDArray* gradW,
+                                NDArray* gradB, const LongType kD, const LongType kH, const LongType kW,
+                                const LongType sD, const LongType sH, const LongType sW, const LongType pD,
+                                const LongType pH, const LongType pW, const LongType dD, const LongType dH,
+                                const LongType dW, const int isNCDHW, const int wFormat) {
+  LongType bS, iC, iD, iH, iW, oC, oD, oH,
+      oW;  // batch size, input channels, input depth/height/width, output channels, output depth/height/width;
+  LongType indIOioC, indIOioD, indWoC, indWiC, indWkD;  // corresponding indexes
+  ConvolutionUtils::getSizesAndIndexesConv3d(isNCDHW, wFormat, *input, *gradO, bS, iC, iD, iH, iW, oC, oD, oH, oW,
+                                             indIOioC, indIOioD, indWiC, indWoC, indWkD);
+
+  std::vector<LongType> gradOaxesForDot;
+
+  if (!isNCDHW) {
+    gradOaxesForDot = {0, 1, 2, 3};                        // bS, oD, oH, oW
+    input = new NDArray(input->permute({0, 4, 1, 2, 3}));  // [bS, iD, iH, iW, iC] -> [bS, iC, iD, iH, iW]
+    gradI = new NDArray(gradI->permute({0, 4, 1, 2, 3}));  // [bS, iD, iH, iW, iC] -> [bS, iC, iD, iH, iW]
+  } else {
+    gradOaxesForDot = {0, 2, 3, 4};  // bS, oD, oH, oW
+  }
+
+  std::vector<LongType> wPermut, colPermut;
+
+  if (0 == wFormat) {
+    wPermut = {3, 0, 1, 2, 4};
+    colPermut = {2, 3, 4, 1, 0, 5, 6, 7};
+  } else if (1 == wFormat) {
+    wPermut = {1, 2, 3, 4, 0};
+    colPermut = {1, 2, 3, 4, 0, 5, 6, 7};
+  } else {
+    wPermut = {4, 1, 2, 3, 0};
+    colPermut = {2, 3, 4, 1, 0, 5, 6, 7};
+  }
+
+  // ----- calculation of gradW and gradB ----- //
+  NDArray columns(input->ordering(), {bS, iC, kD, kH, kW, oD, oH, oW}, input->dataType(), block.launchContext());
+  ConvolutionUtils::vol2col(block, *input, columns, sD, sH, sW, pD, pH, pW, dD, dH,
+                            dW);  // [bS, iC, iD, iH, iW] is convoluted to [bS, iC, kD, kH, kW, oD, oH, oW]
+  MmulHelper::tensorDot(
+      &columns, gradO, gradW, {0, 5, 6, 7}, gradOaxesForDot,
+      wPermut);  // [bS, iC, kD, kH, kW, oD, oH, oW] x [bS, oD, oH, oW, oC]/[bS, oC, oD, oH, oW] = [iC, kD, kH, kW, oC]
+
+  //----- calculation of gradO -----//
+  if (gradB) {
+    NDArray* gradBR = gradB;
+    if (gradB->rankOf() == 2) gradBR = new NDArray(gradB->reshape(gradB->ordering(), {gradB->lengthOf()}, false));
+    gradO->reduceAlongDimension(reduce::Sum, *gradBR, &gradOaxesForDot);  // sum over bS oD oH oW
+    if (gradBR != gradB) delete gradBR;
+  }
+
+  //----- calculation of gradI -----//
+  // [kD, kH, kW, iC, oC] x [bS, oD, oH, oW, oC]/[bS, oC, oD, oH, oW] = [kD, kH, kW, iC, bS, oD, oH, oW]
+  // [oC, iC, kD, kH, kW] x [bS, oD, oH, oW, oC]/[bS, oC, oD, oH, oW] = [kD, kH, kW, iC, bS, oD, oH, oW]
+  // [oC, kD, kH, kW, iC] x [bS, oD, oH, oW, oC]/[bS, oC, oD, oH, oW] = [kD, kH, kW, iC, bS, oD, oH, oW]
+  MmulHelper::tensorDot(weights, gradO, &columns, {indWoC}, {indIOioC}, colPermut);
+  ConvolutionUtils::col2vol(block, columns, *gradI, sD, sH, sW, pD, pH, pW, dD, dH,
+                            dW);  // columns [bS, iC, kD, kH, kW, oD, oH, oW] is de-convoluted to  [bS, iC, iD, iH, iW]
+
+  if (!isNCDHW) {
+    delete input;
+    delete gradI;
+  }
+}
+
+}  // namespace ops
+}  // namespace sd
@@ -0,0 +1,60 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Embedding bag: gather of table rows and their per bag reduction in a single pass
+//
+
+#ifndef LIBND4J_EMBEDDING_BAG_HELPERS_H
+#define LIBND4J_EMBEDDING_BAG_HELPERS_H
+#include <ops/declarable/helpers/helpers.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+enum EmbeddingBagMode { kEmbeddingBagSum = 0, kEmbeddingBagMean = 1, kEmbeddingBagMax = 2 };
+
+/**
+ * table [numRows, dim], indices [numLookups] are row numbers of table, output [numBags, dim].
+ * With segmentIds = false bags holds [numBags] non-decreasing start positions of bags in indices, bag b ends where
+ * bag b + 1 starts, the last one at the end of indices. With segmentIds = true bags holds [numLookups] bag ids.
+ * weights is optional [numLookups] per lookup multiplier, sum mode only. Empty bags produce zeros.
+ */
+SD_LIB_HIDDEN void embeddingBag(const NDArray& table, const NDArray& indices, const NDArray& bags,
+                                const NDArray* weights, const bool segmentIds, const int mode, NDArray& output);
+
+/**
+ * Sparse gradient of embeddingBag given gradO [numBags, dim]: uniqueIndices [numUnique] receives distinct values
+ * of indices in ascending order and gradRows [numUnique, dim] gradients of the corresponding table rows. gradWeights
+ * [numLookups] is optional, requires weights.
+ */
+SD_LIB_HIDDEN void embeddingBagBp(const NDArray& table, const NDArray& indices, const NDArray& bags,
+                                  const NDArray* weights, const NDArray& gradO, const bool segmentIds, const int mode,
+                                  NDArray& uniqueIndices, NDArray& gradRows, NDArray* gradWeights);
+
+/**
+ * number of distinct values in indices, i.e. length of embeddingBagBp sparse gradient
+ */
+SD_LIB_HIDDEN LongType embeddingBagNumUnique(const NDArray& indices);
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_EMBEDDING_BAG_HELPERS_H
@@ -0,0 +1,53 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Fused scaled dot product attention: softmax(scale * q k^T) v without materializing the [tQ, tK] scores
+//
+
+#ifndef LIBND4J_FUSED_ATTENTION_HELPERS_H
+#define LIBND4J_FUSED_ATTENTION_HELPERS_H
+#include <ops/declarable/helpers/helpers.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+/**
+ * queries [bS, tQ, dK] or [bS, nH, tQ, dK], keys [bS, (nH,) tK, dK], values [bS, (nH,) tK, dV],
+ * output [bS, (nH,) tQ, dV]. Arrays may be arbitrary strided views.
+ * keyMask is optional [bS, tK], zero entries exclude the key. causal excludes keys j > i for query i.
+ * Queries with every key excluded produce zeros.
+ */
+SD_LIB_HIDDEN void fusedDotProductAttention(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                            const NDArray* keyMask, NDArray& output, const double scale,
+                                            const bool causal);
+
+/**
+ * Gradients of fusedDotProductAttention with respect to queries, keys and values given gradO [bS, (nH,) tQ, dV].
+ * Scores are recomputed block by block, extra memory is O(bS * nH * tQ).
+ */
+SD_LIB_HIDDEN void fusedDotProductAttentionBp(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                              const NDArray* keyMask, const NDArray& gradO, NDArray& gradQ,
+                                              NDArray& gradK, NDArray& gradV, const double scale, const bool causal);
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_FUSED_ATTENTION_HELPERS_H
@@ -38,6 +38,11 @@ SD_LIB_HIDDEN void gruCell(const NDArray* x, const NDArray* hLast, const NDArray
 SD_LIB_HIDDEN void gruTimeLoop(sd::LaunchContext* context, const NDArray* x, const NDArray* h0, const NDArray* Wx,
                                const NDArray* Wh, const NDArray* b, NDArray* h, bool linearBeforeReset);
 
+// cpu only: gruTimeLoop with input projection of all time steps precomputed by single gemm, returns false (and does
+// nothing) if given arrays are not supported
+SD_LIB_HIDDEN bool gruTimeLoopFused(const NDArray* x, const NDArray* h0, const NDArray* Wx, const NDArray* Wh,
+                                    const NDArray* b, NDArray* h, bool linearBeforeReset);
+
 SD_LIB_HIDDEN void gruCellBp(sd::LaunchContext* context, const NDArray* x, const NDArray* hLast, const NDArray* W,
                              const NDArray* Wc, const NDArray* b, const NDArray* bc, const NDArray* dLdr,
                              const NDArray* dLdu, const NDArray* dLdc, const NDArray* dLdh, NDArray* dLdx,
@@ -36,6 +36,13 @@ SD_LIB_HIDDEN sd::LongType nonMaxSuppressionGeneric(sd::LaunchContext* context,
                                                     int maxSize, double overlapThreshold, double scoreThreshold,
                                                     NDArray* output);
 
+// boxes [bS, numBoxes, q, 4] (q is 1 or numClasses), scores [bS, numBoxes, numClasses]; per class selection is limited
+// by maxOutputPerClass, merged result is truncated to nmsedScores->sizeAt(1)
+SD_LIB_HIDDEN void combinedNonMaxSuppression(sd::LaunchContext* context, NDArray* boxes, NDArray* scores,
+                                             int maxOutputPerClass, double overlapThreshold, double scoreThreshold,
+                                             bool clipBoxes, NDArray* nmsedBoxes, NDArray* nmsedScores,
+                                             NDArray* nmsedClasses, NDArray* validDetections);
+
 }  // namespace helpers
 }  // namespace ops
 }  // namespace sd
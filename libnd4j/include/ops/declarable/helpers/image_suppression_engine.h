@@ -0,0 +1,171 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Greedy non-max suppression engine shared by image suppression helpers.
+//
+// Candidates are processed in score order in blocks of 64. For every block, suppression masks of its rows against all
+// later candidates are computed in parallel over 64-candidate column words, then the block is swept sequentially:
+// surviving row is selected and its mask is OR-ed into the removed bitset. Boxes are unpacked once, in score order, into
+// structure of arrays, so IoU of one row against a column word reads contiguous memory.
+//
+#ifndef LIBND4J_IMAGE_SUPPRESSION_ENGINE_H
+#define LIBND4J_IMAGE_SUPPRESSION_ENGINE_H
+#include <execution/Threads.h>
+#include <math/templatemath.h>
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// coordinates are computed in float unless boxes are given in double
+template <typename T>
+struct NmsCompute {
+  typedef typename std::conditional<std::is_same<T, double>::value, double, float>::type type;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// boxes [y1, x1, y2, x2] in any corner order, stored as (ymin, xmin, ymax, xmax) and area
+template <typename C>
+class NmsBoxes {
+ private:
+  std::vector<C> _yMin, _xMin, _yMax, _xMax, _area;
+
+ public:
+  explicit NmsBoxes(const sd::LongType numBoxes)
+      : _yMin(numBoxes), _xMin(numBoxes), _yMax(numBoxes), _xMax(numBoxes), _area(numBoxes) {}
+
+  template <typename T>
+  SD_INLINE void set(const sd::LongType i, const T* box, const sd::LongType stride) {
+    const C y1 = static_cast<C>(box[0]), x1 = static_cast<C>(box[stride]);
+    const C y2 = static_cast<C>(box[2 * stride]), x2 = static_cast<C>(box[3 * stride]);
+    _yMin[i] = sd::math::sd_min<C>(y1, y2);
+    _xMin[i] = sd::math::sd_min<C>(x1, x2);
+    _yMax[i] = sd::math::sd_max<C>(y1, y2);
+    _xMax[i] = sd::math::sd_max<C>(x1, x2);
+    _area[i] = (_yMax[i] - _yMin[i]) * (_xMax[i] - _xMin[i]);
+  }
+
+  // intersection over union, zero if any of boxes is degenerate
+  SD_INLINE C operator()(const sd::LongType i, const sd::LongType j) const {
+    const C zero = static_cast<C>(0.f);
+    if (_area[i] <= zero || _area[j] <= zero) return zero;
+
+    const C height = sd::math::sd_min<C>(_yMax[i], _yMax[j]) - sd::math::sd_max<C>(_yMin[i], _yMin[j]);
+    const C width = sd::math::sd_min<C>(_xMax[i], _xMax[j]) - sd::math::sd_max<C>(_xMin[i], _xMin[j]);
+    const C intersection = sd::math::sd_max<C>(height, zero) * sd::math::sd_max<C>(width, zero);
+
+    return intersection / (_area[i] + _area[j] - intersection);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// indices of scores passing threshold, sorted by descending score, equal scores keep ascending index order
+template <typename T>
+static std::vector<sd::LongType> nmsCandidates(const T* scores, const sd::LongType numScores,
+                                               const sd::LongType stride, const float scoreThreshold,
+                                               const bool inclusive) {
+  std::vector<sd::LongType> order;
+  order.reserve(numScores);
+  for (sd::LongType i = 0; i < numScores; ++i) {
+    const auto score = static_cast<float>(scores[i * stride]);
+    if (inclusive ? score >= scoreThreshold : score > scoreThreshold) order.push_back(i);
+  }
+
+  std::stable_sort(order.begin(), order.end(), [scores, stride](const sd::LongType i, const sd::LongType j) {
+    return scores[i * stride] > scores[j * stride];
+  });
+
+  return order;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// greedy selection over candidates 0..numCandidates-1 (already in score order)
+// overlap(i, j) - similarity of candidates i < j, candidate j is suppressed by selected i if similarity is above
+// threshold (or equal to it when inclusive is true)
+// returns positions of selected candidates, at most maxOutputSize of them
+template <typename C, typename Overlap>
+static std::vector<sd::LongType> nmsGreedy(const Overlap& overlap, const sd::LongType numCandidates,
+                                           const sd::LongType maxOutputSize, const C threshold, const bool inclusive,
+                                           const bool parallel = true) {
+  constexpr sd::LongType blockSize = 64;
+  const sd::LongType numWords = (numCandidates + blockSize - 1) / blockSize;
+
+  std::vector<sd::LongType> selected;
+  if (maxOutputSize <= 0 || numCandidates == 0) return selected;
+
+  std::vector<uint64_t> removed(numWords, 0);
+  std::vector<uint64_t> masks(blockSize * numWords, 0);  // masks of rows of current block
+
+  for (sd::LongType word = 0; word < numWords && (sd::LongType)selected.size() < maxOutputSize; ++word) {
+    const sd::LongType rowStart = word * blockSize;
+    const sd::LongType rowEnd = sd::math::sd_min<sd::LongType>(rowStart + blockSize, numCandidates);
+
+    if (rowEnd - rowStart == blockSize ? removed[word] == ~uint64_t(0)
+                                       : removed[word] == (uint64_t(1) << (rowEnd - rowStart)) - 1)
+      continue;  // whole block is suppressed already
+
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto w = start; w < stop; ++w) {
+        const sd::LongType colStart = w * blockSize;
+        const sd::LongType colEnd = sd::math::sd_min<sd::LongType>(colStart + blockSize, numCandidates);
+        const uint64_t colRemoved = removed[w];
+
+        for (sd::LongType r = rowStart; r < rowEnd; ++r) {
+          uint64_t mask = 0;
+          if (((removed[word] >> (r - rowStart)) & 1) == 0)
+            for (sd::LongType c = sd::math::sd_max<sd::LongType>(colStart, r + 1); c < colEnd; ++c) {
+              if ((colRemoved >> (c - colStart)) & 1) continue;
+              const C similarity = overlap(r, c);
+              if (inclusive ? similarity >= threshold : similarity > threshold) mask |= uint64_t(1) << (c - colStart);
+            }
+
+          masks[(r - rowStart) * numWords + w] = mask;
+        }
+      }
+    };
+
+    if (parallel)
+      samediff::Threads::parallel_for(func, word, numWords);
+    else
+      func(0, word, numWords, 1);
+
+    for (sd::LongType r = rowStart; r < rowEnd; ++r) {
+      if ((removed[word] >> (r - rowStart)) & 1) continue;
+
+      selected.push_back(r);
+      if ((sd::LongType)selected.size() == maxOutputSize) break;
+
+      const uint64_t* mask = masks.data() + (r - rowStart) * numWords;
+      for (sd::LongType w = word; w < numWords; ++w) removed[w] |= mask[w];
+    }
+  }
+
+  return selected;
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_IMAGE_SUPPRESSION_ENGINE_H
@@ -0,0 +1,333 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Barnes-Hut repulsive forces over a space-partitioning tree (quadtree for 2D, octree for 3D, 2^D-tree in general)
+//
+#include <system/op_boilerplate.h>
+#if NOT_EXCLUDED(OP_barnes_repulsive_forces)
+
+#include <execution/Threads.h>
+#include <ops/declarable/helpers/BarnesHutTsne.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// Cells of the tree, or of one of its subtrees while the tree is being built in parallel. Children of a cell are
+// consecutive and always come after their parent.
+template <typename T>
+struct SpCells {
+  std::vector<sd::LongType> begin, end, firstChild;
+  std::vector<int> numChildren, depth;
+  std::vector<T> center;
+
+  sd::LongType size() const { return static_cast<sd::LongType>(begin.size()); }
+
+  sd::LongType add(const sd::LongType b, const sd::LongType e, const int d, const T* c, const int dims) {
+    begin.emplace_back(b);
+    end.emplace_back(e);
+    firstChild.emplace_back(-1);
+    numChildren.emplace_back(0);
+    depth.emplace_back(d);
+    center.insert(center.end(), c, c + dims);
+    return size() - 1;
+  }
+};
+
+template <typename T>
+class SpTree {
+ private:
+  // cells holding this many points or less are never split
+  static const sd::LongType kLeafSize = 8;
+  // duplicate points would be split forever otherwise
+  static const int kMaxDepth = 32;
+
+  const T* _data;
+  const sd::LongType _numPoints;
+  const int _dims;
+
+  std::vector<T> _halfWidth;            // max half width of a cell for every depth
+  std::vector<sd::LongType> _points;    // point indices grouped by cell
+  SpCells<T> _cells;
+  std::vector<T> _mass;                 // center of mass for every cell
+
+  bool isLeaf(const SpCells<T>& cells, const sd::LongType c) const {
+    return cells.end[c] - cells.begin[c] <= kLeafSize || cells.depth[c] >= kMaxDepth;
+  }
+
+  // stable counting sort of the cell points by orthant, then one child per non-empty orthant
+  void split(SpCells<T>& cells, const sd::LongType c, std::vector<T>& rootHalf, std::vector<int>& orthants,
+             std::vector<sd::LongType>& scratch, std::vector<sd::LongType>& counts, std::vector<T>& center) {
+    const auto b = cells.begin[c];
+    const auto e = cells.end[c];
+    const int numOrthants = 1 << _dims;
+    const int depth = cells.depth[c];
+    center.assign(cells.center.begin() + c * _dims, cells.center.begin() + (c + 1) * _dims);
+
+    counts.assign(numOrthants + 1, 0);
+    orthants.resize(e - b);
+    scratch.assign(_points.begin() + b, _points.begin() + e);
+    for (sd::LongType p = 0; p < e - b; p++) {
+      auto y = _data + scratch[p] * _dims;
+      int o = 0;
+      for (int d = 0; d < _dims; d++)
+        if (y[d] > center[d]) o |= 1 << d;
+
+      orthants[p] = o;
+      counts[o + 1]++;
+    }
+
+    for (int o = 0; o < numOrthants; o++) counts[o + 1] += counts[o];
+
+    std::vector<sd::LongType> cursor(counts.begin(), counts.end() - 1);
+    for (sd::LongType p = 0; p < e - b; p++) _points[b + cursor[orthants[p]]++] = scratch[p];
+
+    cells.firstChild[c] = cells.size();
+    const T scale = static_cast<T>(1.f) / static_cast<T>(sd::LongType(2) << depth);
+    for (int o = 0; o < numOrthants; o++) {
+      if (counts[o + 1] == counts[o]) continue;
+
+      for (int d = 0; d < _dims; d++) {
+        const T offset = rootHalf[d] * scale;
+        center[d] = cells.center[c * _dims + d] + ((o >> d) & 1 ? offset : -offset);
+      }
+
+      cells.add(b + counts[o], b + counts[o + 1], depth + 1, center.data(), _dims);
+      cells.numChildren[c]++;
+    }
+  }
+
+  void accumulateMass(const sd::LongType c) {
+    auto m = _mass.data() + c * _dims;
+    std::fill_n(m, _dims, static_cast<T>(0.f));
+
+    if (_cells.firstChild[c] < 0) {
+      for (auto p = _cells.begin[c]; p < _cells.end[c]; p++) {
+        auto y = _data + _points[p] * _dims;
+        for (int d = 0; d < _dims; d++) m[d] += y[d];
+      }
+    } else {
+      for (auto k = _cells.firstChild[c]; k < _cells.firstChild[c] + _cells.numChildren[c]; k++)
+        for (int d = 0; d < _dims; d++) m[d] += _mass[k * _dims + d];
+    }
+  }
+
+ public:
+  SpTree(const T* data, const sd::LongType numPoints, const int dims)
+      : _data(data), _numPoints(numPoints), _dims(dims) {
+    std::vector<T> lower(data, data + dims), upper(data, data + dims);
+    for (sd::LongType i = 1; i < numPoints; i++)
+      for (int d = 0; d < dims; d++) {
+        lower[d] = sd::math::sd_min<T>(lower[d], data[i * dims + d]);
+        upper[d] = sd::math::sd_max<T>(upper[d], data[i * dims + d]);
+      }
+
+    std::vector<T> rootHalf(dims), rootCenter(dims);
+    T maxHalf = static_cast<T>(0.f);
+    for (int d = 0; d < dims; d++) {
+      rootCenter[d] = (lower[d] + upper[d]) / static_cast<T>(2.f);
+      rootHalf[d] = sd::math::sd_max<T>((upper[d] - lower[d]) / static_cast<T>(2.f), static_cast<T>(1e-5f));
+      maxHalf = sd::math::sd_max<T>(maxHalf, rootHalf[d]);
+    }
+
+    _halfWidth.resize(kMaxDepth + 1);
+    for (int d = 0; d <= kMaxDepth; d++) _halfWidth[d] = maxHalf / static_cast<T>(sd::LongType(1) << d);
+
+    _points.resize(numPoints);
+    for (sd::LongType i = 0; i < numPoints; i++) _points[i] = i;
+
+    // top levels are split serially until cells are small enough to be handed over to separate threads
+    const auto numThreads = sd::Environment::getInstance().maxMasterThreads();
+    const auto threshold = sd::math::sd_max<sd::LongType>(kLeafSize, numPoints / (8 * numThreads));
+
+    std::vector<int> orthants;
+    std::vector<sd::LongType> scratch, counts, frontier;
+    std::vector<T> center;
+    _cells.add(0, numPoints, 0, rootCenter.data(), dims);
+    for (sd::LongType c = 0; c < _cells.size(); c++) {
+      if (isLeaf(_cells, c)) continue;
+
+      if (_cells.end[c] - _cells.begin[c] <= threshold)
+        frontier.emplace_back(c);
+      else
+        split(_cells, c, rootHalf, orthants, scratch, counts, center);
+    }
+
+    // subtrees below the frontier own disjoint ranges of points, so they're built independently
+    std::vector<SpCells<T>> subtrees(frontier.size());
+    auto buildFunc = PRAGMA_THREADS_FOR {
+      std::vector<int> orthants;
+      std::vector<sd::LongType> scratch, counts;
+      std::vector<T> center;
+      for (auto f = start; f < stop; f++) {
+        auto& local = subtrees[f];
+        const auto c = frontier[f];
+        local.add(_cells.begin[c], _cells.end[c], _cells.depth[c], _cells.center.data() + c * _dims, _dims);
+        for (sd::LongType l = 0; l < local.size(); l++)
+          if (!isLeaf(local, l)) split(local, l, rootHalf, orthants, scratch, counts, center);
+      }
+    };
+    samediff::Threads::parallel_dynamic(buildFunc, 0, frontier.size());
+
+    // local cell l > 0 of subtree f becomes cell offsets[f] + l - 1, local cell 0 is the frontier cell itself
+    std::vector<sd::LongType> offsets(frontier.size() + 1, _cells.size());
+    for (size_t f = 0; f < frontier.size(); f++) offsets[f + 1] = offsets[f] + subtrees[f].size() - 1;
+
+    const auto numTop = _cells.size();
+    const auto numCells = offsets[frontier.size()];
+    _cells.begin.resize(numCells);
+    _cells.end.resize(numCells);
+    _cells.firstChild.resize(numCells);
+    _cells.numChildren.resize(numCells);
+    _cells.depth.resize(numCells);
+    std::vector<T>().swap(_cells.center);
+    _mass.resize(numCells * dims);
+
+    auto mergeFunc = PRAGMA_THREADS_FOR {
+      for (auto f = start; f < stop; f++) {
+        auto& local = subtrees[f];
+        const auto shift = offsets[f] - 1;
+        for (sd::LongType l = 0; l < local.size(); l++) {
+          const auto c = l == 0 ? frontier[f] : shift + l;
+          _cells.begin[c] = local.begin[l];
+          _cells.end[c] = local.end[l];
+          _cells.firstChild[c] = local.firstChild[l] < 0 ? -1 : shift + local.firstChild[l];
+          _cells.numChildren[c] = local.numChildren[l];
+          _cells.depth[c] = local.depth[l];
+        }
+
+        for (auto c = offsets[f + 1] - 1; c >= offsets[f]; c--) accumulateMass(c);
+
+        local = SpCells<T>();
+      }
+    };
+    samediff::Threads::parallel_dynamic(mergeFunc, 0, frontier.size());
+
+    for (auto c = numTop - 1; c >= 0; c--) accumulateMass(c);
+
+    auto normFunc = PRAGMA_THREADS_FOR {
+      for (auto c = start; c < stop; c++) {
+        const auto count = static_cast<T>(_cells.end[c] - _cells.begin[c]);
+        for (int d = 0; d < _dims; d++) _mass[c * _dims + d] /= count;
+      }
+    };
+    samediff::Threads::parallel_for(normFunc, 0, numCells);
+  }
+
+  sd::LongType numCells() const { return _cells.size(); }
+
+  /**
+   * This method computes unnormalized repulsive force for every point, and accumulates sum of q over all pairs.
+   * Cell is summarized by its center of mass when maxHalfWidth / distance < theta, theta == 0 gives exact forces.
+   */
+  double repulsiveForces(const T theta, T* forces) const {
+    std::vector<double> partialSums(_numPoints);
+
+    auto func = PRAGMA_THREADS_FOR {
+      std::vector<sd::LongType> stack;
+      for (auto i = start; i < stop; i++) {
+        auto y = _data + i * _dims;
+        auto force = forces + i * _dims;
+        std::fill_n(force, _dims, static_cast<T>(0.f));
+        double sumQ = 0.;
+
+        stack.assign(1, 0);
+        while (!stack.empty()) {
+          const auto c = stack.back();
+          stack.pop_back();
+
+          auto m = _mass.data() + c * _dims;
+          T dist = static_cast<T>(0.f);
+          for (int d = 0; d < _dims; d++) dist += (y[d] - m[d]) * (y[d] - m[d]);
+
+          const T width = _halfWidth[_cells.depth[c]];
+          if (width * width < theta * theta * dist) {
+            const T q = static_cast<T>(1.f) / (static_cast<T>(1.f) + dist);
+            const T mult = static_cast<T>(_cells.end[c] - _cells.begin[c]) * q;
+            sumQ += mult;
+            for (int d = 0; d < _dims; d++) force[d] += mult * q * (y[d] - m[d]);
+          } else if (_cells.firstChild[c] < 0) {
+            for (auto p = _cells.begin[c]; p < _cells.end[c]; p++) {
+              const auto j = _points[p];
+              if (j == i) continue;
+
+              auto other = _data + j * _dims;
+              T pairDist = static_cast<T>(0.f);
+              for (int d = 0; d < _dims; d++) pairDist += (y[d] - other[d]) * (y[d] - other[d]);
+
+              const T q = static_cast<T>(1.f) / (static_cast<T>(1.f) + pairDist);
+              sumQ += q;
+              for (int d = 0; d < _dims; d++) force[d] += q * q * (y[d] - other[d]);
+            }
+          } else {
+            for (auto k = _cells.firstChild[c]; k < _cells.firstChild[c] + _cells.numChildren[c]; k++)
+              stack.emplace_back(k);
+          }
+        }
+
+        partialSums[i] = sumQ;
+      }
+    };
+    samediff::Threads::parallel_for(func, 0, _numPoints);
+
+    double sumQ = 0.;
+    for (auto v : partialSums) sumQ += v;
+
+    return sumQ;
+  }
+};
+
+template <typename T>
+static void barnes_repulsive_forces_(const NDArray& data, const double theta, NDArray& forces, NDArray& sumQ) {
+  const NDArray* y = data.ordering() == 'c' && data.ews() == 1 ? &data : new NDArray(data.dup('c'));
+  NDArray* z = forces.ordering() == 'c' && forces.ews() == 1
+                   ? &forces
+                   : new NDArray('c', forces.getShapeAsVector(), forces.dataType(), forces.getContext());
+
+  const auto numPoints = y->sizeAt(0);
+  if (numPoints > 0) {
+    SpTree<T> tree(y->bufferAsT<T>(), numPoints, static_cast<int>(y->sizeAt(1)));
+    sumQ.p<double>(0, tree.repulsiveForces(static_cast<T>(theta), z->bufferAsT<T>()));
+  } else {
+    sumQ.p<double>(0, 0.);
+  }
+
+  if (z != &forces) {
+    forces.assign(*z);
+    delete z;
+  }
+  if (y != &data) delete y;
+}
+
+void barnes_repulsive_forces(const NDArray& data, const double theta, NDArray& forces, NDArray& sumQ) {
+  NDArray::preparePrimaryUse({&forces, &sumQ}, {&data});
+
+  BUILD_SINGLE_SELECTOR(data.dataType(), barnes_repulsive_forces_, (data, theta, forces, sumQ), SD_FLOAT_TYPES);
+
+  NDArray::registerPrimaryUse({&forces, &sumQ}, {&data});
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif
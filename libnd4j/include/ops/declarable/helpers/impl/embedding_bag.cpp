@@ -0,0 +1,320 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Embedding bag without materialized [numLookups, dim] gather. Bags are processed in parallel, every bag streams its
+// table rows straight into a dim-sized accumulator, prefetching rows of upcoming lookups. The backward pass groups
+// lookups by table row, so every row of the sparse gradient is reduced by a single thread and the result doesn't
+// depend on scheduling.
+//
+#include <execution/Threads.h>
+#include <ops/declarable/helpers/embedding_bag.h>
+#include <ops/impl/gemm_packed.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// rows of large tables come from memory in random order, touching rows a few lookups ahead overlaps these misses with
+// the reduction of current row
+static const LongType kEmbeddingBagPrefetch = 8;
+// bags handed out to thread at once
+static const LongType kEmbeddingBagGrain = 8;
+
+struct EmbeddingBags {
+  std::vector<LongType> rows;    // table row of every lookup
+  std::vector<LongType> order;   // lookups grouped by bag, empty when bags are contiguous ranges of indices
+  std::vector<LongType> bounds;  // bag b is order[bounds[b] : bounds[b + 1]]
+
+  LongType lookup(const LongType k) const { return order.empty() ? k : order[k]; }
+  LongType numBags() const { return bounds.size() - 1; }
+};
+
+template <typename T>
+static SD_INLINE void embeddingBagPrefetch(const T* row, const LongType length) {
+#if defined(__GNUC__)
+  for (LongType i = 0; i < length; i += 64 / sizeof(T)) __builtin_prefetch(row + i, 0, 1);
+#endif
+}
+
+template <typename I>
+static void embeddingBagReadInts_(const NDArray& array, std::vector<LongType>& values) {
+  const I* x = array.bufferAsT<I>();
+  const LongType ews = array.ews();
+  values.resize(array.lengthOf());
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto i = start; i < stop; i++)
+      values[i] = x[ews > 0 ? i * ews : shape::getIndexOffset(i, array.shapeInfo())];
+  };
+
+  samediff::Threads::parallel_for(func, 0, array.lengthOf());
+}
+
+static std::vector<LongType> embeddingBagInts(const NDArray& array) {
+  std::vector<LongType> values;
+  BUILD_SINGLE_SELECTOR(array.dataType(), embeddingBagReadInts_, (array, values), SD_INTEGER_TYPES);
+  return values;
+}
+
+template <typename X>
+static std::vector<typename sd::blas::GemmAccumulator<X>::type> embeddingBagWeights(const NDArray* weights) {
+  std::vector<typename sd::blas::GemmAccumulator<X>::type> values;
+  if (weights == nullptr) return values;
+
+  const X* w = weights->bufferAsT<X>();
+  values.resize(weights->lengthOf());
+  for (LongType i = 0; i < weights->lengthOf(); i++) values[i] = w[shape::getIndexOffset(i, weights->shapeInfo())];
+
+  return values;
+}
+
+static EmbeddingBags embeddingBags(const NDArray& indices, const NDArray& bags, const bool segmentIds,
+                                   const LongType numRows, const LongType numBags) {
+  EmbeddingBags result;
+  result.rows = embeddingBagInts(indices);
+  const LongType numLookups = result.rows.size();
+
+  for (const auto row : result.rows)
+    if (row < 0 || row >= numRows) THROW_EXCEPTION("embedding_bag: indices must be in range [0, table rows) !");
+
+  const auto b = embeddingBagInts(bags);
+  if (!segmentIds) {
+    result.bounds = b;
+    result.bounds.push_back(numLookups);
+
+    for (LongType i = 0; i < numBags; i++)
+      if (result.bounds[i] < 0 || result.bounds[i] > result.bounds[i + 1])
+        THROW_EXCEPTION("embedding_bag: offsets must be non-decreasing and in range [0, number of indices] !");
+  } else {
+    // counting sort of lookups by bag id, keeps order of lookups within bag
+    result.bounds.assign(numBags + 1, 0);
+    for (const auto id : b) {
+      if (id < 0 || id >= numBags) THROW_EXCEPTION("embedding_bag: segment ids must be in range [0, number of bags) !");
+      result.bounds[id + 1]++;
+    }
+    std::partial_sum(result.bounds.begin(), result.bounds.end(), result.bounds.begin());
+
+    std::vector<LongType> next(result.bounds.begin(), result.bounds.end() - 1);
+    result.order.resize(numLookups);
+    for (LongType k = 0; k < numLookups; k++) result.order[next[b[k]]++] = k;
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void embeddingBag_(const NDArray& table, const EmbeddingBags& bags, const NDArray* weights, const int mode,
+                          NDArray& output) {
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
+
+  const X* t = table.bufferAsT<X>();
+  X* z = output.bufferAsT<X>();
+  const LongType dim = table.sizeAt(1);
+  const LongType tRow = table.strideAt(0), tCol = table.strideAt(1);
+  const LongType zRow = output.strideAt(0), zCol = output.strideAt(1);
+  const auto w = embeddingBagWeights<X>(weights);
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Acc> acc(dim);
+    const LongType lastLookup = bags.bounds[stop];
+
+    for (auto b = start; b < stop; b++) {
+      const LongType count = bags.bounds[b + 1] - bags.bounds[b];
+      const Acc init = mode == kEmbeddingBagMax && count > 0 ? -DataTypeUtils::infOrMax<Acc>() : static_cast<Acc>(0);
+      std::fill(acc.begin(), acc.end(), init);
+
+      for (LongType k = bags.bounds[b]; k < bags.bounds[b + 1]; k++) {
+        if (tCol == 1 && k + kEmbeddingBagPrefetch < lastLookup)
+          embeddingBagPrefetch(t + bags.rows[bags.lookup(k + kEmbeddingBagPrefetch)] * tRow, dim);
+
+        const LongType lookup = bags.lookup(k);
+        const X* row = t + bags.rows[lookup] * tRow;
+
+        if (mode == kEmbeddingBagMax) {
+          for (LongType j = 0; j < dim; j++) acc[j] = sd::math::sd_max<Acc>(acc[j], static_cast<Acc>(row[j * tCol]));
+        } else {
+          const Acc scale = w.empty() ? static_cast<Acc>(1) : w[lookup];
+          PRAGMA_OMP_SIMD
+          for (LongType j = 0; j < dim; j++) acc[j] += scale * static_cast<Acc>(row[j * tCol]);
+        }
+      }
+
+      const Acc factor = mode == kEmbeddingBagMean && count > 0 ? static_cast<Acc>(1) / count : static_cast<Acc>(1);
+      X* zb = z + b * zRow;
+      for (LongType j = 0; j < dim; j++) zb[j * zCol] = static_cast<X>(acc[j] * factor);
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(func, 0, bags.numBags(), 1, sd::Environment::getInstance().maxMasterThreads(),
+                                      kEmbeddingBagGrain);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void embeddingBagBp_(const NDArray& table, const EmbeddingBags& bags, const NDArray* weights,
+                            const NDArray& gradO, const int mode, NDArray& uniqueIndices, NDArray& gradRows,
+                            NDArray* gradWeights) {
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
+
+  const X* t = table.bufferAsT<X>();
+  const X* g = gradO.bufferAsT<X>();
+  X* gR = gradRows.bufferAsT<X>();
+  LongType* uI = uniqueIndices.bufferAsT<LongType>();
+  const LongType numLookups = bags.rows.size();
+  const LongType numBags = bags.numBags();
+  const LongType dim = table.sizeAt(1);
+  const LongType tRow = table.strideAt(0), tCol = table.strideAt(1);
+  const LongType gRow = gradO.strideAt(0), gCol = gradO.strideAt(1);
+  const LongType gRRow = gradRows.strideAt(0), gRCol = gradRows.strideAt(1);
+  const auto w = embeddingBagWeights<X>(weights);
+
+  // bag of every lookup, -1 for lookups before the first offset
+  std::vector<LongType> bagOf(numLookups, -1);
+  // for max: lookup which provided the maximum of every [bag, column]
+  std::vector<LongType> winner(mode == kEmbeddingBagMax ? numBags * dim : 0, -1);
+
+  auto bagFunc = PRAGMA_THREADS_FOR {
+    std::vector<Acc> best(mode == kEmbeddingBagMax ? dim : 0);
+
+    for (auto b = start; b < stop; b++) {
+      for (LongType k = bags.bounds[b]; k < bags.bounds[b + 1]; k++) {
+        const LongType lookup = bags.lookup(k);
+        bagOf[lookup] = b;
+
+        if (mode != kEmbeddingBagMax) continue;
+        const X* row = t + bags.rows[lookup] * tRow;
+        LongType* bagWinner = winner.data() + b * dim;
+        for (LongType j = 0; j < dim; j++) {
+          const Acc v = static_cast<Acc>(row[j * tCol]);
+          if (bagWinner[j] < 0 || v > best[j]) {
+            best[j] = v;
+            bagWinner[j] = lookup;
+          }
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(bagFunc, 0, numBags, 1, sd::Environment::getInstance().maxMasterThreads(),
+                                      kEmbeddingBagGrain);
+
+  // lookups grouped by table row in ascending order, group u is byRow[groups[u] : groups[u + 1]]
+  std::vector<LongType> byRow(numLookups);
+  std::iota(byRow.begin(), byRow.end(), 0);
+  std::sort(byRow.begin(), byRow.end(), [&](const LongType a, const LongType b) {
+    return bags.rows[a] < bags.rows[b] || (bags.rows[a] == bags.rows[b] && a < b);
+  });
+
+  std::vector<LongType> groups;
+  for (LongType k = 0; k < numLookups; k++)
+    if (k == 0 || bags.rows[byRow[k]] != bags.rows[byRow[k - 1]]) groups.push_back(k);
+  groups.push_back(numLookups);
+
+  auto rowFunc = PRAGMA_THREADS_FOR {
+    std::vector<Acc> acc(dim);
+
+    for (auto u = start; u < stop; u++) {
+      std::fill(acc.begin(), acc.end(), static_cast<Acc>(0));
+
+      for (LongType k = groups[u]; k < groups[u + 1]; k++) {
+        const LongType lookup = byRow[k];
+        const LongType b = bagOf[lookup];
+        if (b < 0) continue;
+
+        const X* gb = g + b * gRow;
+        if (mode == kEmbeddingBagMax) {
+          const LongType* bagWinner = winner.data() + b * dim;
+          for (LongType j = 0; j < dim; j++)
+            if (bagWinner[j] == lookup) acc[j] += static_cast<Acc>(gb[j * gCol]);
+        } else {
+          const LongType count = bags.bounds[b + 1] - bags.bounds[b];
+          const Acc scale = mode == kEmbeddingBagMean ? static_cast<Acc>(1) / count
+                                                      : (w.empty() ? static_cast<Acc>(1) : w[lookup]);
+          PRAGMA_OMP_SIMD
+          for (LongType j = 0; j < dim; j++) acc[j] += scale * static_cast<Acc>(gb[j * gCol]);
+        }
+      }
+
+      X* row = gR + u * gRRow;
+      for (LongType j = 0; j < dim; j++) row[j * gRCol] = static_cast<X>(acc[j]);
+      uI[shape::getIndexOffset(u, uniqueIndices.shapeInfo())] = bags.rows[byRow[groups[u]]];
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(rowFunc, 0, groups.size() - 1, 1,
+                                      sd::Environment::getInstance().maxMasterThreads(), kEmbeddingBagGrain);
+
+  if (gradWeights == nullptr) return;
+
+  X* gW = gradWeights->bufferAsT<X>();
+  auto weightsFunc = PRAGMA_THREADS_FOR {
+    for (auto lookup = start; lookup < stop; lookup++) {
+      const LongType b = bagOf[lookup];
+      Acc sum = static_cast<Acc>(0);
+
+      if (b >= 0) {
+        const X* row = t + bags.rows[lookup] * tRow;
+        const X* gb = g + b * gRow;
+        for (LongType j = 0; j < dim; j++) sum += static_cast<Acc>(row[j * tCol]) * static_cast<Acc>(gb[j * gCol]);
+      }
+      gW[shape::getIndexOffset(lookup, gradWeights->shapeInfo())] = static_cast<X>(sum);
+    }
+  };
+
+  samediff::Threads::parallel_for(weightsFunc, 0, numLookups);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void embeddingBag(const NDArray& table, const NDArray& indices, const NDArray& bags, const NDArray* weights,
+                  const bool segmentIds, const int mode, NDArray& output) {
+  NDArray::preparePrimaryUse({&output}, {&table, &indices, &bags, weights});
+  const auto embeddingBagsInfo = embeddingBags(indices, bags, segmentIds, table.sizeAt(0), output.sizeAt(0));
+
+  BUILD_SINGLE_SELECTOR(table.dataType(), embeddingBag_, (table, embeddingBagsInfo, weights, mode, output),
+                        SD_FLOAT_TYPES);
+  NDArray::registerPrimaryUse({&output}, {&table, &indices, &bags, weights});
+}
+
+void embeddingBagBp(const NDArray& table, const NDArray& indices, const NDArray& bags, const NDArray* weights,
+                    const NDArray& gradO, const bool segmentIds, const int mode, NDArray& uniqueIndices,
+                    NDArray& gradRows, NDArray* gradWeights) {
+  NDArray::preparePrimaryUse({&uniqueIndices, &gradRows, gradWeights}, {&table, &indices, &bags, weights, &gradO});
+  const auto embeddingBagsInfo = embeddingBags(indices, bags, segmentIds, table.sizeAt(0), gradO.sizeAt(0));
+
+  BUILD_SINGLE_SELECTOR(
+      table.dataType(), embeddingBagBp_,
+      (table, embeddingBagsInfo, weights, gradO, mode, uniqueIndices, gradRows, gradWeights), SD_FLOAT_TYPES);
+  NDArray::registerPrimaryUse({&uniqueIndices, &gradRows, gradWeights}, {&table, &indices, &bags, weights, &gradO});
+}
+
+LongType embeddingBagNumUnique(const NDArray& indices) {
+  auto rows = embeddingBagInts(indices);
+  std::sort(rows.begin(), rows.end());
+
+  return std::unique(rows.begin(), rows.end()) - rows.begin();
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
@@ -0,0 +1,501 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Tiled scaled dot product attention with online softmax. Query rows are processed in blocks; for every block of keys
+// the scores land in a small tile, the running row max and row sum are updated and the output accumulator is rescaled,
+// so nothing larger than a [queryBlock, keyBlock] tile is held per thread. The backward pass recomputes the tiles
+// from the per row log-sum-exp: dQ is accumulated per query block, dK and dV per key block, so every gradient row has
+// a single writer.
+//
+#include <execution/Threads.h>
+#include <ops/declarable/helpers/fused_attention.h>
+#include <ops/impl/gemm_packed.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// a [64, 64] score tile and the packed q/k/v blocks stay in L2 for head sizes up to 256
+static const LongType kAttentionQueryBlock = 64;
+static const LongType kAttentionKeyBlock = 64;
+
+template <typename T>
+struct AttentionTensor {
+  T* buffer;
+  LongType batchStride;
+  LongType headStride;
+  LongType timeStride;
+  LongType featureStride;
+
+  T* row(const LongType b, const LongType h, const LongType t) const {
+    return buffer + b * batchStride + h * headStride + t * timeStride;
+  }
+};
+
+// [bS, t, d] or [bS, nH, t, d]
+template <typename T>
+static AttentionTensor<T> attentionTensor(T* buffer, const NDArray& array) {
+  AttentionTensor<T> result;
+  result.buffer = buffer;
+  result.batchStride = array.strideAt(0);
+  result.headStride = array.rankOf() == 4 ? array.strideAt(1) : 0;
+  result.timeStride = array.strideAt(-2);
+  result.featureStride = array.strideAt(-1);
+  return result;
+}
+
+template <typename X>
+struct AttentionProblem {
+  AttentionTensor<const X> q;
+  AttentionTensor<const X> k;
+  AttentionTensor<const X> v;
+  LongType bS, nH, tQ, tK, dK, dV;
+  const uint8_t* keep;  // [bS, tK], nullptr without key mask
+  bool causal;
+  double scale;
+
+  // keys past this one are excluded for all query rows [i0, i0 + rows)
+  LongType keyEnd(const LongType i0, const LongType rows) const { return causal ? std::min(tK, i0 + rows) : tK; }
+};
+
+template <typename X>
+static AttentionProblem<X> attentionProblem(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                            const uint8_t* keep, const double scale, const bool causal) {
+  AttentionProblem<X> p;
+  p.q = attentionTensor<const X>(queries.bufferAsT<X>(), queries);
+  p.k = attentionTensor<const X>(keys.bufferAsT<X>(), keys);
+  p.v = attentionTensor<const X>(values.bufferAsT<X>(), values);
+  p.bS = queries.sizeAt(0);
+  p.nH = queries.rankOf() == 4 ? queries.sizeAt(1) : 1;
+  p.tQ = queries.sizeAt(-2);
+  p.tK = keys.sizeAt(-2);
+  p.dK = queries.sizeAt(-1);
+  p.dV = values.sizeAt(-1);
+  p.keep = keep;
+  p.causal = causal;
+  p.scale = scale;
+  return p;
+}
+
+// tile products run on the packed gemm micro kernel, operands are padded to its register tile
+template <typename Acc>
+static LongType attentionGemmRows(const LongType n) {
+  return (n + sd::blas::PackedGemmBlocking<Acc>::MR - 1) / sd::blas::PackedGemmBlocking<Acc>::MR *
+         sd::blas::PackedGemmBlocking<Acc>::MR;
+}
+
+template <typename Acc>
+static LongType attentionGemmCols(const LongType n) {
+  return (n + sd::blas::PackedGemmBlocking<Acc>::NR - 1) / sd::blas::PackedGemmBlocking<Acc>::NR *
+         sd::blas::PackedGemmBlocking<Acc>::NR;
+}
+
+// rows [t0, t0 + rows) of head (b, h) as the left operand [time, feature] of a tile product
+template <typename X, typename Acc>
+static void packAttentionLhs(const AttentionTensor<const X>& src, const LongType b, const LongType h,
+                             const LongType t0, const LongType rows, const LongType width, Acc* packed) {
+  sd::blas::packA<X, Acc, sd::blas::PackedGemmBlocking<Acc>::MR>(src.row(b, h, t0), src.timeStride,
+                                                                  src.featureStride, rows, width, packed);
+}
+
+// the same rows as the right operand, [time, feature] or transposed to [feature, time]
+template <typename X, typename Acc>
+static void packAttentionRhs(const AttentionTensor<const X>& src, const LongType b, const LongType h,
+                             const LongType t0, const LongType rows, const LongType width, const bool transposed,
+                             Acc* packed) {
+  const X* s = src.row(b, h, t0);
+  if (transposed)
+    sd::blas::packB<X, Acc, sd::blas::PackedGemmBlocking<Acc>::NR>(s, src.featureStride, src.timeStride, width, rows,
+                                                                     packed);
+  else
+    sd::blas::packB<X, Acc, sd::blas::PackedGemmBlocking<Acc>::NR>(s, src.timeStride, src.featureStride, rows, width,
+                                                                     packed);
+}
+
+// c[rows, cols] += a[rows, inner] * b[inner, cols] for packed operands, c has row stride ldc and room for rows and
+// cols rounded up to the register tile
+template <typename Acc>
+static void attentionGemm(const LongType rows, const LongType cols, const LongType inner, const Acc* a, const Acc* b,
+                          Acc* c, const LongType ldc) {
+  constexpr int MR = sd::blas::PackedGemmBlocking<Acc>::MR;
+  constexpr int NR = sd::blas::PackedGemmBlocking<Acc>::NR;
+
+  for (LongType jr = 0; jr < cols; jr += NR)
+    for (LongType ir = 0; ir < rows; ir += MR)
+      sd::blas::gemmMicroKernel<Acc, MR, NR>(inner, a + ir * inner, b + jr * inner, c + ir * ldc + jr, ldc);
+}
+
+// dst(b, h, t0 + r, :) = multiplier * src[r, :], src has row stride ld
+template <typename X, typename Acc>
+static void unpackAttentionRows(const Acc* src, const LongType rows, const LongType width, const LongType ld,
+                                const Acc multiplier, const AttentionTensor<X>& dst, const LongType b,
+                                const LongType h, const LongType t0) {
+  X* d = dst.row(b, h, t0);
+  if (dst.featureStride == 1) {
+    for (LongType r = 0; r < rows; r++) {
+      const Acc* sr = src + r * ld;
+      X* dr = d + r * dst.timeStride;
+      for (LongType e = 0; e < width; e++) dr[e] = static_cast<X>(multiplier * sr[e]);
+    }
+  } else {
+    // feature major views (multi head attention keeps [bS, nH, d, t]) are written along time
+    for (LongType e = 0; e < width; e++) {
+      X* de = d + e * dst.featureStride;
+      for (LongType r = 0; r < rows; r++) de[r * dst.timeStride] = static_cast<X>(multiplier * src[r * ld + e]);
+    }
+  }
+}
+
+// per thread buffers, lhs operands are packed by packAttentionLhs, rhs ones by packAttentionRhs;
+// the gradient buffers are only allocated for the backward pass
+template <typename Acc>
+struct AttentionTiles {
+  LongType ldK, ldV;
+  std::vector<Acc> q, kT, v, scores, p, o, rowMax, rowSum;
+  std::vector<Acc> g, vT, k, qRhs, gRhs, gradScores, gradS, gradQ, gradK, gradV;
+
+  AttentionTiles(const LongType dK, const LongType dV, const bool backward)
+      : ldK(attentionGemmCols<Acc>(dK)), ldV(attentionGemmCols<Acc>(dV)) {
+    const LongType queryRows = attentionGemmRows<Acc>(kAttentionQueryBlock);
+    const LongType keyRows = attentionGemmRows<Acc>(kAttentionKeyBlock);
+
+    q.resize(queryRows * dK);
+    kT.resize(dK * kAttentionKeyBlock);
+    v.resize(kAttentionKeyBlock * ldV);
+    scores.resize(queryRows * kAttentionKeyBlock);
+    p.resize(std::max(queryRows * kAttentionKeyBlock, keyRows * kAttentionQueryBlock));
+    o.resize(queryRows * ldV);
+    rowMax.resize(kAttentionQueryBlock);
+    rowSum.resize(kAttentionQueryBlock);
+    if (!backward) return;
+
+    g.resize(queryRows * dV);
+    vT.resize(dV * kAttentionKeyBlock);
+    k.resize(kAttentionKeyBlock * ldK);
+    qRhs.resize(kAttentionQueryBlock * ldK);
+    gRhs.resize(kAttentionQueryBlock * ldV);
+    gradScores.resize(queryRows * kAttentionKeyBlock);
+    gradS.resize(keyRows * kAttentionQueryBlock);
+    gradQ.resize(queryRows * ldK);
+    gradK.resize(keyRows * ldK);
+    gradV.resize(keyRows * ldV);
+  }
+};
+
+// excluded scores of the tile for queries [i0, i0 + rows) and keys [j0, j0 + cols) become -inf
+template <typename X, typename Acc>
+static void maskAttentionTile(const AttentionProblem<X>& p, const LongType b, const LongType i0, const LongType rows,
+                              const LongType j0, const LongType cols, Acc* scores) {
+  const uint8_t* keep = p.keep != nullptr ? p.keep + b * p.tK + j0 : nullptr;
+  const bool causalTile = p.causal && j0 + cols - 1 > i0;
+  if (keep == nullptr && !causalTile) return;
+
+  const Acc minusInf = -std::numeric_limits<Acc>::infinity();
+  for (LongType i = 0; i < rows; i++) {
+    Acc* s = scores + i * kAttentionKeyBlock;
+    const LongType allowed = causalTile ? std::max<LongType>(0, std::min<LongType>(cols, i0 + i - j0 + 1)) : cols;
+    if (keep != nullptr)
+      for (LongType j = 0; j < allowed; j++)
+        if (!keep[j]) s[j] = minusInf;
+    for (LongType j = allowed; j < cols; j++) s[j] = minusInf;
+  }
+}
+
+// scores[i, j] = scale * q_i . k_j for queries [i0, i0 + rows) and keys [j0, j0 + cols), excluded pairs are -inf
+template <typename X, typename Acc>
+static void attentionScores(const AttentionProblem<X>& p, const LongType b, const LongType i0, const LongType rows,
+                            const LongType j0, const LongType cols, const Acc* q, const Acc* kT, Acc* scores) {
+  const Acc scale = static_cast<Acc>(p.scale);
+  std::fill(scores, scores + attentionGemmRows<Acc>(rows) * kAttentionKeyBlock, static_cast<Acc>(0));
+  attentionGemm<Acc>(rows, cols, p.dK, q, kT, scores, kAttentionKeyBlock);
+
+  for (LongType i = 0; i < rows; i++) {
+    Acc* s = scores + i * kAttentionKeyBlock;
+    PRAGMA_OMP_SIMD
+    for (LongType j = 0; j < cols; j++) s[j] *= scale;
+  }
+
+  maskAttentionTile<X, Acc>(p, b, i0, rows, j0, cols, scores);
+}
+
+// Online softmax over the keys visible to queries [i0, i0 + rows) of head (b, h). Leaves the packed queries in t.q,
+// the normalized output rows in t.o and the row log-sum-exp in lse, +inf for queries without visible keys.
+template <typename X, typename Acc>
+static void attentionRowsForward(const AttentionProblem<X>& p, const LongType b, const LongType h, const LongType i0,
+                                 const LongType rows, AttentionTiles<Acc>& t, Acc* lse) {
+  constexpr int MR = sd::blas::PackedGemmBlocking<Acc>::MR;
+  const Acc minusInf = -std::numeric_limits<Acc>::infinity();
+  Acc* scores = t.scores.data();
+  Acc* rowMax = t.rowMax.data();
+  Acc* rowSum = t.rowSum.data();
+  Acc* o = t.o.data();
+
+  packAttentionLhs<X, Acc>(p.q, b, h, i0, rows, p.dK, t.q.data());
+  std::fill(rowMax, rowMax + rows, minusInf);
+  std::fill(rowSum, rowSum + rows, static_cast<Acc>(0));
+  std::fill(t.o.begin(), t.o.end(), static_cast<Acc>(0));
+
+  const LongType keyEnd = p.keyEnd(i0, rows);
+  for (LongType j0 = 0; j0 < keyEnd; j0 += kAttentionKeyBlock) {
+    const LongType cols = std::min(kAttentionKeyBlock, keyEnd - j0);
+    packAttentionRhs<X, Acc>(p.k, b, h, j0, cols, p.dK, true, t.kT.data());
+    packAttentionRhs<X, Acc>(p.v, b, h, j0, cols, p.dV, false, t.v.data());
+    attentionScores<X, Acc>(p, b, i0, rows, j0, cols, t.q.data(), t.kT.data(), scores);
+
+    // scores become unnormalized probabilities under the running max
+    for (LongType i = 0; i < rows; i++) {
+      Acc* s = scores + i * kAttentionKeyBlock;
+      Acc m = rowMax[i];
+      for (LongType j = 0; j < cols; j++) m = sd::math::sd_max<Acc>(m, s[j]);
+      if (m == minusInf) {
+        std::fill(s, s + cols, static_cast<Acc>(0));
+        continue;
+      }
+
+      // rescale what was accumulated under the previous max
+      const Acc correction = std::exp(rowMax[i] - m);
+      if (correction != static_cast<Acc>(1)) {
+        Acc* oi = o + i * t.ldV;
+        PRAGMA_OMP_SIMD
+        for (LongType e = 0; e < p.dV; e++) oi[e] *= correction;
+      }
+
+      Acc sum = 0;
+      for (LongType j = 0; j < cols; j++) {
+        s[j] = std::exp(s[j] - m);
+        sum += s[j];
+      }
+
+      rowMax[i] = m;
+      rowSum[i] = rowSum[i] * correction + sum;
+    }
+
+    // o += p v
+    sd::blas::packA<Acc, Acc, MR>(scores, kAttentionKeyBlock, 1, rows, cols, t.p.data());
+    attentionGemm<Acc>(rows, p.dV, cols, t.p.data(), t.v.data(), o, t.ldV);
+  }
+
+  for (LongType i = 0; i < rows; i++) {
+    if (rowSum[i] > static_cast<Acc>(0)) {
+      Acc* oi = o + i * t.ldV;
+      const Acc inv = static_cast<Acc>(1) / rowSum[i];
+      PRAGMA_OMP_SIMD
+      for (LongType e = 0; e < p.dV; e++) oi[e] *= inv;
+      lse[i] = rowMax[i] + std::log(rowSum[i]);
+    } else {
+      lse[i] = std::numeric_limits<Acc>::infinity();
+    }
+  }
+}
+
+static std::vector<uint8_t> attentionKeyMask(const NDArray* keyMask) {
+  std::vector<uint8_t> keep;
+  if (keyMask == nullptr || keyMask->isEmpty()) return keep;
+
+  keep.resize(keyMask->lengthOf());
+  for (LongType e = 0; e < keyMask->lengthOf(); e++) keep[e] = keyMask->e<double>(e) != 0.0 ? 1 : 0;
+  return keep;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void fusedDotProductAttention_(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                      const uint8_t* keep, NDArray& output, const double scale, const bool causal) {
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
+
+  const auto p = attentionProblem<X>(queries, keys, values, keep, scale, causal);
+  const auto out = attentionTensor<X>(output.bufferAsT<X>(), output);
+  const LongType queryBlocks = (p.tQ + kAttentionQueryBlock - 1) / kAttentionQueryBlock;
+
+  // causal blocks further down the sequence see more keys, hence dynamic scheduling
+  auto func = PRAGMA_THREADS_FOR {
+    AttentionTiles<Acc> t(p.dK, p.dV, false);
+    Acc lse[kAttentionQueryBlock];
+
+    for (auto task = start; task < stop; task++) {
+      const LongType b = task / (p.nH * queryBlocks);
+      const LongType h = (task / queryBlocks) % p.nH;
+      const LongType i0 = (task % queryBlocks) * kAttentionQueryBlock;
+      const LongType rows = std::min(kAttentionQueryBlock, p.tQ - i0);
+
+      attentionRowsForward<X, Acc>(p, b, h, i0, rows, t, lse);
+      unpackAttentionRows<X, Acc>(t.o.data(), rows, p.dV, t.ldV, static_cast<Acc>(1), out, b, h, i0);
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(func, 0, p.bS * p.nH * queryBlocks);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void fusedDotProductAttentionBp_(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                        const uint8_t* keep, const NDArray& gradO, NDArray& gradQ, NDArray& gradK,
+                                        NDArray& gradV, const double scale, const bool causal) {
+  using Acc = typename sd::blas::GemmAccumulator<X>::type;
+  constexpr int MR = sd::blas::PackedGemmBlocking<Acc>::MR;
+
+  const auto p = attentionProblem<X>(queries, keys, values, keep, scale, causal);
+  const auto gO = attentionTensor<const X>(gradO.bufferAsT<X>(), gradO);
+  const auto gQ = attentionTensor<X>(gradQ.bufferAsT<X>(), gradQ);
+  const auto gK = attentionTensor<X>(gradK.bufferAsT<X>(), gradK);
+  const auto gV = attentionTensor<X>(gradV.bufferAsT<X>(), gradV);
+  const Acc scaleAcc = static_cast<Acc>(scale);
+  const LongType queryBlocks = (p.tQ + kAttentionQueryBlock - 1) / kAttentionQueryBlock;
+  const LongType keyBlocks = (p.tK + kAttentionKeyBlock - 1) / kAttentionKeyBlock;
+
+  // per query row: log-sum-exp of the scores and delta = dO . O, the only state kept between the passes
+  std::vector<Acc> lse(p.bS * p.nH * p.tQ);
+  std::vector<Acc> delta(p.bS * p.nH * p.tQ);
+
+  // pass 1, per query block: recompute O to get lse and delta, then dQ = scale * dS K
+  auto queryFunc = PRAGMA_THREADS_FOR {
+    AttentionTiles<Acc> t(p.dK, p.dV, true);
+
+    for (auto task = start; task < stop; task++) {
+      const LongType b = task / (p.nH * queryBlocks);
+      const LongType h = (task / queryBlocks) % p.nH;
+      const LongType i0 = (task % queryBlocks) * kAttentionQueryBlock;
+      const LongType rows = std::min(kAttentionQueryBlock, p.tQ - i0);
+      Acc* rowLse = lse.data() + (b * p.nH + h) * p.tQ + i0;
+      Acc* rowDelta = delta.data() + (b * p.nH + h) * p.tQ + i0;
+
+      attentionRowsForward<X, Acc>(p, b, h, i0, rows, t, rowLse);
+
+      for (LongType i = 0; i < rows; i++) {
+        const X* gi = gO.row(b, h, i0 + i);
+        const Acc* oi = t.o.data() + i * t.ldV;
+        Acc sum = 0;
+        for (LongType e = 0; e < p.dV; e++) sum += static_cast<Acc>(gi[e * gO.featureStride]) * oi[e];
+        rowDelta[i] = sum;
+      }
+
+      packAttentionLhs<X, Acc>(gO, b, h, i0, rows, p.dV, t.g.data());
+      std::fill(t.gradQ.begin(), t.gradQ.end(), static_cast<Acc>(0));
+      const LongType keyEnd = p.keyEnd(i0, rows);
+      for (LongType j0 = 0; j0 < keyEnd; j0 += kAttentionKeyBlock) {
+        const LongType cols = std::min(kAttentionKeyBlock, keyEnd - j0);
+        packAttentionRhs<X, Acc>(p.k, b, h, j0, cols, p.dK, true, t.kT.data());
+        packAttentionRhs<X, Acc>(p.k, b, h, j0, cols, p.dK, false, t.k.data());
+        packAttentionRhs<X, Acc>(p.v, b, h, j0, cols, p.dV, true, t.vT.data());
+        attentionScores<X, Acc>(p, b, i0, rows, j0, cols, t.q.data(), t.kT.data(), t.scores.data());
+
+        // dP = dO v^T, then dS = P * (dP - delta) in place
+        std::fill(t.gradScores.begin(), t.gradScores.end(), static_cast<Acc>(0));
+        attentionGemm<Acc>(rows, cols, p.dV, t.g.data(), t.vT.data(), t.gradScores.data(), kAttentionKeyBlock);
+        for (LongType i = 0; i < rows; i++) {
+          const Acc* s = t.scores.data() + i * kAttentionKeyBlock;
+          Acc* ds = t.gradScores.data() + i * kAttentionKeyBlock;
+          for (LongType j = 0; j < cols; j++) ds[j] = std::exp(s[j] - rowLse[i]) * (ds[j] - rowDelta[i]);
+        }
+
+        sd::blas::packA<Acc, Acc, MR>(t.gradScores.data(), kAttentionKeyBlock, 1, rows, cols, t.p.data());
+        attentionGemm<Acc>(rows, p.dK, cols, t.p.data(), t.k.data(), t.gradQ.data(), t.ldK);
+      }
+
+      unpackAttentionRows<X, Acc>(t.gradQ.data(), rows, p.dK, t.ldK, scaleAcc, gQ, b, h, i0);
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(queryFunc, 0, p.bS * p.nH * queryBlocks);
+
+  // pass 2, per key block: dV = P^T dO, dK = scale * dS^T Q
+  auto keyFunc = PRAGMA_THREADS_FOR {
+    AttentionTiles<Acc> t(p.dK, p.dV, true);
+
+    for (auto task = start; task < stop; task++) {
+      const LongType b = task / (p.nH * keyBlocks);
+      const LongType h = (task / keyBlocks) % p.nH;
+      const LongType j0 = (task % keyBlocks) * kAttentionKeyBlock;
+      const LongType cols = std::min(kAttentionKeyBlock, p.tK - j0);
+      const Acc* headLse = lse.data() + (b * p.nH + h) * p.tQ;
+      const Acc* headDelta = delta.data() + (b * p.nH + h) * p.tQ;
+
+      packAttentionRhs<X, Acc>(p.k, b, h, j0, cols, p.dK, true, t.kT.data());
+      packAttentionRhs<X, Acc>(p.v, b, h, j0, cols, p.dV, true, t.vT.data());
+      std::fill(t.gradK.begin(), t.gradK.end(), static_cast<Acc>(0));
+      std::fill(t.gradV.begin(), t.gradV.end(), static_cast<Acc>(0));
+
+      // with the causal mask earlier queries never see this block
+      for (LongType i0 = p.causal ? j0 : 0; i0 < p.tQ; i0 += kAttentionQueryBlock) {
+        const LongType rows = std::min(kAttentionQueryBlock, p.tQ - i0);
+        packAttentionLhs<X, Acc>(p.q, b, h, i0, rows, p.dK, t.q.data());
+        packAttentionLhs<X, Acc>(gO, b, h, i0, rows, p.dV, t.g.data());
+        packAttentionRhs<X, Acc>(p.q, b, h, i0, rows, p.dK, false, t.qRhs.data());
+        packAttentionRhs<X, Acc>(gO, b, h, i0, rows, p.dV, false, t.gRhs.data());
+        attentionScores<X, Acc>(p, b, i0, rows, j0, cols, t.q.data(), t.kT.data(), t.scores.data());
+
+        std::fill(t.gradScores.begin(), t.gradScores.end(), static_cast<Acc>(0));
+        attentionGemm<Acc>(rows, cols, p.dV, t.g.data(), t.vT.data(), t.gradScores.data(), kAttentionKeyBlock);
+        for (LongType i = 0; i < rows; i++) {
+          Acc* s = t.scores.data() + i * kAttentionKeyBlock;
+          Acc* ds = t.gradScores.data() + i * kAttentionKeyBlock;
+          for (LongType j = 0; j < cols; j++) {
+            s[j] = std::exp(s[j] - headLse[i0 + i]);
+            ds[j] = s[j] * (ds[j] - headDelta[i0 + i]);
+          }
+        }
+
+        // both tiles are consumed transposed, keys become the rows of the product
+        sd::blas::packA<Acc, Acc, MR>(t.scores.data(), 1, kAttentionKeyBlock, cols, rows, t.p.data());
+        sd::blas::packA<Acc, Acc, MR>(t.gradScores.data(), 1, kAttentionKeyBlock, cols, rows, t.gradS.data());
+        attentionGemm<Acc>(cols, p.dV, rows, t.p.data(), t.gRhs.data(), t.gradV.data(), t.ldV);
+        attentionGemm<Acc>(cols, p.dK, rows, t.gradS.data(), t.qRhs.data(), t.gradK.data(), t.ldK);
+      }
+
+      unpackAttentionRows<X, Acc>(t.gradK.data(), cols, p.dK, t.ldK, scaleAcc, gK, b, h, j0);
+      unpackAttentionRows<X, Acc>(t.gradV.data(), cols, p.dV, t.ldV, static_cast<Acc>(1), gV, b, h, j0);
+    }
+  };
+
+  samediff::Threads::parallel_dynamic(keyFunc, 0, p.bS * p.nH * keyBlocks);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void fusedDotProductAttention(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                              const NDArray* keyMask, NDArray& output, const double scale, const bool causal) {
+  const auto keep = attentionKeyMask(keyMask);
+
+  NDArray::preparePrimaryUse({&output}, {&queries, &keys, &values});
+  BUILD_SINGLE_SELECTOR(queries.dataType(), fusedDotProductAttention_,
+                        (queries, keys, values, keep.empty() ? nullptr : keep.data(), output, scale, causal),
+                        SD_FLOAT_TYPES);
+  NDArray::registerPrimaryUse({&output}, {&queries, &keys, &values});
+}
+
+void fusedDotProductAttentionBp(const NDArray& queries, const NDArray& keys, const NDArray& values,
+                                const NDArray* keyMask, const NDArray& gradO, NDArray& gradQ, NDArray& gradK,
+                                NDArray& gradV, const double scale, const bool causal) {
+  const auto keep = attentionKeyMask(keyMask);
+
+  NDArray::preparePrimaryUse({&gradQ, &gradK, &gradV}, {&queries, &keys, &values, &gradO});
+  BUILD_SINGLE_SELECTOR(
+      queries.dataType(), fusedDotProductAttentionBp_,
+      (queries, keys, values, keep.empty() ? nullptr : keep.data(), gradO, gradQ, gradK, gradV, scale, causal),
+      SD_FLOAT_TYPES);
+  NDArray::registerPrimaryUse({&gradQ, &gradK, &gradV}, {&queries, &keys, &values, &gradO});
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
@@ -180,6 +180,10 @@ void gruTimeLoop(sd::LaunchContext* context, const NDArray* x, const NDArray* hI
 
   // h  cell outputs at each time step [sL, bS, nOut]
 
+#ifndef __CUDABLAS__
+  if (gruTimeLoopFused(x, hI, Wx, Wh, b, h, linearBeforeReset)) return;
+#endif
+
   const int sL = x->sizeAt(0);
   const int bS = x->sizeAt(1);
   const int nOut = hI->sizeAt(1);
@@ -0,0 +1,156 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Multi-class, batched non-max suppression in one call
+//
+#include <system/op_boilerplate.h>
+
+#if NOT_EXCLUDED(OP_combined_non_max_suppression)
+
+#include <ops/declarable/helpers/image_suppression.h>
+#include <ops/declarable/helpers/image_suppression_engine.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+template <typename T>
+static void combinedNonMaxSuppression_(const NDArray* boxes, const NDArray* scores, int maxOutputPerClass,
+                                       double overlapThreshold, double scoreThreshold, bool clipBoxes,
+                                       NDArray* nmsedBoxes, NDArray* nmsedScores, NDArray* nmsedClasses,
+                                       NDArray* validDetections) {
+  // boxes           [bS, numBoxes, q, 4], q is 1 (boxes shared by all classes) or numClasses
+  // scores          [bS, numBoxes, numClasses]
+  // nmsedBoxes      [bS, maxDetections, 4]
+  // nmsedScores     [bS, maxDetections]
+  // nmsedClasses    [bS, maxDetections]
+  // validDetections [bS]
+  typedef typename NmsCompute<T>::type C;
+
+  struct Detection {
+    T score;
+    sd::LongType classIdx;
+    sd::LongType boxIdx;
+  };
+
+  const sd::LongType bS = scores->sizeAt(0);
+  const sd::LongType numBoxes = scores->sizeAt(1);
+  const sd::LongType numClasses = scores->sizeAt(2);
+  const sd::LongType q = boxes->sizeAt(2);
+  const sd::LongType maxDetections = nmsedScores->sizeAt(1);
+
+  const T* boxesBuff = boxes->bufferAsT<T>();
+  const T* scoresBuff = scores->bufferAsT<T>();
+  const sd::LongType bStride0 = boxes->strideAt(0), bStride1 = boxes->strideAt(1), bStride2 = boxes->strideAt(2),
+                     bStride3 = boxes->strideAt(3);
+  const sd::LongType sStride0 = scores->strideAt(0), sStride1 = scores->strideAt(1), sStride2 = scores->strideAt(2);
+
+  // every (batch, class) pair is independent, so engine itself runs single-threaded here
+  std::vector<std::vector<Detection>> perClass(bS * numClasses);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto task = start; task < stop; ++task) {
+      const sd::LongType b = task / numClasses;
+      const sd::LongType c = task % numClasses;
+
+      const T* classScores = scoresBuff + b * sStride0 + c * sStride2;
+      const T* classBoxes = boxesBuff + b * bStride0 + (q == 1 ? 0 : c) * bStride2;
+
+      const auto order = nmsCandidates<T>(classScores, numBoxes, sStride1, static_cast<float>(scoreThreshold), false);
+      const sd::LongType numCandidates = order.size();
+
+      NmsBoxes<C> sorted(numCandidates);
+      for (sd::LongType i = 0; i < numCandidates; ++i) sorted.set(i, classBoxes + order[i] * bStride1, bStride3);
+
+      const auto selected = nmsGreedy<C>(sorted, numCandidates, maxOutputPerClass, static_cast<C>(overlapThreshold),
+                                         false, false);
+
+      auto& detections = perClass[task];
+      detections.reserve(selected.size());
+      for (auto i : selected) detections.push_back({classScores[order[i] * sStride1], c, order[i]});
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, bS * numClasses);
+
+  T* zBoxes = nmsedBoxes->bufferAsT<T>();
+  T* zScores = nmsedScores->bufferAsT<T>();
+  T* zClasses = nmsedClasses->bufferAsT<T>();
+  int* zValid = validDetections->bufferAsT<int>();
+
+  auto merge = PRAGMA_THREADS_FOR {
+    for (auto b = start; b < stop; ++b) {
+      std::vector<Detection> detections;
+      for (sd::LongType c = 0; c < numClasses; ++c)
+        detections.insert(detections.end(), perClass[b * numClasses + c].begin(), perClass[b * numClasses + c].end());
+
+      // equal scores keep class order
+      std::stable_sort(detections.begin(), detections.end(),
+                       [](const Detection& x, const Detection& y) { return x.score > y.score; });
+
+      const sd::LongType numValid = sd::math::sd_min<sd::LongType>(detections.size(), maxDetections);
+
+      for (sd::LongType i = 0; i < maxDetections; ++i) {
+        T* zBox = zBoxes + b * nmsedBoxes->strideAt(0) + i * nmsedBoxes->strideAt(1);
+        T& zScore = zScores[b * nmsedScores->strideAt(0) + i * nmsedScores->strideAt(1)];
+        T& zClass = zClasses[b * nmsedClasses->strideAt(0) + i * nmsedClasses->strideAt(1)];
+
+        if (i >= numValid) {
+          for (int k = 0; k < 4; ++k) zBox[k * nmsedBoxes->strideAt(2)] = static_cast<T>(0.f);
+          zScore = static_cast<T>(0.f);
+          zClass = static_cast<T>(0.f);
+          continue;
+        }
+
+        const auto& d = detections[i];
+        const T* box = boxesBuff + b * bStride0 + d.boxIdx * bStride1 + (q == 1 ? 0 : d.classIdx) * bStride2;
+        for (int k = 0; k < 4; ++k) {
+          T v = box[k * bStride3];
+          if (clipBoxes) v = sd::math::sd_min<T>(sd::math::sd_max<T>(v, static_cast<T>(0.f)), static_cast<T>(1.f));
+          zBox[k * nmsedBoxes->strideAt(2)] = v;
+        }
+        zScore = d.score;
+        zClass = static_cast<T>(d.classIdx);
+      }
+
+      zValid[b * validDetections->strideAt(0)] = static_cast<int>(numValid);
+    }
+  };
+
+  samediff::Threads::parallel_for(merge, 0, bS);
+}
+
+void combinedNonMaxSuppression(sd::LaunchContext* context, NDArray* boxes, NDArray* scores, int maxOutputPerClass,
+                               double overlapThreshold, double scoreThreshold, bool clipBoxes, NDArray* nmsedBoxes,
+                               NDArray* nmsedScores, NDArray* nmsedClasses, NDArray* validDetections) {
+  NDArray::preparePrimaryUse({nmsedBoxes, nmsedScores, nmsedClasses, validDetections}, {boxes, scores});
+
+  BUILD_SINGLE_SELECTOR(boxes->dataType(), combinedNonMaxSuppression_,
+                        (boxes, scores, maxOutputPerClass, overlapThreshold, scoreThreshold, clipBoxes, nmsedBoxes,
+                         nmsedScores, nmsedClasses, validDetections),
+                        SD_FLOAT_TYPES);
+
+  NDArray::registerPrimaryUse({nmsedBoxes, nmsedScores, nmsedClasses, validDetections}, {boxes, scores});
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif
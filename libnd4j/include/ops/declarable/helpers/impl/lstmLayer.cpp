@@ -609,6 +609,10 @@ void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const NDArray* Wr, c
   // params = {dataFormat, directionMode, cellClip, gateAct, gateAlpha, gateBeta, cellAct, cellAlpha, cellBeta, outAct,
   // outAlpha, outBeta}; dataFormat: 0,3 = [sL, bS, nIn], 1 = [bS, sL ,nIn], 2 = [bS, nIn, sL]
 
+#ifndef __CUDABLAS__
+  if (lstmLayerTimeLoopFused(x, Wx, Wr, b, seqLen, hI, cI, Wp, params, forward, h, hL, cL)) return;
+#endif
+
   const int dataFormat = params[0];
   const int directionMode = params[1];
 
@@ -0,0 +1,476 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Affine int8 quantization. Integer matmul and conv2d run on the int8 gemm (ops/impl/gemm_int8.hpp) with scaling,
+// bias and requantization applied in its epilogue, so int32 accumulators are never written to memory.
+//
+#include <execution/Threads.h>
+#include <ops/declarable/helpers/convolutions.h>
+#include <ops/declarable/helpers/quantization.h>
+#include <ops/impl/gemm_int8.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+// input seen as [outer, channels, inner] around axis, channels is 1 for per-tensor parameters
+static void quantizationLayout(const NDArray& input, const NDArray& scale, const int axis, LongType& channels,
+                               LongType& inner) {
+  channels = 1;
+  inner = input.lengthOf();
+  if (scale.lengthOf() == 1) return;
+
+  const int rank = input.rankOf();
+  const int a = axis < 0 ? axis + rank : axis;
+  channels = input.sizeAt(a);
+  inner = 1;
+  for (int e = a + 1; e < rank; e++) inner *= input.sizeAt(e);
+}
+
+static std::vector<float> quantizationScales(const NDArray& scale, const LongType channels) {
+  std::vector<float> result(channels);
+  for (LongType c = 0; c < channels; c++) result[c] = scale.e<float>(scale.lengthOf() == 1 ? 0 : c);
+  return result;
+}
+
+static std::vector<int32_t> quantizationZeroPoints(const NDArray& zeroPoint, const LongType channels) {
+  std::vector<int32_t> result(channels);
+  for (LongType c = 0; c < channels; c++) result[c] = zeroPoint.e<int32_t>(zeroPoint.lengthOf() == 1 ? 0 : c);
+  return result;
+}
+
+// saturate(round(v) + zeroPoint), nearbyint rounds half to even under the default rounding mode
+template <typename Z>
+static SD_INLINE Z quantizeValue(const float v, const int32_t zeroPoint) {
+  const float r = std::nearbyint(v) + static_cast<float>(zeroPoint);
+  if (r >= static_cast<float>(std::numeric_limits<Z>::max())) return std::numeric_limits<Z>::max();
+  if (r <= static_cast<float>(std::numeric_limits<Z>::lowest())) return std::numeric_limits<Z>::lowest();
+  return static_cast<Z>(r);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X, typename Z>
+static void quantizeLinearT(const NDArray& input, const std::vector<float>& scales,
+                            const std::vector<int32_t>& zeroPoints, const LongType channels, const LongType inner,
+                            NDArray& output) {
+  const X* x = input.bufferAsT<X>();
+  Z* z = output.bufferAsT<Z>();
+  const LongType length = input.lengthOf();
+
+  if (channels > 1 && inner == 1) {
+    // channels are the fastest changing dimension
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto r = start; r < stop; r++)
+        for (LongType c = 0; c < channels; c++)
+          z[r * channels + c] = quantizeValue<Z>(static_cast<float>(x[r * channels + c]) / scales[c], zeroPoints[c]);
+    };
+    samediff::Threads::parallel_for(func, 0, length / channels);
+    return;
+  }
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop;) {
+      const LongType c = (e / inner) % channels;
+      const LongType end = sd::math::sd_min<LongType>(stop, (e / inner + 1) * inner);
+      const float s = scales[c];
+      const int32_t zp = zeroPoints[c];
+      for (auto i = e; i < end; i++) z[i] = quantizeValue<Z>(static_cast<float>(x[i]) / s, zp);
+      e = end;
+    }
+  };
+  samediff::Threads::parallel_for(func, 0, length);
+}
+
+template <typename X>
+static void quantizeLinear_(const NDArray& input, const std::vector<float>& scales,
+                            const std::vector<int32_t>& zeroPoints, const LongType channels, const LongType inner,
+                            NDArray& output) {
+  switch (output.dataType()) {
+    case sd::DataType::INT8:
+      quantizeLinearT<X, int8_t>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    case sd::DataType::UINT8:
+      quantizeLinearT<X, uint8_t>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    case sd::DataType::INT32:
+      quantizeLinearT<X, int32_t>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    default:
+      THROW_EXCEPTION("quantizeLinear: output data type must be INT8, UINT8 or INT32");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X, typename Z>
+static void dequantizeLinearT(const NDArray& input, const std::vector<float>& scales,
+                              const std::vector<int32_t>& zeroPoints, const LongType channels, const LongType inner,
+                              NDArray& output) {
+  const X* x = input.bufferAsT<X>();
+  Z* z = output.bufferAsT<Z>();
+  const LongType length = input.lengthOf();
+
+  if (channels > 1 && inner == 1) {
+    auto func = PRAGMA_THREADS_FOR {
+      for (auto r = start; r < stop; r++)
+        for (LongType c = 0; c < channels; c++)
+          z[r * channels + c] =
+              static_cast<Z>(static_cast<float>(static_cast<int32_t>(x[r * channels + c]) - zeroPoints[c]) * scales[c]);
+    };
+    samediff::Threads::parallel_for(func, 0, length / channels);
+    return;
+  }
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop;) {
+      const LongType c = (e / inner) % channels;
+      const LongType end = sd::math::sd_min<LongType>(stop, (e / inner + 1) * inner);
+      const float s = scales[c];
+      const int32_t zp = zeroPoints[c];
+      PRAGMA_OMP_SIMD
+      for (auto i = e; i < end; i++) z[i] = static_cast<Z>(static_cast<float>(static_cast<int32_t>(x[i]) - zp) * s);
+      e = end;
+    }
+  };
+  samediff::Threads::parallel_for(func, 0, length);
+}
+
+template <typename Z>
+static void dequantizeLinear_(const NDArray& input, const std::vector<float>& scales,
+                              const std::vector<int32_t>& zeroPoints, const LongType channels, const LongType inner,
+                              NDArray& output) {
+  switch (input.dataType()) {
+    case sd::DataType::INT8:
+      dequantizeLinearT<int8_t, Z>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    case sd::DataType::UINT8:
+      dequantizeLinearT<uint8_t, Z>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    case sd::DataType::INT32:
+      dequantizeLinearT<int32_t, Z>(input, scales, zeroPoints, channels, inner, output);
+      break;
+    default:
+      THROW_EXCEPTION("dequantizeLinear: input data type must be INT8, UINT8 or INT32");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void quantizeLinear(const NDArray& input, const NDArray& scale, const NDArray& zeroPoint, const int axis,
+                    NDArray& output) {
+  LongType channels, inner;
+  quantizationLayout(input, scale, axis, channels, inner);
+  const auto scales = quantizationScales(scale, channels);
+  const auto zeroPoints = quantizationZeroPoints(zeroPoint, channels);
+
+  NDArray::preparePrimaryUse({&output}, {&input});
+
+  const NDArray* x = input.ordering() == 'c' && input.ews() == 1 ? &input : new NDArray(input.dup('c'));
+  NDArray* z = output.ordering() == 'c' && output.ews() == 1
+                   ? &output
+                   : new NDArray('c', output.getShapeAsVector(), output.dataType(), output.getContext());
+
+  BUILD_SINGLE_SELECTOR(input.dataType(), quantizeLinear_, (*x, scales, zeroPoints, channels, inner, *z),
+                        SD_FLOAT_TYPES);
+
+  if (z != &output) {
+    output.assign(*z);
+    delete z;
+  }
+  if (x != &input) delete x;
+
+  NDArray::registerPrimaryUse({&output}, {&input});
+}
+
+void dequantizeLinear(const NDArray& input, const NDArray& scale, const NDArray& zeroPoint, const int axis,
+                      NDArray& output) {
+  LongType channels, inner;
+  quantizationLayout(input, scale, axis, channels, inner);
+  const auto scales = quantizationScales(scale, channels);
+  const auto zeroPoints = quantizationZeroPoints(zeroPoint, channels);
+
+  NDArray::preparePrimaryUse({&output}, {&input});
+
+  const NDArray* x = input.ordering() == 'c' && input.ews() == 1 ? &input : new NDArray(input.dup('c'));
+  NDArray* z = output.ordering() == 'c' && output.ews() == 1
+                   ? &output
+                   : new NDArray('c', output.getShapeAsVector(), output.dataType(), output.getContext());
+
+  BUILD_SINGLE_SELECTOR(output.dataType(), dequantizeLinear_, (*x, scales, zeroPoints, channels, inner, *z),
+                        SD_FLOAT_TYPES);
+
+  if (z != &output) {
+    output.assign(*z);
+    delete z;
+  }
+  if (x != &input) delete x;
+
+  NDArray::registerPrimaryUse({&output}, {&input});
+}
+
+//////////////////////////////////////////////////////////////////////////
+// per output column out = acc * mul + add, followed by rounding and zeroPoint for integer outputs
+struct QuantizedEpilogue {
+  std::vector<float> mul, add;
+  int32_t zeroPoint;
+
+  QuantizedEpilogue(const sd::DataType zType, const float xScale, const std::vector<float>& wScales,
+                    const NDArray* bias, const double outScale, const int outZeroPoint)
+      : mul(wScales.size()), add(wScales.size()), zeroPoint(outZeroPoint) {
+    const bool requantize = zType == sd::DataType::INT8 || zType == sd::DataType::UINT8;
+    const float invOutScale = requantize ? static_cast<float>(1. / outScale) : 1.f;
+    for (size_t c = 0; c < wScales.size(); c++) {
+      mul[c] = xScale * wScales[c] * invOutScale;
+      add[c] = bias != nullptr ? bias->e<float>(c) * invOutScale : 0.f;
+    }
+  }
+};
+
+template <typename Z>
+static SD_INLINE Z quantizedOutput(const int32_t acc, const float mul, const float add, const int32_t zeroPoint) {
+  return static_cast<Z>(static_cast<float>(acc) * mul + add);
+}
+
+template <>
+SD_INLINE int8_t quantizedOutput<int8_t>(const int32_t acc, const float mul, const float add, const int32_t zeroPoint) {
+  return quantizeValue<int8_t>(static_cast<float>(acc) * mul + add, zeroPoint);
+}
+
+template <>
+SD_INLINE uint8_t quantizedOutput<uint8_t>(const int32_t acc, const float mul, const float add,
+                                           const int32_t zeroPoint) {
+  return quantizeValue<uint8_t>(static_cast<float>(acc) * mul + add, zeroPoint);
+}
+
+template <>
+SD_INLINE int32_t quantizedOutput<int32_t>(const int32_t acc, const float mul, const float add,
+                                           const int32_t zeroPoint) {
+  return acc;
+}
+
+template <typename X, typename Z>
+static void quantizedGemm(const LongType M, const X* A, const LongType aRowStride, const LongType aColStride,
+                          const int32_t aZeroPoint, const sd::blas::Int8GemmPackedB& B,
+                          const std::vector<int32_t>& bZeroPoints, const QuantizedEpilogue& epilogue, Z* C,
+                          const LongType cRowStride, const LongType cColStride) {
+  const bool symmetric =
+      std::all_of(bZeroPoints.begin(), bZeroPoints.end(), [](const int32_t zp) -> bool { return zp == 0; });
+
+  sd::blas::int8Gemm<X>(M, A, aRowStride, aColStride, aZeroPoint, B, symmetric ? nullptr : bZeroPoints.data(),
+                        [&](const LongType r, const LongType c, const LongType count, const int32_t* acc) {
+                          Z* out = C + r * cRowStride + c * cColStride;
+                          const float* mul = epilogue.mul.data() + c;
+                          const float* add = epilogue.add.data() + c;
+                          for (LongType j = 0; j < count; j++)
+                            out[j * cColStride] = quantizedOutput<Z>(acc[j], mul[j], add[j], epilogue.zeroPoint);
+                        });
+}
+
+#define SD_QUANTIZED_OUTPUT_SELECTOR(X, ZTYPE, NAME, SIGNATURE)                               \
+  switch (ZTYPE) {                                                                            \
+    case sd::DataType::FLOAT32:                                                               \
+      NAME<X, float> SIGNATURE;                                                               \
+      break;                                                                                  \
+    case sd::DataType::DOUBLE:                                                                \
+      NAME<X, double> SIGNATURE;                                                              \
+      break;                                                                                  \
+    case sd::DataType::HALF:                                                                  \
+      NAME<X, float16> SIGNATURE;                                                             \
+      break;                                                                                  \
+    case sd::DataType::BFLOAT16:                                                              \
+      NAME<X, bfloat16> SIGNATURE;                                                            \
+      break;                                                                                  \
+    case sd::DataType::INT8:                                                                  \
+      NAME<X, int8_t> SIGNATURE;                                                              \
+      break;                                                                                  \
+    case sd::DataType::UINT8:                                                                 \
+      NAME<X, uint8_t> SIGNATURE;                                                             \
+      break;                                                                                  \
+    case sd::DataType::INT32:                                                                 \
+      NAME<X, int32_t> SIGNATURE;                                                             \
+      break;                                                                                  \
+    default:                                                                                  \
+      THROW_EXCEPTION("quantized gemm: output must be floating point, INT8, UINT8 or INT32"); \
+  }
+
+#define SD_QUANTIZED_SELECTOR(XTYPE, ZTYPE, NAME, SIGNATURE)                    \
+  switch (XTYPE) {                                                              \
+    case sd::DataType::INT8:                                                    \
+      SD_QUANTIZED_OUTPUT_SELECTOR(int8_t, ZTYPE, NAME, SIGNATURE);             \
+      break;                                                                    \
+    case sd::DataType::UINT8:                                                   \
+      SD_QUANTIZED_OUTPUT_SELECTOR(uint8_t, ZTYPE, NAME, SIGNATURE);            \
+      break;                                                                    \
+    default:                                                                    \
+      THROW_EXCEPTION("quantized gemm: quantized input must be INT8 or UINT8"); \
+  }
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X, typename Z>
+static void quantizedMatmul_(const NDArray& x, const NDArray& w, const int32_t xZeroPoint,
+                             const std::vector<int32_t>& wZeroPoints, const QuantizedEpilogue& epilogue,
+                             NDArray& output) {
+  sd::blas::Int8GemmPackedB packed;
+  sd::blas::int8PackMatrixB(w.sizeAt(0), w.sizeAt(1), w.bufferAsT<int8_t>(), w.strideAt(0), w.strideAt(1), packed);
+
+  quantizedGemm<X, Z>(x.sizeAt(0), x.bufferAsT<X>(), x.strideAt(0), x.strideAt(1), xZeroPoint, packed, wZeroPoints,
+                      epilogue, output.bufferAsT<Z>(), output.strideAt(0), output.strideAt(1));
+}
+
+void quantizedMatmul(const NDArray& x, const NDArray& w, const NDArray& xScale, const NDArray& xZeroPoint,
+                     const NDArray& wScale, const NDArray& wZeroPoint, const NDArray* bias, const double outScale,
+                     const int outZeroPoint, NDArray& output) {
+  const LongType N = w.sizeAt(1);
+  const QuantizedEpilogue epilogue(output.dataType(), xScale.e<float>(0), quantizationScales(wScale, N), bias,
+                                   outScale, outZeroPoint);
+  const auto wZeroPoints = quantizationZeroPoints(wZeroPoint, N);
+  const int32_t xZp = xZeroPoint.e<int32_t>(0);
+
+  NDArray::preparePrimaryUse({&output}, {&x, &w});
+
+  SD_QUANTIZED_SELECTOR(x.dataType(), output.dataType(), quantizedMatmul_,
+                        (x, w, xZp, wZeroPoints, epilogue, output));
+
+  NDArray::registerPrimaryUse({&output}, {&x, &w});
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X, typename Z>
+static void quantizedConv2d_(const NDArray& input, const int8_t* w, const LongType wRowStride,
+                             const LongType wColStride, const int32_t xZeroPoint,
+                             const std::vector<int32_t>& wZeroPoints, const QuantizedEpilogue& epilogue,
+                             NDArray& output, const LongType kH, const LongType kW, const LongType sH,
+                             const LongType sW, const LongType pH, const LongType pW, const LongType dH,
+                             const LongType dW, const int isNCHW) {
+  // input  [bS, iH, iW, iC] (NHWC) or [bS, iC, iH, iW] (NCHW), 'c' order
+  // output [bS, oH, oW, oC] (NHWC) or [bS, oC, oH, oW] (NCHW), 'c' order
+  const LongType bS = input.sizeAt(0);
+  const LongType iC = input.sizeAt(isNCHW ? 1 : 3);
+  const LongType iH = input.sizeAt(isNCHW ? 2 : 1);
+  const LongType iW = input.sizeAt(isNCHW ? 3 : 2);
+  const LongType oC = output.sizeAt(isNCHW ? 1 : 3);
+  const LongType oH = output.sizeAt(isNCHW ? 2 : 1);
+  const LongType oW = output.sizeAt(isNCHW ? 3 : 2);
+  const LongType oHW = oH * oW;
+  const LongType K = kH * kW * iC;
+
+  const X* x = input.bufferAsT<X>();
+  Z* z = output.bufferAsT<Z>();
+  const X pad = static_cast<X>(xZeroPoint);
+
+  // NHWC 1x1 convolution is a plain matmul over the input
+  const bool pointwise = !isNCHW && kH == 1 && kW == 1 && sH == 1 && sW == 1 && pH == 0 && pW == 0;
+  std::vector<X> columns(pointwise ? 0 : oHW * K);
+
+  // the weights are shared by every batch item, so they are packed once per call
+  sd::blas::Int8GemmPackedB packed;
+  sd::blas::int8PackMatrixB(K, oC, w, wRowStride, wColStride, packed);
+
+  for (LongType b = 0; b < bS; b++) {
+    const X* xb = x + b * iC * iH * iW;
+
+    if (!pointwise) {
+      // rows of [oH * oW, kH * kW * iC] columns, k runs over (kh, kw, ic) like the weights matrix
+      auto func = PRAGMA_THREADS_FOR {
+        for (auto p = start; p < stop; p++) {
+          const LongType oh = p / oW;
+          const LongType ow = p % oW;
+          X* row = columns.data() + p * K;
+          for (LongType kh = 0; kh < kH; kh++) {
+            const LongType ih = oh * sH - pH + kh * dH;
+            for (LongType kw = 0; kw < kW; kw++) {
+              const LongType iw = ow * sW - pW + kw * dW;
+              X* dst = row + (kh * kW + kw) * iC;
+              if (ih < 0 || ih >= iH || iw < 0 || iw >= iW)
+                std::fill(dst, dst + iC, pad);
+              else if (isNCHW)
+                for (LongType ic = 0; ic < iC; ic++) dst[ic] = xb[(ic * iH + ih) * iW + iw];
+              else
+                std::memcpy(dst, xb + (ih * iW + iw) * iC, iC * sizeof(X));
+            }
+          }
+        }
+      };
+      samediff::Threads::parallel_for(func, 0, oHW);
+    }
+
+    quantizedGemm<X, Z>(oHW, pointwise ? xb : columns.data(), K, 1, xZeroPoint, packed, wZeroPoints, epilogue,
+                        z + b * oC * oHW, isNCHW ? 1 : oC, isNCHW ? oHW : 1);
+  }
+}
+
+void quantizedConv2d(const NDArray& input, const NDArray& weights, const NDArray& xScale, const NDArray& xZeroPoint,
+                     const NDArray& wScale, const NDArray& wZeroPoint, const NDArray* bias, NDArray& output,
+                     const LongType kH, const LongType kW, const LongType sH, const LongType sW, LongType pH,
+                     LongType pW, const LongType dH, const LongType dW, const int isSameMode, const int isNCHW,
+                     const int wFormat, const double outScale, const int outZeroPoint) {
+  // weights [kH, kW, iC, oC], [oC, iC, kH, kW], [oC, kH, kW, iC]
+  const LongType iC = input.sizeAt(isNCHW ? 1 : 3);
+  const LongType oC = output.sizeAt(isNCHW ? 1 : 3);
+  const LongType K = kH * kW * iC;
+
+  if (isSameMode)
+    ConvolutionUtils::calcPadding2D(pH, pW, output.sizeAt(isNCHW ? 2 : 1), output.sizeAt(isNCHW ? 3 : 2),
+                                    input.sizeAt(isNCHW ? 2 : 1), input.sizeAt(isNCHW ? 3 : 2), kH, kW, sH, sW, dH,
+                                    dW);
+
+  const QuantizedEpilogue epilogue(output.dataType(), xScale.e<float>(0), quantizationScales(wScale, oC), bias,
+                                   outScale, outZeroPoint);
+  const auto wZeroPoints = quantizationZeroPoints(wZeroPoint, oC);
+  const int32_t xZp = xZeroPoint.e<int32_t>(0);
+
+  NDArray::preparePrimaryUse({&output}, {&input, &weights});
+
+  // weights as [kH * kW * iC, oC] matrix, formats 0 and 2 are used in place
+  const bool contiguous = weights.ordering() == 'c' && weights.ews() == 1;
+  const NDArray* w = contiguous && wFormat != 1
+                         ? &weights
+                         : new NDArray(weights.permute(wFormat == 0   ? std::vector<sd::LongType>({0, 1, 2, 3})
+                                                       : wFormat == 1 ? std::vector<sd::LongType>({2, 3, 1, 0})
+                                                                      : std::vector<sd::LongType>({1, 2, 3, 0}))
+                                           .dup('c'));
+  const LongType wRowStride = w == &weights && wFormat == 2 ? 1 : oC;
+  const LongType wColStride = w == &weights && wFormat == 2 ? K : 1;
+
+  const NDArray* x = input.ordering() == 'c' && input.ews() == 1 ? &input : new NDArray(input.dup('c'));
+  NDArray* z = output.ordering() == 'c' && output.ews() == 1
+                   ? &output
+                   : new NDArray('c', output.getShapeAsVector(), output.dataType(), output.getContext());
+
+  SD_QUANTIZED_SELECTOR(input.dataType(), output.dataType(), quantizedConv2d_,
+                        (*x, w->bufferAsT<int8_t>(), wRowStride, wColStride, xZp, wZeroPoints, epilogue, *z, kH, kW,
+                         sH, sW, pH, pW, dH, dW, isNCHW));
+
+  if (z != &output) {
+    output.assign(*z);
+    delete z;
+  }
+  if (x != &input) delete x;
+  if (w != &weights) delete w;
+
+  NDArray::registerPrimaryUse({&output}, {&input, &weights});
+}
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
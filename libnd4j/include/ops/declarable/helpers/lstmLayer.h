@@ -52,6 +52,14 @@ SD_LIB_HIDDEN void lstmLayerTimeLoop(const NDArray* x, const NDArray* Wx, const
                                      const std::vector<float>& params, const bool forward, NDArray* h, NDArray* hL,
                                      NDArray* cL);
 
+//////////////////////////////////////////////////////////////////////////
+// cpu only: same as lstmLayerTimeLoop, but with input projection of all time steps precomputed by single gemm and
+// allocation-free time loop, returns false (and does nothing) if given arrays are not supported
+SD_LIB_HIDDEN bool lstmLayerTimeLoopFused(const NDArray* x, const NDArray* Wx, const NDArray* Wr, const NDArray* b,
+                                          const NDArray* seqLen, const NDArray* hI, const NDArray* cI,
+                                          const NDArray* Wp, const std::vector<float>& params, const bool forward,
+                                          NDArray* h, NDArray* hL, NDArray* cL);
+
 //////////////////////////////////////////////////////////////////////////
 SD_LIB_HIDDEN void lstmLayerTimeLoopBp(const NDArray* x, const NDArray* Wx, const NDArray* Wr, const NDArray* b,
                                        const NDArray* seqLen, NDArray* hI, NDArray* cI, const NDArray* Wp,
@@ -0,0 +1,71 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Affine (scale, zero point) int8 quantization and integer matmul/conv2d built on the int8 gemm
+//
+
+#ifndef LIBND4J_QUANTIZATION_HELPERS_H
+#define LIBND4J_QUANTIZATION_HELPERS_H
+#include <ops/declarable/helpers/helpers.h>
+
+namespace sd {
+namespace ops {
+namespace helpers {
+
+/**
+ * q = saturate(round(x / scale) + zeroPoint), rounding half to even. scale and zeroPoint are scalars (per-tensor) or
+ * vectors holding one value per slice along axis (per-channel).
+ */
+SD_LIB_HIDDEN void quantizeLinear(const NDArray& input, const NDArray& scale, const NDArray& zeroPoint, const int axis,
+                                  NDArray& output);
+
+/**
+ * x = (q - zeroPoint) * scale, with the same per-tensor/per-channel rules as quantizeLinear
+ */
+SD_LIB_HIDDEN void dequantizeLinear(const NDArray& input, const NDArray& scale, const NDArray& zeroPoint,
+                                    const int axis, NDArray& output);
+
+/**
+ * Integer x [M, K] (int8 or uint8) times int8 w [K, N]. wScale/wZeroPoint are scalars or hold one value per output
+ * column. Output type selects the epilogue:
+ *   floating point - (x - xZeroPoint)(w - wZeroPoint) * xScale * wScale + bias
+ *   int8/uint8     - the value above requantized with outScale/outZeroPoint
+ *   int32          - raw accumulators, bias is not applied
+ */
+SD_LIB_HIDDEN void quantizedMatmul(const NDArray& x, const NDArray& w, const NDArray& xScale,
+                                   const NDArray& xZeroPoint, const NDArray& wScale, const NDArray& wZeroPoint,
+                                   const NDArray* bias, const double outScale, const int outZeroPoint,
+                                   NDArray& output);
+
+/**
+ * conv2d over quantized input and int8 weights, with the matmul epilogues above. Padded positions hold xZeroPoint,
+ * i.e. real zero. wScale/wZeroPoint are scalars or hold one value per output channel.
+ */
+SD_LIB_HIDDEN void quantizedConv2d(const NDArray& input, const NDArray& weights, const NDArray& xScale,
+                                   const NDArray& xZeroPoint, const NDArray& wScale, const NDArray& wZeroPoint,
+                                   const NDArray* bias, NDArray& output, const LongType kH, const LongType kW,
+                                   const LongType sH, const LongType sW, LongType pH, LongType pW, const LongType dH,
+                                   const LongType dW, const int isSameMode, const int isNCHW, const int wFormat,
+                                   const double outScale, const int outZeroPoint);
+
+}  // namespace helpers
+}  // namespace ops
+}  // namespace sd
+
+#endif  // LIBND4J_QUANTIZATION_HELPERS_H
@@ -35,7 +35,8 @@ namespace helpers {
 SD_LIB_HIDDEN void skipgram(NDArray &syn0, NDArray &syn1, NDArray &syn1Neg, NDArray &expTable, NDArray &negTable,
                             NDArray &target, NDArray &ngStarter, int nsRounds, NDArray &indices, NDArray &codes,
                             NDArray &alpha, NDArray &randomValue, NDArray &inferenceVector, const bool preciseMode,
-                            const int numWorkers,const int iterations,double minLearningRate);
+                            const int numWorkers,const int iterations,double minLearningRate,
+                            const bool sharedNegatives = false);
 
 
 SD_LIB_HIDDEN void  skipgramInference(NDArray &syn0, NDArray &syn1, NDArray &syn1Neg, NDArray &expTable, NDArray &negTable, int target,
@@ -23,12 +23,15 @@
 #include <exceptions/datatype_exception.h>
 #include <exceptions/graph_exception.h>
 #include <graph/exceptions/unresolved_input_exception.h>
+#include <helpers/ExecutionTracer.h>
 #include <helpers/ShapeUtils.h>
 #include <helpers/StringUtils.h>
+#include <memory/ScratchArena.h>
 #include <ops/declarable/DeclarableOp.h>
 #include <ops/declarable/OpRegistrator.h>
 
 #include <cstdarg>
+#include <memory>
 #if defined(HAVE_VEDA)
 #include <ops/declarable/platform/vednn/veda_helper.h>
 #endif
@@ -667,6 +670,9 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
 
   sd::LongType memoryBefore =
       block->workspace() == nullptr ? 0L : block->workspace()->getSpilledSize() + block->workspace()->getUsedSize();
+  const bool tracing = ExecutionTracer::isEnabled();
+  const uint64_t traceStart = tracing ? ExecutionTracer::ticks() : 0;
+  const sd::LongType traceAllocated = tracing ? ExecutionTracer::allocatedBytes() : 0;
   if (Environment::getInstance().isProfiling()) timeEnter = std::chrono::system_clock::now();
   // basic validation: ensure inputs are set
   REQUIRE_OK(this->validateNonEmptyInput(*block));
@@ -688,6 +694,9 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
   sd::Status status;
   bool hasHelper = false;
 
+  // temporaries created by the op itself go to this thread's scratch arena, which is rewound once we're done
+  std::unique_ptr<memory::ScratchArena::Scope> scratchScope(new memory::ScratchArena::Scope());
+
   // platform helpers use might be forbidden for various reasons, so we'll check it out first
   if (block->helpersAllowed() && sd::Environment::getInstance().helpersAllowed()) {
     // if we have platform-specific helper for this op - invoke it
@@ -778,6 +787,8 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
 
   if (!hasHelper) status = this->validateAndExecute(*block);
 #endif
+  scratchScope.reset();
+
   // optionally saving execution time
   if (Environment::getInstance().isProfiling()) {
     timeEnd = std::chrono::system_clock::now();
@@ -857,13 +868,37 @@ sd::Status sd::ops::DeclarableOp::execute(Context *block) {
     }
   }
 
+  if (tracing) traceExecution(*block, traceStart, traceAllocated);
+
   traceExecIfNeeded(*block);
 
 
   return status;
 }
 
+void DeclarableOp::traceExecution(Context &block, uint64_t start, sd::LongType allocatedBefore) {
+  const auto end = ExecutionTracer::ticks();
+  auto &tracer = ExecutionTracer::getInstance();
+  if (!tracer.shouldRecord(end - start)) return;
+
+  // shapes are hashed only for executions that actually get recorded
+  uint64_t shapeHash = 14695981039346656037ULL;
+  for (int e = 0; e < block.width(); e++) {
+    auto array = block.isFastPath() ? (e < block.fastpath_in().size() ? block.fastpath_in()[e] : nullptr)
+                                    : block.variable(e)->getNDArray();
+    if (array != nullptr) shapeHash = ExecutionTracer::hashShape(shapeHash, array->shapeInfo());
+  }
+
+  const auto nameHash = static_cast<uint64_t>(getOpHash());
+  tracer.registerName(nameHash, *getOpName());
+  tracer.record(nameHash, shapeHash, start, end, ExecutionTracer::allocatedBytes() - allocatedBefore,
+                ExecutionTracer::OP);
+}
+
 void DeclarableOp::overwriteResult(Context &block, int outputIdx, NDArray *array, bool remove) {
+  // results outlive the op, so they must not pin this thread's scratch arena
+  if (array != nullptr && array->dataBuffer() != nullptr) array->dataBuffer()->detachFromArena();
+
   if (block.isFastPath()) {
     if (remove && block.fastpath_out()[outputIdx] != nullptr) {
       // delete reference/call destructor if remove is true
@@ -900,6 +935,8 @@ void DeclarableOp::overwriteResult(Context &block, int outputIdx, NDArray *array
 }
 
 void DeclarableOp::overwriteResult(Context &block, int outputIdx, NDArray *array) {
+  if (array != nullptr && array->dataBuffer() != nullptr) array->dataBuffer()->detachFromArena();
+
   block.pushNDArrayToVariableSpace(block.nodeId(), outputIdx, array);
   auto varSpace = block.getVariableSpace();
   if (varSpace->hasVariable(block.getNodeId(), outputIdx)) {
@@ -0,0 +1,339 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Single-pass execution of fused elementwise chains
+//
+#include <array/NDArrayFactory.h>
+#include <execution/Threads.h>
+#include <helpers/ConstantShapeHelper.h>
+#include <ops/declarable/FusedElementwiseOp.h>
+
+#ifndef __CUDABLAS__
+#include <loops/pairwise_transform.h>
+#include <loops/scalar.h>
+#include <loops/transform_float.h>
+#include <loops/transform_same.h>
+#include <loops/transform_strict.h>
+#endif
+
+#include <algorithm>
+
+namespace sd {
+namespace ops {
+
+// elements per tile: operands of one tile should stay in L1/L2 between stages
+static const sd::LongType kFusedTile = 4096;
+
+FusedElementwiseOp::FusedElementwiseOp(const std::vector<FusedStage> &stages, int numInputs)
+    : LegacyOp::LegacyOp(numInputs), _stages(stages) {
+  //
+}
+
+LegacyOp *FusedElementwiseOp::clone() { return new FusedElementwiseOp(_stages, _numInputs); }
+
+bool FusedElementwiseOp::isFusable(sd::graph::OpType opType) {
+  return opType == sd::graph::OpType_TRANSFORM_SAME || opType == sd::graph::OpType_TRANSFORM_FLOAT ||
+         opType == sd::graph::OpType_TRANSFORM_STRICT || opType == sd::graph::OpType_SCALAR ||
+         opType == sd::graph::OpType_PAIRWISE || opType == sd::graph::OpType_BROADCAST;
+}
+
+/**
+ * All fused stages preserve shape and data type of their first operand, so does the whole chain
+ */
+ShapeList *FusedElementwiseOp::calculateOutputShape(ShapeList *inputShape, sd::graph::Context &block) {
+  auto inShape = inputShape->at(0);
+
+  sd::LongType *newShape;
+  COPY_SHAPE(inShape, newShape);
+
+  return SHAPELIST(CONSTANT(newShape));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void applyStage(const FusedStage &stage, NDArray &input, const NDArray *operand, NDArray &z) {
+  ExtraArguments extras(stage.tArgs);
+
+  switch (stage.opType) {
+    case sd::graph::OpType_TRANSFORM_SAME:
+      input.applyTransform(static_cast<sd::transform::SameOps>(stage.opNum), z, &extras);
+      break;
+    case sd::graph::OpType_TRANSFORM_FLOAT:
+      input.applyTransform(static_cast<sd::transform::FloatOps>(stage.opNum), z, &extras);
+      break;
+    case sd::graph::OpType_TRANSFORM_STRICT:
+      input.applyTransform(static_cast<sd::transform::StrictOps>(stage.opNum), z, &extras);
+      break;
+    case sd::graph::OpType_SCALAR: {
+      if (operand != nullptr) {
+        input.applyScalarArr(static_cast<sd::scalar::Ops>(stage.opNum), *operand, z, &extras);
+      } else {
+        auto scalar = NDArrayFactory::create(input.dataType(), stage.scalar, input.getContext());
+        input.applyScalarArr(static_cast<sd::scalar::Ops>(stage.opNum), scalar, z, &extras);
+      }
+    } break;
+    case sd::graph::OpType_PAIRWISE:
+      input.applyPairwiseTransform(static_cast<sd::pairwise::Ops>(stage.opNum), *operand, z, &extras);
+      break;
+    case sd::graph::OpType_BROADCAST: {
+      std::vector<sd::LongType> dims(stage.dimensions);
+      std::sort(dims.begin(), dims.end());
+      input.applyBroadcast(static_cast<sd::broadcast::Ops>(stage.opNum), &dims, *operand, z, &extras);
+    } break;
+    default:
+      THROW_EXCEPTION("FusedElementwiseOp: unsupported stage type");
+  }
+}
+
+#ifndef __CUDABLAS__
+//////////////////////////////////////////////////////////////////////////
+// broadcast and pairwise enums number the same functors differently, tiles run broadcasts through pairwise kernels.
+// Returns -1 for broadcast ops without pairwise counterpart
+static int broadcastAsPairwise(const int opNum) {
+  switch (opNum) {
+    case sd::broadcast::Add:
+      return sd::pairwise::Add;
+    case sd::broadcast::Subtract:
+      return sd::pairwise::Subtract;
+    case sd::broadcast::Multiply:
+      return sd::pairwise::Multiply;
+    case sd::broadcast::Divide:
+      return sd::pairwise::Divide;
+    case sd::broadcast::ReverseDivide:
+      return sd::pairwise::ReverseDivide;
+    case sd::broadcast::ReverseSubtract:
+      return sd::pairwise::ReverseSubtract;
+    case sd::broadcast::CopyPws:
+      return sd::pairwise::CopyPws;
+    case sd::broadcast::Pow:
+      return sd::pairwise::Pow;
+    case sd::broadcast::MinPairwise:
+      return sd::pairwise::MinPairwise;
+    case sd::broadcast::MaxPairwise:
+      return sd::pairwise::MaxPairwise;
+    case sd::broadcast::AMinPairwise:
+      return sd::pairwise::AMinPairwise;
+    case sd::broadcast::AMaxPairwise:
+      return sd::pairwise::AMaxPairwise;
+    case sd::broadcast::SquaredSubtract:
+      return sd::pairwise::SquaredSubtract;
+    case sd::broadcast::FloorMod:
+      return sd::pairwise::FloorMod;
+    case sd::broadcast::FloorDiv:
+      return sd::pairwise::FloorDiv;
+    case sd::broadcast::ReverseMod:
+      return sd::pairwise::ReverseMod;
+    case sd::broadcast::SafeDivide:
+      return sd::pairwise::SafeDivide;
+    case sd::broadcast::Mod:
+      return sd::pairwise::Mod;
+    case sd::broadcast::TruncateDiv:
+      return sd::pairwise::TruncateDiv;
+    case sd::broadcast::Atan2:
+      return sd::pairwise::Atan2;
+    case sd::broadcast::DivideNoNan:
+      return sd::pairwise::DivideNoNan;
+    case sd::broadcast::PowDerivative:
+      return sd::pairwise::PowDerivative;
+    default:
+      return -1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// tiles are contiguous, so every stage sees its operands as plain vectors. Broadcast is supported along the last
+// axis only: tiles then start on a row boundary and the operand is replicated once to the tile length
+static bool canRunTiled(const std::vector<FusedStage> &stages, const std::vector<const NDArray *> &operands,
+                        const NDArray &x, const NDArray &z) {
+  if (!x.isR() || x.isEmpty() || x.dataType() != z.dataType() || !x.isSameShape(z)) return false;
+
+  if (x.ews() != 1 || z.ews() != 1 || x.ordering() != z.ordering()) return false;
+
+  for (size_t k = 0; k < stages.size(); k++) {
+    auto y = operands[k];
+
+    switch (stages[k].opType) {
+      case sd::graph::OpType_SCALAR:
+        if (y != nullptr && y->lengthOf() != 1) return false;
+        break;
+      case sd::graph::OpType_PAIRWISE:
+        if (y->dataType() != x.dataType() || y->ews() != 1 || y->ordering() != x.ordering() || !y->isSameShape(x))
+          return false;
+        break;
+      case sd::graph::OpType_BROADCAST: {
+        if (y->dataType() != x.dataType() || y->ews() != 1 || x.ordering() != 'c' || x.rankOf() < 1) return false;
+
+        if (broadcastAsPairwise(stages[k].opNum) < 0) return false;
+        if (stages[k].dimensions.size() != 1 || y->lengthOf() != x.sizeAt(-1)) return false;
+
+        auto axis = stages[k].dimensions[0];
+        if (axis < 0) axis += x.rankOf();
+        if (axis != x.rankOf() - 1) return false;
+      } break;
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename X>
+static void fusedTiles_(const std::vector<FusedStage> &stages, const std::vector<const NDArray *> &operands,
+                        const NDArray &x, NDArray &z) {
+  const auto length = x.lengthOf();
+  const auto numStages = stages.size();
+
+  sd::LongType tile = kFusedTile;
+  for (const auto &stage : stages)
+    if (stage.opType == sd::graph::OpType_BROADCAST) {
+      const auto rowLength = x.sizeAt(-1);
+      tile = sd::math::sd_max<sd::LongType>(1, kFusedTile / rowLength) * rowLength;
+      break;
+    }
+  tile = sd::math::sd_min<sd::LongType>(tile, length);
+
+  std::vector<std::vector<X>> extras(numStages);
+  std::vector<std::vector<X>> replicated(numStages);
+  std::vector<X> scalars(numStages);
+  std::vector<const X *> operandBuffers(numStages, nullptr);
+
+  for (size_t k = 0; k < numStages; k++) {
+    for (auto v : stages[k].tArgs) extras[k].emplace_back(static_cast<X>(v));
+
+    auto y = operands[k];
+    switch (stages[k].opType) {
+      case sd::graph::OpType_SCALAR:
+        scalars[k] = y != nullptr ? y->e<X>(0) : static_cast<X>(stages[k].scalar);
+        break;
+      case sd::graph::OpType_PAIRWISE:
+        operandBuffers[k] = y->bufferAsT<X>();
+        break;
+      case sd::graph::OpType_BROADCAST: {
+        const auto yBuffer = y->bufferAsT<X>();
+        const auto rowLength = y->lengthOf();
+        replicated[k].resize(tile);
+        for (sd::LongType i = 0; i < tile; i++) replicated[k][i] = yBuffer[i % rowLength];
+        operandBuffers[k] = replicated[k].data();
+      } break;
+      default:
+        break;
+    }
+  }
+
+  const auto dataType = x.dataType();
+  const auto tileShapeInfo = ConstantShapeHelper::getInstance().vectorShapeInfo(tile, dataType);
+  const auto tailShapeInfo =
+      length % tile == 0 ? tileShapeInfo : ConstantShapeHelper::getInstance().vectorShapeInfo(length % tile, dataType);
+
+  const auto xBuffer = x.bufferAsT<X>();
+  auto zBuffer = z.bufferAsT<X>();
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++) {
+      const auto offset = t * tile;
+      const auto n = sd::math::sd_min<sd::LongType>(tile, length - offset);
+      const auto vectorShapeInfo = n == tile ? tileShapeInfo : tailShapeInfo;
+
+      const X *in = xBuffer + offset;
+      X *out = zBuffer + offset;
+
+      for (size_t k = 0; k < numStages; k++) {
+        const auto opNum = stages[k].opNum;
+        auto extraParams = extras[k].empty() ? nullptr : const_cast<X *>(extras[k].data());
+
+        switch (stages[k].opType) {
+          case sd::graph::OpType_TRANSFORM_SAME:
+            functions::transform::TransformSame<X>::exec(opNum, in, vectorShapeInfo, out, vectorShapeInfo, extraParams,
+                                                         0, 1);
+            break;
+          case sd::graph::OpType_TRANSFORM_FLOAT:
+            functions::transform::TransformFloat<X, X>::exec(opNum, in, vectorShapeInfo, out, vectorShapeInfo,
+                                                             extraParams, 0, 1);
+            break;
+          case sd::graph::OpType_TRANSFORM_STRICT:
+            functions::transform::TransformStrict<X>::exec(opNum, in, vectorShapeInfo, out, vectorShapeInfo,
+                                                           extraParams, 0, 1);
+            break;
+          case sd::graph::OpType_SCALAR:
+            functions::scalar::ScalarTransform<X, X, X>::transform(opNum, in, 1, out, 1, &scalars[k], extraParams, n,
+                                                                   0, n);
+            break;
+          case sd::graph::OpType_PAIRWISE:
+            functions::pairwise_transforms::PairWiseTransform<X, X, X>::exec(
+                opNum, in, 1, operandBuffers[k] + offset, 1, out, 1, extraParams, n, 0, n);
+            break;
+          case sd::graph::OpType_BROADCAST:
+            functions::pairwise_transforms::PairWiseTransform<X, X, X>::exec(
+                broadcastAsPairwise(opNum), in, 1, operandBuffers[k], 1, out, 1, extraParams, n, 0, n);
+            break;
+          default:
+            break;
+        }
+
+        in = out;
+      }
+    }
+  };
+
+  samediff::Threads::parallel_for(func, 0, (length + tile - 1) / tile);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+sd::Status FusedElementwiseOp::validateAndExecute(Context &block) {
+  auto x = INPUT_VARIABLE(0);
+  auto z = OUTPUT_VARIABLE(0);
+
+  std::vector<const NDArray *> operands(_stages.size(), nullptr);
+  std::vector<const NDArray *> inputs({x});
+  for (size_t k = 0; k < _stages.size(); k++) {
+    if (_stages[k].operand < 0) continue;
+
+    operands[k] = INPUT_VARIABLE(_stages[k].operand);
+    inputs.emplace_back(operands[k]);
+  }
+
+#ifndef __CUDABLAS__
+  if (canRunTiled(_stages, operands, *x, *z)) {
+    NDArray::preparePrimaryUse({z}, inputs);
+    BUILD_SINGLE_SELECTOR(x->dataType(), fusedTiles_, (_stages, operands, *x, *z), SD_FLOAT_TYPES);
+    NDArray::registerPrimaryUse({z}, inputs);
+
+    STORE_RESULT(*z);
+    traceExecIfNeeded(block);
+
+    return sd::Status::OK;
+  }
+#endif
+
+  // generic path: stage by stage, intermediate results live in the output array
+  NDArray *input = x;
+  for (size_t k = 0; k < _stages.size(); k++) {
+    applyStage(_stages[k], *input, operands[k], *z);
+    input = z;
+  }
+
+  STORE_RESULT(*z);
+  traceExecIfNeeded(block);
+
+  return sd::Status::OK;
+}
+}  // namespace ops
+}  // namespace sd
@@ -46,6 +46,19 @@ class GEMM {
                  int ldb, double beta, void *C, int ldc);
 };
 
+/**
+ * Cache-blocked gemm over packed panels, see ops/impl/gemm_packed.hpp.
+ * Used for data types that have no BLAS gemm. Matrices are described by
+ * (row stride, column stride) pairs, so any 2D view can be passed directly.
+ */
+template <typename X, typename Y, typename Z>
+class PackedGEMM {
+ public:
+  static void op(sd::LongType M, sd::LongType N, sd::LongType K, double alpha, const X *A, sd::LongType aRowStride,
+                 sd::LongType aColStride, const Y *B, sd::LongType bRowStride, sd::LongType bColStride, double beta,
+                 Z *C, sd::LongType cRowStride, sd::LongType cColStride);
+};
+
 template <typename X, typename Y, typename Z>
 class GEMV : public sd::blas::GEMM<X, Y, Z> {
  public:
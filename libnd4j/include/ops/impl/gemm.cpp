@@ -22,6 +22,7 @@
 //
 #include <execution/Threads.h>
 #include <ops/gemm.h>
+#include <ops/impl/gemm_packed.hpp>
 #include <system/Environment.h>
 #include <types/types.h>
 
@@ -57,51 +58,20 @@ void GEMM<X, Y, Z>::op(int Order, int TransA, int TransB, int M, int N, int K, d
   auto B = reinterpret_cast<Y *>(vB);
   auto C = reinterpret_cast<Z *>(vC);
 
-  bool transAFlag = TransA == CblasTrans;
-  bool transBFlag = TransB == CblasTrans;
-
-  if (beta == 0.0) {
-    Z z = 0.f;
-    int length = M * N;
-    if (length <= Environment::getInstance().elementwiseThreshold()) {
-      for (int r = 0; r < length; r++) C[r] = z;
-    } else {
-      auto func = PRAGMA_THREADS_FOR {
-        for (auto r = start; r < stop; r++) C[r] = z;
-      };
-      samediff::Threads::parallel_for(func, 0, length);
-    }
-  }
-
-  auto func = PRAGMA_THREADS_FOR_2D {
-    for (auto r = start_x; r < stop_x; r += inc_x) {
-      for (auto c = start_y; c < stop_y; c += inc_y) {
-        int zIdx = linearIndexF(M, N, r, c);
-
-        Z dot = static_cast<Z>(0.0f);
-
-        if (alpha != 0.0) {
-          int bIdx;  // = linearIndexF(K, N, 0, c);
-          int aIdx;
-
-          for (int k = 0; k < K; k++) {
-            aIdx = (transAFlag ? linearIndexC(M, K, r, k) : linearIndexF(M, K, r, k));
-            bIdx = (transBFlag ? linearIndexC(K, N, k, c) : linearIndexF(K, N, k, c));
-            dot += static_cast<Z>(alpha) * static_cast<Z>(A[aIdx]) *
-                   static_cast<Z>(B[bIdx]);  // A[aIdx]sd::math::sd_dot<T>(aX, bX, K) * alpha;
-          }
-        }
-
-        if (beta != 0.0) {
-          C[zIdx] = static_cast<Z>(dot + static_cast<Z>(beta) * C[zIdx]);
-        } else {
-          C[zIdx] = static_cast<Z>(dot);
-        }
-      }
-    }
-  };
+  const bool rowMajor = Order == CblasRowMajor;
+  const bool transAFlag = TransA == CblasTrans;
+  const bool transBFlag = TransB == CblasTrans;
+
+  // express every matrix as (row stride, column stride) pair, leading dimension goes to the non-contiguous axis
+  const sd::LongType aRowStride = transAFlag != rowMajor ? lda : 1;
+  const sd::LongType aColStride = transAFlag != rowMajor ? 1 : lda;
+  const sd::LongType bRowStride = transBFlag != rowMajor ? ldb : 1;
+  const sd::LongType bColStride = transBFlag != rowMajor ? 1 : ldb;
+  const sd::LongType cRowStride = rowMajor ? ldc : 1;
+  const sd::LongType cColStride = rowMajor ? 1 : ldc;
 
-  samediff::Threads::parallel_for(func, 0, M, 1, 0, N, 1);
+  PackedGEMM<X, Y, Z>::op(M, N, K, alpha, A, aRowStride, aColStride, B, bRowStride, bColStride, beta, C, cRowStride,
+                          cColStride);
 }
 
 template <typename X, typename Y, typename Z>
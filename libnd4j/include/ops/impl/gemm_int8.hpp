@@ -0,0 +1,359 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// 8-bit gemm with int32 accumulation, used by quantized matmul/conv.
+//
+// Both operands are packed in groups of 4 consecutive k values: an A sliver holds MR rows as [k/4][MR][4] bytes, a B
+// sliver holds NR columns as [k/4][NR][4] bytes. This is the operand layout of the 4-way byte dot-product
+// instructions (x86 VNNI vpdpbusd, ARM sdot), so when the target has one of them an MR x NR register tile takes one
+// instruction per row and k group. Other targets store B groups as [k/4][4][NR] and use a plain loop which compilers
+// vectorize.
+//
+// x86 VNNI multiplies unsigned A bytes by signed B bytes, so A is stored with an offset there. Offsets and zero
+// points are all folded into a per-row / per-column correction, applied before the tile is handed to the epilogue.
+//
+#ifndef LIBND4J_GEMM_INT8_HPP
+#define LIBND4J_GEMM_INT8_HPP
+
+#include <execution/Threads.h>
+#include <math/templatemath.h>
+#include <system/Environment.h>
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX512VNNI__) && defined(__AVX512F__)
+#include <immintrin.h>
+#define SD_INT8_GEMM_AVX512VNNI 1
+#elif defined(__AVXVNNI__)
+#include <immintrin.h>
+#define SD_INT8_GEMM_AVXVNNI 1
+#elif defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#define SD_INT8_GEMM_DOTPROD 1
+#endif
+
+namespace sd {
+namespace blas {
+
+struct Int8GemmBlocking {
+  // NR int32 lanes make one 512-bit register (or two 256-bit / four 128-bit ones)
+  static constexpr int MR = 4;
+  static constexpr int NR = 16;
+  static constexpr sd::LongType MC = MR * 16;
+  static constexpr sd::LongType NC = NR * 16;
+};
+
+#if defined(SD_INT8_GEMM_AVX512VNNI) || defined(SD_INT8_GEMM_AVXVNNI)
+typedef uint8_t Int8GemmPackedA;
+#else
+typedef int8_t Int8GemmPackedA;
+#endif
+
+// value added to A elements of type X so that they fit Int8GemmPackedA
+template <typename X>
+static constexpr int32_t int8GemmShift() {
+  return std::is_same<Int8GemmPackedA, uint8_t>::value ? (std::is_signed<X>::value ? 128 : 0)
+                                                       : (std::is_signed<X>::value ? 0 : -128);
+}
+
+static SD_INLINE sd::LongType int8GemmDepth(const sd::LongType K) { return (K + 3) & ~static_cast<sd::LongType>(3); }
+
+// position of element (k, j) inside a packed B sliver
+static SD_INLINE sd::LongType int8PackedB(const sd::LongType k, const sd::LongType j) {
+#if defined(SD_INT8_GEMM_AVX512VNNI) || defined(SD_INT8_GEMM_AVXVNNI) || defined(SD_INT8_GEMM_DOTPROD)
+  return (k >> 2) * Int8GemmBlocking::NR * 4 + j * 4 + (k & 3);
+#else
+  // no dot-product instruction: keep every k row contiguous, so the kernel reads B with unit stride
+  return (k >> 2) * Int8GemmBlocking::NR * 4 + (k & 3) * Int8GemmBlocking::NR + j;
+#endif
+}
+
+// packs rows [0, mc) of A into MR-row slivers and stores the sums of the packed (shifted) rows
+template <typename X>
+static void int8PackA(const X *A, const sd::LongType rowStride, const sd::LongType colStride, const sd::LongType mc,
+                      const sd::LongType K, Int8GemmPackedA *packed, int32_t *rowSums) {
+  constexpr int MR = Int8GemmBlocking::MR;
+  constexpr int32_t shift = int8GemmShift<X>();
+  const sd::LongType K4 = int8GemmDepth(K);
+
+  for (sd::LongType s = 0; s < mc; s += MR) {
+    Int8GemmPackedA *dst = packed + s * K4;
+    for (int i = 0; i < MR; i++) {
+      const sd::LongType r = s + i;
+      sd::LongType k = 0;
+      if (r < mc) {
+        const X *src = A + r * rowStride;
+        int32_t sum = 0;
+        for (; k < K; k++) {
+          const int32_t v = static_cast<int32_t>(src[k * colStride]) + shift;
+          dst[(k >> 2) * MR * 4 + i * 4 + (k & 3)] = static_cast<Int8GemmPackedA>(v);
+          sum += v;
+        }
+        rowSums[r] = sum;
+      }
+      for (; k < K4; k++) dst[(k >> 2) * MR * 4 + i * 4 + (k & 3)] = 0;
+    }
+  }
+}
+
+// packs columns [0, cols) of B into one NR-column sliver and stores the column sums
+static void int8PackB(const int8_t *B, const sd::LongType rowStride, const sd::LongType colStride,
+                      const sd::LongType K, const sd::LongType cols, int8_t *packed, int32_t *colSums) {
+  constexpr int NR = Int8GemmBlocking::NR;
+  const sd::LongType K4 = int8GemmDepth(K);
+
+  for (int j = 0; j < NR; j++) {
+    sd::LongType k = 0;
+    int32_t sum = 0;
+    if (j < cols) {
+      const int8_t *src = B + j * colStride;
+      for (; k < K; k++) {
+        const int8_t v = src[k * rowStride];
+        packed[int8PackedB(k, j)] = v;
+        sum += v;
+      }
+    }
+    colSums[j] = sum;
+    for (; k < K4; k++) packed[int8PackedB(k, j)] = 0;
+  }
+}
+
+// c[MR x NR] = A sliver * B sliver over k4 groups of 4
+static SD_INLINE void int8MicroKernel(const sd::LongType k4, const Int8GemmPackedA *a, const int8_t *b, int32_t *c) {
+  constexpr int MR = Int8GemmBlocking::MR;
+  constexpr int NR = Int8GemmBlocking::NR;
+
+#if defined(SD_INT8_GEMM_AVX512VNNI)
+  __m512i acc[MR];
+  for (int i = 0; i < MR; i++) acc[i] = _mm512_setzero_si512();
+
+  for (sd::LongType p = 0; p < k4; p++) {
+    const __m512i bv = _mm512_loadu_si512(b + p * NR * 4);
+    for (int i = 0; i < MR; i++) {
+      int32_t a4;
+      std::memcpy(&a4, a + (p * MR + i) * 4, sizeof(a4));
+      acc[i] = _mm512_dpbusd_epi32(acc[i], _mm512_set1_epi32(a4), bv);
+    }
+  }
+
+  for (int i = 0; i < MR; i++) _mm512_storeu_si512(c + i * NR, acc[i]);
+#elif defined(SD_INT8_GEMM_AVXVNNI)
+  __m256i acc[MR][2];
+  for (int i = 0; i < MR; i++) acc[i][0] = acc[i][1] = _mm256_setzero_si256();
+
+  for (sd::LongType p = 0; p < k4; p++) {
+    const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + p * NR * 4));
+    const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + p * NR * 4 + 32));
+    for (int i = 0; i < MR; i++) {
+      int32_t a4;
+      std::memcpy(&a4, a + (p * MR + i) * 4, sizeof(a4));
+      const __m256i av = _mm256_set1_epi32(a4);
+      acc[i][0] = _mm256_dpbusd_avx_epi32(acc[i][0], av, b0);
+      acc[i][1] = _mm256_dpbusd_avx_epi32(acc[i][1], av, b1);
+    }
+  }
+
+  for (int i = 0; i < MR; i++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + i * NR), acc[i][0]);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + i * NR + 8), acc[i][1]);
+  }
+#elif defined(SD_INT8_GEMM_DOTPROD)
+  int32x4_t acc[MR][4];
+  for (int i = 0; i < MR; i++)
+    for (int q = 0; q < 4; q++) acc[i][q] = vdupq_n_s32(0);
+
+  for (sd::LongType p = 0; p < k4; p++) {
+    int8x16_t bv[4];
+    for (int q = 0; q < 4; q++) bv[q] = vld1q_s8(b + p * NR * 4 + q * 16);
+    for (int i = 0; i < MR; i++) {
+      int32_t a4;
+      std::memcpy(&a4, a + (p * MR + i) * 4, sizeof(a4));
+      const int8x16_t av = vreinterpretq_s8_s32(vdupq_n_s32(a4));
+      for (int q = 0; q < 4; q++) acc[i][q] = vdotq_s32(acc[i][q], bv[q], av);
+    }
+  }
+
+  for (int i = 0; i < MR; i++)
+    for (int q = 0; q < 4; q++) vst1q_s32(c + i * NR + q * 4, acc[i][q]);
+#else
+  int32_t acc[MR][NR];
+  for (int i = 0; i < MR; i++) {
+    PRAGMA_OMP_SIMD
+    for (int j = 0; j < NR; j++) acc[i][j] = 0;
+  }
+
+  for (sd::LongType p = 0; p < k4; p++) {
+    const Int8GemmPackedA *ap = a + p * MR * 4;
+    const int8_t *bp = b + p * NR * 4;
+    for (int i = 0; i < MR; i++) {
+      const int32_t a0 = ap[i * 4], a1 = ap[i * 4 + 1], a2 = ap[i * 4 + 2], a3 = ap[i * 4 + 3];
+      PRAGMA_OMP_SIMD
+      for (int j = 0; j < NR; j++)
+        acc[i][j] += a0 * bp[j] + a1 * bp[NR + j] + a2 * bp[2 * NR + j] + a3 * bp[3 * NR + j];
+    }
+  }
+
+  for (int i = 0; i < MR; i++) {
+    PRAGMA_OMP_SIMD
+    for (int j = 0; j < NR; j++) c[i * NR + j] = acc[i][j];
+  }
+#endif
+}
+
+// B packed into NR-column slivers for int8Gemm, together with its column sums
+struct Int8GemmPackedB {
+  sd::LongType K = 0;
+  sd::LongType N = 0;
+  std::vector<int8_t> data;
+  std::vector<int32_t> colSums;
+};
+
+// packs a K x N int8 matrix B, so that gemms sharing it (e.g. the batch items of a convolution) pack it only once
+static void int8PackMatrixB(const sd::LongType K, const sd::LongType N, const int8_t *B, const sd::LongType bRowStride,
+                            const sd::LongType bColStride, Int8GemmPackedB &packed) {
+  constexpr int NR = Int8GemmBlocking::NR;
+
+  const sd::LongType K4 = int8GemmDepth(K);
+  const sd::LongType nSlivers = (N + NR - 1) / NR;
+
+  packed.K = K;
+  packed.N = N;
+  packed.data.resize(nSlivers * NR * K4);
+  packed.colSums.resize(nSlivers * NR);
+
+  auto packB = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++)
+      int8PackB(B + t * NR * bColStride, bRowStride, bColStride, K, sd::math::sd_min<sd::LongType>(NR, N - t * NR),
+                packed.data.data() + t * NR * K4, packed.colSums.data() + t * NR);
+  };
+  samediff::Threads::parallel_tad(packB, 0, nSlivers);
+}
+
+/**
+ * Same as the int8Gemm below, with B already packed by int8PackMatrixB. A has M rows and B.K columns.
+ */
+template <typename X, typename F>
+static void int8Gemm(const sd::LongType M, const X *A, const sd::LongType aRowStride, const sd::LongType aColStride,
+                     const int32_t aZeroPoint, const Int8GemmPackedB &B, const int32_t *bZeroPoints, F &&epilogue) {
+  static_assert(std::is_same<X, int8_t>::value || std::is_same<X, uint8_t>::value,
+                "int8Gemm: A must hold int8 or uint8 values");
+  constexpr int MR = Int8GemmBlocking::MR;
+  constexpr int NR = Int8GemmBlocking::NR;
+
+  const sd::LongType N = B.N;
+  const sd::LongType K = B.K;
+  if (M <= 0 || N <= 0) return;
+
+  const sd::LongType K4 = int8GemmDepth(K);
+  const int8_t *bPacked = B.data.data();
+  const int32_t *colSums = B.colSums.data();
+
+  // sum (a - za)(b - zb) = sum s * b - d * colSum(b) - zb * (rowSum(s) - K * d), with s = a + shift, d = shift + za
+  const int32_t d = int8GemmShift<X>() + aZeroPoint;
+  const int32_t kd = static_cast<int32_t>(K) * d;
+
+  const sd::LongType numThreads = sd::Environment::getInstance().maxMasterThreads();
+  sd::LongType MC = Int8GemmBlocking::MC, NC = Int8GemmBlocking::NC;
+  auto numTiles = [&]() -> sd::LongType { return ((M + MC - 1) / MC) * ((N + NC - 1) / NC); };
+  while (numTiles() < numThreads && NC > 2 * NR) NC /= 2;
+  while (numTiles() < numThreads && MC > MR) MC /= 2;
+
+  const sd::LongType mTiles = (M + MC - 1) / MC;
+  const sd::LongType nTiles = (N + NC - 1) / NC;
+  const sd::LongType mcMax = ((sd::math::sd_min<sd::LongType>(MC, M) + MR - 1) / MR) * MR;
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Int8GemmPackedA> aPacked(mcMax * K4);
+    std::vector<int32_t> rowSums(mcMax);
+    int32_t tile[MR * NR];
+    sd::LongType packedBlock = -1;
+
+    for (auto t = start; t < stop; t++) {
+      const sd::LongType block = t / nTiles;
+      const sd::LongType i0 = block * MC;
+      const sd::LongType j0 = (t % nTiles) * NC;
+      const sd::LongType mc = sd::math::sd_min<sd::LongType>(MC, M - i0);
+      const sd::LongType nc = sd::math::sd_min<sd::LongType>(NC, N - j0);
+
+      // consecutive tiles of one thread mostly share their row block
+      if (block != packedBlock) {
+        int8PackA<X>(A + i0 * aRowStride, aRowStride, aColStride, mc, K, aPacked.data(), rowSums.data());
+        packedBlock = block;
+      }
+
+      for (sd::LongType jr = 0; jr < nc; jr += NR) {
+        const sd::LongType j = j0 + jr;
+        const sd::LongType cols = sd::math::sd_min<sd::LongType>(NR, N - j);
+        const int32_t *cs = colSums + j;
+
+        for (sd::LongType ir = 0; ir < mc; ir += MR) {
+          int8MicroKernel(K4 / 4, aPacked.data() + ir * K4, bPacked + j * K4, tile);
+
+          const sd::LongType rows = sd::math::sd_min<sd::LongType>(MR, mc - ir);
+          for (sd::LongType i = 0; i < rows; i++) {
+            int32_t *row = tile + i * NR;
+            const int32_t rs = rowSums[ir + i] - kd;
+            if (bZeroPoints != nullptr) {
+              const int32_t *zb = bZeroPoints + j;
+              PRAGMA_OMP_SIMD
+              for (sd::LongType c = 0; c < cols; c++) row[c] -= d * cs[c] + zb[c] * rs;
+            } else {
+              PRAGMA_OMP_SIMD
+              for (sd::LongType c = 0; c < cols; c++) row[c] -= d * cs[c];
+            }
+
+            epilogue(i0 + ir + i, j, cols, static_cast<const int32_t *>(row));
+          }
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, mTiles * nTiles);
+}
+
+/**
+ * Computes acc(r, c) = sum_k (A(r, k) - aZeroPoint) * (B(k, c) - bZeroPoints[c]) for a M x K matrix A of int8 or
+ * uint8 values and a K x N int8 matrix B, both given by (row stride, column stride) pairs. bZeroPoints may be nullptr
+ * for symmetric B.
+ *
+ * Results aren't stored anywhere: for every finished row fragment epilogue(r, c, count, acc) is called with count
+ * consecutive int32 values of row r starting at column c, so scaling, bias and requantization happen while the tile
+ * is still in registers/L1. Epilogue is called concurrently for disjoint fragments.
+ */
+template <typename X, typename F>
+static void int8Gemm(const sd::LongType M, const sd::LongType N, const sd::LongType K, const X *A,
+                     const sd::LongType aRowStride, const sd::LongType aColStride, const int32_t aZeroPoint,
+                     const int8_t *B, const sd::LongType bRowStride, const sd::LongType bColStride,
+                     const int32_t *bZeroPoints, F &&epilogue) {
+  if (M <= 0 || N <= 0) return;
+
+  // B is reused by every row block, so it is packed once up front
+  Int8GemmPackedB packed;
+  int8PackMatrixB(K, N, B, bRowStride, bColStride, packed);
+  int8Gemm<X>(M, A, aRowStride, aColStride, aZeroPoint, packed, bZeroPoints, std::forward<F>(epilogue));
+}
+
+}  // namespace blas
+}  // namespace sd
+
+#endif  // LIBND4J_GEMM_INT8_HPP
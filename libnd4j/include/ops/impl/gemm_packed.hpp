@@ -0,0 +1,241 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Cache-blocked, packed gemm used for data types without a BLAS path.
+//
+// C is split into MC x NC tiles which are distributed over threads. For every tile the K dimension is walked in KC
+// chunks: an MC x KC block of A and a KC x NC block of B are packed (and converted to the accumulator type) into
+// MR-row / NR-column slivers, then an MR x NR register tile is updated per sliver pair. The tile accumulator lives in
+// the accumulator type for the whole K range, so half/bfloat16 inputs are summed in fp32 and only rounded once.
+//
+#ifndef LIBND4J_GEMM_PACKED_HPP
+#define LIBND4J_GEMM_PACKED_HPP
+
+#include <execution/Threads.h>
+#include <ops/gemm.h>
+#include <system/Environment.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace sd {
+namespace blas {
+
+template <typename T>
+struct GemmAccumulator {
+  using type = T;
+};
+
+template <>
+struct GemmAccumulator<float16> {
+  using type = float;
+};
+
+template <>
+struct GemmAccumulator<bfloat16> {
+  using type = float;
+};
+
+template <>
+struct GemmAccumulator<int8_t> {
+  using type = int32_t;
+};
+
+template <>
+struct GemmAccumulator<uint8_t> {
+  using type = int32_t;
+};
+
+template <>
+struct GemmAccumulator<int16_t> {
+  using type = int32_t;
+};
+
+template <>
+struct GemmAccumulator<uint16_t> {
+  using type = int32_t;
+};
+
+template <typename Acc>
+struct PackedGemmBlocking {
+  // register tile: MR rows of A against one cache line worth of B columns
+  static constexpr int MR = 6;
+  static constexpr int NR = sizeof(Acc) >= 8 ? 8 : 16;
+  // KC x NR sliver of B stays in L1, MC x KC block of A and KC x NC block of B stay in L2
+  static constexpr sd::LongType KC = sizeof(Acc) >= 8 ? 128 : 256;
+  static constexpr sd::LongType MC = MR * 16;
+  static constexpr sd::LongType NC = NR * 16;
+};
+
+// packs rows [0, mc) x cols [0, kc) of A into MR-row slivers: sliver s holds element (s * MR + i, k) at k * MR + i
+template <typename X, typename Acc, int MR>
+static void packA(const X *A, const sd::LongType rowStride, const sd::LongType colStride, const sd::LongType mc,
+                  const sd::LongType kc, Acc *packed) {
+  for (sd::LongType s = 0; s < mc; s += MR) {
+    const sd::LongType rows = sd::math::sd_min<sd::LongType>(MR, mc - s);
+    Acc *dst = packed + s * kc;
+    const X *src = A + s * rowStride;
+
+    if (colStride == 1) {
+      for (sd::LongType i = 0; i < rows; i++) {
+        const X *row = src + i * rowStride;
+        for (sd::LongType k = 0; k < kc; k++) dst[k * MR + i] = static_cast<Acc>(row[k]);
+      }
+    } else {
+      for (sd::LongType k = 0; k < kc; k++)
+        for (sd::LongType i = 0; i < rows; i++) dst[k * MR + i] = static_cast<Acc>(src[i * rowStride + k * colStride]);
+    }
+
+    for (sd::LongType i = rows; i < MR; i++)
+      for (sd::LongType k = 0; k < kc; k++) dst[k * MR + i] = static_cast<Acc>(0);
+  }
+}
+
+// packs rows [0, kc) x cols [0, nc) of B into NR-column slivers: sliver t holds element (k, t * NR + j) at k * NR + j
+template <typename Y, typename Acc, int NR>
+static void packB(const Y *B, const sd::LongType rowStride, const sd::LongType colStride, const sd::LongType kc,
+                  const sd::LongType nc, Acc *packed) {
+  for (sd::LongType t = 0; t < nc; t += NR) {
+    const sd::LongType cols = sd::math::sd_min<sd::LongType>(NR, nc - t);
+    Acc *dst = packed + t * kc;
+    const Y *src = B + t * colStride;
+
+    if (colStride == 1 && cols == NR) {
+      for (sd::LongType k = 0; k < kc; k++) {
+        const Y *row = src + k * rowStride;
+        PRAGMA_OMP_SIMD
+        for (int j = 0; j < NR; j++) dst[k * NR + j] = static_cast<Acc>(row[j]);
+      }
+    } else {
+      for (sd::LongType k = 0; k < kc; k++) {
+        for (sd::LongType j = 0; j < cols; j++) dst[k * NR + j] = static_cast<Acc>(src[k * rowStride + j * colStride]);
+        for (sd::LongType j = cols; j < NR; j++) dst[k * NR + j] = static_cast<Acc>(0);
+      }
+    }
+  }
+}
+
+// C[MR x NR] += A sliver * B sliver, C is row-major with leading dimension ldc
+template <typename Acc, int MR, int NR>
+static SD_INLINE void gemmMicroKernel(const sd::LongType kc, const Acc *a, const Acc *b, Acc *c,
+                                      const sd::LongType ldc) {
+  Acc acc[MR][NR];
+  for (int i = 0; i < MR; i++) {
+    PRAGMA_OMP_SIMD
+    for (int j = 0; j < NR; j++) acc[i][j] = static_cast<Acc>(0);
+  }
+
+  for (sd::LongType k = 0; k < kc; k++) {
+    const Acc *ak = a + k * MR;
+    const Acc *bk = b + k * NR;
+    for (int i = 0; i < MR; i++) {
+      const Acc ai = ak[i];
+      PRAGMA_OMP_SIMD
+      for (int j = 0; j < NR; j++) acc[i][j] += ai * bk[j];
+    }
+  }
+
+  for (int i = 0; i < MR; i++) {
+    PRAGMA_OMP_SIMD
+    for (int j = 0; j < NR; j++) c[i * ldc + j] += acc[i][j];
+  }
+}
+
+/**
+ * C = alpha * A * B + beta * C for arbitrary strided M x K, K x N and M x N matrices.
+ * Element (r, c) of every matrix lives at r * rowStride + c * colStride, so both orders,
+ * transposed views and non-unit strides are handled without materializing copies.
+ */
+template <typename X, typename Y, typename Z>
+void PackedGEMM<X, Y, Z>::op(const sd::LongType M, const sd::LongType N, const sd::LongType K, const double alpha,
+                             const X *A, const sd::LongType aRowStride, const sd::LongType aColStride, const Y *B,
+                             const sd::LongType bRowStride, const sd::LongType bColStride, const double beta, Z *C,
+                             const sd::LongType cRowStride, const sd::LongType cColStride) {
+  using Acc = typename GemmAccumulator<Z>::type;
+  using Blocking = PackedGemmBlocking<Acc>;
+  constexpr int MR = Blocking::MR;
+  constexpr int NR = Blocking::NR;
+
+  if (M <= 0 || N <= 0) return;
+
+  const Acc alphaAcc = static_cast<Acc>(alpha);
+  const Acc betaAcc = static_cast<Acc>(beta);
+  const bool betaPresent = beta != 0.0;
+
+  // shrink tiles for small outputs, so that every thread still gets some work
+  const sd::LongType numThreads = sd::Environment::getInstance().maxMasterThreads();
+  sd::LongType MC = Blocking::MC, NC = Blocking::NC;
+  auto numTiles = [&]() -> sd::LongType { return ((M + MC - 1) / MC) * ((N + NC - 1) / NC); };
+  while (numTiles() < numThreads && NC > 4 * NR) NC /= 2;
+  while (numTiles() < numThreads && MC > 2 * MR) MC = ((MC / 2 + MR - 1) / MR) * MR;
+
+  const sd::LongType mTiles = (M + MC - 1) / MC;
+  const sd::LongType nTiles = (N + NC - 1) / NC;
+
+  // buffers are sized to the actual problem, tiny products don't pay for full blocks
+  const sd::LongType mcMax = ((sd::math::sd_min<sd::LongType>(MC, M) + MR - 1) / MR) * MR;
+  const sd::LongType ncMax = ((sd::math::sd_min<sd::LongType>(NC, N) + NR - 1) / NR) * NR;
+  const sd::LongType kcMax = sd::math::sd_max<sd::LongType>(1, sd::math::sd_min<sd::LongType>(Blocking::KC, K));
+
+  auto func = PRAGMA_THREADS_FOR {
+    std::vector<Acc> aPacked(mcMax * kcMax);
+    std::vector<Acc> bPacked(kcMax * ncMax);
+    std::vector<Acc> cTile(mcMax * ncMax);
+
+    for (auto t = start; t < stop; t++) {
+      const sd::LongType i0 = (t / nTiles) * MC;
+      const sd::LongType j0 = (t % nTiles) * NC;
+      const sd::LongType mc = sd::math::sd_min<sd::LongType>(MC, M - i0);
+      const sd::LongType nc = sd::math::sd_min<sd::LongType>(NC, N - j0);
+
+      std::fill(cTile.begin(), cTile.end(), static_cast<Acc>(0));
+
+      for (sd::LongType p0 = 0; p0 < K; p0 += Blocking::KC) {
+        const sd::LongType kc = sd::math::sd_min<sd::LongType>(Blocking::KC, K - p0);
+
+        packA<X, Acc, MR>(A + i0 * aRowStride + p0 * aColStride, aRowStride, aColStride, mc, kc, aPacked.data());
+        packB<Y, Acc, NR>(B + p0 * bRowStride + j0 * bColStride, bRowStride, bColStride, kc, nc, bPacked.data());
+
+        for (sd::LongType jr = 0; jr < nc; jr += NR)
+          for (sd::LongType ir = 0; ir < mc; ir += MR)
+            gemmMicroKernel<Acc, MR, NR>(kc, aPacked.data() + ir * kc, bPacked.data() + jr * kc,
+                                         cTile.data() + ir * ncMax + jr, ncMax);
+      }
+
+      for (sd::LongType i = 0; i < mc; i++) {
+        Z *cRow = C + (i0 + i) * cRowStride + j0 * cColStride;
+        const Acc *tRow = cTile.data() + i * ncMax;
+        if (betaPresent) {
+          for (sd::LongType j = 0; j < nc; j++)
+            cRow[j * cColStride] =
+                static_cast<Z>(alphaAcc * tRow[j] + betaAcc * static_cast<Acc>(cRow[j * cColStride]));
+        } else {
+          for (sd::LongType j = 0; j < nc; j++) cRow[j * cColStride] = static_cast<Z>(alphaAcc * tRow[j]);
+        }
+      }
+    }
+  };
+
+  samediff::Threads::parallel_tad(func, 0, mTiles * nTiles);
+}
+
+}  // namespace blas
+}  // namespace sd
+
+#endif  // LIBND4J_GEMM_PACKED_HPP
@@ -26,6 +26,7 @@
 #include <helpers/TAD.h>
 #include <helpers/shape.h>
 #include <ops/declarable/CustomOperations.h>
+#include <ops/impl/specials_sort.hpp>
 #include <ops/specials.h>
 #include <types/types.h>
 
@@ -45,180 +46,18 @@ void SpecialTypeConverter::convertGeneric(sd::Pointer *extras, void *dx, sd::Lon
   samediff::Threads::parallel_for(func, 0, N);
 };
 
-template <typename X, typename Y>
-void quickSort_parallel_internal_key(X *key, sd::LongType const *xShapeInfo, Y *values, sd::LongType const *yShapeInfo,
-                                     LongType left, LongType right, LongType cutoff, bool descending) {
-  sd::LongType i = left, j = right;
-  X ktmp;
-  X pivot = key[shape::getIndexOffset((left + right) / 2, xShapeInfo)];
-
-  Y vtmp;
-
-  {
-    /* PARTITION PART */
-    while (i <= j) {
-      if (descending) {
-        while (key[shape::getIndexOffset(i, xShapeInfo)] > pivot) i++;
-        while (key[shape::getIndexOffset(j, xShapeInfo)] < pivot) j--;
-        if (i <= j) {
-          ktmp = key[shape::getIndexOffset(i, xShapeInfo)];
-          key[shape::getIndexOffset(i, xShapeInfo)] = key[shape::getIndexOffset(j, xShapeInfo)];
-          key[shape::getIndexOffset(j, xShapeInfo)] = ktmp;
-
-          vtmp = values[shape::getIndexOffset(i, yShapeInfo)];
-          values[shape::getIndexOffset(i, yShapeInfo)] = values[shape::getIndexOffset(j, yShapeInfo)];
-          values[shape::getIndexOffset(j, yShapeInfo)] = vtmp;
-
-          i++;
-          j--;
-        }
-      } else {
-        while (key[shape::getIndexOffset(i, xShapeInfo)] < pivot) i++;
-        while (key[shape::getIndexOffset(j, xShapeInfo)] > pivot) j--;
-        if (i <= j) {
-          ktmp = key[shape::getIndexOffset(i, xShapeInfo)];
-          key[shape::getIndexOffset(i, xShapeInfo)] = key[shape::getIndexOffset(j, xShapeInfo)];
-          key[shape::getIndexOffset(j, xShapeInfo)] = ktmp;
-
-          vtmp = values[shape::getIndexOffset(i, yShapeInfo)];
-          values[shape::getIndexOffset(i, yShapeInfo)] = values[shape::getIndexOffset(j, yShapeInfo)];
-          values[shape::getIndexOffset(j, yShapeInfo)] = vtmp;
-
-          i++;
-          j--;
-        }
-      }
-    }
-  }
-
-  //
-
-  if (((right - left) < cutoff)) {
-    if (left < j) {
-      quickSort_parallel_internal_key(key, xShapeInfo, values, yShapeInfo, left, j, cutoff, descending);
-    }
-    if (i < right) {
-      quickSort_parallel_internal_key(key, xShapeInfo, values, yShapeInfo, i, right, cutoff, descending);
-    }
-
-  } else {
-    PRAGMA_OMP_TASK {
-      quickSort_parallel_internal_key(key, xShapeInfo, values, yShapeInfo, left, j, cutoff, descending);
-    }
-    PRAGMA_OMP_TASK {
-      quickSort_parallel_internal_key(key, xShapeInfo, values, yShapeInfo, i, right, cutoff, descending);
-    }
-  }
-}
-
-template <typename X, typename Y>
-void quickSort_parallel_internal_value(X *key, sd::LongType const *xShapeInfo, Y *value, sd::LongType const *yShapeInfo,
-                                       LongType left, LongType right, LongType cutoff, bool descending) {
-  sd::LongType i = left, j = right;
-  X ktmp;
-  Y pivot = value[shape::getIndexOffset((left + right) / 2, yShapeInfo)];
-
-  Y vtmp;
-
-  {
-    /* PARTITION PART */
-    while (i <= j) {
-      if (descending) {
-        while (value[shape::getIndexOffset(i, yShapeInfo)] > pivot) i++;
-        while (value[shape::getIndexOffset(j, yShapeInfo)] < pivot) j--;
-        if (i <= j) {
-          ktmp = key[shape::getIndexOffset(i, xShapeInfo)];
-          key[shape::getIndexOffset(i, xShapeInfo)] = key[shape::getIndexOffset(j, xShapeInfo)];
-          key[shape::getIndexOffset(j, xShapeInfo)] = ktmp;
-
-          vtmp = value[shape::getIndexOffset(i, yShapeInfo)];
-          value[shape::getIndexOffset(i, yShapeInfo)] = value[shape::getIndexOffset(j, yShapeInfo)];
-          value[shape::getIndexOffset(j, yShapeInfo)] = vtmp;
-
-          i++;
-          j--;
-        }
-      } else {
-        while (value[shape::getIndexOffset(i, yShapeInfo)] < pivot) i++;
-        while (value[shape::getIndexOffset(j, yShapeInfo)] > pivot) j--;
-        if (i <= j) {
-          ktmp = key[shape::getIndexOffset(i, xShapeInfo)];
-          key[shape::getIndexOffset(i, xShapeInfo)] = key[shape::getIndexOffset(j, xShapeInfo)];
-          key[shape::getIndexOffset(j, xShapeInfo)] = ktmp;
-
-          vtmp = value[shape::getIndexOffset(i, yShapeInfo)];
-          value[shape::getIndexOffset(i, yShapeInfo)] = value[shape::getIndexOffset(j, yShapeInfo)];
-          value[shape::getIndexOffset(j, yShapeInfo)] = vtmp;
-
-          i++;
-          j--;
-        }
-      }
-    }
-  }
-
-  //
-
-  if (((right - left) < cutoff)) {
-    if (left < j) {
-      quickSort_parallel_internal_value(key, xShapeInfo, value, yShapeInfo, left, j, cutoff, descending);
-    }
-    if (i < right) {
-      quickSort_parallel_internal_value(key, xShapeInfo, value, yShapeInfo, i, right, cutoff, descending);
-    }
-
-  } else {
-    PRAGMA_OMP_TASK {
-      quickSort_parallel_internal_value(key, xShapeInfo, value, yShapeInfo, left, j, cutoff, descending);
-    }
-    PRAGMA_OMP_TASK {
-      quickSort_parallel_internal_value(key, xShapeInfo, value, yShapeInfo, i, right, cutoff, descending);
-    }
-  }
-}
-
-template <typename X, typename Y>
-static void quickSort_parallel_key(void *varray, sd::LongType const *xShapeInfo, void *yarray,
-                                   sd::LongType const *yShapeInfo, sd::LongType lenArray, int numThreads,
-                                   bool descending) {
-  auto array = reinterpret_cast<X *>(varray);
-  auto values = reinterpret_cast<Y *>(yarray);
-  int cutoff = 1000;
-
-  PRAGMA_OMP_PARALLEL_THREADS(numThreads) {
-    PRAGMA_OMP_SINGLE_ARGS(nowait) {
-      quickSort_parallel_internal_key(array, xShapeInfo, values, yShapeInfo, 0, lenArray - 1, cutoff, descending);
-    }
-  }
-}
-
-template <typename X, typename Y>
-static void quickSort_parallel_value(void *varray, sd::LongType const *xShapeInfo, void *yarray,
-                                     sd::LongType const *yShapeInfo, sd::LongType lenArray, int numThreads,
-                                     bool descending) {
-  auto array = reinterpret_cast<X *>(varray);
-  auto values = reinterpret_cast<Y *>(yarray);
-  int cutoff = 1000;
-
-  PRAGMA_OMP_PARALLEL_THREADS(numThreads) {
-    PRAGMA_OMP_SINGLE_ARGS(nowait) {
-      quickSort_parallel_internal_value(array, xShapeInfo, values, yShapeInfo, 0, lenArray - 1, cutoff, descending);
-    }
-  }
-}
-
 template <typename X, typename Y>
 void DoubleMethods<X, Y>::sortByKey(void *vx, sd::LongType const *xShapeInfo, void *vy, sd::LongType const *yShapeInfo,
                                     bool descending) {
-  quickSort_parallel_key<X, Y>(vx, xShapeInfo, vy, yShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(),
-                               descending);
+  sorting::sortStrided<X, Y>(reinterpret_cast<X *>(vx), xShapeInfo, reinterpret_cast<Y *>(vy), yShapeInfo, descending,
+                             sd::Environment::getInstance().maxMasterThreads());
 }
 
 template <typename X, typename Y>
 void DoubleMethods<X, Y>::sortByValue(void *vx, sd::LongType const *xShapeInfo, void *vy,
                                       sd::LongType const *yShapeInfo, bool descending) {
-  quickSort_parallel_value<X, Y>(vx, xShapeInfo, vy, yShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(),
-                                 descending);
+  sorting::sortStrided<Y, X>(reinterpret_cast<Y *>(vy), yShapeInfo, reinterpret_cast<X *>(vx), xShapeInfo, descending,
+                             sd::Environment::getInstance().maxMasterThreads());
 }
 
 template <typename X, typename Y>
@@ -231,8 +70,6 @@ void DoubleMethods<X, Y>::sortTadByKey(void *vx, sd::LongType const *xShapeInfo,
   auto packX = ConstantTadHelper::getInstance().tadForDimensions(xShapeInfo, dimension, dimensionLength);
   auto packY = ConstantTadHelper::getInstance().tadForDimensions(yShapeInfo, dimension, dimensionLength);
 
-  auto xLength = shape::length(xShapeInfo);
-  auto xTadLength = shape::length(packX->primaryShapeInfo());
   auto numTads = packX->numberOfTads();
 
   auto func = PRAGMA_THREADS_FOR {
@@ -240,8 +77,7 @@ void DoubleMethods<X, Y>::sortTadByKey(void *vx, sd::LongType const *xShapeInfo,
       auto dx = x + packX->primaryOffsets()[r];
       auto dy = y + packY->primaryOffsets()[r];
 
-      quickSort_parallel_key<X, Y>(dx, packX->primaryShapeInfo(), dy, packY->primaryShapeInfo(), xTadLength, 1,
-                                   descending);
+      sorting::sortStrided<X, Y>(dx, packX->primaryShapeInfo(), dy, packY->primaryShapeInfo(), descending, 1);
     }
   };
 
@@ -258,8 +94,6 @@ void DoubleMethods<X, Y>::sortTadByValue(void *vx, sd::LongType const *xShapeInf
   auto packX = ConstantTadHelper::getInstance().tadForDimensions(xShapeInfo, dimension, dimensionLength);
   auto packY = ConstantTadHelper::getInstance().tadForDimensions(yShapeInfo, dimension, dimensionLength);
 
-  auto xLength = shape::length(xShapeInfo);
-  auto xTadLength = shape::length(packX->primaryShapeInfo());
   auto numTads = packX->numberOfTads();
 
   auto func = PRAGMA_THREADS_FOR {
@@ -267,8 +101,7 @@ void DoubleMethods<X, Y>::sortTadByValue(void *vx, sd::LongType const *xShapeInf
       auto dx = x + packX->primaryOffsets()[r];
       auto dy = y + packY->primaryOffsets()[r];
 
-      quickSort_parallel_value<X, Y>(dx, packX->primaryShapeInfo(), dy, packY->primaryShapeInfo(), xTadLength, 1,
-                                     descending);
+      sorting::sortStrided<Y, X>(dy, packY->primaryShapeInfo(), dx, packX->primaryShapeInfo(), descending, 1);
     }
   };
 
@@ -26,6 +26,7 @@
 #include <helpers/TAD.h>
 #include <helpers/shape.h>
 #include <ops/declarable/CustomOperations.h>
+#include <ops/impl/specials_sort.hpp>
 #include <ops/specials.h>
 #include <types/types.h>
 
@@ -373,81 +374,6 @@ void SpecialMethods<T>::averageGeneric(void **vx, void *vz, sd::LongType const *
   }
 }
 
-template <typename T>
-sd::LongType SpecialMethods<T>::getPosition(sd::LongType const *xShapeInfo, sd::LongType index) {
-  LongType xEWS = shape::elementWiseStride(xShapeInfo);
-
-  if (xEWS == 1)
-    return index;
-  else if (xEWS > 1)
-    return index * xEWS;
-  else
-    return shape::getIndexOffset(index, xShapeInfo);
-}
-
-template <typename T>
-void SpecialMethods<T>::quickSort_parallel_internal(T *array, sd::LongType const *xShapeInfo, int left, int right,
-                                                    int cutoff, bool descending) {
-  int i = left, j = right;
-  T tmp;
-  T pivot = array[getPosition(xShapeInfo, (left + right) / 2)];
-
-  {
-    /* PARTITION PART */
-    while (i <= j) {
-      if (descending) {
-        while (array[getPosition(xShapeInfo, i)] > pivot) i++;
-        while (array[getPosition(xShapeInfo, j)] < pivot) j--;
-        if (i <= j) {
-          tmp = array[getPosition(xShapeInfo, i)];
-          array[getPosition(xShapeInfo, i)] = array[getPosition(xShapeInfo, j)];
-          array[getPosition(xShapeInfo, j)] = tmp;
-          i++;
-          j--;
-        }
-      } else {
-        while (array[getPosition(xShapeInfo, i)] < pivot) i++;
-        while (array[getPosition(xShapeInfo, j)] > pivot) j--;
-        if (i <= j) {
-          tmp = array[getPosition(xShapeInfo, i)];
-          array[getPosition(xShapeInfo, i)] = array[getPosition(xShapeInfo, j)];
-          array[getPosition(xShapeInfo, j)] = tmp;
-          i++;
-          j--;
-        }
-      }
-    }
-  }
-
-  //
-
-  if (((right - left) < cutoff)) {
-    if (left < j) {
-      quickSort_parallel_internal(array, xShapeInfo, left, j, cutoff, descending);
-    }
-    if (i < right) {
-      quickSort_parallel_internal(array, xShapeInfo, i, right, cutoff, descending);
-    }
-
-  } else {
-    PRAGMA_OMP_TASK { quickSort_parallel_internal(array, xShapeInfo, left, j, cutoff, descending); }
-    PRAGMA_OMP_TASK { quickSort_parallel_internal(array, xShapeInfo, i, right, cutoff, descending); }
-  }
-}
-
-template <typename T>
-void SpecialMethods<T>::quickSort_parallel(void *varray, sd::LongType const *xShapeInfo, sd::LongType lenArray,
-                                           int numThreads, bool descending) {
-  auto array = reinterpret_cast<T *>(varray);
-  int cutoff = 1000;
-
-  PRAGMA_OMP_PARALLEL_THREADS(numThreads) {
-    PRAGMA_OMP_SINGLE_ARGS(nowait) {
-      quickSort_parallel_internal(array, xShapeInfo, 0, lenArray - 1, cutoff, descending);
-    }
-  }
-}
-
 template <typename T>
 int SpecialMethods<T>::nextPowerOf2(int number) {
   int pos = 0;
@@ -472,7 +398,7 @@ template <typename T>
 void SpecialMethods<T>::sortGeneric(void *vx, sd::LongType const *xShapeInfo, bool descending) {
   auto x = reinterpret_cast<T *>(vx);
 
-  quickSort_parallel(x, xShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(), descending);
+  sorting::sortStrided<T>(x, xShapeInfo, descending, sd::Environment::getInstance().maxMasterThreads());
 }
 
 template <typename T>
@@ -481,16 +407,19 @@ void SpecialMethods<T>::sortTadGeneric(void *vx, sd::LongType const *xShapeInfo,
                                        bool descending) {
   auto x = reinterpret_cast<T *>(vx);
 
-  // quickSort_parallel(x, xShapeInfo, shape::length(xShapeInfo), omp_get_max_threads(), descending);
   sd::LongType xLength = shape::length(xShapeInfo);
   sd::LongType xTadLength = shape::tadLength(xShapeInfo, dimension, dimensionLength);
-  int numTads = xLength / xTadLength;
+  sd::LongType numTads = xLength / xTadLength;
+
+  // few long TADs share threads between them
+  const int threadsPerTad = static_cast<int>(
+      sd::math::sd_max<sd::LongType>(1, sd::Environment::getInstance().maxMasterThreads() / numTads));
 
   auto func = PRAGMA_THREADS_FOR {
     for (auto r = start; r < stop; r++) {
       T *dx = x + tadOffsets[r];
 
-      quickSort_parallel(dx, tadShapeInfo, xTadLength, 1, descending);
+      sorting::sortStrided<T>(dx, tadShapeInfo, descending, threadsPerTad);
     }
   };
   samediff::Threads::parallel_tad(func, 0, numTads);
@@ -0,0 +1,367 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Sorting engine behind sortGeneric/sortTadGeneric, sortByKey/sortByValue and sortCooIndices.
+//
+// Keys are first mapped to unsigned integers of the same width, such that unsigned order matches numeric order of
+// the original type (sign flip for signed integers, IEEE trick for floating point types). NaNs lose their sign bit
+// first, so all of them end up past infinities.
+// Descending order is just a bitwise complement of that. Large arrays are then sorted with LSD radix sort, 8 bits
+// per pass, split over threads with per-thread histograms; passes where every key shares the same digit are skipped.
+// Small arrays are sorted with std::sort (introsort, so no quadratic worst case) over the same mapped keys.
+// Radix sort is stable, payload (values of sortByKey etc) moves together with keys. All indices are 64-bit.
+//
+#ifndef LIBND4J_SPECIALS_SORT_HPP
+#define LIBND4J_SPECIALS_SORT_HPP
+
+#include <execution/Threads.h>
+#include <helpers/shape.h>
+#include <system/Environment.h>
+#include <types/bfloat16.h>
+#include <types/float16.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sd {
+namespace sorting {
+
+// below this length radix passes cost more than comparisons
+static constexpr sd::LongType RADIX_THRESHOLD = 256;
+// minimal amount of elements handled by one thread within radix pass
+static constexpr sd::LongType RADIX_ELEMENTS_PER_THREAD = 32768;
+
+template <int BYTES>
+struct RadixUnsigned;
+
+template <>
+struct RadixUnsigned<1> {
+  using type = uint8_t;
+};
+
+template <>
+struct RadixUnsigned<2> {
+  using type = uint16_t;
+};
+
+template <>
+struct RadixUnsigned<4> {
+  using type = uint32_t;
+};
+
+template <>
+struct RadixUnsigned<8> {
+  using type = uint64_t;
+};
+
+/**
+ * Order preserving mapping of T onto unsigned integer of the same width
+ */
+template <typename T>
+struct RadixKey {
+  using U = typename RadixUnsigned<sizeof(T)>::type;
+
+  static constexpr bool floating = std::is_floating_point<T>::value || std::is_same<T, float16>::value ||
+                                   std::is_same<T, bfloat16>::value;
+  static constexpr bool signedInt = !floating && std::numeric_limits<T>::is_signed;
+  static constexpr U SIGN = static_cast<U>(static_cast<U>(1) << (sizeof(U) * 8 - 1));
+  static constexpr int MANTISSA = std::is_same<T, double>::value    ? 52
+                                  : std::is_same<T, float>::value   ? 23
+                                  : std::is_same<T, float16>::value ? 10
+                                                                    : 7;
+  // all exponent bits set, anything above it without the sign bit is a NaN
+  static constexpr U INF = static_cast<U>(static_cast<U>(~SIGN) ^ ((static_cast<U>(1) << MANTISSA) - 1));
+
+  static SD_INLINE U encode(const T value, const bool descending) {
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+
+    if (floating) {
+      const U magnitude = static_cast<U>(bits & static_cast<U>(~SIGN));
+      if (magnitude > INF) bits = magnitude;
+
+      bits = (bits & SIGN) ? static_cast<U>(~bits) : static_cast<U>(bits | SIGN);
+    }
+    else if (signedInt)
+      bits = static_cast<U>(bits ^ SIGN);
+
+    return descending ? static_cast<U>(~bits) : bits;
+  }
+
+  static SD_INLINE T decode(U bits, const bool descending) {
+    if (descending) bits = static_cast<U>(~bits);
+
+    if (floating)
+      bits = (bits & SIGN) ? static_cast<U>(bits ^ SIGN) : static_cast<U>(~bits);
+    else if (signedInt)
+      bits = static_cast<U>(bits ^ SIGN);
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+// placeholder payload type for sorts without payload
+struct NoPayload {};
+
+template <typename P>
+struct Payload {
+  static constexpr bool present = true;
+};
+
+template <>
+struct Payload<NoPayload> {
+  static constexpr bool present = false;
+};
+
+/**
+ * Stable LSD radix sort of n unsigned keys, payload (if any) is permuted together with keys.
+ */
+template <typename U, typename P>
+static void radixSort(U *keys, P *payload, const sd::LongType n, int numThreads) {
+  constexpr int PASSES = sizeof(U);
+  constexpr int RADIX = 256;
+
+  numThreads = static_cast<int>(sd::math::sd_max<sd::LongType>(
+      1, sd::math::sd_min<sd::LongType>(numThreads, n / RADIX_ELEMENTS_PER_THREAD)));
+  const sd::LongType chunk = (n + numThreads - 1) / numThreads;
+
+  // histograms of every digit at once, [thread][pass][digit]
+  std::vector<sd::LongType> histogram(numThreads * PASSES * RADIX, 0);
+
+  auto countAll = PRAGMA_THREADS_FOR {
+    for (auto t = start; t < stop; t++) {
+      sd::LongType *h = histogram.data() + t * PASSES * RADIX;
+      const sd::LongType end = sd::math::sd_min<sd::LongType>(n, (t + 1) * chunk);
+      for (sd::LongType e = t * chunk; e < end; e++) {
+        const U key = keys[e];
+        for (int p = 0; p < PASSES; p++) h[p * RADIX + ((key >> (p * 8)) & 0xFF)]++;
+      }
+    }
+  };
+  samediff::Threads::parallel_tad(countAll, 0, numThreads, 1, numThreads);
+
+  std::vector<bool> skip(PASSES, false);
+  for (int p = 0; p < PASSES; p++)
+    for (int d = 0; d < RADIX; d++) {
+      sd::LongType total = 0;
+      for (int t = 0; t < numThreads; t++) total += histogram[(t * PASSES + p) * RADIX + d];
+      if (total == n) skip[p] = true;
+      if (total != 0) break;
+    }
+
+  // P may be bool, so std::vector isn't used for payload buffers
+  std::unique_ptr<U[]> keysTmp;
+  std::unique_ptr<P[]> payloadTmp;
+  U *src = keys, *dst = nullptr;
+  P *pSrc = payload, *pDst = nullptr;
+
+  // per-thread counts of the current pass, turned into per-thread scatter positions
+  std::vector<sd::LongType> positions(numThreads * RADIX);
+  bool moved = false;
+
+  for (int p = 0; p < PASSES; p++) {
+    if (skip[p]) continue;
+
+    if (dst == nullptr) {
+      keysTmp.reset(new U[n]);
+      dst = keysTmp.get();
+      if (Payload<P>::present) {
+        payloadTmp.reset(new P[n]);
+        pDst = payloadTmp.get();
+      }
+    }
+
+    const int shift = p * 8;
+
+    if (moved) {
+      auto count = PRAGMA_THREADS_FOR {
+        for (auto t = start; t < stop; t++) {
+          sd::LongType *h = positions.data() + t * RADIX;
+          std::fill(h, h + RADIX, 0);
+          const sd::LongType end = sd::math::sd_min<sd::LongType>(n, (t + 1) * chunk);
+          for (sd::LongType e = t * chunk; e < end; e++) h[(src[e] >> shift) & 0xFF]++;
+        }
+      };
+      samediff::Threads::parallel_tad(count, 0, numThreads, 1, numThreads);
+    } else {
+      for (int t = 0; t < numThreads; t++)
+        std::copy(histogram.begin() + (t * PASSES + p) * RADIX, histogram.begin() + (t * PASSES + p + 1) * RADIX,
+                  positions.begin() + t * RADIX);
+    }
+
+    // digit-major, thread-minor exclusive prefix sum keeps the sort stable
+    sd::LongType offset = 0;
+    for (int d = 0; d < RADIX; d++)
+      for (int t = 0; t < numThreads; t++) {
+        const sd::LongType c = positions[t * RADIX + d];
+        positions[t * RADIX + d] = offset;
+        offset += c;
+      }
+
+    auto scatter = PRAGMA_THREADS_FOR {
+      for (auto t = start; t < stop; t++) {
+        sd::LongType *pos = positions.data() + t * RADIX;
+        const sd::LongType end = sd::math::sd_min<sd::LongType>(n, (t + 1) * chunk);
+        for (sd::LongType e = t * chunk; e < end; e++) {
+          const auto target = pos[(src[e] >> shift) & 0xFF]++;
+          dst[target] = src[e];
+          if (Payload<P>::present) pDst[target] = pSrc[e];
+        }
+      }
+    };
+    samediff::Threads::parallel_tad(scatter, 0, numThreads, 1, numThreads);
+
+    std::swap(src, dst);
+    std::swap(pSrc, pDst);
+    moved = true;
+  }
+
+  // odd amount of executed passes leaves result in temporary buffer
+  if (src != keys) {
+    auto copy = PRAGMA_THREADS_FOR {
+      for (auto t = start; t < stop; t++) {
+        const sd::LongType begin = t * chunk;
+        const sd::LongType end = sd::math::sd_min<sd::LongType>(n, (t + 1) * chunk);
+        if (begin >= end) continue;
+        std::memcpy(keys + begin, src + begin, (end - begin) * sizeof(U));
+        if (Payload<P>::present) std::copy(pSrc + begin, pSrc + end, payload + begin);
+      }
+    };
+    samediff::Threads::parallel_tad(copy, 0, numThreads, 1, numThreads);
+  }
+}
+
+/**
+ * Sorts already mapped keys: radix sort for large arrays, introsort for small ones
+ */
+template <typename U, typename P>
+static void sortMapped(U *keys, P *payload, const sd::LongType n, const int numThreads) {
+  if (n < 2) return;
+
+  if (n >= RADIX_THRESHOLD) {
+    radixSort<U, P>(keys, payload, n, numThreads);
+  } else if (!Payload<P>::present) {
+    std::sort(keys, keys + n);
+  } else {
+    std::vector<std::pair<U, P>> pairs(n);
+    for (sd::LongType e = 0; e < n; e++) pairs[e] = std::make_pair(keys[e], payload[e]);
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const std::pair<U, P> &a, const std::pair<U, P> &b) { return a.first < b.first; });
+    for (sd::LongType e = 0; e < n; e++) {
+      keys[e] = pairs[e].first;
+      payload[e] = pairs[e].second;
+    }
+  }
+}
+
+/**
+ * Sorts n contiguous keys in place, payload (if not nullptr) is permuted together with keys
+ */
+template <typename K, typename P>
+static void sortLinear(K *keys, P *payload, const sd::LongType n, const bool descending, const int numThreads) {
+  using U = typename RadixKey<K>::U;
+  if (n < 2) return;
+
+  // keys are mapped in place: U has the same width as K
+  auto mapped = reinterpret_cast<U *>(keys);
+
+  auto encode = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) mapped[e] = RadixKey<K>::encode(keys[e], descending);
+  };
+  auto decode = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) keys[e] = RadixKey<K>::decode(mapped[e], descending);
+  };
+
+  if (numThreads > 1) {
+    samediff::Threads::parallel_for(encode, 0, n, 1, numThreads);
+    sortMapped<U, P>(mapped, payload, n, numThreads);
+    samediff::Threads::parallel_for(decode, 0, n, 1, numThreads);
+  } else {
+    encode(0, 0, n, 1);
+    sortMapped<U, P>(mapped, payload, n, numThreads);
+    decode(0, 0, n, 1);
+  }
+}
+
+/**
+ * Sorts keys described by kShapeInfo, payload (if not nullptr) is described by pShapeInfo and must have the same
+ * length. Contiguous arrays are sorted in place, anything else goes through contiguous copies.
+ */
+template <typename K, typename P>
+static void sortStrided(K *keys, const sd::LongType *kShapeInfo, P *payload, const sd::LongType *pShapeInfo,
+                        const bool descending, const int numThreads) {
+  const sd::LongType n = shape::length(kShapeInfo);
+  if (n < 2) return;
+
+  // contiguous keys and payload pair up in memory order only if it's the same logical order for both, otherwise
+  // whichever of them isn't 'c' ordered goes through a copy in logical order
+  sd::LongType nonUnity;
+  const bool paired = !Payload<P>::present || shape::order(kShapeInfo) == shape::order(pShapeInfo) ||
+                      shape::isCommonVector(kShapeInfo, nonUnity) || shape::isCommonVector(pShapeInfo, nonUnity);
+  const bool kLinear = shape::elementWiseStride(kShapeInfo) == 1 && (paired || shape::order(kShapeInfo) == 'c');
+  const bool pLinear = !Payload<P>::present ||
+                       (shape::elementWiseStride(pShapeInfo) == 1 && (paired || shape::order(pShapeInfo) == 'c'));
+
+  if (kLinear && pLinear) {
+    sortLinear<K, P>(keys, payload, n, descending, numThreads);
+    return;
+  }
+
+  std::unique_ptr<K[]> kCopy;
+  std::unique_ptr<P[]> pCopy;
+  K *k = keys;
+  P *p = payload;
+
+  if (!kLinear) {
+    kCopy.reset(new K[n]);
+    k = kCopy.get();
+    for (sd::LongType e = 0; e < n; e++) k[e] = keys[shape::getIndexOffset(e, kShapeInfo)];
+  }
+
+  if (!pLinear) {
+    pCopy.reset(new P[n]);
+    p = pCopy.get();
+    for (sd::LongType e = 0; e < n; e++) p[e] = payload[shape::getIndexOffset(e, pShapeInfo)];
+  }
+
+  sortLinear<K, P>(k, p, n, descending, numThreads);
+
+  if (!kLinear)
+    for (sd::LongType e = 0; e < n; e++) keys[shape::getIndexOffset(e, kShapeInfo)] = k[e];
+
+  if (!pLinear)
+    for (sd::LongType e = 0; e < n; e++) payload[shape::getIndexOffset(e, pShapeInfo)] = p[e];
+}
+
+template <typename K>
+static void sortStrided(K *keys, const sd::LongType *kShapeInfo, const bool descending, const int numThreads) {
+  sortStrided<K, NoPayload>(keys, kShapeInfo, nullptr, nullptr, descending, numThreads);
+}
+
+}  // namespace sorting
+}  // namespace sd
+
+#endif  // LIBND4J_SPECIALS_SORT_HPP
@@ -20,6 +20,7 @@
 // @author raver119@gmail.com
 //
 #include <helpers/shape.h>
+#include <ops/impl/specials_sort.hpp>
 #include <ops/specials_sparse.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -89,120 +90,43 @@ void SparseUtils<T>::swapEverything(sd::LongType *indices, T *array, int rank, s
 }
 
 template <typename T>
-sd::LongType SparseUtils<T>::coo_quickSort_findPivot(sd::LongType *indices, T *array, sd::LongType left,
-                                                     sd::LongType right, int rank) {
-  sd::LongType mid = (left + right) / 2;
-
-  // ensure left < mid
-  if (ltIndices(indices, rank, mid, left)) {  // ensure lo < mid
-    swapEverything(indices, array, rank, mid, left);
-  }
-
-  // ensure left < right
-  if (ltIndices(indices, rank, right, left)) {
-    swapEverything(indices, array, rank, right, left);
-  }
-
-  // ensure mid < right
-  if (ltIndices(indices, rank, right, mid)) {
-    swapEverything(indices, array, rank, right, mid);
-  }
-
-  // mid is the median of the 3, and is the optimal pivot point
-  return mid;
-}
+void SparseUtils<T>::sortCooIndicesGeneric(sd::LongType *indices, void *vx, sd::LongType length, int rank) {
+  auto values = reinterpret_cast<T *>(vx);
+  if (length < 2) return;
 
-template <typename T>
-void SparseUtils<T>::coo_quickSort_parallel_internal(sd::LongType *indices, T *array, sd::LongType left,
-                                                     sd::LongType right, int cutoff, int rank) {
-  sd::LongType span = right - left;  // elements to be partitioned - 1
+  const int numThreads = sd::Environment::getInstance().maxMasterThreads();
+  using U = sorting::RadixKey<sd::LongType>::U;
 
-  if (span == 1) {
-    // only 2 elements to partition. swap if needed and return directly without further sorting.
-    if (ltIndices(indices, rank, right, left)) {
-      swapEverything(indices, array, rank, left, right);
-    }
-    return;
-  }
+  // lexicographic order via stable sorts by every coordinate, innermost dimension first,
+  // only the permutation moves around until the very end
+  std::vector<sd::LongType> permutation(length);
+  std::vector<U> column(length);
+  for (sd::LongType e = 0; e < length; e++) permutation[e] = e;
 
-  // find optimal pivot and sort left < right < right
-  sd::LongType pvt = coo_quickSort_findPivot(indices, array, left, right, rank);
+  for (int d = rank - 1; d >= 0; d--) {
+    auto gather = PRAGMA_THREADS_FOR {
+      for (auto e = start; e < stop; e++)
+        column[e] = sorting::RadixKey<sd::LongType>::encode(indices[permutation[e] * rank + d], false);
+    };
+    samediff::Threads::parallel_for(gather, 0, length);
 
-  if (span == 2) {
-    // only 3 elements to partition. findPivot has already sorted them. no further sorting is needed.
-    return;
+    sorting::sortMapped<U, sd::LongType>(column.data(), permutation.data(), length, numThreads);
   }
 
-  // index that is greater than pivot - leftmost element is already partitioned because of findPivot.
-  sd::LongType i = left + 1;
-
-  // index that is smaller than pivot - rightmost element is already partitioned because of findPivot.
-  sd::LongType j = right - 1;
-
-  {
-    // flag that indicates that pivot index lies between i and j and *could* be swapped.
-    bool checkPivot = true;
-    /* PARTITION PART */
-    while (i <= j) {
-      while (ltIndices(indices, rank, i, pvt)) i++;
-
-      while (gtIndices(indices, rank, j, pvt)) j--;
-
-      if (i <= j) {
-        if (i != j) {  // swap can be fairly expensive. don't swap i -> i
-          swapEverything(indices, array, rank, i, j);
-        }
-
-        // only check pivot if it hasn't already been swapped.
-        if (checkPivot) {
-          // check if we moved the pivot, if so, change pivot index accordingly
-          if (pvt == j) {
-            pvt = i;
-            checkPivot = false;
-          } else if (pvt == i) {
-            pvt = j;
-            checkPivot = false;
-          }
-        }
+  std::vector<sd::LongType> sortedIndices(length * rank);
+  std::vector<T> sortedValues(length);
 
-        i++;
-        j--;
-      }
+  auto apply = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      const auto source = permutation[e];
+      for (int d = 0; d < rank; d++) sortedIndices[e * rank + d] = indices[source * rank + d];
+      sortedValues[e] = values[source];
     }
-  }
-
-  if ((span < cutoff)) {
-    if (left < j) {
-      coo_quickSort_parallel_internal(indices, array, left, j, cutoff, rank);
-    }
-    if (i < right) {
-      coo_quickSort_parallel_internal(indices, array, i, right, cutoff, rank);
-    }
-
-  } else {
-    PRAGMA_OMP_TASK { coo_quickSort_parallel_internal(indices, array, left, j, cutoff, rank); }
-    PRAGMA_OMP_TASK { coo_quickSort_parallel_internal(indices, array, i, right, cutoff, rank); }
-  }
-}
-
-template <typename T>
-void SparseUtils<T>::coo_quickSort_parallel(sd::LongType *indices, T *array, sd::LongType lenArray, int numThreads,
-                                            int rank) {
-  int cutoff = 1000;
+  };
+  samediff::Threads::parallel_for(apply, 0, length);
 
-  PRAGMA_OMP_PARALLEL_THREADS(numThreads) {
-    PRAGMA_OMP_SINGLE_ARGS(nowait) { coo_quickSort_parallel_internal(indices, array, 0, lenArray - 1, cutoff, rank); }
-  }
-}
-
-template <typename T>
-void SparseUtils<T>::sortCooIndicesGeneric(sd::LongType *indices, void *vx, sd::LongType length, int rank) {
-  auto values = reinterpret_cast<T *>(vx);
-#ifdef _OPENMP
-  coo_quickSort_parallel(indices, values, length, omp_get_max_threads(), rank);
-#else
-  coo_quickSort_parallel(indices, values, length, 1, rank);
-#endif
+  std::memcpy(indices, sortedIndices.data(), length * rank * sizeof(sd::LongType));
+  std::copy(sortedValues.begin(), sortedValues.end(), values);
 }
 
 BUILD_SINGLE_TEMPLATE(template class SparseUtils, , SD_COMMON_TYPES);
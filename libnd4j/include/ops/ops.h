@@ -2335,23 +2335,45 @@ class OneMinus {
   }
 };
 
+/**
+ * @brief AggregateType - helper template to use desired type for the aggregation expressions.
+ *  This way we can reduce overflow and precision issues for certain types
+ *
+ * @tparam Z
+ */
+template <typename Z>
+struct AggregateType {
+  using type = Z;
+};
+
+template <>
+struct AggregateType<float16> {
+  using type = float;
+};
+
+template <>
+struct AggregateType<bfloat16> {
+  using type = float;
+};
+
 template <typename X>
 class Sum {
  public:
   no_op_exec_special_accumulation_same no_op_exec_special_accumulation_same_cuda
 
-  SD_OP_DEF static X
-  startingValue(const X *input) {
-    return static_cast<X>(0.0f);
-  }
+  using InterType = typename AggregateType<X>::type;
 
-  SD_OP_DEF static X merge(X old, X opOutput, X *extraParams) { return opOutput + old; }
+  SD_OP_DEF static X startingValue(const X *input) { return static_cast<X>(0.0f); }
 
-  SD_OP_DEF static X update(X old, X opOutput, X *extraParams) { return opOutput + old; }
+  SD_OP_DEF static InterType merge(InterType old, InterType opOutput, X *extraParams) { return opOutput + old; }
 
-  SD_OP_DEF static X op(X d1, X *extraParams) { return d1; }
+  SD_OP_DEF static InterType update(InterType old, InterType opOutput, X *extraParams) { return opOutput + old; }
 
-  SD_OP_DEF static X postProcess(X reduction, sd::LongType n, X *extraParams) { return reduction; }
+  SD_OP_DEF static InterType op(X d1, X *extraParams) { return static_cast<InterType>(d1); }
+
+  SD_OP_DEF static X postProcess(InterType reduction, sd::LongType n, X *extraParams) {
+    return static_cast<X>(reduction);
+  }
 };
 
 template <typename X>
@@ -2379,22 +2401,6 @@ class ReduceSameBenchmarkOp {
   SD_OP_DEF static X postProcess(X reduction, sd::LongType n, X *extraParams) { return reduction; }
 };
 
-/**
- * @brief AggregateType - helper template to use desired type for the aggregation expressions.
- *  This way we can reduce overflow and precision issues for certain types
- *
- * @tparam Z
- */
-template <typename Z>
-struct AggregateType {
-  using type = Z;
-};
-
-template <>
-struct AggregateType<float16> {
-  using type = float;
-};
-
 template <typename X, typename Z>
 class ShannonEntropy {
  public:
@@ -2468,20 +2474,23 @@ class ASum {
   no_op_exec_special_accumulation_same no_op_exec_special_accumulation_same_cuda
 
   const static functions::ReduceType reduceType = functions::ReduceType::ASUM;
+  using InterType = typename AggregateType<X>::type;
 
   SD_OP_DEF static X startingValue(const X *input) { return static_cast<X>(0); }
 
-  SD_OP_DEF static X merge(X old, X opOutput, X *extraParams) {
-    return sd::math::sd_abs<X>(opOutput) + sd::math::sd_abs<X>(old);
+  SD_OP_DEF static InterType merge(InterType old, InterType opOutput, X *extraParams) {
+    return sd::math::sd_abs<InterType>(opOutput) + sd::math::sd_abs<InterType>(old);
   }
 
-  SD_OP_DEF static X update(X old, X opOutput, X *extraParams) {
-    return sd::math::sd_abs<X>(opOutput) + sd::math::sd_abs<X>(old);
+  SD_OP_DEF static InterType update(InterType old, InterType opOutput, X *extraParams) {
+    return sd::math::sd_abs<InterType>(opOutput) + sd::math::sd_abs<InterType>(old);
   }
 
-  SD_OP_DEF static X op(X d1, X *extraParams) { return sd::math::sd_abs<X>(d1); }
+  SD_OP_DEF static InterType op(X d1, X *extraParams) { return static_cast<InterType>(sd::math::sd_abs<X>(d1)); }
 
-  SD_OP_DEF static X postProcess(X reduction, sd::LongType n, X *extraParams) { return sd::math::sd_abs<X>(reduction); }
+  SD_OP_DEF static X postProcess(InterType reduction, sd::LongType n, X *extraParams) {
+    return static_cast<X>(sd::math::sd_abs<InterType>(reduction));
+  }
 };
 
 template <typename X, typename Z>
@@ -56,12 +56,6 @@ class SD_LIB_EXPORT SpecialMethods {
   static void averageGeneric(void **x, void *z, const sd::LongType *zShapeInfo, int n, sd::LongType length,
                              bool propagate);
 
-  static sd::LongType getPosition(const sd::LongType *xShapeInfo, sd::LongType index);
-  static void quickSort_parallel_internal(T *array, const sd::LongType *xShapeInfo, int left, int right, int cutoff,
-                                          bool descending);
-  static void quickSort_parallel(void *array, const sd::LongType *xShapeInfo, sd::LongType lenArray, int numThreads,
-                                 bool descending);
-
   static int nextPowerOf2(int number);
   static int lastPowerOf2(int number);
 
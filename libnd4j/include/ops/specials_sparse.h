@@ -59,14 +59,6 @@ class SD_LIB_EXPORT SparseUtils {
 
   static void swapEverything(sd::LongType *indices, T *array, int rank, sd::LongType x, sd::LongType y);
 
-  static void coo_quickSort_parallel_internal(sd::LongType *indices, T *array, sd::LongType left, sd::LongType right,
-                                              int cutoff, int rank);
-
-  static void coo_quickSort_parallel(sd::LongType *indices, T *array, sd::LongType lenArray, int numThreads, int rank);
-
-  static sd::LongType coo_quickSort_findPivot(sd::LongType *indices, T *array, sd::LongType left, sd::LongType right,
-                                              int rank);
-
   static void sortCooIndicesGeneric(sd::LongType *indices, void *vx, sd::LongType length, int rank);
 };
 
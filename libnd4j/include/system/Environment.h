@@ -50,6 +50,13 @@ class SD_LIB_EXPORT Environment {
   std::atomic<bool> _precBoost;
   std::atomic<bool> _useONEDNN{true};
   std::atomic<bool> _allowHelpers{true};
+  std::atomic<bool> _useWinograd{true};
+  std::atomic<bool> _useScratchArena{true};
+  std::atomic<int64_t> _scratchArenaLimit{128LL * 1024LL * 1024LL};
+  std::atomic<bool> _useWorkStealing{true};
+  std::atomic<bool> _tracing{false};
+  std::atomic<int> _traceSampling{1};
+  std::atomic<int64_t> _traceSlowNanos{0};
 
   std::atomic<int> _maxThreads;
   std::atomic<int> _maxMasterThreads;
@@ -141,6 +148,48 @@ class SD_LIB_EXPORT Environment {
   bool isUseONEDNN() { return _useONEDNN.load(); }
   void setUseONEDNN(bool useMKLDNN) { _useONEDNN.store(useMKLDNN); }
 
+  /**
+   * Winograd transform is used for 3x3 stride-1 conv2d in float/double by default
+   */
+  bool isUseWinograd() { return _useWinograd.load(); }
+  void setUseWinograd(bool useWinograd) { _useWinograd.store(useWinograd); }
+
+  /**
+   * Op-internal temporaries are placed into per-thread scratch arenas by default, see memory/ScratchArena.h
+   */
+  bool isUseScratchArena() { return _useScratchArena.load(); }
+  void setUseScratchArena(bool useScratchArena) { _useScratchArena.store(useScratchArena); }
+
+  /**
+   * Max size of a single thread's scratch arena, larger temporaries go to heap
+   */
+  int64_t scratchArenaLimit() { return _scratchArenaLimit.load(); }
+  void setScratchArenaLimit(int64_t maxBytes) { _scratchArenaLimit.store(maxBytes); }
+
+  /**
+   * samediff::Threads schedules work on execution/WorkStealingPool.h by default, ThreadPool is used otherwise
+   */
+  bool isUseWorkStealing() { return _useWorkStealing.load(); }
+  void setUseWorkStealing(bool useWorkStealing) { _useWorkStealing.store(useWorkStealing); }
+
+  /**
+   * Op executions are recorded by helpers/ExecutionTracer.h when tracing is on
+   */
+  bool isTracing() { return _tracing.load(std::memory_order_relaxed); }
+  void setTracing(bool tracing) { _tracing.store(tracing); }
+
+  /**
+   * Only every N-th execution on each thread gets recorded, 1 means every execution
+   */
+  int traceSampling() { return _traceSampling.load(std::memory_order_relaxed); }
+  void setTraceSampling(int every) { _traceSampling.store(every); }
+
+  /**
+   * Executions slower than this are recorded regardless of sampling, 0 disables the check
+   */
+  int64_t traceSlowNanos() { return _traceSlowNanos.load(std::memory_order_relaxed); }
+  void setTraceSlowNanos(int64_t nanos) { _traceSlowNanos.store(nanos); }
+
   sd::DataType defaultFloatDataType();
   void setDefaultFloatDataType(sd::DataType dtype);
 
@@ -184,3 +184,316 @@ TEST_F(AttentionTests, basic_multi_head_dot_product_bp_attention_with_mask) {
     delete result;
 }
  */
+
+static void fillAttention(NDArray& array, const double phase) {
+  for (sd::LongType e = 0; e < array.lengthOf(); e++) array.p(e, std::sin(0.37 * e + phase) * 1.5);
+}
+
+// softmax(scale * q k^T) v over [bS, nH, t, d] arrays, mask is [bS, tK] or nullptr
+static NDArray attentionReference(NDArray& q, NDArray& k, NDArray& v, NDArray* mask, const double scale,
+                                  const bool causal) {
+  const sd::LongType bS = q.sizeAt(0), nH = q.sizeAt(1), tQ = q.sizeAt(2), tK = k.sizeAt(2), dK = q.sizeAt(3),
+                     dV = v.sizeAt(3);
+  NDArray out('c', {bS, nH, tQ, dV}, sd::DataType::DOUBLE);
+  out.nullify();
+  std::vector<double> w(tK);
+
+  for (sd::LongType b = 0; b < bS; b++)
+    for (sd::LongType h = 0; h < nH; h++)
+      for (sd::LongType i = 0; i < tQ; i++) {
+        double max = -1e300, sum = 0.;
+        for (sd::LongType j = 0; j < tK; j++) {
+          w[j] = -INFINITY;
+          if ((causal && j > i) || (mask != nullptr && mask->e<double>(b, j) == 0.)) continue;
+          double s = 0.;
+          for (sd::LongType e = 0; e < dK; e++) s += q.e<double>(b, h, i, e) * k.e<double>(b, h, j, e);
+          w[j] = s * scale;
+          max = sd::math::sd_max<double>(max, w[j]);
+        }
+        for (sd::LongType j = 0; j < tK; j++) sum += w[j] == -INFINITY ? 0. : std::exp(w[j] - max);
+        if (sum == 0.) continue;
+
+        for (sd::LongType e = 0; e < dV; e++) {
+          double o = 0.;
+          for (sd::LongType j = 0; j < tK; j++)
+            if (w[j] != -INFINITY) o += std::exp(w[j] - max) / sum * v.e<double>(b, h, j, e);
+          out.p(b, h, i, e, o);
+        }
+      }
+
+  return out;
+}
+
+// gradients of attentionReference() w.r.t. q, k and v for given output gradient, same layouts
+static void attentionBpReference(NDArray& q, NDArray& k, NDArray& v, NDArray* mask, NDArray& eps, const double scale,
+                                 const bool causal, NDArray& dq, NDArray& dk, NDArray& dv) {
+  const sd::LongType bS = q.sizeAt(0), nH = q.sizeAt(1), tQ = q.sizeAt(2), tK = k.sizeAt(2), dK = q.sizeAt(3),
+                     dV = v.sizeAt(3);
+  dq.nullify();
+  dk.nullify();
+  dv.nullify();
+  std::vector<double> p(tK), dp(tK);
+
+  for (sd::LongType b = 0; b < bS; b++)
+    for (sd::LongType h = 0; h < nH; h++)
+      for (sd::LongType i = 0; i < tQ; i++) {
+        double max = -1e300, sum = 0.;
+        for (sd::LongType j = 0; j < tK; j++) {
+          p[j] = -INFINITY;
+          if ((causal && j > i) || (mask != nullptr && mask->e<double>(b, j) == 0.)) continue;
+          double s = 0.;
+          for (sd::LongType e = 0; e < dK; e++) s += q.e<double>(b, h, i, e) * k.e<double>(b, h, j, e);
+          p[j] = s * scale;
+          max = sd::math::sd_max<double>(max, p[j]);
+        }
+        for (sd::LongType j = 0; j < tK; j++) {
+          p[j] = p[j] == -INFINITY ? 0. : std::exp(p[j] - max);
+          sum += p[j];
+        }
+        if (sum == 0.) continue;
+
+        // dp = eps v^T, ds = p (dp - sum(p dp))
+        double dot = 0.;
+        for (sd::LongType j = 0; j < tK; j++) {
+          p[j] /= sum;
+          dp[j] = 0.;
+          for (sd::LongType e = 0; e < dV; e++) {
+            dp[j] += eps.e<double>(b, h, i, e) * v.e<double>(b, h, j, e);
+            dv.p(b, h, j, e, dv.e<double>(b, h, j, e) + p[j] * eps.e<double>(b, h, i, e));
+          }
+          dot += p[j] * dp[j];
+        }
+
+        for (sd::LongType j = 0; j < tK; j++) {
+          const double ds = p[j] * (dp[j] - dot) * scale;
+          if (ds == 0.) continue;
+          for (sd::LongType e = 0; e < dK; e++) {
+            dq.p(b, h, i, e, dq.e<double>(b, h, i, e) + ds * k.e<double>(b, h, j, e));
+            dk.p(b, h, j, e, dk.e<double>(b, h, j, e) + ds * q.e<double>(b, h, i, e));
+          }
+        }
+      }
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_1) {
+  auto queries = NDArrayFactory::create<float>('c', {2, 70, 8});
+  auto keys = NDArrayFactory::create<float>('c', {2, 90, 8});
+  auto values = NDArrayFactory::create<float>('c', {2, 90, 6});
+  fillAttention(queries, 0.1);
+  fillAttention(keys, 0.2);
+  fillAttention(values, 0.3);
+
+  sd::ops::fused_dot_product_attention op;
+  auto result = op.evaluate({&queries, &keys, &values}, {0.5}, {}, {});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+  ASSERT_TRUE(z->isSameShape({2, 70, 6}));
+
+  auto q = queries.reshape('c', {2, 1, 70, 8});
+  auto k = keys.reshape('c', {2, 1, 90, 8});
+  auto v = values.reshape('c', {2, 1, 90, 6});
+  auto exp = attentionReference(q, k, v, nullptr, 0.5, false).reshape('c', {2, 70, 6});
+  for (sd::LongType e = 0; e < exp.lengthOf(); e++) ASSERT_NEAR(exp.e<double>(e), z->e<double>(e), 1e-5);
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_2) {
+  auto queries = NDArrayFactory::create<float>('c', {2, 3, 130, 8});
+  auto keys = NDArrayFactory::create<float>('c', {2, 3, 130, 8});
+  auto values = NDArrayFactory::create<float>('c', {2, 3, 130, 4});
+  auto mask = NDArrayFactory::create<float>('c', {2, 130});
+  fillAttention(queries, 0.4);
+  fillAttention(keys, 0.5);
+  fillAttention(values, 0.6);
+  mask.assign(1.f);
+  for (int j = 3; j < 130; j += 7) mask.p(1, j, 0.f);
+  for (int j = 100; j < 130; j++) mask.p(0, j, 0.f);
+
+  sd::ops::fused_dot_product_attention op;
+  auto result = op.evaluate({&queries, &keys, &values, &mask}, {0.35}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+
+  auto exp = attentionReference(queries, keys, values, &mask, 0.35, true);
+  for (sd::LongType e = 0; e < exp.lengthOf(); e++) ASSERT_NEAR(exp.e<double>(e), z->e<double>(e), 1e-5);
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp_1) {
+  NDArray queries('c', {1, 2, 9, 3}, sd::DataType::DOUBLE);
+  NDArray keys('c', {1, 2, 11, 3}, sd::DataType::DOUBLE);
+  NDArray values('c', {1, 2, 11, 2}, sd::DataType::DOUBLE);
+  NDArray eps('c', {1, 2, 9, 2}, sd::DataType::DOUBLE);
+  fillAttention(queries, 0.7);
+  fillAttention(keys, 0.8);
+  fillAttention(values, 0.9);
+
+  const OpArgsHolder argsHolderFF({&queries, &keys, &values}, {0.6}, {}, {true});
+  const OpArgsHolder argsHolderBP({&queries, &keys, &values, &eps}, {0.6}, {}, {true});
+
+  sd::ops::fused_dot_product_attention opFF;
+  sd::ops::fused_dot_product_attention_bp opBP;
+
+  const bool isGradCorrect = GradCheck::checkGrad(opFF, opBP, argsHolderFF, argsHolderBP);
+  ASSERT_TRUE(isGradCorrect);
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp_2) {
+  NDArray queries('c', {2, 5, 3}, sd::DataType::DOUBLE);
+  NDArray keys('c', {2, 7, 3}, sd::DataType::DOUBLE);
+  NDArray values('c', {2, 7, 4}, sd::DataType::DOUBLE);
+  NDArray eps('c', {2, 5, 4}, sd::DataType::DOUBLE);
+  fillAttention(queries, 1.1);
+  fillAttention(keys, 1.2);
+  fillAttention(values, 1.3);
+
+  const OpArgsHolder argsHolderFF({&queries, &keys, &values}, {1.}, {}, {});
+  const OpArgsHolder argsHolderBP({&queries, &keys, &values, &eps}, {1.}, {}, {});
+
+  sd::ops::fused_dot_product_attention opFF;
+  sd::ops::fused_dot_product_attention_bp opBP;
+
+  const bool isGradCorrect = GradCheck::checkGrad(opFF, opBP, argsHolderFF, argsHolderBP);
+  ASSERT_TRUE(isGradCorrect);
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp_3) {
+  // several query and key blocks with a partial tail, causal blocks start on the diagonal
+  NDArray queries('c', {2, 2, 150, 8}, sd::DataType::DOUBLE);
+  NDArray keys('c', {2, 2, 150, 8}, sd::DataType::DOUBLE);
+  NDArray values('c', {2, 2, 150, 4}, sd::DataType::DOUBLE);
+  NDArray eps('c', {2, 2, 150, 4}, sd::DataType::DOUBLE);
+  NDArray mask('c', {2, 150}, sd::DataType::DOUBLE);
+  fillAttention(queries, 0.2);
+  fillAttention(keys, 0.3);
+  fillAttention(values, 0.4);
+  fillAttention(eps, 0.5);
+  mask.assign(1.);
+  for (int j = 5; j < 150; j += 9) mask.p(0, j, 0.);
+  for (int j = 70; j < 140; j++) mask.p(1, j, 0.);
+
+  NDArray dq(queries.shapeInfo()), dk(keys.shapeInfo()), dv(values.shapeInfo());
+  attentionBpReference(queries, keys, values, &mask, eps, 0.3, true, dq, dk, dv);
+
+  sd::ops::fused_dot_product_attention_bp op;
+  auto result = op.evaluate({&queries, &keys, &values, &eps, &mask}, {0.3}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_TRUE(dq.equalsTo(result.at(0), 1e-8));
+  ASSERT_TRUE(dk.equalsTo(result.at(1), 1e-8));
+  ASSERT_TRUE(dv.equalsTo(result.at(2), 1e-8));
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_bp_4) {
+  // non-causal masked gradients must match the materializing dot_product_attention_bp, which takes [bS, d, t]
+  NDArray queries('c', {2, 130, 8}, sd::DataType::DOUBLE);
+  NDArray keys('c', {2, 140, 8}, sd::DataType::DOUBLE);
+  NDArray values('c', {2, 140, 4}, sd::DataType::DOUBLE);
+  NDArray eps('c', {2, 130, 4}, sd::DataType::DOUBLE);
+  NDArray mask('c', {2, 140}, sd::DataType::DOUBLE);
+  fillAttention(queries, 0.6);
+  fillAttention(keys, 0.7);
+  fillAttention(values, 0.8);
+  fillAttention(eps, 0.9);
+  mask.assign(1.);
+  for (int j = 2; j < 140; j += 5) mask.p(1, j, 0.);
+  for (int j = 100; j < 140; j++) mask.p(0, j, 0.);
+
+  sd::ops::fused_dot_product_attention_bp op;
+  auto fused = op.evaluate({&queries, &keys, &values, &eps, &mask}, {1. / std::sqrt(8.)}, {}, {});
+  ASSERT_EQ(sd::Status::OK, fused.status());
+
+  auto q = queries.permute({0, 2, 1}).dup('c');
+  auto k = keys.permute({0, 2, 1}).dup('c');
+  auto v = values.permute({0, 2, 1}).dup('c');
+  auto e = eps.permute({0, 2, 1}).dup('c');
+  sd::ops::dot_product_attention_bp opRef;
+  auto materialized = opRef.evaluate({&q, &k, &v, &e, &mask}, {}, {1}, {});
+  ASSERT_EQ(sd::Status::OK, materialized.status());
+
+  for (int i = 0; i < 3; i++) {
+    auto expected = materialized.at(i)->permute({0, 2, 1});
+    ASSERT_TRUE(expected.equalsTo(fused.at(i), 1e-8));
+  }
+}
+
+TEST_F(AttentionTests, fused_dot_product_attention_mixed_types_1) {
+  NDArray queries('c', {2, 5, 3}, sd::DataType::FLOAT32);
+  NDArray keys('c', {2, 7, 3}, sd::DataType::DOUBLE);
+  NDArray values('c', {2, 7, 4}, sd::DataType::FLOAT32);
+  NDArray eps('c', {2, 5, 4}, sd::DataType::DOUBLE);
+  NDArray output('c', {2, 5, 4}, sd::DataType::FLOAT32);
+  NDArray dLdq('c', {2, 5, 3}, sd::DataType::FLOAT32);
+  NDArray dLdk('c', {2, 7, 3}, sd::DataType::FLOAT32);
+  NDArray dLdv('c', {2, 7, 4}, sd::DataType::FLOAT32);
+
+  sd::ops::fused_dot_product_attention op;
+  ASSERT_ANY_THROW(op.execute({&queries, &keys, &values}, {&output}, {1.}, {}, {}));
+
+  keys = NDArray('c', {2, 7, 3}, sd::DataType::FLOAT32);
+  sd::ops::fused_dot_product_attention_bp opBP;
+  ASSERT_ANY_THROW(opBP.execute({&queries, &keys, &values, &eps}, {&dLdq, &dLdk, &dLdv}, {1.}, {}, {}));
+}
+
+TEST_F(AttentionTests, multi_head_dot_product_attention_fused_1) {
+  auto keys = NDArrayFactory::create<float>('c', {3, 4, 75});
+  auto values = NDArrayFactory::create<float>('c', {3, 4, 75});
+  auto queries = NDArrayFactory::create<float>('c', {3, 4, 70});
+  auto Wq = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wk = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wv = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wo = NDArrayFactory::create<float>('c', {2 * 3, 5});
+  fillAttention(keys, 0.1);
+  fillAttention(values, 0.2);
+  fillAttention(queries, 0.3);
+  fillAttention(Wq, 0.4);
+  fillAttention(Wk, 0.5);
+  fillAttention(Wv, 0.6);
+  fillAttention(Wo, 0.7);
+
+  // without weights output the fused kernel is used, with it the scores are materialized
+  sd::ops::multi_head_dot_product_attention op;
+  auto fused = op.evaluate({&queries, &keys, &values, &Wq, &Wk, &Wv, &Wo}, {1, 0});
+  auto materialized = op.evaluate({&queries, &keys, &values, &Wq, &Wk, &Wv, &Wo}, {1, 1});
+  ASSERT_EQ(sd::Status::OK, fused.status());
+  ASSERT_EQ(sd::Status::OK, materialized.status());
+
+  ASSERT_TRUE(materialized.at(0)->isSameShape(fused.at(0)));
+  ASSERT_TRUE(materialized.at(0)->equalsTo(fused.at(0), 1e-4));
+}
+
+TEST_F(AttentionTests, multi_head_dot_product_attention_fused_2) {
+  auto keys = NDArrayFactory::create<float>('c', {3, 4, 75});
+  auto values = NDArrayFactory::create<float>('c', {3, 4, 75});
+  auto queries = NDArrayFactory::create<float>('c', {3, 4, 70});
+  auto Wq = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wk = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wv = NDArrayFactory::create<float>('c', {2, 3, 4});
+  auto Wo = NDArrayFactory::create<float>('c', {2 * 3, 5});
+  auto mask = NDArrayFactory::create<float>('c', {3, 75});
+  fillAttention(keys, 0.1);
+  fillAttention(values, 0.2);
+  fillAttention(queries, 0.3);
+  fillAttention(Wq, 0.4);
+  fillAttention(Wk, 0.5);
+  fillAttention(Wv, 0.6);
+  fillAttention(Wo, 0.7);
+  // every third key is masked out, the rest are kept
+  for (sd::LongType e = 0; e < mask.lengthOf(); e++) mask.p(e, e % 3 == 0 ? 0.f : 1.f);
+
+  sd::ops::multi_head_dot_product_attention op;
+  auto fused = op.evaluate({&queries, &keys, &values, &Wq, &Wk, &Wv, &Wo, &mask}, {1, 0});
+  auto materialized = op.evaluate({&queries, &keys, &values, &Wq, &Wk, &Wv, &Wo, &mask}, {1, 1});
+  auto unmasked = op.evaluate({&queries, &keys, &values, &Wq, &Wk, &Wv, &Wo}, {1, 0});
+  ASSERT_EQ(sd::Status::OK, fused.status());
+  ASSERT_EQ(sd::Status::OK, materialized.status());
+  ASSERT_EQ(sd::Status::OK, unmasked.status());
+
+  ASSERT_TRUE(materialized.at(0)->isSameShape(fused.at(0)));
+  ASSERT_TRUE(materialized.at(0)->equalsTo(fused.at(0), 1e-4));
+  ASSERT_FALSE(unmasked.at(0)->equalsTo(fused.at(0), 1e-4));
+
+  // masked keys get zero attention weight
+  auto weights = materialized.at(1);
+  for (sd::LongType b = 0; b < weights->sizeAt(0); b++)
+    for (sd::LongType h = 0; h < weights->sizeAt(1); h++)
+      for (sd::LongType j = 0; j < weights->sizeAt(2); j += 3)
+        for (sd::LongType i = 0; i < weights->sizeAt(3); i++) ASSERT_NEAR(0., weights->e<double>(b, h, j, i), 1e-6);
+}
@@ -0,0 +1,141 @@
+/* ******************************************************************************
+ *
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Apache License, Version 2.0 which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ *  See the NOTICE file distributed with this work for additional
+ *  information regarding copyright ownership.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ ******************************************************************************/
+
+//
+// Native benchmark harness: parameter spaces, timing and machine-readable reports
+//
+#include <helpers/BenchmarkHelper.h>
+#include <ops/declarable/CustomOperations.h>
+
+#include <algorithm>
+
+#include "testlayers.h"
+
+using namespace sd;
+using namespace sd::graph;
+
+class BenchmarkHelperTests : public NDArrayTests {
+ public:
+};
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BenchmarkHelperTests, ParametersBatch_1) {
+  IntPowerParameters length("length", 2, 4, 8, 2);
+  BoolParameters inplace("inplace");
+  PredefinedParameters k("k", {3, 5});
+
+  ParametersBatch batch({&length, &inplace, &k});
+  auto parameters = batch.parameters();
+
+  ASSERT_EQ(12, parameters.size());
+  ASSERT_EQ(16, parameters[0].getIntParam("length"));
+  ASSERT_EQ(0, parameters[0].getIntParam("inplace"));
+  ASSERT_EQ(3, parameters[0].getIntParam("k"));
+  ASSERT_EQ(5, parameters[1].getIntParam("k"));
+  ASSERT_EQ(1, parameters[2].getIntParam("inplace"));
+  ASSERT_EQ(256, parameters[11].getIntParam("length"));
+  ASSERT_EQ(std::string("length=256, inplace=1, k=5"), parameters[11].asString());
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BenchmarkHelperTests, ParametersBatch_2) {
+  ParametersBatch batch({});
+  auto parameters = batch.parameters();
+
+  ASSERT_EQ(1, parameters.size());
+  ASSERT_TRUE(parameters[0].intParams().empty());
+
+  IntParameters rows("rows", 1, 10, 4);
+  ASSERT_EQ(std::vector<int>({1, 5, 9}), rows.evaluate());
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BenchmarkHelperTests, Percentile_1) {
+  std::vector<double> timings({5., 1., 4., 2., 3., 10., 9., 8., 7., 6.});
+
+  ASSERT_EQ(5., BenchmarkReport::percentile(timings, 50.));
+  ASSERT_EQ(10., BenchmarkReport::percentile(timings, 99.));
+  ASSERT_EQ(1., BenchmarkReport::percentile(timings, 0.));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BenchmarkHelperTests, ScalarReport_1) {
+  BenchmarkReport report;
+  BenchmarkHelper helper(1, 5, &report);
+
+  IntParameters length("length", 64, 128, 64);
+  ParametersBatch batch({&length});
+
+  auto generator = PARAMETRIC_XZ() {
+    x.push_back(NDArrayFactory::create_<float>('c', {p.getIntParam("length")}));
+    z.push_back(NDArrayFactory::create_<float>('c', {p.getIntParam("length")}));
+  };
+
+  auto scalar = NDArrayFactory::create<float>(2.f);
+  ScalarBenchmark sbAdd(scalar::Ops::Add, "sAdd");
+  sbAdd.setY(&scalar);
+
+  auto table = helper.runOperationSuit(&sbAdd, generator, batch, "Scalar Addition");
+  ASSERT_NE(std::string::npos, table.find("sAdd"));
+
+  ASSERT_EQ(2, report.size());
+  const auto &r = report.results()[1];
+  ASSERT_EQ(std::string("Scalar Addition"), r.suite);
+  ASSERT_EQ(std::string("length=128"), r.parameters);
+  ASSERT_EQ(std::string("FLOAT"), r.dataType);
+  ASSERT_EQ(5, r.iterations);
+  ASSERT_EQ(128., r.flops);
+  ASSERT_EQ(1024., r.bytes);
+  ASSERT_TRUE(r.minNs <= r.medianNs && r.medianNs <= r.p99Ns && r.p99Ns <= r.maxNs);
+
+  auto json = report.asJson();
+  ASSERT_NE(std::string::npos, json.find("\"name\": \"sAdd\""));
+  ASSERT_NE(std::string::npos, json.find("\"parameters\": \"length=128\""));
+  ASSERT_NE(std::string::npos, json.find("\"p99_ns\""));
+
+  auto csv = report.asCsv();
+  ASSERT_EQ(3, std::count(csv.begin(), csv.end(), '\n'));
+  ASSERT_NE(std::string::npos, csv.find("Scalar Addition,sAdd,length=64,FLOAT"));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(BenchmarkHelperTests, DeclarableReport_1) {
+  BenchmarkReport report;
+  BenchmarkHelper helper(0, 3, &report);
+
+  ParametersBatch batch({});
+  sd::ops::matmul op;
+  DeclarableBenchmark benchmark(op, "matmul", [](Context &ctx) -> double {
+    return 2.0 * ctx.fastpath_out()[0]->lengthOf() * ctx.fastpath_in()[0]->sizeAt(-1);
+  });
+
+  auto generator = PARAMETRIC_D() {
+    auto ctx = new Context(1);
+    ctx->setInputArray(0, NDArrayFactory::create_<float>('c', {4, 8}), true);
+    ctx->setInputArray(1, NDArrayFactory::create_<float>('c', {8, 2}), true);
+    ctx->setOutputArray(0, NDArrayFactory::create_<float>('c', {4, 2}), true);
+    return ctx;
+  };
+
+  helper.runOperationSuit(&benchmark, generator, batch, "MatMul");
+
+  ASSERT_EQ(1, report.size());
+  ASSERT_EQ(128., report.results()[0].flops);
+  ASSERT_EQ(224., report.results()[0].bytes);
+  ASSERT_EQ(std::string("[4, 8]/[8, 2]"), report.results()[0].shape);
+}
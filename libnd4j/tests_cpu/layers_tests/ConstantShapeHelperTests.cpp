@@ -25,6 +25,8 @@
 #include <helpers/PointersManager.h>
 #include <ops/declarable/CustomOperations.h>
 
+#include <thread>
+
 #include "testlayers.h"
 
 using namespace sd;
@@ -74,6 +76,73 @@ TEST_F(ConstantTadHelperTests, test_cachedAmount_1) {
   ASSERT_TRUE(ttlBefore <= ttlMiddle);
 }
 
+TEST_F(ConstantTadHelperTests, test_cachedAmount_2) {
+  auto array = NDArrayFactory::create<float>('c', {3, 5, 7, 11});
+
+  std::vector<sd::LongType> dimsA = {1, 3};
+  std::vector<sd::LongType> dimsB = {3, 1};
+  auto packA = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), &dimsA);
+  auto ttlMiddle = ConstantTadHelper::getInstance().totalCachedEntries();
+
+  // same descriptor (axes get sorted) must be served from cache
+  auto packB = ConstantTadHelper::getInstance().tadForDimensions(array.shapeInfo(), &dimsB);
+  auto ttlAfter = ConstantTadHelper::getInstance().totalCachedEntries();
+
+  ASSERT_EQ(packA, packB);
+  ASSERT_EQ(ttlMiddle, ttlAfter);
+  ASSERT_EQ(21, packA->numberOfTads());
+}
+
+TEST_F(ConstantShapeHelperTests, concurrent_lookup_1) {
+  const int numThreads = 8;
+  const int numShapes = 64;
+  std::vector<std::vector<const sd::LongType *>> results(numThreads, std::vector<const sd::LongType *>(numShapes));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&results, t]() {
+      for (int e = 0; e < numShapes; e++)
+        results[t][e] = ConstantShapeHelper::getInstance().createShapeInfo(
+            sd::DataType::FLOAT32, 'c', {(sd::LongType)e + 1, (sd::LongType)17, (sd::LongType)31});
+    });
+  }
+
+  for (auto &thread : threads) thread.join();
+
+  for (int t = 1; t < numThreads; t++)
+    for (int e = 0; e < numShapes; e++) ASSERT_EQ(results[0][e], results[t][e]);
+}
+
+TEST_F(ConstantShapeHelperTests, raw_lookup_1) {
+  // hits resolved from raw shapeInfo or shape must land on the same entries as descriptors
+  auto &helper = ConstantShapeHelper::getInstance();
+  NDArray x('f', {4, 6, 5}, sd::DataType::DOUBLE);
+  auto view = x({0, 0, 1, 5, 0, 0});
+  NDArray empty('c', {3, 0, 2}, sd::DataType::FLOAT32);
+
+  for (auto shapeInfo : {x.shapeInfo(), view.shapeInfo(), empty.shapeInfo()}) {
+    ShapeDescriptor descriptor(shapeInfo);
+    ASSERT_EQ(std::hash<ShapeDescriptor>()(descriptor), ShapeDescriptor::hashShapeInfo(shapeInfo));
+    ASSERT_TRUE(descriptor.equalsShapeInfo(shapeInfo));
+    ASSERT_EQ(helper.bufferForShapeInfo(&descriptor), helper.bufferForShapeInfo(shapeInfo));
+  }
+
+  const sd::LongType shape[] = {2, 0, 7};
+  for (auto order : {'c', 'f'})
+    for (int rank = 0; rank <= 3; rank++) {
+      ShapeDescriptor descriptor(sd::DataType::INT32, order, shape + 3 - rank, rank);
+      ASSERT_EQ(std::hash<ShapeDescriptor>()(descriptor),
+                ShapeDescriptor::hashShape(sd::DataType::INT32, order, shape + 3 - rank, rank));
+      ASSERT_TRUE(descriptor.equalsShape(sd::DataType::INT32, order, shape + 3 - rank, rank));
+      ASSERT_FALSE(descriptor.equalsShape(sd::DataType::INT64, order, shape + 3 - rank, rank));
+      ASSERT_EQ(helper.bufferForShapeInfo(&descriptor),
+                helper.bufferForShapeInfo(sd::DataType::INT32, order, rank, shape + 3 - rank));
+    }
+
+  ShapeDescriptor strided(x.shapeInfo());
+  ASSERT_FALSE(strided.equalsShapeInfo(view.shapeInfo()));
+}
+
 TEST_F(ConstantShapeHelperTests, basic_test_1) {
   auto ptr = ShapeBuilders::createShapeInfo(sd::DataType::BFLOAT16, 'f', {5, 10, 15});
   ShapeDescriptor descriptor(ptr);
@@ -3902,4 +3902,161 @@ TEST_F(ConvolutionTests1, conv2d_ff_119_2) {
   ASSERT_EQ(sd::Status::OK, status);
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_ff_bp_strided_1) {
+  // results must not depend on memory layout of input/output arrays
+  int bS = 2, iH = 9, iW = 7, iC = 3, oC = 4, kH = 3, kW = 2, sH = 2, sW = 1, pH = 1, pW = 0, dH = 1, dW = 2;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+  int wFormat = 1;      // [oC, iC, kH, kW]
+
+  NDArray input('c', {bS, iH, iW, iC}, sd::DataType::FLOAT32);
+  NDArray weights('c', {oC, iC, kH, kW}, sd::DataType::FLOAT32);
+  NDArray bias('c', {oC}, {0.1, 0.2, 0.3, 0.4}, sd::DataType::FLOAT32);
+  input.linspace(-1., 0.05);
+  weights.linspace(0.3, -0.02);
+
+  std::vector<sd::LongType> iArgs = {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat};
+
+  sd::ops::conv2d op;
+  auto resultsC = op.evaluate({&input, &weights, &bias}, {}, iArgs);
+  auto inputF = input.dup('f');
+  auto resultsF = op.evaluate({&inputF, &weights, &bias}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, resultsC.status());
+  ASSERT_EQ(sd::Status::OK, resultsF.status());
+  ASSERT_TRUE(resultsC.at(0)->equalsTo(resultsF.at(0)));
+
+  NDArray gradO = resultsC.at(0)->ulike();
+  gradO.linspace(0.5, -0.01);
+  auto gradOF = gradO.dup('f');
+
+  sd::ops::conv2d_bp opBP;
+  auto gradsC = opBP.evaluate({&input, &weights, &bias, &gradO}, {}, iArgs);
+  auto gradsF = opBP.evaluate({&inputF, &weights, &bias, &gradOF}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, gradsC.status());
+  ASSERT_EQ(sd::Status::OK, gradsF.status());
+
+  for (int e = 0; e < 3; e++) ASSERT_TRUE(gradsC.at(e)->equalsTo(gradsF.at(e)));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv2d_winograd_1) {
+  // 3x3 stride-1 kernels take Winograd path, results must match direct convolution
+  int bS = 2, iH = 11, iW = 9, iC = 8, oC = 6, kH = 3, kW = 3, sH = 1, sW = 1, pH = 0, pW = 0, dH = 1, dW = 1;
+  sd::ops::conv2d op;
+
+  for (int dataFormat = 0; dataFormat < 2; dataFormat++) {
+    for (int paddingMode = 0; paddingMode < 2; paddingMode++) {
+      std::vector<sd::LongType> inShape = dataFormat ? std::vector<sd::LongType>({bS, iH, iW, iC})
+                                                     : std::vector<sd::LongType>({bS, iC, iH, iW});
+      NDArray input('c', inShape, sd::DataType::FLOAT32);
+      NDArray weights('c', {kH, kW, iC, oC}, sd::DataType::FLOAT32);
+      input.linspace(-2., 0.01);
+      weights.linspace(-0.5, 0.003);
+
+      std::vector<sd::LongType> iArgs = {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, 0};
+
+      sd::Environment::getInstance().setUseWinograd(false);
+      auto expected = op.evaluate({&input, &weights}, {}, iArgs);
+      sd::Environment::getInstance().setUseWinograd(true);
+      auto results = op.evaluate({&input, &weights}, {}, iArgs);
+
+      ASSERT_EQ(sd::Status::OK, expected.status());
+      ASSERT_EQ(sd::Status::OK, results.status());
+      ASSERT_TRUE(expected.at(0)->isSameShape(results.at(0)));
+      ASSERT_TRUE(expected.at(0)->equalsTo(results.at(0), 1e-4));
+
+      // transformed weights are cached, updated weights must not be served stale
+      weights *= -2.f;
+      sd::Environment::getInstance().setUseWinograd(false);
+      auto expected2 = op.evaluate({&input, &weights}, {}, iArgs);
+      sd::Environment::getInstance().setUseWinograd(true);
+      auto results2 = op.evaluate({&input, &weights}, {}, iArgs);
+
+      ASSERT_TRUE(expected2.at(0)->equalsTo(results2.at(0), 1e-4));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, depthwise_conv2d_ff_bp_strided_1) {
+  // 'f' ordered output and gradients must match c ordered ones
+  int bS = 2, iH = 7, iW = 6, iC = 3, mC = 2, kH = 3, kW = 2, sH = 2, sW = 1, pH = 1, pW = 0, dH = 1, dW = 1;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 0;   // 1-NHWC, 0-NCHW
+
+  NDArray input('c', {bS, iC, iH, iW}, sd::DataType::FLOAT32);
+  NDArray weights('c', {kH, kW, iC, mC}, sd::DataType::FLOAT32);
+  NDArray bias('c', {iC * mC}, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6}, sd::DataType::FLOAT32);
+  input.linspace(-1., 0.01);
+  weights.linspace(0.3, -0.02);
+
+  std::vector<sd::LongType> iArgs = {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat};
+
+  sd::ops::depthwise_conv2d op;
+  auto resultsC = op.evaluate({&input, &weights, &bias}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, resultsC.status());
+  NDArray outputF('f', resultsC.at(0)->getShapeAsVector(), sd::DataType::FLOAT32);
+  ASSERT_EQ(sd::Status::OK, op.execute({&input, &weights, &bias}, {&outputF}, {}, iArgs, {}));
+  ASSERT_TRUE(resultsC.at(0)->equalsTo(outputF));
+
+  NDArray gradO = resultsC.at(0)->ulike();
+  gradO.linspace(0.5, -0.01);
+  auto gradOF = gradO.dup('f');
+  NDArray gradIF('f', input.getShapeAsVector(), sd::DataType::FLOAT32);
+  NDArray gradWF('f', weights.getShapeAsVector(), sd::DataType::FLOAT32);
+  NDArray gradBF('f', bias.getShapeAsVector(), sd::DataType::FLOAT32);
+
+  sd::ops::depthwise_conv2d_bp opBP;
+  auto gradsC = opBP.evaluate({&input, &weights, &bias, &gradO}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, gradsC.status());
+  ASSERT_EQ(sd::Status::OK,
+            opBP.execute({&input, &weights, &bias, &gradOF}, {&gradIF, &gradWF, &gradBF}, {}, iArgs, {}));
+
+  ASSERT_TRUE(gradsC.at(0)->equalsTo(gradIF));
+  ASSERT_TRUE(gradsC.at(1)->equalsTo(gradWF));
+  ASSERT_TRUE(gradsC.at(2)->equalsTo(gradBF));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ConvolutionTests1, conv3d_ff_bp_strided_1) {
+  // 'f' ordered output and gradients must match c ordered ones
+  int bS = 2, iD = 5, iH = 6, iW = 4, iC = 2, oC = 3, kD = 2, kH = 2, kW = 2, sD = 1, sH = 2, sW = 1, pD = 0, pH = 0,
+      pW = 0, dD = 1, dH = 1, dW = 1;
+  int paddingMode = 0;  // 1-SAME, 0-VALID;
+  int dataFormat = 0;   // 1-NDHWC, 0-NCDHW
+
+  NDArray input('c', {bS, iC, iD, iH, iW}, sd::DataType::FLOAT32);
+  NDArray weights('c', {kD, kH, kW, iC, oC}, sd::DataType::FLOAT32);
+  NDArray bias('c', {oC}, {0.1, 0.2, 0.3}, sd::DataType::FLOAT32);
+  input.linspace(-1., 0.01);
+  weights.linspace(0.3, -0.02);
+
+  std::vector<sd::LongType> iArgs = {kD, kH, kW, sD, sH, sW, pD, pH, pW, dD, dH, dW, paddingMode, dataFormat};
+
+  sd::ops::conv3dnew op;
+  auto resultsC = op.evaluate({&input, &weights, &bias}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, resultsC.status());
+  NDArray outputF('f', resultsC.at(0)->getShapeAsVector(), sd::DataType::FLOAT32);
+  ASSERT_EQ(sd::Status::OK, op.execute({&input, &weights, &bias}, {&outputF}, {}, iArgs, {}));
+  ASSERT_TRUE(resultsC.at(0)->equalsTo(outputF));
+
+  NDArray gradO = resultsC.at(0)->ulike();
+  gradO.linspace(0.5, -0.01);
+  auto gradOF = gradO.dup('f');
+  NDArray gradIF('f', input.getShapeAsVector(), sd::DataType::FLOAT32);
+  NDArray gradWF('f', weights.getShapeAsVector(), sd::DataType::FLOAT32);
+  NDArray gradBF('f', bias.getShapeAsVector(), sd::DataType::FLOAT32);
+
+  sd::ops::conv3dnew_bp opBP;
+  auto gradsC = opBP.evaluate({&input, &weights, &bias, &gradO}, {}, iArgs);
+  ASSERT_EQ(sd::Status::OK, gradsC.status());
+  ASSERT_EQ(sd::Status::OK,
+            opBP.execute({&input, &weights, &bias, &gradOF}, {&gradIF, &gradWF, &gradBF}, {}, iArgs, {}));
+
+  ASSERT_TRUE(gradsC.at(0)->equalsTo(gradIF));
+  ASSERT_TRUE(gradsC.at(1)->equalsTo(gradWF));
+  ASSERT_TRUE(gradsC.at(2)->equalsTo(gradBF));
+}
+
 #endif  // LIBND4J_CONVOLUTIONTESTS1_H
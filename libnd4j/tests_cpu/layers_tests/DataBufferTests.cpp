@@ -25,6 +25,7 @@
 #include <graph/Variable.h>
 #include <graph/VariableSpace.h>
 #include <helpers/RandomLauncher.h>
+#include <memory/ScratchArena.h>
 #include <ops/declarable/CustomOperations.h>
 #include <ops/declarable/helpers/col2im.h>
 #include <ops/declarable/helpers/convolutions.h>
@@ -75,3 +76,106 @@ TEST_F(DataBufferTests, test_alloc_limit_1) {
   MemoryCounter::getInstance().setDeviceLimit(deviceId, odLimit);
   MemoryCounter::getInstance().setGroupLimit(MemoryType::HOST, odLimit);
 }
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(DataBufferTests, test_scratch_arena_1) {
+  if (!Environment::getInstance().isUseScratchArena()) return;
+
+  // start from empty arena: first op only measures its demand
+  ScratchArena::trim();
+  ASSERT_EQ(0, ScratchArena::statistics().capacity);
+
+  {
+    ScratchArena::Scope scope;
+    DataBuffer buffer(4096, DataType::FLOAT32);
+    ASSERT_TRUE(buffer.primary() != nullptr);
+  }
+
+  auto before = ScratchArena::statistics();
+  ASSERT_TRUE(before.highWaterMark >= 4096);
+  ASSERT_TRUE(before.capacity >= before.highWaterMark);
+
+  {
+    ScratchArena::Scope scope;
+    DataBuffer buffer(4096, DataType::FLOAT32);
+    auto values = reinterpret_cast<float *>(buffer.primary());
+    for (int e = 0; e < 1024; e++) ASSERT_EQ(0.f, values[e]);
+
+    ASSERT_EQ(before.allocations + 1, ScratchArena::statistics().allocations);
+  }
+
+  // outside of op scope nothing goes to arena
+  DataBuffer buffer(4096, DataType::FLOAT32);
+  auto after = ScratchArena::statistics();
+  ASSERT_EQ(before.allocations + 1, after.allocations);
+  ASSERT_TRUE(after.resets > before.resets);
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(DataBufferTests, test_scratch_arena_2) {
+  if (!Environment::getInstance().isUseScratchArena()) return;
+
+  auto input = NDArrayFactory::create<float>('c', {2, 3, 8, 8});
+  auto weights = NDArrayFactory::create<float>('c', {3, 3, 3, 4});
+  input.linspace(0.1, 0.05);
+  weights.linspace(-1., 0.02);
+
+  sd::ops::conv2d op;
+
+  // escaping outputs of the first run must survive arena being reused by later ones
+  auto first = op.evaluate({&input, &weights}, {}, {3, 3, 1, 1, 0, 0, 1, 1, 1, 0});
+  ASSERT_EQ(sd::Status::OK, first.status());
+
+  auto before = ScratchArena::statistics();
+  auto second = op.evaluate({&input, &weights}, {}, {3, 3, 1, 1, 0, 0, 1, 1, 1, 0});
+  ASSERT_EQ(sd::Status::OK, second.status());
+  ASSERT_TRUE(ScratchArena::statistics().allocations > before.allocations);
+
+  Environment::getInstance().setUseScratchArena(false);
+  auto reference = op.evaluate({&input, &weights}, {}, {3, 3, 1, 1, 0, 0, 1, 1, 1, 0});
+  Environment::getInstance().setUseScratchArena(true);
+
+  ASSERT_EQ(*reference.at(0), *first.at(0));
+  ASSERT_EQ(*reference.at(0), *second.at(0));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(DataBufferTests, test_scratch_arena_3) {
+  if (!Environment::getInstance().isUseScratchArena() || !Environment::getInstance().isCPU()) return;
+
+  // arena memory is reported to MemoryCounter when arena grows, and given back when it's trimmed
+  ScratchArena::trim();
+  auto deviceId = AffinityManager::currentDeviceId();
+  auto idle = MemoryCounter::getInstance().allocatedDevice(deviceId);
+
+  {
+    ScratchArena::Scope scope;
+    DataBuffer buffer(1 << 16, DataType::FLOAT32);
+  }
+
+  auto capacity = ScratchArena::statistics().capacity;
+  ASSERT_TRUE(capacity > 0);
+  ASSERT_EQ(idle + capacity, MemoryCounter::getInstance().allocatedDevice(deviceId));
+
+  // escaped block is moved to heap, so arena gets rewound on the next op
+  auto escaped = std::make_shared<DataBuffer>(4096, DataType::FLOAT32);
+  {
+    ScratchArena::Scope scope;
+    escaped = std::make_shared<DataBuffer>(4096, DataType::FLOAT32);
+    reinterpret_cast<float *>(escaped->primary())[7] = 3.f;
+    escaped->detachFromArena();
+  }
+
+  auto before = ScratchArena::statistics();
+  {
+    ScratchArena::Scope scope;
+    DataBuffer buffer(4096, DataType::FLOAT32);
+  }
+  ASSERT_EQ(before.spills, ScratchArena::statistics().spills);
+  ASSERT_TRUE(ScratchArena::statistics().resets > before.resets);
+  ASSERT_EQ(3.f, reinterpret_cast<float *>(escaped->primary())[7]);
+
+  escaped.reset();
+  ScratchArena::trim();
+  ASSERT_EQ(idle, MemoryCounter::getInstance().allocatedDevice(deviceId));
+}
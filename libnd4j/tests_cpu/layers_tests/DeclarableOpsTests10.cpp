@@ -27,6 +27,8 @@
 #include <ops/declarable/helpers/image_resize.h>
 #include <ops/ops.h>
 
+#include <numeric>
+
 #include "testlayers.h"
 
 using namespace sd;
@@ -2041,6 +2043,108 @@ TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressingOverlap_3) {
   ASSERT_EQ(expected,*result);
 }
 
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressing_8) {
+  // overlapping grid of unit boxes, spans several 64-candidate blocks
+  const int numBoxes = 200;
+  NDArray boxes('c', {numBoxes, 4}, sd::DataType::FLOAT32);
+  NDArray scores('c', {numBoxes}, sd::DataType::FLOAT32);
+  for (int i = 0; i < numBoxes; ++i) {
+    const float y = (i % 20) * 0.3f, x = (i / 20) * 0.3f;
+    boxes.p(i, 0, y);
+    boxes.p(i, 1, x);
+    boxes.p(i, 2, y + 1.f);
+    boxes.p(i, 3, x + 1.f);
+    scores.p(i, ((i * 37) % 101) / 101.f);
+  }
+
+  auto iou = [&](int i, int j) -> float {
+    const float h = sd::math::sd_min<float>(boxes.e<float>(i, 2), boxes.e<float>(j, 2)) -
+                    sd::math::sd_max<float>(boxes.e<float>(i, 0), boxes.e<float>(j, 0));
+    const float w = sd::math::sd_min<float>(boxes.e<float>(i, 3), boxes.e<float>(j, 3)) -
+                    sd::math::sd_max<float>(boxes.e<float>(i, 1), boxes.e<float>(j, 1));
+    const float intersection = sd::math::sd_max<float>(h, 0.f) * sd::math::sd_max<float>(w, 0.f);
+    return intersection / (2.f - intersection);
+  };
+
+  std::vector<int> order(numBoxes);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int i, int j) { return scores.e<float>(i) > scores.e<float>(j); });
+
+  std::vector<int> expected;
+  for (auto i : order) {
+    bool keep = true;
+    for (auto j : expected) keep = keep && iou(i, j) <= 0.5f;
+    if (keep) expected.push_back(i);
+  }
+
+  // v2 output length is max output size itself
+  sd::ops::non_max_suppression op;
+  auto results = op.evaluate({&boxes, &scores}, {0.5}, {(sd::LongType)expected.size()});
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_EQ(expected.size(), results.at(0)->lengthOf());
+  for (size_t e = 0; e < expected.size(); ++e) ASSERT_EQ(expected[e], results.at(0)->e<int>(e));
+
+  sd::ops::non_max_suppression_v3 opV3;
+  auto resultsV3 = opV3.evaluate({&boxes, &scores}, {0.5}, {numBoxes});
+  ASSERT_EQ(sd::Status::OK, resultsV3.status());
+  ASSERT_EQ(expected.size(), resultsV3.at(0)->lengthOf());
+  for (size_t e = 0; e < expected.size(); ++e) ASSERT_EQ(expected[e], resultsV3.at(0)->e<int>(e));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, Image_NonMaxSuppressing_9) {
+  // scores of another type than boxes
+  NDArray boxes('c', {6, 4}, {0, 0, 1, 1, 0, 0.1f, 1, 1.1f, 0, -0.1f, 1.f, 0.9f,
+                              0, 10, 1, 11, 0, 10.1f, 1.f, 11.1f, 0, 100, 1, 101},
+                sd::DataType::FLOAT32);
+  NDArray scores('c', {6}, {0.9f, .75f, .6f, .95f, .5f, .3f}, sd::DataType::HALF);
+  NDArray scoresF = scores.cast(sd::DataType::FLOAT32);
+  NDArray expected = NDArrayFactory::create<int>('c', {3}, {3, 0, 5});
+
+  sd::ops::non_max_suppression op;
+  auto results = op.evaluate({&boxes, &scores}, {0.5}, {3});
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_TRUE(expected.equalsTo(results.at(0)));
+
+  sd::ops::non_max_suppression_v3 opV3;
+  auto resultsV3 = opV3.evaluate({&boxes, &scores}, {0.5, 0.4}, {6});
+  auto expectedV3 = opV3.evaluate({&boxes, &scoresF}, {0.5, 0.4}, {6});
+  ASSERT_EQ(sd::Status::OK, resultsV3.status());
+  ASSERT_EQ(sd::Status::OK, expectedV3.status());
+  ASSERT_TRUE(expectedV3.at(0)->isSameShape(resultsV3.at(0)));
+  ASSERT_TRUE(expectedV3.at(0)->equalsTo(resultsV3.at(0)));
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests10, Image_CombinedNonMaxSuppression_1) {
+  NDArray boxes('c', {2, 4, 4},
+                {0.f, 0.f, 0.5f, 0.5f, 0.f, 0.05f, 0.5f, 0.55f, 0.5f, 0.5f, 1.f, 1.f, 0.6f, 0.f, 0.9f, 0.3f,
+                 0.f, 0.f, 0.5f, 0.5f, 0.f, 0.05f, 0.5f, 0.55f, 0.5f, 0.5f, 1.f, 1.f, 0.6f, 0.f, 0.9f, 0.3f},
+                sd::DataType::FLOAT32);
+  NDArray scores('c', {2, 4, 2},
+                 {0.9f, 0.2f, 0.8f, 0.7f, 0.1f, 0.6f, 0.05f, 0.3f, 0.1f, 0.5f, 0.1f, 0.05f, 0.1f, 0.05f, 0.1f, 0.4f},
+                 sd::DataType::FLOAT32);
+
+  NDArray expBoxes('c', {2, 3, 4},
+                   {0.f, 0.f, 0.5f, 0.5f, 0.f, 0.05f, 0.5f, 0.55f, 0.5f, 0.5f, 1.f, 1.f,
+                    0.f, 0.f, 0.5f, 0.5f, 0.6f, 0.f, 0.9f, 0.3f, 0.f, 0.f, 0.f, 0.f},
+                   sd::DataType::FLOAT32);
+  NDArray expScores('c', {2, 3}, {0.9f, 0.7f, 0.6f, 0.5f, 0.4f, 0.f}, sd::DataType::FLOAT32);
+  NDArray expClasses('c', {2, 3}, {0.f, 1.f, 1.f, 1.f, 1.f, 0.f}, sd::DataType::FLOAT32);
+  NDArray expValid('c', {2}, {3, 2}, sd::DataType::INT32);
+
+  // 2 boxes per class at most, 3 detections in total
+  sd::ops::combined_non_max_suppression op;
+  auto results = op.evaluate({&boxes, &scores}, {0.5, 0.15}, {2, 3});
+
+  ASSERT_EQ(sd::Status::OK, results.status());
+  ASSERT_EQ(expBoxes, *results.at(0));
+  ASSERT_EQ(expScores, *results.at(1));
+  ASSERT_EQ(expClasses, *results.at(2));
+  ASSERT_EQ(expValid, *results.at(3));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests10, Image_CropAndResize_1) {
   int axis = 0;
@@ -1306,6 +1306,20 @@ TEST_F(DeclarableOpsTests12, inTopK_5) {
   ASSERT_TRUE(expV.equalsTo(v));
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests12, inTopK_6) {
+  // classes tied at the boundary of top k are all within top k
+  auto x = NDArrayFactory::create<float>('c', {2, 4}, {1.f, 3.f, 3.f, 3.f, 4.f, 2.f, 2.f, 1.f});
+  auto y = NDArrayFactory::create<sd::LongType>('c', {2}, {3, 2});
+  auto expV = NDArrayFactory::create<bool>('c', {2}, {true, true});
+
+  sd::ops::in_top_k op;
+  auto result = op.evaluate({&x, &y}, {}, {2});
+
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_TRUE(expV.equalsTo(result.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests12, cube_1) {
   NDArray x('c', {2, 3}, {1., 2., 3., 4., 5, 6});
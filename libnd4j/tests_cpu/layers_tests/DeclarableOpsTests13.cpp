@@ -390,6 +390,100 @@ TEST_F(DeclarableOpsTests13, BarnesHutTsne_symmetrized_4) {
   ASSERT_TRUE(exp4.equalsTo(res));
 }
 
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_symmetrized_5) {
+  // N below the number of rows, last row is ignored
+  auto rows = NDArrayFactory::create<int>('c', {5}, {0, 2, 3, 5, 6});
+  auto cols = NDArrayFactory::create<int>('c', {6}, {1, 2, 0, 0, 1, 2});
+  auto vals = NDArrayFactory::create<double>('c', {6}, {10., 20., 30., 40., 50., 60.});
+  auto expRows = NDArrayFactory::create<int>('c', {1, 4}, {0, 2, 4, 6});
+  auto expCols = NDArrayFactory::create<int>('c', {1, 6}, {1, 2, 0, 2, 0, 1});
+  auto expVals = NDArrayFactory::create<double>('c', {1, 6}, {20., 30., 20., 25., 30., 25.});
+
+  sd::ops::barnes_symmetrized op;
+  auto result = op.evaluate({&rows, &cols, &vals}, {}, {3});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  ASSERT_TRUE(expRows.equalsTo(result.at(0)));
+  ASSERT_TRUE(expCols.equalsTo(result.at(1)));
+  ASSERT_TRUE(expVals.equalsTo(result.at(2)));
+}
+
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_RepulsiveForces_1) {
+  auto data = NDArrayFactory::create<double>('c', {40, 2});
+  data.linspace(0.1, 0.37);
+  data.applyTransform(transform::Sin, data);
+
+  // theta == 0 never summarizes cells, so result must match all-pairs sums
+  auto exp = NDArrayFactory::create<double>('c', {40, 2});
+  double expSum = 0.;
+  for (int i = 0; i < 40; i++) {
+    for (int j = 0; j < 40; j++) {
+      if (i == j) continue;
+      auto dx = data.e<double>(i, 0) - data.e<double>(j, 0);
+      auto dy = data.e<double>(i, 1) - data.e<double>(j, 1);
+      auto q = 1. / (1. + dx * dx + dy * dy);
+      expSum += q;
+      exp.p(i, 0, exp.e<double>(i, 0) + q * q * dx);
+      exp.p(i, 1, exp.e<double>(i, 1) + q * q * dy);
+    }
+  }
+
+  sd::ops::barnes_repulsive_forces op;
+  auto result = op.evaluate({&data}, {0.}, {});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  ASSERT_TRUE(exp.equalsTo(result.at(0), 1e-8));
+  ASSERT_NEAR(expSum, result.at(1)->e<double>(0), 1e-8);
+
+  auto approx = op.evaluate({&data}, {0.5}, {});
+  ASSERT_EQ(approx.status(), sd::Status::OK);
+  ASSERT_NEAR(expSum, approx.at(1)->e<double>(0), 0.05 * expSum);
+}
+
+TEST_F(DeclarableOpsTests13, BarnesHutTsne_RepulsiveForces_2) {
+  // enough points for the tree to be split into many subtrees that are built and merged in parallel
+  const int n = 600;
+  auto data = NDArrayFactory::create<double>('c', {n, 2});
+  data.linspace(0.1, 0.37);
+  data.applyTransform(transform::Sin, data);
+
+  auto x = data.bufferAsT<double>();
+  auto exp = NDArrayFactory::create<double>('c', {n, 2});
+  auto e = exp.bufferAsT<double>();
+  double expSum = 0.;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      if (i == j) continue;
+      auto dx = x[i * 2] - x[j * 2];
+      auto dy = x[i * 2 + 1] - x[j * 2 + 1];
+      auto q = 1. / (1. + dx * dx + dy * dy);
+      expSum += q;
+      e[i * 2] += q * q * dx;
+      e[i * 2 + 1] += q * q * dy;
+    }
+  }
+
+  sd::ops::barnes_repulsive_forces op;
+  auto exact = op.evaluate({&data}, {0.}, {});
+  ASSERT_EQ(exact.status(), sd::Status::OK);
+  ASSERT_TRUE(exp.equalsTo(exact.at(0), 1e-8));
+  ASSERT_NEAR(expSum, exact.at(1)->e<double>(0), 1e-6);
+
+  // approximated forces must not depend on how the tree was built
+  auto parallel = op.evaluate({&data}, {0.5}, {});
+  ASSERT_EQ(parallel.status(), sd::Status::OK);
+
+  const auto threads = sd::Environment::getInstance().maxThreads();
+  const auto masterThreads = sd::Environment::getInstance().maxMasterThreads();
+  sd::Environment::getInstance().setMaxThreads(1);
+  sd::Environment::getInstance().setMaxMasterThreads(1);
+  auto serial = op.evaluate({&data}, {0.5}, {});
+  sd::Environment::getInstance().setMaxThreads(threads);
+  sd::Environment::getInstance().setMaxMasterThreads(masterThreads);
+
+  ASSERT_EQ(serial.status(), sd::Status::OK);
+  ASSERT_TRUE(serial.at(0)->equalsTo(parallel.at(0), 1e-10));
+  ASSERT_NEAR(serial.at(1)->e<double>(0), parallel.at(1)->e<double>(0), 1e-8);
+}
+
 TEST_F(DeclarableOpsTests13, CellContains_test_1) {
   auto corners = NDArrayFactory::create<double>({0.5384, 0.5640, 0.3449, 0.5257, 0.5505});
   auto width = NDArrayFactory::create<double>({0.4306, 0.3960, 0.4639, 0.5040, 0.4904});
@@ -1247,6 +1247,44 @@ TEST_F(DeclarableOpsTests5, Test_TopK_5) {
   ASSERT_TRUE(expI.equalsTo(i));
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests5, Test_TopK_6) {
+  // equal values are taken in order of their indices
+  auto x = NDArrayFactory::create<float>('c', {2, 6}, {1.f, 5.f, 3.f, 5.f, 3.f, 0.f, 2.f, 2.f, 2.f, 2.f, 2.f, 2.f});
+  auto expV = NDArrayFactory::create<float>('c', {2, 3}, {5.f, 5.f, 3.f, 2.f, 2.f, 2.f});
+  auto expI = NDArrayFactory::create<sd::LongType>('c', {2, 3}, {1, 3, 2, 0, 1, 2});
+
+  sd::ops::top_k op;
+  auto result = op.evaluate({&x}, {}, {3}, {true});
+
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_TRUE(expV.equalsTo(result.at(0)));
+  ASSERT_TRUE(expI.equalsTo(result.at(1)));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests5, Test_TopK_7) {
+  // single wide row
+  const int width = 200000;
+  auto x = NDArrayFactory::create<float>('c', {1, width});
+  for (int e = 0; e < width; e++) x.p(e, static_cast<float>((e * 7919) % width));
+
+  sd::ops::top_k op;
+  auto result = op.evaluate({&x}, {}, {100}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  auto v = result.at(0);
+  auto i = result.at(1);
+  for (int e = 0; e < 100; e++) {
+    ASSERT_EQ(static_cast<float>(width - 1 - e), v->e<float>(e));
+    ASSERT_EQ(v->e<float>(e), x.e<float>(i->e<sd::LongType>(e)));
+  }
+
+  auto unsorted = op.evaluate({&x}, {}, {100}, {false});
+  ASSERT_EQ(sd::Status::OK, unsorted.status());
+  for (int e = 1; e < 100; e++) ASSERT_TRUE(unsorted.at(1)->e<sd::LongType>(e - 1) < unsorted.at(1)->e<sd::LongType>(e));
+}
+
 ///////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests5, Test_Moments_1) {
   auto x = NDArrayFactory::create<double>('c', {2, 3, 4},
@@ -1636,6 +1674,97 @@ TEST_F(DeclarableOpsTests5, EmbeddingLookup_3) {
 ASSERT_EQ(exp,*output);
 }
 
+TEST_F(DeclarableOpsTests5, EmbeddingBag_1) {
+  auto table = NDArrayFactory::create<double>('c', {5, 2}, {1, 2, 11, 12, 21, 22, 31, 32, 41, 42});
+  auto indices = NDArrayFactory::create<int>({1, 3, 3, 0, 4});
+  auto offsets = NDArrayFactory::create<int>({0, 2, 2});  // second bag is empty
+  auto weights = NDArrayFactory::create<double>({1., 0.5, 2., 1., -1.});
+  auto expSum = NDArrayFactory::create<double>('c', {3, 2}, {42, 44, 0, 0, 73, 76});
+  auto expWeighted = NDArrayFactory::create<double>('c', {3, 2}, {26.5, 28, 0, 0, 22, 24});
+
+  sd::ops::embedding_bag op;
+  auto result = op.evaluate({&table, &indices, &offsets}, {}, {0});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expSum, *result.at(0));
+
+  result = op.evaluate({&table, &indices, &offsets, &weights}, {}, {0});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expWeighted, *result.at(0));
+}
+
+TEST_F(DeclarableOpsTests5, EmbeddingBag_2) {
+  auto table = NDArrayFactory::create<float>('c', {5, 2}, {1, 2, 11, 12, 21, 22, 31, 32, 41, 42});
+  auto indices = NDArrayFactory::create<sd::LongType>({0, 2, 4, 2});
+  auto segmentIds = NDArrayFactory::create<int>({1, 0, 1, 1});
+  auto expMean = NDArrayFactory::create<float>('c', {2, 2}, {21, 22, 21, 22});
+  auto expMax = NDArrayFactory::create<float>('c', {2, 2}, {21, 22, 41, 42});
+
+  sd::ops::embedding_bag op;
+  auto result = op.evaluate({&table, &indices, &segmentIds}, {}, {1, 1});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expMean, *result.at(0));
+
+  result = op.evaluate({&table, &indices, &segmentIds}, {}, {2, 1});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expMax, *result.at(0));
+}
+
+TEST_F(DeclarableOpsTests5, EmbeddingBag_bp_1) {
+  auto table = NDArrayFactory::create<double>('c', {5, 2}, {1, 2, 11, 12, 21, 22, 31, 32, 41, 42});
+  auto indices = NDArrayFactory::create<int>({1, 3, 3, 0, 4});
+  auto offsets = NDArrayFactory::create<int>({0, 2, 2});
+  auto weights = NDArrayFactory::create<double>({1., 0.5, 2., 1., -1.});
+  auto eps = NDArrayFactory::create<double>('c', {3, 2}, {1, 2, 3, 4, 5, 6});
+
+  // row 2 isn't looked up, so it is absent from sparse gradient
+  auto expIndices = NDArrayFactory::create<sd::LongType>({0, 1, 3, 4});
+  auto expRows = NDArrayFactory::create<double>('c', {4, 2}, {5, 6, 1, 2, 6, 8, 5, 6});
+  auto expWeightedRows = NDArrayFactory::create<double>('c', {4, 2}, {5, 6, 1, 2, 10.5, 13, -5, -6});
+  auto expGradWeights = NDArrayFactory::create<double>({35, 95, 347, 17, 457});
+
+  sd::ops::embedding_bag_bp op;
+  auto result = op.evaluate({&table, &indices, &offsets, &eps}, {}, {0});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expIndices, *result.at(0));
+  ASSERT_EQ(expRows, *result.at(1));
+
+  result = op.evaluate({&table, &indices, &offsets, &weights, &eps}, {}, {0});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expIndices, *result.at(0));
+  ASSERT_EQ(expWeightedRows, *result.at(1));
+  ASSERT_EQ(expGradWeights, *result.at(2));
+}
+
+TEST_F(DeclarableOpsTests5, EmbeddingBag_bp_2) {
+  auto table = NDArrayFactory::create<float>('c', {5, 2}, {1, 2, 11, 12, 21, 22, 31, 32, 41, 42});
+  auto indices = NDArrayFactory::create<sd::LongType>({0, 2, 4, 2});
+  auto segmentIds = NDArrayFactory::create<int>({1, 0, 1, 1});
+  auto eps = NDArrayFactory::create<float>('c', {2, 2}, {1, 2, 3, 4});
+
+  // max: gradient goes to the row which provided the maximum only
+  auto expIndices = NDArrayFactory::create<sd::LongType>({0, 2, 4});
+  auto expRows = NDArrayFactory::create<float>('c', {3, 2}, {0, 0, 1, 2, 3, 4});
+
+  sd::ops::embedding_bag_bp op;
+  auto result = op.evaluate({&table, &indices, &segmentIds, &eps}, {}, {2, 1});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(expIndices, *result.at(0));
+  ASSERT_EQ(expRows, *result.at(1));
+}
+
+TEST_F(DeclarableOpsTests5, EmbeddingBag_bp_3) {
+  auto table = NDArrayFactory::create<float>('c', {5, 2}, {1, 2, 11, 12, 21, 22, 31, 32, 41, 42});
+  auto indices = NDArrayFactory::create<sd::LongType>({0, 2, 4, 2});
+  auto offsets = NDArrayFactory::create<sd::LongType>({0, 1});
+  auto eps = NDArrayFactory::create<double>('c', {2, 2}, {1, 2, 3, 4});
+  auto uniqueIndices = NDArrayFactory::create<sd::LongType>('c', {3});
+  auto gradRows = NDArrayFactory::create<float>('c', {3, 2});
+
+  // eps of another float type than table is rejected
+  sd::ops::embedding_bag_bp op;
+  ASSERT_ANY_THROW(op.execute({&table, &indices, &offsets, &eps}, {&uniqueIndices, &gradRows}, {}, {0}, {}));
+}
+
 TEST_F(DeclarableOpsTests5, DynamicPartition_01) {
   auto x = NDArrayFactory::create<int>({2, 1, 2, 0});
 
@@ -2131,6 +2131,22 @@ TEST_F(DeclarableOpsTests7, TestSegmentProd_08) {
   ASSERT_TRUE(exp.equalsTo(result.at(0)));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestSegmentProd_09) {
+  auto x = NDArrayFactory::create<float>('c', {4, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+
+  // ----------------------------------------------------------------
+
+  // segments 1 and 3 have no rows, their product is one
+  auto idx = NDArrayFactory::create<int>({0, 0, 2, 4});
+  auto exp = NDArrayFactory::create<float>('c', {5, 3}, {4, 10, 18, 1, 1, 1, 7, 8, 9, 1, 1, 1, 10, 11, 12});
+  sd::ops::segment_prod op;
+
+  auto result = op.evaluate({&x, &idx}, {}, {});
+  ASSERT_EQ(result.status(), sd::Status::OK);
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests7, TestUnsortedSegmentProd_1) {
   auto x = NDArrayFactory::create<double>({1.8, 2.5, 4., 9., 2.1, 2.4, 3., 9., 2.1, 2.1, 0.7, 0.1, 3., 4.2, 2.2, 1.});
@@ -2298,6 +2314,50 @@ TEST_F(DeclarableOpsTests7, TestUnsortedSegmentProdBP_4) {
   ASSERT_TRUE(exp.equalsTo(result.at(0)));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(DeclarableOpsTests7, TestUnsortedSegment_LargeInput_1) {
+  // few segments over many rows, segment 3 is empty
+  const int rows = 20000;
+  auto x = NDArrayFactory::create<float>('c', {rows, 3});
+  auto idx = NDArrayFactory::create<int>('c', {rows});
+  auto gradO = NDArrayFactory::create<float>('c', {4, 3});
+  auto expSum = NDArrayFactory::create<float>('c', {4, 3});
+  auto expMax = NDArrayFactory::create<float>('c', {4, 3});
+  auto expGrad = NDArrayFactory::create<float>('c', {rows, 3});
+  gradO.assign(1.f);
+  expMax.assign(-DataTypeUtils::max<float>());
+
+  std::vector<int> counts(4, 0);
+  for (int i = 0; i < rows; i++) {
+    const int c = (i * 7) % 3;
+    idx.p(i, c);
+    counts[c]++;
+    for (int k = 0; k < 3; k++) {
+      const float v = static_cast<float>((i + k) % 5);
+      x.p(i, k, v);
+      expSum.p(c, k, expSum.e<float>(c, k) + v);
+      if (counts[c] == 1 || v > expMax.e<float>(c, k)) expMax.p(c, k, v);
+    }
+  }
+  for (int i = 0; i < rows; i++)
+    for (int k = 0; k < 3; k++) expGrad.p(i, k, 1.f / counts[idx.e<int>(i)]);
+
+  sd::ops::unsorted_segment_sum opSum;
+  auto resSum = opSum.evaluate({&x, &idx}, {}, {4});
+  ASSERT_EQ(resSum.status(), sd::Status::OK);
+  ASSERT_TRUE(expSum.equalsTo(resSum.at(0)));
+
+  sd::ops::unsorted_segment_max opMax;
+  auto resMax = opMax.evaluate({&x, &idx}, {}, {4});
+  ASSERT_EQ(resMax.status(), sd::Status::OK);
+  ASSERT_TRUE(expMax.equalsTo(resMax.at(0)));
+
+  sd::ops::unsorted_segment_mean_bp opMeanBP;
+  auto resGrad = opMeanBP.evaluate({&x, &idx, &gradO}, {}, {4});
+  ASSERT_EQ(resGrad.status(), sd::Status::OK);
+  ASSERT_TRUE(expGrad.equalsTo(resGrad.at(0)));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TEST_F(DeclarableOpsTests7, TestExtractImagePatches_1) {
   auto x = NDArrayFactory::create<double>(
@@ -20,6 +20,8 @@
 // Created by raver119 on 11.12.17.
 //
 #include <graph/GraphHolder.h>
+#include <graph/Node.h>
+#include <legacy/NativeOps.h>
 
 #include "testlayers.h"
 
@@ -81,3 +83,143 @@ TEST_F(GraphHolderTests, SimpleTests_3) {
 
   delete graph2;
 }
+
+static Graph *sessionGraph() {
+  auto graph = new Graph();
+  graph->getVariableSpace()->putVariable(-1, NDArrayFactory::create_<float>('c', {5, 5}));
+
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+  graph->addNode(new Node(OpType_TRANSFORM_STRICT, transform::Cosine, 2, {1}, {3}));
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {}));
+
+  return graph;
+}
+
+TEST_F(GraphHolderTests, Session_1) {
+  sd::LongType graphId = 121;
+  GraphHolder::getInstance().registerGraph(graphId, sessionGraph());
+
+  auto x = NDArrayFactory::create<float>('c', {5, 5});
+  x.assign(-2.0f);
+
+  sd::Pointer buffers[] = {x.buffer()};
+  sd::Pointer shapes[] = {(sd::Pointer)x.shapeInfo()};
+  int indices[] = {-1};
+
+  auto session = GraphHolder::getInstance().session(graphId);
+  ASSERT_EQ(session, GraphHolder::getInstance().session(graphId));
+  ASSERT_EQ(1, GraphHolder::getInstance().numberOfSessions(graphId));
+
+  ASSERT_EQ(sd::Status::OK, session->execute(buffers, shapes, indices, 1));
+  ASSERT_EQ(1, session->outputs().size());
+
+  auto z = session->outputs().at(0)->getNDArray();
+  auto zBuffer = z->buffer();
+  ASSERT_NEAR(0.4161468, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+  // same shapes: inputs are rebound and output arrays are reused
+  x.assign(-1.0f);
+  ASSERT_EQ(sd::Status::OK, session->execute(buffers, shapes, indices, 1));
+  z = session->outputs().at(0)->getNDArray();
+  ASSERT_EQ(zBuffer, z->buffer());
+  ASSERT_NEAR(0.5403023, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+  ASSERT_EQ(1, session->rebuilds());
+  ASSERT_EQ(2, session->executions());
+
+  // new shape: per-session state is recreated
+  auto y = NDArrayFactory::create<float>('c', {3, 4});
+  y.assign(0.0f);
+  buffers[0] = y.buffer();
+  shapes[0] = (sd::Pointer)y.shapeInfo();
+
+  ASSERT_EQ(sd::Status::OK, session->execute(buffers, shapes, indices, 1));
+  z = session->outputs().at(0)->getNDArray();
+  ASSERT_TRUE(z->isSameShape(y));
+  ASSERT_NEAR(1.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+  ASSERT_EQ(2, session->rebuilds());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+  ASSERT_EQ(0, GraphHolder::getInstance().numberOfSessions(graphId));
+}
+
+TEST_F(GraphHolderTests, Session_2) {
+  sd::LongType graphId = 122;
+  GraphHolder::getInstance().registerGraph(graphId, sessionGraph());
+
+  auto x = NDArrayFactory::create<float>('c', {5, 5});
+  x.assign(-2.0f);
+
+  sd::Pointer buffers[] = {x.buffer()};
+  sd::Pointer shapes[] = {(sd::Pointer)x.shapeInfo()};
+  int indices[] = {-1};
+
+  // stored graph variables must stay untouched by sessions
+  auto original = GraphHolder::getInstance().pullGraph(graphId)->getVariableSpace()->getVariable(-1)->getNDArray();
+
+  for (int e = 0; e < 3; e++) {
+    auto set = executeStoredGraph(nullptr, graphId, buffers, shapes, indices, 1);
+    ASSERT_TRUE(set != nullptr);
+    ASSERT_EQ(sd::Status::OK, getVariablesSetStatus(set));
+    ASSERT_EQ(1, getVariablesSetSize(set));
+
+    auto z = getVariable(set, 0)->getNDArray();
+    ASSERT_NEAR(0.4161468, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+    deleteVariablesSet(set);
+  }
+
+  ASSERT_EQ(original, GraphHolder::getInstance().pullGraph(graphId)->getVariableSpace()->getVariable(-1)->getNDArray());
+  ASSERT_EQ(1, GraphHolder::getInstance().session(graphId)->rebuilds());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+}
+
+TEST_F(GraphHolderTests, Session_3) {
+  sd::LongType graphId = 123;
+
+  auto graph = new Graph();
+  graph->getVariableSpace()->putVariable(-1, NDArrayFactory::create_<float>('c', {5, 5}));
+
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2}));
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 2, {1}, {3}));
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {2}, {4}));
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Neg, 4, {3}, {5}));
+  graph->addNode(new Node(OpType_TRANSFORM_SAME, transform::Abs, 5, {4}, {}));
+
+  GraphHolder::getInstance().registerGraph(graphId, graph);
+
+  auto x = NDArrayFactory::create<float>('c', {5, 5});
+  x.assign(-2.0f);
+
+  sd::Pointer buffers[] = {x.buffer()};
+  sd::Pointer shapes[] = {(sd::Pointer)x.shapeInfo()};
+  int indices[] = {-1};
+
+  auto session = GraphHolder::getInstance().session(graphId);
+  ASSERT_EQ(sd::Status::OK, session->execute(buffers, shapes, indices, 1));
+  ASSERT_NEAR(2.0, session->outputs().at(0)->getNDArray()->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+  // 4 intermediate arrays, but only 2 of them are alive at any layer
+  auto &plan = session->memoryPlan();
+  ASSERT_EQ(4, plan.allocations().size());
+  ASSERT_EQ(4 * 128, plan.naiveSize());
+  ASSERT_EQ(2 * 128, session->arenaSize());
+
+  for (auto &a : plan.allocations())
+    for (auto &b : plan.allocations()) {
+      if (&a == &b || a.first > b.last || b.first > a.last) continue;
+
+      ASSERT_TRUE(a.offset + a.bytes <= b.offset || b.offset + b.bytes <= a.offset);
+    }
+
+  // next calls run within the arena
+  for (int e = 0; e < 2; e++) {
+    x.assign(-3.0f - e);
+    ASSERT_EQ(sd::Status::OK, session->execute(buffers, shapes, indices, 1));
+    ASSERT_NEAR(3.0 + e, session->outputs().at(0)->getNDArray()->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+  }
+
+  ASSERT_EQ(1, session->rebuilds());
+
+  GraphHolder::getInstance().dropGraphAny(graphId);
+}
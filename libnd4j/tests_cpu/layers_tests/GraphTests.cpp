@@ -23,6 +23,7 @@
 #include <flatbuffers/flatbuffers.h>
 #include <graph/Graph.h>
 #include <graph/GraphUtils.h>
+#include <graph/MemoryPlan.h>
 #include <graph/Node.h>
 #include <graph/scheme/graph_generated.h>
 #include <graph/scheme/node_generated.h>
@@ -321,6 +322,59 @@ TEST_F(GraphTests, QuadInput1) {
   delete graph;
 }
 
+TEST_F(GraphTests, QuadInput2) {
+  // same graph as QuadInput1, but independent nodes within each layer are executed concurrently
+  auto graph = new Graph();
+  graph->getExecutorConfiguration()->_executionMode = ExecutionMode_AUTO;
+
+  auto x0 = NDArrayFactory::create_<float>('c', {5, 5});
+  x0->assign(0.0);
+
+  auto x1 = NDArrayFactory::create_<float>('c', {5, 5});
+  x1->assign(-1.0);
+
+  auto x2 = NDArrayFactory::create_<float>('c', {5, 5});
+  x2->assign(-2.0);
+
+  auto x3 = NDArrayFactory::create_<float>('c', {5, 5});
+  x3->assign(-3.0);
+
+  auto z = NDArrayFactory::create_<float>('c', {5, 5});
+  z->assign(119.0);
+
+  graph->getVariableSpace()->putVariable(-1, x0);
+  graph->getVariableSpace()->putVariable(-2, x1);
+  graph->getVariableSpace()->putVariable(-3, x2);
+  graph->getVariableSpace()->putVariable(-4, x3);
+  graph->getVariableSpace()->putVariable(-5, z);
+
+  auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {11});
+  auto nodeB = new Node(OpType_TRANSFORM_SAME, transform::Abs, 2, {-2}, {11});
+  auto nodeC = new Node(OpType_TRANSFORM_SAME, transform::Abs, 3, {-3}, {21});
+  auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {-4}, {21});
+
+  auto nodeP1 = new Node(OpType_PAIRWISE, pairwise::Add, 11, {1, 2}, {31});
+  auto nodeP2 = new Node(OpType_PAIRWISE, pairwise::Add, 21, {3, 4}, {31});
+
+  auto nodeZ = new Node(OpType_PAIRWISE, pairwise::Add, 31, {11, 21}, {-5});
+
+  graph->addNode(nodeA);
+  graph->addNode(nodeB);
+  graph->addNode(nodeC);
+  graph->addNode(nodeD);
+  graph->addNode(nodeP1);
+  graph->addNode(nodeP2);
+  graph->addNode(nodeZ);
+
+  ASSERT_EQ(sd::Status::OK, GraphExecutioner::execute(graph));
+
+  ASSERT_NEAR(5.0, graph->getVariableSpace()->getVariable(21)->getNDArray()->reduceNumber(reduce::Mean).e<float>(0),
+              1e-5);
+  ASSERT_NEAR(6.0, z->reduceNumber(reduce::Mean).e<float>(0), 1e-5);
+
+  delete graph;
+}
+
 TEST_F(GraphTests, InternalBranching1) {
   auto graph = new Graph();
 
@@ -566,6 +620,214 @@ TEST_F(GraphTests, ScalarTest1) {
   delete graph;
 }
 
+TEST_F(GraphTests, FusedElementwiseChain1) {
+  auto graph = new Graph();
+
+  auto x = NDArrayFactory::create_<float>('c', {5, 5});
+  x->assign(-2.0f);
+
+  auto y = NDArrayFactory::create_<float>('c', {5, 5});
+  y->assign(3.0f);
+
+  auto bias = NDArrayFactory::create_<float>('c', {5});
+  for (int e = 0; e < bias->lengthOf(); e++) bias->p(e, -((float)e + 4));
+
+  auto z = NDArrayFactory::create_<float>('c', {5, 5});
+
+  graph->getVariableSpace()->putVariable(-1, x);
+  graph->getVariableSpace()->putVariable(-2, y);
+  graph->getVariableSpace()->putVariable(-3, bias);
+  graph->getVariableSpace()->putVariable(-4, z);
+
+  auto nodeA = new Node(OpType_PAIRWISE, pairwise::Add, 1, {-1, -2}, {2});
+  auto nodeB = new Node(OpType_SCALAR, scalar::Multiply, 2, {1}, {3}, {}, 2.0f);
+  auto nodeC = new Node(OpType_BROADCAST, broadcast::Add, 3, {2, -3}, {4}, {1});
+  auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {3}, {-4});
+
+  graph->addNode(nodeA);
+  graph->addNode(nodeB);
+  graph->addNode(nodeC);
+  graph->addNode(nodeD);
+
+  ASSERT_EQ(4, graph->totalNodes());
+
+  graph->fuseElementwiseChains();
+
+  ASSERT_EQ(1, graph->totalNodes());
+  ASSERT_EQ(OpType_CUSTOM, graph->getMapped()->at(4)->opType());
+
+  GraphExecutioner::execute(graph);
+
+  // |(-2 + 3) * 2 - (e + 4)| = e + 2
+  auto exp = NDArrayFactory::create<float>('c', {5, 5});
+  for (int r = 0; r < 5; r++)
+    for (int e = 0; e < 5; e++) exp.p(r * 5 + e, (float)e + 2);
+
+  ASSERT_TRUE(exp.equalsTo(z));
+
+  delete graph;
+}
+
+TEST_F(GraphTests, FusedElementwiseChain_Broadcast1) {
+  // broadcast ops are numbered differently from their pairwise counterparts used by fused tiles
+  auto graph = new Graph();
+
+  auto x = NDArrayFactory::create_<float>('c', {4, 5});
+  x->assign(6.0f);
+
+  auto b = NDArrayFactory::create_<float>('c', {5});
+  auto m = NDArrayFactory::create_<float>('c', {5});
+  auto d = NDArrayFactory::create_<float>('c', {5});
+  for (int e = 0; e < 5; e++) {
+    b->p(e, (float)e + 1);
+    m->p(e, (float)e + 2);
+    d->p(e, (float)e + 4);
+  }
+
+  auto z = NDArrayFactory::create_<float>('c', {4, 5});
+
+  graph->getVariableSpace()->putVariable(-1, x);
+  graph->getVariableSpace()->putVariable(-2, b);
+  graph->getVariableSpace()->putVariable(-3, m);
+  graph->getVariableSpace()->putVariable(-4, d);
+  graph->getVariableSpace()->putVariable(-5, z);
+
+  auto nodeA = new Node(OpType_BROADCAST, broadcast::Subtract, 1, {-1, -2}, {2}, {1});
+  auto nodeB = new Node(OpType_BROADCAST, broadcast::Multiply, 2, {1, -3}, {3}, {1});
+  auto nodeC = new Node(OpType_BROADCAST, broadcast::Divide, 3, {2, -4}, {4}, {1});
+  auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {3}, {-5});
+
+  graph->addNode(nodeA);
+  graph->addNode(nodeB);
+  graph->addNode(nodeC);
+  graph->addNode(nodeD);
+
+  graph->fuseElementwiseChains();
+
+  ASSERT_EQ(1, graph->totalNodes());
+
+  GraphExecutioner::execute(graph);
+
+  // |(6 - (e + 1)) * (e + 2) / (e + 4)|
+  auto exp = NDArrayFactory::create<float>('c', {4, 5});
+  for (int r = 0; r < 4; r++)
+    for (int e = 0; e < 5; e++) exp.p(r * 5 + e, (5.0f - e) * (e + 2.0f) / (e + 4.0f));
+
+  ASSERT_TRUE(exp.equalsTo(z));
+
+  delete graph;
+}
+
+TEST_F(GraphTests, FusedElementwiseChain_Tiles1) {
+  // 91 x 101 elements take 3 tiles of 40 rows, the last one is a 11 row tail
+  const int rows = 91, cols = 101;
+  auto graph = new Graph();
+
+  auto x = NDArrayFactory::create_<float>('c', {rows, cols});
+  auto y = NDArrayFactory::create_<float>('c', {rows, cols});
+  for (int e = 0; e < rows * cols; e++) {
+    x->p(e, (float)(e % 13) - 6.0f);
+    y->p(e, (float)(e % 7) * 0.5f);
+  }
+
+  auto bias = NDArrayFactory::create_<float>('c', {cols});
+  for (int e = 0; e < cols; e++) bias->p(e, -(float)(e % 10));
+
+  auto z = NDArrayFactory::create_<float>('c', {rows, cols});
+
+  graph->getVariableSpace()->putVariable(-1, x);
+  graph->getVariableSpace()->putVariable(-2, y);
+  graph->getVariableSpace()->putVariable(-3, bias);
+  graph->getVariableSpace()->putVariable(-4, z);
+
+  auto nodeA = new Node(OpType_PAIRWISE, pairwise::Add, 1, {-1, -2}, {2});
+  auto nodeB = new Node(OpType_SCALAR, scalar::Multiply, 2, {1}, {3}, {}, 2.0f);
+  auto nodeC = new Node(OpType_BROADCAST, broadcast::Add, 3, {2, -3}, {4}, {1});
+  auto nodeD = new Node(OpType_TRANSFORM_SAME, transform::Abs, 4, {3}, {-4});
+
+  graph->addNode(nodeA);
+  graph->addNode(nodeB);
+  graph->addNode(nodeC);
+  graph->addNode(nodeD);
+
+  graph->fuseElementwiseChains();
+
+  ASSERT_EQ(1, graph->totalNodes());
+
+  GraphExecutioner::execute(graph);
+
+  auto exp = NDArrayFactory::create<float>('c', {rows, cols});
+  for (int r = 0; r < rows; r++)
+    for (int c = 0; c < cols; c++) {
+      const int e = r * cols + c;
+      exp.p(e, sd::math::sd_abs<float>(((float)(e % 13) - 6.0f + (float)(e % 7) * 0.5f) * 2.0f - (float)(c % 10)));
+    }
+
+  ASSERT_TRUE(exp.equalsTo(z));
+
+  delete graph;
+}
+
+TEST_F(GraphTests, FusedElementwiseChain2) {
+  auto graph = new Graph();
+
+  auto x = NDArrayFactory::create_<float>('c', {5, 5});
+  x->assign(-2.0f);
+
+  auto z0 = NDArrayFactory::create_<float>('c', {5, 5});
+  auto z1 = NDArrayFactory::create_<float>('c', {5, 5});
+
+  graph->getVariableSpace()->putVariable(-1, x);
+  graph->getVariableSpace()->putVariable(-2, z0);
+  graph->getVariableSpace()->putVariable(-3, z1);
+
+  // node 2 result is consumed twice, so it must stay materialized
+  auto nodeA = new Node(OpType_TRANSFORM_SAME, transform::Abs, 1, {-1}, {2});
+  auto nodeB = new Node(OpType_SCALAR, scalar::Add, 2, {1}, {3, 4}, {}, 1.0f);
+  auto nodeC = new Node(OpType_TRANSFORM_SAME, transform::Neg, 3, {2}, {-2});
+  auto nodeD = new Node(OpType_TRANSFORM_FLOAT, transform::Sqrt, 4, {2}, {-3});
+
+  graph->addNode(nodeA);
+  graph->addNode(nodeB);
+  graph->addNode(nodeC);
+  graph->addNode(nodeD);
+
+  graph->fuseElementwiseChains();
+
+  ASSERT_EQ(3, graph->totalNodes());
+  ASSERT_EQ(OpType_CUSTOM, graph->getMapped()->at(2)->opType());
+  ASSERT_EQ(OpType_TRANSFORM_SAME, graph->getMapped()->at(3)->opType());
+
+  GraphExecutioner::execute(graph);
+
+  ASSERT_NEAR(-3.0f, z0->e<float>(0), 1e-5);
+  ASSERT_NEAR(1.7320508f, z1->e<float>(0), 1e-5);
+
+  delete graph;
+}
+
+TEST_F(GraphTests, MemoryPlan1) {
+  MemoryPlan plan;
+
+  auto shapeInfo = ConstantShapeHelper::getInstance().vectorShapeInfo(25, sd::DataType::FLOAT32);
+  plan.addAllocation({1, 0}, shapeInfo, 100, 0, 1);
+  plan.addAllocation({2, 0}, shapeInfo, 200, 1, 2);
+  plan.addAllocation({3, 0}, shapeInfo, 100, 2, 3);
+  plan.addAllocation({4, 0}, shapeInfo, 50, 0, 3);
+
+  plan.assignOffsets();
+
+  auto &a = plan.allocations();
+  ASSERT_EQ(0, a[1].offset);
+  ASSERT_EQ(256, a[0].offset);
+  // lifetimes of the 1st and the 3rd buffers don't overlap, so they share memory
+  ASSERT_EQ(256, a[2].offset);
+  ASSERT_EQ(384, a[3].offset);
+
+  ASSERT_EQ(448, plan.arenaSize());
+  ASSERT_EQ(576, plan.naiveSize());
+}
+
 TEST_F(GraphTests, SymbolicLookupTest1) {
   auto graph = new Graph();
 
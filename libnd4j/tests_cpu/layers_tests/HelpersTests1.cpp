@@ -1506,6 +1506,76 @@ TEST_F(HelpersTests1, mmulHelper_test_7) {
   ASSERT_TRUE(exp.equalsTo(&result));
 }
 
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_8) {
+  // half has no BLAS gemm, sizes straddle the register and cache blocks of the packed gemm
+  const sd::LongType M = 37, K = 300, N = 45;
+  NDArray x('f', {M, K}, sd::DataType::FLOAT32);
+  NDArray y('c', {K, N}, sd::DataType::FLOAT32);
+  for (sd::LongType i = 0; i < x.lengthOf(); ++i) x.p(i, static_cast<float>(i % 3) - 1.f);
+  for (sd::LongType i = 0; i < y.lengthOf(); ++i) y.p(i, static_cast<float>(i % 5) - 2.f);
+
+  auto expected = MmulHelper::mmul(&x, &y, nullptr, 1., 0.);
+
+  auto xH = x.cast(sd::DataType::HALF);
+  auto yH = y.cast(sd::DataType::HALF);
+  auto result = MmulHelper::mmul(&xH, &yH, nullptr, 1., 0.);
+
+  ASSERT_EQ(sd::DataType::HALF, result->dataType());
+  ASSERT_TRUE(expected->isSameShape(result));
+  ASSERT_TRUE(expected->equalsTo(result->cast(sd::DataType::FLOAT32)));
+
+  delete expected;
+  delete result;
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_9) {
+  const sd::LongType M = 70, K = 100, N = 130;
+  NDArray x('c', {M, K}, sd::DataType::FLOAT32);
+  NDArray y('f', {K, N}, sd::DataType::FLOAT32);
+  for (sd::LongType i = 0; i < x.lengthOf(); ++i) x.p(i, static_cast<float>(i % 3) - 1.f);
+  for (sd::LongType i = 0; i < y.lengthOf(); ++i) y.p(i, static_cast<float>(i % 2));
+
+  auto expected = MmulHelper::mmul(&x, &y, nullptr, 1., 0.);
+
+  auto xB = x.cast(sd::DataType::BFLOAT16);
+  auto yB = y.cast(sd::DataType::BFLOAT16);
+  NDArray result('c', {M, N}, sd::DataType::BFLOAT16);
+  MmulHelper::mmul(&xB, &yB, &result, 1., 0.);
+
+  ASSERT_TRUE(expected->equalsTo(result.cast(sd::DataType::FLOAT32)));
+
+  delete expected;
+}
+
+////////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, mmulHelper_test_10) {
+  // transposed view of A, alpha and beta applied
+  const sd::LongType M = 19, K = 260, N = 23;
+  NDArray x('c', {K, M}, sd::DataType::INT32);
+  NDArray y('c', {K, N}, sd::DataType::INT32);
+  x.linspace(-100);
+  y.linspace(-50);
+  auto xT = x.transpose();
+
+  NDArray result('c', {M, N}, sd::DataType::INT32);
+  NDArray expected('c', {M, N}, sd::DataType::INT32);
+  result = 3;
+
+  for (sd::LongType i = 0; i < M; ++i) {
+    for (sd::LongType j = 0; j < N; ++j) {
+      int sum = 0;
+      for (sd::LongType k = 0; k < K; ++k) sum += x.e<int>(k, i) * y.e<int>(k, j);
+      expected.p(i, j, 2 * sum + 3 * 3);
+    }
+  }
+
+  MmulHelper::mmul(&xT, &y, &result, 2., 3.);
+
+  ASSERT_TRUE(expected.equalsTo(result));
+}
+
 ////////////////////////////////////////////////////////////////////
 TEST_F(HelpersTests1, tensordot_test_1) {
   auto a = NDArrayFactory::create<float>('c', {2, 3, 4});
@@ -2588,3 +2658,139 @@ TEST_F(HelpersTests1, lstmLayerCell_3) {
   ASSERT_TRUE(expC.isSameShape(c));
   ASSERT_TRUE(expC.equalsTo(c));
 }
+
+///////////////////////////////////////////////////////////////////
+// per batch element, per time step reference built from lstmLayerCell
+static void lstmLayerTimeLoopReference(const NDArray& x, const NDArray& Wx, const NDArray& Wr, const NDArray& b,
+                                       const NDArray* seqLen, const NDArray& hI, const NDArray& cI, const NDArray& Wp,
+                                       const std::vector<float>& params, const bool forward, NDArray& h, NDArray& hL,
+                                       NDArray& cL) {
+  const int dataFormat = params[0];
+  const int directionMode = params[1];
+  const sd::LongType sL = dataFormat == 0 ? x.sizeAt(0) : x.sizeAt(dataFormat);
+  const sd::LongType bS = dataFormat == 0 ? x.sizeAt(1) : x.sizeAt(0);
+
+  auto alongTimeBatch = [&](const NDArray& arr, const sd::LongType t, const sd::LongType e) -> NDArray {
+    if (dataFormat == 0) return arr({t, t + 1, e, e + 1, 0, 0});
+    if (dataFormat == 1) return arr({e, e + 1, t, t + 1, 0, 0});
+    return arr({e, e + 1, 0, 0, t, t + 1});
+  };
+
+  h.nullify();
+  hL.nullify();
+  cL.nullify();
+
+  for (sd::LongType e = 0; e < bS; ++e) {
+    const sd::LongType limit = seqLen ? seqLen->e<sd::LongType>(e) : sL;
+    if (limit == 0) continue;
+
+    NDArray hPrev = hI({e, e + 1, 0, 0}).dup();
+    NDArray cPrev = cI({e, e + 1, 0, 0}).dup();
+    NDArray hNext = hPrev.ulike();
+    NDArray cNext = cPrev.ulike();
+
+    for (sd::LongType k = 0; k < limit; ++k) {
+      sd::LongType t = k;
+      if (!forward) t = seqLen && directionMode != 1 ? limit - 1 - k : sL - 1 - k;
+
+      NDArray xt = alongTimeBatch(x, t, e).dup();
+      sd::ops::helpers::lstmLayerCell(&xt, &Wx, &Wr, &b, &hPrev, &cPrev, &Wp, params, &hNext, &cNext);
+      alongTimeBatch(h, t, e).assign(hNext);
+      hPrev.assign(hNext);
+      cPrev.assign(cNext);
+    }
+
+    hL({e, e + 1, 0, 0}).assign(hPrev);
+    cL({e, e + 1, 0, 0}).assign(cPrev);
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, lstmLayerTimeLoop_1) {
+  const int sL = 5;
+  const int bS = 3;
+  const int nIn = 4;
+  const int nOut = 3;
+
+  // dataFormat = 1 [bS, sL, nIn], forward, clipping 1.5, sigmoid gates, tanh cell, softplus output
+  std::vector<float> params = {1, 0, 1.5, 2, 0, 0, 0, 0, 0, 10, 0, 0};
+
+  NDArray x('c', {bS, sL, nIn}, sd::DataType::FLOAT32);
+  NDArray Wx('c', {nIn, 4 * nOut}, sd::DataType::FLOAT32);
+  NDArray Wr('c', {nOut, 4 * nOut}, sd::DataType::FLOAT32);
+  NDArray b('c', {4 * nOut}, sd::DataType::FLOAT32);
+  NDArray hI('c', {bS, nOut}, sd::DataType::FLOAT32);
+  NDArray cI('c', {bS, nOut}, sd::DataType::FLOAT32);
+  NDArray Wp('c', {3 * nOut}, sd::DataType::FLOAT32);
+  NDArray seqLen('c', {bS}, {5, 2, 0}, sd::DataType::INT64);
+
+  x.linspace(-1., 0.04);
+  Wx.linspace(-0.5, 0.02);
+  Wr.linspace(0.3, -0.015);
+  b.linspace(-0.1, 0.03);
+  hI.linspace(0.1, 0.05);
+  cI.linspace(-0.4, 0.1);
+  Wp.linspace(0.2, -0.03);
+
+  NDArray h('c', {bS, sL, nOut}, sd::DataType::FLOAT32);
+  NDArray hL('c', {bS, nOut}, sd::DataType::FLOAT32);
+  NDArray cL('c', {bS, nOut}, sd::DataType::FLOAT32);
+  NDArray expH = h.ulike(), expHL = hL.ulike(), expCL = cL.ulike();
+
+  lstmLayerTimeLoopReference(x, Wx, Wr, b, &seqLen, hI, cI, Wp, params, true, expH, expHL, expCL);
+  sd::ops::helpers::lstmLayerTimeLoop(&x, &Wx, &Wr, &b, &seqLen, &hI, &cI, &Wp, params, true, &h, &hL, &cL);
+
+  ASSERT_TRUE(expH.equalsTo(h, 1e-5));
+  ASSERT_TRUE(expHL.equalsTo(hL, 1e-5));
+  ASSERT_TRUE(expCL.equalsTo(cL, 1e-5));
+}
+
+///////////////////////////////////////////////////////////////////
+TEST_F(HelpersTests1, lstmLayerTimeLoop_2) {
+  const int sL = 4;
+  const int bS = 3;
+  const int nIn = 2;
+  const int nOut = 5;
+
+  NDArray x('c', {sL, bS, nIn}, sd::DataType::DOUBLE);
+  NDArray Wx('c', {nIn, 4 * nOut}, sd::DataType::DOUBLE);
+  NDArray Wr('c', {nOut, 4 * nOut}, sd::DataType::DOUBLE);
+  NDArray b('c', {4 * nOut}, sd::DataType::DOUBLE);
+  NDArray hI('c', {bS, nOut}, sd::DataType::DOUBLE);
+  NDArray cI('c', {bS, nOut}, sd::DataType::DOUBLE);
+  NDArray Wp('c', {3 * nOut}, sd::DataType::DOUBLE);
+  NDArray seqLen('c', {bS}, {1, 4, 3}, sd::DataType::INT32);
+
+  x.linspace(0.5, -0.03);
+  Wx.linspace(-0.3, 0.01);
+  Wr.linspace(0.25, -0.005);
+  b.linspace(0.1, -0.01);
+  hI.linspace(-0.2, 0.03);
+  cI.linspace(0.3, -0.04);
+  Wp.linspace(-0.1, 0.02);
+
+  NDArray h('c', {sL, bS, nOut}, sd::DataType::DOUBLE);
+  NDArray hL('c', {bS, nOut}, sd::DataType::DOUBLE);
+  NDArray cL('c', {bS, nOut}, sd::DataType::DOUBLE);
+  NDArray expH = h.ulike(), expHL = hL.ulike(), expCL = cL.ulike();
+
+  // backward pass in both direction modes: hard sigmoid gates, scaled tanh cell, leaky relu output
+  for (float directionMode : {1.f, 2.f}) {
+    std::vector<float> params = {0, directionMode, 0, 7, 0, 0, 6, 1.5, 0.7, 4, 0.2, 0};
+
+    lstmLayerTimeLoopReference(x, Wx, Wr, b, &seqLen, hI, cI, Wp, params, false, expH, expHL, expCL);
+    sd::ops::helpers::lstmLayerTimeLoop(&x, &Wx, &Wr, &b, &seqLen, &hI, &cI, &Wp, params, false, &h, &hL, &cL);
+
+    ASSERT_TRUE(expH.equalsTo(h));
+    ASSERT_TRUE(expHL.equalsTo(hL));
+    ASSERT_TRUE(expCL.equalsTo(cL));
+
+    // without seqLen
+    lstmLayerTimeLoopReference(x, Wx, Wr, b, nullptr, hI, cI, Wp, params, false, expH, expHL, expCL);
+    sd::ops::helpers::lstmLayerTimeLoop(&x, &Wx, &Wr, &b, nullptr, &hI, &cI, &Wp, params, false, &h, &hL, &cL);
+
+    ASSERT_TRUE(expH.equalsTo(h));
+    ASSERT_TRUE(expHL.equalsTo(hL));
+    ASSERT_TRUE(expCL.equalsTo(cL));
+  }
+}
@@ -1866,3 +1866,54 @@ TEST_F(MultiDataTypeTests, assign_2) {
 
   ASSERT_TRUE(expected.equalsTo(&y));
 }
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(MultiDataTypeTests, reduce_sum_half_long_1) {
+  // sequential accumulation in HALF would stall at 256 here
+  const sd::LongType length = 100000;
+  NDArray x('c', {length}, sd::DataType::HALF);
+  x.assign(0.1f);
+
+  const float expected = static_cast<float>(length) * x.e<float>(0);
+
+  NDArray sum = x.reduceNumber(reduce::Sum);
+  NDArray mean = x.reduceNumber(reduce::Mean);
+
+  ASSERT_EQ(sd::DataType::HALF, sum.dataType());
+  ASSERT_NEAR(expected, sum.e<float>(0), 8.f);
+  ASSERT_NEAR(x.e<float>(0), mean.e<float>(0), 1e-3f);
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(MultiDataTypeTests, reduce_sum_bfloat16_long_1) {
+  const sd::LongType length = 50000;
+  NDArray x('c', {4, length}, sd::DataType::BFLOAT16);
+  x.assign(0.1f);
+
+  const float expected = static_cast<float>(length) * x.e<float>(0);
+
+  std::vector<sd::LongType> dims = {1};
+  NDArray sum = x.reduceAlongDimension(reduce::Sum, &dims);
+  NDArray asum = x.reduceAlongDimension(reduce::ASum, &dims);
+
+  for (sd::LongType e = 0; e < 4; e++) {
+    ASSERT_NEAR(expected, sum.e<float>(e), 32.f);
+    ASSERT_NEAR(expected, asum.e<float>(e), 32.f);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(MultiDataTypeTests, reduce_sum_thread_count_1) {
+  // summation tree must not depend on the number of threads, single thread included
+  NDArray x('c', {100003}, sd::DataType::FLOAT32);
+  x.linspace(0.1, 0.37);
+  x.applyTransform(transform::Sin, x);
+
+  const auto threads = sd::Environment::getInstance().maxThreads();
+  sd::Environment::getInstance().setMaxThreads(1);
+  const float serial = x.reduceNumber(reduce::Sum).e<float>(0);
+  sd::Environment::getInstance().setMaxThreads(threads);
+  const float parallel = x.reduceNumber(reduce::Sum).e<float>(0);
+
+  ASSERT_EQ(serial, parallel);
+}
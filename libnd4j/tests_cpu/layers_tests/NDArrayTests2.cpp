@@ -20,6 +20,7 @@
 // Created by raver119 on 21.11.17.
 //
 #include <array/NDArray.h>
+#include <array/NumpyIO.h>
 #include <helpers/DebugHelper.h>
 #include <ops/declarable/headers/parity_ops.h>
 
@@ -1199,3 +1200,87 @@ TEST_F(NDArrayTest2, test_numpy_import_1) {
 
   ASSERT_EQ(exp, array);
 }
+
+TEST_F(NDArrayTest2, test_numpy_mmap_1) {
+  std::string fname("./resources/arr_3,4_float32.npy");
+  auto exp = NDArrayFactory::create<float>('c', {3, 4});
+  exp.linspace(0);
+
+  auto array = NDArrayFactory::mapNpyFile(fname.c_str());
+  ASSERT_EQ(exp, array);
+
+  // mapping is private, so in-place updates don't reach the file
+  array.applyScalar(scalar::Add, 1.f, array);
+  ASSERT_EQ(exp + 1.f, array);
+  ASSERT_EQ(exp, NDArrayFactory::mapNpyFile(fname.c_str()));
+}
+
+TEST_F(NDArrayTest2, test_numpy_writer_1) {
+  std::string fname("./numpy_writer_1.npy");
+  auto chunk = NDArrayFactory::create<double>('c', {2, 3});
+  chunk.linspace(1);
+
+  {
+    NpyWriter writer(fname.c_str(), sd::DataType::FLOAT32, {-1, 3});
+    for (int e = 0; e < 5; e++) writer.write(chunk);
+  }
+
+  auto array = NDArrayFactory::mapNpyFile(fname.c_str());
+  ASSERT_EQ(sd::DataType::FLOAT32, array.dataType());
+  ASSERT_EQ(std::vector<sd::LongType>({10, 3}), array.getShapeAsVector());
+  ASSERT_NEAR(6.f, array.e<float>(9, 2), 1e-5);
+
+  std::remove(fname.c_str());
+}
+
+TEST_F(NDArrayTest2, test_numpy_npz_1) {
+  NpzArchive archive("./resources/arrays_deflated.npz");
+  ASSERT_EQ(2, archive.size());
+  ASSERT_TRUE(archive.contains("a"));
+  ASSERT_FALSE(archive.contains("c"));
+
+  // stored entry
+  auto expA = NDArrayFactory::create<float>('c', {3, 4});
+  expA.linspace(0);
+  ASSERT_EQ(expA, archive.array("a"));
+
+  // deflated entry
+  auto b = archive.array("b");
+  ASSERT_EQ(sd::DataType::INT64, b.dataType());
+  ASSERT_EQ(100, b.lengthOf());
+  for (int e = 0; e < 100; e++) ASSERT_EQ(e % 7, b.e<sd::LongType>(e));
+}
+
+TEST_F(NDArrayTest2, test_numpy_npz_broken_zip64_1) {
+  std::string fname("./numpy_npz_broken_zip64_1.npz");
+  auto put = [](std::vector<char> &v, size_t pos, uint64_t value, int bytes) {
+    for (int e = 0; e < bytes; e++) v[pos + e] = static_cast<char>((value >> (8 * e)) & 0xFF);
+  };
+
+  // single central directory entry, uncompressed size saturated, but zip64 extra field holds 4 bytes only
+  const std::string name("a.npy");
+  std::vector<char> zip(46 + name.size() + 8 + 22, 0);
+  put(zip, 0, 0x02014b50, 4);
+  put(zip, 20, 16, 4);
+  put(zip, 24, 0xFFFFFFFFULL, 4);
+  put(zip, 28, name.size(), 2);
+  put(zip, 30, 8, 2);
+  memcpy(zip.data() + 46, name.data(), name.size());
+  put(zip, 46 + name.size(), 0x0001, 2);
+  put(zip, 46 + name.size() + 2, 4, 2);
+
+  const auto eocd = 46 + name.size() + 8;
+  put(zip, eocd, 0x06054b50, 4);
+  put(zip, eocd + 8, 1, 2);
+  put(zip, eocd + 10, 1, 2);
+  put(zip, eocd + 12, eocd, 4);
+
+  auto file = fopen(fname.c_str(), "wb");
+  ASSERT_TRUE(file != nullptr);
+  ASSERT_EQ(zip.size(), fwrite(zip.data(), 1, zip.size(), file));
+  fclose(file);
+
+  ASSERT_ANY_THROW(NpzArchive archive(fname.c_str()));
+
+  std::remove(fname.c_str());
+}
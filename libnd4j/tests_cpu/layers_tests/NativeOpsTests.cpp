@@ -944,7 +944,7 @@ TEST_F(NativeOpsTests, TadPackTest_1) {
   auto x = NDArrayFactory::create<sd::LongType>('c', {2, 3, 4});
   sd::TadPack *pack = ::tadOnlyShapeInfo(x.shapeInfo(), dimension, dimensionLength);
   ASSERT_TRUE(pack != nullptr);
-  delete pack;
+  deleteTadPack(pack);
 }
 
 TEST_F(NativeOpsTests, AverageTest_1) {
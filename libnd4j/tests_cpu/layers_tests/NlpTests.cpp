@@ -317,6 +317,81 @@ TEST_F(NlpTests, test_sg_ns_batch_1) {
   ASSERT_EQ(sd::Status::OK, result.status());
 }
 
+TEST_F(NlpTests, test_sg_ns_batch_shared_1) {
+  // three pairs sharing positive word 5 form one window
+  auto target = NDArrayFactory::create<int>('c', {3}, {0, 1, 2});
+  auto ngStarter = NDArrayFactory::create<int>('c', {3}, {5, 5, 5});
+  auto indices = NDArrayFactory::empty<int>();
+  auto codes = NDArrayFactory::empty<int8_t>();
+  auto syn0 = NDArrayFactory::create<float>('c', {100, 10});
+  auto syn1Neg = NDArrayFactory::create<float>('c', {100, 10});
+  auto syn1 = NDArrayFactory::empty<float>();
+  auto expTable = NDArrayFactory::create<float>('c', {10000});
+  auto negTable = NDArrayFactory::create<float>('c', {100000});
+
+  auto alpha = NDArrayFactory::create<double>('c', {3}, {0.025, 0.025, 0.025});
+  auto randomValue = NDArrayFactory::create<sd::LongType>('c', {3}, {1L, 3L, 5L});
+  auto inferenceVector = NDArrayFactory::empty<float>();
+
+  syn0.assign(0.01);
+  syn1Neg.assign(0.02);
+  expTable.assign(0.5);
+  negTable.linspace(0.0);
+
+  sd::ops::skipgram op;
+  auto result = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0, &syn1, &syn1Neg, &expTable, &negTable,
+                             &alpha, &randomValue, &inferenceVector},
+                            {}, {4, 1}, {false, true, true}, {}, true);
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  // every pair pushes the positive row by (1 - 0.5) * alpha * 0.01, all computed from the same old rows
+  auto exp = NDArrayFactory::create<float>('c', {1, 10});
+  exp.assign(0.020375f);
+
+  auto row = syn1Neg({5, 6, 0, 0}, true);
+  ASSERT_TRUE(exp.equalsTo(row, 1e-6));
+}
+
+TEST_F(NlpTests, test_sg_ns_batch_shared_2) {
+  // windows of a single pair with one negative each train exactly like regular mode
+  auto target = NDArrayFactory::create<int>('c', {3}, {0, 1, 2});
+  auto ngStarter = NDArrayFactory::create<int>('c', {3}, {5, 6, 7});
+  auto indices = NDArrayFactory::empty<int>();
+  auto codes = NDArrayFactory::empty<int8_t>();
+  auto syn1 = NDArrayFactory::empty<float>();
+  auto expTable = NDArrayFactory::create<float>('c', {10000});
+  auto negTable = NDArrayFactory::create<float>('c', {100000});
+
+  auto alpha = NDArrayFactory::create<double>('c', {3}, {0.025, 0.02, 0.015});
+  auto randomValue = NDArrayFactory::create<sd::LongType>('c', {3}, {1L, 3L, 5L});
+  auto inferenceVector = NDArrayFactory::empty<float>();
+
+  expTable.linspace(0.0, 1.0 / 10000);
+  negTable.linspace(0.0);
+
+  auto syn0A = NDArrayFactory::create<float>('c', {100, 10});
+  auto syn1NegA = NDArrayFactory::create<float>('c', {100, 10});
+  syn0A.linspace(0.0, 0.0001);
+  syn1NegA.linspace(0.0, 0.0002);
+
+  auto syn0B = syn0A.dup();
+  auto syn1NegB = syn1NegA.dup();
+
+  sd::ops::skipgram op;
+  auto resultA = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0A, &syn1, &syn1NegA, &expTable, &negTable,
+                              &alpha, &randomValue, &inferenceVector},
+                             {}, {4, 1}, {false, true, false}, {}, true);
+  ASSERT_EQ(sd::Status::OK, resultA.status());
+
+  auto resultB = op.evaluate({&target, &ngStarter, &indices, &codes, &syn0B, &syn1, &syn1NegB, &expTable, &negTable,
+                              &alpha, &randomValue, &inferenceVector},
+                             {}, {4, 1}, {false, true, true}, {}, true);
+  ASSERT_EQ(sd::Status::OK, resultB.status());
+
+  ASSERT_TRUE(syn0A.equalsTo(syn0B, 1e-6));
+  ASSERT_TRUE(syn1NegA.equalsTo(syn1NegB, 1e-6));
+}
+
 TEST_F(NlpTests, test_cbow_hs_batch_1) {
 #ifdef __CUDABLAS__
   return;
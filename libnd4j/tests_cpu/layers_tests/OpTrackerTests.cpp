@@ -21,6 +21,7 @@
 //
 #include <graph/Graph.h>
 #include <graph/Node.h>
+#include <helpers/ExecutionTracer.h>
 #include <helpers/OpTracker.h>
 #include <ops/declarable/CustomOperations.h>
 
@@ -63,3 +64,53 @@ TEST_F(OpTrackerTests, Test_Ops_List_1) {
     }
   }
 }
+
+TEST_F(OpTrackerTests, Test_Execution_Trace_1) {
+  auto x = NDArrayFactory::create<float>('c', {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  sd::ops::reduce_sum op;
+
+  Environment::getInstance().setTracing(true);
+  Environment::getInstance().setTraceSampling(1);
+  ExecutionTracer::getInstance().purge();
+
+  for (int e = 0; e < 8; e++) {
+    auto result = op.evaluate({&x}, {}, {1});
+    ASSERT_EQ(sd::Status::OK, result.status());
+  }
+
+  auto events = ExecutionTracer::getInstance().events();
+  int numSum = 0;
+  for (const auto &event : events) {
+    if (event.nameHash != static_cast<uint64_t>(op.getOpHash())) continue;
+
+    numSum++;
+    ASSERT_TRUE(event.end >= event.start);
+    ASSERT_EQ(ExecutionTracer::OP, event.kind);
+    // output array is allocated within execution, no workspace involved
+    ASSERT_TRUE(event.bytes >= 2 * static_cast<int64_t>(sizeof(float)));
+  }
+  ASSERT_EQ(8, numSum);
+
+  auto json = ExecutionTracer::getInstance().toChromeJson();
+  ASSERT_TRUE(json.find("\"reduce_sum\"") != std::string::npos);
+
+  // Trace.packet is field 1, length-delimited
+  auto perfetto = ExecutionTracer::getInstance().toPerfetto();
+  ASSERT_FALSE(perfetto.empty());
+  ASSERT_EQ(0x0a, perfetto[0]);
+
+  // only every 4th execution is kept now
+  Environment::getInstance().setTraceSampling(4);
+  ExecutionTracer::getInstance().purge();
+  for (int e = 0; e < 8; e++) op.evaluate({&x}, {}, {1});
+
+  numSum = 0;
+  for (const auto &event : ExecutionTracer::getInstance().events())
+    if (event.nameHash == static_cast<uint64_t>(op.getOpHash())) numSum++;
+
+  Environment::getInstance().setTraceSampling(1);
+  Environment::getInstance().setTracing(false);
+  ExecutionTracer::getInstance().purge();
+
+  ASSERT_EQ(2, numSum);
+}
@@ -1604,3 +1604,66 @@ TEST_F(ParityOpsTests, scatter_update_4) {
   ASSERT_TRUE(exp.equalsTo(x));
 }
 
+//////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatter_add_duplicates_lock_1) {
+  // many duplicates per row on small output
+  NDArray input('c', {50, 32}, sd::DataType::FLOAT32);
+  NDArray indices('c', {1000}, sd::DataType::INT32);
+  NDArray updates('c', {1000, 32}, sd::DataType::FLOAT32);
+  NDArray exp('c', {50, 32}, sd::DataType::FLOAT32);
+
+  input.linspace(1);
+  updates.assign(0.5f);
+  for (int i = 0; i < 1000; ++i) indices.p(i, (i * 7) % 50);
+  exp.linspace(11);
+
+  sd::ops::scatter_add op;
+  auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(exp, *result.at(0));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatter_upd_duplicates_lock_1) {
+  // last update of each row wins, as with serial execution
+  NDArray input('c', {64, 16}, sd::DataType::INT32);
+  NDArray indices('c', {1024}, sd::DataType::INT64);
+  NDArray updates('c', {1024, 16}, sd::DataType::INT32);
+  NDArray exp('c', {64, 16}, sd::DataType::INT32);
+
+  input.assign(-1);
+  for (int i = 0; i < 1024; ++i) {
+    indices.p(i, i % 64);
+    updates({i, i + 1, 0, 0}).assign(i);
+  }
+  for (int r = 0; r < 64; ++r) exp({r, r + 1, 0, 0}).assign(960 + r);
+
+  sd::ops::scatter_upd op;
+  auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(exp, *result.at(0));
+}
+
+//////////////////////////////////////////////////////////////////////
+TEST_F(ParityOpsTests, scatterND_add_duplicates_lock_1) {
+  // output much larger than number of updates, each destination repeated 25 times
+  NDArray input('c', {100, 100, 4}, sd::DataType::DOUBLE);
+  NDArray indices('c', {2500, 2}, sd::DataType::INT32);
+  NDArray updates('c', {2500, 4}, sd::DataType::DOUBLE);
+  NDArray exp('c', {100, 100, 4}, sd::DataType::DOUBLE);
+
+  input.assign(1.);
+  updates.assign(2.);
+  exp.assign(1.);
+  for (int i = 0; i < 2500; ++i) {
+    const int r = (i * 13) % 100, c = (i * 17) % 100;
+    indices.p(2 * i, r);
+    indices.p(2 * i + 1, c);
+    exp({r, r + 1, c, c + 1, 0, 0}) += 2.;
+  }
+
+  sd::ops::scatter_nd_add op;
+  auto result = op.evaluate({&input, &indices, &updates}, {}, {}, {true});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(exp, *result.at(0));
+}
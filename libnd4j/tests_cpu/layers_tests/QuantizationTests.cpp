@@ -21,7 +21,9 @@
 //
 
 #include <array/NDArray.h>
+#include <helpers/MmulHelper.h>
 #include <loops/type_conversions.h>
+#include <ops/declarable/CustomOperations.h>
 
 #include "testlayers.h"
 
@@ -66,3 +68,282 @@ TEST_F(QuantizationTests, Compression_Test_1) {
 
 #endif
 }
+
+// deterministic values spread over [lo, lo + 254]
+static void fillQuantized(NDArray &array, const int seed, const int lo = -127) {
+  for (sd::LongType e = 0; e < array.lengthOf(); e++) array.p(e, static_cast<int>((e * 37 + seed * 11) % 255) + lo);
+}
+
+static NDArray dequantized(const NDArray &q, const float scale, const int zeroPoint) {
+  NDArray result('c', q.getShapeAsVector(), sd::DataType::FLOAT32);
+  for (sd::LongType e = 0; e < q.lengthOf(); e++) result.p(e, (q.e<int>(e) - zeroPoint) * scale);
+  return result;
+}
+
+TEST_F(QuantizationTests, QuantizeLinear_1) {
+  auto x = NDArrayFactory::create<float>('c', {7}, {-1.f, -0.5f, 0.f, 0.25f, 0.5f, 1.f, 2.f});
+  auto scale = NDArrayFactory::create<float>(0.01f);
+  auto zeroPoint = NDArrayFactory::create<int>(0);
+  auto zeroPointU = NDArrayFactory::create<int>(128);
+
+  NDArray exp('c', {7}, {-100, -50, 0, 25, 50, 100, 127}, sd::DataType::INT8);
+  NDArray expU('c', {7}, {28, 78, 128, 153, 178, 228, 255}, sd::DataType::UINT8);
+
+  sd::ops::quantize_linear op;
+  auto result = op.evaluate({&x, &scale, &zeroPoint}, {}, {});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_EQ(sd::DataType::INT8, result.at(0)->dataType());
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+
+  auto resultU = op.evaluate({&x, &scale, &zeroPointU}, {}, {}, {}, {sd::DataType::UINT8});
+  ASSERT_EQ(sd::Status::OK, resultU.status());
+  ASSERT_EQ(sd::DataType::UINT8, resultU.at(0)->dataType());
+  ASSERT_TRUE(expU.equalsTo(resultU.at(0)));
+}
+
+TEST_F(QuantizationTests, QuantizeLinear_2) {
+  auto x = NDArrayFactory::create<float>('c', {2, 3}, {1.f, 2.f, 3.f, -1.f, -2.f, -3.f});
+  auto scale = NDArrayFactory::create<float>('c', {3}, {0.1f, 0.2f, 0.5f});
+  auto zeroPoint = NDArrayFactory::create<int>('c', {3}, {0, 10, -5});
+
+  NDArray exp('c', {2, 3}, {10, 20, 1, -10, 0, -11}, sd::DataType::INT8);
+
+  sd::ops::quantize_linear op;
+  auto result = op.evaluate({&x, &scale, &zeroPoint}, {}, {1});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+
+  sd::ops::dequantize_linear dop;
+  auto back = dop.evaluate({result.at(0), &scale, &zeroPoint}, {}, {-1});
+  ASSERT_EQ(sd::Status::OK, back.status());
+  ASSERT_EQ(sd::DataType::FLOAT32, back.at(0)->dataType());
+  ASSERT_TRUE(x.equalsTo(back.at(0), 1e-5));
+}
+
+TEST_F(QuantizationTests, DequantizeLinear_1) {
+  NDArray q('c', {2, 3}, {1, 3, -1, -2, 2, 6}, sd::DataType::INT8);
+  auto scale = NDArrayFactory::create<float>('c', {2}, {0.5f, 0.25f});
+  auto zeroPoint = NDArrayFactory::create<int>('c', {2}, {1, -2});
+
+  auto exp = NDArrayFactory::create<double>('c', {2, 3}, {0., 1., -1., 0., 1., 2.});
+
+  sd::ops::dequantize_linear op;
+  auto result = op.evaluate({&q, &scale, &zeroPoint}, {}, {0}, {}, {sd::DataType::DOUBLE});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  ASSERT_TRUE(exp.isSameShape(result.at(0)));
+  ASSERT_TRUE(exp.equalsTo(result.at(0)));
+}
+
+TEST_F(QuantizationTests, QuantizedMatmul_1) {
+  const int M = 5, K = 37, N = 19;
+  NDArray x('c', {M, K}, sd::DataType::INT8);
+  NDArray w('c', {K, N}, sd::DataType::INT8);
+  fillQuantized(x, 1);
+  fillQuantized(w, 2);
+
+  auto xScale = NDArrayFactory::create<float>(0.05f);
+  auto xZeroPoint = NDArrayFactory::create<int>(3);
+  auto wScale = NDArrayFactory::create<float>('c', {N});
+  auto wZeroPoint = NDArrayFactory::create<int>('c', {N});
+  for (int j = 0; j < N; j++) {
+    wScale.p(j, 0.01f * (j + 1));
+    wZeroPoint.p(j, j % 3 - 1);
+  }
+
+  sd::ops::quantized_matmul op;
+  auto result = op.evaluate({&x, &w, &xScale, &xZeroPoint, &wScale, &wZeroPoint}, {}, {});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+  ASSERT_EQ(sd::DataType::FLOAT32, z->dataType());
+  ASSERT_EQ(M, z->sizeAt(0));
+  ASSERT_EQ(N, z->sizeAt(1));
+
+  for (int i = 0; i < M; i++)
+    for (int j = 0; j < N; j++) {
+      double exp = 0.;
+      for (int k = 0; k < K; k++)
+        exp += (x.e<int>(i, k) - 3) * 0.05 * (w.e<int>(k, j) - wZeroPoint.e<int>(j)) * wScale.e<double>(j);
+      ASSERT_NEAR(exp, z->e<double>(i, j), 1e-5 * sd::math::sd_max<double>(1., sd::math::sd_abs<double>(exp)));
+    }
+}
+
+TEST_F(QuantizationTests, QuantizedMatmul_2) {
+  // transposed uint8 x, raw int32 accumulators
+  const int M = 9, K = 130, N = 33;
+  NDArray xT('c', {K, M}, sd::DataType::UINT8);
+  NDArray w('c', {K, N}, sd::DataType::INT8);
+  fillQuantized(xT, 3, 0);
+  fillQuantized(w, 4);
+
+  auto xScale = NDArrayFactory::create<float>(1.f);
+  auto xZeroPoint = NDArrayFactory::create<int>(128);
+  auto wScale = NDArrayFactory::create<float>(1.f);
+  auto wZeroPoint = NDArrayFactory::create<int>(-2);
+
+  sd::ops::quantized_matmul op;
+  auto result =
+      op.evaluate({&xT, &w, &xScale, &xZeroPoint, &wScale, &wZeroPoint}, {}, {1, 0}, {}, {sd::DataType::INT32});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+  ASSERT_EQ(sd::DataType::INT32, z->dataType());
+
+  for (int i = 0; i < M; i++)
+    for (int j = 0; j < N; j++) {
+      int exp = 0;
+      for (int k = 0; k < K; k++) exp += (xT.e<int>(k, i) - 128) * (w.e<int>(k, j) + 2);
+      ASSERT_EQ(exp, z->e<int>(i, j));
+    }
+}
+
+TEST_F(QuantizationTests, QuantizedXwPlusB_1) {
+  const int M = 4, K = 64, N = 17;
+  NDArray x('c', {M, K}, sd::DataType::UINT8);
+  NDArray w('c', {K, N}, sd::DataType::INT8);
+  fillQuantized(x, 5, 0);
+  fillQuantized(w, 6);
+  auto bias = NDArrayFactory::create<float>('c', {N});
+  bias.linspace(-2., 0.25);
+
+  auto xScale = NDArrayFactory::create<float>(0.02f);
+  auto xZeroPoint = NDArrayFactory::create<int>(120);
+  auto wScale = NDArrayFactory::create<float>(0.004f);
+  auto wZeroPoint = NDArrayFactory::create<int>(0);
+  const double outScale = 0.1;
+  const int outZeroPoint = -4;
+
+  sd::ops::quantized_xw_plus_b op;
+  auto result = op.evaluate({&x, &w, &bias, &xScale, &xZeroPoint, &wScale, &wZeroPoint}, {outScale, outZeroPoint},
+                            {}, {}, {sd::DataType::INT8});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+  ASSERT_EQ(sd::DataType::INT8, z->dataType());
+
+  for (int i = 0; i < M; i++)
+    for (int j = 0; j < N; j++) {
+      double real = bias.e<double>(j);
+      for (int k = 0; k < K; k++) real += (x.e<int>(i, k) - 120) * 0.02 * w.e<int>(k, j) * 0.004;
+      const double exp =
+          sd::math::sd_max<double>(-128., sd::math::sd_min<double>(127., std::round(real / outScale) + outZeroPoint));
+      // float epilogue may round differently exactly at .5
+      ASSERT_NEAR(exp, z->e<double>(i, j), 1.);
+    }
+}
+
+TEST_F(QuantizationTests, QuantizedConv2d_1) {
+  // NHWC, SAME padding, per-tensor weights with bias, compared against float conv2d of dequantized values
+  int bS = 2, iH = 5, iW = 4, iC = 3, oC = 6, kH = 3, kW = 3, sH = 1, sW = 1, pH = 0, pW = 0, dH = 1, dW = 1;
+  int paddingMode = 1;  // 1-SAME, 0-VALID
+  int dataFormat = 1;   // 1-NHWC, 0-NCHW
+
+  NDArray input('c', {bS, iH, iW, iC}, sd::DataType::INT8);
+  NDArray weights('c', {kH, kW, iC, oC}, sd::DataType::INT8);
+  fillQuantized(input, 7);
+  fillQuantized(weights, 8);
+  auto bias = NDArrayFactory::create<float>('c', {oC}, {1.f, -2.f, 0.5f, 0.f, 3.f, -1.f});
+
+  auto xScale = NDArrayFactory::create<float>(0.03f);
+  auto xZeroPoint = NDArrayFactory::create<int>(5);
+  auto wScale = NDArrayFactory::create<float>(0.02f);
+  auto wZeroPoint = NDArrayFactory::create<int>(0);
+
+  auto inputF = dequantized(input, 0.03f, 5);
+  auto weightsF = dequantized(weights, 0.02f, 0);
+
+  sd::ops::conv2d fop;
+  auto expected =
+      fop.evaluate({&inputF, &weightsF, &bias}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat});
+  ASSERT_EQ(sd::Status::OK, expected.status());
+
+  sd::ops::quantized_conv2d op;
+  auto result = op.evaluate({&input, &weights, &xScale, &xZeroPoint, &wScale, &wZeroPoint, &bias}, {},
+                            {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+  ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-3));
+}
+
+TEST_F(QuantizationTests, QuantizedConv2d_2) {
+  // NCHW, VALID, strides and dilations, [oC, iC, kH, kW] weights with per-channel scale and zero point
+  int bS = 3, iH = 9, iW = 8, iC = 5, oC = 4, kH = 2, kW = 3, sH = 2, sW = 1, pH = 0, pW = 0, dH = 2, dW = 2;
+  int paddingMode = 0;  // 1-SAME, 0-VALID
+  int dataFormat = 0;   // 1-NHWC, 0-NCHW
+  int wFormat = 1;
+
+  NDArray input('c', {bS, iC, iH, iW}, sd::DataType::UINT8);
+  NDArray weights('c', {oC, iC, kH, kW}, sd::DataType::INT8);
+  fillQuantized(input, 9, 0);
+  fillQuantized(weights, 10);
+
+  auto xScale = NDArrayFactory::create<float>(0.01f);
+  auto xZeroPoint = NDArrayFactory::create<int>(127);
+  auto wScale = NDArrayFactory::create<float>('c', {oC}, {0.01f, 0.02f, 0.005f, 0.04f});
+  auto wZeroPoint = NDArrayFactory::create<int>('c', {oC}, {0, 1, -3, 2});
+
+  auto inputF = dequantized(input, 0.01f, 127);
+  NDArray weightsF('c', {oC, iC, kH, kW}, sd::DataType::FLOAT32);
+  for (sd::LongType e = 0; e < weights.lengthOf(); e++) {
+    const auto c = e / (iC * kH * kW);
+    weightsF.p(e, (weights.e<int>(e) - wZeroPoint.e<int>(c)) * wScale.e<float>(c));
+  }
+
+  sd::ops::conv2d fop;
+  auto expected =
+      fop.evaluate({&inputF, &weightsF}, {}, {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  ASSERT_EQ(sd::Status::OK, expected.status());
+
+  sd::ops::quantized_conv2d op;
+  auto result = op.evaluate({&input, &weights, &xScale, &xZeroPoint, &wScale, &wZeroPoint}, {},
+                            {kH, kW, sH, sW, pH, pW, dH, dW, paddingMode, dataFormat, wFormat});
+  ASSERT_EQ(sd::Status::OK, result.status());
+
+  ASSERT_TRUE(expected.at(0)->isSameShape(result.at(0)));
+  ASSERT_TRUE(expected.at(0)->equalsTo(result.at(0), 1e-3));
+}
+
+TEST_F(QuantizationTests, QuantizedConv2d_3) {
+  // NHWC pointwise convolution, raw int32 accumulators
+  int bS = 2, iH = 3, iW = 3, iC = 20, oC = 7;
+
+  NDArray input('c', {bS, iH, iW, iC}, sd::DataType::INT8);
+  NDArray weights('c', {1, 1, iC, oC}, sd::DataType::INT8);
+  fillQuantized(input, 11);
+  fillQuantized(weights, 12);
+
+  auto xScale = NDArrayFactory::create<float>(1.f);
+  auto xZeroPoint = NDArrayFactory::create<int>(-1);
+  auto wScale = NDArrayFactory::create<float>(1.f);
+  auto wZeroPoint = NDArrayFactory::create<int>(0);
+
+  sd::ops::quantized_conv2d op;
+  auto result = op.evaluate({&input, &weights, &xScale, &xZeroPoint, &wScale, &wZeroPoint}, {},
+                            {1, 1, 1, 1, 0, 0, 1, 1, 0, 1}, {}, {sd::DataType::INT32});
+  ASSERT_EQ(sd::Status::OK, result.status());
+  auto z = result.at(0);
+  ASSERT_EQ(sd::DataType::INT32, z->dataType());
+
+  for (int p = 0; p < bS * iH * iW; p++)
+    for (int c = 0; c < oC; c++) {
+      int exp = 0;
+      for (int k = 0; k < iC; k++) exp += (input.e<int>(p * iC + k) + 1) * weights.e<int>(k * oC + c);
+      ASSERT_EQ(exp, z->e<int>(p * oC + c));
+    }
+}
+
+TEST_F(QuantizationTests, Mmul_Int8_1) {
+  const int M = 7, K = 45, N = 21;
+  NDArray a('c', {M, K}, sd::DataType::INT8);
+  NDArray b('f', {K, N}, sd::DataType::INT8);
+  NDArray c('c', {M, N}, sd::DataType::INT32);
+  fillQuantized(a, 13);
+  fillQuantized(b, 14);
+
+  MmulHelper::mmul(&a, &b, &c, 1., 0.);
+
+  for (int i = 0; i < M; i++)
+    for (int j = 0; j < N; j++) {
+      int exp = 0;
+      for (int k = 0; k < K; k++) exp += a.e<int>(i, k) * b.e<int>(k, j);
+      ASSERT_EQ(exp, c.e<int>(i, j));
+    }
+}
@@ -106,3 +106,84 @@ TEST_F(SortCpuTests, test_tad_sort_by_val_1) {
   ASSERT_EQ(ek, k);
   ASSERT_EQ(ev, v);
 }
+
+TEST_F(SortCpuTests, test_linear_sort_by_key_2) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  // long enough for radix path, equal keys must keep original order of values
+  const int length = 100000;
+  auto k = NDArrayFactory::create<float>('c', {length});
+  auto v = NDArrayFactory::create<sd::LongType>('c', {length});
+  for (int e = 0; e < length; e++) {
+    k.p(e, static_cast<float>((e * 7919) % 1000) - 500.f);
+    v.p(e, e);
+  }
+
+  sortByKey(nullptr, k.buffer(), k.shapeInfo(), k.specialBuffer(), k.specialShapeInfo(), v.buffer(), v.shapeInfo(),
+            v.specialBuffer(), v.specialShapeInfo(), true);
+
+  for (int e = 1; e < length; e++) {
+    ASSERT_TRUE(k.e<float>(e - 1) >= k.e<float>(e));
+    if (k.e<float>(e - 1) == k.e<float>(e)) ASSERT_TRUE(v.e<sd::LongType>(e - 1) < v.e<sd::LongType>(e));
+    ASSERT_EQ(static_cast<float>((v.e<sd::LongType>(e) * 7919) % 1000) - 500.f, k.e<float>(e));
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_strided_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  // column of c-ordered matrix, negative values and duplicates included
+  auto x = NDArrayFactory::create<int>('c', {3000, 2});
+  for (int e = 0; e < 3000; e++) {
+    x.p(e, 0, (e * 37) % 1001 - 500);
+    x.p(e, 1, e);
+  }
+
+  auto column = x({0, 0, 0, 1}, true);
+  auto exp = column.dup('c');
+  std::vector<int> values(3000);
+  for (int e = 0; e < 3000; e++) values[e] = exp.e<int>(e);
+  std::sort(values.begin(), values.end());
+
+  sort(nullptr, column.buffer(), column.shapeInfo(), column.specialBuffer(), column.specialShapeInfo(), false);
+
+  for (int e = 0; e < 3000; e++) {
+    ASSERT_EQ(values[e], x.e<int>(e, 0));
+    ASSERT_EQ(e, x.e<int>(e, 1));
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_by_key_mixed_order_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  // both arrays are contiguous, but payload is 'f' ordered: pairs are matched by logical index, not memory order
+  auto k = NDArrayFactory::create<float>('c', {3, 4}, {7, 2, 11, 5, 0, 9, 3, 8, 1, 10, 6, 4});
+  auto v = NDArrayFactory::create<float>('f', {3, 4});
+  for (int e = 0; e < 12; e++) v.p(e, k.e<float>(e) * 10.f);
+
+  sortByKey(nullptr, k.buffer(), k.shapeInfo(), k.specialBuffer(), k.specialShapeInfo(), v.buffer(), v.shapeInfo(),
+            v.specialBuffer(), v.specialShapeInfo(), false);
+
+  for (int e = 0; e < 12; e++) {
+    ASSERT_EQ(static_cast<float>(e), k.e<float>(e));
+    ASSERT_EQ(e * 10.f, v.e<float>(e));
+  }
+}
+
+TEST_F(SortCpuTests, test_sort_nans_1) {
+  if (!Environment::getInstance().isCPU()) return;
+
+  // NaNs go past infinities regardless of their sign bit
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  auto x = NDArrayFactory::create<float>('c', {6}, {1.f, -nan, inf, nan, -inf, -2.f});
+
+  sort(nullptr, x.buffer(), x.shapeInfo(), x.specialBuffer(), x.specialShapeInfo(), false);
+
+  ASSERT_EQ(-inf, x.e<float>(0));
+  ASSERT_EQ(-2.f, x.e<float>(1));
+  ASSERT_EQ(1.f, x.e<float>(2));
+  ASSERT_EQ(inf, x.e<float>(3));
+  ASSERT_TRUE(std::isnan(x.e<float>(4)));
+  ASSERT_TRUE(std::isnan(x.e<float>(5)));
+}
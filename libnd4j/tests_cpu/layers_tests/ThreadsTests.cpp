@@ -21,6 +21,7 @@
 //
 #include <execution/ThreadPool.h>
 #include <execution/Threads.h>
+#include <execution/WorkStealingPool.h>
 #include <loops/type_conversions.h>
 #include <ops/declarable/CustomOperations.h>
 
@@ -192,11 +193,118 @@ TEST_F(ThreadsTests, reduction_test_1) {
   ASSERT_EQ(8192, sum);
 }
 
+TEST_F(ThreadsTests, dynamic_test_1) {
+  std::vector<int> visits(1000, 0);
+  std::atomic<int64_t> busy[64];
+  for (auto &b : busy) b.store(0);
+
+  auto func = PRAGMA_THREADS_FOR {
+    // calls sharing thread_id must not overlap
+    if (busy[thread_id]++ != 0) THROW_EXCEPTION("thread_id is used concurrently");
+
+    for (auto e = start; e < stop; e += increment) {
+      visits[e]++;
+
+      // skewed cost: iterations near the end are way heavier
+      volatile double dummy = 0.0;
+      for (int i = 0; i < e * 10; i++) dummy = dummy + i;
+    }
+
+    busy[thread_id]--;
+  };
+
+  auto numThreads = samediff::Threads::parallel_dynamic(func, 0, 1000, 1, 8, 4);
+  ASSERT_TRUE(numThreads >= 1 && numThreads <= 8);
+
+  for (auto v : visits) ASSERT_EQ(1, v);
+}
+
+TEST_F(ThreadsTests, dynamic_test_2) {
+  // lots of tiny task groups, created and destroyed on the stack right after their last task completes
+  std::atomic<int64_t> sum;
+  sum.store(0);
+
+  auto func = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e += increment) sum++;
+  };
+
+  for (int i = 0; i < 20000; i++) samediff::Threads::parallel_dynamic(func, 0, 8, 1, 8, 1);
+
+  ASSERT_EQ(20000LL * 8LL, sum.load());
+}
+
+TEST_F(ThreadsTests, nested_test_1) {
+  std::atomic<int64_t> sum;
+  sum.store(0);
+
+  auto inner = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) sum += e;
+  };
+
+  auto outer = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) samediff::Threads::parallel_for(inner, 0, 4096, 1, 4);
+  };
+
+  samediff::Threads::parallel_tad(outer, 0, 16, 1, 4);
+
+  ASSERT_EQ(16LL * (4095LL * 4096LL / 2), sum.load());
+}
+
 static void _code(int thread_id) {
   auto x = NDArrayFactory::create<float>('c', {65536 * 16});
   x.assign(1.1f);
 }
 
+#ifndef SD_WORK_STEALING_DISABLED
+TEST_F(ThreadsTests, nested_test_2) {
+  // both inner spans have to run at the same time, a nested call executed serially never gets there
+  if (sd::Environment::getInstance().maxThreads() < 2) return;
+
+  std::atomic<int> arrived;
+  std::atomic<int> met;
+  arrived.store(0);
+  met.store(0);
+
+  auto inner = PRAGMA_THREADS_FOR {
+    arrived++;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (arrived.load() < 2 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+
+    if (arrived.load() >= 2) met++;
+  };
+
+  auto outer = PRAGMA_THREADS_FOR {
+    if (thread_id == 0) samediff::Threads::parallel_tad(inner, 0, 2, 1, 2);
+  };
+
+  samediff::Threads::parallel_tad(outer, 0, 2, 1, 2);
+
+  ASSERT_EQ(2, met.load());
+}
+
+TEST_F(ThreadsTests, nested_test_3) {
+  // waiting on the nested call must not pick up sibling spans, they'd try to take the lock this thread holds
+  std::mutex lock;
+  std::atomic<int64_t> sum;
+  sum.store(0);
+
+  auto inner = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) sum += e;
+  };
+
+  auto outer = PRAGMA_THREADS_FOR {
+    for (auto e = start; e < stop; e++) {
+      std::lock_guard<std::mutex> guard(lock);
+      samediff::Threads::parallel_tad(inner, 0, 64, 1, 4);
+    }
+  };
+
+  samediff::Threads::parallel_tad(outer, 0, 32, 1, 8);
+
+  ASSERT_EQ(32LL * (63LL * 64LL / 2), sum.load());
+}
+#endif
+
 TEST_F(ThreadsTests, crash_test_1) {
   if (!Environment::getInstance().isCPU()) return;
 